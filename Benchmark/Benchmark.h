@@ -0,0 +1,35 @@
+//
+// Copyright (c) 2016 - 2017 Mesh Consultants Inc.
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include <Urho3D/Core/Context.h>
+#include <Urho3D/Core/Timer.h>
+
+// Benchmark suites run by IogramBenchmark, one per subsystem.
+void BenchmarkIoGraph(Urho3D::Context* context);
+void BenchmarkIoDataTree(Urho3D::Context* context);
+void BenchmarkTriMesh(Urho3D::Context* context);
+void BenchmarkMeshImport(Urho3D::Context* context);
+
+// Prints label and the milliseconds elapsed on timer, then resets the timer.
+void ReportTime(const Urho3D::String& label, Urho3D::HiresTimer& timer);
@@ -0,0 +1,96 @@
+//
+// Copyright (c) 2016 - 2017 Mesh Consultants Inc.
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include <Urho3D/Core/Context.h>
+#include <Urho3D/Core/Timer.h>
+#include <Urho3D/Math/Random.h>
+
+#include "Benchmark.h"
+#include "IoDataTree.h"
+
+using namespace Urho3D;
+
+namespace {
+
+	const unsigned NUM_BRANCHES = 100000;
+
+	// path {i / 100, i % 100}: two levels, like the output of a component solved over a grafted list
+	Vector<int> BranchPath(unsigned i)
+	{
+		Vector<int> path;
+		path.Push(i / 100);
+		path.Push(i % 100);
+		return path;
+	}
+
+	void TimeTree(Context* context, const String& name, const PODVector<unsigned>& addOrder)
+	{
+		HiresTimer timer;
+
+		IoDataTree tree(context);
+		for (unsigned i = 0; i < addOrder.Size(); ++i) {
+			tree.Add(BranchPath(addOrder[i]), Variant((float)addOrder[i]));
+		}
+		// the first ordered read merges whatever was added out of order
+		tree.GetNumBranches();
+		ReportTime(name + ": Add " + String(NUM_BRANCHES) + " branches", timer);
+
+		float sum = 0.0f;
+		for (unsigned i = 0; i < NUM_BRANCHES; ++i) {
+			Variant item;
+			tree.GetItem(item, BranchPath(i), 0);
+			sum += item.GetFloat();
+		}
+		ReportTime(name + ": GetItem from every branch", timer);
+
+		Vector<int> path = tree.Begin();
+		for (unsigned i = 0; i < tree.GetNumBranches(); ++i) {
+			Variant item;
+			tree.GetNextItem(item, ITEM);
+			path = tree.GetNextBranch();
+		}
+		ReportTime(name + ": iterate branches as LocalSolve does", timer);
+
+		IoDataTree copy(tree);
+		ReportTime(name + ": copy (shares the branches)", timer);
+
+		copy.Add(BranchPath(0), Variant(sum));
+		ReportTime(name + ": first Add to the copy (detaches)", timer);
+	}
+
+}
+
+void BenchmarkIoDataTree(Context* context)
+{
+	PODVector<unsigned> ascending(NUM_BRANCHES);
+	for (unsigned i = 0; i < NUM_BRANCHES; ++i) {
+		ascending[i] = i;
+	}
+	TimeTree(context, "ascending paths", ascending);
+
+	PODVector<unsigned> shuffled = ascending;
+	SetRandomSeed(1);
+	for (unsigned i = NUM_BRANCHES - 1; i > 0; --i) {
+		Swap(shuffled[i], shuffled[Rand() % (i + 1)]);
+	}
+	TimeTree(context, "shuffled paths", shuffled);
+}
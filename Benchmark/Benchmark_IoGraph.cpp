@@ -0,0 +1,206 @@
+//
+// Copyright (c) 2016 - 2017 Mesh Consultants Inc.
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include <Urho3D/Core/Context.h>
+#include <Urho3D/Core/Timer.h>
+#include <Urho3D/IO/VectorBuffer.h>
+
+#include <cstring>
+
+#include "Benchmark.h"
+#include "IoComponentBase.h"
+#include "IoDataTree.h"
+#include "IoGraph.h"
+#include "IoSerialization.h"
+#include "Maths_Addition.h"
+
+using namespace Urho3D;
+
+namespace {
+
+	const unsigned NUM_COMPONENTS = 10000;
+
+	const unsigned LATTICE_WIDTH = 64;
+	const unsigned LATTICE_DEPTH = 32;
+	const unsigned NUM_VALUES = 1000;
+
+	// Graph of NUM_COMPONENTS plain components with two inputs and one output each.
+	// Input 0 carries the links, input 1 is set by hand so that every component has data
+	// and so that editing it dirties exactly one component.
+	SharedPtr<IoGraph> MakeGraph(Context* context)
+	{
+		SharedPtr<IoGraph> graph(new IoGraph(context));
+		for (unsigned i = 0; i < NUM_COMPONENTS; ++i) {
+			SharedPtr<IoComponentBase> component(new IoComponentBase(context, 2, 1));
+			component->InputHardSet(0, IoDataTree(context, Variant(0.0f)));
+			component->InputHardSet(1, IoDataTree(context, Variant(0.0f)));
+			graph->AddNewComponent(component);
+		}
+
+		return graph;
+	}
+
+	// Dirties component index through its free input, then re-solves what depends on it.
+	void EditAndSolve(IoGraph* graph, Context* context, unsigned index, float value)
+	{
+		graph->GetComponent(index)->InputHardSet(1, IoDataTree(context, Variant(value)));
+		graph->QuickTopoSolveGraph();
+	}
+
+	// LATTICE_DEPTH levels of LATTICE_WIDTH additions, each adding two neighbours from the level above,
+	// so that every level is LATTICE_WIDTH independent thread safe components working on NUM_VALUES items
+	SharedPtr<IoGraph> MakeLattice(Context* context)
+	{
+		VariantVector values(NUM_VALUES);
+		for (unsigned i = 0; i < NUM_VALUES; ++i) {
+			values[i] = 0.001f * i;
+		}
+
+		SharedPtr<IoGraph> graph(new IoGraph(context));
+		for (unsigned d = 0; d < LATTICE_DEPTH; ++d) {
+			for (unsigned i = 0; i < LATTICE_WIDTH; ++i) {
+				SharedPtr<IoComponentBase> component(new Maths_Addition(context));
+				if (d == 0) {
+					component->InputHardSet(0, IoDataTree(context, values));
+					component->InputHardSet(1, IoDataTree(context, Variant((float)i)));
+				}
+				graph->AddNewComponent(component);
+			}
+		}
+
+		for (unsigned d = 1; d < LATTICE_DEPTH; ++d) {
+			for (unsigned i = 0; i < LATTICE_WIDTH; ++i) {
+				unsigned child = d * LATTICE_WIDTH + i;
+				graph->AddConnection((d - 1) * LATTICE_WIDTH + i, 0, child, 0);
+				graph->AddConnection((d - 1) * LATTICE_WIDTH + (i + 1) % LATTICE_WIDTH, 0, child, 1);
+			}
+		}
+
+		return graph;
+	}
+
+	// output trees of every component in the binary save format, so that two solves compare bit for bit
+	void WriteOutputs(IoGraph* graph, Context* context, VectorBuffer& dest)
+	{
+		for (int i = 0; i < graph->GetDummyNodeCount(); ++i) {
+			IoDataTree tree(context);
+			graph->GetOutputIoDataTree(i, 0, tree);
+			IoSerialization::SaveDataTree(tree, dest);
+		}
+	}
+
+	// Solves the lattice serially and in parallel from cleared outputs and compares the results.
+	void CheckParallelSolve(Context* context)
+	{
+		HiresTimer timer;
+
+		SharedPtr<IoGraph> graph = MakeLattice(context);
+		ReportTime("lattice: build " + String(LATTICE_WIDTH * LATTICE_DEPTH) + " additions", timer);
+
+		graph->SetParallelSolve(false);
+		graph->TopoSolveGraph();
+		ReportTime("lattice: serial solve", timer);
+
+		VectorBuffer serial;
+		WriteOutputs(graph, context, serial);
+
+		for (int i = 0; i < graph->GetDummyNodeCount(); ++i) {
+			graph->GetComponent(i)->ClearOutputs();
+		}
+		timer.Reset();
+
+		graph->SetParallelSolve(true);
+		graph->TopoSolveGraph();
+		ReportTime("lattice: parallel solve", timer);
+
+		VectorBuffer parallel;
+		WriteOutputs(graph, context, parallel);
+
+		bool identical = serial.GetSize() == parallel.GetSize() &&
+			memcmp(serial.GetData(), parallel.GetData(), serial.GetSize()) == 0;
+		PrintLine(String("lattice: parallel outputs ") + (identical ? "identical to serial" : "DIFFER from serial") +
+			" (" + String(serial.GetSize()) + " bytes)");
+
+		graph->Clear();
+	}
+
+	void TimeGraph(IoGraph* graph, Context* context, const String& name, unsigned smallConeIndex)
+	{
+		HiresTimer timer;
+
+		Vector<int> order;
+		graph->IsAcyclic(order);
+		ReportTime(name + ": first sort (builds the adjacency)", timer);
+
+		for (unsigned i = 0; i < 10; ++i) {
+			order.Clear();
+			graph->IsAcyclic(order);
+		}
+		PrintLine(ToString("%-56s %10.3f ms", (name + ": sort, average of 10").CString(), timer.GetUSec(true) / 10000.0f));
+
+		graph->TopoSolveGraph();
+		ReportTime(name + ": full solve", timer);
+
+		graph->QuickTopoSolveGraph();
+		ReportTime(name + ": quick solve, nothing dirty", timer);
+
+		EditAndSolve(graph, context, 0, 1.0f);
+		ReportTime(name + ": quick solve after editing the root", timer);
+
+		EditAndSolve(graph, context, smallConeIndex, 2.0f);
+		ReportTime(name + ": quick solve after editing one leaf", timer);
+	}
+
+}
+
+void BenchmarkIoGraph(Context* context)
+{
+	HiresTimer timer;
+
+	// chain: component i feeds component i + 1
+	{
+		SharedPtr<IoGraph> graph = MakeGraph(context);
+		for (unsigned i = 0; i + 1 < NUM_COMPONENTS; ++i) {
+			graph->AddConnection(i, 0, i + 1, 0);
+		}
+		ReportTime("chain: build and connect " + String(NUM_COMPONENTS) + " components", timer);
+
+		TimeGraph(graph, context, "chain", NUM_COMPONENTS - 1);
+		graph->Clear();
+	}
+
+	// fan-out: component 0 feeds every other component
+	{
+		timer.Reset();
+		SharedPtr<IoGraph> graph = MakeGraph(context);
+		for (unsigned i = 1; i < NUM_COMPONENTS; ++i) {
+			graph->AddConnection(0, 0, i, 0);
+		}
+		ReportTime("fan-out: build and connect " + String(NUM_COMPONENTS) + " components", timer);
+
+		TimeGraph(graph, context, "fan-out", NUM_COMPONENTS - 1);
+		graph->Clear();
+	}
+
+	// lattice: parallel solve against the serial one
+	CheckParallelSolve(context);
+}
@@ -0,0 +1,144 @@
+//
+// Copyright (c) 2016 - 2017 Mesh Consultants Inc.
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include <Urho3D/Core/Context.h>
+#include <Urho3D/Core/Timer.h>
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "Benchmark.h"
+#include "Geomlib_MeshImport.h"
+
+using namespace Urho3D;
+
+namespace {
+
+	// Grids of GRID_SIZES[i] x GRID_SIZES[i] quads: 125k, 500k and 2M triangles
+	const unsigned GRID_SIZES[] = { 250, 500, 1000 };
+	const unsigned NUM_GRID_SIZES = sizeof(GRID_SIZES) / sizeof(GRID_SIZES[0]);
+
+	void Append(std::vector<char>& data, const char* text)
+	{
+		data.insert(data.end(), text, text + strlen(text));
+	}
+
+	template <typename T>
+	void AppendBinary(std::vector<char>& data, T value)
+	{
+		const char* bytes = reinterpret_cast<const char*>(&value);
+		data.insert(data.end(), bytes, bytes + sizeof(T));
+	}
+
+	// gridSize x gridSize quads as OBJ text, one quad per face line
+	void MakeGridOBJ(unsigned gridSize, std::vector<char>& data)
+	{
+		unsigned numPoints = gridSize + 1;
+		char line[128];
+
+		data.clear();
+		for (unsigned i = 0; i < numPoints; ++i) {
+			for (unsigned j = 0; j < numPoints; ++j) {
+				sprintf(line, "v %u %u %f\n", i, j, 0.001f * ((i * j) % 97));
+				Append(data, line);
+			}
+		}
+		for (unsigned i = 0; i < gridSize; ++i) {
+			for (unsigned j = 0; j < gridSize; ++j) {
+				unsigned a = i * numPoints + j + 1;
+				unsigned b = a + numPoints;
+				sprintf(line, "f %u %u %u %u\n", a, b, b + 1, a + 1);
+				Append(data, line);
+			}
+		}
+	}
+
+	// The same grid as binary_little_endian PLY with triangle faces
+	void MakeGridPLY(unsigned gridSize, std::vector<char>& data)
+	{
+		unsigned numPoints = gridSize + 1;
+		char header[256];
+		sprintf(header,
+			"ply\nformat binary_little_endian 1.0\n"
+			"element vertex %u\nproperty float x\nproperty float y\nproperty float z\n"
+			"element face %u\nproperty list uchar int vertex_indices\nend_header\n",
+			numPoints * numPoints, 2 * gridSize * gridSize);
+
+		data.clear();
+		Append(data, header);
+		for (unsigned i = 0; i < numPoints; ++i) {
+			for (unsigned j = 0; j < numPoints; ++j) {
+				AppendBinary(data, (float)i);
+				AppendBinary(data, (float)j);
+				AppendBinary(data, 0.001f * ((i * j) % 97));
+			}
+		}
+		for (unsigned i = 0; i < gridSize; ++i) {
+			for (unsigned j = 0; j < gridSize; ++j) {
+				int a = i * numPoints + j;
+				int b = a + numPoints;
+				AppendBinary(data, (unsigned char)3);
+				AppendBinary(data, a);
+				AppendBinary(data, b);
+				AppendBinary(data, a + 1);
+				AppendBinary(data, (unsigned char)3);
+				AppendBinary(data, a + 1);
+				AppendBinary(data, b);
+				AppendBinary(data, b + 1);
+			}
+		}
+	}
+
+	typedef bool(*ParseFunction)(const char*, size_t, PODVector<float>&, PODVector<int>&, bool);
+
+	void TimeParse(const String& name, ParseFunction parse, const std::vector<char>& data, HiresTimer& timer)
+	{
+		PODVector<float> positions;
+		PODVector<int> indices;
+
+		timer.Reset();
+		parse(&data[0], data.size(), positions, indices, false);
+		ReportTime(name + ": serial", timer);
+
+		parse(&data[0], data.size(), positions, indices, true);
+		ReportTime(name + ": parallel", timer);
+	}
+
+}
+
+void BenchmarkMeshImport(Context* context)
+{
+	HiresTimer timer;
+	std::vector<char> data;
+
+	for (unsigned i = 0; i < NUM_GRID_SIZES; ++i) {
+		unsigned numFaces = 2 * GRID_SIZES[i] * GRID_SIZES[i];
+		String name = String(numFaces) + " faces";
+
+		MakeGridOBJ(GRID_SIZES[i], data);
+		TimeParse(name + ", OBJ " + String((unsigned)(data.size() >> 20)) + " MB", Geomlib::ParseOBJ, data, timer);
+
+		MakeGridPLY(GRID_SIZES[i], data);
+		TimeParse(name + ", PLY " + String((unsigned)(data.size() >> 20)) + " MB", Geomlib::ParsePLY, data, timer);
+	}
+}
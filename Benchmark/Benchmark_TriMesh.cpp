@@ -0,0 +1,116 @@
+//
+// Copyright (c) 2016 - 2017 Mesh Consultants Inc.
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include <Urho3D/Core/Context.h>
+#include <Urho3D/Core/Timer.h>
+
+#include "Benchmark.h"
+#include "IoDataTree.h"
+#include "TriMesh.h"
+#include "Geomlib_TriMeshRemesh.h"
+
+using namespace Urho3D;
+
+namespace {
+
+	const unsigned GRID_SIZE = 500;
+	const unsigned NUM_COPIES = 100;
+
+	// GRID_SIZE x GRID_SIZE quads split into triangles: 251k vertices, 498k faces
+	void MakeGrid(Eigen::MatrixXf& V, Eigen::MatrixXi& F)
+	{
+		unsigned numPoints = GRID_SIZE + 1;
+		V.resize(numPoints * numPoints, 3);
+		for (unsigned i = 0; i < numPoints; ++i) {
+			for (unsigned j = 0; j < numPoints; ++j) {
+				V.row(i * numPoints + j) << (float)i, (float)j, 0.0f;
+			}
+		}
+
+		F.resize(2 * GRID_SIZE * GRID_SIZE, 3);
+		for (unsigned i = 0; i < GRID_SIZE; ++i) {
+			for (unsigned j = 0; j < GRID_SIZE; ++j) {
+				int a = i * numPoints + j;
+				int b = a + numPoints;
+				unsigned f = 2 * (i * GRID_SIZE + j);
+				F.row(f) << a, b, a + 1;
+				F.row(f + 1) << a + 1, b, b + 1;
+			}
+		}
+	}
+
+	void TimeMesh(Context* context, const String& name, const Variant& mesh, HiresTimer& timer)
+	{
+		float sum = 0.0f;
+		for (unsigned i = 0; i < NUM_COPIES; ++i) {
+			Variant copy = mesh;
+			sum += copy.GetVariantMap().Size();
+		}
+		ReportTime(name + ": " + String(NUM_COPIES) + " Variant copies", timer);
+
+		for (unsigned i = 0; i < NUM_COPIES; ++i) {
+			IoDataTree tree(context, mesh);
+			IoDataTree copy(tree);
+			Variant item;
+			copy.GetItem(item, copy.Begin(), 0);
+			sum += item.GetVariantMap().Size();
+		}
+		ReportTime(name + ": " + String(NUM_COPIES) + " trips through a data tree", timer);
+
+		for (unsigned i = 0; i < NUM_COPIES; ++i) {
+			TriMeshView view(mesh);
+			sum += view.GetVertex(view.GetNumVertices() - 1).x_;
+		}
+		ReportTime(name + ": " + String(NUM_COPIES) + " TriMeshViews", timer);
+
+		VariantVector vertexList = TriMesh_GetVertexList(mesh);
+		ReportTime(name + ": TriMesh_GetVertexList", timer);
+	}
+
+}
+
+void BenchmarkTriMesh(Context* context)
+{
+	Eigen::MatrixXf V;
+	Eigen::MatrixXi F;
+	MakeGrid(V, F);
+
+	HiresTimer timer;
+
+	Variant unpacked = TriMesh_Make(V, F);
+	ReportTime("unpacked: TriMesh_Make", timer);
+	TimeMesh(context, "unpacked", unpacked, timer);
+
+	Variant packed = TriMesh_MakePacked(V, F);
+	ReportTime("packed: TriMesh_MakePacked", timer);
+	TimeMesh(context, "packed", packed, timer);
+
+	Variant repacked = TriMesh_Pack(unpacked);
+	ReportTime("TriMesh_Pack", timer);
+
+	Variant reunpacked = TriMesh_Unpack(packed);
+	ReportTime("TriMesh_Unpack", timer);
+
+	// Mesh_Remesh defaults: average edge length, tolerance 0.33, 2 steps
+	Variant remeshed = Geomlib::TriMesh_Remesh(packed, 0.0f, 0.33f, 2);
+	ReportTime("TriMesh_Remesh: 2 steps", timer);
+}
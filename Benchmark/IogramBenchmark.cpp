@@ -0,0 +1,80 @@
+//
+// Copyright (c) 2016 - 2017 Mesh Consultants Inc.
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include <Urho3D/Core/Context.h>
+#include <Urho3D/Core/ProcessUtils.h>
+#include <Urho3D/Core/Timer.h>
+#include <Urho3D/Core/WorkQueue.h>
+#include <Urho3D/Core/StringUtils.h>
+
+#include "Benchmark.h"
+
+using namespace Urho3D;
+
+// Usage: IogramBenchmark [suite ...]
+// Runs the named suites, or all of them when none is given. Suites: graph, datatree, trimesh, import
+int main(int argc, char** argv)
+{
+	SharedPtr<Context> context(new Context());
+
+	// IoComponentBase seeds its ID from the system time
+	context->RegisterSubsystem(new Time(context));
+
+	// workers for the parallel graph solve
+	WorkQueue* queue = new WorkQueue(context);
+	context->RegisterSubsystem(queue);
+	queue->CreateThreads(GetNumLogicalCPUs() - 1);
+
+	Vector<String> arguments;
+	for (int i = 1; i < argc; ++i) {
+		arguments.Push(String(argv[i]).ToLower());
+	}
+	bool runAll = arguments.Empty();
+
+	if (runAll || arguments.Contains("graph")) {
+		PrintLine("--- IoGraph");
+		BenchmarkIoGraph(context);
+	}
+
+	if (runAll || arguments.Contains("datatree")) {
+		PrintLine("--- IoDataTree");
+		BenchmarkIoDataTree(context);
+	}
+
+	if (runAll || arguments.Contains("trimesh")) {
+		PrintLine("--- TriMesh");
+		BenchmarkTriMesh(context);
+	}
+
+	if (runAll || arguments.Contains("import")) {
+		PrintLine("--- Mesh import");
+		BenchmarkMeshImport(context);
+	}
+
+	return 0;
+}
+
+void ReportTime(const String& label, HiresTimer& timer)
+{
+	float milliseconds = timer.GetUSec(true) / 1000.0f;
+	PrintLine(ToString("%-56s %10.3f ms", label.CString(), milliseconds));
+}
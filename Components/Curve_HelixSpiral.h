@@ -33,6 +33,8 @@ public:
                        const Urho3D::Vector<Urho3D::Variant>& inSolveInstance,
                        Urho3D::Vector<Urho3D::Variant>& outSolveInstance
                        );
+
+    bool IsThreadSafe() const { return true; }
     
     void AddInputSlot() = delete;
     void AddOutputSlot() = delete;
@@ -37,5 +37,7 @@ public:
 		Urho3D::Vector<Urho3D::Variant>& outSolveInstance
 		);
 
+	bool IsThreadSafe() const { return true; }
+
 	static Urho3D::String iconTexture;
 };
\ No newline at end of file
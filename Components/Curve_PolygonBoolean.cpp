@@ -0,0 +1,171 @@
+//
+// Copyright (c) 2016 - 2017 Mesh Consultants Inc.
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "Curve_PolygonBoolean.h"
+
+#include <assert.h>
+
+#include <Urho3D/Core/Variant.h>
+#include <Urho3D/Math/Matrix3x4.h>
+
+#include "Geomlib_PolygonClipping.h"
+
+using namespace Urho3D;
+
+String Curve_PolygonBoolean::iconTexture = "";
+
+Curve_PolygonBoolean::Curve_PolygonBoolean(Context* context) :
+	IoComponentBase(context, 5, 3)
+{
+	SetName("PolygonBoolean");
+	SetFullName("Polygon Boolean");
+	SetDescription("Union, intersection, difference or exclusive or of closed polylines in a plane");
+	SetGroup(IoComponentGroup::CURVE);
+	SetSubgroup("Operators");
+
+	inputSlots_[0]->SetName("PolylinesA");
+	inputSlots_[0]->SetVariableName("A");
+	inputSlots_[0]->SetDescription("Closed polylines of the first region");
+	inputSlots_[0]->SetVariantType(VariantType::VAR_VARIANTMAP);
+	inputSlots_[0]->SetDataAccess(DataAccess::LIST);
+
+	inputSlots_[1]->SetName("PolylinesB");
+	inputSlots_[1]->SetVariableName("B");
+	inputSlots_[1]->SetDescription("Closed polylines of the second region, may be empty for a union of A");
+	inputSlots_[1]->SetVariantType(VariantType::VAR_VARIANTMAP);
+	inputSlots_[1]->SetDataAccess(DataAccess::LIST);
+
+	inputSlots_[2]->SetName("Operation");
+	inputSlots_[2]->SetVariableName("O");
+	inputSlots_[2]->SetDescription("0 union, 1 intersection, 2 difference A - B, 3 exclusive or");
+	inputSlots_[2]->SetVariantType(VariantType::VAR_INT);
+	inputSlots_[2]->SetDataAccess(DataAccess::ITEM);
+	inputSlots_[2]->SetDefaultValue(0);
+	inputSlots_[2]->DefaultSet();
+
+	inputSlots_[3]->SetName("EvenOdd");
+	inputSlots_[3]->SetVariableName("E");
+	inputSlots_[3]->SetDescription("Fill by even-odd rule, where any nested polyline is a hole; otherwise holes must wind opposite to their outline");
+	inputSlots_[3]->SetVariantType(VariantType::VAR_BOOL);
+	inputSlots_[3]->SetDataAccess(DataAccess::ITEM);
+	inputSlots_[3]->SetDefaultValue(false);
+	inputSlots_[3]->DefaultSet();
+
+	inputSlots_[4]->SetName("Plane");
+	inputSlots_[4]->SetVariableName("T");
+	inputSlots_[4]->SetDescription("Transform whose XZ plane the polylines are projected to");
+	inputSlots_[4]->SetVariantType(VariantType::VAR_MATRIX3X4);
+	inputSlots_[4]->SetDataAccess(DataAccess::ITEM);
+	inputSlots_[4]->SetDefaultValue(Matrix3x4::IDENTITY);
+	inputSlots_[4]->DefaultSet();
+
+	outputSlots_[0]->SetName("Boundaries");
+	outputSlots_[0]->SetVariableName("P");
+	outputSlots_[0]->SetDescription("Closed boundary polylines, each outline followed by its holes");
+	outputSlots_[0]->SetVariantType(VariantType::VAR_VARIANTMAP);
+	outputSlots_[0]->SetDataAccess(DataAccess::LIST);
+
+	outputSlots_[1]->SetName("IsHole");
+	outputSlots_[1]->SetVariableName("H");
+	outputSlots_[1]->SetDescription("Whether each boundary is a hole");
+	outputSlots_[1]->SetVariantType(VariantType::VAR_BOOL);
+	outputSlots_[1]->SetDataAccess(DataAccess::LIST);
+
+	outputSlots_[2]->SetName("Region");
+	outputSlots_[2]->SetVariableName("R");
+	outputSlots_[2]->SetDescription("Index of the region each boundary belongs to");
+	outputSlots_[2]->SetVariantType(VariantType::VAR_INT);
+	outputSlots_[2]->SetDataAccess(DataAccess::LIST);
+}
+
+void Curve_PolygonBoolean::SolveInstance(
+	const Vector<Variant>& inSolveInstance,
+	Vector<Variant>& outSolveInstance
+)
+{
+	assert(inSolveInstance.Size() == inputSlots_.Size());
+	assert(outSolveInstance.Size() == outputSlots_.Size());
+
+	///////////////////
+	// VERIFY & EXTRACT
+
+	const VariantVector& polylinesA = inSolveInstance[0].GetVariantVector();
+	const VariantVector& polylinesB = inSolveInstance[1].GetVariantVector();
+
+	VariantType type2 = inSolveInstance[2].GetType();
+	if (!(type2 == VariantType::VAR_INT || type2 == VariantType::VAR_FLOAT)) {
+		URHO3D_LOGWARNING("Curve_PolygonBoolean -- O must be an integer");
+		SetAllOutputsNull(outSolveInstance);
+		return;
+	}
+	int operation = inSolveInstance[2].GetInt();
+	if (operation < Geomlib::POLYGON_UNION || operation > Geomlib::POLYGON_XOR) {
+		URHO3D_LOGWARNING("Curve_PolygonBoolean -- O must be 0, 1, 2 or 3");
+		SetAllOutputsNull(outSolveInstance);
+		return;
+	}
+
+	bool evenOdd = inSolveInstance[3].GetBool();
+
+	if (inSolveInstance[4].GetType() != VariantType::VAR_MATRIX3X4) {
+		URHO3D_LOGWARNING("Curve_PolygonBoolean -- T must be a valid transform");
+		SetAllOutputsNull(outSolveInstance);
+		return;
+	}
+	Matrix3x4 plane = inSolveInstance[4].GetMatrix3x4();
+
+	///////////////////
+	// COMPONENT'S WORK
+
+	VariantVector boundaries;
+	PODVector<bool> holes;
+	PODVector<int> regions;
+	bool success = Geomlib::PolygonBoolean(
+		polylinesA,
+		polylinesB,
+		(Geomlib::PolygonOperation)operation,
+		evenOdd ? Geomlib::FILL_EVENODD : Geomlib::FILL_NONZERO,
+		plane,
+		boundaries,
+		holes,
+		regions
+	);
+	if (!success) {
+		URHO3D_LOGWARNING("Curve_PolygonBoolean -- needs at least one valid polyline");
+		SetAllOutputsNull(outSolveInstance);
+		return;
+	}
+
+	VariantVector holeFlags(holes.Size());
+	VariantVector regionIndices(regions.Size());
+	for (unsigned i = 0; i < holes.Size(); ++i) {
+		holeFlags[i] = holes[i];
+		regionIndices[i] = regions[i];
+	}
+
+	/////////////////
+	// ASSIGN OUTPUTS
+
+	outSolveInstance[0] = boundaries;
+	outSolveInstance[1] = holeFlags;
+	outSolveInstance[2] = regionIndices;
+}
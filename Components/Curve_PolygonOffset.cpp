@@ -0,0 +1,174 @@
+//
+// Copyright (c) 2016 - 2017 Mesh Consultants Inc.
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "Curve_PolygonOffset.h"
+
+#include <assert.h>
+
+#include <Urho3D/Core/Variant.h>
+#include <Urho3D/Math/Matrix3x4.h>
+
+#include "Geomlib_PolygonClipping.h"
+
+using namespace Urho3D;
+
+String Curve_PolygonOffset::iconTexture = "Textures/Icons/Curve_OffsetPolyline.png";
+
+Curve_PolygonOffset::Curve_PolygonOffset(Context* context) :
+	IoComponentBase(context, 5, 3)
+{
+	SetName("PolygonOffset");
+	SetFullName("Polygon Offset");
+	SetDescription("Grows or shrinks the region bounded by closed polylines in a plane, merging overlaps");
+	SetGroup(IoComponentGroup::CURVE);
+	SetSubgroup("Operators");
+
+	inputSlots_[0]->SetName("Polylines");
+	inputSlots_[0]->SetVariableName("P");
+	inputSlots_[0]->SetDescription("Closed polylines bounding the region; holes wind opposite to their outline");
+	inputSlots_[0]->SetVariantType(VariantType::VAR_VARIANTMAP);
+	inputSlots_[0]->SetDataAccess(DataAccess::LIST);
+
+	inputSlots_[1]->SetName("Distance");
+	inputSlots_[1]->SetVariableName("D");
+	inputSlots_[1]->SetDescription("Distance to offset by, negative to shrink");
+	inputSlots_[1]->SetVariantType(VariantType::VAR_FLOAT);
+	inputSlots_[1]->SetDataAccess(DataAccess::ITEM);
+	inputSlots_[1]->SetDefaultValue(1.0f);
+	inputSlots_[1]->DefaultSet();
+
+	inputSlots_[2]->SetName("Join");
+	inputSlots_[2]->SetVariableName("J");
+	inputSlots_[2]->SetDescription("Corner join: 0 miter, 1 round, 2 square");
+	inputSlots_[2]->SetVariantType(VariantType::VAR_INT);
+	inputSlots_[2]->SetDataAccess(DataAccess::ITEM);
+	inputSlots_[2]->SetDefaultValue(0);
+	inputSlots_[2]->DefaultSet();
+
+	inputSlots_[3]->SetName("MiterLimit");
+	inputSlots_[3]->SetVariableName("M");
+	inputSlots_[3]->SetDescription("Longest miter as a multiple of the distance, sharper corners are squared off");
+	inputSlots_[3]->SetVariantType(VariantType::VAR_FLOAT);
+	inputSlots_[3]->SetDataAccess(DataAccess::ITEM);
+	inputSlots_[3]->SetDefaultValue(2.0f);
+	inputSlots_[3]->DefaultSet();
+
+	inputSlots_[4]->SetName("Plane");
+	inputSlots_[4]->SetVariableName("T");
+	inputSlots_[4]->SetDescription("Transform whose XZ plane the polylines are projected to");
+	inputSlots_[4]->SetVariantType(VariantType::VAR_MATRIX3X4);
+	inputSlots_[4]->SetDataAccess(DataAccess::ITEM);
+	inputSlots_[4]->SetDefaultValue(Matrix3x4::IDENTITY);
+	inputSlots_[4]->DefaultSet();
+
+	outputSlots_[0]->SetName("Boundaries");
+	outputSlots_[0]->SetVariableName("O");
+	outputSlots_[0]->SetDescription("Closed offset polylines, each outline followed by its holes");
+	outputSlots_[0]->SetVariantType(VariantType::VAR_VARIANTMAP);
+	outputSlots_[0]->SetDataAccess(DataAccess::LIST);
+
+	outputSlots_[1]->SetName("IsHole");
+	outputSlots_[1]->SetVariableName("H");
+	outputSlots_[1]->SetDescription("Whether each boundary is a hole");
+	outputSlots_[1]->SetVariantType(VariantType::VAR_BOOL);
+	outputSlots_[1]->SetDataAccess(DataAccess::LIST);
+
+	outputSlots_[2]->SetName("Region");
+	outputSlots_[2]->SetVariableName("R");
+	outputSlots_[2]->SetDescription("Index of the region each boundary belongs to");
+	outputSlots_[2]->SetVariantType(VariantType::VAR_INT);
+	outputSlots_[2]->SetDataAccess(DataAccess::LIST);
+}
+
+void Curve_PolygonOffset::SolveInstance(
+	const Vector<Variant>& inSolveInstance,
+	Vector<Variant>& outSolveInstance
+)
+{
+	assert(inSolveInstance.Size() == inputSlots_.Size());
+	assert(outSolveInstance.Size() == outputSlots_.Size());
+
+	///////////////////
+	// VERIFY & EXTRACT
+
+	const VariantVector& polylines = inSolveInstance[0].GetVariantVector();
+
+	VariantType type1 = inSolveInstance[1].GetType();
+	if (!(type1 == VariantType::VAR_FLOAT || type1 == VariantType::VAR_INT)) {
+		URHO3D_LOGWARNING("Curve_PolygonOffset -- D must be an int or float type");
+		SetAllOutputsNull(outSolveInstance);
+		return;
+	}
+	float distance = inSolveInstance[1].GetFloat();
+
+	int join = inSolveInstance[2].GetInt();
+	if (join < Geomlib::JOIN_MITER || join > Geomlib::JOIN_SQUARE) {
+		URHO3D_LOGWARNING("Curve_PolygonOffset -- J must be 0, 1 or 2");
+		SetAllOutputsNull(outSolveInstance);
+		return;
+	}
+
+	float miterLimit = inSolveInstance[3].GetFloat();
+
+	if (inSolveInstance[4].GetType() != VariantType::VAR_MATRIX3X4) {
+		URHO3D_LOGWARNING("Curve_PolygonOffset -- T must be a valid transform");
+		SetAllOutputsNull(outSolveInstance);
+		return;
+	}
+	Matrix3x4 plane = inSolveInstance[4].GetMatrix3x4();
+
+	///////////////////
+	// COMPONENT'S WORK
+
+	VariantVector boundaries;
+	PODVector<bool> holes;
+	PODVector<int> regions;
+	bool success = Geomlib::PolygonOffset(
+		polylines,
+		distance,
+		(Geomlib::PolygonJoin)join,
+		miterLimit,
+		plane,
+		boundaries,
+		holes,
+		regions
+	);
+	if (!success) {
+		URHO3D_LOGWARNING("Curve_PolygonOffset -- needs at least one valid polyline");
+		SetAllOutputsNull(outSolveInstance);
+		return;
+	}
+
+	VariantVector holeFlags(holes.Size());
+	VariantVector regionIndices(regions.Size());
+	for (unsigned i = 0; i < holes.Size(); ++i) {
+		holeFlags[i] = holes[i];
+		regionIndices[i] = regions[i];
+	}
+
+	/////////////////
+	// ASSIGN OUTPUTS
+
+	outSolveInstance[0] = boundaries;
+	outSolveInstance[1] = holeFlags;
+	outSolveInstance[2] = regionIndices;
+}
@@ -25,7 +25,7 @@
 #include <assert.h>
 
 #include "Polyline.h"
-#include "Geomlib_PolylinePointFromParameter.h"
+#include "Geomlib_PolylineEvaluator.h"
 
 using namespace Urho3D;
 
@@ -36,7 +36,7 @@ Curve_PolylineEvaluate::Curve_PolylineEvaluate(Context* context) :
 {
 	SetName("EvaluatePolyline");
 	SetFullName("Evaluate Polyline");
-	SetDescription("Evaluate point on polyline from parameter");
+	SetDescription("Evaluate points on polyline from parameters");
 	SetGroup(IoComponentGroup::CURVE);
 	SetSubgroup("Geometry");
 
@@ -48,23 +48,33 @@ Curve_PolylineEvaluate::Curve_PolylineEvaluate(Context* context) :
 
 	inputSlots_[1]->SetName("Parameter");
 	inputSlots_[1]->SetVariableName("T");
-	inputSlots_[1]->SetDescription("Parameter to evaluate");
+	inputSlots_[1]->SetDescription("Parameters to evaluate");
 	inputSlots_[1]->SetVariantType(VariantType::VAR_FLOAT);
-	inputSlots_[1]->SetDataAccess(DataAccess::ITEM);
+	inputSlots_[1]->SetDataAccess(DataAccess::LIST);
 	inputSlots_[1]->SetDefaultValue(Variant(0.5f));
 	inputSlots_[1]->DefaultSet();
 
 	outputSlots_[0]->SetName("Point");
 	outputSlots_[0]->SetVariableName("P");
-	outputSlots_[0]->SetDescription("Point on polyline corresponding to parameter");
+	outputSlots_[0]->SetDescription("Points on polyline corresponding to parameters");
 	outputSlots_[0]->SetVariantType(VariantType::VAR_VECTOR3);
-	outputSlots_[0]->SetDataAccess(DataAccess::ITEM);
+	outputSlots_[0]->SetDataAccess(DataAccess::LIST);
 
 	outputSlots_[1]->SetName("Transform");
 	outputSlots_[1]->SetVariableName("T");
-	outputSlots_[1]->SetDescription("Transform on polyline corresponding to parameter");
+	outputSlots_[1]->SetDescription("Transforms on polyline corresponding to parameters");
 	outputSlots_[1]->SetVariantType(VariantType::VAR_MATRIX3X4);
-	outputSlots_[1]->SetDataAccess(DataAccess::ITEM);
+	outputSlots_[1]->SetDataAccess(DataAccess::LIST);
+}
+
+void Curve_PolylineEvaluate::LoadInputAccess(unsigned inputIndex, DataAccess savedAccess)
+{
+	// Parameter used to be an item, old graphs keep one point per parameter in the branch they were saved with
+	if (inputIndex == 1 && savedAccess == DataAccess::ITEM) {
+		inputSlots_[1]->SetDataAccess(DataAccess::ITEM);
+		outputSlots_[0]->SetDataAccess(DataAccess::ITEM);
+		outputSlots_[1]->SetDataAccess(DataAccess::ITEM);
+	}
 }
 
 void Curve_PolylineEvaluate::SolveInstance(
@@ -86,38 +96,62 @@ void Curve_PolylineEvaluate::SolveInstance(
 	}
 	Variant polyline = inSolveInstance[0];
 	// Verify input slot 1
-	if (inSolveInstance[1].GetType() != VariantType::VAR_FLOAT) {
-		URHO3D_LOGWARNING("T must have type float.");
-		outSolveInstance[0] = Variant();
-		return;
+	// graphs saved before Parameter took a list keep item access, see LoadInputAccess
+	bool singleParameter = inSolveInstance[1].GetType() != VAR_VARIANTVECTOR;
+	VariantVector tList;
+	if (singleParameter) {
+		tList.Push(inSolveInstance[1]);
 	}
-	float t = inSolveInstance[1].GetFloat();
-	if (t < 0.0f || t > 1.0f) {
-		URHO3D_LOGWARNING("T must be in range 0.0f <= T <= 1.0f.");
-		outSolveInstance[0] = Variant();
-		return;
+	else {
+		tList = inSolveInstance[1].GetVariantVector();
+	}
+
+	// invalid parameters are evaluated at 0 and get null outputs, so the outputs stay aligned with T
+	PODVector<float> ts(tList.Size());
+	PODVector<bool> validT(tList.Size());
+	for (unsigned i = 0; i < tList.Size(); ++i) {
+		float t = tList[i].GetFloat();
+		validT[i] = tList[i].GetType() == VAR_FLOAT && t >= 0.0f && t <= 1.0f;
+		ts[i] = validT[i] ? t : 0.0f;
+		if (!validT[i]) {
+			URHO3D_LOGWARNING("T must have type float in range 0.0f <= T <= 1.0f.");
+		}
 	}
 
 	///////////////////
 	// COMPONENT'S WORK
 
-	Vector3 point;
-	Urho3D::Matrix3x4 transform;
-	bool success = Geomlib::PolylinePointFromParameter(polyline, t, point);
-	bool success_transform = Geomlib::PolylineTransformFromParameter(polyline, t, transform);
-
-
-
-	if (!success || !success_transform) {
+	// one evaluator and a single forward walk serve all parameters and both outputs
+	std::shared_ptr<const Geomlib::PolylineEvaluator> evaluator = Geomlib::PolylineEvaluator::Get(polyline);
+	if (!evaluator || evaluator->GetNumVertices() < 2 || Equals(evaluator->GetLength(), 0.0f)) {
 		URHO3D_LOGWARNING("EvaluatePolyline operation failed.");
 		outSolveInstance[0] = Variant();
 		outSolveInstance[1] = Variant();
 		return;
 	}
 
+	PODVector<Vector3> points;
+	PODVector<Matrix3x4> transforms;
+	evaluator->Evaluate(ts, &points, 0, &transforms);
+
 	/////////////////
 	// ASSIGN OUTPUTS
 
-	outSolveInstance[0] = Variant(point);
-	outSolveInstance[1] = Variant(transform);
+	VariantVector pointList(ts.Size());
+	VariantVector transformList(ts.Size());
+	for (unsigned i = 0; i < ts.Size(); ++i) {
+		if (validT[i]) {
+			pointList[i] = points[i];
+			transformList[i] = transforms[i];
+		}
+	}
+
+	if (singleParameter) {
+		outSolveInstance[0] = pointList[0];
+		outSolveInstance[1] = transformList[0];
+	}
+	else {
+		outSolveInstance[0] = pointList;
+		outSolveInstance[1] = transformList;
+	}
 }
\ No newline at end of file
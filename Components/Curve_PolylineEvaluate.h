@@ -29,10 +29,14 @@ class URHO3D_API Curve_PolylineEvaluate : public IoComponentBase {
 public:
 	Curve_PolylineEvaluate(Urho3D::Context* context);
 
+	void LoadInputAccess(unsigned inputIndex, DataAccess savedAccess);
+
 	void SolveInstance(
 		const Urho3D::Vector<Urho3D::Variant>& inSolveInstance,
 		Urho3D::Vector<Urho3D::Variant>& outSolveInstance
 	);
 
+	bool IsThreadSafe() const { return true; }
+
 	static Urho3D::String iconTexture;
 };
\ No newline at end of file
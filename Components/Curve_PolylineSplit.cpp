@@ -0,0 +1,160 @@
+//
+// Copyright (c) 2016 - 2017 Mesh Consultants Inc.
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "Curve_PolylineSplit.h"
+
+#include <assert.h>
+
+#include <Urho3D/Core/Variant.h>
+#include <Urho3D/Math/Matrix3x4.h>
+
+#include "Geomlib_PolylineIntersection.h"
+
+using namespace Urho3D;
+
+String Curve_PolylineSplit::iconTexture = "Textures/Icons/Curve_PolylineDivide.png";
+
+Curve_PolylineSplit::Curve_PolylineSplit(Context* context) :
+	IoComponentBase(context, 4, 3)
+{
+	SetName("PolylineSplit");
+	SetFullName("Split Polylines At Intersections");
+	SetDescription("Splits polylines wherever they cross or touch each other or themselves");
+	SetGroup(IoComponentGroup::CURVE);
+	SetSubgroup("Operators");
+
+	inputSlots_[0]->SetName("Polylines");
+	inputSlots_[0]->SetVariableName("P");
+	inputSlots_[0]->SetDescription("Polylines to split");
+	inputSlots_[0]->SetVariantType(VariantType::VAR_VARIANTMAP);
+	inputSlots_[0]->SetDataAccess(DataAccess::LIST);
+
+	inputSlots_[1]->SetName("Tolerance");
+	inputSlots_[1]->SetVariableName("D");
+	inputSlots_[1]->SetDescription("Segments closer than this are treated as intersecting");
+	inputSlots_[1]->SetVariantType(VariantType::VAR_FLOAT);
+	inputSlots_[1]->SetDataAccess(DataAccess::ITEM);
+	inputSlots_[1]->SetDefaultValue(0.001f);
+	inputSlots_[1]->DefaultSet();
+
+	inputSlots_[2]->SetName("Planar");
+	inputSlots_[2]->SetVariableName("F");
+	inputSlots_[2]->SetDescription("Intersect the polylines as projected to the plane, rather than in 3D");
+	inputSlots_[2]->SetVariantType(VariantType::VAR_BOOL);
+	inputSlots_[2]->SetDataAccess(DataAccess::ITEM);
+	inputSlots_[2]->SetDefaultValue(true);
+	inputSlots_[2]->DefaultSet();
+
+	inputSlots_[3]->SetName("Plane");
+	inputSlots_[3]->SetVariableName("T");
+	inputSlots_[3]->SetDescription("Transform whose XZ plane the polylines are projected to");
+	inputSlots_[3]->SetVariantType(VariantType::VAR_MATRIX3X4);
+	inputSlots_[3]->SetDataAccess(DataAccess::ITEM);
+	inputSlots_[3]->SetDefaultValue(Matrix3x4::IDENTITY);
+	inputSlots_[3]->DefaultSet();
+
+	outputSlots_[0]->SetName("Pieces");
+	outputSlots_[0]->SetVariableName("O");
+	outputSlots_[0]->SetDescription("Polylines running between consecutive intersections");
+	outputSlots_[0]->SetVariantType(VariantType::VAR_VARIANTMAP);
+	outputSlots_[0]->SetDataAccess(DataAccess::LIST);
+
+	outputSlots_[1]->SetName("Source");
+	outputSlots_[1]->SetVariableName("S");
+	outputSlots_[1]->SetDescription("Index of the input polyline each piece comes from");
+	outputSlots_[1]->SetVariantType(VariantType::VAR_INT);
+	outputSlots_[1]->SetDataAccess(DataAccess::LIST);
+
+	outputSlots_[2]->SetName("Points");
+	outputSlots_[2]->SetVariableName("X");
+	outputSlots_[2]->SetDescription("Intersection points");
+	outputSlots_[2]->SetVariantType(VariantType::VAR_VECTOR3);
+	outputSlots_[2]->SetDataAccess(DataAccess::LIST);
+}
+
+void Curve_PolylineSplit::SolveInstance(
+	const Vector<Variant>& inSolveInstance,
+	Vector<Variant>& outSolveInstance
+)
+{
+	assert(inSolveInstance.Size() == inputSlots_.Size());
+	assert(outSolveInstance.Size() == outputSlots_.Size());
+
+	///////////////////
+	// VERIFY & EXTRACT
+
+	const VariantVector& polylines = inSolveInstance[0].GetVariantVector();
+
+	VariantType type1 = inSolveInstance[1].GetType();
+	if (!(type1 == VariantType::VAR_FLOAT || type1 == VariantType::VAR_INT)) {
+		URHO3D_LOGWARNING("Curve_PolylineSplit -- D must be an int or float type");
+		SetAllOutputsNull(outSolveInstance);
+		return;
+	}
+	float tolerance = inSolveInstance[1].GetFloat();
+	if (tolerance < 0.0f) {
+		URHO3D_LOGWARNING("Curve_PolylineSplit -- D must not be negative");
+		SetAllOutputsNull(outSolveInstance);
+		return;
+	}
+
+	bool planar = inSolveInstance[2].GetBool();
+
+	if (inSolveInstance[3].GetType() != VariantType::VAR_MATRIX3X4) {
+		URHO3D_LOGWARNING("Curve_PolylineSplit -- T must be a valid transform");
+		SetAllOutputsNull(outSolveInstance);
+		return;
+	}
+	Matrix3x4 plane = inSolveInstance[3].GetMatrix3x4();
+
+	///////////////////
+	// COMPONENT'S WORK
+
+	PODVector<Geomlib::PolylineIntersection> intersections;
+	Geomlib::PolylineIntersections(polylines, tolerance, planar ? &plane : 0, true, intersections);
+
+	VariantVector pieces;
+	PODVector<int> sources;
+	Geomlib::PolylineSplitAtIntersections(polylines, intersections, pieces, sources);
+	if (pieces.Empty()) {
+		URHO3D_LOGWARNING("Curve_PolylineSplit -- needs at least one valid polyline");
+		SetAllOutputsNull(outSolveInstance);
+		return;
+	}
+
+	VariantVector sourceIndices(sources.Size());
+	for (unsigned i = 0; i < sources.Size(); ++i) {
+		sourceIndices[i] = sources[i];
+	}
+
+	VariantVector points(intersections.Size());
+	for (unsigned i = 0; i < intersections.Size(); ++i) {
+		points[i] = intersections[i].point_;
+	}
+
+	/////////////////
+	// ASSIGN OUTPUTS
+
+	outSolveInstance[0] = pieces;
+	outSolveInstance[1] = sourceIndices;
+	outSolveInstance[2] = points;
+}
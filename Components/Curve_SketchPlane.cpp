@@ -280,7 +280,7 @@ void Curve_SketchPlane::HandleDragEnd(Urho3D::StringHash eventType, Urho3D::Vari
 	Variant lastPoly = Polyline_Make(trackedPoints_);
 	trackedCurves_.Push(lastPoly);
 
-	solvedFlag_ = 0;
+	MarkUnsolved();
 	GetSubsystem<IoGraph>()->QuickTopoSolveGraph();
 }
 
@@ -154,7 +154,7 @@ void Geometry_WriteDXF::SolveInstance(
 
 		//only support triangle meshes right now
 		if (TriMesh_Verify((*mMap))) {
-			dWriter->SetMesh((*mMap)["vertices"].GetVariantVector(), (*mMap)["faces"].GetVariantVector(), layer);
+			dWriter->SetMesh(TriMesh_GetVertexList(*mMap), TriMesh_GetFaceList(*mMap), layer);
 		}
 		else if (NMesh_Verify((*mMap))) {
 			Variant triMesh = NMesh_ConvertToTriMesh(*mMap);
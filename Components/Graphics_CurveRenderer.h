@@ -40,6 +40,8 @@ public:
 		Urho3D::Vector<Urho3D::Variant>& outSolveInstance
 	);
 
+	bool IsVisibleOutput() const { return true; }
+
 	Urho3D::Vector<int> trackedItems;
 
 };
\ No newline at end of file
@@ -43,6 +43,8 @@ public:
 		Urho3D::Vector<Urho3D::Variant>& outSolveInstance
 		);
 
+	bool IsVisibleOutput() const { return true; }
+
 	Urho3D::Vector<Urho3D::SharedPtr<Urho3D::Model> > trackedItems;
 	int autoNameCounter = 0;
 
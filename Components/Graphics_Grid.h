@@ -42,5 +42,7 @@ public:
 		Urho3D::Vector<Urho3D::Variant>& outSolveInstance
 	);
 
+	bool IsVisibleOutput() const { return true; }
+
 	Urho3D::Vector<int> trackedItems_;
 };
\ No newline at end of file
@@ -37,7 +37,8 @@ using namespace Urho3D;
 
 String Graphics_MeshRenderer::iconTexture = "Textures/Icons/Scene_MeshRenderer.png";
 
-Graphics_MeshRenderer::Graphics_MeshRenderer(Urho3D::Context* context) : IoComponentBase(context, 4, 3)
+Graphics_MeshRenderer::Graphics_MeshRenderer(Urho3D::Context* context) : IoComponentBase(context, 4, 3),
+	renderCache(context)
 {
 	SetName("MeshRenderer");
 	SetFullName("MeshRenderer");
@@ -97,34 +98,13 @@ Graphics_MeshRenderer::~Graphics_MeshRenderer()
 
 void Graphics_MeshRenderer::PreLocalSolve()
 {
-	//delete old nodes
-	Scene* scene = (Scene*)GetGlobalVar("Scene").GetPtr();
-	if (scene)
-	{
-		for (int i = 0; i < trackedItems.Size(); i++)
-		{
-			Node* oldNode = scene->GetNode(trackedItems[i]);
-			if (oldNode)
-			{
-				oldNode->Remove();
-			}
-
-		}
-
-		trackedItems.Clear();
-	}
-
-	//release resource
-	ResourceCache* rc = GetSubsystem<ResourceCache>();
-	for (int i = 0; i < trackedResources.Size(); i++)
-	{
-		String resourcePath = trackedResources[i];
-		if(resourcePath.Contains("tmp/models/"))
-			rc->ReleaseResource<Model>(trackedResources[i]);
-		if (resourcePath.Contains("tmp/materials/"))
-			rc->ReleaseResource<Material>(trackedResources[i]);
-	}
+	renderCache.BeginSolve();
+}
 
+void Graphics_MeshRenderer::PostLocalSolve()
+{
+	//nodes and resources of items that were not drawn again are removed here
+	renderCache.EndSolve();
 }
 
 void Graphics_MeshRenderer::SolveInstance(
@@ -179,7 +159,6 @@ void Graphics_MeshRenderer::SolveInstance(
             if (nodeId == -1)
                 SetAllOutputsNull(outSolveInstance);
         
-            trackedItems.Push(nodeId);
             outSolveInstance[0] = nodeId;
             outSolveInstance[1] = model_pointer.GetPtr();
 			outSolveInstance[2] = model_name;
@@ -193,7 +172,6 @@ void Graphics_MeshRenderer::SolveInstance(
             if (nodeId == -1)
                 SetAllOutputsNull(outSolveInstance);
             
-            trackedItems.Push(nodeId);
             outSolveInstance[0] = nodeId;
             outSolveInstance[1] = model_pointer.GetPtr();
 	    outSolveInstance[2] = model_name;
@@ -207,6 +185,23 @@ void Graphics_MeshRenderer::SolveInstance(
 	}
 }
 
+namespace {
+
+// preview colors tinted by the normal direction
+void NormalColors(const PODVector<Vector3>& normals, PODVector<unsigned>& colors)
+{
+	colors.Resize(normals.Size());
+	for (unsigned i = 0; i < normals.Size(); i++)
+	{
+		Vector3 n = normals[i];
+		Color vCol = Color(n.x_, n.y_, n.z_, 1.0f);
+		vCol = 0.5f * (vCol + Color::WHITE);
+		colors[i] = vCol.ToUInt();
+	}
+}
+
+} // namespace
+
 int Graphics_MeshRenderer::TriMesh_Render(Urho3D::Variant trimesh,
                                           Urho3D::Context* context,
                                           Urho3D::String material_path,
@@ -215,147 +210,19 @@ int Graphics_MeshRenderer::TriMesh_Render(Urho3D::Variant trimesh,
                                           Urho3D::Variant& model_pointer,
 					  Urho3D::String& model_name)
 {
-    
-    Vector<VertexData> vbd;
-    Vector<Vector3> tmpVerts;
-    Vector<int> tmpFaces;
-    
-    VariantVector verts = TriMesh_GetVertexList(trimesh);
-    VariantVector faces = TriMesh_GetFaceList(trimesh);
-    VariantVector normals;
-    
-    if (flatShaded)
-    {
-        normals = TriMesh_ComputeFaceNormals(trimesh, true);
-        tmpFaces.Resize(faces.Size());
-        tmpVerts.Resize(faces.Size());
-        vbd.Resize(faces.Size());
-        
-        unsigned int vCol = Urho3D::Color::WHITE.ToUInt();
-        
-        //render with duplicate verts for flat face shading
-        for (unsigned i = 0; i < faces.Size(); i++)
-        {
-            int fId = faces[i].GetInt();
-            int normId = (int)floor((float)i / 3.0f);
-			Vector3 n = normals[normId].GetVector3();
-			Color vCol = Color(n.x_, n.y_, n.z_, 1.0f);
-			vCol = 0.5f * (vCol + Color::WHITE);
-            //unsigned int col = vCols[normId%numColors].GetColor().ToUInt();
-            if (fId < (int)verts.Size())
-            {
-                vbd[i].position = verts[fId].GetVector3();
-				vbd[i].normal = n;
-				vbd[i].color = vCol.ToUInt();
-                tmpVerts[i] = vbd[i].position;
-            }
-            
-            tmpFaces[i] = i;
-            
-        }
-    }
-    else
-    {
-        normals = TriMesh_ComputeVertexNormals(trimesh, true);
-        tmpFaces.Resize(faces.Size());
-        tmpVerts.Resize(verts.Size());
-        vbd.Resize(verts.Size());
-        unsigned int vCol = Color::WHITE.ToUInt();
-        
-        for (unsigned i = 0; i < verts.Size(); i++)
-        {
-			Vector3 n = normals[i].GetVector3();
-			Color vCol = Color(n.x_, n.y_, n.z_, 1.0f);
-			vCol = 0.5f * (vCol + Color::WHITE);
-			
-			vbd[i].position = verts[i].GetVector3();
-			vbd[i].normal = n;
-			vbd[i].color = vCol.ToUInt();
-            tmpVerts[i] = verts[i].GetVector3();
-        }
-        
-        for (unsigned i = 0; i < faces.Size(); i++)
-        {
-            tmpFaces[i] = faces[i].GetInt();
-        }
-    }
-    
-    SharedPtr<VertexBuffer> vb(new VertexBuffer(context));
-    SharedPtr<IndexBuffer> ib(new IndexBuffer(context));
-    
-    // Shadowed buffer needed for raycasts to work, and so that data can be automatically restored on device loss
-    vb->SetShadowed(true);
-    vb->SetSize(vbd.Size(), Urho3D::MASK_POSITION | Urho3D::MASK_NORMAL | Urho3D::MASK_COLOR);
-    vb->SetData((void*)&vbd[0]);
-    
-    ib->SetShadowed(true);
-    ib->SetSize(tmpFaces.Size(), true);
-    ib->SetData(&tmpFaces[0]);
-    
-    Geometry* geom = new Geometry(context);
-    geom->SetNumVertexBuffers(1);
-    geom->SetVertexBuffer(0, vb);
-    geom->SetIndexBuffer(ib);
-    geom->SetDrawRange(Urho3D::TRIANGLE_LIST, 0, faces.Size());
-    
-    SharedPtr<Model> model(new Model(context));
-    model->SetNumGeometries(1);
-    model->SetGeometry(0, 0, geom);
-    model->SetBoundingBox(BoundingBox(&tmpVerts[0], tmpVerts.Size()));
-    model->SetGeometryCenter(0, Vector3::ZERO);
-    
-    Vector<SharedPtr<VertexBuffer>> allVBuffers;
-    Vector<SharedPtr<IndexBuffer>> allIBuffers;
-    
-    allVBuffers.Push(vb);
-    allIBuffers.Push(ib);
-    
-    PODVector<unsigned int> morphStarts;
-    PODVector<unsigned int> morphRanges;
-    
-    model->SetVertexBuffers(allVBuffers, morphStarts, morphRanges);
-    model->SetIndexBuffers(allIBuffers);
+	PODVector<Vector3> positions;
+	PODVector<Vector3> normals;
+	PODVector<unsigned> colors;
+	PODVector<unsigned> indices;
 
-    //create a new node
-    Scene* scene = (Scene*)GetGlobalVar("Scene").GetPtr();
-    Material* mat = GetSubsystem<ResourceCache>()->GetResource<Material>(material_path);
-    if (!scene || !mat)
-    {
-        //SetAllOutputsNull(outSolveInstance);
-        return -1;
-    }
-    
-    Node* mNode = scene->CreateChild("MeshPreviewNode");
-    StaticModel* sm = mNode->CreateComponent<StaticModel>();
-    int smID = sm->GetID();
-    
-    SharedPtr<Material> cloneMat = mat->Clone();
-    cloneMat->SetName("tmp/materials/generated_mat_" + String(smID));
-	Color specColor = cloneMat->GetShaderParameter("MatSpecColor").GetColor();
-	Color existingColor = cloneMat->GetShaderParameter("MatDiffColor").GetColor();
-	Color blendColor = existingColor.MultiplyComponents(mainColor);
-    cloneMat->SetShaderParameter("MatDiffColor", blendColor);
-    model->SetName("tmp/models/generated_model_" + String(smID));
-    
-    //add these to the resource cache
-    ResourceCache* rc = GetSubsystem<ResourceCache>();
-    bool res = rc->AddManualResource(model);
-    res = rc->AddManualResource(cloneMat);
-    trackedResources.Push(cloneMat->GetName());
-    trackedResources.Push(model->GetName());
-    
-    sm->SetModel(model);
-    //sm->SetMaterial(cloneMat);
-    sm->SetMaterial(cloneMat);
-	sm->SetCastShadows(true);
-	sm->SetShadowDistance(100.0f);
-    
-    model_pointer = Variant(sm);
-    
-	std::cout << "model->GetName().CString() = " << model->GetName().CString() << std::endl;
-	model_name = model->GetName();
+	VariantVector vCols;
+	if (!TriMesh_GetRenderData(trimesh, vCols, flatShaded, positions, normals, colors, indices))
+	{
+		return -1;
+	}
+	NormalColors(normals, colors);
 
-    return mNode->GetID();
+	return RenderData(positions, normals, colors, indices, material_path, mainColor, true, model_pointer, model_name);
 }
 
 int Graphics_MeshRenderer::NMesh_Render(Urho3D::Variant nMesh,
@@ -366,12 +233,7 @@ int Graphics_MeshRenderer::NMesh_Render(Urho3D::Variant nMesh,
                                           Urho3D::Variant& model_pointer,
 					  Urho3D::String& model_name)
 {
-    
-    Vector<VertexData> vbd;
-    Vector<Vector3> tmpVerts;
-    Vector<int> tmpFaces;
-
-    VariantVector normals;
+    VariantVector normalList;
     VariantVector ngonTriList;
     VariantVector ngonTriList_unified;
     
@@ -380,12 +242,22 @@ int Graphics_MeshRenderer::NMesh_Render(Urho3D::Variant nMesh,
     Urho3D::Variant convertedMesh = NMesh_ConvertToTriMesh(nMesh, ngonTriList);
     
     Urho3D::Variant unifiedMesh = TriMesh_UnifyNormals(convertedMesh);
+
+    // if it is smooth-shaded, just compute as smoothshaded trimesh
+    if (!flatShaded)
+    {
+        return TriMesh_Render(unifiedMesh, context, material_path, flatShaded, mainColor, model_pointer, model_name);
+    }
     
     VariantVector verts = TriMesh_GetVertexList(unifiedMesh);
     
     // only for the size:
     VariantVector triFaceList = TriMesh_GetFaceList(unifiedMesh);
     int numb_tris = triFaceList.Size();
+    if (numb_tris == 0)
+    {
+        return -1;
+    }
     
     // make a copy of faceTris that has the new ordering
     int counter = 0;
@@ -400,119 +272,94 @@ int Graphics_MeshRenderer::NMesh_Render(Urho3D::Variant nMesh,
     }
     
     // for now render each nGon face as actually planar
-    if (flatShaded)
+    PODVector<Vector3> positions(numb_tris);
+    PODVector<Vector3> normals(numb_tris);
+    PODVector<unsigned> colors;
+    PODVector<unsigned> indices(numb_tris);
+
+    normalList = TriMesh_ComputeFaceNormals(unifiedMesh, true);
+
+    //render with duplicate verts for flat face shading
+    // assign every triangle from a single ngon face to one normal.
+    int faceCounter = 0;
+    for (unsigned i = 0; i < ngonTriList_unified.Size(); i++)
     {
-        normals = TriMesh_ComputeFaceNormals(unifiedMesh, true);
-        tmpFaces.Resize(numb_tris);
-        tmpVerts.Resize(numb_tris);
-        vbd.Resize(numb_tris);
-        
-        unsigned int vCol = Urho3D::Color::WHITE.ToUInt();
-        
-        //render with duplicate verts for flat face shading
-        // assign every triangle from a single ngon face to one normal.
-        int faceCounter = 0;
-        for (unsigned i = 0; i < ngonTriList_unified.Size(); i++)
-        {
-            // Get the face list for the first n-gon face
-            VariantVector faces = ngonTriList_unified[i].GetVariantVector();
-            // take the first face of the ngon to compute the norm of the ngon
-            int normId = faceCounter;
-            for (int j = 0; j < faces.Size(); ++j){
-                int ID = 3*faceCounter +j;
-                int fId = faces[j].GetInt();
-				Vector3 n = normals[normId].GetVector3();;
-				Color vCol = Color(n.x_, n.y_, n.z_, 1.0f);
-				vCol = 0.5f * (vCol + Color::WHITE);
-                if (fId < (int)verts.Size())
-                {
-                    vbd[ID].position = verts[fId].GetVector3();
-					vbd[ID].normal = n;
-                    vbd[ID].color = vCol.ToUInt();
-                    tmpVerts[ID] = vbd[ID].position;
-                }
-                tmpFaces[ID] = ID;
-            }
-            faceCounter += faces.Size()/3;
+        // Get the face list for the first n-gon face
+        VariantVector faces = ngonTriList_unified[i].GetVariantVector();
+        // take the first face of the ngon to compute the norm of the ngon
+        int normId = faceCounter;
+        for (int j = 0; j < faces.Size(); ++j){
+            int ID = 3*faceCounter +j;
+            int fId = faces[j].GetInt();
+            positions[ID] = fId < (int)verts.Size() ? verts[fId].GetVector3() : Vector3::ZERO;
+            normals[ID] = normalList[normId].GetVector3();
+            indices[ID] = ID;
         }
+        faceCounter += faces.Size()/3;
     }
-    else
-    {
-        // if it is smooth-shaded, just compute as smoothshaded trimesh
-		String path_to_resource_ref;
-        return TriMesh_Render(unifiedMesh, context, material_path, flatShaded, mainColor, model_pointer, path_to_resource_ref);
-    }
-    
-    SharedPtr<VertexBuffer> vb(new VertexBuffer(context));
-    SharedPtr<IndexBuffer> ib(new IndexBuffer(context));
-    
-    // Shadowed buffer needed for raycasts to work, and so that data can be automatically restored on device loss
-    vb->SetShadowed(true);
-    vb->SetSize(vbd.Size(), Urho3D::MASK_POSITION | Urho3D::MASK_NORMAL | Urho3D::MASK_COLOR);
-    vb->SetData((void*)&vbd[0]);
-    
-    ib->SetShadowed(true);
-    ib->SetSize(tmpFaces.Size(), true);
-    ib->SetData(&tmpFaces[0]);
-    
-    Geometry* geom = new Geometry(context);
-    geom->SetNumVertexBuffers(1);
-    geom->SetVertexBuffer(0, vb);
-    geom->SetIndexBuffer(ib);
-    geom->SetDrawRange(Urho3D::TRIANGLE_LIST, 0, numb_tris);
-    
-    SharedPtr<Model> model(new Model(context));
-    model->SetNumGeometries(1);
-    model->SetGeometry(0, 0, geom);
-    model->SetBoundingBox(BoundingBox(&tmpVerts[0], tmpVerts.Size()));
-    model->SetGeometryCenter(0, Vector3::ZERO);
-    
-    Vector<SharedPtr<VertexBuffer>> allVBuffers;
-    Vector<SharedPtr<IndexBuffer>> allIBuffers;
-    
-    allVBuffers.Push(vb);
-    allIBuffers.Push(ib);
-    
-    PODVector<unsigned int> morphStarts;
-    PODVector<unsigned int> morphRanges;
-    
-    model->SetVertexBuffers(allVBuffers, morphStarts, morphRanges);
-    model->SetIndexBuffers(allIBuffers);
-    
-    //create a new node
-    Scene* scene = (Scene*)GetGlobalVar("Scene").GetPtr();
-    Material* mat = GetSubsystem<ResourceCache>()->GetResource<Material>(material_path);
-    if (!scene || !mat)
-    {
-        //SetAllOutputsNull(outSolveInstance);
-        return -1;
-    }
-    
-    Node* mNode = scene->CreateChild("MeshPreviewNode");
-    StaticModel* sm = mNode->CreateComponent<StaticModel>();
-    int smID = sm->GetID();
-    
-	SharedPtr<Material> cloneMat = mat->Clone();
-	cloneMat->SetName("tmp/materials/generated_mat_" + String(smID));
+    NormalColors(normals, colors);
+
+    return RenderData(positions, normals, colors, indices, material_path, mainColor, false, model_pointer, model_name);
+}
+
+int Graphics_MeshRenderer::RenderData(
+	const PODVector<Vector3>& positions,
+	const PODVector<Vector3>& normals,
+	const PODVector<unsigned>& colors,
+	const PODVector<unsigned>& indices,
+	Urho3D::String material_path,
+	Urho3D::Color mainColor,
+	bool castShadows,
+	Urho3D::Variant& model_pointer,
+	Urho3D::String& model_name)
+{
+	Scene* scene = (Scene*)GetGlobalVar("Scene").GetPtr();
+	Material* mat = GetSubsystem<ResourceCache>()->GetResource<Material>(material_path);
+	if (!scene || !mat)
+	{
+		return -1;
+	}
+
+	// reuse this item's node, buffers and material from the last solve
+	unsigned item = renderCache.FindItem(solvePath_, solveIndex_);
+	Model* model = renderCache.UpdateModel(item, positions, normals, colors, indices);
+	if (!model)
+	{
+		return -1;
+	}
+
+	StaticModel* sm = renderCache.GetStaticModel(item, scene, "MeshPreviewNode");
+	int smID = sm->GetID();
+	Material* cloneMat = renderCache.GetMaterial(item, mat);
+
+	//add these to the resource cache the first time round; the render cache releases them again
+	ResourceCache* rc = GetSubsystem<ResourceCache>();
+	if (cloneMat->GetName().Empty())
+	{
+		cloneMat->SetName("tmp/materials/generated_mat_" + String(smID));
+		rc->AddManualResource(cloneMat);
+	}
+	if (model->GetName().Empty())
+	{
+		model->SetName("tmp/models/generated_model_" + String(smID));
+		rc->AddManualResource(model);
+	}
+
 	Color existingColor = cloneMat->GetShaderParameter("MatDiffColor").GetColor();
 	Color blendColor = existingColor.MultiplyComponents(mainColor);
 	cloneMat->SetShaderParameter("MatDiffColor", blendColor);
-	model->SetName("tmp/models/generated_model_" + String(smID));
 
-	//add these to the resource cache
-	ResourceCache* rc = GetSubsystem<ResourceCache>();
-	bool res = rc->AddManualResource(model);
-	res = rc->AddManualResource(cloneMat);
-	trackedResources.Push(cloneMat->GetName());
-	trackedResources.Push(model->GetName());
-    
-    sm->SetModel(model);
-    sm->SetMaterial(cloneMat);
-    //sm->SetMaterial(mat);
-    
-    model_pointer = Variant(sm);
-    model_name = model->GetName();
-    return mNode->GetID();
-}
+	sm->SetModel(model);
+	sm->SetMaterial(cloneMat);
+	// set either way, the StaticModel may be reused from an item that did cast shadows
+	sm->SetCastShadows(castShadows);
+	if (castShadows)
+	{
+		sm->SetShadowDistance(100.0f);
+	}
 
+	model_pointer = Variant(sm);
+	model_name = model->GetName();
 
+	return sm->GetNode()->GetID();
+}
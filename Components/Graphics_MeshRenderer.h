@@ -23,6 +23,7 @@
 #pragma once
 
 #include "IoComponentBase.h"
+#include "IoRenderCache.h"
 #include <Urho3D/Graphics/Model.h>
 
 //vertex data types
@@ -44,11 +45,14 @@ public:
 	static Urho3D::String iconTexture;
 
 	virtual void PreLocalSolve();
+	virtual void PostLocalSolve();
 
 	void SolveInstance(
 		const Urho3D::Vector<Urho3D::Variant>& inSolveInstance,
 		Urho3D::Vector<Urho3D::Variant>& outSolveInstance
 		);
+
+	bool IsVisibleOutput() const { return true; }
     
     int TriMesh_Render(
 		Urho3D::Variant trimesh,
@@ -71,8 +75,19 @@ public:
 	Urho3D::String normalMat = "Materials/BasicPBR.xml";
 	Urho3D::String normalAlphaMat = "Materials/BasicPBRAlpha.xml";
 
-	Urho3D::Vector<int> trackedItems;
-	Urho3D::Vector<Urho3D::String> trackedResources;
-	int autoNameCounter = 0;
+	IoRenderCache renderCache;
+
+private:
+	int RenderData(
+		const Urho3D::PODVector<Urho3D::Vector3>& positions,
+		const Urho3D::PODVector<Urho3D::Vector3>& normals,
+		const Urho3D::PODVector<unsigned>& colors,
+		const Urho3D::PODVector<unsigned>& indices,
+		Urho3D::String material_path,
+		Urho3D::Color mainColor,
+		bool castShadows,
+		Urho3D::Variant& model_pointer,
+		Urho3D::String& model_name
+	);
 
 };
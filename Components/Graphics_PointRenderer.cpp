@@ -34,7 +34,8 @@ using namespace Urho3D;
 String Graphics_PointRenderer::iconTexture = "Textures/Icons/Graphics_PointRenderer.png";
 
 
-Graphics_PointRenderer::Graphics_PointRenderer(Urho3D::Context* context) : IoComponentBase(context, 5, 2)
+Graphics_PointRenderer::Graphics_PointRenderer(Urho3D::Context* context) : IoComponentBase(context, 5, 2),
+	renderCache(context)
 {
 	SetName("Display");
 	SetFullName("Geometry Display");
@@ -48,9 +49,9 @@ Graphics_PointRenderer::Graphics_PointRenderer(Urho3D::Context* context) : IoCom
 
 	inputSlots_[1]->SetName("Color");
 	inputSlots_[1]->SetVariableName("C");
-	inputSlots_[1]->SetDescription("Color to Display");
+	inputSlots_[1]->SetDescription("Color to Display, one per point or cycled");
 	inputSlots_[1]->SetVariantType(VariantType::VAR_COLOR);
-	inputSlots_[1]->SetDataAccess(DataAccess::ITEM);
+	inputSlots_[1]->SetDataAccess(DataAccess::LIST);
 	inputSlots_[1]->SetDefaultValue(Color(0.9f, 0.6f, 0.9f, 1.0f));
 	inputSlots_[1]->DefaultSet();
 
@@ -86,29 +87,29 @@ Graphics_PointRenderer::Graphics_PointRenderer(Urho3D::Context* context) : IoCom
 
 	outputSlots_[1]->SetName("BillboardSet");
 	outputSlots_[1]->SetVariableName("B");
-	outputSlots_[1]->SetDescription("Pointer to billboard set");
+	outputSlots_[1]->SetDescription("Pointer to billboard set, left empty when the points are drawn as a point cloud");
 	outputSlots_[1]->SetVariantType(VariantType::VAR_PTR); // this would change to VAR_FLOAT if access becomes LIST
 	outputSlots_[1]->SetDataAccess(DataAccess::ITEM);
 
 }
 
-void Graphics_PointRenderer::PreLocalSolve()
+void Graphics_PointRenderer::LoadInputAccess(unsigned inputIndex, DataAccess savedAccess)
 {
-	Scene* scene = (Scene*)GetGlobalVar("Scene").GetPtr();
-	if (scene)
+	//Color used to be an item, old graphs drew every color of a branch as its own copy of the points
+	if (inputIndex == 1 && savedAccess == DataAccess::ITEM)
 	{
-		for (int i = 0; i < trackedItems.Size(); i++)
-		{
-			Node* n = scene->GetNode(trackedItems[i]);
-			if (n)
-			{
-				n->RemoveAllComponents();
-				n->Remove();
-			}
-		}
+		inputSlots_[1]->SetDataAccess(DataAccess::ITEM);
 	}
+}
+
+void Graphics_PointRenderer::PreLocalSolve()
+{
+	renderCache.BeginSolve();
+}
 
-	trackedItems.Clear();
+void Graphics_PointRenderer::PostLocalSolve()
+{
+	renderCache.EndSolve();
 }
 
 void Graphics_PointRenderer::SolveInstance(
@@ -124,64 +125,125 @@ void Graphics_PointRenderer::SolveInstance(
 		return;
 	}
 
-	ResourceCache* rc = GetSubsystem<ResourceCache>();
-	String pointMat = "Materials/BasicPoints.xml";
-	Material* baseMat = rc->GetResource<Material>(pointMat);
+	VariantVector points = inSolveInstance[0].GetVariantVector();
 
-	if (!baseMat)
+	if (points.Empty() || points[0].GetType() == VAR_NONE)
 	{
 		SetAllOutputsNull(outSolveInstance);
 		return;
 	}
 
-	VariantVector points = inSolveInstance[0].GetVariantVector();
+	//get the other data
+	String spritePath = inSolveInstance[2].GetString();
+	//graphs saved before Color took a list keep item access, see LoadInputAccess
+	VariantVector colorList;
+	if (inSolveInstance[1].GetType() == VAR_COLOR)
+	{
+		colorList.Push(inSolveInstance[1]);
+	}
+	else
+	{
+		colorList = inSolveInstance[1].GetVariantVector();
+	}
+	Vector3 size = inSolveInstance[3].GetVector3();
+	bool fixedSize = inSolveInstance[4].GetBool();
 
-	if (points.Empty() || points[0].GetType() == VAR_NONE)
+	//flatten the branch in one pass
+	PODVector<Vector3> positions;
+	positions.Reserve(points.Size());
+	for (unsigned i = 0; i < points.Size(); i++)
+	{
+		if (points[i].GetType() == VAR_VECTOR3)
+		{
+			positions.Push(points[i].GetVector3());
+		}
+	}
+
+	PODVector<Color> colors;
+	for (unsigned i = 0; i < colorList.Size(); i++)
+	{
+		if (colorList[i].GetType() == VAR_COLOR)
+		{
+			colors.Push(colorList[i].GetColor());
+		}
+	}
+	if (colors.Empty())
+	{
+		colors.Push(Color(0.9f, 0.6f, 0.9f, 1.0f));
+	}
+
+	if (positions.Empty())
 	{
 		SetAllOutputsNull(outSolveInstance);
 		return;
 	}
 
+	ResourceCache* rc = GetSubsystem<ResourceCache>();
+	unsigned item = renderCache.FindItem(solvePath_, solveIndex_);
+	Node* node = renderCache.GetNode(item, scene, ID + "_Preview");
 
-	//get the other data
-	String spritePath = inSolveInstance[2].GetString();
-	Color mainColor = inSolveInstance[1].GetColor();
-	Vector3 size = inSolveInstance[3].GetVector3();
-	bool fixedSize = inSolveInstance[4].GetBool();
+	//large sets are drawn as a chunked point list, sprites would cost a quad per point
+	if (positions.Size() > IO_MAX_BILLBOARD_POINTS)
+	{
+		//the billboard set stays, empty, so the output pointer is valid either way
+		BillboardSet* pointCloud = node->GetOrCreateComponent<BillboardSet>();
+		pointCloud->SetNumBillboards(0);
+		pointCloud->Commit();
+
+		PODVector<unsigned> vertexColors(colors.Size());
+		for (unsigned i = 0; i < colors.Size(); i++)
+		{
+			vertexColors[i] = colors[i].ToUInt();
+		}
+
+		Material* mat = renderCache.GetMaterial(item, rc->GetResource<Material>(pointCloudMat));
+		if (!mat)
+		{
+			SetAllOutputsNull(outSolveInstance);
+			return;
+		}
+		renderCache.UpdatePointCloud(item, scene, ID + "_Preview", positions, vertexColors, mat);
+
+		outSolveInstance[0] = node->GetID();
+		outSolveInstance[1] = pointCloud;
+		return;
+	}
+
+	Material* baseMat = rc->GetResource<Material>(pointMat);
+	if (!baseMat)
+	{
+		SetAllOutputsNull(outSolveInstance);
+		return;
+	}
 
 	//get texture if possible
 	Texture2D* tex = rc->GetResource<Texture2D>(spritePath);
 
-	//clone the material
-	SharedPtr<Material> cloneMat = baseMat->Clone();
+	//reuse the material clone from the last solve
+	Material* cloneMat = renderCache.GetMaterial(item, baseMat);
 	cloneMat->SetTexture(TextureUnit::TU_DIFFUSE, tex);
-	cloneMat->SetShaderParameter("MatDiffColor", mainColor);
-	
-	Node* node = scene->CreateChild(ID + "_Preview");
-	BillboardSet* pointCloud = node->CreateComponent<BillboardSet>();
-	pointCloud->SetNumBillboards(points.Size());
+	cloneMat->SetShaderParameter("MatDiffColor", Color::WHITE);
+
+	renderCache.RemovePointCloud(item);
+	BillboardSet* pointCloud = node->GetOrCreateComponent<BillboardSet>();
+	pointCloud->SetNumBillboards(positions.Size());
 	pointCloud->SetMaterial(cloneMat);
 	pointCloud->SetSorted(true);
 	pointCloud->SetFixedScreenSize(fixedSize);
 
-	//track
-	trackedItems.Push(node->GetID());
-
-
 	//add the points
-	for (int i = 0; i < points.Size(); i++)
+	for (unsigned i = 0; i < positions.Size(); i++)
 	{
 		Billboard* bb = pointCloud->GetBillboard(i);
 
-		bb->position_ = points[i].GetVector3();
+		bb->position_ = positions[i];
 		bb->size_ = Vector2(size.x_, size.y_);
 		bb->enabled_ = true;
-		bb->color_ = mainColor;
+		bb->color_ = colors[i % colors.Size()];
 	}
 
-
 	pointCloud->Commit();
 
 	outSolveInstance[0] = node->GetID();
 	outSolveInstance[1] = pointCloud;
-}
\ No newline at end of file
+}
@@ -23,6 +23,7 @@
 #pragma once
 
 #include "IoComponentBase.h"
+#include "IoRenderCache.h"
 #include <Urho3D/Graphics/BillboardSet.h>
 
 class URHO3D_API Graphics_PointRenderer : public IoComponentBase {
@@ -31,14 +32,21 @@ public:
 	Graphics_PointRenderer(Urho3D::Context* context);
 
 	virtual void PreLocalSolve();
+	virtual void PostLocalSolve();
+	virtual void LoadInputAccess(unsigned inputIndex, DataAccess savedAccess);
 
-	Urho3D::Vector<int> trackedItems;
+	IoRenderCache renderCache;
 
 	void SolveInstance(
 		const Urho3D::Vector<Urho3D::Variant>& inSolveInstance,
 		Urho3D::Vector<Urho3D::Variant>& outSolveInstance
 	);
 
+	bool IsVisibleOutput() const { return true; }
+
 	static Urho3D::String iconTexture;
 
+	Urho3D::String pointMat = "Materials/BasicPoints.xml";
+	Urho3D::String pointCloudMat = "Materials/BasicPointCloud.xml";
+
 };
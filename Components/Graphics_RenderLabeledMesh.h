@@ -51,6 +51,8 @@ public:
 		Urho3D::Vector<Urho3D::Variant>& outSolveInstance
 		);
 
+	bool IsVisibleOutput() const { return true; }
+
 	int TriMesh_Render(Urho3D::Variant trimesh,
 		Urho3D::Context* context,
 		Urho3D::String material_path,
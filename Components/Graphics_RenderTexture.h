@@ -42,6 +42,8 @@ public:
 		Urho3D::Vector<Urho3D::Variant>& outSolveInstance
 	);
 
+	bool IsVisibleOutput() const { return true; }
+
 	Urho3D::Vector<Urho3D::String> trackedItems;
 
 	void HandleRenderUpdate(Urho3D::StringHash eventType, Urho3D::VariantMap& eventData);
@@ -40,4 +40,6 @@ public:
 		Urho3D::Vector<Urho3D::Variant>& outSolveInstance
 		);
 
+	bool IsVisibleOutput() const { return true; }
+
 };
\ No newline at end of file
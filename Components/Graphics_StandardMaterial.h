@@ -37,6 +37,8 @@ public:
 		Urho3D::Vector<Urho3D::Variant>& outSolveInstance
 		);
 
+	bool IsVisibleOutput() const { return true; }
+
 	virtual void PreLocalSolve();
 	Urho3D::Vector<Urho3D::String> trackedItems;
 
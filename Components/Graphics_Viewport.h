@@ -45,5 +45,7 @@ public:
 		Urho3D::Vector<Urho3D::Variant>& outSolveInstance
 		);
 
+	bool IsVisibleOutput() const { return true; }
+
 	Urho3D::Vector<UIElement*> trackedItems;
 };
\ No newline at end of file
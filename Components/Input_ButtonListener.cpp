@@ -90,6 +90,6 @@ void Input_ButtonListener::SolveInstance(
 
 void Input_ButtonListener::HandleButtonPress(StringHash eventType, VariantMap& eventData)
 {
-	solvedFlag_ = 0;
+	MarkUnsolved();
 	GetSubsystem<IoGraph>()->QuickTopoSolveGraph();
 }
\ No newline at end of file
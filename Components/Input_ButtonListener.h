@@ -38,5 +38,7 @@ public:
 		Urho3D::Vector<Urho3D::Variant>& outSolveInstance
 		);
 
+	bool IsVisibleOutput() const { return true; }
+
 	void HandleButtonPress(Urho3D::StringHash eventType, Urho3D::VariantMap& eventData);
 };
\ No newline at end of file
@@ -105,7 +105,7 @@ void Input_EditGeometryListener::HandleEditGeometry(StringHash eventType, Varian
 		currentGeometry = Variant();
 	}
 
-	solvedFlag_ = 0;
+	MarkUnsolved();
 	GetSubsystem<IoGraph>()->QuickTopoSolveGraph();
 }
 
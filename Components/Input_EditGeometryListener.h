@@ -39,6 +39,8 @@ public:
 		const Urho3D::Vector<Urho3D::Variant>& inSolveInstance,
 		Urho3D::Vector<Urho3D::Variant>& outSolveInstance
 		);
+
+	bool IsVisibleOutput() const { return true; }
 	Urho3D::Variant currentGeometry;
 	void HandleEditGeometry(Urho3D::StringHash eventType, Urho3D::VariantMap& eventData);
 	void HandleEditGeometryReset(Urho3D::StringHash eventType, Urho3D::VariantMap& eventData);
@@ -129,7 +129,7 @@ void Input_GamepadListener::HandleButtonDown(StringHash eventType, VariantMap& e
 		}
 	}
 
-	solvedFlag_ = 0;
+	MarkUnsolved();
 	GetSubsystem<IoGraph>()->QuickTopoSolveGraph();
 }
 
@@ -150,6 +150,6 @@ void Input_GamepadListener::HandleAxisMove(StringHash eventType, VariantMap& eve
 		}
 	}
 
-	solvedFlag_ = 0;
+	MarkUnsolved();
 	GetSubsystem<IoGraph>()->QuickTopoSolveGraph();
 }
\ No newline at end of file
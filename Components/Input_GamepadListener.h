@@ -38,6 +38,8 @@ public:
 		const Urho3D::Vector<Urho3D::Variant>& inSolveInstance,
 		Urho3D::Vector<Urho3D::Variant>& outSolveInstance
 		);
+
+	bool IsVisibleOutput() const { return true; }
 	bool isOn = false;
 
 	int buttonID = -1;
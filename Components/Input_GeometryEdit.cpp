@@ -212,7 +212,7 @@ void Input_GeometryEdit::HandleMouseMove(StringHash eventType, VariantMap& event
 	if (bs && bs == vGeom)
 	{
 		//retrieve original vertex position
-		Variant geom = currentHitResult.node_->GetVar("ReferenceGeometry");
+		Variant geom = TriMesh_Unpack(currentHitResult.node_->GetVar("ReferenceGeometry"));
 		VariantMap geomMap = geom.GetVariantMap();
 		VariantVector verts = geomMap["vertices"].GetVariantVector();
 
@@ -41,6 +41,8 @@ public:
 		Urho3D::Vector<Urho3D::Variant>& outSolveInstance
 	);
 
+	bool IsVisibleOutput() const { return true; }
+
 	Urho3D::Vector<int> trackedItems;
 	int constraintFlags = 7;
 	bool reset = true;
@@ -39,6 +39,8 @@ public:
 		Urho3D::Vector<Urho3D::Variant>& outSolveInstance
 		);
 
+	bool IsVisibleOutput() const { return true; }
+
 	Urho3D::Text* treeText = NULL;
 
 	virtual Urho3D::String GetNodeStyle();
@@ -134,7 +134,7 @@ void Input_KeyboardListener::HandleKeyDown(StringHash eventType, VariantMap& eve
 		keyDown = "";
 	}
 
-	solvedFlag_ = 0;
+	MarkUnsolved();
 	GetSubsystem<IoGraph>()->QuickTopoSolveGraph();
 }
 
@@ -163,6 +163,6 @@ void Input_KeyboardListener::HandleKeyUp(StringHash eventType, VariantMap& event
 		keyDown = "";
 	}
 
-	solvedFlag_ = 0;
+	MarkUnsolved();
 	GetSubsystem<IoGraph>()->QuickTopoSolveGraph();
 }
@@ -38,6 +38,8 @@ public:
 		Urho3D::Vector<Urho3D::Variant>& outSolveInstance
 		);
 
+	bool IsVisibleOutput() const { return true; }
+
 	Urho3D::String keyFilter = "";
 	Urho3D::String keyDown = "";
 	Urho3D::String keyUp = "";
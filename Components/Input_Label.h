@@ -38,6 +38,8 @@ public:
 		Urho3D::Vector<Urho3D::Variant>& outSolveInstance
 		);
 
+	bool IsVisibleOutput() const { return true; }
+
 
 	static Urho3D::String iconTexture;
 	virtual void HandleCustomInterface(Urho3D::UIElement* customElement);
@@ -103,6 +103,6 @@ void Input_LineEditListener::SolveInstance(
 
 void Input_LineEditListener::HandleLineEdit(StringHash eventType, VariantMap& eventData)
 {
-	solvedFlag_ = 0;
+	MarkUnsolved();
 	GetSubsystem<IoGraph>()->QuickTopoSolveGraph();
 }
\ No newline at end of file
@@ -131,7 +131,7 @@ void Input_MouseDownListener::HandleMouseMove(StringHash eventType, VariantMap&
 		mDelta = Vector3(X, Y, 0);
 
 
-		solvedFlag_ = 0;
+		MarkUnsolved();
 		GetSubsystem<IoGraph>()->QuickTopoSolveGraph();
 	}
 
@@ -39,6 +39,8 @@ public:
 		Urho3D::Vector<Urho3D::Variant>& outSolveInstance
 		);
 
+	bool IsVisibleOutput() const { return true; }
+
 	void HandleMouseMove(Urho3D::StringHash eventType, Urho3D::VariantMap& eventData);
 
 	bool isOn = false;
@@ -184,7 +184,7 @@ void Input_ObjectMove::HandleMouseMove(StringHash eventType, VariantMap& eventDa
 	}
 
 
-	solvedFlag_ = 0;
+	MarkUnsolved();
 	GetSubsystem<IoGraph>()->QuickTopoSolveGraph();
 
 }
@@ -225,7 +225,7 @@ void Input_ObjectMove::HandleMouseUp(StringHash eventType, VariantMap& eventData
 		currentNode = NULL;
 		currentCamera = NULL;
 
-		solvedFlag_ = 0;
+		MarkUnsolved();
 		GetSubsystem<IoGraph>()->QuickTopoSolveGraph();
 
 	}
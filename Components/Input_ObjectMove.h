@@ -41,6 +41,8 @@ public:
 		Urho3D::Vector<Urho3D::Variant>& outSolveInstance
 	);
 
+	bool IsVisibleOutput() const { return true; }
+
 	Urho3D::Node* currentNode = NULL;
 	Urho3D::Camera* currentCamera;
 	Urho3D::Vector3 orgPos;
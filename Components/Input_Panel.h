@@ -43,6 +43,8 @@ public:
 		Urho3D::Vector<Urho3D::Variant>& outSolveInstance
 		);
 
+	bool IsVisibleOutput() const { return true; }
+
 	static Urho3D::String iconTexture;
 
 	Urho3D::SharedPtr<Urho3D::MultiLineEdit> textArea_;
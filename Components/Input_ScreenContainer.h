@@ -38,6 +38,8 @@ public:
 		Urho3D::Vector<Urho3D::Variant>& outSolveInstance
 	);
 
+	bool IsVisibleOutput() const { return true; }
+
 	Urho3D::Vector<Widget_Container*> trackedItems;
 	static Urho3D::String iconTexture;
 };
\ No newline at end of file
@@ -37,6 +37,8 @@ public:
 		Urho3D::Vector <Urho3D::Variant> & outSolveInstance
 		);
 
+	bool IsVisibleOutput() const { return true; }
+
 	Urho3D::Vector<Urho3D::UIElement*> trackedItems;
 	static Urho3D::String iconTexture;
 };
\ No newline at end of file
@@ -40,6 +40,8 @@ public:
 		Urho3D::Vector<Urho3D::Variant>& outSolveInstance
 		);
 
+	bool IsVisibleOutput() const { return true; }
+
 	Urho3D::Vector<Urho3D::UIElement*> trackedItems;
 	void HandleButtonPress(Urho3D::StringHash eventType, Urho3D::VariantMap& eventData);
 	void HandleButtonRelease(Urho3D::StringHash eventType, Urho3D::VariantMap& eventData);
@@ -454,7 +454,7 @@ void Input_SketchPlane::HandleDragEnd(Urho3D::StringHash eventType, Urho3D::Vari
 			//clear
 			trackedPoints_.Clear();
 
-			solvedFlag_ = 0;
+			MarkUnsolved();
 			GetSubsystem<IoGraph>()->QuickTopoSolveGraph();
 		}
 	}
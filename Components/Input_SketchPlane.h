@@ -49,6 +49,8 @@ public:
 		Urho3D::Vector<Urho3D::Variant>& outSolveInstance
 	);
 
+	bool IsVisibleOutput() const { return true; }
+
 
 	static Urho3D::String iconTexture;
 
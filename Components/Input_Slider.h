@@ -40,6 +40,8 @@ public:
 		Urho3D::Vector<Urho3D::Variant>& outSolveInstance
 		);
 
+	bool IsVisibleOutput() const { return true; }
+
 	float minRange = 0.0f;
 	float maxRange = 100.0f;
 	float currentValue = 0.000f;
@@ -118,6 +118,6 @@ void Input_SliderListener::SolveInstance(
 
 void Input_SliderListener::HandleSliderChanged(StringHash eventType, VariantMap& data)
 {
-	solvedFlag_ = 0;
+	MarkUnsolved();
 	GetSubsystem<IoGraph>()->QuickTopoSolveGraph();
 }
@@ -37,6 +37,8 @@ public:
 		Urho3D::Vector<Urho3D::Variant>& outSolveInstance
 		);
 
+	bool IsVisibleOutput() const { return true; }
+
 	static Urho3D::String iconTexture;
 
 	void HandleSliderChanged(Urho3D::StringHash eventType, Urho3D::VariantMap& data);
@@ -38,6 +38,8 @@ public:
 		Urho3D::Vector<Urho3D::Variant>& outSolveInstance
 		);
 
+	bool IsVisibleOutput() const { return true; }
+
 	virtual Urho3D::String GetNodeStyle();
 	virtual void HandleCustomInterface(Urho3D::UIElement* customElement);
 
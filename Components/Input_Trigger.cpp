@@ -63,7 +63,7 @@ int Input_Trigger::LocalSolve()
 	assert(outputSlots_.Size() == 1);
 
 	if (inputSlots_[0]->HasNoData()) {
-		solvedFlag_ = 0;
+		MarkUnsolved();
 		return 0;
 	}
 
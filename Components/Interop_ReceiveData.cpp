@@ -110,7 +110,7 @@ void Interop_ReceiveData::HandleLineEdit(StringHash eventType, VariantMap& event
 		Network* network = GetSubsystem<Network>();
 		bool res = network->Connect(sourceAddress_, importPort_, 0);
 
-		solvedFlag_ = 0;
+		MarkUnsolved();
 		GetSubsystem<IoGraph>()->QuickTopoSolveGraph();
 
 	}
@@ -124,7 +124,7 @@ void Interop_ReceiveData::HandleLineEdit(StringHash eventType, VariantMap& event
 		Network* network = GetSubsystem<Network>();
 		bool res = network->Connect(sourceAddress_, importPort_, 0);
 
-		solvedFlag_ = 0;
+		MarkUnsolved();
 		GetSubsystem<IoGraph>()->QuickTopoSolveGraph();
 	}
 }
@@ -154,7 +154,7 @@ void Interop_ReceiveData::HandleNetworkMessage(Urho3D::StringHash eventType, Urh
 
 		int size = incomingData_.Size();
 
-		solvedFlag_ = 0;
+		MarkUnsolved();
 		GetSubsystem<IoGraph>()->QuickTopoSolveGraph();
 	}
 }
@@ -113,7 +113,7 @@ void Interop_SendData::HandleLineEdit(StringHash eventType, VariantMap& eventDat
 		bool res = network->StartServer(exportPort_);
 		bool serverRunning = network->IsServerRunning();
 
-		solvedFlag_ = 0;
+		MarkUnsolved();
 		GetSubsystem<IoGraph>()->QuickTopoSolveGraph();
 
 	}
@@ -38,4 +38,6 @@ public:
 		Urho3D::Vector<Urho3D::Variant>& outSolveInstance
 		);
 
+	bool IsThreadSafe() const { return true; }
+
 };
\ No newline at end of file
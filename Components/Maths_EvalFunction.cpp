@@ -26,6 +26,8 @@
 #include "Urho3D/AngelScript/APITemplates.h"
 #include "Urho3D/AngelScript/Script.h";
 
+#include "IoExpression.h"
+
 using namespace Urho3D;
 
 String Maths_EvalFunction::iconTexture = "Textures/Icons/Maths_EvalFunction.png";
@@ -89,6 +91,26 @@ void Maths_EvalFunction::SolveInstance(
 	float y = inSolveInstance[1].GetFloat();
 	float z = inSolveInstance[2].GetFloat();
 
+	//compiled once per function string, evaluated natively
+	Vector<String> varNames;
+	varNames.Push("X");
+	varNames.Push("Y");
+	varNames.Push("Z");
+	PODVector<IoExpressionType> varTypes(3);
+	varTypes[0] = varTypes[1] = varTypes[2] = EXPR_FLOAT;
+
+	std::shared_ptr<const IoExpression> expression = IoExpression::GetCached(function, varNames, varTypes);
+	if (expression && expression->GetResultType() == EXPR_FLOAT)
+	{
+		Vector<Variant> args;
+		args.Push(x);
+		args.Push(y);
+		args.Push(z);
+		outSolveInstance[0] = expression->Evaluate(args);
+		return;
+	}
+
+	//script fallback for syntax the expression compiler does not cover
 	//replace the argument place holders with the function variables
 	function.Replace("X", String(x), false);
 	function.Replace("Y", String(y), false);
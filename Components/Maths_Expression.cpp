@@ -26,6 +26,7 @@
 #include "Urho3D/AngelScript/APITemplates.h"
 #include "Urho3D/AngelScript/Script.h";
 #include "Urho3D/UI/UIEvents.h"
+#include "IoExpression.h"
 #include "IoGraph.h"
 
 using namespace Urho3D;
@@ -103,7 +104,29 @@ void Maths_Expression::SolveInstance(
 		return;
 	}
 	
-	//evaluate the expression
+	//compiled path: expressions over float and Vector3 inputs are parsed once and cached
+	Vector<String> varNames;
+	PODVector<IoExpressionType> varTypes;
+	bool compilable = true;
+	for (int i = 0; i < inSolveInstance.Size(); i++)
+	{
+		IoExpressionType type = IoExpression::GetVariantType(inSolveInstance[i]);
+		compilable = compilable && type != EXPR_NONE;
+		varNames.Push(inputSlots_[i]->GetVariableName());
+		varTypes.Push(type);
+	}
+
+	if (compilable)
+	{
+		std::shared_ptr<const IoExpression> expression = IoExpression::GetCached(expression_, varNames, varTypes);
+		if (expression)
+		{
+			outSolveInstance[0] = expression->Evaluate(inSolveInstance);
+			return;
+		}
+	}
+
+	//evaluate the expression as a script
 	String scriptCommand = "";
 
 	for (int i = 0; i < inSolveInstance.Size(); i++)
@@ -180,7 +203,7 @@ void Maths_Expression::HandleLineEdit(Urho3D::StringHash eventType, Urho3D::Vari
 
 		SetGenericData("Expression", expression_);
 
-		solvedFlag_ = 0;
+		MarkUnsolved();
 		GetSubsystem<IoGraph>()->QuickTopoSolveGraph();
 	}
 
@@ -36,4 +36,6 @@ public:
 		const Urho3D::Vector<Urho3D::Variant>& inSolveInstance,
 		Urho3D::Vector<Urho3D::Variant>& outSolveInstance
 		);
+
+	bool IsThreadSafe() const { return true; }
 };
\ No newline at end of file
@@ -36,6 +36,8 @@ public:
 		Urho3D::Vector<Urho3D::Variant>& outSolveInstance
 	);
 
+	bool IsThreadSafe() const { return true; }
+
 	void AddInputSlot() = delete;
 	void AddOutputSlot() = delete;
 	void DeleteInputSlot(int index) = delete;
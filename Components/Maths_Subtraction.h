@@ -38,6 +38,8 @@ public:
 		Urho3D::Vector<Urho3D::Variant>& outSolveInstance
 		);
 
+	bool IsThreadSafe() const { return true; }
+
 	void AddInputSlots() = delete;
 	void AddOutputSlots() = delete;
 	void DeleteInputSlot(int index) = delete;
@@ -29,6 +29,7 @@
 #pragma warning(pop)
 
 #include "ConversionUtilities.h"
+#include "Geomlib_RemoveDuplicates.h"
 #include "TriMesh.h"
 
 #include <Eigen/Core>
@@ -36,13 +37,51 @@
 
 using namespace Urho3D;
 
+namespace {
+
+// Welds vertices of V closer than eps, remaps F and drops faces that collapse
+void WeldMatrices(Eigen::MatrixXf& V, Eigen::MatrixXi& F, float eps)
+{
+	PODVector<Vector3> points((unsigned)V.rows());
+	for (unsigned i = 0; i < points.Size(); ++i) {
+		points[i] = Vector3(V(i, 0), V(i, 1), V(i, 2));
+	}
+
+	PODVector<Vector3> weldedPoints;
+	PODVector<int> weldIndices;
+	Geomlib::WeldPoints(points, eps, Geomlib::WELD_DISTANCE, weldedPoints, weldIndices, true);
+
+	Eigen::MatrixXf WV((int)weldedPoints.Size(), 3);
+	for (unsigned i = 0; i < weldedPoints.Size(); ++i) {
+		WV.row(i) << weldedPoints[i].x_, weldedPoints[i].y_, weldedPoints[i].z_;
+	}
+
+	Eigen::MatrixXi WF(F.rows(), 3);
+	int numFaces = 0;
+	for (int f = 0; f < F.rows(); ++f) {
+		int a = weldIndices[F(f, 0)];
+		int b = weldIndices[F(f, 1)];
+		int c = weldIndices[F(f, 2)];
+		if (a == b || b == c || c == a) {
+			continue;
+		}
+		WF.row(numFaces++) << a, b, c;
+	}
+	WF.conservativeResize(numFaces, 3);
+
+	V = WV;
+	F = WF;
+}
+
+}
+
 String Mesh_CleanMesh::iconTexture = "Textures/Icons/Mesh_CleanMesh.png";
 
-Mesh_CleanMesh::Mesh_CleanMesh(Context* context) : IoComponentBase(context, 1, 2)
+Mesh_CleanMesh::Mesh_CleanMesh(Context* context) : IoComponentBase(context, 2, 2)
 {
 	SetName("CleanMeshVertices");
 	SetFullName("Cull Unused Vertices");
-	SetDescription("Cull unused vertices from trimesh");
+	SetDescription("Cull unused vertices from trimesh, optionally welding close vertices first");
 	SetGroup(IoComponentGroup::MESH);
 	SetSubgroup("Operators");
 
@@ -52,6 +91,14 @@ Mesh_CleanMesh::Mesh_CleanMesh(Context* context) : IoComponentBase(context, 1, 2
 	inputSlots_[0]->SetVariantType(VariantType::VAR_VARIANTMAP);
 	inputSlots_[0]->SetDataAccess(DataAccess::ITEM);
 
+	inputSlots_[1]->SetName("WeldDistance");
+	inputSlots_[1]->SetVariableName("W");
+	inputSlots_[1]->SetDescription("Weld vertices closer than this distance first (0 to skip)");
+	inputSlots_[1]->SetVariantType(VariantType::VAR_FLOAT);
+	inputSlots_[1]->SetDataAccess(DataAccess::ITEM);
+	inputSlots_[1]->SetDefaultValue(0.0f);
+	inputSlots_[1]->DefaultSet();
+
 	outputSlots_[0]->SetName("Mesh");
 	outputSlots_[0]->SetVariableName("M");
 	outputSlots_[0]->SetDescription("Mesh after removing unused vertices");
@@ -96,10 +143,21 @@ void Mesh_CleanMesh::SolveInstance(
 		return;
 	}
 
+	int num_original = (int)V.rows();
+	float weldDistance = inSolveInstance[1].GetFloat();
+	if (weldDistance > 0.0f) {
+		WeldMatrices(V, F, weldDistance);
+		if (F.rows() == 0) {
+			URHO3D_LOGWARNING("Mesh_CleanMesh --- every face collapsed at weld distance W");
+			SetAllOutputsNull(outSolveInstance);
+			return;
+		}
+	}
+
 	Eigen::VectorXi _1;
 	igl::remove_unreferenced(V, F, NV, NF, _1);
 	Variant out_mesh = TriMesh_Make(NV, NF);
-	int num_removed = V.rows() - NV.rows();
+	int num_removed = num_original - (int)NV.rows();
 
 	/////////////////
 	// ASSIGN OUTPUTS
@@ -28,7 +28,7 @@
 #include <Urho3D/Math/Vector3.h>
 
 #include "ConversionUtilities.h"
-#include "Geomlib_TriMeshClosestPoint.h"
+#include "Geomlib_TriMeshBVH.h"
 #include "TriMesh.h"
 
 using namespace Urho3D;
@@ -52,27 +52,27 @@ Mesh_ClosestPoint::Mesh_ClosestPoint(Context* context) :
 
 	inputSlots_[1]->SetName("Query Point");
 	inputSlots_[1]->SetVariableName("Q");
-	inputSlots_[1]->SetDescription("Point to search from");
+	inputSlots_[1]->SetDescription("Points to search from");
 	inputSlots_[1]->SetVariantType(VariantType::VAR_VECTOR3);
-	inputSlots_[1]->SetDataAccess(DataAccess::ITEM);
+	inputSlots_[1]->SetDataAccess(DataAccess::LIST);
 
 	outputSlots_[0]->SetName("Point");
 	outputSlots_[0]->SetVariableName("P");
 	outputSlots_[0]->SetDescription("Point on mesh closest to query point");
 	outputSlots_[0]->SetVariantType(VariantType::VAR_VECTOR3);
-	outputSlots_[0]->SetDataAccess(DataAccess::ITEM);
+	outputSlots_[0]->SetDataAccess(DataAccess::LIST);
 
 	outputSlots_[1]->SetName("Index");
 	outputSlots_[1]->SetVariableName("I");
 	outputSlots_[1]->SetDescription("Index of closest face");
 	outputSlots_[1]->SetVariantType(VariantType::VAR_INT);
-	outputSlots_[1]->SetDataAccess(DataAccess::ITEM);
+	outputSlots_[1]->SetDataAccess(DataAccess::LIST);
 
 	outputSlots_[2]->SetName("Distance");
 	outputSlots_[2]->SetVariableName("D");
 	outputSlots_[2]->SetDescription("Distance from query point to mesh");
 	outputSlots_[2]->SetVariantType(VariantType::VAR_FLOAT);
-	outputSlots_[2]->SetDataAccess(DataAccess::ITEM);
+	outputSlots_[2]->SetDataAccess(DataAccess::LIST);
 }
 
 void Mesh_ClosestPoint::SolveInstance(
@@ -83,30 +83,47 @@ void Mesh_ClosestPoint::SolveInstance(
 	assert(inSolveInstance.Size() == inputSlots_.Size());
 
 	Variant inMesh = inSolveInstance[0];
-	VariantMap meshMap = inMesh.GetVariantMap();
-	Vector3 q = inSolveInstance[1].GetVector3();
-
-	int index = -1;
-	Vector3 p;
+	VariantVector queries = inSolveInstance[1].GetVariantVector();
 
 	///////////////////////////////////////////////////////////////////////////////////////////////
-	bool success = false;
-
+	// all query points go through one hierarchy in a single batch
+	std::shared_ptr<const Geomlib::TriMeshBVH> bvh;
 	if (TriMesh_Verify(inMesh)) {
-		success = Geomlib::TriMeshClosestPoint(inMesh, q, index, p);
+		bvh = Geomlib::TriMeshBVH::Get(inMesh);
 	}
 	///////////////////////////////////////////////////////////////////////////////////////////////
 
-	if (success) {
-		float dist = sqrt((q - p).LengthSquared());
+	if (!bvh) {
+		SetAllOutputsNull(outSolveInstance);
+		return;
+	}
 
-		outSolveInstance[0] = Variant(p);
-		outSolveInstance[1] = Variant(index);
-		outSolveInstance[2] = Variant(dist);
+	PODVector<Vector3> queryPoints(queries.Size());
+	for (unsigned i = 0; i < queries.Size(); ++i) {
+		queryPoints[i] = queries[i].GetVector3();
 	}
-	else {
-		outSolveInstance[0] = Variant();
-		outSolveInstance[1] = Variant();
-		outSolveInstance[2] = Variant();
+
+	PODVector<int> faces;
+	PODVector<Vector3> points;
+	bvh->ClosestPoints(queryPoints, faces, points);
+
+	VariantVector pointList;
+	VariantVector indexList;
+	VariantVector distanceList;
+	for (unsigned i = 0; i < points.Size(); ++i) {
+		if (faces[i] < 0 || queries[i].GetType() != VAR_VECTOR3) {
+			pointList.Push(Variant());
+			indexList.Push(Variant());
+			distanceList.Push(Variant());
+			continue;
+		}
+
+		pointList.Push(Variant(points[i]));
+		indexList.Push(Variant(faces[i]));
+		distanceList.Push(Variant((queryPoints[i] - points[i]).Length()));
 	}
+
+	outSolveInstance[0] = pointList;
+	outSolveInstance[1] = indexList;
+	outSolveInstance[2] = distanceList;
 }
\ No newline at end of file
@@ -93,7 +93,7 @@ int Mesh_DeconstructFace::LocalSolve()
     nullTree.Add(path, Variant());
     
     if (inputSlots_[0]->HasNoData()) {
-        solvedFlag_ = 0;
+        MarkUnsolved();
         outputSlots_[0]->SetIoDataTree(nullTree);
         outputSlots_[1]->SetIoDataTree(nullTree);
         outputSlots_[2]->SetIoDataTree(nullTree);
@@ -109,7 +109,7 @@ int Mesh_DeconstructFace::LocalSolve()
     inputMeshTree.GetItem(inMesh, path, 0);
     if (inMesh.GetType() == VAR_NONE)
     {
-        solvedFlag_ = 0;
+        MarkUnsolved();
         outputSlots_[0]->SetIoDataTree(nullTree);
         outputSlots_[1]->SetIoDataTree(nullTree);
         outputSlots_[2]->SetIoDataTree(nullTree);
@@ -119,7 +119,7 @@ int Mesh_DeconstructFace::LocalSolve()
     
     if (!TriMesh_Verify(inMesh)) {
         URHO3D_LOGWARNING("M must be a TriMesh!");
-        solvedFlag_ = 0;
+        MarkUnsolved();
         outputSlots_[0]->SetIoDataTree(nullTree);
         outputSlots_[1]->SetIoDataTree(nullTree);
         outputSlots_[2]->SetIoDataTree(nullTree);
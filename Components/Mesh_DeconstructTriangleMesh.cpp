@@ -84,7 +84,8 @@ void Mesh_DeconstructTriangleMesh::SolveInstance(
 		return;
 	}
 
-	VariantMap mData = inSolveInstance[0].GetVariantMap();
+	// the lists are read directly below, so expand packed TriMesh storage first
+	VariantMap mData = TriMesh_Unpack(inSolveInstance[0]).GetVariantMap();
 
 	if (mData.Keys().Contains("vertices") && mData.Keys().Contains("faces") && mData.Keys().Contains("normals"))
 	{
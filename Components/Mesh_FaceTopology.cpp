@@ -25,6 +25,7 @@
 
 #include "TriMesh.h"
 #include "MeshTopologyQueries.h"
+#include "Geomlib_TriMeshAdjacency.h"
 
 
 using namespace Urho3D;
@@ -78,7 +79,7 @@ int Mesh_FaceTopology::LocalSolve()
 	nullTree.Add(path, Variant());
 
 	if (inputSlots_[0]->HasNoData()) {
-		solvedFlag_ = 0;
+		MarkUnsolved();
 		outputSlots_[0]->SetIoDataTree(nullTree);
 		outputSlots_[1]->SetIoDataTree(nullTree);
 		outputSlots_[2]->SetIoDataTree(nullTree);
@@ -94,7 +95,7 @@ int Mesh_FaceTopology::LocalSolve()
 	inputMeshTree.GetItem(inMesh, path, 0);
 	if (inMesh.GetType() == VAR_NONE)
 	{
-		solvedFlag_ = 0;
+		MarkUnsolved();
 		outputSlots_[0]->SetIoDataTree(nullTree);
 		outputSlots_[1]->SetIoDataTree(nullTree);
 		outputSlots_[2]->SetIoDataTree(nullTree);
@@ -104,7 +105,7 @@ int Mesh_FaceTopology::LocalSolve()
 
 	if (!TriMesh_HasAdjacencyData(inMesh)) {
 		URHO3D_LOGWARNING("M must be a TriMesh WITH DATA (use Mesh_ComputeAdjacencyData)!");
-		solvedFlag_ = 0;
+		MarkUnsolved();
 		outputSlots_[0]->SetIoDataTree(nullTree);
 		outputSlots_[1]->SetIoDataTree(nullTree);
 		outputSlots_[2]->SetIoDataTree(nullTree);
@@ -163,15 +164,19 @@ IoDataTree Mesh_FaceTopology::ComputeAdjacentFaces(Urho3D::Variant inMeshWithDat
 	IoDataTree adjacent_faces_tree(GetContext());
 
 	VariantMap* meshWithData = inMeshWithData.GetVariantMapPtr();
-	VariantMap* triMesh = (*meshWithData)["mesh"].GetVariantMapPtr();
 
-	VariantVector* face_face_list = (*meshWithData)["face-face"].GetVariantVectorPtr();
+	std::shared_ptr<const Geomlib::TriMeshAdjacency> adjacency = Geomlib::TriMeshAdjacency::Get((*meshWithData)["mesh"]);
+	if (!adjacency)
+		return adjacent_faces_tree;
 
-	for (int i = 0; i < (*face_face_list).Size(); ++i) {
+	for (unsigned i = 0; i < adjacency->GetNumFaces(); ++i) {
 		Vector<int> path;
 		path.Push(i);
 
-		VariantVector adj_faces = (*face_face_list)[i].GetVariantVector();
+		VariantVector adj_faces;
+		for (int k = 0; k < 3; ++k) {
+			adj_faces.Push(Variant(adjacency->GetFaceFace(i, k)));
+		}
 		adjacent_faces_tree.Add(path, adj_faces);
 
 	}
@@ -24,31 +24,10 @@
 
 #include <assert.h>
 
-#include <Urho3D/Core/Context.h>
-#include <Urho3D/Core/Object.h>
 #include <Urho3D/Core/Variant.h>
-#include <Urho3D/Container/Vector.h>
-#include <Urho3D/Container/Str.h>
 
-#pragma warning(push, 0)
-#include <igl/writeOBJ.h>
-#include <igl/readOBJ.h>
-#include <igl/polygon_mesh_to_triangle_mesh.h>
-#pragma warning(pop)
-
-#include "ConversionUtilities.h"
 #include "TriMesh.h"
-
-// #include "common.h"
-// #include "meshio.h"
-// #include "dedge.h"
-// #include "subdivide.h"
-// #include "meshstats.h"
-// #include "hierarchy.h"
-// #include "field.h"
-// #include "normal.h"
-// #include "extract.h"
-// #include "bvh.h"
+#include "Geomlib_FieldRemesh.h"
 
 using namespace Urho3D;
 
@@ -58,7 +37,9 @@ Mesh_FieldRemesh::Mesh_FieldRemesh(Context* context) : IoComponentBase(context,
 {
 	SetName("FieldRemesh");
 	SetFullName("FieldRemesh");
-	SetDescription("Remeshes in a really clever and fast way (https://github.com/wjakob/instant-meshes)");
+	SetDescription("Field aligned remeshing to an approximate face count (after Instant Meshes, Jakob et al. 2015)");
+	SetGroup(IoComponentGroup::MESH);
+	SetSubgroup("Operators");
 
 	AddInputSlot(
 		"Mesh",
@@ -71,12 +52,20 @@ Mesh_FieldRemesh::Mesh_FieldRemesh(Context* context) : IoComponentBase(context,
 	AddInputSlot(
 		"Faces",
 		"N",
-		"Number of faces",
-		VAR_FLOAT,
-		DataAccess::ITEM
+		"Target number of faces",
+		VAR_INT,
+		DataAccess::ITEM,
+		500
 	);
 
-	inputSlots_[1]->SetDefaultValue(500);
+	AddInputSlot(
+		"Quads",
+		"Q",
+		"Output a quad dominant NMesh, otherwise a TriMesh",
+		VAR_BOOL,
+		DataAccess::ITEM,
+		true
+	);
 
 	AddOutputSlot(
 		"Mesh",
@@ -95,5 +84,43 @@ void Mesh_FieldRemesh::SolveInstance(
 	assert(inSolveInstance.Size() == inputSlots_.Size());
 	assert(outSolveInstance.Size() == outputSlots_.Size());
 
-	
-}
\ No newline at end of file
+	///////////////////
+	// VERIFY & EXTRACT
+
+	Variant meshIn = inSolveInstance[0];
+	if (!TriMesh_Verify(meshIn)) {
+		URHO3D_LOGWARNING("Mesh_FieldRemesh -- invalid TriMesh");
+		SetAllOutputsNull(outSolveInstance);
+		return;
+	}
+
+	VariantType type1 = inSolveInstance[1].GetType();
+	if (!(type1 == VariantType::VAR_INT || type1 == VariantType::VAR_FLOAT)) {
+		URHO3D_LOGWARNING("Mesh_FieldRemesh -- N must be an integer");
+		SetAllOutputsNull(outSolveInstance);
+		return;
+	}
+	int targetFaces = inSolveInstance[1].GetInt();
+	if (targetFaces <= 0) {
+		URHO3D_LOGWARNING("Mesh_FieldRemesh -- N must be positive");
+		SetAllOutputsNull(outSolveInstance);
+		return;
+	}
+
+	bool quads = inSolveInstance[2].GetBool();
+
+	///////////////////
+	// COMPONENT'S WORK
+
+	Variant meshOut;
+	if (!Geomlib::FieldRemesh(meshIn, targetFaces, quads, meshOut)) {
+		URHO3D_LOGWARNING("Mesh_FieldRemesh -- remeshing failed");
+		SetAllOutputsNull(outSolveInstance);
+		return;
+	}
+
+	/////////////////
+	// ASSIGN OUTPUTS
+
+	outSolveInstance[0] = meshOut;
+}
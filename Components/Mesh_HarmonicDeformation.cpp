@@ -24,13 +24,7 @@
 #include <Urho3D/Core/Variant.h>
 #include <algorithm>
 #include "TriMesh.h"
-
-#pragma warning(push, 0)
-#include <igl/colon.h>
-#include <igl/harmonic.h>
-#include <igl/readOBJ.h>
-#include <igl/readDMAT.h>
-#pragma warning(pop)
+#include "Geomlib_SparseSolverCache.h"
 
 using namespace Urho3D;
 
@@ -139,51 +133,44 @@ void Mesh_HarmonicDeformation::SolveInstance(
 		return;
 	}
 
-	//init matrices
-	Eigen::MatrixXd V;
-	Eigen::MatrixXi F;
-	Eigen::VectorXi b;
-	Eigen::MatrixXd D_bc;
-	Eigen::MatrixXd D;
-
-	//TriMeshToMatrices(mesh, V, F);
-	TriMeshToDoubleMatrices(mesh, V, F);
+	VariantVector verts = TriMesh_GetVertexList(mesh);
+	VariantVector faces = TriMesh_GetFaceList(mesh);
 
 	//collect the disp vecs and indices
 	int numVecs = Min(dispVecs.Size(), dispIdx.Size());
-	b.resize(numVecs);
-	D_bc.resize(numVecs, 3);
+	PODVector<int> b(numVecs);
+	PODVector<Vector3> D_bc(numVecs);
 
 	//create the handle and displacement vectors
 	for (int i = 0; i < numVecs; i++)
 	{
 		int idx = dispIdx[i].GetInt();
-		if (idx > V.rows())
+		if (idx < 0 || idx >= (int)verts.Size())
 		{
 			URHO3D_LOGERROR("Provide an out of range index!");
 			SetAllOutputsNull(outSolveInstance);
 			return;
 		}
 
-		Vector3 v = dispVecs[i].GetVector3();
-		D_bc.row(i) = Eigen::RowVector3d(v.x_, v.y_, v.z_);
+		D_bc[i] = dispVecs[i].GetVector3();
 		b[i] = idx;
 	}
 
 	//finally, proceed with calculation
-	igl::harmonic(V, F, b, D_bc, power, D);
-
-	int dRows = D.rows();
-	int dCols = D.cols();
+	//the factorization is cached per mesh and index set, so only moving the vectors is cheap
+	PODVector<Vector3> D;
+	if (!Geomlib::TriMesh_HarmonicDeformation(mesh, b, D_bc, power, D))
+	{
+		URHO3D_LOGWARNING("HarmonicDeformation --- failed to solve for the deformation field");
+		SetAllOutputsNull(outSolveInstance);
+		return;
+	}
 
 	VariantVector vecsOut;
-	VariantVector verts = TriMesh_GetVertexList(mesh);
-	VariantVector faces = TriMesh_GetFaceList(mesh);
 
-	for (int i = 0; i < D.rows(); i++)
+	for (unsigned i = 0; i < D.Size(); i++)
 	{
-		Eigen::RowVector3d v = D.row(i);
-		Vector3 dV = Vector3(v.x(), v.y(), v.z());
+		Vector3 dV = D[i];
 		vecsOut.Push(dV);
 
 		Vector3 orgVert = verts[i].GetVector3();
@@ -0,0 +1,118 @@
+//
+// Copyright (c) 2016 - 2017 Mesh Consultants Inc.
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "Mesh_MeshBoolean.h"
+
+#include <assert.h>
+
+#include <Urho3D/Core/Variant.h>
+
+#include "TriMesh.h"
+#include "Geomlib_MeshBoolean.h"
+
+using namespace Urho3D;
+
+String Mesh_MeshBoolean::iconTexture = "Textures/Icons/Mesh_MeshPlaneIntersection.png";
+
+Mesh_MeshBoolean::Mesh_MeshBoolean(Context* context) :
+	IoComponentBase(context, 3, 1)
+{
+	SetName("MeshBoolean");
+	SetFullName("Mesh Boolean");
+	SetDescription("Union, intersection or difference of closed triangle meshes");
+	SetGroup(IoComponentGroup::MESH);
+	SetSubgroup("Operators");
+
+	inputSlots_[0]->SetName("MeshA");
+	inputSlots_[0]->SetVariableName("A");
+	inputSlots_[0]->SetDescription("First closed mesh");
+	inputSlots_[0]->SetVariantType(VariantType::VAR_VARIANTMAP);
+	inputSlots_[0]->SetDataAccess(DataAccess::ITEM);
+
+	inputSlots_[1]->SetName("MeshB");
+	inputSlots_[1]->SetVariableName("B");
+	inputSlots_[1]->SetDescription("Second closed mesh");
+	inputSlots_[1]->SetVariantType(VariantType::VAR_VARIANTMAP);
+	inputSlots_[1]->SetDataAccess(DataAccess::ITEM);
+
+	inputSlots_[2]->SetName("Operation");
+	inputSlots_[2]->SetVariableName("O");
+	inputSlots_[2]->SetDescription("0 union, 1 intersection, 2 difference A - B");
+	inputSlots_[2]->SetVariantType(VariantType::VAR_INT);
+	inputSlots_[2]->SetDataAccess(DataAccess::ITEM);
+	inputSlots_[2]->SetDefaultValue(0);
+	inputSlots_[2]->DefaultSet();
+
+	outputSlots_[0]->SetName("Mesh");
+	outputSlots_[0]->SetVariableName("M");
+	outputSlots_[0]->SetDescription("Closed mesh of the result");
+	outputSlots_[0]->SetVariantType(VariantType::VAR_VARIANTMAP);
+	outputSlots_[0]->SetDataAccess(DataAccess::ITEM);
+}
+
+void Mesh_MeshBoolean::SolveInstance(
+	const Vector<Variant>& inSolveInstance,
+	Vector<Variant>& outSolveInstance
+)
+{
+	assert(inSolveInstance.Size() == inputSlots_.Size());
+	assert(outSolveInstance.Size() == outputSlots_.Size());
+
+	///////////////////
+	// VERIFY & EXTRACT
+
+	Variant meshA = inSolveInstance[0];
+	Variant meshB = inSolveInstance[1];
+	if (!TriMesh_Verify(meshA) || !TriMesh_Verify(meshB)) {
+		URHO3D_LOGWARNING("Mesh_MeshBoolean -- invalid TriMesh");
+		SetAllOutputsNull(outSolveInstance);
+		return;
+	}
+
+	VariantType type2 = inSolveInstance[2].GetType();
+	if (!(type2 == VariantType::VAR_INT || type2 == VariantType::VAR_FLOAT)) {
+		URHO3D_LOGWARNING("Mesh_MeshBoolean -- O must be an integer");
+		SetAllOutputsNull(outSolveInstance);
+		return;
+	}
+	int operation = inSolveInstance[2].GetInt();
+	if (operation < Geomlib::MESH_UNION || operation > Geomlib::MESH_DIFFERENCE) {
+		URHO3D_LOGWARNING("Mesh_MeshBoolean -- O must be 0, 1 or 2");
+		SetAllOutputsNull(outSolveInstance);
+		return;
+	}
+
+	///////////////////
+	// COMPONENT'S WORK
+
+	Variant result;
+	if (!Geomlib::MeshBoolean(meshA, meshB, (Geomlib::MeshBooleanOperation)operation, result)) {
+		URHO3D_LOGWARNING("Mesh_MeshBoolean -- result is empty");
+		SetAllOutputsNull(outSolveInstance);
+		return;
+	}
+
+	/////////////////
+	// ASSIGN OUTPUTS
+
+	outSolveInstance[0] = result;
+}
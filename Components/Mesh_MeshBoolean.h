@@ -0,0 +1,45 @@
+//
+// Copyright (c) 2016 - 2017 Mesh Consultants Inc.
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "IoComponentBase.h"
+
+class URHO3D_API Mesh_MeshBoolean : public IoComponentBase {
+	URHO3D_OBJECT(Mesh_MeshBoolean, IoComponentBase)
+public:
+	Mesh_MeshBoolean(Urho3D::Context* context);
+
+	void SolveInstance(
+		const Urho3D::Vector<Urho3D::Variant>& inSolveInstance,
+		Urho3D::Vector<Urho3D::Variant>& outSolveInstance
+	);
+
+	bool IsThreadSafe() const { return true; }
+
+	void AddInputSlot() = delete;
+	void AddOutputSlot() = delete;
+	void DeleteInputSlot(int index) = delete;
+	void DeleteOutputSlot(int index) = delete;
+
+	static Urho3D::String iconTexture;
+};
@@ -0,0 +1,96 @@
+//
+// Copyright (c) 2016 - 2017 Mesh Consultants Inc.
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "Mesh_MeshIntersection.h"
+
+#include <assert.h>
+
+#include <Urho3D/Core/Variant.h>
+
+#include "TriMesh.h"
+#include "Geomlib_TriTriIntersection.h"
+
+using namespace Urho3D;
+
+String Mesh_MeshIntersection::iconTexture = "Textures/Icons/Mesh_MeshPlaneIntersection.png";
+
+Mesh_MeshIntersection::Mesh_MeshIntersection(Context* context) :
+	IoComponentBase(context, 2, 1)
+{
+	SetName("MeshIntersection");
+	SetFullName("Mesh Mesh Intersection");
+	SetDescription("Intersection curves of two triangle meshes");
+	SetGroup(IoComponentGroup::MESH);
+	SetSubgroup("Operators");
+
+	inputSlots_[0]->SetName("MeshA");
+	inputSlots_[0]->SetVariableName("A");
+	inputSlots_[0]->SetDescription("First mesh");
+	inputSlots_[0]->SetVariantType(VariantType::VAR_VARIANTMAP);
+	inputSlots_[0]->SetDataAccess(DataAccess::ITEM);
+
+	inputSlots_[1]->SetName("MeshB");
+	inputSlots_[1]->SetVariableName("B");
+	inputSlots_[1]->SetDescription("Second mesh");
+	inputSlots_[1]->SetVariantType(VariantType::VAR_VARIANTMAP);
+	inputSlots_[1]->SetDataAccess(DataAccess::ITEM);
+
+	outputSlots_[0]->SetName("Curves");
+	outputSlots_[0]->SetVariableName("C");
+	outputSlots_[0]->SetDescription("Intersection polylines, closed where the meshes are closed");
+	outputSlots_[0]->SetVariantType(VariantType::VAR_VARIANTMAP);
+	outputSlots_[0]->SetDataAccess(DataAccess::LIST);
+}
+
+void Mesh_MeshIntersection::SolveInstance(
+	const Vector<Variant>& inSolveInstance,
+	Vector<Variant>& outSolveInstance
+)
+{
+	assert(inSolveInstance.Size() == inputSlots_.Size());
+	assert(outSolveInstance.Size() == outputSlots_.Size());
+
+	///////////////////
+	// VERIFY & EXTRACT
+
+	Variant meshA = inSolveInstance[0];
+	Variant meshB = inSolveInstance[1];
+	if (!TriMesh_Verify(meshA) || !TriMesh_Verify(meshB)) {
+		URHO3D_LOGWARNING("Mesh_MeshIntersection -- invalid TriMesh");
+		SetAllOutputsNull(outSolveInstance);
+		return;
+	}
+
+	///////////////////
+	// COMPONENT'S WORK
+
+	VariantVector curves;
+	if (!Geomlib::TriMeshIntersectionPolylines(meshA, meshB, curves)) {
+		SetAllOutputsNull(outSolveInstance);
+		return;
+	}
+
+	/////////////////
+	// ASSIGN OUTPUTS
+
+	outSolveInstance[0] = curves;
+}
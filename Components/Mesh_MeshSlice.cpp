@@ -0,0 +1,139 @@
+//
+// Copyright (c) 2016 - 2017 Mesh Consultants Inc.
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "Mesh_MeshSlice.h"
+
+#include <assert.h>
+
+#include <Urho3D/Core/Variant.h>
+#include <Urho3D/Math/Vector3.h>
+
+#include "TriMesh.h"
+#include "Geomlib_TriMeshSlice.h"
+
+using namespace Urho3D;
+
+String Mesh_MeshSlice::iconTexture = "Textures/Icons/Mesh_MeshPlaneIntersection.png";
+
+Mesh_MeshSlice::Mesh_MeshSlice(Context* context) :
+	IoComponentBase(context, 3, 2)
+{
+	SetName("MeshSlice");
+	SetFullName("Mesh Slice");
+	SetDescription("Contour a triangle mesh with a stack of planes");
+	SetGroup(IoComponentGroup::MESH);
+	SetSubgroup("Operators");
+
+	inputSlots_[0]->SetName("Mesh");
+	inputSlots_[0]->SetVariableName("M");
+	inputSlots_[0]->SetDescription("Mesh to slice");
+	inputSlots_[0]->SetVariantType(VariantType::VAR_VARIANTMAP);
+	inputSlots_[0]->SetDataAccess(DataAccess::ITEM);
+
+	inputSlots_[1]->SetName("Points");
+	inputSlots_[1]->SetVariableName("P");
+	inputSlots_[1]->SetDescription("Point on each plane");
+	inputSlots_[1]->SetVariantType(VariantType::VAR_VECTOR3);
+	inputSlots_[1]->SetDataAccess(DataAccess::LIST);
+
+	inputSlots_[2]->SetName("Normals");
+	inputSlots_[2]->SetVariableName("N");
+	inputSlots_[2]->SetDescription("Normal of each plane, cycled; a single normal gives parallel slices");
+	inputSlots_[2]->SetVariantType(VariantType::VAR_VECTOR3);
+	inputSlots_[2]->SetDataAccess(DataAccess::LIST);
+	inputSlots_[2]->SetDefaultValue(Vector3(0.0f, 1.0f, 0.0f));
+	inputSlots_[2]->DefaultSet();
+
+	outputSlots_[0]->SetName("Contours");
+	outputSlots_[0]->SetVariableName("C");
+	outputSlots_[0]->SetDescription("Section polylines, closed where the mesh is closed");
+	outputSlots_[0]->SetVariantType(VariantType::VAR_VARIANTMAP);
+	outputSlots_[0]->SetDataAccess(DataAccess::LIST);
+
+	outputSlots_[1]->SetName("PlaneIndex");
+	outputSlots_[1]->SetVariableName("I");
+	outputSlots_[1]->SetDescription("Index of the plane each contour lies in");
+	outputSlots_[1]->SetVariantType(VariantType::VAR_INT);
+	outputSlots_[1]->SetDataAccess(DataAccess::LIST);
+}
+
+void Mesh_MeshSlice::SolveInstance(
+	const Vector<Variant>& inSolveInstance,
+	Vector<Variant>& outSolveInstance
+)
+{
+	assert(inSolveInstance.Size() == inputSlots_.Size());
+	assert(outSolveInstance.Size() == outputSlots_.Size());
+
+	///////////////////
+	// VERIFY & EXTRACT
+
+	Variant inMesh = inSolveInstance[0];
+	if (!TriMesh_Verify(inMesh)) {
+		URHO3D_LOGWARNING("Mesh_MeshSlice -- invalid TriMesh");
+		SetAllOutputsNull(outSolveInstance);
+		return;
+	}
+
+	VariantVector pointList = inSolveInstance[1].GetVariantVector();
+	PODVector<Vector3> points;
+	for (unsigned i = 0; i < pointList.Size(); ++i) {
+		if (pointList[i].GetType() == VAR_VECTOR3) {
+			points.Push(pointList[i].GetVector3());
+		}
+	}
+
+	VariantVector normalList = inSolveInstance[2].GetVariantVector();
+	PODVector<Vector3> normals;
+	for (unsigned i = 0; i < normalList.Size(); ++i) {
+		if (normalList[i].GetType() == VAR_VECTOR3) {
+			normals.Push(normalList[i].GetVector3());
+		}
+	}
+
+	if (points.Empty() || normals.Empty()) {
+		URHO3D_LOGWARNING("Mesh_MeshSlice -- needs at least one point and one normal");
+		SetAllOutputsNull(outSolveInstance);
+		return;
+	}
+
+	///////////////////
+	// COMPONENT'S WORK
+
+	VariantVector contours;
+	PODVector<int> contourPlanes;
+	if (!Geomlib::TriMesh_Slice(inMesh, points, normals, contours, contourPlanes)) {
+		SetAllOutputsNull(outSolveInstance);
+		return;
+	}
+
+	VariantVector planeIndices(contourPlanes.Size());
+	for (unsigned i = 0; i < contourPlanes.Size(); ++i) {
+		planeIndices[i] = contourPlanes[i];
+	}
+
+	/////////////////
+	// ASSIGN OUTPUTS
+
+	outSolveInstance[0] = contours;
+	outSolveInstance[1] = planeIndices;
+}
@@ -25,6 +25,7 @@
 #include "Urho3D/AngelScript/Script.h"
 #include "Urho3D/AngelScript/ScriptFile.h"
 
+#include "IoExpression.h"
 #include "TriMesh.h"
 
 using namespace Urho3D;
@@ -79,6 +80,45 @@ void Mesh_PerVertexEval::SolveInstance(
 	}
 	String function = inSolveInstance[1].GetString();
 
+	//compiled path: evaluate the whole vertex array in one go, straight from the mesh positions
+	Vector<String> var_names;
+	var_names.Push("X");
+	var_names.Push("Y");
+	var_names.Push("Z");
+	PODVector<IoExpressionType> var_types(3);
+	var_types[0] = var_types[1] = var_types[2] = EXPR_FLOAT;
+
+	std::shared_ptr<const IoExpression> expression = IoExpression::GetCached(function, var_names, var_types);
+	if (expression) {
+		if (expression->GetResultType() != EXPR_FLOAT) {
+			URHO3D_LOGWARNING("PerVertexEval --- function must evaluate to a float");
+			SetAllOutputsNull(outSolveInstance);
+			return;
+		}
+
+		TriMeshView view(tri_mesh);
+		unsigned num_vertices = view.GetNumVertices();
+		const float* positions = view.GetPositions();
+
+		PODVector<IoExpressionArray> inputs;
+		inputs.Push(IoExpressionArray(positions, 3));
+		inputs.Push(IoExpressionArray(positions + 1, 3));
+		inputs.Push(IoExpressionArray(positions + 2, 3));
+
+		PODVector<float> results(num_vertices);
+		if (num_vertices > 0)
+			expression->Evaluate(inputs, num_vertices, &results[0]);
+
+		VariantVector per_vertex_float_values(num_vertices);
+		for (unsigned i = 0; i < num_vertices; ++i) {
+			per_vertex_float_values[i] = results[i];
+		}
+
+		outSolveInstance[0] = per_vertex_float_values;
+		return;
+	}
+
+	//script fallback for syntax the expression compiler does not cover
 	VariantVector vertex_list = TriMesh_GetVertexList(tri_mesh);
 	VariantVector per_vertex_float_values;
 	for (int i = 0; i < vertex_list.Size(); ++i) {
@@ -24,20 +24,11 @@
 
 #include <assert.h>
 
-#include <iostream>
-#include <vector>
-
-#include <Eigen/Core>
-
-#pragma warning(push, 0)
-#include <igl/adjacency_list.h>
-#pragma warning(pop)
-
-#include "ConversionUtilities.h"
 #include "TriMesh.h"
 #include "Geomlib_TriMeshAverageEdgeLength.h"
 #include "Geomlib_TriMeshEdgeSplit.h"
 #include "Geomlib_TriMeshEdgeCollapse.h"
+#include "Geomlib_TriMeshRemesh.h"
 
 using namespace Urho3D;
 
@@ -71,7 +62,7 @@ Mesh_Remesh::Mesh_Remesh(Context* context) : IoComponentBase(context, 4, 1)
 
 	inputSlots_[3]->SetName("NumSteps");
 	inputSlots_[3]->SetVariableName("NumSteps");
-	inputSlots_[3]->SetDescription("Number of split/collapse steps to perform");
+	inputSlots_[3]->SetDescription("Number of split/collapse/flip/relax steps to perform");
 	inputSlots_[3]->SetVariantType(VariantType::VAR_FLOAT);
 	inputSlots_[3]->SetDataAccess(DataAccess::ITEM);
 	inputSlots_[3]->SetDefaultValue(Variant(2));
@@ -105,9 +96,9 @@ void Mesh_Remesh::SolveInstance(
 
 	// get input slot 1 (optional)
 	Variant target_var = inSolveInstance[1];
-	//float target = Geomlib::TriMeshAverageEdgeLength(inMesh);
-	//if (target_var.GetType() == VAR_FLOAT)
-	//	target = target_var.GetFloat();
+	float target = 0.0f;
+	if (target_var.GetType() == VAR_FLOAT)
+		target = target_var.GetFloat();
 
 	// Verify input slot 0
 	float tol = inSolveInstance[2].GetFloat();
@@ -127,17 +118,21 @@ void Mesh_Remesh::SolveInstance(
 	///////////////////
 	// COMPONENT'S WORK
 
-	Variant curMesh = inMesh;
-	for (int i = 0; i < steps; ++i) {
-
-		float avg_edge_length = Geomlib::TriMeshAverageEdgeLength(curMesh);
-		if (target_var.GetType() == VAR_FLOAT)
-			avg_edge_length = target_var.GetFloat();
-		float split_threshold = (1.0f + tol) * avg_edge_length;
-		Variant splitMesh = Geomlib::TriMesh_SplitLongEdges(curMesh, split_threshold);
-		//avg_edge_length = Geomlib::TriMeshAverageEdgeLength(splitMesh);
-		float collapse_threshold = (1.0f - tol) * avg_edge_length;
-		curMesh = Geomlib::TriMesh_CollapseShortEdges(splitMesh, collapse_threshold);
+	Variant curMesh = Geomlib::TriMesh_Remesh(inMesh, target, tol, steps);
+	if (curMesh.GetType() == VAR_NONE) {
+		// the half-edge remesher needs an oriented manifold, anything else goes through the split/collapse steps
+		URHO3D_LOGINFO("Mesh_Remesh -- TriMesh is not an oriented manifold, only splitting and collapsing edges");
+		curMesh = inMesh;
+		for (int i = 0; i < steps; ++i) {
+
+			float avg_edge_length = Geomlib::TriMeshAverageEdgeLength(curMesh);
+			if (target_var.GetType() == VAR_FLOAT)
+				avg_edge_length = target_var.GetFloat();
+			float split_threshold = (1.0f + tol) * avg_edge_length;
+			Variant splitMesh = Geomlib::TriMesh_SplitLongEdges(curMesh, split_threshold);
+			float collapse_threshold = (1.0f - tol) * avg_edge_length;
+			curMesh = Geomlib::TriMesh_CollapseShortEdges(splitMesh, collapse_threshold);
+		}
 	}
 
 	/////////////////
@@ -29,11 +29,8 @@
 
 #include <Eigen/Core>
 
-#pragma warning(push, 0)
-#include <igl/adjacency_list.h>
-#pragma warning(pop)
-
 #include "ConversionUtilities.h"
+#include "Geomlib_TriMeshAdjacency.h"
 #include "TriMesh.h"
 
 using namespace Urho3D;
@@ -128,21 +125,22 @@ void Mesh_SmoothMesh::SolveInstance(
 	bool loadSuccess = IglMeshToMatrices(inMesh, V, F);
 	Variant outMesh;
 
-	if (loadSuccess) {
-		Eigen::MatrixXf W = V;
+	// topology does not change while smoothing, and repeated solves on the same mesh share it
+	std::shared_ptr<const Geomlib::TriMeshAdjacency> adjacency = Geomlib::TriMeshAdjacency::Get(inMesh);
 
-		std::vector<std::vector<unsigned> > adj;
-		igl::adjacency_list(F, adj);
+	if (loadSuccess && adjacency && (int)adjacency->GetNumVertices() == V.rows()) {
+		Eigen::MatrixXf W = V;
 
 		for (int index = 0; index < steps; ++index) {
-			for (unsigned i = 0; i < adj.size(); ++i) {
-				std::vector<unsigned> cur_adj = adj[i];
+			for (unsigned i = 0; i < adjacency->GetNumVertices(); ++i) {
+				unsigned count = 0;
+				const int* cur_adj = adjacency->GetVertexVertices(i, count);
 				Eigen::RowVector3f v(0.0f, 0.0f, 0.0f);
-				for (unsigned j = 0; j < cur_adj.size(); ++j) {
+				for (unsigned j = 0; j < count; ++j) {
 					v += W.row(cur_adj[j]);
 				}
-				if (cur_adj.size() > 0) {
-					float scalar = 1.0f / cur_adj.size();
+				if (count > 0) {
+					float scalar = 1.0f / count;
 					v = scalar * v;
 				}
 				W.row(i) = v;
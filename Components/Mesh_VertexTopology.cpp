@@ -25,6 +25,7 @@
 
 #include "TriMesh.h"
 #include "MeshTopologyQueries.h"
+#include "Geomlib_TriMeshAdjacency.h"
 
 
 using namespace Urho3D;
@@ -77,7 +78,7 @@ int Mesh_VertexTopology::LocalSolve()
 	nullTree.Add(path, Variant());
     
     if (inputSlots_[0]->HasNoData()) {
-        solvedFlag_ = 0;
+        MarkUnsolved();
 		outputSlots_[0]->SetIoDataTree(nullTree);
 		outputSlots_[1]->SetIoDataTree(nullTree);
 		outputSlots_[2]->SetIoDataTree(nullTree);
@@ -92,7 +93,7 @@ int Mesh_VertexTopology::LocalSolve()
     inputMeshTree.GetItem(inMesh, path, 0);
     if (inMesh.GetType() == VAR_NONE)
     {
-        solvedFlag_ = 0;
+        MarkUnsolved();
 		outputSlots_[0]->SetIoDataTree(nullTree);
 		outputSlots_[1]->SetIoDataTree(nullTree);
 		outputSlots_[2]->SetIoDataTree(nullTree);
@@ -102,7 +103,7 @@ int Mesh_VertexTopology::LocalSolve()
 	
 	if (!TriMesh_HasAdjacencyData(inMesh)) {
 		URHO3D_LOGWARNING("M must be a TriMesh WITH DATA (use Mesh_ComputeAdjacencyData)!");
-		solvedFlag_ = 0;
+		MarkUnsolved();
 		outputSlots_[0]->SetIoDataTree(nullTree);
 		outputSlots_[1]->SetIoDataTree(nullTree);
 		outputSlots_[2]->SetIoDataTree(nullTree);
@@ -126,28 +127,30 @@ IoDataTree Mesh_VertexTopology::ComputeVertexStars(Urho3D::Variant inMeshWithDat
     IoDataTree vertex_stars_tree(GetContext());
     
     VariantMap* meshWithData = inMeshWithData.GetVariantMapPtr();
-    VariantMap* triMesh = (*meshWithData)["mesh"].GetVariantMapPtr();
+    const Variant& triMesh = (*meshWithData)["mesh"];
     
-    Urho3D::VariantVector vertexList = TriMesh_GetVertexList(Variant(*triMesh));
+    std::shared_ptr<const Geomlib::TriMeshAdjacency> adjacency = Geomlib::TriMeshAdjacency::Get(triMesh);
+    if (!adjacency)
+        return vertex_stars_tree;
     
-    for (int i = 0; i < vertexList.Size(); ++i){
+    TriMeshView view(triMesh);
+    
+    for (unsigned i = 0; i < adjacency->GetNumVertices(); ++i){
         Vector<int> path;
         path.Push(i);
         
-        VariantVector* vertex_vertex_list = (*meshWithData)["vertex-vertex"].GetVariantVectorPtr();
-        int num = vertex_vertex_list->Size();
-        if (i < num ){
-            VariantVector vertex_star = (*vertex_vertex_list)[i].GetVariantVector();
-            vertex_stars_tree.Add(path, vertex_star);
-            
-            // compute the vectors of these verts at the same time.
-            VariantVector star_vectors;
-            for (int j = 0; j < vertex_star.Size(); ++j){
-                int curVert = vertex_star[j].GetInt();
-                star_vectors.Push(Variant(vertexList[curVert].GetVector3()));
-            }
-            starVectorsTree.Add(path, star_vectors);
+        unsigned count = 0;
+        const int* star = adjacency->GetVertexVertices(i, count);
+        
+        // compute the vectors of these verts at the same time.
+        VariantVector vertex_star;
+        VariantVector star_vectors;
+        for (unsigned j = 0; j < count; ++j){
+            vertex_star.Push(Variant(star[j]));
+            star_vectors.Push(Variant(view.GetVertex(star[j])));
         }
+        vertex_stars_tree.Add(path, vertex_star);
+        starVectorsTree.Add(path, star_vectors);
     }
 
     return vertex_stars_tree;
@@ -158,22 +161,24 @@ IoDataTree Mesh_VertexTopology::ComputeAdjacentFaces(Urho3D::Variant inMeshWithD
     IoDataTree adjacent_faces_tree(GetContext());
     
     VariantMap* meshWithData = inMeshWithData.GetVariantMapPtr();
-    VariantMap* triMesh = (*meshWithData)["mesh"].GetVariantMapPtr();
     
-    Urho3D::VariantVector vertexList = TriMesh_GetVertexList(Variant(*triMesh));
+    std::shared_ptr<const Geomlib::TriMeshAdjacency> adjacency = Geomlib::TriMeshAdjacency::Get((*meshWithData)["mesh"]);
+    if (!adjacency)
+        return adjacent_faces_tree;
     
-    for (int i = 0; i < vertexList.Size(); ++i){
+    for (unsigned i = 0; i < adjacency->GetNumVertices(); ++i){
         Vector<int> path;
         path.Push(i);
         
-        VariantVector* vertex_face_list = (*meshWithData)["vertex-face"].GetVariantVectorPtr();
-        int num = vertex_face_list->Size();
-        if (i < num){
-            VariantVector adj_faces = (*vertex_face_list)[i].GetVariantVector();
-            adjacent_faces_tree.Add(path, adj_faces);
-        }
+        unsigned count = 0;
+        const int* faces = adjacency->GetVertexFaces(i, count);
         
+        VariantVector adj_faces;
+        for (unsigned j = 0; j < count; ++j){
+            adj_faces.Push(Variant(faces[j]));
+        }
+        adjacent_faces_tree.Add(path, adj_faces);
     }
     
     return adjacent_faces_tree;
-}
+}
\ No newline at end of file
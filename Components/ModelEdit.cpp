@@ -37,13 +37,7 @@
 #include <Urho3D/IO/Log.h>
 
 #include "TriMesh.h"
-
-#pragma warning(push, 0)
-#include <igl/colon.h>
-#include <igl/harmonic.h>
-#include <igl/readOBJ.h>
-#include <igl/readDMAT.h>
-#pragma warning(pop)
+#include "Geomlib_SparseSolverCache.h"
 
 
 using namespace Urho3D;
@@ -172,6 +166,7 @@ void ModelEdit::HandleMouseDown(Urho3D::StringHash eventType, Urho3D::VariantMap
 			startScreenPos_ = GetScaledMousePosition();
 			primaryVertexID_ = raycastResult_.subObject_;
 			editing_ = true;
+			CollectDragHandles();
 
 			URHO3D_LOGINFO("Hello mouse down!");
 		}
@@ -236,9 +231,16 @@ void ModelEdit::HandleMouseMove(Urho3D::StringHash eventType, Urho3D::VariantMap
 			//track displacement and index
 			primaryDelta_ = sceneDeltaVec;
             
-            //move the vertex
-			b->position_ = sceneHint;
-            bs->Commit();
+            //move the vertex, and the ones around it when there is something to deform
+			if (dragIds_.Size() < verts.Size())
+			{
+				PreviewHandles();
+			}
+			else
+			{
+				b->position_ = sceneHint;
+				bs->Commit();
+			}
             
             VariantMap data;
             data["NodeReference"] = raycastResult_.node_;
@@ -282,28 +284,17 @@ void ModelEdit::HandleMouseUp(Urho3D::StringHash eventType, Urho3D::VariantMap&
 
 
 		Variant geomOut;
-		Vector<Vector3> deltas;
-		Vector<int> ids;
-
-		//always push the moved vertex
-		deltas.Push(primaryDelta_);
-		ids.Push(primaryVertexID_);
 
-		//find deltas and ids
-		for (int i = 0; i < verts.Size(); i++)
+		//same handles as the preview, the moved vertex first and the rest held in place
+		Vector<int> ids = dragIds_;
+		Vector<Vector3> deltas(ids.Size());
+		for (unsigned i = 0; i < deltas.Size(); i++)
 		{
-			Vector3 v = verts[i].GetVector3();
-			float dist = (v - orgVert).Length();
-
-			if (dist < radius_)
-			{
-
-			}
-			else
-			{
-				deltas.Push(Vector3::ZERO);
-				ids.Push(i);
-			}
+			deltas[i] = Vector3::ZERO;
+		}
+		if (!deltas.Empty())
+		{
+			deltas[0] = primaryDelta_;
 		}
 
 		//do deformation (make sure there is some deformation to do) 
@@ -331,6 +322,7 @@ void ModelEdit::HandleMouseUp(Urho3D::StringHash eventType, Urho3D::VariantMap&
 		//reset
 		primaryDelta_ = Vector3::ZERO;
 		primaryVertexID_ = -1;
+		dragIds_.Clear();
 
 	}
 }
@@ -352,49 +344,101 @@ void ModelEdit::UpdateHandles()
 	}
 }
 
-void ModelEdit::DoHarmonicDeformation(Urho3D::Vector<Vector3> deltas, Urho3D::Vector<int> ids, Variant& geomOut)
+void ModelEdit::CollectDragHandles()
 {
-	//////do harmonic deformation
+	dragIds_.Clear();
 
-	//init matrices
-	Eigen::MatrixXd V;
-	Eigen::MatrixXi F;
-	Eigen::VectorXi b;
-	Eigen::MatrixXd D_bc;
-	Eigen::MatrixXd D;
+	VariantVector verts = TriMesh_GetVertexList(baseGeometry_);
+	if (primaryVertexID_ < 0 || primaryVertexID_ >= (int)verts.Size())
+	{
+		return;
+	}
+
+	//always push the moved vertex
+	dragIds_.Push(primaryVertexID_);
+
+	//every vertex outside the radius stays where it is
+	Vector3 orgVert = verts[primaryVertexID_].GetVector3();
+	for (unsigned i = 0; i < verts.Size(); i++)
+	{
+		float dist = (verts[i].GetVector3() - orgVert).Length();
+		if (dist >= radius_)
+		{
+			dragIds_.Push(i);
+		}
+	}
+}
+
+void ModelEdit::PreviewHandles()
+{
+	if (!meshEditor_ || dragIds_.Empty())
+	{
+		return;
+	}
+
+	//only the dragged displacement changes between calls, so this is a back-substitution against the cached factorization
+	PODVector<int> b(dragIds_.Size());
+	PODVector<Vector3> D_bc(dragIds_.Size());
+	for (unsigned i = 0; i < dragIds_.Size(); i++)
+	{
+		b[i] = dragIds_[i];
+		D_bc[i] = Vector3::ZERO;
+	}
+	D_bc[0] = primaryDelta_;
+
+	PODVector<Vector3> D;
+	if (!Geomlib::TriMesh_HarmonicDeformation(baseGeometry_, b, D_bc, 2, D))
+	{
+		return;
+	}
 
-	//TriMeshToMatrices(mesh, V, F);
 	VariantVector verts = TriMesh_GetVertexList(baseGeometry_);
-	TriMeshToDoubleMatrices(baseGeometry_, V, F);
+	if (verts.Size() != D.Size() || verts.Size() != meshEditor_->GetNumBillboards())
+	{
+		return;
+	}
 
+	for (unsigned i = 0; i < verts.Size(); i++)
+	{
+		meshEditor_->GetBillboard(i)->position_ = verts[i].GetVector3() + D[i];
+	}
+	meshEditor_->Commit();
+}
+
+void ModelEdit::DoHarmonicDeformation(Urho3D::Vector<Vector3> deltas, Urho3D::Vector<int> ids, Variant& geomOut)
+{
+	//////do harmonic deformation
+
+	VariantVector verts = TriMesh_GetVertexList(baseGeometry_);
 
 	//collect the disp vecs and indices
 	int numVecs = Min(deltas.Size(), ids.Size());
-	b.resize(numVecs);
-	D_bc.resize(numVecs, 3);
+	PODVector<int> b(numVecs);
+	PODVector<Vector3> D_bc(numVecs);
 
 	//create the handle and displacement vectors
 	for (int i = 0; i < numVecs; i++)
 	{
-		int idx = ids[i];
-		Vector3 v = deltas[i];
-		D_bc.row(i) = Eigen::RowVector3d(v.x_, v.y_, v.z_);
-		b[i] = idx;
+		b[i] = ids[i];
+		D_bc[i] = deltas[i];
 	}
 
 	//finally, proceed with calculation
+	//the base geometry and handles are the ones the drag preview solved with, so this reuses its factorization
 	int power = 2;
-	igl::harmonic(V, F, b, D_bc, power, D);
-
-	int dRows = D.rows();
-	int dCols = D.cols();
+	PODVector<Vector3> D;
+	if (!Geomlib::TriMesh_HarmonicDeformation(baseGeometry_, b, D_bc, power, D))
+	{
+		URHO3D_LOGWARNING("ModelEdit --- harmonic deformation failed");
+		geomOut = baseGeometry_;
+		return;
+	}
 
 	VariantVector vecsOut;
 
-	for (int i = 0; i < D.rows(); i++)
+	for (unsigned i = 0; i < D.Size(); i++)
 	{
-		Eigen::RowVector3d v = D.row(i);
-		Vector3 dV = Vector3(v.x(), v.y(), v.z());
+		Vector3 dV = D[i];
 		vecsOut.Push(dV);
 
 		Vector3 orgVert = verts[i].GetVector3();
@@ -43,6 +43,7 @@ public:
     void SetRadius(float radius) { radius_ = radius; }
 	void DoHarmonicDeformation(Urho3D::Vector<Urho3D::Vector3> deltas, Urho3D::Vector<int> ids, Urho3D::Variant& geomOut);
 	void UpdateHandles();
+	void PreviewHandles();
 
 protected:
 
@@ -54,6 +55,10 @@ protected:
 	Urho3D::Variant baseGeometry_;
 	Urho3D::Vector3 primaryDelta_;
 	int primaryVertexID_;
+	// fixed vertices of the drag in progress: the dragged vertex, then every vertex outside radius_.
+	// The base geometry and this set stay the same for the whole drag, so every preview solve and the
+	// final one reuse the factorization built on the first mouse move.
+	Urho3D::Vector<int> dragIds_;
 
 protected:
 
@@ -67,5 +72,6 @@ protected:
 	void HandleMouseUp(Urho3D::StringHash eventType, Urho3D::VariantMap& eventData);
 	void HandleComponentRemoved(Urho3D::StringHash eventType, Urho3D::VariantMap& eventData);
 	bool Raycast();
+	void CollectDragHandles();
 
 };
@@ -42,6 +42,8 @@ public:
 		Urho3D::Vector<Urho3D::Variant>& outSolveInstance
 	);
 
+	bool IsVisibleOutput() const { return true; }
+
 	Urho3D::Vector<Urho3D::SharedPtr<Urho3D::CollisionShape> > trackedItems;
 
 };
\ No newline at end of file
@@ -205,6 +205,9 @@ you must include it here and follow the registration pattern in RegisterComponen
 #include "Curve_HelixSpiral.h"
 #include "Curve_Polyline.h"
 #include "Curve_OffsetPolyline.h"
+#include "Curve_PolygonBoolean.h"
+#include "Curve_PolygonOffset.h"
+#include "Curve_PolylineSplit.h"
 #include "Curve_SmoothPolyline.h"
 #include "Curve_LineSegment.h"
 #include "Curve_SmoothPolyline.h"
@@ -245,6 +248,9 @@ you must include it here and follow the registration pattern in RegisterComponen
 #include "Mesh_TriangulateNMesh.h"
 #include "Mesh_Tetrahedralize.h"
 #include "Mesh_MeshPlaneIntersection.h"
+#include "Mesh_MeshSlice.h"
+#include "Mesh_MeshIntersection.h"
+#include "Mesh_MeshBoolean.h"
 #include "Mesh_AverageEdgeLength.h"
 #include "Mesh_UnifyNormals.h"
 #include "Mesh_SplitLongEdges.h"
@@ -494,12 +500,15 @@ void RegisterCoreComponents(Context* context)
 	RegisterIogramType<Mesh_HarmonicDeformation>(context);
 	RegisterIogramType<Mesh_TriangulateNMesh>(context);
 	RegisterIogramType<Mesh_MeshModeler>(context);
-	//	RegisterIogramType<Mesh_FieldRemesh>(context);
+	RegisterIogramType<Mesh_FieldRemesh>(context);
 	RegisterIogramType<Curve_ZigZagPolyline>(context);
     RegisterIogramType<Curve_HelixSpiral>(context);
     RegisterIogramType<Curve_PolylineSweep>(context);
     RegisterIogramType<Curve_Polyline>(context);
 	RegisterIogramType<Curve_OffsetPolyline>(context);
+	RegisterIogramType<Curve_PolygonBoolean>(context);
+	RegisterIogramType<Curve_PolygonOffset>(context);
+	RegisterIogramType<Curve_PolylineSplit>(context);
 	RegisterIogramType<Curve_SmoothPolyline>(context);
 	RegisterIogramType<Curve_LineSegment>(context);
 	RegisterIogramType<Curve_SmoothPolyline>(context);
@@ -536,6 +545,9 @@ void RegisterCoreComponents(Context* context)
 	RegisterIogramType<Mesh_FacePolylines>(context);
 	RegisterIogramType<Mesh_Boundary>(context);
 	RegisterIogramType<Mesh_MeshPlaneIntersection>(context);
+	RegisterIogramType<Mesh_MeshSlice>(context);
+	RegisterIogramType<Mesh_MeshIntersection>(context);
+	RegisterIogramType<Mesh_MeshBoolean>(context);
 	RegisterIogramType<Mesh_JoinMeshes>(context);
 	RegisterIogramType<Mesh_TriMeshVolume>(context);
 	RegisterIogramType<Mesh_Tetrahedralize>(context);
@@ -41,5 +41,7 @@ public:
 		Urho3D::Vector<Urho3D::Variant>& outSolveInstance
 		);
 
+	bool IsVisibleOutput() const { return true; }
+
 	Urho3D::Vector<Urho3D::Pair<int, Urho3D::String>> trackedItems;
 };
\ No newline at end of file
@@ -37,4 +37,6 @@ public:
 		const Urho3D::Vector<Urho3D::Variant>& inSolveInstance,
 		Urho3D::Vector<Urho3D::Variant>& outSolveInstance
 		);
+
+	bool IsVisibleOutput() const { return true; }
 };
\ No newline at end of file
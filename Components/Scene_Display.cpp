@@ -36,7 +36,9 @@ using namespace Urho3D;
 String Scene_Display::iconTexture = "Textures/Icons/Scene_Display.png";
 
 
-Scene_Display::Scene_Display(Urho3D::Context* context) : IoComponentBase(context, 4, 2)
+Scene_Display::Scene_Display(Urho3D::Context* context) : IoComponentBase(context, 4, 2),
+	renderCache(context),
+	pointItem(-1)
 {
 	SetName("Display");
 	SetFullName("Geometry Display");
@@ -80,7 +82,7 @@ Scene_Display::Scene_Display(Urho3D::Context* context) : IoComponentBase(context
 
 	outputSlots_[1]->SetName("Model");
 	outputSlots_[1]->SetVariableName("M");
-	outputSlots_[1]->SetDescription("Pointer to model");
+	outputSlots_[1]->SetDescription("Pointer to model, or to the billboard set of points. When linked, a model is a copy that later solves leave unchanged");
 	outputSlots_[1]->SetVariantType(VariantType::VAR_PTR); // this would change to VAR_FLOAT if access becomes LIST
 	outputSlots_[1]->SetDataAccess(DataAccess::ITEM);
 
@@ -88,23 +90,62 @@ Scene_Display::Scene_Display(Urho3D::Context* context) : IoComponentBase(context
 
 void Scene_Display::PreLocalSolve()
 {
+	pointPositions.Clear();
+	pointColors.Clear();
+	pointItem = -1;
+
+	renderCache.BeginSolve();
+}
+
+void Scene_Display::PostLocalSolve()
+{
+	//points arrive one item at a time, they are all drawn here in a single pass
 	Scene* scene = (Scene*)GetGlobalVar("Scene").GetPtr();
-	if (scene)
+	if (scene && pointItem >= 0)
 	{
-		for (int i = 0; i < trackedItems.Size(); i++)
+		ResourceCache* cache = GetSubsystem<ResourceCache>();
+		Node* node = renderCache.GetNode(pointItem, scene, ID + "_Preview");
+
+		if (pointPositions.Size() <= IO_MAX_BILLBOARD_POINTS)
 		{
-			Node* n = scene->GetNode(trackedItems[i]);
-			if (n)
+			renderCache.RemovePointCloud(pointItem);
+
+			BillboardSet* pointCloud = node->GetOrCreateComponent<BillboardSet>();
+			pointCloud->SetMaterial(cache->GetResource<Material>(pointMat));
+			pointCloud->SetSorted(true);
+			pointCloud->SetFixedScreenSize(true);
+			pointCloud->SetNumBillboards(pointPositions.Size());
+
+			for (unsigned i = 0; i < pointPositions.Size(); i++)
 			{
-				n->RemoveAllComponents();
-				n->Remove();
+				Billboard* bb = pointCloud->GetBillboard(i);
+				bb->position_ = pointPositions[i];
+				bb->size_ = Vector2(10.0f, 10.0f);
+				bb->enabled_ = true;
+				bb->color_ = pointColors[i];
 			}
+
+			pointCloud->Commit();
 		}
-	}
+		else
+		{
+			//the billboard set stays, empty, so the Model outputs still point to it
+			BillboardSet* pointCloud = node->GetOrCreateComponent<BillboardSet>();
+			pointCloud->SetNumBillboards(0);
+			pointCloud->Commit();
 
-	trackedItems.Clear();
+			PODVector<unsigned> colors(pointColors.Size());
+			for (unsigned i = 0; i < pointColors.Size(); i++)
+			{
+				colors[i] = pointColors[i].ToUInt();
+			}
 
-	pointCloud = NULL;
+			Material* mat = renderCache.GetMaterial(pointItem, cache->GetResource<Material>(pointCloudMat));
+			renderCache.UpdatePointCloud(pointItem, scene, ID + "_Preview", pointPositions, colors, mat);
+		}
+	}
+
+	renderCache.EndSolve();
 }
 
 void Scene_Display::SolveInstance(
@@ -139,75 +180,70 @@ void Scene_Display::SolveInstance(
 	}
 
 
+	if (inSolveInstance[0].GetType() == VAR_VECTOR3)
+	{
+		//collect the point, the whole set is drawn at once in PostLocalSolve
+		if (pointItem < 0)
+		{
+			pointItem = (int)renderCache.FindItem("points");
+		}
+
+		pointPositions.Push(inSolveInstance[0].GetVector3());
+		pointColors.Push(inSolveInstance[1].GetColor());
+
+		Node* node = renderCache.GetNode(pointItem, scene, ID + "_Preview");
+		outSolveInstance[0] = node->GetID();
+		outSolveInstance[1] = node->GetOrCreateComponent<BillboardSet>();
+
+		return;
+	}
+
 	VariantVector vCols;
+	unsigned item = renderCache.FindItem(solvePath_, solveIndex_);
+	PODVector<Vector3> positions;
+	PODVector<Vector3> normals;
+	PODVector<unsigned> colors;
+	PODVector<unsigned> indices;
 
 	//first check that input 0 is a model already
 	SharedPtr<Model> mdl((Model*)inSolveInstance[0].GetVoidPtr());
+	bool cachedModel = false;
 	if (mdl)
 	{
 
-	} //create the model
+	} //create the model, reusing this item's buffers from the last solve
 	else if (TriMesh_Verify(inSolveInstance[0]))
 	{
-		mdl = TriMesh_GetRenderMesh(inSolveInstance[0], GetContext(), vCols, flat);
+		if (TriMesh_GetRenderData(inSolveInstance[0], vCols, flat, positions, normals, colors, indices))
+		{
+			mdl = renderCache.UpdateModel(item, positions, normals, colors, indices);
+			cachedModel = true;
+		}
 
 	}
 	else if (NMesh_Verify(inSolveInstance[0]))
 	{
-		mdl = NMesh_GetRenderMesh(inSolveInstance[0], GetContext(), vCols, flat);
+		if (NMesh_GetRenderData(inSolveInstance[0], vCols, positions, normals, colors, indices))
+		{
+			mdl = renderCache.UpdateModel(item, positions, normals, colors, indices);
+			cachedModel = true;
+		}
 	}
 	else if (Polyline_Verify(inSolveInstance[0]))
 	{
-		mdl = Polyline_GetRenderMesh(inSolveInstance[0], GetContext(), vCols, 0.01f);
-		mat = GetSubsystem<ResourceCache>()->GetResource<Material>(normalMatWires);
-	}
-	else if (inSolveInstance[0].GetType() == VAR_VECTOR3)
-	{
-		//check if billboard set is null
-		if (!pointCloud)
-		{
-			Node* node = scene->CreateChild(ID + "_Preview");
-			pointCloud = node->CreateComponent<BillboardSet>();
-			pointCloud->SetNumBillboards(1);
-			ResourceCache* cache = GetSubsystem<ResourceCache>();
-			Material* pMat = cache->GetResource<Material>(pointMat);
-			pointCloud->SetMaterial(pMat);
-			pointCloud->SetSorted(true);
-			trackedItems.Push(node->GetID());
-
-		}
-
-		//otherwise continue
-		int numPoints = pointCloud->GetNumBillboards();
-		if (numPoints > 16000)
+		if (Polyline_GetRenderData(inSolveInstance[0], vCols, 0.01f, false, positions, normals, colors, indices))
 		{
-			URHO3D_LOGWARNING("Large vertex count detected.");
+			mdl = renderCache.UpdateModel(item, positions, normals, colors, indices);
+			cachedModel = true;
 		}
-
-		pointCloud->SetNumBillboards(numPoints + 1);
-		Billboard* bb = pointCloud->GetBillboard(numPoints);
-
-		bb->position_ = inSolveInstance[0].GetVector3();
-		bb->size_ = Vector2(10.0f, 10.0f);
-		bb->enabled_ = true;
-		bb->color_ = inSolveInstance[1].GetColor();
-		pointCloud->SetFixedScreenSize(true);
-		pointCloud->Commit();
-
-		//TODO: totally not ideal, but works for now
-		outSolveInstance[0] = pointCloud->GetNode()->GetID();
-		outSolveInstance[1] = pointCloud;
-
-		return;
+		mat = GetSubsystem<ResourceCache>()->GetResource<Material>(normalMatWires);
 	}
 
 	//have model, now actually put it in the scene
 	if (mdl && mat)
 	{
-		Node* node = scene->CreateChild(ID + "_Preview");
-		StaticModel* sm = node->CreateComponent<StaticModel>();
-
-		SharedPtr<Material> cMat = mat->Clone();
+		StaticModel* sm = renderCache.GetStaticModel(item, scene, ID + "_Preview");
+		Material* cMat = renderCache.GetMaterial(item, mat);
 		col = inSolveInstance[1].GetColor();
 		int mode = inSolveInstance[2].GetInt();
 		mode = Clamp(mode, 0, 2);
@@ -220,9 +256,16 @@ void Scene_Display::SolveInstance(
 		sm->SetMaterial(cMat);
 		sm->SetCastShadows(true);
 	
-		trackedItems.Push(node->GetID());
-		outSolveInstance[0] = node->GetID();
-		outSolveInstance[1] = mdl;
+		outSolveInstance[0] = sm->GetNode()->GetID();
+		//the cached model is rewritten by the next solve, linked components get a copy that stays as it is now
+		if (cachedModel && outputSlots_[1]->GetNumLinkedInputSlots() > 0)
+		{
+			outSolveInstance[1] = renderCache.GetModelSnapshot(item);
+		}
+		else
+		{
+			outSolveInstance[1] = mdl;
+		}
 	}
 	else {
 		SetAllOutputsNull(outSolveInstance);
@@ -23,6 +23,7 @@
 #pragma once
 
 #include "IoComponentBase.h"
+#include "IoRenderCache.h"
 #include <Urho3D/Graphics/BillboardSet.h>
 
 class URHO3D_API Scene_Display : public IoComponentBase {
@@ -31,18 +32,24 @@ public:
 	Scene_Display(Urho3D::Context* context);
 
 	virtual void PreLocalSolve();
+	virtual void PostLocalSolve();
 
-	Urho3D::Vector<int> trackedItems;
+	IoRenderCache renderCache;
+
+	///points collected over a solve, drawn together in PostLocalSolve
+	Urho3D::PODVector<Urho3D::Vector3> pointPositions;
+	Urho3D::PODVector<Urho3D::Color> pointColors;
+	int pointItem;
 
 	void SolveInstance(
 		const Urho3D::Vector<Urho3D::Variant>& inSolveInstance,
 		Urho3D::Vector<Urho3D::Variant>& outSolveInstance
 		);
 
+	bool IsVisibleOutput() const { return true; }
+
 	static Urho3D::String iconTexture;
 
-	Urho3D::BillboardSet* pointCloud;
-    
 
 	///normal preview material
 #ifdef EMSCRIPTEN
@@ -57,5 +64,6 @@ public:
 	
 	Urho3D::String normalMatWires = "Materials/BasicWireframe.xml";
 	Urho3D::String pointMat = "Materials/BasicPoints.xml";
+	Urho3D::String pointCloudMat = "Materials/BasicPointCloud.xml";
 	Urho3D::String widget = "Materials/BasicTransparent.xml";
 };
@@ -56,7 +56,7 @@ int Scene_HandleEvent::LocalSolve()
 	assert(outputSlots_.Size() >= 1);
 
 	if (inputSlots_[0]->HasNoData()) {
-		solvedFlag_ = 0;
+		MarkUnsolved();
 		return 0;
 	}
 
@@ -69,7 +69,7 @@ int Scene_HandleEvent::LocalSolve()
 	String eventName = name.GetString();
 	if (eventName.Empty())
 	{
-		solvedFlag_ = 0;
+		MarkUnsolved();
 		return 0;
 	}
 
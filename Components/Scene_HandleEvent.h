@@ -31,6 +31,8 @@ public:
 
 	int LocalSolve();
 
+	bool IsVisibleOutput() const { return true; }
+
 	static Urho3D::String iconTexture;
 
 	void GenericEventHandler(Urho3D::StringHash eventType, Urho3D::VariantMap& eventData);
@@ -114,7 +114,7 @@ void Scene_MouseClickListener::HandleMouseClick(StringHash eventType, VariantMap
 			(float)(pos.y_ - viewRect.top_)/viewRect.Height(), 0);
 	}
 
-	solvedFlag_ = 0;
+	MarkUnsolved();
 	GetSubsystem<IoGraph>()->QuickTopoSolveGraph();
 }
 
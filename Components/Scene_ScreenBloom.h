@@ -40,5 +40,7 @@ public:
 		Urho3D::Vector<Urho3D::Variant>& outSolveInstance
 		);
 
+	bool IsVisibleOutput() const { return true; }
+
 	bool hasBloom = false;
 };
\ No newline at end of file
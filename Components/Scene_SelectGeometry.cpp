@@ -249,6 +249,6 @@ void Scene_SelectGeometry::HandleMouseClick(StringHash eventType, VariantMap& ev
 		mPos = Vector3(pos.x_ - viewRect.left_, pos.y_ - viewRect.top_, 0);
 	}
 
-	solvedFlag_ = 0;
+	MarkUnsolved();
 	GetSubsystem<IoGraph>()->QuickTopoSolveGraph();
 }
\ No newline at end of file
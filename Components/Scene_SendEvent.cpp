@@ -55,7 +55,7 @@ int Scene_SendEvent::LocalSolve()
 	assert(outputSlots_.Size() == 0);
 
 	if (inputSlots_[0]->HasNoData() || inputSlots_[1]->HasNoData()) {
-		solvedFlag_ = 0;
+		MarkUnsolved();
 		return 0;
 	}
 
@@ -69,7 +69,7 @@ int Scene_SendEvent::LocalSolve()
 	String eventName = name.GetString();
 	if (eventName.Empty())
 	{
-		solvedFlag_ = 0;
+		MarkUnsolved();
 		return 0;
 	}
 
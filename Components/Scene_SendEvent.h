@@ -31,5 +31,7 @@ public:
 
 	int LocalSolve();
 
+	bool IsVisibleOutput() const { return true; }
+
 	static Urho3D::String iconTexture;
 };
\ No newline at end of file
@@ -93,7 +93,7 @@ void Scene_UpdateListener::HandleSceneUpdate(StringHash eventType, VariantMap& e
 	elapsedTime = GetSubsystem<Time>()->GetElapsedTime();
 	deltaTime = eventData[P_TIMESTEP].GetFloat();
 
-	solvedFlag_ = 0;
+	MarkUnsolved();
 	GetSubsystem<IoGraph>()->QuickTopoSolveGraph();
 
 }
\ No newline at end of file
@@ -40,6 +40,8 @@ public:
 		Urho3D::Vector<Urho3D::Variant>& outSolveInstance
 		);
 
+	bool IsVisibleOutput() const { return true; }
+
 	float lastStartTime = 0.0f;
 	float elapsedTime = 0.0f;
 	float deltaTime = 0.0f;
@@ -83,7 +83,7 @@ void Sets_ExportViewData::HandleLineEdit(StringHash eventType, VariantMap& event
 	if (exportNameEdit)
 	{
 		exportName = exportNameEdit->GetText();
-		solvedFlag_ = 0;
+		MarkUnsolved();
 
 		//set as metadata
 		SetGenericData("ExportVariableName", exportName);
@@ -98,14 +98,14 @@ int Sets_ExportViewData::LocalSolve()
 	exportName = GetGenericData("ExportVariableName").GetString();
 		
 	if (inputSlots_[0]->HasNoData()) {
-		solvedFlag_ = 0;
+		MarkUnsolved();
 		return 0;
 	}
 
 	//check that the name is actually valid
 	if (exportName.Empty())
 	{
-		solvedFlag_ = 0;
+		MarkUnsolved();
 		return 0;
 	}
 
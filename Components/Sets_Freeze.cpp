@@ -31,6 +31,7 @@
 #include <Urho3D/UI/UIEvents.h>;
 #include "ColorDefs.h"
 #include "IoGraph.h"
+#include "IoSerialization.h"
 #include <assert.h>
 
 using namespace Urho3D;
@@ -88,8 +89,7 @@ void Sets_Freeze::SolveInstance(
 		VariantMap map = inSolveInstance[0].GetVariantMap();
 		if (file->GetMode() == FILE_WRITE)
 		{
-			//file->Write(msg.GetData(), msg.GetSize());
-			file->WriteVariantMap(map);
+			IoSerialization::SaveData(map, *file);
 		}
 		file->Close();
 
@@ -116,7 +116,11 @@ void Sets_Freeze::SolveInstance(
 		SharedPtr<File> file = rc->GetFile(resourceName_);
 		if (file)
 		{			
-			VariantMap vm = file->ReadVariantMap();
+			VariantMap vm;
+			if (!IoSerialization::LoadData(vm, *file))
+			{
+				URHO3D_LOGWARNING("Sets_Freeze --- could not read " + resourceName_);
+			}
 
 			//create flat list.
 			//TODO: maintain tree structure
@@ -193,7 +197,7 @@ void Sets_Freeze::HandleModeChange(Urho3D::StringHash eventType, Urho3D::Variant
 		SetGenericData("FreezeFile", resourceName_);
 	}
 
-	solvedFlag_ = 0;
+	MarkUnsolved();
 	GetSubsystem<IoGraph>()->QuickTopoSolveGraph();
 }
 
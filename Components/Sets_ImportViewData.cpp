@@ -81,7 +81,7 @@ void Sets_ImportViewData::HandleLineEdit(StringHash eventType, VariantMap& event
 	if (importNameEdit)
 	{
 		importName = importNameEdit->GetText();
-		solvedFlag_ = 0;
+		MarkUnsolved();
 
 		//set as metadata
 		SetGenericData("ImportVariableName", importName);
@@ -98,7 +98,7 @@ int Sets_ImportViewData::LocalSolve()
 	
 	if (importName.Empty())
 	{
-		solvedFlag_ = 0;
+		MarkUnsolved();
 		return 0;
 	}
 
@@ -107,7 +107,7 @@ int Sets_ImportViewData::LocalSolve()
 
 	if (!viewExportsMap.Keys().Contains(importName))
 	{
-		solvedFlag_ = 0;
+		MarkUnsolved();
 		return 0;
 	}
 
@@ -116,7 +116,7 @@ int Sets_ImportViewData::LocalSolve()
 	int sourceIndex = graph->GetComponentIndex(sourceID);
 	if (sourceIndex < 0)
 	{
-		solvedFlag_ = 0;
+		MarkUnsolved();
 		return 0;
 	}
 
@@ -129,7 +129,7 @@ int Sets_ImportViewData::LocalSolve()
 	{
 		//create the connection and call solve to update the outputs
 		graph->AddConnection(sourceIndex, 0, targetIndex, 0);
-		solvedFlag_ = 0;
+		MarkUnsolved();
 
 		//pretty dangerouse to call solve within solve
 		//couldn't get the conection created above to "stick" without it, though.
@@ -59,13 +59,13 @@ Sets_ListLength::Sets_ListLength(Context* context) :
 int Sets_ListLength::LocalSolve()
 {
 	if (inputSlots_[0]->HasNoData()) {
-		solvedFlag_ = 0;
+		MarkUnsolved();
 		return 0;
 	}
 
 	SharedPtr<IoDataTree> in_tree = SharedPtr<IoDataTree>(new IoDataTree(inputSlots_[0]->GetIoDataTree()));
 	if (in_tree->GetNumBranches() == 0) {
-		solvedFlag_ = 0;
+		MarkUnsolved();
 		return 0;
 	}
 
@@ -117,7 +117,7 @@ void Sets_LoopBegin::HandleUpdate(StringHash eventType, VariantMap& eventData)
 	//only update if this condition is met
 	if (currentIndex < numSteps)
 	{
-		solvedFlag_ = 0;
+		MarkUnsolved();
 		GetSubsystem<IoGraph>()->QuickTopoSolveGraph();
 	}
 	else
@@ -37,6 +37,25 @@
 using namespace Urho3D;
 
 namespace {
+
+	bool IsNumber(const Variant& var)
+	{
+		VariantType type = var.GetType();
+		return type == VAR_INT || type == VAR_FLOAT || type == VAR_DOUBLE;
+	}
+
+	// rangeMin and rangeMax are optional, they only take effect when both are given and 0 <= rangeMin <= rangeMax
+	bool GetRange(const Variant& minVar, const Variant& maxVar, double& minRange, double& maxRange)
+	{
+		if (!IsNumber(minVar) || !IsNumber(maxVar)) {
+			return false;
+		}
+
+		minRange = minVar.GetDouble();
+		maxRange = maxVar.GetDouble();
+		return minRange >= 0.0 && maxRange >= minRange;
+	}
+
 } // namespace
 
 String ShapeOp_EdgeStrain::iconTexture = "Textures/Icons/DefaultIcon.png";
@@ -51,21 +70,21 @@ ShapeOp_EdgeStrain::ShapeOp_EdgeStrain(Context* context) : IoComponentBase(conte
 
 	inputSlots_[0]->SetName("Start");
 	inputSlots_[0]->SetVariableName("S");
-	inputSlots_[0]->SetDescription("Start point of edge");
+	inputSlots_[0]->SetDescription("Start points of edges");
 	inputSlots_[0]->SetVariantType(VariantType::VAR_VECTOR3);
-	inputSlots_[0]->SetDataAccess(DataAccess::ITEM);
+	inputSlots_[0]->SetDataAccess(DataAccess::LIST);
 
 	inputSlots_[1]->SetName("End");
 	inputSlots_[1]->SetVariableName("E");
-	inputSlots_[1]->SetDescription("End point of edge");
+	inputSlots_[1]->SetDescription("End points of edges");
 	inputSlots_[1]->SetVariantType(VariantType::VAR_VECTOR3);
-	inputSlots_[1]->SetDataAccess(DataAccess::ITEM);
+	inputSlots_[1]->SetDataAccess(DataAccess::LIST);
 
 	inputSlots_[2]->SetName("Weight");
 	inputSlots_[2]->SetVariableName("W");
-	inputSlots_[2]->SetDescription("Weight of edge constraint");
+	inputSlots_[2]->SetDescription("Weights of edge constraints, the last one repeats for the remaining edges");
 	inputSlots_[2]->SetVariantType(VariantType::VAR_FLOAT);
-	inputSlots_[2]->SetDataAccess(DataAccess::ITEM);
+	inputSlots_[2]->SetDataAccess(DataAccess::LIST);
 	inputSlots_[2]->SetDefaultValue(Variant(1.0f));
 	inputSlots_[2]->DefaultSet();
 
@@ -83,15 +102,100 @@ ShapeOp_EdgeStrain::ShapeOp_EdgeStrain(Context* context) : IoComponentBase(conte
 
 	outputSlots_[0]->SetName("EdgeStrain");
 	outputSlots_[0]->SetVariableName("ES");
-	outputSlots_[0]->SetDescription("EdgeStrain ShapeOp constraint");
+	outputSlots_[0]->SetDescription("EdgeStrain ShapeOp constraints, one block for all edges");
 	outputSlots_[0]->SetVariantType(VariantType::VAR_VARIANTMAP);
-	outputSlots_[0]->SetDataAccess(DataAccess::ITEM);
+	outputSlots_[0]->SetDataAccess(DataAccess::LIST);
+}
+
+void ShapeOp_EdgeStrain::LoadInputAccess(unsigned inputIndex, DataAccess savedAccess)
+{
+	// Start, End and Weight used to be items, old graphs keep one constraint map per edge
+	if (inputIndex <= 2 && savedAccess == DataAccess::ITEM) {
+		inputSlots_[inputIndex]->SetDataAccess(DataAccess::ITEM);
+		outputSlots_[0]->SetDataAccess(DataAccess::ITEM);
+	}
 }
 
 void ShapeOp_EdgeStrain::SolveInstance(
 	const Vector<Variant>& inSolveInstance,
 	Vector<Variant>& outSolveInstance
 )
+{
+	// graphs saved before Start and End took lists solve one edge per instance, see LoadInputAccess
+	if (inSolveInstance[0].GetType() != VAR_VARIANTVECTOR) {
+		SolveSingleEdge(inSolveInstance, outSolveInstance);
+		return;
+	}
+
+	const VariantVector& startList = inSolveInstance[0].GetVariantVector();
+	const VariantVector& endList = inSolveInstance[1].GetVariantVector();
+	VariantVector weightList;
+	if (inSolveInstance[2].GetType() == VAR_VARIANTVECTOR) {
+		weightList = inSolveInstance[2].GetVariantVector();
+	}
+	else {
+		weightList.Push(inSolveInstance[2]);
+	}
+
+	if (startList.Empty() || startList.Size() != endList.Size() || weightList.Empty()) {
+		SetAllOutputsNull(outSolveInstance);
+		URHO3D_LOGWARNING("ShapeOp_EdgeStrain --- Start and End must be lists of the same length, with at least one weight");
+		return;
+	}
+
+	double minRange = 0.0;
+	double maxRange = 0.0;
+	bool hasRange = GetRange(inSolveInstance[3], inSolveInstance[4], minRange, maxRange);
+
+	// one block for all edges, ShapeOp_Solve adds it without a Variant per constraint
+	unsigned numEdges = startList.Size();
+	PODVector<Vector3> points(2 * numEdges);
+	PODVector<int> ids(2 * numEdges);
+	PODVector<float> weights(numEdges);
+	PODVector<double> scalars(hasRange ? 3 * numEdges : 0);
+
+	for (unsigned i = 0; i < numEdges; ++i) {
+		const Variant& weightVar = weightList[Min(i, weightList.Size() - 1)];
+		if (
+			startList[i].GetType() != VAR_VECTOR3 ||
+			endList[i].GetType() != VAR_VECTOR3 ||
+			!(weightVar.GetType() == VAR_FLOAT || weightVar.GetType() == VAR_DOUBLE)
+			)
+		{
+			SetAllOutputsNull(outSolveInstance);
+			URHO3D_LOGWARNING("ShapeOp_EdgeStrain --- invalid input");
+			return;
+		}
+
+		float weight = weightVar.GetFloat();
+		if (weight <= 0.0f) {
+			SetAllOutputsNull(outSolveInstance);
+			URHO3D_LOGWARNING("ShapeOp_EdgeStrain --- weight must be > 0.0f");
+			return;
+		}
+
+		points[2 * i] = startList[i].GetVector3();
+		points[2 * i + 1] = endList[i].GetVector3();
+		ids[2 * i] = 2 * i;
+		ids[2 * i + 1] = 2 * i + 1;
+		weights[i] = weight;
+
+		if (hasRange) {
+			scalars[3 * i] = (points[2 * i] - points[2 * i + 1]).Length();
+			scalars[3 * i + 1] = minRange;
+			scalars[3 * i + 2] = maxRange;
+		}
+	}
+
+	VariantVector strainsOut;
+	strainsOut.Push(ShapeOpConstraintBlock_Make("EdgeStrain", points, ids, 2, weights, scalars, 3));
+	outSolveInstance[0] = strainsOut;
+}
+
+void ShapeOp_EdgeStrain::SolveSingleEdge(
+	const Vector<Variant>& inSolveInstance,
+	Vector<Variant>& outSolveInstance
+)
 {
 	if (
 		inSolveInstance[0].GetType() != VAR_VECTOR3 ||
@@ -125,27 +229,16 @@ void ShapeOp_EdgeStrain::SolveInstance(
 	var_map["vertices"] = shapeop_vertices;
 
 	// User has the option of supplying minRange and maxRange values if defaults won't do
-	VariantType type_minRange = inSolveInstance[3].GetType();
-	VariantType type_maxRange = inSolveInstance[4].GetType();
-	if (
-		(type_minRange == VAR_INT || type_minRange == VAR_FLOAT || type_minRange == VAR_DOUBLE) &&
-		(type_maxRange == VAR_INT || type_maxRange == VAR_FLOAT || type_maxRange == VAR_DOUBLE)
-		)
+	double minRange = 0.0;
+	double maxRange = 0.0;
+	if (GetRange(inSolveInstance[3], inSolveInstance[4], minRange, maxRange))
 	{
-		double minRange = inSolveInstance[3].GetDouble();
-		double maxRange = inSolveInstance[4].GetDouble();
-		if (
-			minRange >= 0.0 &&
-			maxRange >= minRange
-			)
-		{
-			double length = (start_coords - end_coords).Length();
+		double length = (start_coords - end_coords).Length();
 
-			var_map["length"] = length;
-			var_map["minRange"] = minRange;
-			var_map["maxRange"] = maxRange;
-			var_map["editFlag"] = 1;
-		}
+		var_map["length"] = length;
+		var_map["minRange"] = minRange;
+		var_map["maxRange"] = maxRange;
+		var_map["editFlag"] = 1;
 	}
 
 	Variant constraint = Variant(var_map);
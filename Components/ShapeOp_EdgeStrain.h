@@ -29,6 +29,8 @@ class URHO3D_API ShapeOp_EdgeStrain : public IoComponentBase {
 public:
 	ShapeOp_EdgeStrain(Urho3D::Context* context);
 
+	void LoadInputAccess(unsigned inputIndex, DataAccess savedAccess);
+
 	void SolveInstance(
 		const Urho3D::Vector<Urho3D::Variant>& inSolveInstance,
 		Urho3D::Vector<Urho3D::Variant>& outSolveInstance
@@ -40,4 +42,11 @@ public:
 	void DeleteOutputSlot(int index) = delete;
 
 	static Urho3D::String iconTexture;
+
+private:
+	// one constraint map, for graphs saved with item access
+	void SolveSingleEdge(
+		const Urho3D::Vector<Urho3D::Variant>& inSolveInstance,
+		Urho3D::Vector<Urho3D::Variant>& outSolveInstance
+	);
 };
\ No newline at end of file
@@ -99,17 +99,27 @@ void ShapeOp_GeometryStrain::SolveInstance(
 	)
 {
 	
-	VariantVector verts;
+	PODVector<Vector3> points;
 	Vector<Pair<int, int>> edges;
 	
 	if(TriMesh_Verify(inSolveInstance[0]))
 	{
-		verts = TriMesh_GetVertexList(inSolveInstance[0]);
+		TriMeshView view(inSolveInstance[0]);
+		points.Resize(view.GetNumVertices());
+		for (unsigned i = 0; i < points.Size(); i++)
+		{
+			points[i] = view.GetVertex(i);
+		}
 		edges = TriMesh_ComputeEdges(inSolveInstance[0]);
 	}
 	else if (Polyline_Verify(inSolveInstance[0]))
 	{
-		verts = Polyline_GetVertexList(inSolveInstance[0]);
+		VariantVector verts = Polyline_GetVertexList(inSolveInstance[0]);
+		points.Resize(verts.Size());
+		for (unsigned i = 0; i < points.Size(); i++)
+		{
+			points[i] = verts[i].GetVector3();
+		}
 		edges = Polyline_ComputeEdges(inSolveInstance[0]);
 	}
 	else
@@ -118,36 +128,31 @@ void ShapeOp_GeometryStrain::SolveInstance(
 		return;
 	}
 
-	//create the constraints
-	VariantVector strainsOut;
+	if (edges.Empty())
+	{
+		SetAllOutputsNull(outSolveInstance);
+		return;
+	}
 
 	//get general params
 	float weight = inSolveInstance[1].GetFloat();
-	float min = inSolveInstance[2].GetFloat();
-	float max = inSolveInstance[3].GetFloat();
 
-	for (int i = 0; i < edges.Size(); i++)
+	//one block for all edges, sharing the vertices of the geometry; ShapeOp_Solve adds it without a Variant per constraint
+	PODVector<int> ids(2 * edges.Size());
+	for (unsigned i = 0; i < edges.Size(); i++)
 	{
-		
-		Vector3 vA = verts[edges[i].first_].GetVector3();
-		Vector3 vB = verts[edges[i].second_].GetVector3();
-		
-		Variant start = ShapeOpVertex_Make(vA);
-		Variant end = ShapeOpVertex_Make(vB);
-		VariantVector shapeop_vertices;
-		shapeop_vertices.Push(start);
-		shapeop_vertices.Push(end);
-
-		VariantMap var_map;
-		var_map["type"] = Variant("ShapeOpConstraint");
-		var_map["constraintType"] = Variant("EdgeStrain");
-		var_map["weight"] = weight;
-		var_map["vertices"] = shapeop_vertices;
-
-		strainsOut.Push(var_map);
+		ids[2 * i] = edges[i].first_;
+		ids[2 * i + 1] = edges[i].second_;
+	}
 
+	PODVector<float> weights(edges.Size());
+	for (unsigned i = 0; i < weights.Size(); i++)
+	{
+		weights[i] = weight;
 	}
 
+	VariantVector strainsOut;
+	strainsOut.Push(ShapeOpConstraintBlock_Make("EdgeStrain", points, ids, 2, weights, PODVector<double>(), 0));
 
 	outSolveInstance[0] = strainsOut;
 }
\ No newline at end of file
@@ -99,51 +99,37 @@ void ShapeOp_MeshTriangleStrain::SolveInstance(
 	)
 {
 
-	VariantVector verts;
-	VariantVector faces;
-
-	if (TriMesh_Verify(inSolveInstance[0]))
-	{
-		verts = TriMesh_GetVertexList(inSolveInstance[0]);
-		faces = TriMesh_GetFaceList(inSolveInstance[0]);
-	}
-	else
+	TriMeshView view(inSolveInstance[0]);
+	if (!TriMesh_Verify(inSolveInstance[0]) || !view.IsValid())
 	{
 		SetAllOutputsNull(outSolveInstance);
 		return;
 	}
 
-	//create the constraints
-	VariantVector strainsOut;
-
 	//get general params
 	float weight = inSolveInstance[1].GetFloat();
-	float min = inSolveInstance[2].GetFloat();
-	float max = inSolveInstance[3].GetFloat();
 
-	for (int i = 0; i < faces.Size()/3; i++)
+	//one block for all faces, ShapeOp_Solve adds it without a Variant per constraint
+	PODVector<Vector3> points(view.GetNumVertices());
+	for (unsigned i = 0; i < points.Size(); i++)
 	{
+		points[i] = view.GetVertex(i);
+	}
 
-		Vector3 vA = verts[faces[3 * i + 0].GetInt()].GetVector3();
-		Vector3 vB = verts[faces[3 * i + 1].GetInt()].GetVector3();
-		Vector3 vC = verts[faces[3 * i + 2].GetInt()].GetVector3();
-
-		VariantVector shapeop_vertices = {
-			ShapeOpVertex_Make(vA),
-			ShapeOpVertex_Make(vB),
-			ShapeOpVertex_Make(vC)
-		};
-
-		VariantMap var_map;
-		var_map["type"] = Variant("ShapeOpConstraint");
-		var_map["constraintType"] = Variant("TriangleStrain");
-		var_map["weight"] = weight;
-		var_map["vertices"] = shapeop_vertices;
-
-		strainsOut.Push(var_map);
+	PODVector<int> ids(3 * view.GetNumFaces());
+	for (unsigned i = 0; i < ids.Size(); i++)
+	{
+		ids[i] = view.GetIndices()[i];
+	}
 
+	PODVector<float> weights(view.GetNumFaces());
+	for (unsigned i = 0; i < weights.Size(); i++)
+	{
+		weights[i] = weight;
 	}
 
+	VariantVector strainsOut;
+	strainsOut.Push(ShapeOpConstraintBlock_Make("TriangleStrain", points, ids, 3, weights, PODVector<double>(), 0));
 
 	outSolveInstance[0] = strainsOut;
 }
\ No newline at end of file
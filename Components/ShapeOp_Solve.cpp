@@ -24,7 +24,9 @@
 
 #include <assert.h>
 
+#include <cstring>
 #include <iostream>
+#include <unordered_map>
 #include <vector>
 
 #include <Urho3D/Core/Context.h>
@@ -37,6 +39,7 @@
 #include "ShapeOp_IogramWrapper.h"
 #include "ShapeOp_Solver.h"
 
+#include "Geomlib_RemoveDuplicates.h"
 #include "TriMesh.h"
 
 using namespace Urho3D;
@@ -75,25 +78,124 @@ namespace {
 		}
 	}
 
-	void SetUpRawVertices(
-		VariantVector& constraints,
+	// Constraints of one type sharing the number of ids and edit scalars. The ids index the raw
+	// vertex list until welding and the welded list after it.
+	struct ConstraintBlock {
+		String constraintType;
+		unsigned idsPerConstraint;
+		unsigned scalarsPerConstraint;
+		std::vector<int> ids;
+		std::vector<double> weights;
+		std::vector<double> scalars;
+	};
+
+	ConstraintBlock& FindOrAddBlock(
+		std::vector<ConstraintBlock>& blocks,
+		unsigned first_shared_block,
+		const String& constraintType,
+		unsigned idsPerConstraint,
+		unsigned scalarsPerConstraint
+	)
+	{
+		for (unsigned i = first_shared_block; i < blocks.size(); ++i) {
+			ConstraintBlock& block = blocks[i];
+			if (
+				block.idsPerConstraint == idsPerConstraint &&
+				block.scalarsPerConstraint == scalarsPerConstraint &&
+				block.constraintType == constraintType
+				)
+			{
+				return block;
+			}
+		}
+
+		ConstraintBlock block;
+		block.constraintType = constraintType;
+		block.idsPerConstraint = idsPerConstraint;
+		block.scalarsPerConstraint = scalarsPerConstraint;
+		blocks.push_back(block);
+		return blocks.back();
+	}
+
+	// One pass over a single ShapeOpConstraint map, batched into the block for its type
+	void AddSingleConstraint(
+		const Variant& constraint,
+		std::vector<ConstraintBlock>& blocks,
+		unsigned first_shared_block,
 		Vector<Vector3>& raw_vertices
 	)
 	{
-		int raw_index = 0;
-		for (unsigned i = 0; i < constraints.Size(); ++i) {
-
-			VariantMap* var_map = constraints[i].GetVariantMapPtr();
-			VariantVector* shapeop_vertices = (*var_map)["vertices"].GetVariantVectorPtr();
-
-			for (unsigned j = 0; j < shapeop_vertices->Size(); ++j) {
-				VariantMap* var_map2 = (*shapeop_vertices)[j].GetVariantMapPtr();
-				Vector3 v = (*var_map2)["coords"].GetVector3();
-				raw_vertices.Push(v);
-				SetConstraintRawIndex(constraints[i], j, raw_index);
-				++raw_index;
+		const VariantMap& var_map = constraint.GetVariantMap();
+		const Variant* vertices_var = var_map["vertices"];
+		if (vertices_var == NULL || vertices_var->GetType() != VAR_VARIANTVECTOR) {
+			return;
+		}
+		const VariantVector& shapeop_vertices = vertices_var->GetVariantVector();
+		if (shapeop_vertices.Empty()) {
+			return;
+		}
+
+		String constraintType = ShapeOpConstraint_constraintType(constraint);
+
+		// edit parameters, under the keys the constraint components write
+		double scalars[3];
+		unsigned nb_scalars = 0;
+		const Variant* edit_flag = var_map["editFlag"];
+		if (edit_flag != NULL && edit_flag->GetInt() == 1) {
+			const Variant* length = var_map["length"];
+			const Variant* min_range = var_map["minRange"];
+			const Variant* max_range = var_map["maxRange"];
+			if (constraintType == "EdgeStrain" && length && min_range && max_range) {
+				scalars[nb_scalars++] = length->GetDouble();
+				scalars[nb_scalars++] = min_range->GetDouble();
+				scalars[nb_scalars++] = max_range->GetDouble();
 			}
+			else if (constraintType == "TriangleStrain" && min_range && max_range) {
+				scalars[nb_scalars++] = min_range->GetDouble();
+				scalars[nb_scalars++] = max_range->GetDouble();
+			}
+		}
+
+		ConstraintBlock& block = FindOrAddBlock(blocks, first_shared_block, constraintType, shapeop_vertices.Size(), nb_scalars);
+		for (unsigned j = 0; j < shapeop_vertices.Size(); ++j) {
+			const Variant* coords = shapeop_vertices[j].GetVariantMap()["coords"];
+			block.ids.push_back((int)raw_vertices.Size());
+			raw_vertices.Push(coords != NULL ? coords->GetVector3() : Vector3::ZERO);
+		}
+		block.weights.push_back(ShapeOpConstraint_weight(constraint));
+		block.scalars.insert(block.scalars.end(), scalars, scalars + nb_scalars);
+	}
+
+	// Copies a ShapeOpConstraintBlock's arrays, without touching a Variant per constraint
+	void AddConstraintBlock(
+		const ShapeOpConstraintBlockView& view,
+		std::vector<ConstraintBlock>& blocks,
+		Vector<Vector3>& raw_vertices
+	)
+	{
+		int raw_offset = (int)raw_vertices.Size();
+		const float* points = view.GetPoints();
+		raw_vertices.Resize(raw_vertices.Size() + view.GetNumPoints());
+		for (unsigned i = 0; i < view.GetNumPoints(); ++i) {
+			raw_vertices[raw_offset + i] = Vector3(points + 3 * i);
 		}
+
+		unsigned nb_ids = view.GetNumConstraints() * view.GetIdsPerConstraint();
+		unsigned nb_scalars = view.GetNumConstraints() * view.GetScalarsPerConstraint();
+
+		ConstraintBlock block;
+		block.constraintType = view.GetConstraintType();
+		block.idsPerConstraint = view.GetIdsPerConstraint();
+		block.scalarsPerConstraint = view.GetScalarsPerConstraint();
+		block.ids.resize(nb_ids);
+		for (unsigned i = 0; i < nb_ids; ++i) {
+			block.ids[i] = raw_offset + view.GetIds()[i];
+		}
+		block.weights.assign(view.GetWeights(), view.GetWeights() + view.GetNumConstraints());
+		if (nb_scalars > 0) {
+			block.scalars.assign(view.GetScalars(), view.GetScalars() + nb_scalars);
+		}
+		blocks.push_back(block);
 	}
 
 	void WeldVertices(
@@ -105,8 +207,6 @@ namespace {
 		float eps
 	)
 	{
-		float epsSquared = eps * eps;
-
 		if (vertices.Size() <= 1) {
 			URHO3D_LOGWARNING("WeldVertices-- - vertices.Size() <= 1, nothing to process");
 			welded_vertices = vertices;
@@ -114,108 +214,96 @@ namespace {
 			return;
 		}
 
-		std::vector<int> vertexDuplicates_(vertices.Size());
-
-		for (int i = 0; i < (int)vertices.Size(); ++i) {
-			vertexDuplicates_[i] = i; // Assume not a duplicate
-			for (int j = 0; j < i; ++j) {
-				if ((vertices[j] - vertices[i]).LengthSquared() < epsSquared) {
-					vertexDuplicates_[i] = j;
-					break;
-				}
-			}
+		PODVector<Vector3> points(vertices.Size());
+		for (unsigned i = 0; i < vertices.Size(); ++i) {
+			points[i] = vertices[i];
 		}
 
-		std::vector<int> vertexUniques_ = vertexDuplicates_;
-		std::sort(vertexUniques_.begin(), vertexUniques_.end());
-		vertexUniques_.erase(std::unique(vertexUniques_.begin(), vertexUniques_.end()), vertexUniques_.end());
+		PODVector<Vector3> welded_points;
+		PODVector<int> weld_indices;
+		Geomlib::WeldPoints(points, eps, Geomlib::WELD_DISTANCE, welded_points, weld_indices, true);
 
-		for (int i = 0; i < vertexUniques_.size(); ++i) {
-			int k = vertexUniques_[i];
-			welded_vertices.Push(vertices[k]);
+		welded_vertices.Resize(welded_points.Size());
+		for (unsigned i = 0; i < welded_points.Size(); ++i) {
+			welded_vertices[i] = welded_points[i];
 		}
-
-		for (int j = 0; j < (int)vertices.Size(); ++j) {
-			int orig_j = vertexDuplicates_[j];
-			int uniq_j = find(vertexUniques_.begin(), vertexUniques_.end(), orig_j) - vertexUniques_.begin();
-			new_indices.Push(uniq_j);
+		new_indices.Resize(weld_indices.Size());
+		for (unsigned i = 0; i < weld_indices.Size(); ++i) {
+			new_indices[i] = weld_indices[i];
 		}
 
 		assert(new_indices.Size() == vertices.Size());
 	}
 
-	void UpdateConstraintsAfterWelding(
-		VariantVector& constraints,
+	void UpdateBlocksAfterWelding(
+		std::vector<ConstraintBlock>& blocks,
 		const Vector<int>& new_indices
 	)
 	{
-		for (unsigned i = 0; i < constraints.Size(); ++i) {
-			VariantMap* var_map = constraints[i].GetVariantMapPtr();
-			VariantVector* shapeop_vertices = (*var_map)["vertices"].GetVariantVectorPtr();
-
-			for (unsigned j = 0; j < shapeop_vertices->Size(); ++j) {
-				VariantMap* var_map2 = (*shapeop_vertices)[j].GetVariantMapPtr();
-				int current_raw_index = (*var_map2)["raw_index"].GetInt();
-				int processed_index = new_indices[current_raw_index];
-				SetConstraintProcessedIndex(constraints[i], j, processed_index);
+		for (unsigned i = 0; i < blocks.size(); ++i) {
+			std::vector<int>& ids = blocks[i].ids;
+			for (unsigned j = 0; j < ids.size(); ++j) {
+				ids[j] = new_indices[ids[j]];
 			}
 		}
 	}
 
-	struct ConstraintEditData {
-		int index_into_constraints;
-		std::vector<double> scalars;
-	};
-
-	void PrepareAndCall_shapeop_editConstraint(
-		Variant& constraint,
-		std::vector<ConstraintEditData>& all_edit_data,
+	// Closeness targets live on the right-hand side of ShapeOp's system, so moving
+	// them does not require a new factorization.
+	void EditClosenessTargets(
+		const ConstraintBlock& block,
+		const int* constraint_ids,
+		const Vector<Vector3>& welded_vertices,
 		ShapeOpSolver* op
 	)
 	{
-		String constraintType = ShapeOpConstraint_constraintType(constraint);
-
-		VariantMap* var_map = constraint.GetVariantMapPtr();
-
-		if (constraintType == String("EdgeStrain")) {
-			int constraint_id = (*var_map)["constraint_id"].GetInt();
-			assert(constraint_id != -1);
-
-			ConstraintEditData ced;
-			ced.scalars = std::vector<double>(3);
-			ced.scalars[0] = (*var_map)["length"].GetDouble();
-			ced.scalars[1] = (*var_map)["rangeMin"].GetDouble();
-			ced.scalars[2] = (*var_map)["rangeMax"].GetDouble();
-			all_edit_data.push_back(ced);
-			int i = (int)all_edit_data.size() - 1;
-
-			shapeop_editConstraint(
-				op,
-				constraintType.CString(),
-				constraint_id,
-				all_edit_data[i].scalars.data(),
-				(int)all_edit_data[i].scalars.size()
-			);
+		if (block.idsPerConstraint != 1) {
+			return;
 		}
-		else if (constraintType == String("TriangleStrian")) {
-			int constraint_id = (*var_map)["constraint_id"].GetInt();
-			assert(constraint_id != -1);
 
-			ConstraintEditData ced;
-			ced.scalars = std::vector<double>(2);
-			ced.scalars[0] = (*var_map)["rangeMin"].GetDouble();
-			ced.scalars[1] = (*var_map)["rangeMax"].GetDouble();
-			all_edit_data.push_back(ced);
-			int i = (int)all_edit_data.size() - 1;
+		std::vector<double> scalars(3 * block.ids.size());
+		for (unsigned i = 0; i < block.ids.size(); ++i) {
+			Vector3 v = welded_vertices[block.ids[i]];
+			scalars[3 * i] = (double)v.x_;
+			scalars[3 * i + 1] = (double)v.y_;
+			scalars[3 * i + 2] = (double)v.z_;
+		}
+		shapeop_editConstraints(op, "Closeness", constraint_ids, (int)block.ids.size(), scalars.data(), 3);
+	}
 
-			shapeop_editConstraint(
-				op,
-				constraintType.CString(),
-				constraint_id,
-				all_edit_data[i].scalars.data(),
-				(int)all_edit_data[i].scalars.size()
-			);
+	// Everything that goes into ShapeOp's system matrix: point count, constraint
+	// types, ids and weights, plus the dynamic parameters. A persistent solver
+	// can be reused only while this stays the same.
+	std::vector<double> ComputeSessionSignature(
+		const std::vector<ConstraintBlock>& blocks,
+		int nb_points,
+		bool add_gravity,
+		const Vector3& g_vec,
+		double mass,
+		double damping,
+		double timestep
+	)
+	{
+		std::vector<double> signature;
+		signature.push_back((double)nb_points);
+		signature.push_back(add_gravity ? 1.0 : 0.0);
+		signature.push_back((double)g_vec.x_);
+		signature.push_back((double)g_vec.y_);
+		signature.push_back((double)g_vec.z_);
+		signature.push_back(mass);
+		signature.push_back(damping);
+		signature.push_back(timestep);
+
+		for (unsigned i = 0; i < blocks.size(); ++i) {
+			const ConstraintBlock& block = blocks[i];
+			signature.push_back((double)block.constraintType.ToHash());
+			signature.push_back((double)block.idsPerConstraint);
+			signature.push_back((double)block.weights.size());
+			signature.insert(signature.end(), block.weights.begin(), block.weights.end());
+			signature.insert(signature.end(), block.ids.begin(), block.ids.end());
 		}
+
+		return signature;
 	}
 
 	// ShapeOp's solver natively operates on raw points not meshes.
@@ -228,35 +316,53 @@ namespace {
 	};
 	*/
 
+	// exact coordinate match, as the tracked meshes are the ones the constraints were built from
+	struct Vector3BitsHash {
+		size_t operator()(const Vector3& v) const
+		{
+			// -0.0f compares equal to 0.0f, so both hash as 0.0f
+			float coords[3] = { v.x_ + 0.0f, v.y_ + 0.0f, v.z_ + 0.0f };
+			unsigned bits[3];
+			memcpy(bits, coords, sizeof(bits));
+			return (size_t)(bits[0] * 73856093u ^ bits[1] * 19349663u ^ bits[2] * 83492791u);
+		}
+	};
+	struct Vector3BitsEqual {
+		bool operator()(const Vector3& a, const Vector3& b) const
+		{
+			return a.x_ == b.x_ && a.y_ == b.y_ && a.z_ == b.z_;
+		}
+	};
+
 	void SetUpMeshTrackingData(
 		VariantVector& unverified_meshes,
 		const Vector<Vector3>& raw_vertices,
 		std::vector<MeshTrackingData>& tracked_meshes
 	)
 	{
+		// first raw index of every coordinate
+		std::unordered_map<Vector3, int, Vector3BitsHash, Vector3BitsEqual> raw_lookup;
+		if (!unverified_meshes.Empty()) {
+			raw_lookup.reserve(raw_vertices.Size());
+			for (unsigned k = 0; k < raw_vertices.Size(); ++k) {
+				raw_lookup.insert(std::make_pair(raw_vertices[k], (int)k));
+			}
+		}
+
 		for (int i = 0; i < unverified_meshes.Size(); ++i) {
 			if (TriMesh_Verify(unverified_meshes[i])) {
 				MeshTrackingData mtd;
 				mtd.mesh = unverified_meshes[i];
-				VariantMap* var_map = unverified_meshes[i].GetVariantMapPtr();
-				VariantVector* vertex_list = (*var_map)["vertices"].GetVariantVectorPtr();
+				VariantVector vertex_list_storage = TriMesh_GetVertexList(unverified_meshes[i]);
+				VariantVector* vertex_list = &vertex_list_storage;
 				for (unsigned j = 0; j < vertex_list->Size(); ++j) {
 					Vector3 v = (*vertex_list)[j].GetVector3();
-					bool found = false;
-					for (unsigned k = 0; k < raw_vertices.Size(); ++k) {
-						Vector3 w = raw_vertices[k];
-						if (
-							v.x_ == w.x_ &&
-							v.y_ == w.y_ &&
-							v.z_ == w.z_
-							)
-						{
-							found = true;
-							mtd.raw_indices.push_back(k);
-							break;
-						}
+					std::unordered_map<Vector3, int, Vector3BitsHash, Vector3BitsEqual>::const_iterator it = raw_lookup.find(v);
+					bool found = it != raw_lookup.end();
+					if (found) {
+						mtd.raw_indices.push_back(it->second);
 					}
-					if (!found) {
+					else {
 						std::cout << "FAILED to find exact match for tracked mesh vertex in raw_vertices" << std::endl;
 					}
 				}
@@ -316,7 +422,7 @@ ShapeOp_Solve::ShapeOp_Solve(Context* context) : IoComponentBase(context, 10, 2)
 	inputSlots_[1]->SetDescription("Weld points within distance");
 	inputSlots_[1]->SetVariantType(VariantType::VAR_FLOAT);
 	inputSlots_[1]->SetDataAccess(DataAccess::ITEM);
-	inputSlots_[1]->SetDefaultValue(Variant(0.0001f));
+	inputSlots_[1]->SetDefaultValue(Variant(0.001f));
 	inputSlots_[1]->DefaultSet();
 
 	inputSlots_[2]->SetName("Gravity");
@@ -365,7 +471,7 @@ ShapeOp_Solve::ShapeOp_Solve(Context* context) : IoComponentBase(context, 10, 2)
 
 	inputSlots_[8]->SetName("ResetPts");
 	inputSlots_[8]->SetVariableName("ResetPts");
-	inputSlots_[8]->SetDescription("Reset points");
+	inputSlots_[8]->SetDescription("Reset points to their input positions without restarting the solver");
 	inputSlots_[8]->SetVariantType(VariantType::VAR_BOOL);
 	inputSlots_[8]->SetDataAccess(DataAccess::ITEM);
 	inputSlots_[8]->SetDefaultValue(Variant(false));
@@ -373,7 +479,7 @@ ShapeOp_Solve::ShapeOp_Solve(Context* context) : IoComponentBase(context, 10, 2)
 
 	inputSlots_[9]->SetName("Restart");
 	inputSlots_[9]->SetVariableName("Restart");
-	inputSlots_[9]->SetDescription("Restart");
+	inputSlots_[9]->SetDescription("Rebuild the solver on every solve; set false to keep stepping the same session while constraints are unchanged");
 	inputSlots_[9]->SetVariantType(VariantType::VAR_BOOL);
 	inputSlots_[9]->SetDataAccess(DataAccess::ITEM);
 	inputSlots_[9]->SetDefaultValue(Variant(true));
@@ -392,11 +498,20 @@ ShapeOp_Solve::ShapeOp_Solve(Context* context) : IoComponentBase(context, 10, 2)
 	outputSlots_[1]->SetDataAccess(DataAccess::LIST);
 }
 
+ShapeOp_Solve::~ShapeOp_Solve()
+{
+	if (op != NULL) {
+		shapeop_delete(op);
+		op = NULL;
+	}
+}
+
 void ShapeOp_Solve::SolveInstance(
 	const Vector<Variant>& inSolveInstance,
 	Vector<Variant>& outSolveInstance
 )
 {
+	bool reset_points = inSolveInstance[8].GetBool();
 	bool reinitialize = inSolveInstance[9].GetBool();
 
 	///////////////////////////////////////////////////////////////////////////////
@@ -431,29 +546,41 @@ void ShapeOp_Solve::SolveInstance(
 	);
 	m_iterations = iterations;
 
-	// get all valid constraints
-	VariantVector unverified_constraints = inSolveInstance[0].GetVariantVector();
-	VariantVector constraints;
+	// get all valid constraints, single constraints of a type share one block
+	const VariantVector& unverified_constraints = inSolveInstance[0].GetVariantVector();
+	std::vector<ConstraintBlock> blocks;
+	Vector<Vector3> raw_vertices;
 	for (unsigned i = 0; i < unverified_constraints.Size(); ++i) {
 
-		Variant var = unverified_constraints[i];
+		const Variant& var = unverified_constraints[i];
+		ShapeOpConstraintBlockView view(var);
+		if (view.IsValid()) {
+			AddConstraintBlock(view, blocks, raw_vertices);
+		}
+	}
+	unsigned first_shared_block = (unsigned)blocks.size();
+	for (unsigned i = 0; i < unverified_constraints.Size(); ++i) {
+
+		const Variant& var = unverified_constraints[i];
 		if (ShapeOpConstraint_Verify(var)) {
-			constraints.Push(var);
+			AddSingleConstraint(var, blocks, first_shared_block, raw_vertices);
 		}
 	}
-	if (constraints.Size() <= 0) {
+	unsigned nb_constraints = 0;
+	for (unsigned i = 0; i < blocks.size(); ++i) {
+		nb_constraints += (unsigned)blocks[i].weights.size();
+	}
+	if (nb_constraints == 0) {
 		SetAllOutputsNull(outSolveInstance);
 		URHO3D_LOGWARNING("ShapeOp_Solve --- no valid constraints found at ConstraintList");
 		return;
 	}
 	URHO3D_LOGINFO("ShapeOp_Solve --- found valid constraints, beginning vertex processing....");
 
-	// Collect points as raw_vertices, weld nearby ones, update constraint metadata
-	Vector<Vector3> raw_vertices;
-	SetUpRawVertices(constraints, raw_vertices);
+	// Weld nearby raw vertices and point the constraint ids at the welded ones
 	Vector<Vector3> welded_vertices;
 	Vector<int> new_indices;
-	WeldVertices(raw_vertices, welded_vertices, new_indices, 0.001f);
+	WeldVertices(raw_vertices, welded_vertices, new_indices, weld_eps);
 	if (welded_vertices.Empty())
 	{
 		SetAllOutputsNull(outSolveInstance);
@@ -461,7 +588,7 @@ void ShapeOp_Solve::SolveInstance(
 	}
 
 	m_new_indices = new_indices;
-	UpdateConstraintsAfterWelding(constraints, new_indices);
+	UpdateBlocksAfterWelding(blocks, new_indices);
 
 	VariantVector unverified_meshes = inSolveInstance[7].GetVariantVector();
 	std::vector<MeshTrackingData> tracked_meshes;
@@ -472,87 +599,128 @@ void ShapeOp_Solve::SolveInstance(
 	// II. ShapeOp API calls
 	///////////////////////////////////////////////////////////////////////////////
 
-	// 1) Create the solver with #shapeop_create
+	int nb_points = (int)welded_vertices.Size();
+	std::vector<double> pts_in(3 * nb_points);
+	for (int i = 0; i < nb_points; ++i) {
+		const Vector3& v = welded_vertices[i];
+		pts_in[3 * i] = (double)v.x_;
+		pts_in[3 * i + 1] = (double)v.y_;
+		pts_in[3 * i + 2] = (double)v.z_;
+	}
 
-	ShapeOpSolver* op = shapeop_create();
-	//ShapeOpSolver* op = shapeop_create();
+	// The existing solver (and the factorization built by #shapeop_initDynamic) is
+	// reused unless a restart is requested or the system it was built for changed.
+	std::vector<double> signature = ComputeSessionSignature(
+		blocks,
+		nb_points,
+		add_gravity,
+		g_vec,
+		mass,
+		damping,
+		timestep
+	);
+	bool restart = reinitialize || op == NULL || signature != m_signature;
 
-	// 2) Set the vertices with #shapeop_setPoints
+	if (restart) {
 
-	std::vector<double> pts_in;
-	for (int i = 0; i < (int)welded_vertices.Size(); ++i) {
-		Vector3 v = welded_vertices[i];
-		pts_in.push_back((double)v.x_);
-		pts_in.push_back((double)v.y_);
-		pts_in.push_back((double)v.z_);
-	}
+		if (op != NULL) {
+			shapeop_delete(op);
+			op = NULL;
+		}
 
-	int nb_points = (int)(pts_in.size() / 3);
-	m_nb_points = nb_points;
-	shapeop_setPoints(op, pts_in.data(), nb_points);
+		// 1) Create the solver with #shapeop_create
 
-	// 3A) Setup the constraints with #shapeop_addConstraint and #shapeop_editConstraint
+		op = shapeop_create();
 
-	// all ids are captured here so their data won't go out of scope after added to the solver
-	// since they must be added as array ptr/size combos
-	std::vector<std::vector<int> > all_ids;
-	for (unsigned i = 0; i < constraints.Size(); ++i) {
+		// 2) Set the vertices with #shapeop_setPoints
 
-		Variant constraint = constraints[i];
-		std::vector<int> ids;
-		int val = GetConstraintIds(constraint, ids);
-		all_ids.push_back(ids);
-	}
+		m_nb_points = nb_points;
+		shapeop_setPoints(op, pts_in.data(), nb_points);
 
-	assert((unsigned)all_ids.size() == constraints.Size());
+		// 3A) Setup the constraints with #shapeop_addConstraints and #shapeop_editConstraints,
+		// one call per block
 
-	int count = 0;
-	for (unsigned i = 0; i < constraints.Size(); ++i) {
+		m_constraint_ids.assign(nb_constraints, -1);
+		int count = 0;
+		unsigned offset = 0;
+		for (unsigned i = 0; i < blocks.size(); ++i) {
 
-		Variant constraint = constraints[i];
-		int nb_ids = (int)all_ids[i].size();
+			const ConstraintBlock& block = blocks[i];
+			int nb_block = (int)block.weights.size();
+			int* constraint_ids = m_constraint_ids.data() + offset;
 
-		int constraint_id = shapeop_addConstraint(
-			op,
-			ShapeOpConstraint_constraintType(constraint).CString(),
-			all_ids[i].data(),
-			nb_ids,
-			ShapeOpConstraint_weight(constraint)
-		);
-		if (ShapeOpConstraint_NeedsEdit(constraints[i])) {
-			ShapeOpConstraint_SetConstraintId(constraints[i], constraint_id);
+			count += shapeop_addConstraints(
+				op,
+				block.constraintType.CString(),
+				block.ids.data(),
+				(int)block.idsPerConstraint,
+				block.weights.data(),
+				nb_block,
+				constraint_ids
+			);
+			if (block.scalarsPerConstraint > 0) {
+				shapeop_editConstraints(
+					op,
+					block.constraintType.CString(),
+					constraint_ids,
+					nb_block,
+					block.scalars.data(),
+					(int)block.scalarsPerConstraint
+				);
+			}
+			offset += nb_block;
 		}
-		count++;
-	}
 
-	std::vector<ConstraintEditData> all_edit_data;
-	for (unsigned i = 0; i < constraints.Size(); ++i) {
+		URHO3D_LOGINFO("ShapeOp_Solve --- " + String(count) + " Constraints added");
 
-		if (ShapeOpConstraint_NeedsEdit(constraints[i])) {
-			PrepareAndCall_shapeop_editConstraint(
-				constraints[i],
-				all_edit_data,
-				op
-			);
-		}
-	}
+		// 3B) Setup the forces with #shapeop_addVertexForce
 
-	URHO3D_LOGINFO("ShapeOp_Solve --- " + String(count) + " Constraints added");
+		// ... not sure if we're still adding forces to individual vertices
 
-	// 3B) Setup the forces with #shapeop_addVertexForce
+		double gravity_force[3] = { (double)g_vec.x_, (double)g_vec.y_, (double)g_vec.z_ };
+		if (add_gravity) {
+			shapeop_addGravityForce(op, gravity_force);
+			URHO3D_LOGINFO("ShapeOp_Solve --- Gravity force added");
+		}
 
-	// ... not sure if we're still adding forces to individual vertices
+		// 4) Initialize the solver with #shapeop_init or #shapeop_initDynamic
 
-	double gravity_force[3] = { (double)g_vec.x_, (double)g_vec.y_, (double)g_vec.z_ };
-	if (add_gravity) {
-		shapeop_addGravityForce(op, gravity_force);
-		URHO3D_LOGINFO("ShapeOp_Solve --- Gravity force added");
+		shapeop_initDynamic(op, mass, damping, timestep);
+		m_signature = signature;
 	}
+	else {
+
+		// Same points, constraints and weights as the running session: only the
+		// constraint targets are refreshed, the factorization is left untouched.
+		if (reset_points) {
+			shapeop_setPoints(op, pts_in.data(), nb_points);
+		}
+
+		assert(m_constraint_ids.size() == nb_constraints);
 
-	// 4) Initialize the solver with #shapeop_init or #shapeop_initDynamic
+		unsigned offset = 0;
+		for (unsigned i = 0; i < blocks.size(); ++i) {
 
-	//shapeop_init(op);
-	shapeop_initDynamic(op, mass, damping, timestep);
+			const ConstraintBlock& block = blocks[i];
+			int nb_block = (int)block.weights.size();
+			const int* constraint_ids = m_constraint_ids.data() + offset;
+
+			if (block.scalarsPerConstraint > 0) {
+				shapeop_editConstraints(
+					op,
+					block.constraintType.CString(),
+					constraint_ids,
+					nb_block,
+					block.scalars.data(),
+					(int)block.scalarsPerConstraint
+				);
+			}
+			else if (block.constraintType == "Closeness") {
+				EditClosenessTargets(block, constraint_ids, welded_vertices, op);
+			}
+			offset += nb_block;
+		}
+	}
 
 	// 5) Optimize with #shapeop_solve
 
@@ -565,11 +733,8 @@ void ShapeOp_Solve::SolveInstance(
 	std::vector<double> pts_out(3 * nb_points);
 	shapeop_getPoints(op, pts_out.data(), nb_points);
 
-	// 7) Delete the solver with #shapeop_delete
-	shapeop_delete(op);
-
-	//shapeop_delete(op);
-	//op = NULL;
+	// 7) The solver is kept alive for the next solve and deleted on restart or
+	// in the destructor with #shapeop_delete
 
 	///////////////////////////////////////////////////////////////////////////////
 	// III. Prepare and assign outputs
@@ -586,47 +751,4 @@ void ShapeOp_Solve::SolveInstance(
 
 	outSolveInstance[0] = points;
 	outSolveInstance[1] = meshes_out;
-	//}
-	//else if (op != NULL) {
-
-	//	//make double sure that some constraints have been created
-	//	if (m_nb_points == -1)
-	//	{
-	//		SetAllOutputsNull(outSolveInstance);
-	//		return;
-	//	}
-
-	//	assert(op);
-	//	assert(m_nb_points != -1);
-
-	//	URHO3D_LOGINFO("ShapeOp_Solve --- continuing solver for " + String(m_iterations) + " iterations....");
-	//	shapeop_solve(op, m_iterations);
-	//	URHO3D_LOGINFO("ShapeOp_Sovle --- solver finished");
-
-	//	// 6) Get back the vertices with #shapeop_getPoints
-
-	//	std::vector<double> pts_out(3 * m_nb_points);
-	//	shapeop_getPoints(op, pts_out.data(), m_nb_points);
-
-	//	// 7) Delete the solver with #shapeop_delete
-
-	//	//shapeop_delete(op);
-	//	//op = NULL;
-
-	//	///////////////////////////////////////////////////////////////////////////////
-	//	// III. Prepare and assign outputs
-	//	///////////////////////////////////////////////////////////////////////////////
-
-	//	VariantVector points;
-	//	for (int i = 0; i < 3 * m_nb_points; i += 3) {
-	//		Vector3 pt((float)pts_out[i], (float)pts_out[i + 1], (float)pts_out[i + 2]);
-	//		points.Push(pt);
-	//	}
-
-	//	VariantVector meshes_out;
-	//	UpdateTrackedMeshes(m_tracked_meshes, m_new_indices, points, meshes_out);
-
-	//	outSolveInstance[0] = points;
-	//	outSolveInstance[1] = meshes_out;
-	//}
-}
\ No newline at end of file
+}
@@ -40,6 +40,7 @@ class URHO3D_API ShapeOp_Solve : public IoComponentBase {
 	URHO3D_OBJECT(ShapeOp_Solve, IoComponentBase)
 public:
 	ShapeOp_Solve(Urho3D::Context* context);
+	~ShapeOp_Solve();
 
 	void SolveInstance(
 		const Urho3D::Vector<Urho3D::Variant>& inSolveInstance,
@@ -59,5 +60,7 @@ public:
 	int m_nb_points = -1;
 	std::vector<MeshTrackingData> m_tracked_meshes;
 	Urho3D::Vector<int> m_new_indices;
+	std::vector<int> m_constraint_ids;
+	std::vector<double> m_signature;
 
 };
\ No newline at end of file
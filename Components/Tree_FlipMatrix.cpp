@@ -57,7 +57,7 @@ int Tree_FlipMatrix::LocalSolve()
 	assert(outputSlots_.Size() == 1);
 
 	if (inputSlots_[0]->HasNoData()) {
-		solvedFlag_ = 0;
+		MarkUnsolved();
 		return 0;
 	}
 
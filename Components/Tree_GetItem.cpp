@@ -74,7 +74,7 @@ IoComponentBase(context, 3, 1)
 int Tree_GetItem::LocalSolve()
 {
     if (inputSlots_[0]->HasNoData()) {
-        solvedFlag_ = 0;
+        MarkUnsolved();
         return 0;
     }
 
@@ -100,7 +100,8 @@ int Tree_GetItem::LocalSolve()
         VariantType entry_type = cur_input_branch.GetType();
         if (entry_type != VAR_INT){
             URHO3D_LOGWARNING("branch ID must be an int");
-            return solvedFlag_ = 0;
+            MarkUnsolved();
+            return 0;
         }
         // get the branch ID, and convert to path format
         int branch = cur_input_branch.GetInt();
@@ -119,7 +120,8 @@ int Tree_GetItem::LocalSolve()
         VariantType item_type = index_var.GetType();
         if (item_type != VAR_INT){
             URHO3D_LOGWARNING("item ID must be an int");
-            return solvedFlag_ = 0;
+            MarkUnsolved();
+            return 0;
         }
         
         // get the item ID, note this defaults to -1 to get whole branch
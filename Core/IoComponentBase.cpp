@@ -26,10 +26,12 @@
 #include <iostream>
 #include <vector>
 
+#include <Urho3D/Core/Thread.h>
 #include <Urho3D/Core/Variant.h>
 
 #include "IndexUtilities.h"
 #include "IoDataTree.h"
+#include "IoGraph.h"
 #include "IoInputSlot.h"
 #include "IoOutputSlot.h"
 #include "NetworkUtilities.h"
@@ -147,7 +149,7 @@ void IoComponentBase::InputHardSet(int inputIndex, IoDataTree ioDataTree)
 
 	inputSlots_[inputIndex]->HardSet(ioDataTree);
 
-	solvedFlag_ = 0;
+	MarkUnsolved();
 }
 
 ///////////////
@@ -321,13 +323,16 @@ int IoComponentBase::LocalSolve()
 		}
 	}
 
+	int ret;
 	if (tree_access_required) {
 		URHO3D_LOGWARNING("IoComponentBase::LocalSolve --- TREE access is alpha!");
-		int ret = NewLocalSolve();
-		return ret;
+		ret = NewLocalSolve();
+	}
+	else {
+		ret = OldLocalSolve();
 	}
 
-	int ret = OldLocalSolve();
+	PostLocalSolve();
 	return ret;
 }
 
@@ -338,7 +343,7 @@ int IoComponentBase::NewLocalSolve()
 		if (inputSlots_[i]->HasNoData()) {
 
 			ClearOutputs();
-			solvedFlag_ = 0;
+			MarkUnsolved();
 			return 0;
 		}
 	}
@@ -441,6 +446,8 @@ int IoComponentBase::NewLocalSolve()
 				inSolveInstance.Push(arg);
 			}
 			Vector<Variant> outSolveInstance(outputSlots_.Size());
+			solvePath_ = outputPath;
+			solveIndex_ = j;
 			SolveInstance(inSolveInstance, outSolveInstance);
 
 			for (unsigned k = 0; k < outputSlots_.Size(); ++k) {
@@ -494,7 +501,7 @@ int IoComponentBase::OldLocalSolve()
 			// shot in dark, C.C. 7/12/2016
 			ClearOutputs();
 
-			solvedFlag_ = 0;
+			MarkUnsolved();
 			return 0;
 		}
 	}
@@ -563,6 +570,8 @@ int IoComponentBase::OldLocalSolve()
 				inSolveInstance.Push(arg);
 			}
 			Vector<Variant> outSolveInstance(outputSlots_.Size());
+			solvePath_ = outputPath;
+			solveIndex_ = j;
 			SolveInstance(inSolveInstance, outSolveInstance);
 
 			for (unsigned k = 0; k < outputSlots_.Size(); ++k) {
@@ -612,9 +621,42 @@ void IoComponentBase::ClearOutputs()
 
 	VariantMap data;
 	data["component"] = this;
-	SendEvent("OutputsCleared", data);
+	SendSolveEvent("OutputsCleared", data);
+
+	MarkUnsolved();
+}
 
+void IoComponentBase::MarkUnsolved()
+{
 	solvedFlag_ = 0;
+
+	// workers of the parallel solver leave the dirty set to IoGraph, which fills it in at the level barrier
+	if (graph_ && Thread::IsMainThread()) {
+		graph_->MarkDirty(this);
+	}
+}
+
+// Urho3D only dispatches events on the main thread, so anything sent while a worker is solving
+// this component is queued and replayed by IoGraph once the worker has finished.
+void IoComponentBase::SendSolveEvent(StringHash eventType, VariantMap& eventData)
+{
+	if (Thread::IsMainThread()) {
+		SendEvent(eventType, eventData);
+	}
+	else {
+		deferredEvents_.Push(MakePair(eventType, eventData));
+	}
+}
+
+void IoComponentBase::FlushDeferredEvents()
+{
+	// swap out first, handlers are free to trigger new solves
+	Vector<Pair<StringHash, VariantMap> > events;
+	events.Swap(deferredEvents_);
+
+	for (unsigned i = 0; i < events.Size(); ++i) {
+		SendEvent(events[i].first_, events[i].second_);
+	}
 }
 
 void IoComponentBase::AddInputSlot()
@@ -622,7 +664,7 @@ void IoComponentBase::AddInputSlot()
 	Urho3D::SharedPtr<IoInputSlot> xslotPtr(new IoInputSlot(GetContext(), Urho3D::SharedPtr<IoComponentBase>(this)));
 	inputSlots_.Push(xslotPtr);
 
-	solvedFlag_ = 0;
+	MarkUnsolved();
 }
 
 void IoComponentBase::AddOutputSlot()
@@ -630,7 +672,7 @@ void IoComponentBase::AddOutputSlot()
 	Urho3D::SharedPtr<IoOutputSlot> slotPtr(new IoOutputSlot(GetContext(), Urho3D::SharedPtr<IoComponentBase>(this)));
 	outputSlots_.Push(slotPtr);
 
-	solvedFlag_ = 0;
+	MarkUnsolved();
 }
 
 IoInputSlot*  IoComponentBase::AddInputSlot(
@@ -663,7 +705,7 @@ IoInputSlot*  IoComponentBase::AddInputSlot(
 
 	SendEvent("NewInputSlotAdded", data);
 
-	solvedFlag_ = 0;
+	MarkUnsolved();
 
 	return xslotPtr.Get();
 }
@@ -709,7 +751,7 @@ IoInputSlot*  IoComponentBase::AddInputSlot(
 
 	SendEvent("NewInputSlotAdded", data);
 
-	solvedFlag_ = 0;
+	MarkUnsolved();
 
 	return xslotPtr.Get();
 }
@@ -739,7 +781,7 @@ IoOutputSlot*  IoComponentBase::AddOutputSlot(
 	
 	SendEvent("NewOutputSlotAdded", data);
 
-	solvedFlag_ = 0;
+	MarkUnsolved();
 
 	return xslotPtr.Get();
 }
@@ -751,7 +793,7 @@ void IoComponentBase::DeleteInputSlot(int index)
 
 	::mDisconnect(inputSlots_[index]);
 	inputSlots_.Erase(index);
-	solvedFlag_ = 0;
+	MarkUnsolved();
 }
 
 void IoComponentBase::DeleteOutputSlot(int index)
@@ -762,7 +804,7 @@ void IoComponentBase::DeleteOutputSlot(int index)
 	::mDisconnect(outputSlots_[index]);
 
 	outputSlots_.Erase(index);
-	solvedFlag_ = 0;
+	MarkUnsolved();
 }
 
 int IoComponentBase::GetNumOutgoingLinks(int outputSlotIdx) const
@@ -960,7 +1002,8 @@ void IoComponentBase::SetAllOutputsNull(Urho3D::Vector<Urho3D::Variant>& outSolv
 		outSolveInstance[i] = Variant();
 	}
 
-	SendEvent("GraphNodeError");
+	VariantMap data;
+	SendSolveEvent("GraphNodeError", data);
 }
 
 bool IoComponentBase::SetGenericData(String key, Variant data)
@@ -39,6 +39,8 @@
 #include "IoInputSlot.h"
 #include "IoOutputSlot.h"
 
+class IoGraph;
+
 //////////////////
 // IoComponentBase
 
@@ -59,6 +61,7 @@ public:
 	friend class IoInputSlot;
 	friend class IoOutputSlot;
 	friend class IoSerialization;
+	friend class IoGraph;
 	friend class Editor_NodeView;
 
 public:
@@ -67,12 +70,19 @@ public:
 	virtual int LocalSolve();
 	virtual void ClearOutputs();
 	virtual void PreLocalSolve() {};
+	virtual void PostLocalSolve() {};
 	virtual void SolveInstance(
 		const Urho3D::Vector<Urho3D::Variant>& inSolveInstance,
 		Urho3D::Vector<Urho3D::Variant>& outSolveInstance
 	);
 	bool IsSolved() const { return solvedFlag_ == 1; }
 
+	// Clears the solved flag and, on the main thread, queues this component in its graph's dirty set,
+	// which seeds the next QuickTopoSolveGraph. Use it instead of writing solvedFlag_ = 0 directly.
+	void MarkUnsolved();
+
+	IoGraph* GetGraph() const { return graph_; }
+
 	void InputHardSet(int inputIndex, IoDataTree ioDataTree);
 
 	IoDataTree GetOutputIoDataTree(unsigned index);
@@ -162,10 +172,26 @@ public:
 	bool IsPreviewEnabled() const { return previewEnabled_ == 1; }
 
 	// Flags for topological ordering-based solve methods
-	void EnableSolve() { solveEnabled_ = 1; solvedFlag_ = 0; }
-	void DisableSolve() { solveEnabled_ = 0; solvedFlag_ = 0; }
+	void EnableSolve() { solveEnabled_ = 1; MarkUnsolved(); }
+	void DisableSolve() { solveEnabled_ = 0; MarkUnsolved(); }
 	bool IsSolveEnabled() const { return solveEnabled_ == 1; }
 
+	// Flag for the parallel solver: only components returning true are solved on worker threads.
+	// Opt in only if SolveInstance touches nothing but its own members and its inputs (no scene, UI, script engine, files or globals).
+	virtual bool IsThreadSafe() const { return false; }
+
+	// Flag for the progressive solve: components whose solve changes what is on screen (scene, UI) return true
+	// and are solved, with everything upstream of them, before the rest of the graph.
+	virtual bool IsVisibleOutput() const { return false; }
+
+	// Called by IoSerialization for each input slot whose data access in a saved graph differs from the current one.
+	// Components that changed the access of a slot override this to keep old graphs solving the way they were saved.
+	virtual void LoadInputAccess(unsigned inputIndex, DataAccess savedAccess) {}
+
+	// Events raised during LocalSolve on a worker thread are held here and sent by the graph afterwards.
+	void SendSolveEvent(Urho3D::StringHash eventType, Urho3D::VariantMap& eventData);
+	void FlushDeferredEvents();
+
 	//base functions for handling custom ui
 	virtual Urho3D::String GetNodeStyle();
 	virtual void HandleCustomInterface(Urho3D::UIElement* customElement);
@@ -225,6 +251,19 @@ protected: // protected so derived objects can access
 	// 1: Flags this component as OK to solve.
 	int solveEnabled_ = 1;
 
+	// graph this component has been added to, set and cleared by IoGraph
+	IoGraph* graph_ = 0;
+	// true while this component is listed in graph_'s dirty set
+	bool dirtyQueued_ = false;
+
+	// output branch path and index in it of the SolveInstance call in progress,
+	// identifies the item being solved across solves (e.g. to key cached previews)
+	Urho3D::Vector<int> solvePath_;
+	unsigned solveIndex_ = 0;
+
+	// events queued by SendSolveEvent while solving off the main thread
+	Urho3D::Vector<Urho3D::Pair<Urho3D::StringHash, Urho3D::VariantMap> > deferredEvents_;
+
 	/* later metadata */
 	Urho3D::String name_ = "";
 	Urho3D::String fullName_ = "";
@@ -25,7 +25,10 @@
 #include <Urho3D/Core/StringUtils.h>
 #include <Urho3D/IO/Log.h>
 
+#include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <vector>
 
 #include <assert.h>
 
@@ -47,53 +50,234 @@ IoDataTree::IoDataTree(Context* context, Urho3D::Vector<Urho3D::Variant> items)
 	Add(path, items);
 }
 
-IoDataTree::~IoDataTree()
+IoPath::IoPath(const Vector<int>& path) :
+	size_(path.Size()),
+	hash_(path.Size())
 {
-	HashMap<String, IoBranch*>::ConstIterator it;
-	for (it = branches_.Begin(); it != branches_.End(); ++it) {
-		delete it->second_;
+	int* dest = inline_;
+	if (size_ > MAX_INLINE) {
+		overflow_.Resize(size_);
+		dest = &overflow_[0];
+	}
+
+	for (unsigned i = 0; i < size_; ++i) {
+		dest[i] = path[i];
+		hash_ = hash_ * 31 + (unsigned)path[i];
 	}
 }
 
-IoDataTree::IoDataTree(const IoDataTree& original) : IoDataTree(original.GetContext())
+bool IoPath::operator==(const IoPath& rhs) const
+{
+	if (hash_ != rhs.hash_ || size_ != rhs.size_) {
+		return false;
+	}
+
+	const int* lhsData = Data();
+	const int* rhsData = rhs.Data();
+	for (unsigned i = 0; i < size_; ++i) {
+		if (lhsData[i] != rhsData[i]) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool IoPath::operator<(const IoPath& rhs) const
 {
-	HashMap<String, IoBranch*>::ConstIterator it;
-	for (it = original.branches_.Begin(); it != original.branches_.End(); ++it) {
-		String pathString = it->first_;
-		Vector<int> path = PathFromUniqueString(pathString);
+	const int* lhsData = Data();
+	const int* rhsData = rhs.Data();
+	unsigned common = Min(size_, rhs.size_);
+	for (unsigned i = 0; i < common; ++i) {
+		if (lhsData[i] != rhsData[i]) {
+			return lhsData[i] < rhsData[i];
+		}
+	}
 
-		Vector<Variant> data = it->second_->data;
+	return size_ < rhs.size_;
+}
 
-		branches_[pathString] = new IoBranch(path);
-		branches_[pathString]->data = data;
+IoBranchStore::IoBranchStore(const IoBranchStore& rhs) :
+	sortedCount_(0),
+	sorted_(true)
+{
+	rhs.Sort();
+
+	keys = rhs.keys;
+	branches.Resize(rhs.branches.Size());
+	for (unsigned i = 0; i < rhs.branches.Size(); ++i) {
+		branches[i] = new IoBranch(*rhs.branches[i]);
 	}
+	sortedCount_ = keys.Size();
 }
 
-IoDataTree& IoDataTree::operator=(const IoDataTree& rhs)
+IoBranchStore::~IoBranchStore()
 {
-	if (this != &rhs) {
-		HashMap<String, IoBranch*>::ConstIterator it;
-		for (it = branches_.Begin(); it != branches_.End(); ++it) {
-			delete it->second_;
+	for (unsigned i = 0; i < branches.Size(); ++i) {
+		delete branches[i];
+	}
+}
+
+void IoBranchStore::Sort() const
+{
+	if (sorted_.load(std::memory_order_acquire)) {
+		return;
+	}
+
+	MutexLock lock(sortMutex_);
+	if (sorted_.load(std::memory_order_relaxed)) {
+		return;
+	}
+
+	// sort the appended tail on its own, then merge it with the ordered head: O(n + t log t) for t pending inserts
+	unsigned n = keys.Size();
+	std::vector<unsigned> order(n);
+	for (unsigned i = 0; i < n; ++i) {
+		order[i] = i;
+	}
+
+	auto keyLess = [this](unsigned a, unsigned b) { return keys[a] < keys[b]; };
+	std::sort(order.begin() + sortedCount_, order.end(), keyLess);
+	std::inplace_merge(order.begin(), order.begin() + sortedCount_, order.end(), keyLess);
+
+	Vector<IoPath> sortedKeys(n);
+	PODVector<IoBranch*> sortedBranches(n);
+	for (unsigned i = 0; i < n; ++i) {
+		sortedKeys[i] = keys[order[i]];
+		sortedBranches[i] = branches[order[i]];
+	}
+
+	// the order is not part of the store's logical state, readers only ever see it sorted
+	IoBranchStore* self = const_cast<IoBranchStore*>(this);
+	self->keys.Swap(sortedKeys);
+	self->branches.Swap(sortedBranches);
+
+	sortedCount_ = n;
+	index_.Clear();
+	sorted_.store(true, std::memory_order_release);
+}
+
+unsigned IoBranchStore::LowerBound(const IoPath& key) const
+{
+	Sort();
+
+	// trees are mostly built in ascending order, so check for an append first
+	if (keys.Empty() || keys.Back() < key) {
+		return keys.Size();
+	}
+
+	unsigned first = 0;
+	unsigned count = keys.Size();
+	while (count > 0) {
+		unsigned step = count / 2;
+		if (keys[first + step] < key) {
+			first += step + 1;
+			count -= step + 1;
+		}
+		else {
+			count = step;
+		}
+	}
+
+	return first;
+}
+
+IoBranch* IoBranchStore::Find(const IoPath& key) const
+{
+	// while inserts are pending every key is in the hash index, no need to sort yet
+	if (sortedCount_ < keys.Size()) {
+		HashMap<IoPath, IoBranch*>::Iterator it = index_.Find(key);
+		return it != index_.End() ? it->second_ : NULL;
+	}
+
+	unsigned index = LowerBound(key);
+	if (index < keys.Size() && keys[index] == key) {
+		return branches[index];
+	}
+
+	return NULL;
+}
+
+void IoBranchStore::Insert(const IoPath& key, IoBranch* branch)
+{
+	// appending in order keeps the store sorted
+	if (sortedCount_ == keys.Size() && (keys.Empty() || keys.Back() < key)) {
+		keys.Push(key);
+		branches.Push(branch);
+		++sortedCount_;
+		return;
+	}
+
+	// out of order: append now and merge on the next ordered read,
+	// inserting in place would move the whole tail and make arbitrary order builds O(n^2)
+	if (sortedCount_ == keys.Size()) {
+		for (unsigned i = 0; i < keys.Size(); ++i) {
+			index_[keys[i]] = branches[i];
 		}
+	}
+
+	keys.Push(key);
+	branches.Push(branch);
+	index_[key] = branch;
+	sorted_.store(false, std::memory_order_relaxed);
+}
+
+IoBranch* IoBranchStore::Detach(unsigned index)
+{
+	Sort();
+
+	IoBranch* branch = branches[index];
+	keys.Erase(index);
+	branches.Erase(index);
+	return branch;
+}
+
+IoDataTree::~IoDataTree()
+{
+}
+
+// copies share the branch storage, it is only duplicated once one of the trees is modified
+IoDataTree::IoDataTree(const IoDataTree& original) : IoDataTree(original.GetContext())
+{
+	store_ = original.store_;
+}
 
-		branches_.Clear();
+IoDataTree& IoDataTree::operator=(const IoDataTree& rhs)
+{
+	if (this != &rhs) {
+		store_ = rhs.store_;
+		branchIndex_ = 0;
 		lastItemIndex_ = 0; // ?
 		branchOverflow_ = false;
 		itemOverflow_ = false;
+	}
+	return *this;
+}
 
-		HashMap<String, IoBranch*>::ConstIterator rhsIt;
-		for (rhsIt = rhs.branches_.Begin(); rhsIt != rhs.branches_.End(); ++rhsIt) {
-			String pathString = rhsIt->first_;
-			Vector<int> path = PathFromUniqueString(pathString);
+const IoBranchStore& IoDataTree::Branches() const
+{
+	static const IoBranchStore emptyBranches;
+	if (!store_) {
+		return emptyBranches;
+	}
 
-			Vector<Variant> data = rhsIt->second_->data;
+	store_->Sort();
+	return *store_;
+}
 
-			branches_[pathString] = new IoBranch(path);
-			branches_[pathString]->data = data;
-		}
+IoBranchStore& IoDataTree::MutableBranches()
+{
+	if (store_ && store_.use_count() == 1) {
+		// use_count is a relaxed read; the fence pairs with the release in the reference drop of a copy
+		// released on another thread, so its last reads of the store happen before our writes
+		std::atomic_thread_fence(std::memory_order_acquire);
+		return *store_;
 	}
-	return *this;
+
+	// storage is shared with other trees (or not allocated yet), take a private copy before writing
+	// the copy keeps the branch order, so branchIndex_ stays valid
+	store_ = store_ ? std::make_shared<IoBranchStore>(*store_) : std::make_shared<IoBranchStore>();
+	return *store_;
 }
 
 String IoDataTree::PathToUniqueString(Vector<int> path) const
@@ -123,32 +307,26 @@ Vector<int> IoDataTree::PathFromUniqueString(String pathString) const
 void IoDataTree::Add(Vector<int> path, Variant item)
 {
 	//check that this path exists
-	String pathString = PathToUniqueString(path);
-	IoBranch* branchId = branches_[pathString];
-	if (branchId == NULL)
+	IoPath key(path);
+	IoBranchStore& branches = MutableBranches();
+	IoBranch* branch = branches.Find(key);
+	if (branch == NULL)
 	{
-		//branch doesn't exist, so create it and add it to the map
-		IoBranch* newBranch = new IoBranch(path);
-		branches_[pathString] = newBranch;
+		//branch doesn't exist, so create it and add it to the index
+		branch = new IoBranch(path);
+		branches.Insert(key, branch);
 	}
 
 	//add the data
-	branches_[pathString]->data.Push(item);
+	branch->data.Push(item);
 	
-	//reset iterators
-	Begin();
+	//reset iterators, Begin would also read the current branch and so sort pending inserts on every Add
+	ResetIterators();
 }
 
 void IoDataTree::GetItem(Variant& item, Vector<int> path, int index) const
 {
-	String pathString = PathToUniqueString(path);
-	IoBranch** branchPtr = branches_[pathString];
-
-	IoBranch* branch = NULL;
-
-	if (branchPtr != NULL) {
-		branch = *branchPtr;
-	}
+	IoBranch* branch = Branches().Find(IoPath(path));
 
 	if (branch != NULL)
 	{
@@ -162,38 +340,31 @@ void IoDataTree::GetItem(Variant& item, Vector<int> path, int index) const
 void IoDataTree::Add(Vector<int> path, VariantVector list)
 {
 	//check that this path exists
-	String pathString = PathToUniqueString(path);
-	IoBranch* branchId = branches_[pathString];
-	if (branchId == NULL)
+	IoPath key(path);
+	IoBranchStore& branches = MutableBranches();
+	IoBranch* branch = branches.Find(key);
+	if (branch == NULL)
 	{
-		//branch doesn't exist, so create it and add it to the map
-		IoBranch* newBranch = new IoBranch(path);
-		branches_[pathString] = newBranch;
+		//branch doesn't exist, so create it and add it to the index
+		branch = new IoBranch(path);
+		branches.Insert(key, branch);
 	}
 
 	//add the data
 	for (unsigned i = 0; i < list.Size(); i++)
 	{
-		branches_[pathString]->data.Push(list[i]);
+		branch->data.Push(list[i]);
 	}
 
-	//reset iterators
-	Begin();
+	//reset iterators, Begin would also read the current branch and so sort pending inserts on every Add
+	ResetIterators();
 }
 
 unsigned IoDataTree::GetNumItemsAtBranch(Vector<int> path, DataAccess accessType) const
 {
-	/*
-	IoBranch** branchPtr = branches_[PathToUniqueString(path)];
-	IoBranch* branch = NULL;
-	if (branchPtr != NULL) {
-		branch = *branchPtr;
-	}
-	*/
-
 	if (accessType == DataAccess::ITEM) {
-		return (*(branches_[PathToUniqueString(path)]))->data.Size();
-		//return branch->data.Size();
+		IoBranch* branch = Branches().Find(IoPath(path));
+		return branch ? branch->data.Size() : 0;
 	}
 	else {
 		return 1; // change to 0 if LocalSolve is ready to handle this
@@ -210,10 +381,10 @@ unsigned IoDataTree::GetNumItemsAtBranch(Vector<int> path, DataAccess accessType
 // without crashing. Hopefully!
 void IoDataTree::LookupType(Variant& dataOut, DataAccess accessType) const
 {
-	HashMap<String, IoBranch*>::ConstIterator it;
-	for (it = branches_.Begin(); it != branches_.End(); ++it) {
-		if (it->second_) {
-			IoBranch* currentBranch = it->second_;
+	const IoBranchStore& branches = Branches();
+	for (unsigned i = 0; i < branches.Size(); ++i) {
+		if (branches.branches[i]) {
+			IoBranch* currentBranch = branches.branches[i];
 			if (currentBranch == NULL) {
 				dataOut = Variant();
 				return;
@@ -234,7 +405,8 @@ void IoDataTree::LookupType(Variant& dataOut, DataAccess accessType) const
 
 void IoDataTree::GetNextItem(Variant& dataOut, DataAccess accessType)
 {
-	IoBranch* currentBranch = branchIterator_->second_;
+	const IoBranchStore& branches = Branches();
+	IoBranch* currentBranch = branchIndex_ < branches.Size() ? branches.branches[branchIndex_] : NULL;
 	if(currentBranch == NULL)
 	{
 		return;
@@ -280,24 +452,25 @@ String IoDataTree::ToString(bool truncate) const
 	}
 	*/
 
-	HashMap<String, IoBranch*>::ConstIterator itr = branches_.Begin();
+	const IoBranchStore& branches = Branches();
 	String out;
 	int branchCounter = 0;
-	for (; itr != branches_.End(); itr++)
+	for (unsigned b = 0; b < branches.Size(); b++)
 	{
 		if (truncate && branchCounter > 5)
 			return out;
 
-		String path = itr->first_;
-		String itemCount = String(itr->second_->data.Size());
+		IoBranch* branch = branches.branches[b];
+		String path = PathToUniqueString(branch->address);
+		String itemCount = String(branch->data.Size());
 		out += "Branch: " + path + ", N = " + itemCount + "\n";
-		int numItems = itr->second_->data.Size();
+		int numItems = branch->data.Size();
 		if (truncate)
 			numItems = Min(numItems, 3);
 
 		for(int i = 0; i < numItems; i++)
 		{
-			Variant var = itr->second_->data[i];
+			Variant var = branch->data[i];
             String type = var.GetTypeName();
             if (var.GetType() == VAR_VARIANTMAP){
                 VariantMap var_map = var.GetVariantMap();
@@ -308,7 +481,7 @@ String IoDataTree::ToString(bool truncate) const
 			out += "    " + var.ToString() + ", type: " + type + "\n";
 		}
 
-		if (truncate && itr->second_->data.Size() > 3)
+		if (truncate && branch->data.Size() > 3)
 		{
 			out += "....and so on\n";
 		}
@@ -321,13 +494,13 @@ String IoDataTree::ToString(bool truncate) const
 
 Urho3D::VariantMap IoDataTree::ToVariantMap() const
 {
-	HashMap<String, IoBranch*>::ConstIterator itr = branches_.Begin();
+	const IoBranchStore& branches = Branches();
 	VariantMap vm;
 
-	for (; itr != branches_.End(); itr++) {
+	for (unsigned b = 0; b < branches.Size(); b++) {
 
-		String path = itr->first_;
-		VariantVector data = itr->second_->data;
+		String path = PathToUniqueString(branches.branches[b]->address);
+		VariantVector data = branches.branches[b]->data;
 		vm[path.CString()] = Variant(data);
 	}
 
@@ -336,18 +509,17 @@ Urho3D::VariantMap IoDataTree::ToVariantMap() const
 
 Urho3D::Vector<Urho3D::String> IoDataTree::GetContent()
 {
-	HashMap<String, IoBranch*>::ConstIterator itr = branches_.Begin();
+	const IoBranchStore& branches = Branches();
 	Vector<String> contents;
 	int branchCounter = 0;
-	for (; itr != branches_.End(); itr++)
+	for (unsigned b = 0; b < branches.Size(); b++)
 	{		
-		String path = itr->first_;
-		String itemCount = String(itr->second_->data.Size());
-		int numItems = itr->second_->data.Size();
+		IoBranch* branch = branches.branches[b];
+		int numItems = branch->data.Size();
 
 		for (int i = 0; i < numItems; i++)
 		{
-			Variant var = itr->second_->data[i];
+			Variant var = branch->data[i];
 			if (var.GetType() == VAR_NONE)
 			{
 
@@ -367,16 +539,18 @@ Urho3D::Vector<Urho3D::String> IoDataTree::GetContent()
 }
 
 // Returns a list of the immediate descendant branches growing out of the path stored in path.
-// These are branches that are already present in the tree.
+// These are branches that are already present in the tree, in ascending order.
 Vector<Vector<int> > IoDataTree::FindChildPaths(Vector<int> path) const
 {
 	Vector<Vector<int> > childPaths;
 
-	HashMap<String, IoBranch*>::ConstIterator it;
-
-	for (it = branches_.Begin(); it != branches_.End(); ++it) {
-		String curPathString = it->first_;
-		Vector<int> curPath = PathFromUniqueString(curPathString);
+	// descendants sort directly after their ancestor, so only that run needs to be visited
+	const IoBranchStore& branches = Branches();
+	for (unsigned i = branches.LowerBound(IoPath(path)); i < branches.Size(); ++i) {
+		const Vector<int>& curPath = branches.branches[i]->address;
+		if (!EqualPaths(path, curPath) && !Descendant(path, curPath)) {
+			break;
+		}
 
 		if (IsParentChildPathPair(path, curPath)) {
 			childPaths.Push(curPath);
@@ -398,8 +572,7 @@ Vector<int> IoDataTree::GetNextNewBranchPath(Vector<int> path) const
 		return copyPath;
 	}
 
-	//Sort(childPaths.Begin(), childPaths.End(), ComparePaths);
-	Sort(childPaths.Begin(), childPaths.End(), ComparePaths);
+	// childPaths is already sorted
 	Vector<int> lastBranchFullPath = childPaths[childPaths.Size() - 1];
 	int lastBranchLastInt = lastBranchFullPath[lastBranchFullPath.Size() - 1];
 	copyPath.Push(lastBranchLastInt + 1);
@@ -408,11 +581,10 @@ Vector<int> IoDataTree::GetNextNewBranchPath(Vector<int> path) const
 
 bool IoDataTree::HasSiblings(Vector<int> path) const
 {
-	HashMap<String, IoBranch*>::ConstIterator it;
+	const IoBranchStore& branches = Branches();
 
-	for (it = branches_.Begin(); it != branches_.End(); ++it) {
-		String curPathString = it->first_;
-		Vector<int> curPath = PathFromUniqueString(curPathString);
+	for (unsigned i = 0; i < branches.Size(); ++i) {
+		const Vector<int>& curPath = branches.branches[i]->address;
 
 		if (WitnessSiblings(path, curPath)) {
 			// curPath witnesses existence of a sibling for path
@@ -428,7 +600,7 @@ bool IoDataTree::CanBeDeleted(Vector<int> path) const
 {
 	bool hasData = false;
 
-	IoBranch* branchId = *branches_[PathToUniqueString(path)];
+	IoBranch* branchId = Branches().Find(IoPath(path));
 	if (branchId != NULL && branchId->data.Size() > 0) {
 		hasData = true;
 	}
@@ -459,12 +631,12 @@ bool IoDataTree::Descendant(Vector<int> ancestor, Vector<int> descendant) const
 
 IoDataTree IoDataTree::Flatten() const
 {
-	HashMap<String, IoBranch*>::ConstIterator it;
+	const IoBranchStore& branches = Branches();
 
 	Vector<Variant> allVariants;
 
-	for (it = branches_.Begin(); it != branches_.End(); ++it) {
-		allVariants.Push(it->second_->data);
+	for (unsigned b = 0; b < branches.Size(); ++b) {
+		allVariants.Push(branches.branches[b]->data);
 	}
 
 	Vector<int> path;
@@ -478,15 +650,14 @@ IoDataTree IoDataTree::Flatten() const
 
 IoDataTree IoDataTree::Graft() const
 {
-	HashMap<String, IoBranch*>::ConstIterator it;
+	const IoBranchStore& branches = Branches();
 
 	IoDataTree graftedTree(GetContext());
 
-	for (it = branches_.Begin(); it != branches_.End(); ++it) {
-		Vector<Variant> vlist = it->second_->data;
+	for (unsigned b = 0; b < branches.Size(); ++b) {
+		const Vector<Variant>& vlist = branches.branches[b]->data;
 		unsigned numItems = vlist.Size();
-		String curPathString = it->first_;
-		Vector<int> curPath = PathFromUniqueString(curPathString);
+		const Vector<int>& curPath = branches.branches[b]->address;
 		if (numItems > 1) {
 			Vector<int> nextBranch = GetNextNewBranchPath(curPath);
 			for (unsigned i = 0; i < numItems; ++i) {
@@ -504,12 +675,17 @@ IoDataTree IoDataTree::Graft() const
 
 IoDataTree IoDataTree::FlipMatrix() const
 {
-	HashMap<String, IoBranch*>::ConstIterator it;
+	const IoBranchStore& branches = Branches();
 	IoDataTree flippedTree(GetContext());
-	int numElements = branches_.Begin()->second_->data.Size();
-	for (it = branches_.Begin(); it != branches_.End(); ++it)
+	if (branches.Size() == 0)
+	{
+		return flippedTree;
+	}
+
+	int numElements = branches.branches[0]->data.Size();
+	for (unsigned b = 0; b < branches.Size(); ++b)
 	{
-		if (it->second_->data.Size() != numElements)
+		if (branches.branches[b]->data.Size() != numElements)
 		{
 			return flippedTree;
 		}
@@ -522,9 +698,9 @@ IoDataTree IoDataTree::FlipMatrix() const
 	for (int i = 0; i < numElements; i++)
 	{
 		path[1] = i;
-		for (it = branches_.Begin(); it != branches_.End(); ++it)
+		for (unsigned b = 0; b < branches.Size(); ++b)
 		{
-			flippedTree.Add(path, it->second_->data[i]);
+			flippedTree.Add(path, branches.branches[b]->data[i]);
 		}
 	}
 
@@ -534,60 +710,71 @@ IoDataTree IoDataTree::FlipMatrix() const
 void IoDataTree::FillInMissingPaths(Vector<int> path)
 {
 	Vector<int> copyPath = path;
+	IoBranchStore& branches = MutableBranches();
 
 	for (unsigned i = path.Size() - 1; i > 0; --i) {
 		copyPath.Erase(i);
-		String copyPathString = PathToUniqueString(copyPath);
-		IoBranch* branch = branches_[copyPathString];
+		IoPath copyKey(copyPath);
+		IoBranch* branch = branches.Find(copyKey);
 		if (branch == NULL) {
 			IoBranch* newBranch = new IoBranch(copyPath);
-			branches_[copyPathString] = newBranch;
+			branches.Insert(copyKey, newBranch);
 		}
 	}
 }
 
 void IoDataTree::FillInAllMissingPaths()
 {
-	HashMap<String, IoBranch*>::ConstIterator it;
+	// collect the paths first, filling in inserts ancestors ahead of the current branch
+	const IoBranchStore& branches = Branches();
+	Vector<Vector<int> > paths(branches.Size());
+	for (unsigned i = 0; i < branches.Size(); ++i) {
+		paths[i] = branches.branches[i]->address;
+	}
 
-	for (it = branches_.Begin(); it != branches_.End(); ++it) {
-		String curPathString = it->first_;
-		Vector<int> curPath = PathFromUniqueString(curPathString);
-		FillInMissingPaths(curPath);
+	for (unsigned i = 0; i < paths.Size(); ++i) {
+		FillInMissingPaths(paths[i]);
 	}
 }
 
 void IoDataTree::ModifyPathInPlace(Vector<int> oldPath, Vector<int> newPath)
 {
-	String oldPathString = PathToUniqueString(oldPath);
-	IoBranch* oldBranchId = branches_[oldPathString];
+	IoBranchStore& branches = MutableBranches();
+
+	IoPath oldKey(oldPath);
+	unsigned oldIndex = branches.LowerBound(oldKey);
+	IoBranch* oldBranchId = (oldIndex < branches.Size() && branches.keys[oldIndex] == oldKey) ? branches.branches[oldIndex] : NULL;
 	if (oldBranchId == NULL) {
 		URHO3D_LOGERROR("ERROR: IoDataTree::ModifyPath --- path to modify does not exist");
 	}
 	assert(oldBranchId != NULL);
 
-	String newPathString = PathToUniqueString(newPath);
-	IoBranch* newBranchId = branches_[newPathString];
+	IoPath newKey(newPath);
+	IoBranch* newBranchId = branches.Find(newKey);
 	if (newBranchId != NULL) {
 		URHO3D_LOGERROR("ERROR: IoDataTree::ModifyPath --- new path already exists");
 	}
 	assert(newBranchId == NULL);
 
-	Vector<Variant> data = branches_[oldPathString]->data;
-	delete oldBranchId;
+	if (oldBranchId == NULL || newBranchId != NULL) {
+		return;
+	}
 
-	branches_.Erase(branches_.Find(oldPathString));
-	newBranchId = new IoBranch(newPath);
-	newBranchId->data = data;
+	// move the branch and its data to the new address
+	branches.Detach(oldIndex);
+	oldBranchId->address = newPath;
 
-	branches_[newPathString] = newBranchId;
+	branches.Insert(newKey, oldBranchId);
 }
 
 IoDataTree IoDataTree::DeleteZeroSiblingPath(Vector<int> zeroSiblingPath) const
 {
 	IoDataTree copyTree = *this;
 
-	IoBranch* thisBranch = copyTree.branches_[PathToUniqueString(zeroSiblingPath)];
+	IoBranchStore& copyBranches = copyTree.MutableBranches();
+	IoPath zeroSiblingKey(zeroSiblingPath);
+	unsigned thisIndex = copyBranches.LowerBound(zeroSiblingKey);
+	IoBranch* thisBranch = (thisIndex < copyBranches.Size() && copyBranches.keys[thisIndex] == zeroSiblingKey) ? copyBranches.branches[thisIndex] : NULL;
 	if (thisBranch != NULL) {
 		assert(thisBranch->data.Size() == 0);
 		// there is data at this branch, we cannot eliminate and should not be trying to
@@ -595,14 +782,14 @@ IoDataTree IoDataTree::DeleteZeroSiblingPath(Vector<int> zeroSiblingPath) const
 
 	unsigned zeroSiblingIndex = zeroSiblingPath.Size() - 1;
 
-	delete thisBranch;
-	copyTree.branches_.Erase(copyTree.branches_.Find(PathToUniqueString(zeroSiblingPath)));
+	if (thisBranch != NULL) {
+		delete copyBranches.Detach(thisIndex);
+	}
 
-	HashMap<String, IoBranch*>::ConstIterator it;
+	const IoBranchStore& branches = Branches();
 
-	for (it = branches_.Begin(); it != branches_.End(); ++it) {
-		String curPathString = it->first_;
-		Vector<int> curPath = PathFromUniqueString(curPathString);
+	for (unsigned i = 0; i < branches.Size(); ++i) {
+		const Vector<int>& curPath = branches.branches[i]->address;
 
 		if (Descendant(zeroSiblingPath, curPath)) {
 			assert(curPath[zeroSiblingIndex] == 0);
@@ -620,17 +807,14 @@ IoDataTree IoDataTree::Simplify() const
 	IoDataTree tmpTree = *this;
 	tmpTree.FillInAllMissingPaths();
 
-	HashMap<String, IoBranch*>::ConstIterator it;
-
 	bool done = false;
 
 	while (!done) {
 
 		done = true;
 
-		for (it = tmpTree.branches_.Begin(); it != tmpTree.branches_.End(); ++it) {
-			String curPathString = it->first_;
-			Vector<int> curPath = PathFromUniqueString(curPathString);
+		for (unsigned i = 0; i < tmpTree.Branches().Size(); ++i) {
+			Vector<int> curPath = tmpTree.Branches().branches[i]->address;
 			if (tmpTree.CanBeDeleted(curPath)) {
 				// adjust curPath and all descendants accordingly
 				IoDataTree copyTmpTree = tmpTree.DeleteZeroSiblingPath(curPath);
@@ -656,14 +840,13 @@ IoDataTree IoDataTree::OneToManyGraft() const
 {
 	IoDataTree graftedTree(GetContext());
 
-	HashMap<String, IoBranch*>::ConstIterator it;
+	const IoBranchStore& branches = Branches();
 
-	for (it = branches_.Begin(); it != branches_.End(); ++it) {
+	for (unsigned b = 0; b < branches.Size(); ++b) {
 
 		// setup "curPath" and the "data" stored there
-		String curPathString = it->first_;
-		Vector<int> curPath = PathFromUniqueString(curPathString);
-		Vector<Variant> data = it->second_->data;
+		const Vector<int>& curPath = branches.branches[b]->address;
+		const Vector<Variant>& data = branches.branches[b]->data;
 
 		if (data.Size() > 1) {
 			Vector<int> basePath = GetNextNewBranchPath(curPath);
@@ -727,24 +910,29 @@ bool IoDataTree::IsParentChildPathPair(Vector<int> parentCandidate, Vector<int>
 
 Vector<int> IoDataTree::Begin()
 {
-	branchIterator_ = branches_.Begin();
+	ResetIterators();
+	return GetCurrentBranch();
+}
+
+void IoDataTree::ResetIterators()
+{
+	branchIndex_ = 0;
 	lastItemIndex_ = 0;
 	branchOverflow_ = false;
 	itemOverflow_ = false;
-	return PathFromUniqueString(branchIterator_->first_);
 }
 
 Vector<int> IoDataTree::GetNextBranch()
 {
 	Vector<int> pathOut;
-	if (++branchIterator_ == branches_.End())
+	if (++branchIndex_ >= Branches().Size())
 	{
 		branchOverflow_ = true;
-		--branchIterator_;
+		--branchIndex_;
 	}
 	lastItemIndex_ = 0;
 	itemOverflow_ = false;
-	pathOut = PathFromUniqueString(branchIterator_->first_);
+	pathOut = GetCurrentBranch();
 
 
 	return pathOut;
@@ -752,7 +940,8 @@ Vector<int> IoDataTree::GetNextBranch()
 
 Vector<int> IoDataTree::GetCurrentBranch() const
 {
-	return PathFromUniqueString(branchIterator_->first_);
+	const IoBranchStore& branches = Branches();
+	return branchIndex_ < branches.Size() ? branches.branches[branchIndex_]->address : Vector<int>();
 }
 
 Vector<int> IoDataTree::IncrementBranchPath(Vector<int> path, int incSize) const
@@ -865,7 +1054,7 @@ bool ComparePaths(const Vector<int>& lhs, const Vector<int>& rhs)
 			Vector<int> rhsCopy = rhs;
 			lhsCopy.Erase(0);
 			rhsCopy.Erase(0);
-			flag = ComparePaths(lhs, rhs);
+			flag = ComparePaths(lhsCopy, rhsCopy);
 		}
 	}
 	return flag;
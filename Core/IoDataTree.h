@@ -22,10 +22,15 @@
 
 #pragma once
 
+#include <Urho3D/Container/HashMap.h>
 #include <Urho3D/Container/Vector.h>
+#include <Urho3D/Core/Mutex.h>
 #include <Urho3D/Core/Object.h>
 #include <Urho3D/Core/Variant.h>
 
+#include <atomic>
+#include <memory>
+
 ///determines the stride with which to iterate over the tree
 enum DataAccess
 {
@@ -48,16 +53,78 @@ public:
 	}
 };
 
+///packed branch address used to key the branch index, short paths are stored inline
+class IoPath
+{
+public:
+	IoPath() : size_(0), hash_(0) {}
+	explicit IoPath(const Urho3D::Vector<int>& path);
+
+	unsigned Size() const { return size_; }
+	const int* Data() const { return size_ <= MAX_INLINE ? inline_ : &overflow_[0]; }
+	int operator[](unsigned index) const { return Data()[index]; }
+	unsigned ToHash() const { return hash_; }
+
+	bool operator==(const IoPath& rhs) const;
+	bool operator!=(const IoPath& rhs) const { return !(*this == rhs); }
+	//lexicographic order, a path sorts before its descendants
+	bool operator<(const IoPath& rhs) const;
+
+private:
+	static const unsigned MAX_INLINE = 8;
+
+	int inline_[MAX_INLINE];
+	Urho3D::PODVector<int> overflow_;
+	unsigned size_;
+	unsigned hash_;
+};
+
+///owns the branches of one or more trees, copies of a tree share it until one of them is modified
+///branches are kept sorted by address, so iteration order does not depend on insertion order
+///out of order inserts are appended and looked up through a hash index, Sort merges them in before the next ordered read
+class IoBranchStore
+{
+public:
+	//keys[i] is the packed address of branches[i], ordered by address once Sort has run
+	Urho3D::Vector<IoPath> keys;
+	Urho3D::PODVector<IoBranch*> branches;
+
+public:
+	IoBranchStore() : sortedCount_(0), sorted_(true) {}
+	IoBranchStore(const IoBranchStore& rhs);
+	~IoBranchStore();
+
+	unsigned Size() const { return branches.Size(); }
+	//merges pending out of order inserts into place; safe to call from several threads reading a shared store
+	void Sort() const;
+	//index of the first branch whose address is not less than key
+	unsigned LowerBound(const IoPath& key) const;
+	IoBranch* Find(const IoPath& key) const;
+	void Insert(const IoPath& key, IoBranch* branch);
+	//removes the branch at index from the index without deleting it
+	IoBranch* Detach(unsigned index);
+
+private:
+	//keys[0 .. sortedCount_) are in order, the rest were appended out of order and are all in index_
+	mutable unsigned sortedCount_;
+	mutable Urho3D::HashMap<IoPath, IoBranch*> index_;
+	mutable std::atomic<bool> sorted_;
+	mutable Urho3D::Mutex sortMutex_;
+};
+
 ///all slots receive and output a datatree
 class URHO3D_API IoDataTree : public Urho3D::Object
 {
 	URHO3D_OBJECT(IoDataTree, Urho3D::Object)
 private:
-	//the branches
-	Urho3D::HashMap<Urho3D::String, IoBranch*> branches_;
+	//the branches, shared between copies of this tree (copy-on-write)
+	//std::shared_ptr rather than SharedPtr since trees are copied from solve worker threads:
+	//copies of one tree may be created, read and released on different threads,
+	//but a single IoDataTree object must not be copied from on one thread while it is mutated on another
+	std::shared_ptr<IoBranchStore> store_;
 
 	//Not totally sure about this, but basically need custom iteration logic
-	Urho3D::HashMap<Urho3D::String, IoBranch*>::ConstIterator branchIterator_;
+	unsigned branchIndex_ = 0;
 	int lastItemIndex_ = 0;
 
 	//flags that track if iterator is in overflow mode
@@ -65,6 +132,10 @@ private:
 	bool branchOverflow_ = false;
 	bool itemOverflow_ = false;
 
+	//read access to the branches (sorted), and write access after detaching from any other tree sharing them
+	const IoBranchStore& Branches() const;
+	IoBranchStore& MutableBranches();
+
 	// use with caution
 	void FillInMissingPaths(Urho3D::Vector<int> path);
 	void FillInAllMissingPaths();
@@ -100,6 +171,8 @@ public:
 	void GetNextItem(Urho3D::Variant& data, DataAccess accessType);
 	Urho3D::Vector<int> GetNextBranch();
 	Urho3D::Vector<int> Begin();
+	//rewinds the iteration without reading the current branch
+	void ResetIterators();
 
 	// User-controlled tree operations
 	IoDataTree Graft() const;
@@ -116,13 +189,13 @@ public:
 	// Part of public interface: const operations with output depending on state
 	void GetItem(Urho3D::Variant& item, Urho3D::Vector<int> path, int index) const;
 	unsigned GetNumItemsAtBranch(Urho3D::Vector<int> path, DataAccess accessType) const;
-	int GetNumBranches() const { return branches_.Keys().Size(); };
+	int GetNumBranches() const { return Branches().Size(); };
 	Urho3D::Vector<int> GetCurrentBranch() const;
 	Urho3D::String ToString(bool truncate=false) const;
 	Urho3D::Vector<Urho3D::String> GetContent();
 	bool branchOverflow() const { return branchOverflow_; };
 	bool itemOverflow() const { return itemOverflow_; };
-	bool IsEmptyTree() const { return branches_.Size() == 0; }
+	bool IsEmptyTree() const { return Branches().Size() == 0; }
 private:
 	// const operations with output depending on state
 	Urho3D::Vector<Urho3D::Vector<int> > FindChildPaths(Urho3D::Vector<int> path) const;
@@ -0,0 +1,860 @@
+//
+// Copyright (c) 2016 - 2017 Mesh Consultants Inc.
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "IoExpression.h"
+
+#include <Urho3D/Container/HashMap.h>
+#include <Urho3D/Core/Mutex.h>
+#include <Urho3D/Math/MathDefs.h>
+#include <Urho3D/Math/Vector3.h>
+
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+using namespace Urho3D;
+
+namespace {
+
+	//number of items evaluated per pass over the code, keeps the register file in cache
+	const unsigned BLOCK_SIZE = 256;
+
+	//cached expressions are dropped wholesale once this many signatures have been seen
+	const unsigned MAX_CACHED_EXPRESSIONS = 256;
+
+	enum ExpressionOp
+	{
+		OP_CONST,
+		OP_ADD,
+		OP_SUB,
+		OP_MUL,
+		OP_DIV,
+		OP_MOD,
+		OP_NEG,
+		OP_SQRT,
+		OP_POW,
+		OP_ABS,
+		OP_SIGN,
+		OP_MIN,
+		OP_MAX,
+		OP_CLAMP,
+		OP_LERP,
+		OP_FLOOR,
+		OP_CEIL,
+		OP_ROUND,
+		OP_EXP,
+		OP_LN,
+		OP_SIN,
+		OP_COS,
+		OP_TAN,
+		OP_ASIN,
+		OP_ACOS,
+		OP_ATAN,
+		OP_ATAN2
+	};
+
+	struct FunctionDef
+	{
+		const char* name_;
+		ExpressionOp op_;
+		unsigned numArgs_;
+	};
+
+	//scalar script functions with a native equivalent; trigonometry works in degrees like the script API
+	const FunctionDef FUNCTIONS[] = {
+		{ "Sqrt", OP_SQRT, 1 },
+		{ "Pow", OP_POW, 2 },
+		{ "Abs", OP_ABS, 1 },
+		{ "Sign", OP_SIGN, 1 },
+		{ "Min", OP_MIN, 2 },
+		{ "Max", OP_MAX, 2 },
+		{ "Clamp", OP_CLAMP, 3 },
+		{ "Lerp", OP_LERP, 3 },
+		{ "Floor", OP_FLOOR, 1 },
+		{ "Ceil", OP_CEIL, 1 },
+		{ "Round", OP_ROUND, 1 },
+		{ "Exp", OP_EXP, 1 },
+		{ "Ln", OP_LN, 1 },
+		{ "Mod", OP_MOD, 2 },
+		{ "Sin", OP_SIN, 1 },
+		{ "Cos", OP_COS, 1 },
+		{ "Tan", OP_TAN, 1 },
+		{ "Asin", OP_ASIN, 1 },
+		{ "Acos", OP_ACOS, 1 },
+		{ "Atan", OP_ATAN, 1 },
+		{ "Atan2", OP_ATAN2, 2 }
+	};
+
+	unsigned GetNumOperands(unsigned op)
+	{
+		switch (op)
+		{
+		case OP_CONST:
+			return 0;
+		case OP_ADD:
+		case OP_SUB:
+		case OP_MUL:
+		case OP_DIV:
+		case OP_MOD:
+		case OP_POW:
+		case OP_MIN:
+		case OP_MAX:
+		case OP_ATAN2:
+			return 2;
+		case OP_CLAMP:
+		case OP_LERP:
+			return 3;
+		default:
+			return 1;
+		}
+	}
+
+	inline float SignOf(float a)
+	{
+		return a > 0.0f ? 1.0f : (a < 0.0f ? -1.0f : 0.0f);
+	}
+
+	inline float ClampTo(float a, float lo, float hi)
+	{
+		return a < lo ? lo : (a > hi ? hi : a);
+	}
+
+	//scalar reference implementation, used for constant folding
+	float EvaluateOp(unsigned op, float a, float b, float c)
+	{
+		switch (op)
+		{
+		case OP_ADD: return a + b;
+		case OP_SUB: return a - b;
+		case OP_MUL: return a * b;
+		case OP_DIV: return a / b;
+		case OP_MOD: return fmodf(a, b);
+		case OP_NEG: return -a;
+		case OP_SQRT: return sqrtf(a);
+		case OP_POW: return powf(a, b);
+		case OP_ABS: return fabsf(a);
+		case OP_SIGN: return SignOf(a);
+		case OP_MIN: return a < b ? a : b;
+		case OP_MAX: return a > b ? a : b;
+		case OP_CLAMP: return ClampTo(a, b, c);
+		case OP_LERP: return a + (b - a) * c;
+		case OP_FLOOR: return floorf(a);
+		case OP_CEIL: return ceilf(a);
+		case OP_ROUND: return floorf(a + 0.5f);
+		case OP_EXP: return expf(a);
+		case OP_LN: return logf(a);
+		case OP_SIN: return sinf(a * M_DEGTORAD);
+		case OP_COS: return cosf(a * M_DEGTORAD);
+		case OP_TAN: return tanf(a * M_DEGTORAD);
+		case OP_ASIN: return M_RADTODEG * asinf(ClampTo(a, -1.0f, 1.0f));
+		case OP_ACOS: return M_RADTODEG * acosf(ClampTo(a, -1.0f, 1.0f));
+		case OP_ATAN: return M_RADTODEG * atanf(a);
+		case OP_ATAN2: return M_RADTODEG * atan2f(a, b);
+		default: return 0.0f;
+		}
+	}
+
+	//runs one instruction over n items; the switch sits outside the loops so each case is a plain array loop
+	void RunInstruction(const IoExpression::Instruction& ins, float* registers, unsigned block, unsigned n)
+	{
+		float* d = registers + ins.dst_ * block;
+		const float* a = registers + ins.a_ * block;
+		const float* b = registers + ins.b_ * block;
+		const float* c = registers + ins.c_ * block;
+
+#define EXPR_KERNEL(value) for (unsigned i = 0; i < n; ++i) { d[i] = (value); } break
+
+		switch (ins.op_)
+		{
+		case OP_CONST: EXPR_KERNEL(ins.value_);
+		case OP_ADD: EXPR_KERNEL(a[i] + b[i]);
+		case OP_SUB: EXPR_KERNEL(a[i] - b[i]);
+		case OP_MUL: EXPR_KERNEL(a[i] * b[i]);
+		case OP_DIV: EXPR_KERNEL(a[i] / b[i]);
+		case OP_NEG: EXPR_KERNEL(-a[i]);
+		case OP_SQRT: EXPR_KERNEL(sqrtf(a[i]));
+		case OP_ABS: EXPR_KERNEL(fabsf(a[i]));
+		case OP_MIN: EXPR_KERNEL(a[i] < b[i] ? a[i] : b[i]);
+		case OP_MAX: EXPR_KERNEL(a[i] > b[i] ? a[i] : b[i]);
+		case OP_CLAMP: EXPR_KERNEL(ClampTo(a[i], b[i], c[i]));
+		case OP_LERP: EXPR_KERNEL(a[i] + (b[i] - a[i]) * c[i]);
+		case OP_FLOOR: EXPR_KERNEL(floorf(a[i]));
+		case OP_CEIL: EXPR_KERNEL(ceilf(a[i]));
+		default: EXPR_KERNEL(EvaluateOp(ins.op_, a[i], b[i], c[i]));
+		}
+
+#undef EXPR_KERNEL
+	}
+
+	struct Value
+	{
+		Value() : type_(EXPR_NONE), integer_(false) { reg_[0] = reg_[1] = reg_[2] = 0; }
+
+		IoExpressionType type_;
+		unsigned reg_[3];
+		//scalar the script would type as int, i.e. built from integer literals only
+		bool integer_;
+	};
+
+	//recursive descent parser emitting single assignment scalar code; Vector3 values are carried as three registers
+	class ExpressionParser
+	{
+	public:
+		ExpressionParser(
+			const String& source,
+			const Vector<String>& varNames,
+			const PODVector<IoExpressionType>& varTypes,
+			const PODVector<unsigned>& varRegisters,
+			unsigned numRegisters
+			) :
+			pos_(source.CString()),
+			varNames_(varNames),
+			varTypes_(varTypes),
+			varRegisters_(varRegisters)
+		{
+			for (unsigned i = 0; i < numRegisters; ++i)
+				NewRegister();
+		}
+
+		Value Parse()
+		{
+			Value result = ParseAdditive();
+			SkipSpace();
+			Accept(';');
+			SkipSpace();
+			if (!Failed() && *pos_ != '\0')
+				return Fail("unexpected character '" + String(*pos_) + "'");
+			if (!Failed() && result.integer_)
+				return Fail("integer expressions are left to the script");
+			return Failed() ? Value() : result;
+		}
+
+		const String& GetError() const { return error_; }
+		const PODVector<IoExpression::Instruction>& GetCode() const { return code_; }
+		unsigned GetNumRegisters() const { return isConstant_.Size(); }
+
+	private:
+		bool Failed() const { return !error_.Empty(); }
+
+		Value Fail(const String& message)
+		{
+			if (error_.Empty())
+				error_ = message;
+			return Value();
+		}
+
+		void SkipSpace()
+		{
+			while (isspace((unsigned char)*pos_))
+				++pos_;
+		}
+
+		bool Accept(char c)
+		{
+			SkipSpace();
+			if (*pos_ != c)
+				return false;
+			++pos_;
+			return true;
+		}
+
+		String ParseIdentifier()
+		{
+			SkipSpace();
+			const char* start = pos_;
+			if (isalpha((unsigned char)*pos_) || *pos_ == '_')
+			{
+				while (isalnum((unsigned char)*pos_) || *pos_ == '_')
+					++pos_;
+			}
+			return String(start, (unsigned)(pos_ - start));
+		}
+
+		unsigned NewRegister()
+		{
+			isConstant_.Push(false);
+			constantValues_.Push(0.0f);
+			return isConstant_.Size() - 1;
+		}
+
+		unsigned EmitConstant(float value)
+		{
+			IoExpression::Instruction ins;
+			ins.op_ = OP_CONST;
+			ins.dst_ = NewRegister();
+			ins.a_ = ins.b_ = ins.c_ = 0;
+			ins.value_ = value;
+			code_.Push(ins);
+
+			isConstant_[ins.dst_] = true;
+			constantValues_[ins.dst_] = value;
+			return ins.dst_;
+		}
+
+		unsigned Emit(unsigned op, unsigned a, unsigned b = 0, unsigned c = 0)
+		{
+			//fold operations whose operands are all known at compile time
+			unsigned numOperands = GetNumOperands(op);
+			bool constant = isConstant_[a] &&
+				(numOperands < 2 || isConstant_[b]) &&
+				(numOperands < 3 || isConstant_[c]);
+			if (constant)
+				return EmitConstant(EvaluateOp(op, constantValues_[a], constantValues_[b], constantValues_[c]));
+
+			IoExpression::Instruction ins;
+			ins.op_ = op;
+			ins.dst_ = NewRegister();
+			ins.a_ = a;
+			ins.b_ = b;
+			ins.c_ = c;
+			ins.value_ = 0.0f;
+			code_.Push(ins);
+			return ins.dst_;
+		}
+
+		Value MakeScalar(unsigned reg)
+		{
+			Value v;
+			v.type_ = EXPR_FLOAT;
+			v.reg_[0] = reg;
+			return v;
+		}
+
+		Value MakeVector(unsigned x, unsigned y, unsigned z)
+		{
+			Value v;
+			v.type_ = EXPR_VECTOR3;
+			v.reg_[0] = x;
+			v.reg_[1] = y;
+			v.reg_[2] = z;
+			return v;
+		}
+
+		unsigned Dot(const Value& a, const Value& b)
+		{
+			unsigned sum = Emit(OP_MUL, a.reg_[0], b.reg_[0]);
+			sum = Emit(OP_ADD, sum, Emit(OP_MUL, a.reg_[1], b.reg_[1]));
+			return Emit(OP_ADD, sum, Emit(OP_MUL, a.reg_[2], b.reg_[2]));
+		}
+
+		Value Binary(unsigned op, const Value& lhs, const Value& rhs)
+		{
+			if (Failed())
+				return Value();
+
+			if (lhs.type_ == EXPR_FLOAT && rhs.type_ == EXPR_FLOAT)
+			{
+				//int op int stays int in the script, and / and % truncate there
+				bool integer = lhs.integer_ && rhs.integer_;
+				if (integer && (op == OP_DIV || op == OP_MOD))
+					return Fail("integer division is left to the script");
+				Value v = MakeScalar(Emit(op, lhs.reg_[0], rhs.reg_[0]));
+				v.integer_ = integer;
+				return v;
+			}
+
+			//Vector3 operators follow Urho3D: componentwise +-*/ between vectors, * and / by a float
+			bool vectorVector = lhs.type_ == EXPR_VECTOR3 && rhs.type_ == EXPR_VECTOR3 && op != OP_MOD;
+			bool vectorFloat = lhs.type_ == EXPR_VECTOR3 && rhs.type_ == EXPR_FLOAT && (op == OP_MUL || op == OP_DIV);
+			bool floatVector = lhs.type_ == EXPR_FLOAT && rhs.type_ == EXPR_VECTOR3 && op == OP_MUL;
+			if (!vectorVector && !vectorFloat && !floatVector)
+				return Fail("unsupported operand types");
+
+			unsigned r[3];
+			for (unsigned i = 0; i < 3; ++i)
+			{
+				unsigned a = lhs.type_ == EXPR_VECTOR3 ? lhs.reg_[i] : lhs.reg_[0];
+				unsigned b = rhs.type_ == EXPR_VECTOR3 ? rhs.reg_[i] : rhs.reg_[0];
+				r[i] = Emit(op, a, b);
+			}
+			return MakeVector(r[0], r[1], r[2]);
+		}
+
+		Value ParseAdditive()
+		{
+			Value lhs = ParseMultiplicative();
+			while (!Failed())
+			{
+				SkipSpace();
+				char c = *pos_;
+				if (c != '+' && c != '-')
+					break;
+				++pos_;
+				if (*pos_ == '=' || *pos_ == c)
+					return Fail("assignment and increment operators are not supported");
+
+				Value rhs = ParseMultiplicative();
+				lhs = Binary(c == '+' ? OP_ADD : OP_SUB, lhs, rhs);
+			}
+			return lhs;
+		}
+
+		Value ParseMultiplicative()
+		{
+			Value lhs = ParseUnary();
+			while (!Failed())
+			{
+				SkipSpace();
+				char c = *pos_;
+				if (c != '*' && c != '/' && c != '%')
+					break;
+				++pos_;
+				if (*pos_ == '*' || *pos_ == '/' || *pos_ == '=')
+					return Fail("unsupported operator");
+
+				Value rhs = ParseUnary();
+				lhs = Binary(c == '*' ? OP_MUL : (c == '/' ? OP_DIV : OP_MOD), lhs, rhs);
+			}
+			return lhs;
+		}
+
+		Value ParseUnary()
+		{
+			if (Accept('+'))
+				return ParseUnary();
+			if (Accept('-'))
+			{
+				Value v = ParseUnary();
+				if (v.type_ == EXPR_FLOAT)
+				{
+					bool integer = v.integer_;
+					v = MakeScalar(Emit(OP_NEG, v.reg_[0]));
+					v.integer_ = integer;
+					return v;
+				}
+				if (v.type_ == EXPR_VECTOR3)
+					return MakeVector(Emit(OP_NEG, v.reg_[0]), Emit(OP_NEG, v.reg_[1]), Emit(OP_NEG, v.reg_[2]));
+				return v;
+			}
+			return ParsePostfix();
+		}
+
+		Value ParsePostfix()
+		{
+			Value v = ParsePrimary();
+			while (!Failed() && Accept('.'))
+				v = ParseMember(v);
+			return v;
+		}
+
+		bool ParseArguments(Vector<Value>& args)
+		{
+			if (Accept(')'))
+				return true;
+			do
+			{
+				Value arg = ParseAdditive();
+				if (Failed())
+					return false;
+				args.Push(arg);
+			} while (Accept(','));
+
+			if (!Accept(')'))
+			{
+				Fail("expected ')'");
+				return false;
+			}
+			return true;
+		}
+
+		Value ParsePrimary()
+		{
+			SkipSpace();
+			if (Accept('('))
+			{
+				Value v = ParseAdditive();
+				if (!Accept(')'))
+					return Fail("expected ')'");
+				return v;
+			}
+
+			if (isdigit((unsigned char)pos_[0]) || (pos_[0] == '.' && isdigit((unsigned char)pos_[1])))
+			{
+				const char* start = pos_;
+				char* end = 0;
+				double number = strtod(pos_, &end);
+				pos_ = end;
+				bool integer = true;
+				for (const char* c = start; c != end; ++c)
+				{
+					if (!isdigit((unsigned char)*c))
+						integer = false;
+				}
+				if (*pos_ == 'f' || *pos_ == 'F')
+				{
+					integer = false;
+					++pos_;
+				}
+				Value v = MakeScalar(EmitConstant((float)number));
+				v.integer_ = integer;
+				return v;
+			}
+
+			String name = ParseIdentifier();
+			if (name.Empty())
+				return *pos_ == '\0' ? Fail("unexpected end of expression") : Fail("unexpected character '" + String(*pos_) + "'");
+
+			if (Accept('('))
+			{
+				Vector<Value> args;
+				if (!ParseArguments(args))
+					return Value();
+				return CallFunction(name, args);
+			}
+
+			for (unsigned i = 0; i < varNames_.Size(); ++i)
+			{
+				if (varNames_[i] != name)
+					continue;
+				unsigned reg = varRegisters_[i];
+				if (varTypes_[i] == EXPR_VECTOR3)
+					return MakeVector(reg, reg + 1, reg + 2);
+				return MakeScalar(reg);
+			}
+
+			if (name == "M_PI")
+				return MakeScalar(EmitConstant(M_PI));
+			if (name == "M_DEGTORAD")
+				return MakeScalar(EmitConstant(M_DEGTORAD));
+			if (name == "M_RADTODEG")
+				return MakeScalar(EmitConstant(M_RADTODEG));
+
+			return Fail("unknown identifier '" + name + "'");
+		}
+
+		Value CallFunction(const String& name, const Vector<Value>& args)
+		{
+			if (name == "Vector3")
+			{
+				if (args.Empty())
+				{
+					unsigned zero = EmitConstant(0.0f);
+					return MakeVector(zero, zero, zero);
+				}
+				if (args.Size() == 1 && args[0].type_ == EXPR_VECTOR3)
+					return args[0];
+				if (args.Size() == 3 && args[0].type_ == EXPR_FLOAT && args[1].type_ == EXPR_FLOAT && args[2].type_ == EXPR_FLOAT)
+					return MakeVector(args[0].reg_[0], args[1].reg_[0], args[2].reg_[0]);
+				return Fail("unsupported Vector3 constructor");
+			}
+
+			if (name == "float")
+			{
+				if (args.Size() == 1 && args[0].type_ == EXPR_FLOAT)
+					return args[0];
+				return Fail("unsupported float conversion");
+			}
+
+			for (unsigned i = 0; i < sizeof(FUNCTIONS) / sizeof(FUNCTIONS[0]); ++i)
+			{
+				const FunctionDef& def = FUNCTIONS[i];
+				if (name != def.name_)
+					continue;
+				if (args.Size() != def.numArgs_)
+					return Fail(name + " expects " + String(def.numArgs_) + " arguments");
+
+				//with only int arguments the script may pick an int overload
+				unsigned regs[3] = { 0, 0, 0 };
+				bool integer = true;
+				for (unsigned j = 0; j < args.Size(); ++j)
+				{
+					if (args[j].type_ != EXPR_FLOAT)
+						return Fail(name + " only takes float arguments");
+					regs[j] = args[j].reg_[0];
+					integer = integer && args[j].integer_;
+				}
+				if (integer)
+					return Fail("integer arguments to " + name + " are left to the script");
+				return MakeScalar(Emit(def.op_, regs[0], regs[1], regs[2]));
+			}
+
+			return Fail("unknown function '" + name + "'");
+		}
+
+		Value ParseMember(const Value& object)
+		{
+			String name = ParseIdentifier();
+			if (name.Empty())
+				return Fail("expected member name");
+			if (object.type_ != EXPR_VECTOR3)
+				return Fail("members are only supported on Vector3");
+
+			Vector<Value> args;
+			bool call = Accept('(');
+			if (call && !ParseArguments(args))
+				return Value();
+
+			if (!call)
+			{
+				if (name == "x")
+					return MakeScalar(object.reg_[0]);
+				if (name == "y")
+					return MakeScalar(object.reg_[1]);
+				if (name == "z")
+					return MakeScalar(object.reg_[2]);
+				if (name == "length")
+					return MakeScalar(Emit(OP_SQRT, Dot(object, object)));
+				if (name == "lengthSquared")
+					return MakeScalar(Dot(object, object));
+				return Fail("unknown Vector3 member '" + name + "'");
+			}
+
+			if (args.Empty())
+			{
+				if (name == "Length")
+					return MakeScalar(Emit(OP_SQRT, Dot(object, object)));
+				if (name == "LengthSquared")
+					return MakeScalar(Dot(object, object));
+				if (name == "Normalized")
+				{
+					unsigned length = Emit(OP_SQRT, Dot(object, object));
+					return MakeVector(
+						Emit(OP_DIV, object.reg_[0], length),
+						Emit(OP_DIV, object.reg_[1], length),
+						Emit(OP_DIV, object.reg_[2], length)
+						);
+				}
+			}
+			else if (args.Size() == 1 && args[0].type_ == EXPR_VECTOR3)
+			{
+				const Value& other = args[0];
+				if (name == "DotProduct")
+					return MakeScalar(Dot(object, other));
+				if (name == "CrossProduct")
+				{
+					const unsigned* a = object.reg_;
+					const unsigned* b = other.reg_;
+					return MakeVector(
+						Emit(OP_SUB, Emit(OP_MUL, a[1], b[2]), Emit(OP_MUL, a[2], b[1])),
+						Emit(OP_SUB, Emit(OP_MUL, a[2], b[0]), Emit(OP_MUL, a[0], b[2])),
+						Emit(OP_SUB, Emit(OP_MUL, a[0], b[1]), Emit(OP_MUL, a[1], b[0]))
+						);
+				}
+			}
+
+			return Fail("unsupported Vector3 method '" + name + "'");
+		}
+
+		const char* pos_;
+		const Vector<String>& varNames_;
+		const PODVector<IoExpressionType>& varTypes_;
+		const PODVector<unsigned>& varRegisters_;
+		PODVector<IoExpression::Instruction> code_;
+		PODVector<bool> isConstant_;
+		PODVector<float> constantValues_;
+		String error_;
+	};
+
+	Mutex cacheMutex_;
+	HashMap<String, std::shared_ptr<const IoExpression> > cache_;
+
+} // namespace
+
+IoExpression::IoExpression() :
+	numRegisters_(0),
+	resultType_(EXPR_NONE)
+{
+	resultRegisters_[0] = resultRegisters_[1] = resultRegisters_[2] = 0;
+}
+
+bool IoExpression::Compile(
+	const String& source,
+	const Vector<String>& varNames,
+	const PODVector<IoExpressionType>& varTypes
+	)
+{
+	constants_.Clear();
+	code_.Clear();
+	varTypes_ = varTypes;
+	varRegisters_.Clear();
+	resultType_ = EXPR_NONE;
+	error_.Clear();
+
+	if (varNames.Size() != varTypes.Size())
+	{
+		error_ = "variable names and types do not match";
+		return false;
+	}
+
+	//variables occupy the first registers
+	unsigned numRegisters = 0;
+	for (unsigned i = 0; i < varTypes.Size(); ++i)
+	{
+		if (varTypes[i] == EXPR_NONE)
+		{
+			error_ = "variable '" + varNames[i] + "' has an unsupported type";
+			return false;
+		}
+		varRegisters_.Push(numRegisters);
+		numRegisters += varTypes[i] == EXPR_VECTOR3 ? 3 : 1;
+	}
+
+	ExpressionParser parser(source, varNames, varTypes, varRegisters_, numRegisters);
+	Value result = parser.Parse();
+	if (result.type_ == EXPR_NONE)
+	{
+		error_ = parser.GetError();
+		return false;
+	}
+
+	//constants never change between blocks, so they are loaded once up front
+	const PODVector<Instruction>& code = parser.GetCode();
+	for (unsigned i = 0; i < code.Size(); ++i)
+	{
+		if (code[i].op_ == OP_CONST)
+			constants_.Push(code[i]);
+		else
+			code_.Push(code[i]);
+	}
+
+	numRegisters_ = parser.GetNumRegisters();
+	resultType_ = result.type_;
+	for (unsigned i = 0; i < 3; ++i)
+		resultRegisters_[i] = result.reg_[i];
+
+	return true;
+}
+
+void IoExpression::Evaluate(const PODVector<IoExpressionArray>& inputs, unsigned count, float* result) const
+{
+	if (!IsValid() || count == 0 || !result || inputs.Size() < varTypes_.Size())
+		return;
+
+	const unsigned block = count < BLOCK_SIZE ? count : BLOCK_SIZE;
+	PODVector<float> registerStorage(numRegisters_ * block);
+	float* registers = &registerStorage[0];
+
+	for (unsigned i = 0; i < constants_.Size(); ++i)
+		RunInstruction(constants_[i], registers, block, block);
+
+	const unsigned numComponents = resultType_ == EXPR_VECTOR3 ? 3 : 1;
+
+	for (unsigned begin = 0; begin < count; begin += block)
+	{
+		const unsigned n = count - begin < block ? count - begin : block;
+
+		//gather the inputs of this block into their registers
+		for (unsigned v = 0; v < varTypes_.Size(); ++v)
+		{
+			const IoExpressionArray& in = inputs[v];
+			unsigned components = varTypes_[v] == EXPR_VECTOR3 ? 3 : 1;
+			for (unsigned c = 0; c < components; ++c)
+			{
+				float* dst = registers + (varRegisters_[v] + c) * block;
+				const float* src = in.data_ + begin * in.stride_ + c;
+				for (unsigned i = 0; i < n; ++i)
+					dst[i] = src[i * in.stride_];
+			}
+		}
+
+		for (unsigned i = 0; i < code_.Size(); ++i)
+			RunInstruction(code_[i], registers, block, n);
+
+		for (unsigned c = 0; c < numComponents; ++c)
+		{
+			const float* src = registers + resultRegisters_[c] * block;
+			float* dst = result + begin * numComponents + c;
+			for (unsigned i = 0; i < n; ++i)
+				dst[i * numComponents] = src[i];
+		}
+	}
+}
+
+Variant IoExpression::Evaluate(const Vector<Variant>& args) const
+{
+	if (!IsValid() || args.Size() < varTypes_.Size())
+		return Variant();
+
+	PODVector<float> values(3 * varTypes_.Size() + 1);
+	PODVector<IoExpressionArray> inputs;
+	for (unsigned i = 0; i < varTypes_.Size(); ++i)
+	{
+		if (GetVariantType(args[i]) != varTypes_[i])
+			return Variant();
+
+		float* value = &values[3 * i];
+		const Variant& arg = args[i];
+		if (arg.GetType() == VAR_VECTOR3)
+		{
+			Vector3 v = arg.GetVector3();
+			value[0] = v.x_;
+			value[1] = v.y_;
+			value[2] = v.z_;
+		}
+		else if (arg.GetType() == VAR_INT)
+			value[0] = (float)arg.GetInt();
+		else if (arg.GetType() == VAR_DOUBLE)
+			value[0] = (float)arg.GetDouble();
+		else
+			value[0] = arg.GetFloat();
+
+		inputs.Push(IoExpressionArray(value, 0));
+	}
+
+	float result[3];
+	Evaluate(inputs, 1, result);
+	if (resultType_ == EXPR_VECTOR3)
+		return Vector3(result);
+	return result[0];
+}
+
+IoExpressionType IoExpression::GetVariantType(const Variant& var)
+{
+	switch (var.GetType())
+	{
+	case VAR_FLOAT:
+		return EXPR_FLOAT;
+	case VAR_VECTOR3:
+		return EXPR_VECTOR3;
+	default:
+		return EXPR_NONE;
+	}
+}
+
+std::shared_ptr<const IoExpression> IoExpression::GetCached(
+	const String& source,
+	const Vector<String>& varNames,
+	const PODVector<IoExpressionType>& varTypes
+	)
+{
+	String key = source;
+	for (unsigned i = 0; i < varNames.Size() && i < varTypes.Size(); ++i)
+		key.AppendWithFormat("\n%s:%d", varNames[i].CString(), (int)varTypes[i]);
+
+	MutexLock lock(cacheMutex_);
+
+	HashMap<String, std::shared_ptr<const IoExpression> >::ConstIterator it = cache_.Find(key);
+	if (it != cache_.End())
+		return it->second_;
+
+	//failures are cached as null as well, so the script fallback does not re-parse every item
+	std::shared_ptr<IoExpression> expression = std::make_shared<IoExpression>();
+	if (!expression->Compile(source, varNames, varTypes))
+		expression.reset();
+
+	if (cache_.Size() >= MAX_CACHED_EXPRESSIONS)
+		cache_.Clear();
+	cache_[key] = expression;
+
+	return expression;
+}
@@ -0,0 +1,115 @@
+//
+// Copyright (c) 2016 - 2017 Mesh Consultants Inc.
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include <Urho3D/Container/Str.h>
+#include <Urho3D/Container/Vector.h>
+#include <Urho3D/Core/Variant.h>
+
+#include <memory>
+
+///type of a value flowing through a compiled expression
+enum IoExpressionType
+{
+	EXPR_NONE,
+	EXPR_FLOAT,
+	EXPR_VECTOR3
+};
+
+///strided view of the values bound to one expression variable
+///item i reads data_[i * stride_]; a stride of 0 broadcasts the same value to every item
+///Vector3 variables read their y and z components from data_[1] and data_[2] relative to x
+struct IoExpressionArray
+{
+	IoExpressionArray() : data_(0), stride_(0) {}
+	IoExpressionArray(const float* data, unsigned stride) : data_(data), stride_(stride) {}
+
+	const float* data_;
+	unsigned stride_;
+};
+
+///Arithmetic expression in script syntax, parsed once into flat scalar code and evaluated over whole arrays.
+///Supports float and Vector3 arithmetic, the common Urho3D math functions (Sin, Pow, Clamp, ...) and the
+///Vector3 members x/y/z, length, DotProduct, CrossProduct and Normalized. Integer literals are tracked so that
+///anything the script would evaluate in int (int division or modulo, an int result) is not compiled either.
+///Anything else fails to compile and callers are expected to fall back to running the expression through the
+///Script subsystem.
+class IoExpression
+{
+public:
+	IoExpression();
+
+	///compiles source against the given variables, returns false and sets the error on unsupported syntax
+	bool Compile(
+		const Urho3D::String& source,
+		const Urho3D::Vector<Urho3D::String>& varNames,
+		const Urho3D::PODVector<IoExpressionType>& varTypes
+		);
+
+	bool IsValid() const { return resultType_ != EXPR_NONE; }
+	IoExpressionType GetResultType() const { return resultType_; }
+	const Urho3D::String& GetError() const { return error_; }
+	unsigned GetNumVariables() const { return varTypes_.Size(); }
+
+	///evaluates count items, one input array per variable
+	///result receives count floats, or count interleaved x, y, z triples for a Vector3 expression
+	void Evaluate(const Urho3D::PODVector<IoExpressionArray>& inputs, unsigned count, float* result) const;
+
+	///evaluates a single item, args must match the variable types passed to Compile
+	Urho3D::Variant Evaluate(const Urho3D::Vector<Urho3D::Variant>& args) const;
+
+	///expression type a Variant binds as, EXPR_NONE if it cannot be used in a compiled expression
+	static IoExpressionType GetVariantType(const Urho3D::Variant& var);
+
+	///returns the compiled expression for source and variable signature from a process wide cache
+	///compiles on first use; returns null if the expression needs the script fallback
+	static std::shared_ptr<const IoExpression> GetCached(
+		const Urho3D::String& source,
+		const Urho3D::Vector<Urho3D::String>& varNames,
+		const Urho3D::PODVector<IoExpressionType>& varTypes
+		);
+
+	///one scalar operation: registers_[dst_] = op(registers_[a_], registers_[b_], registers_[c_]), or value_ for constants
+	struct Instruction
+	{
+		unsigned op_;
+		unsigned dst_;
+		unsigned a_;
+		unsigned b_;
+		unsigned c_;
+		float value_;
+	};
+
+private:
+	///constant loads, run once per Evaluate call
+	Urho3D::PODVector<Instruction> constants_;
+	///everything else, run once per block of items
+	Urho3D::PODVector<Instruction> code_;
+	Urho3D::PODVector<IoExpressionType> varTypes_;
+	///first register of each variable, Vector3 variables occupy three consecutive registers
+	Urho3D::PODVector<unsigned> varRegisters_;
+	unsigned resultRegisters_[3];
+	unsigned numRegisters_;
+	IoExpressionType resultType_;
+	Urho3D::String error_;
+};
@@ -26,10 +26,29 @@
 #include <memory>
 #include <vector>
 
+#include <Urho3D/Core/Timer.h>
+#include <Urho3D/Core/WorkQueue.h>
+
 #include "IndexUtilities.h"
 
+#include <functional>
+#include <queue>
+
 using namespace Urho3D;
 
+namespace {
+
+	// WorkQueue entry point: solves the component stored in start_ and writes the LocalSolve return value to aux_
+	void SolveComponentWork(const WorkItem* item, unsigned threadIndex)
+	{
+		IoComponentBase* component = static_cast<IoComponentBase*>(item->start_);
+		int* solveResult = static_cast<int*>(item->aux_);
+
+		*solveResult = component->LocalSolve();
+	}
+
+}
+
 // Finds a topological sorting of the graph, i.e.
 // Enumerates the vertices 1,..., n such that 
 // i < j for each edge ij
@@ -40,72 +59,48 @@ using namespace Urho3D;
 // top_nbr[i] is the index of the vertex with topological sort number i
 bool  IoGraph::IsAcyclic(Vector<int>& top_nbr) const
 {
+	UpdateAdjacency();
+
 	// initialize the sorting index
 	int N = 0;
 	int n = components_.Size();
 
 	// in_degrees is a record of the in_degrees of the nodes
 	// we will modify this list, which is why we don't use built-in in-degree info.
-	Vector<int> in_degrees;
+	PODVector<unsigned> in_degrees(n);
 	for (int i = 0; i < n; ++i)
 	{
-		in_degrees.Push(components_[i]->ComputeUniqueInDegree());
-	//	std::cout << "component " << i << " has in degree " << in_degrees[i] << std::endl;
+		in_degrees[i] = inOffsets_[i + 1] - inOffsets_[i];
 	}
 
-	// roots is a list of roots at the current step, 
-	Vector<IoComponentBase*> roots;
+	// roots is a FIFO of the vertices whose in-degree has dropped to zero, head is its front
+	PODVector<int> roots;
+	unsigned head = 0;
 
 	// Add all root vertices to sorted list
 	for (int i = 0; i < n; ++i)
 	{
 		if (in_degrees[i] == 0)
-			roots.Push(components_[i].Get());
+			roots.Push(i);
 	}
 
-	while (!roots.Empty())
+	while (head < roots.Size())
 	{
 		// grab the first vertex in roots list
-		IoComponentBase* firstVert = roots[0];
-
-		// find its index
-		int vertID = -1;
-		for (int i = 0; i < (int)components_.Size(); ++i)
-		{
-			if (firstVert == components_[i].Get())
-				vertID = i;
-		}
+		int vertID = roots[head++];
 
 		// assign current topo_number to this vertex
-		top_nbr.Push(vertID); 
+		top_nbr.Push(vertID);
 		N += 1;
-		// then remove that vertex from the list
-		roots.Erase(roots.Begin());
 
-		// get children of the current root node:
-		Vector<SharedPtr<IoComponentBase> > children = firstVert->GetUniqueComponentsOut();
-	//	std::cout << "children of vertex " << vertID << " are: " << std::endl;
-		for (unsigned j = 0; j < children.Size(); ++j)
+		// deprecate the in-degree of its children, add them to roots list
+		for (unsigned j = outOffsets_[vertID]; j < outOffsets_[vertID + 1]; ++j)
 		{
-			// null pointers are not children
-			if (children[j].Null())
-				continue;
-
-			// find indices of the children of the current root node: 
-			int idx = -1;
-			for (int i = 0; i < (int)components_.Size(); ++i)
-			{
-				if (children[j] == components_[i].Get())
-					idx = i;
-			}
-			//std::cout << idx << ", ";
-
-			// deprecate their in-degree, add to roots list
+			unsigned idx = outEdges_[j];
 			in_degrees[idx] = in_degrees[idx] - 1;
 			if (in_degrees[idx] == 0)
-				roots.Push(children[j]);
+				roots.Push(idx);
 		}
-		//std::cout << std::endl;
 	}
 	if (N == n) {
 		// the graph contains no directed cycle
@@ -117,6 +112,82 @@ bool  IoGraph::IsAcyclic(Vector<int>& top_nbr) const
 	}
 }
 
+// Rebuilds the CSR adjacency if components were added/removed or links changed since the last call.
+// Out-edges of a component keep the order of IoComponentBase::GetUniqueComponentsOut
+// (output slot order, then link order), so the topological sort is the same as before.
+// Runs in O(components + links).
+void IoGraph::UpdateAdjacency() const
+{
+	if (!adjacencyDirty_)
+		return;
+
+	unsigned n = components_.Size();
+
+	componentIndices_.Clear();
+	for (unsigned i = 0; i < n; ++i) {
+		componentIndices_[components_[i].Get()] = i;
+	}
+
+	// lastParent[j] == i + 1 once the edge i -> j has been recorded, keeps the edges unique
+	PODVector<unsigned> lastParent(n);
+	PODVector<unsigned> inCounts(n);
+	for (unsigned i = 0; i < n; ++i) {
+		lastParent[i] = 0;
+		inCounts[i] = 0;
+	}
+
+	outOffsets_.Resize(n + 1);
+	outEdges_.Clear();
+	for (unsigned i = 0; i < n; ++i)
+	{
+		outOffsets_[i] = outEdges_.Size();
+
+		const Vector<SharedPtr<IoOutputSlot> >& outputSlots = components_[i]->outputSlots_;
+		for (unsigned k = 0; k < outputSlots.Size(); ++k) {
+			for (unsigned l = 0; l < outputSlots[k]->GetNumLinkedInputSlots(); ++l) {
+				SharedPtr<IoInputSlot> in = outputSlots[k]->GetLinkedInputSlot(l);
+				if (in.Null())
+					continue;
+
+				// links into components that are not part of this graph are ignored
+				HashMap<IoComponentBase*, unsigned>::ConstIterator it = componentIndices_.Find(in->GetHomeComponent().Get());
+				if (it == componentIndices_.End())
+					continue;
+
+				unsigned j = it->second_;
+				if (lastParent[j] == i + 1)
+					continue;
+
+				lastParent[j] = i + 1;
+				outEdges_.Push(j);
+				++inCounts[j];
+			}
+		}
+	}
+	outOffsets_[n] = outEdges_.Size();
+
+	// in-edges by counting sort over the out-edges, parents of each component end up in index order
+	inOffsets_.Resize(n + 1);
+	inOffsets_[0] = 0;
+	for (unsigned i = 0; i < n; ++i) {
+		inOffsets_[i + 1] = inOffsets_[i] + inCounts[i];
+	}
+
+	inEdges_.Resize(outEdges_.Size());
+	PODVector<unsigned> cursor(n);
+	for (unsigned i = 0; i < n; ++i) {
+		cursor[i] = inOffsets_[i];
+	}
+	for (unsigned i = 0; i < n; ++i) {
+		for (unsigned j = outOffsets_[i]; j < outOffsets_[i + 1]; ++j) {
+			inEdges_[cursor[outEdges_[j]]++] = i;
+		}
+	}
+
+	adjacencyDirty_ = false;
+	++adjacencyGeneration_;
+}
+
 
 
 // alternate graph solver
@@ -124,29 +195,48 @@ int IoGraph::TopoSolveGraph()
 {
 	int numSolved = 0;
 	VariantVector solvedIndices;
-	Vector<int> top_number;
-	bool goodToSolve = IsAcyclic(top_number);
+	bool goodToSolve = UpdateTopology();
 	// if it contains a cycle, return failure
 	if (!goodToSolve)
 		return 0;
 
-	// walk through the nodes according to their topological sort index
-	for (unsigned i = 0; i < top_number.Size(); ++i)
-	{
-		// Only tries to call LocalSolve if solve is enabled
-		if (components_[top_number[i]]->IsSolveEnabled()) {
-			components_[top_number[i]]->LocalSolve();
+	// local copy, a component may rewire the graph while we walk it
+	Vector<int> top_number = topoOrder_;
+
+	if (parallelSolve_) {
+		Vector<int> solveResults;
+		ParallelSolveLevels(top_number, false, solveResults);
+
+		// tally in topological order so the solved indices match the serial walk below
+		for (unsigned i = 0; i < top_number.Size(); ++i)
+		{
 			bool solveFlag = components_[top_number[i]]->IsSolved();
 			if (solveFlag) {
-				solvedIndices.Push(top_number[i]);
+				++numSolved;
+				if (solveResults[top_number[i]] != -1)
+					solvedIndices.Push(top_number[i]);
 			}
 		}
-		// Regardless of whether LocalSolve was called,
-		// checks component for input/output consistency
-		// (solveFlag == true if and only if solveFlag_ == 1).
-		bool solveFlag = components_[top_number[i]]->IsSolved();
-		if (solveFlag) {
-			++numSolved;
+	}
+	else {
+		// walk through the nodes according to their topological sort index
+		for (unsigned i = 0; i < top_number.Size(); ++i)
+		{
+			// Only tries to call LocalSolve if solve is enabled
+			if (components_[top_number[i]]->IsSolveEnabled()) {
+				components_[top_number[i]]->LocalSolve();
+				bool solveFlag = components_[top_number[i]]->IsSolved();
+				if (solveFlag) {
+					solvedIndices.Push(top_number[i]);
+				}
+			}
+			// Regardless of whether LocalSolve was called,
+			// checks component for input/output consistency
+			// (solveFlag == true if and only if solveFlag_ == 1).
+			bool solveFlag = components_[top_number[i]]->IsSolved();
+			if (solveFlag) {
+				++numSolved;
+			}
 		}
 	}
 
@@ -170,30 +260,39 @@ int IoGraph::QuickTopoSolveGraph()
 {
 	int numSolved = 0;
 	VariantVector solvedIndices;
-	Vector<int> top_number;
-	bool goodToSolve = IsAcyclic(top_number);
+	bool goodToSolve = UpdateTopology();
 	// if it contains a cycle, return failure
 	if (!goodToSolve)
 		return 0;
 
-	// walk through the nodes according to their topological sort index
-	for (unsigned i = 0; i < top_number.Size(); ++i)
-	{
-		// if the component is unsolved and solve is enabled, then solve
-		if (
-			!components_[top_number[i]]->IsSolved() &&
-			components_[top_number[i]]->IsSolveEnabled()
-			) {
-			int solveFlag = components_[top_number[i]]->LocalSolve();
+	if (parallelSolve_) {
+		Vector<int> top_number = topoOrder_;
+		Vector<int> solveResults;
+		ParallelSolveLevels(top_number, true, solveResults);
+
+		// tally in topological order so the solved indices match the serial walk below
+		for (unsigned i = 0; i < top_number.Size(); ++i)
+		{
+			int solveFlag = solveResults[top_number[i]];
 			if (solveFlag == 1) {
 				++numSolved;
 				solvedIndices.Push(top_number[i]);
 			}
+			else if (solveFlag == -1 && components_[top_number[i]]->IsSolved()) {
+				++numSolved;
+			}
 		}
-		// otherwise check if component has been solved at previous stage
-		else if (components_[top_number[i]]->IsSolved()) {
-			++numSolved;
+	}
+	else {
+		// only the unsolved components and their downstream cone are visited;
+		// if a component rewires the graph mid-pass, start over on the rebuilt order
+		while (!SolveDirtyCone(solvedIndices)) {
+			if (!UpdateTopology())
+				return 0;
 		}
+
+		// after the pass the dirty set holds exactly the components left unsolved
+		numSolved = (int)(components_.Size() - dirtyComponents_.Size());
 	}
 
 	//send message that graph has been solved
@@ -209,15 +308,439 @@ int IoGraph::QuickTopoSolveGraph()
 }
 
 
+// Rebuilds the cached topological order and positions,
+// but only if components were added/removed or links changed since the last call.
+// Returns false if the graph contains a cycle.
+bool IoGraph::UpdateTopology()
+{
+	UpdateAdjacency();
+	if (orderGeneration_ == adjacencyGeneration_)
+		return topoAcyclic_;
+
+	unsigned n = components_.Size();
+
+	topoOrder_.Clear();
+	topoAcyclic_ = IsAcyclic(topoOrder_);
+
+	topoPosition_.Resize(n);
+	for (unsigned i = 0; i < n; ++i) {
+		topoPosition_[i] = -1;
+	}
+	for (unsigned i = 0; i < topoOrder_.Size(); ++i) {
+		topoPosition_[topoOrder_[i]] = i;
+	}
+
+	coneMarks_.Resize(n);
+	for (unsigned i = 0; i < n; ++i) {
+		coneMarks_[i] = 0;
+	}
+	coneStamp_ = 0;
+
+	orderGeneration_ = adjacencyGeneration_;
+	++topologyGeneration_;
+
+	return topoAcyclic_;
+}
+
+// Solves, in cached topological order, the components in the dirty set
+// and any downstream component their new outputs invalidate. Nothing outside that cone is touched.
+// Components left unsolved go back into the dirty set, so they are retried by the next pass as before.
+// Returns false if the topology was rebuilt during the pass (e.g. by a nested solve); the caller should restart.
+bool IoGraph::SolveDirtyCone(VariantVector& solvedIndices)
+{
+	unsigned generation = topologyGeneration_;
+
+	// a fresh stamp clears all marks at once; a nested pass taking a newer stamp
+	// can at worst make this one queue a component twice, the duplicate is skipped when popped
+	unsigned stamp = ++coneStamp_;
+	int lastPosition = -1;
+
+	// min-heap of topological positions waiting to be visited
+	std::priority_queue<int, std::vector<int>, std::greater<int> > pending;
+
+	// everything queued in this pass, checked again once it is over
+	PODVector<unsigned> cone;
+
+	// take the dirty set over, components flagged during the pass start a new one
+	PODVector<IoComponentBase*> seeds;
+	seeds.Swap(dirtyComponents_);
+
+	for (unsigned i = 0; i < seeds.Size(); ++i) {
+		seeds[i]->dirtyQueued_ = false;
+
+		HashMap<IoComponentBase*, unsigned>::ConstIterator it = componentIndices_.Find(seeds[i]);
+		if (it == componentIndices_.End())
+			continue;
+
+		unsigned vertID = it->second_;
+		cone.Push(vertID);
+		if (!components_[vertID]->IsSolved() && components_[vertID]->IsSolveEnabled() && coneMarks_[vertID] != stamp) {
+			pending.push(topoPosition_[vertID]);
+			coneMarks_[vertID] = stamp;
+		}
+	}
+
+	bool completed = true;
+	while (!pending.empty())
+	{
+		int position = pending.top();
+		pending.pop();
+		if (position == lastPosition)
+			continue;
+		lastPosition = position;
+
+		int vertID = topoOrder_[position];
+
+		// an upstream solve may not have invalidated it after all
+		if (components_[vertID]->IsSolved() || !components_[vertID]->IsSolveEnabled())
+			continue;
+
+		int solveFlag = components_[vertID]->LocalSolve();
+		if (solveFlag == 1) {
+			solvedIndices.Push(vertID);
+		}
+
+		if (generation != topologyGeneration_) {
+			completed = false;
+			break;
+		}
+
+		// Transmit has cleared the solved flag of every child that received new data
+		for (unsigned j = outOffsets_[vertID]; j < outOffsets_[vertID + 1]; ++j) {
+			unsigned child = outEdges_[j];
+			if (coneMarks_[child] != stamp && !components_[child]->IsSolved()) {
+				pending.push(topoPosition_[child]);
+				coneMarks_[child] = stamp;
+				cone.Push(child);
+			}
+		}
+	}
+
+	// whatever is still unsolved (failed, disabled or not reached before a restart) stays dirty
+	for (unsigned i = 0; i < cone.Size(); ++i) {
+		if (!components_[cone[i]]->IsSolved()) {
+			MarkDirty(components_[cone[i]].Get());
+		}
+	}
+
+	// drop entries flagged during the pass and solved later in it
+	unsigned kept = 0;
+	for (unsigned i = 0; i < dirtyComponents_.Size(); ++i) {
+		if (dirtyComponents_[i]->IsSolved()) {
+			dirtyComponents_[i]->dirtyQueued_ = false;
+		}
+		else {
+			dirtyComponents_[kept++] = dirtyComponents_[i];
+		}
+	}
+	dirtyComponents_.Resize(kept);
+
+	return completed;
+}
+
+void IoGraph::MarkDirty(IoComponentBase* component)
+{
+	if (!component->dirtyQueued_) {
+		component->dirtyQueued_ = true;
+		dirtyComponents_.Push(component);
+	}
+}
+
+// Groups topologically sorted components into dependency levels.
+// Level 0 holds the components with no upstream components, every other component
+// sits one level below its deepest parent, so components sharing a level never feed each other.
+// levels[k] lists the component indices of level k in topological order.
+void IoGraph::ComputeSolveLevels(const Vector<int>& top_nbr, Vector<Vector<int> >& levels) const
+{
+	Vector<int> depth(components_.Size());
+	for (unsigned i = 0; i < depth.Size(); ++i) {
+		depth[i] = 0;
+	}
+
+	int numLevels = 0;
+	for (unsigned i = 0; i < top_nbr.Size(); ++i)
+	{
+		int vertID = top_nbr[i];
+		numLevels = Max(numLevels, depth[vertID] + 1);
+
+		// parents always come first in top_nbr, so depth[vertID] is final here
+		for (unsigned j = outOffsets_[vertID]; j < outOffsets_[vertID + 1]; ++j) {
+			depth[outEdges_[j]] = Max(depth[outEdges_[j]], depth[vertID] + 1);
+		}
+	}
+
+	levels.Clear();
+	levels.Resize(numLevels);
+	for (unsigned i = 0; i < top_nbr.Size(); ++i) {
+		levels[depth[top_nbr[i]]].Push(top_nbr[i]);
+	}
+}
+
+// Solves the graph level by level, running LocalSolve of the components within a level concurrently on the WorkQueue.
+// Only components flagged IsThreadSafe go to the workers, the rest are solved on the main thread after the workers of their level have finished.
+// Workers do not touch the solved flags of downstream components (see IoInputSlot::SoftSet), those are reset here at the level barrier.
+// quick: if true, only components flagged as unsolved are solved (QuickTopoSolveGraph semantics)
+// solveResults[i]: LocalSolve return value for component i, or -1 if LocalSolve was not called
+void IoGraph::ParallelSolveLevels(const Vector<int>& top_nbr, bool quick, Vector<int>& solveResults)
+{
+	Vector<Vector<int> > levels;
+	ComputeSolveLevels(top_nbr, levels);
+
+	solveResults.Resize(components_.Size());
+	for (unsigned i = 0; i < solveResults.Size(); ++i) {
+		solveResults[i] = -1;
+	}
+
+	levelTimings_.Clear();
+	VariantVector levelSizes;
+
+	// without a WorkQueue everything falls back to the main thread
+	WorkQueue* queue = GetSubsystem<WorkQueue>();
+	HiresTimer levelTimer;
+	float totalTime = 0.0f;
+
+	for (unsigned i = 0; i < levels.Size(); ++i)
+	{
+		levelTimer.Reset();
+
+		Vector<int> mainThreadIndices;
+		Vector<int> workerIndices;
+		for (unsigned j = 0; j < levels[i].Size(); ++j)
+		{
+			int vertID = levels[i][j];
+			IoComponentBase* component = components_[vertID].Get();
+
+			if (!component->IsSolveEnabled() || (quick && component->IsSolved()))
+				continue;
+
+			if (!queue || !component->IsThreadSafe()) {
+				mainThreadIndices.Push(vertID);
+				continue;
+			}
+
+			workerIndices.Push(vertID);
+
+			SharedPtr<WorkItem> item = queue->GetFreeItem();
+			item->priority_ = M_MAX_UNSIGNED;
+			item->workFunction_ = SolveComponentWork;
+			item->start_ = component;
+			item->aux_ = &solveResults[vertID];
+			queue->AddWorkItem(item);
+		}
+
+		// the main thread helps until every worker item of this level is done
+		if (queue) {
+			queue->Complete(M_MAX_UNSIGNED);
+		}
+
+		// every worker has transmitted its outputs by now, flag the receiving components from this thread only
+		for (unsigned j = 0; j < workerIndices.Size(); ++j) {
+			if (!components_[workerIndices[j]]->IsSolved()) {
+				MarkDirty(components_[workerIndices[j]].Get());
+			}
+
+			Vector<unsigned> children = GetDownstreamComponentIndices(workerIndices[j]);
+			for (unsigned k = 0; k < children.Size(); ++k) {
+				components_[children[k]]->MarkUnsolved();
+			}
+		}
+
+		// pinned components run once the workers are idle, so nothing they trigger can race a worker
+		for (unsigned j = 0; j < mainThreadIndices.Size(); ++j) {
+			solveResults[mainThreadIndices[j]] = components_[mainThreadIndices[j]]->LocalSolve();
+		}
+
+		for (unsigned j = 0; j < levels[i].Size(); ++j) {
+			components_[levels[i][j]]->FlushDeferredEvents();
+		}
+
+		float levelTime = levelTimer.GetUSec(false) / 1000.0f;
+		levelTimings_.Push(levelTime);
+		levelSizes.Push((int)levels[i].Size());
+		totalTime += levelTime;
+
+		URHO3D_LOGDEBUG("IoGraph::ParallelSolveLevels --- level " + String(i) + ": " + String(levels[i].Size()) +
+			" components (" + String(mainThreadIndices.Size()) + " on main thread), " + String(levelTime) + " ms");
+	}
+
+	URHO3D_LOGDEBUG("IoGraph::ParallelSolveLevels --- " + String(levels.Size()) + " levels solved in " + String(totalTime) + " ms");
+
+	VariantVector levelTimings;
+	for (unsigned i = 0; i < levelTimings_.Size(); ++i) {
+		levelTimings.Push(levelTimings_[i]);
+	}
+
+	//send the per level timings, the Player logs them for the startup solve
+	VariantMap data;
+	data["graph"] = this;
+	data["level_sizes"] = levelSizes;
+	data["level_timings"] = levelTimings;
+	data["total_time"] = totalTime;
+	SendEvent("OnParallelSolve", data);
+}
+
+// Builds the progressive solve batches. A component joins the cone of the first visible component (in topological order)
+// it feeds, each cone lists its members in topological order, so every batch only depends on itself and earlier batches.
+void IoGraph::BeginProgressiveSolve()
+{
+	progressiveBatches_.Clear();
+	progressiveBatch_ = 0;
+	progressiveVisibleBatches_ = 0;
+	progressiveTimings_.Clear();
+	progressiveTimer_.Reset();
+
+	// a cyclic graph is not solved by TopoSolveGraph either
+	if (!UpdateTopology())
+		return;
+
+	progressiveGeneration_ = topologyGeneration_;
+
+	unsigned n = components_.Size();
+	PODVector<unsigned char> queued(n);
+	PODVector<unsigned char> inCone(n);
+	for (unsigned i = 0; i < n; ++i) {
+		queued[i] = 0;
+		inCone[i] = 0;
+	}
+
+	PODVector<int> stack;
+	for (unsigned i = 0; i < topoOrder_.Size(); ++i)
+	{
+		int target = topoOrder_[i];
+		if (queued[target] || !components_[target]->IsVisibleOutput())
+			continue;
+
+		// walk upstream, stopping at components an earlier cone already holds
+		inCone[target] = 1;
+		stack.Push(target);
+		while (!stack.Empty())
+		{
+			int vertID = stack.Back();
+			stack.Pop();
+			for (unsigned j = inOffsets_[vertID]; j < inOffsets_[vertID + 1]; ++j) {
+				unsigned parent = inEdges_[j];
+				if (!inCone[parent] && !queued[parent]) {
+					inCone[parent] = 1;
+					stack.Push(parent);
+				}
+			}
+		}
+
+		// upstream components sort before the target
+		Vector<int> batch;
+		for (unsigned k = 0; k <= i; ++k) {
+			int vertID = topoOrder_[k];
+			if (inCone[vertID]) {
+				batch.Push(vertID);
+				inCone[vertID] = 0;
+				queued[vertID] = 1;
+			}
+		}
+		progressiveBatches_.Push(batch);
+	}
+
+	progressiveVisibleBatches_ = progressiveBatches_.Size();
+
+	// the deferred rest
+	Vector<int> rest;
+	for (unsigned i = 0; i < topoOrder_.Size(); ++i) {
+		if (!queued[topoOrder_[i]])
+			rest.Push(topoOrder_[i]);
+	}
+
+	Vector<Vector<int> > levels;
+	ComputeSolveLevels(rest, levels);
+	for (unsigned i = 0; i < levels.Size(); ++i) {
+		if (!levels[i].Empty())
+			progressiveBatches_.Push(levels[i]);
+	}
+
+	URHO3D_LOGDEBUG("IoGraph::BeginProgressiveSolve --- " + String(progressiveVisibleBatches_) + " visible branches, " +
+		String(rest.Size()) + " deferred components");
+}
+
+// Solves whole batches until maxMilliseconds have been spent, always at least one.
+// Like TopoSolveGraph, every solve enabled component in a batch is solved, whatever its flag.
+// Returns true while batches remain.
+bool IoGraph::StepProgressiveSolve(float maxMilliseconds)
+{
+	if (!IsProgressiveSolving())
+		return false;
+
+	// the graph was edited since the batches were built, finish with a regular solve
+	UpdateTopology();
+	if (progressiveGeneration_ != topologyGeneration_) {
+		progressiveBatches_.Clear();
+		progressiveBatch_ = 0;
+		QuickTopoSolveGraph();
+		progressiveTimings_.Push(MakePair(String("all components"), progressiveTimer_.GetUSec(false) / 1000.0f));
+		return false;
+	}
+
+	HiresTimer stepTimer;
+	VariantVector solvedIndices;
+
+	while (progressiveBatch_ < progressiveBatches_.Size())
+	{
+		// local copy, a component may rewire the graph while we walk it
+		Vector<int> batch = progressiveBatches_[progressiveBatch_++];
+
+		if (parallelSolve_) {
+			Vector<int> solveResults;
+			ParallelSolveLevels(batch, false, solveResults);
+
+			for (unsigned i = 0; i < batch.Size(); ++i) {
+				if (solveResults[batch[i]] != -1 && components_[batch[i]]->IsSolved())
+					solvedIndices.Push(batch[i]);
+			}
+		}
+		else {
+			for (unsigned i = 0; i < batch.Size(); ++i) {
+				if (components_[batch[i]]->IsSolveEnabled()) {
+					components_[batch[i]]->LocalSolve();
+					if (components_[batch[i]]->IsSolved())
+						solvedIndices.Push(batch[i]);
+				}
+			}
+		}
+
+		float elapsed = progressiveTimer_.GetUSec(false) / 1000.0f;
+		if (progressiveBatch_ == 1 && progressiveVisibleBatches_ > 0)
+			progressiveTimings_.Push(MakePair(String("first visible branch"), elapsed));
+		if (progressiveBatch_ == progressiveVisibleBatches_)
+			progressiveTimings_.Push(MakePair(String("visible branches"), elapsed));
+		if (progressiveBatch_ == progressiveBatches_.Size())
+			progressiveTimings_.Push(MakePair(String("all components"), elapsed));
+
+		if (stepTimer.GetUSec(false) / 1000.0f >= maxMilliseconds)
+			break;
+	}
+
+	//send message that part of the graph has been solved
+	VariantMap data;
+	data["graph"] = this;
+	data["indices"] = solvedIndices;
+	SendEvent("OnSolveGraph", data);
+
+	return IsProgressiveSolving();
+}
+
 //////////////////////////////////////////////////////////////////
 
 
+IoGraph::~IoGraph()
+{
+	// components may outlive the graph through other references
+	for (unsigned i = 0; i < components_.Size(); ++i) {
+		components_[i]->graph_ = 0;
+	}
+}
+
 // POTENTIAL PROBLEM NOW
 void IoGraph::AddNewComponent()
 {
 	SharedPtr<IoComponentBase> nodePtr(new IoComponentBase(GetContext(), 2, 1)); // 2 inputs, 1 output by default (following Grasshopper)
-	components_.Push(nodePtr);
-	rootFlags_.Push(true);
+	AddNewComponent(nodePtr);
 }
 
 // assumption is that this should be a newly constructed node, so all connections are deleted just in case it isn't
@@ -227,6 +750,21 @@ void IoGraph::AddNewComponent(SharedPtr<IoComponentBase> component)
 	//component->DisconnectAllParents();
 	components_.Push(component);
 	rootFlags_.Push(true);
+	adjacencyDirty_ = true;
+
+	component->graph_ = this;
+	if (!component->IsSolved())
+		MarkDirty(component.Get());
+}
+
+// Detaches a component that is leaving this graph, so it no longer reports to the dirty set.
+void IoGraph::ReleaseComponent(IoComponentBase* component)
+{
+	if (component->dirtyQueued_) {
+		dirtyComponents_.Remove(component);
+		component->dirtyQueued_ = false;
+	}
+	component->graph_ = 0;
 }
 
 void IoGraph::AddConnection(
@@ -245,6 +783,7 @@ void IoGraph::AddConnection(
 
 	// child is now definitely not a root
 	rootFlags_[childIndex] = false;
+	adjacencyDirty_ = true;
 }
 
 void IoGraph::DeleteConnection(
@@ -261,6 +800,7 @@ void IoGraph::DeleteConnection(
 	if (components_[childIndex]->ComputeInDegree() == 0) {
 		rootFlags_[childIndex] = true;
 	}
+	adjacencyDirty_ = true;
 
 }
 
@@ -270,8 +810,10 @@ void IoGraph::DeleteComponent(int index)
 	components_[index]->DisconnectAllChildren();
 	components_[index]->DisconnectAllParents();
 
+	ReleaseComponent(ptr.Get());
 	components_.Erase(components_.Begin() + index);
 	rootFlags_.Erase(rootFlags_.Begin() + index);
+	adjacencyDirty_ = true;
 
 	// ALERT: there may be new roots now. 
 	UpdateRoots();
@@ -282,9 +824,11 @@ void IoGraph::Clear()
 {
 	for (unsigned i = 0; i < components_.Size(); ++i) {
 		components_[i]->UnsubscribeFromAllEvents();
+		ReleaseComponent(components_[i].Get());
 	}
 	components_.Clear();
 	rootFlags_.Clear();
+	adjacencyDirty_ = true;
 }
 
 void IoGraph::AddInputSlotToComponent(int component)
@@ -451,9 +995,11 @@ unsigned IoGraph::GetOutputIoDataTree(
 
 void IoGraph::UpdateRoots()
 {
+	UpdateAdjacency();
+
 	for (unsigned i = 0; i < components_.Size(); ++i)
 	{
-		if (components_[i]->ComputeInDegree() == 0)
+		if (inOffsets_[i + 1] == inOffsets_[i])
 			rootFlags_[i] = true;
 		else
 			rootFlags_[i] = false;
@@ -501,23 +1047,11 @@ Vector<unsigned> IoGraph::GetDownstreamComponentIndices(unsigned i) const
 {
 	assert(IndexInRange((int)i, (int)components_.Size()));
 
-	Vector<SharedPtr<IoComponentBase> > downstreamComps = components_[i]->GetUniqueComponentsOut();
+	UpdateAdjacency();
 
 	Vector<unsigned> downIndices;
-	// for each unique downstream component,
-	// look up what its index is in IoGraph::components_ and Push that index to downIndices
-	for (unsigned i = 0; i < downstreamComps.Size(); ++i) {
-		SharedPtr<IoComponentBase> downComp = downstreamComps[i];
-		for (unsigned j = 0; j < components_.Size(); ++j) {
-			if (downComp == components_[j]) {
-				downIndices.Push(j);
-				break;
-			}
-		}
-	}
-
-	if (downIndices.Size() != downstreamComps.Size()) {
-		std::cout << "something strange has happened" << std::endl;
+	for (unsigned j = outOffsets_[i]; j < outOffsets_[i + 1]; ++j) {
+		downIndices.Push(outEdges_[j]);
 	}
 
 	return downIndices;
@@ -26,6 +26,9 @@
 #include <memory>
 #include <vector>
 
+#include <Urho3D/Container/HashMap.h>
+#include <Urho3D/Core/Timer.h>
+
 #include "IoComponentBase.h"
 
 class URHO3D_API IoGraph : public Urho3D::Object
@@ -36,10 +39,61 @@ private:
 	Urho3D::Vector<Urho3D::SharedPtr<IoComponentBase> > components_;
 	Urho3D::Vector<bool> rootFlags_;
 
-	
+	// CSR adjacency over component indices, unique edges only:
+	// outEdges_[outOffsets_[i] .. outOffsets_[i + 1]) are the components immediately downstream of component i,
+	// inEdges_[inOffsets_[i] .. inOffsets_[i + 1]) the ones immediately upstream.
+	// Rebuilt by UpdateAdjacency only when components or links change.
+	mutable Urho3D::PODVector<unsigned> outOffsets_;
+	mutable Urho3D::PODVector<unsigned> outEdges_;
+	mutable Urho3D::PODVector<unsigned> inOffsets_;
+	mutable Urho3D::PODVector<unsigned> inEdges_;
+	mutable Urho3D::HashMap<IoComponentBase*, unsigned> componentIndices_;
+	mutable bool adjacencyDirty_ = true;
+	mutable unsigned adjacencyGeneration_ = 0;
+
+	void UpdateAdjacency() const;
+
+	// cached topological order, rebuilt by UpdateTopology whenever the adjacency is
+	Urho3D::Vector<int> topoOrder_;
+	Urho3D::Vector<int> topoPosition_;
+	bool topoAcyclic_ = false;
+	unsigned orderGeneration_ = 0;
+	unsigned topologyGeneration_ = 0;
+
+	// coneMarks_[i] == coneStamp_ marks component i as queued in the current SolveDirtyCone pass
+	Urho3D::Vector<unsigned> coneMarks_;
+	unsigned coneStamp_ = 0;
+
+	// components flagged unsolved since the last SolveDirtyCone pass (see IoComponentBase::MarkUnsolved),
+	// plus the ones that pass could not solve; may hold entries that have been solved since
+	Urho3D::PODVector<IoComponentBase*> dirtyComponents_;
+
+	void ReleaseComponent(IoComponentBase* component);
+
+	bool UpdateTopology();
+	bool SolveDirtyCone(Urho3D::VariantVector& solvedIndices);
+
+	// when set, TopoSolveGraph and QuickTopoSolveGraph solve independent components concurrently
+	bool parallelSolve_ = false;
+
+	// wall clock time in milliseconds spent on each dependency level during the last parallel solve
+	Urho3D::Vector<float> levelTimings_;
+
+	void ComputeSolveLevels(const Urho3D::Vector<int>& top_nbr, Urho3D::Vector<Urho3D::Vector<int> >& levels) const;
+	void ParallelSolveLevels(const Urho3D::Vector<int>& top_nbr, bool quick, Urho3D::Vector<int>& solveResults);
+
+	// progressive solve state: batches in solve order, the first progressiveVisibleBatches_ of them
+	// are the upstream cones of visible components, progressiveBatch_ is the next one to solve
+	Urho3D::Vector<Urho3D::Vector<int> > progressiveBatches_;
+	unsigned progressiveBatch_ = 0;
+	unsigned progressiveVisibleBatches_ = 0;
+	unsigned progressiveGeneration_ = 0;
+	Urho3D::HiresTimer progressiveTimer_;
+	Urho3D::Vector<Urho3D::Pair<Urho3D::String, float> > progressiveTimings_;
 
 public:
 	IoGraph(Urho3D::Context* context) : Urho3D::Object(context), components_(0), rootFlags_(0) {};
+	virtual ~IoGraph();
 
 	//pointer to current scene
 	Urho3D::Scene* scene;
@@ -105,5 +159,28 @@ public:
 	int QuickTopoSolveGraph();
 	int QuickSolveGraph();
 
+	// forces the cached topological order to be rebuilt before the next solve
+	void InvalidateTopology() { adjacencyDirty_ = true; }
+
+	// queues a component of this graph for the next QuickTopoSolveGraph, called by IoComponentBase::MarkUnsolved
+	void MarkDirty(IoComponentBase* component);
+
+	// Parallel solve: independent components of a dependency level are solved on the WorkQueue.
+	// Saved with the graph (IoSerialization) and forced on by the Player's -parallelsolve option.
+	// Every parallel solve sends "OnParallelSolve" with "graph", "level_sizes" (ints), "level_timings" (ms per level) and "total_time" (ms).
+	void SetParallelSolve(bool parallelSolve) { parallelSolve_ = parallelSolve; }
+	bool IsParallelSolve() const { return parallelSolve_; }
+	const Urho3D::Vector<float>& GetLevelTimings() const { return levelTimings_; }
+
+	// Progressive solve, used at startup so something is on screen before the whole graph is solved.
+	// Components with visible output (IoComponentBase::IsVisibleOutput) are solved first together with everything upstream,
+	// one cone per batch, then the remaining components one dependency level per batch.
+	// Call StepProgressiveSolve once per frame until it returns false.
+	void BeginProgressiveSolve();
+	bool StepProgressiveSolve(float maxMilliseconds);
+	bool IsProgressiveSolving() const { return progressiveBatch_ < progressiveBatches_.Size(); }
+	// milliseconds since BeginProgressiveSolve at which the first visible branch, all visible branches and the whole graph were solved
+	const Urho3D::Vector<Urho3D::Pair<Urho3D::String, float> >& GetProgressiveTimings() const { return progressiveTimings_; }
+
 	bool IsAcyclic(Urho3D::Vector<int>& top_nbr) const;
 };
\ No newline at end of file
@@ -22,6 +22,8 @@
 
 #include "IoInputSlot.h"
 
+#include <Urho3D/Core/Thread.h>
+
 #include "IoComponentBase.h"
 #include "NetworkUtilities.h"
 
@@ -42,13 +44,18 @@ void IoInputSlot::HardSet(IoDataTree ioDataTree)
 {
 	::mDisconnect(Urho3D::SharedPtr<IoInputSlot>(this));
 	ioDataTree_ = ioDataTree;
-	homeComponent_->solvedFlag_ = 0;
+	homeComponent_->MarkUnsolved();
 }
 
 void IoInputSlot::SoftSet(IoDataTree ioDataTree)
 {
 	ioDataTree_ = ioDataTree;
-	homeComponent_->solvedFlag_ = 0;
+
+	// several workers of the parallel solver may feed the same component,
+	// IoGraph::ParallelSolveLevels resets its flag once they have all finished
+	if (Thread::IsMainThread()) {
+		homeComponent_->MarkUnsolved();
+	}
 }
 
 // Depends on defaultValue_ having been set (or uses default defaultValue_).
@@ -56,14 +63,14 @@ void IoInputSlot::SoftSet(IoDataTree ioDataTree)
 void IoInputSlot::DefaultSet()
 {
 	ioDataTree_ = IoDataTree(GetContext(), defaultValue_);
-	homeComponent_->solvedFlag_ = 0;
+	homeComponent_->MarkUnsolved();
 }
 
 void IoInputSlot::Lose()
 {
 	::mDisconnect(Urho3D::SharedPtr<IoInputSlot>(this));
 	ioDataTree_ = IoDataTree(GetContext(), defaultValue_);
-	homeComponent_->solvedFlag_ = 0;
+	homeComponent_->MarkUnsolved();
 }
 
 IoDataTree* IoInputSlot::GetIoDataTreePtr()
@@ -0,0 +1,578 @@
+//
+// Copyright (c) 2016 - 2017 Mesh Consultants Inc.
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "IoRenderCache.h"
+
+#include <Urho3D/Core/Context.h>
+#include <Urho3D/Graphics/Geometry.h>
+#include <Urho3D/Graphics/IndexBuffer.h>
+#include <Urho3D/Graphics/Material.h>
+#include <Urho3D/Graphics/Model.h>
+#include <Urho3D/Graphics/StaticModel.h>
+#include <Urho3D/Graphics/VertexBuffer.h>
+#include <Urho3D/Resource/ResourceCache.h>
+#include <Urho3D/Resource/ResourceEvents.h>
+#include <Urho3D/Scene/Scene.h>
+
+#include <assert.h>
+#include <string.h>
+
+using namespace Urho3D;
+
+namespace {
+
+// Uploads data into a shadowed vertex buffer, resizing it only when the vertex count changes.
+// The shadow copy is the previous upload, so unchanged streams are skipped.
+// Returns true if anything was uploaded.
+bool UploadVertices(VertexBuffer* vb, const void* data, unsigned numVertices, unsigned elementMask)
+{
+	if (vb->GetVertexCount() != numVertices || vb->GetElementMask() != elementMask)
+	{
+		vb->SetSize(numVertices, elementMask);
+		vb->SetData(data);
+		return true;
+	}
+
+	const unsigned char* shadow = vb->GetShadowData();
+	if (shadow && memcmp(shadow, data, numVertices * vb->GetVertexSize()) == 0)
+	{
+		return false;
+	}
+
+	vb->SetData(data);
+	return true;
+}
+
+template <class T>
+bool UploadIndices(IndexBuffer* ib, const PODVector<T>& indices)
+{
+	bool largeIndices = sizeof(T) == sizeof(unsigned);
+	if (ib->GetIndexCount() != indices.Size() || ib->GetIndexSize() != sizeof(T))
+	{
+		ib->SetSize(indices.Size(), largeIndices);
+		ib->SetData(&indices[0]);
+		return true;
+	}
+
+	const unsigned char* shadow = ib->GetShadowData();
+	if (shadow && memcmp(shadow, &indices[0], indices.Size() * sizeof(T)) == 0)
+	{
+		return false;
+	}
+
+	ib->SetData(&indices[0]);
+	return true;
+}
+
+struct PointVertex
+{
+	Vector3 position_;
+	unsigned color_;
+};
+
+// cells per axis of the grid used to order point clouds
+const unsigned POINT_GRID_SIZE = 32;
+
+// interleaves the bits of a grid cell so that consecutive codes stay spatially close
+unsigned PointCellCode(unsigned x, unsigned y, unsigned z)
+{
+	unsigned code = 0;
+	for (unsigned b = 0; b < 5; ++b)
+	{
+		code |= ((x >> b) & 1) << (3 * b);
+		code |= ((y >> b) & 1) << (3 * b + 1);
+		code |= ((z >> b) & 1) << (3 * b + 2);
+	}
+	return code;
+}
+
+// Orders point indices cell by cell along a Morton curve over a coarse grid, in linear time,
+// so that any run of consecutive points covers a compact region of space.
+void SortPointsSpatially(const PODVector<Vector3>& positions, PODVector<unsigned>& order)
+{
+	unsigned numPoints = positions.Size();
+	BoundingBox box(&positions[0], numPoints);
+	Vector3 extent = box.Size();
+	Vector3 scale(
+		extent.x_ > 0.0f ? POINT_GRID_SIZE / extent.x_ : 0.0f,
+		extent.y_ > 0.0f ? POINT_GRID_SIZE / extent.y_ : 0.0f,
+		extent.z_ > 0.0f ? POINT_GRID_SIZE / extent.z_ : 0.0f
+		);
+
+	unsigned numCells = POINT_GRID_SIZE * POINT_GRID_SIZE * POINT_GRID_SIZE;
+	PODVector<unsigned> cellStart(numCells + 1);
+	for (unsigned i = 0; i <= numCells; ++i)
+	{
+		cellStart[i] = 0;
+	}
+
+	PODVector<unsigned> pointCell(numPoints);
+	for (unsigned i = 0; i < numPoints; ++i)
+	{
+		Vector3 p = (positions[i] - box.min_) * scale;
+		unsigned x = Min((unsigned)Max(p.x_, 0.0f), POINT_GRID_SIZE - 1);
+		unsigned y = Min((unsigned)Max(p.y_, 0.0f), POINT_GRID_SIZE - 1);
+		unsigned z = Min((unsigned)Max(p.z_, 0.0f), POINT_GRID_SIZE - 1);
+		pointCell[i] = PointCellCode(x, y, z);
+		++cellStart[pointCell[i] + 1];
+	}
+
+	for (unsigned i = 0; i < numCells; ++i)
+	{
+		cellStart[i + 1] += cellStart[i];
+	}
+
+	order.Resize(numPoints);
+	for (unsigned i = 0; i < numPoints; ++i)
+	{
+		order[cellStart[pointCell[i]]++] = i;
+	}
+}
+
+void ReleaseNamedResource(Context* context, Resource* resource)
+{
+	if (!context || !resource || resource->GetName().Empty())
+	{
+		return;
+	}
+
+	ResourceCache* rc = context->GetSubsystem<ResourceCache>();
+	if (rc)
+	{
+		// forced: the cached item still holds a reference at this point
+		rc->ReleaseResource(resource->GetType(), resource->GetName(), true);
+	}
+}
+
+} // namespace
+
+IoRenderCache::IoRenderCache(Context* context) :
+	context_(context)
+{
+}
+
+IoRenderCache::~IoRenderCache()
+{
+	Clear();
+}
+
+void IoRenderCache::BeginSolve()
+{
+	for (unsigned i = 0; i < items_.Size(); ++i)
+	{
+		items_[i].used_ = false;
+	}
+}
+
+void IoRenderCache::EndSolve()
+{
+	for (unsigned i = 0; i < items_.Size(); ++i)
+	{
+		if (!items_[i].used_)
+		{
+			RemoveItem(items_[i]);
+		}
+	}
+
+	// compact the items that are still drawn and index their keys again
+	unsigned numUsed = 0;
+	for (unsigned i = 0; i < items_.Size(); ++i)
+	{
+		if (items_[i].used_)
+		{
+			if (numUsed != i)
+			{
+				items_[numUsed] = items_[i];
+			}
+			++numUsed;
+		}
+	}
+	items_.Resize(numUsed);
+
+	itemIndices_.Clear();
+	for (unsigned i = 0; i < items_.Size(); ++i)
+	{
+		itemIndices_[items_[i].key_] = i;
+	}
+}
+
+void IoRenderCache::Clear()
+{
+	for (unsigned i = 0; i < items_.Size(); ++i)
+	{
+		RemoveItem(items_[i]);
+	}
+
+	items_.Clear();
+	itemIndices_.Clear();
+}
+
+unsigned IoRenderCache::FindItem(const Vector<int>& path, unsigned index)
+{
+	String key;
+	for (unsigned i = 0; i < path.Size(); ++i)
+	{
+		key += String(path[i]) + ";";
+	}
+	key += String(index);
+
+	return FindItem(key);
+}
+
+unsigned IoRenderCache::FindItem(const String& key)
+{
+	HashMap<String, unsigned>::ConstIterator it = itemIndices_.Find(key);
+	if (it != itemIndices_.End())
+	{
+		items_[it->second_].used_ = true;
+		return it->second_;
+	}
+
+	unsigned item = items_.Size();
+	items_.Resize(item + 1);
+	items_[item].key_ = key;
+	items_[item].used_ = true;
+	itemIndices_[key] = item;
+
+	return item;
+}
+
+Node* IoRenderCache::GetNode(unsigned item, Scene* scene, const String& name)
+{
+	IoRenderItem& renderItem = GetItem(item);
+
+	if (renderItem.node_ && renderItem.node_->GetScene() != scene)
+	{
+		renderItem.node_->Remove();
+		renderItem.node_.Reset();
+	}
+
+	if (!renderItem.node_ && scene)
+	{
+		renderItem.node_ = scene->CreateChild(name);
+	}
+
+	return renderItem.node_;
+}
+
+StaticModel* IoRenderCache::GetStaticModel(unsigned item, Scene* scene, const String& name)
+{
+	Node* node = GetNode(item, scene, name);
+	if (!node)
+	{
+		return 0;
+	}
+
+	// the item may have been drawn as a point cloud before
+	RemovePointCloud(item);
+
+	return node->GetOrCreateComponent<StaticModel>();
+}
+
+Model* IoRenderCache::UpdateModel(
+	unsigned item,
+	const PODVector<Vector3>& positions,
+	const PODVector<Vector3>& normals,
+	const PODVector<unsigned>& colors,
+	const PODVector<unsigned>& indices
+	)
+{
+	unsigned numVertices = positions.Size();
+	if (numVertices == 0 || indices.Empty() || normals.Size() != numVertices || colors.Size() != numVertices)
+	{
+		return 0;
+	}
+
+	IoRenderItem& renderItem = GetItem(item);
+
+	if (!renderItem.model_)
+	{
+		renderItem.positionBuffer_ = new VertexBuffer(context_);
+		renderItem.colorBuffer_ = new VertexBuffer(context_);
+		renderItem.indexBuffer_ = new IndexBuffer(context_);
+
+		// Shadowed buffers are needed for raycasts and device loss, and hold the previous upload to diff against
+		renderItem.positionBuffer_->SetShadowed(true);
+		renderItem.colorBuffer_->SetShadowed(true);
+		renderItem.indexBuffer_->SetShadowed(true);
+
+		renderItem.geometry_ = new Geometry(context_);
+		renderItem.geometry_->SetNumVertexBuffers(2);
+		renderItem.geometry_->SetVertexBuffer(0, renderItem.positionBuffer_);
+		renderItem.geometry_->SetVertexBuffer(1, renderItem.colorBuffer_);
+		renderItem.geometry_->SetIndexBuffer(renderItem.indexBuffer_);
+
+		renderItem.model_ = new Model(context_);
+		renderItem.model_->SetNumGeometries(1);
+		renderItem.model_->SetGeometry(0, 0, renderItem.geometry_);
+		renderItem.model_->SetGeometryCenter(0, Vector3::ZERO);
+
+		Vector<SharedPtr<VertexBuffer> > allVBuffers;
+		Vector<SharedPtr<IndexBuffer> > allIBuffers;
+		allVBuffers.Push(renderItem.positionBuffer_);
+		allVBuffers.Push(renderItem.colorBuffer_);
+		allIBuffers.Push(renderItem.indexBuffer_);
+
+		PODVector<unsigned int> morphStarts;
+		PODVector<unsigned int> morphRanges;
+		renderItem.model_->SetVertexBuffers(allVBuffers, morphStarts, morphRanges);
+		renderItem.model_->SetIndexBuffers(allIBuffers);
+	}
+
+	PODVector<Vector3> positionData(2 * numVertices);
+	for (unsigned i = 0; i < numVertices; ++i)
+	{
+		positionData[2 * i] = positions[i];
+		positionData[2 * i + 1] = normals[i];
+	}
+
+	bool positionsChanged = UploadVertices(renderItem.positionBuffer_, &positionData[0], numVertices, MASK_POSITION | MASK_NORMAL);
+	UploadVertices(renderItem.colorBuffer_, &colors[0], numVertices, MASK_COLOR);
+
+	bool indicesChanged;
+	if (numVertices <= 65536)
+	{
+		PODVector<unsigned short> shortIndices(indices.Size());
+		for (unsigned i = 0; i < indices.Size(); ++i)
+		{
+			shortIndices[i] = (unsigned short)indices[i];
+		}
+		indicesChanged = UploadIndices(renderItem.indexBuffer_, shortIndices);
+	}
+	else
+	{
+		indicesChanged = UploadIndices(renderItem.indexBuffer_, indices);
+	}
+
+	if (indicesChanged || positionsChanged)
+	{
+		renderItem.geometry_->SetDrawRange(TRIANGLE_LIST, 0, indices.Size(), 0, numVertices);
+	}
+
+	if (positionsChanged)
+	{
+		BoundingBox box(&positions[0], numVertices);
+		if (box != renderItem.model_->GetBoundingBox())
+		{
+			renderItem.model_->SetBoundingBox(box);
+
+			// StaticModel copies the bounds when the model is assigned; this is how it gets told to copy them again
+			renderItem.model_->SendEvent(E_RELOADFINISHED);
+		}
+	}
+
+	return renderItem.model_;
+}
+
+Node* IoRenderCache::UpdatePointCloud(
+	unsigned item,
+	Scene* scene,
+	const String& name,
+	const PODVector<Vector3>& positions,
+	const PODVector<unsigned>& colors,
+	Material* material,
+	unsigned maxChunkSize
+	)
+{
+	Node* node = GetNode(item, scene, name);
+	if (!node || positions.Empty() || maxChunkSize == 0)
+	{
+		return node;
+	}
+
+	IoRenderItem& renderItem = GetItem(item);
+
+	// the item may have been drawn as a mesh before
+	if (renderItem.model_)
+	{
+		PODVector<StaticModel*> drawables;
+		node->GetComponents<StaticModel>(drawables);
+		for (unsigned i = 0; i < drawables.Size(); ++i)
+		{
+			if (drawables[i]->GetModel() == renderItem.model_.Get())
+			{
+				node->RemoveComponent(drawables[i]);
+			}
+		}
+
+		ReleaseNamedResource(context_, renderItem.model_);
+		renderItem.model_.Reset();
+		renderItem.geometry_.Reset();
+		renderItem.positionBuffer_.Reset();
+		renderItem.colorBuffer_.Reset();
+		renderItem.indexBuffer_.Reset();
+	}
+
+	PODVector<unsigned> order;
+	SortPointsSpatially(positions, order);
+
+	unsigned numPoints = positions.Size();
+	unsigned numChunks = (numPoints + maxChunkSize - 1) / maxChunkSize;
+	for (unsigned i = numChunks; i < renderItem.chunks_.Size(); ++i)
+	{
+		if (renderItem.chunks_[i].drawable_)
+		{
+			renderItem.chunks_[i].drawable_->Remove();
+		}
+	}
+	renderItem.chunks_.Resize(numChunks);
+
+	unsigned defaultColor = Color::WHITE.ToUInt();
+	PODVector<PointVertex> vertexData;
+	for (unsigned c = 0; c < numChunks; ++c)
+	{
+		unsigned start = c * maxChunkSize;
+		unsigned count = Min(maxChunkSize, numPoints - start);
+
+		vertexData.Resize(count);
+		BoundingBox box;
+		for (unsigned k = 0; k < count; ++k)
+		{
+			unsigned index = order[start + k];
+			vertexData[k].position_ = positions[index];
+			vertexData[k].color_ = colors.Empty() ? defaultColor : colors[index % colors.Size()];
+			box.Merge(positions[index]);
+		}
+
+		IoRenderChunk& chunk = renderItem.chunks_[c];
+		if (!chunk.model_)
+		{
+			// not shadowed: a point cloud is not raycast and a CPU copy of millions of points is not worth keeping
+			chunk.vertexBuffer_ = new VertexBuffer(context_);
+
+			chunk.geometry_ = new Geometry(context_);
+			chunk.geometry_->SetNumVertexBuffers(1);
+			chunk.geometry_->SetVertexBuffer(0, chunk.vertexBuffer_);
+
+			chunk.model_ = new Model(context_);
+			chunk.model_->SetNumGeometries(1);
+			chunk.model_->SetGeometry(0, 0, chunk.geometry_);
+			chunk.model_->SetGeometryCenter(0, Vector3::ZERO);
+
+			Vector<SharedPtr<VertexBuffer> > allVBuffers;
+			Vector<SharedPtr<IndexBuffer> > allIBuffers;
+			allVBuffers.Push(chunk.vertexBuffer_);
+
+			PODVector<unsigned int> morphStarts;
+			PODVector<unsigned int> morphRanges;
+			chunk.model_->SetVertexBuffers(allVBuffers, morphStarts, morphRanges);
+			chunk.model_->SetIndexBuffers(allIBuffers);
+		}
+
+		UploadVertices(chunk.vertexBuffer_, &vertexData[0], count, MASK_POSITION | MASK_COLOR);
+		chunk.geometry_->SetDrawRange(POINT_LIST, 0, 0, 0, count);
+
+		if (box != chunk.model_->GetBoundingBox())
+		{
+			chunk.model_->SetBoundingBox(box);
+			chunk.model_->SendEvent(E_RELOADFINISHED);
+		}
+
+		if (!chunk.drawable_ || chunk.drawable_->GetNode() != node)
+		{
+			chunk.drawable_ = node->CreateComponent<StaticModel>();
+			chunk.drawable_->SetModel(chunk.model_);
+		}
+		chunk.drawable_->SetMaterial(material);
+	}
+
+	return node;
+}
+
+void IoRenderCache::RemovePointCloud(unsigned item)
+{
+	if (item >= items_.Size())
+	{
+		return;
+	}
+
+	IoRenderItem& renderItem = items_[item];
+	for (unsigned i = 0; i < renderItem.chunks_.Size(); ++i)
+	{
+		if (renderItem.chunks_[i].drawable_)
+		{
+			renderItem.chunks_[i].drawable_->Remove();
+		}
+	}
+	renderItem.chunks_.Clear();
+}
+
+Material* IoRenderCache::GetMaterial(unsigned item, Material* source)
+{
+	if (!source)
+	{
+		return 0;
+	}
+
+	IoRenderItem& renderItem = GetItem(item);
+	if (!renderItem.material_ || renderItem.materialSource_ != source->GetName())
+	{
+		ReleaseNamedResource(context_, renderItem.material_);
+		renderItem.material_ = source->Clone();
+		renderItem.materialSource_ = source->GetName();
+	}
+	else
+	{
+		// callers tint the clone, undo last solve's tint the way a fresh clone would
+		const HashMap<StringHash, MaterialShaderParameter>& parameters = source->GetShaderParameters();
+		for (HashMap<StringHash, MaterialShaderParameter>::ConstIterator it = parameters.Begin(); it != parameters.End(); ++it)
+		{
+			renderItem.material_->SetShaderParameter(it->second_.name_, it->second_.value_);
+		}
+		renderItem.material_->SetFillMode(source->GetFillMode());
+	}
+
+	return renderItem.material_;
+}
+
+Model* IoRenderCache::GetModelSnapshot(unsigned item)
+{
+	IoRenderItem& renderItem = GetItem(item);
+	if (!renderItem.model_)
+	{
+		return 0;
+	}
+
+	renderItem.snapshot_ = renderItem.model_->Clone();
+	return renderItem.snapshot_;
+}
+
+IoRenderItem& IoRenderCache::GetItem(unsigned item)
+{
+	assert(item < items_.Size());
+
+	items_[item].used_ = true;
+	return items_[item];
+}
+
+void IoRenderCache::RemoveItem(IoRenderItem& renderItem)
+{
+	if (renderItem.node_)
+	{
+		renderItem.node_->Remove();
+	}
+
+	ReleaseNamedResource(context_, renderItem.model_);
+	ReleaseNamedResource(context_, renderItem.material_);
+
+	renderItem = IoRenderItem();
+}
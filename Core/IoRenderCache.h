@@ -0,0 +1,148 @@
+//
+// Copyright (c) 2016 - 2017 Mesh Consultants Inc.
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include <Urho3D/Container/HashMap.h>
+#include <Urho3D/Container/Ptr.h>
+#include <Urho3D/Container/Str.h>
+#include <Urho3D/Container/Vector.h>
+#include <Urho3D/Math/Vector3.h>
+
+namespace Urho3D
+{
+class Context;
+class Geometry;
+class IndexBuffer;
+class Material;
+class Model;
+class Node;
+class Scene;
+class StaticModel;
+class VertexBuffer;
+}
+
+///point counts above this are drawn as a point list rather than one sprite per point
+static const unsigned IO_MAX_BILLBOARD_POINTS = 16000;
+
+///one spatially coherent piece of a point cloud, drawn and culled as its own StaticModel
+struct IoRenderChunk
+{
+	Urho3D::SharedPtr<Urho3D::Model> model_;
+	Urho3D::SharedPtr<Urho3D::Geometry> geometry_;
+	Urho3D::SharedPtr<Urho3D::VertexBuffer> vertexBuffer_;
+	Urho3D::WeakPtr<Urho3D::StaticModel> drawable_;
+};
+
+///one cached preview item: a scene node plus the model, buffers and material drawn on it
+struct IoRenderItem
+{
+	IoRenderItem() : used_(false) {}
+
+	Urho3D::WeakPtr<Urho3D::Node> node_;
+	Urho3D::SharedPtr<Urho3D::Model> model_;
+	Urho3D::SharedPtr<Urho3D::Geometry> geometry_;
+	///positions and normals, interleaved
+	Urho3D::SharedPtr<Urho3D::VertexBuffer> positionBuffer_;
+	///vertex colors, kept in their own stream so a color change does not re-upload positions
+	Urho3D::SharedPtr<Urho3D::VertexBuffer> colorBuffer_;
+	Urho3D::SharedPtr<Urho3D::IndexBuffer> indexBuffer_;
+	Urho3D::Vector<IoRenderChunk> chunks_;
+	Urho3D::SharedPtr<Urho3D::Material> material_;
+	Urho3D::String materialSource_;
+	///copy of model_ handed out on an output, left alone by later solves
+	Urho3D::SharedPtr<Urho3D::Model> snapshot_;
+	///identity of the data drawn by this item, see IoRenderCache::FindItem
+	Urho3D::String key_;
+	bool used_;
+};
+
+///Preview nodes and GPU buffers of one component, kept alive across solves.
+///Items are keyed by the output path and index of the data they draw: an item of a solve reuses the node,
+///StaticModel, buffers and material of the item with the same key in the previous solve, so inserting or
+///removing an item upstream does not shift every later item onto another item's buffers. Buffers are only
+///resized when vertex or index counts change and only the streams whose contents differ are uploaded,
+///so redrawing during a slider drag costs what actually changed rather than a full rebuild.
+class IoRenderCache
+{
+public:
+	IoRenderCache(Urho3D::Context* context);
+	~IoRenderCache();
+
+	///starts a solve: all items are marked unused
+	void BeginSolve();
+	///ends a solve: nodes of items not used since BeginSolve are removed from the scene
+	void EndSolve();
+	///removes all nodes and releases all buffers
+	void Clear();
+
+	///item drawing the data at index of the output branch path, the same item every solve
+	unsigned FindItem(const Urho3D::Vector<int>& path, unsigned index);
+	///item with an arbitrary key, for data that is not drawn one item per SolveInstance call
+	unsigned FindItem(const Urho3D::String& key);
+
+	///node of an item, created as a child of scene on first use or when the scene has changed
+	Urho3D::Node* GetNode(unsigned item, Urho3D::Scene* scene, const Urho3D::String& name);
+	///StaticModel component on the node of an item
+	Urho3D::StaticModel* GetStaticModel(unsigned item, Urho3D::Scene* scene, const Urho3D::String& name);
+
+	///writes triangle list data into the model of an item and returns it
+	///normals and colors must have one entry per position; indices use 16 bits whenever the vertex count allows
+	Urho3D::Model* UpdateModel(
+		unsigned item,
+		const Urho3D::PODVector<Urho3D::Vector3>& positions,
+		const Urho3D::PODVector<Urho3D::Vector3>& normals,
+		const Urho3D::PODVector<unsigned>& colors,
+		const Urho3D::PODVector<unsigned>& indices
+		);
+
+	///writes a point list into the node of an item, split into spatially coherent chunks of at most maxChunkSize points
+	///each chunk is its own StaticModel so chunks outside the view are culled; colors are cycled if shorter than positions
+	Urho3D::Node* UpdatePointCloud(
+		unsigned item,
+		Urho3D::Scene* scene,
+		const Urho3D::String& name,
+		const Urho3D::PODVector<Urho3D::Vector3>& positions,
+		const Urho3D::PODVector<unsigned>& colors,
+		Urho3D::Material* material,
+		unsigned maxChunkSize = 262144
+		);
+	///removes the point cloud chunks of an item, leaving its node in place
+	void RemovePointCloud(unsigned item);
+
+	///private clone of source for an item, re-cloned only when source changes
+	///its shader parameters are reset from source on every call, so each solve starts from the source material
+	Urho3D::Material* GetMaterial(unsigned item, Urho3D::Material* source);
+
+	///copy of the model of an item that later solves do not modify, held until the next snapshot or until the item is removed
+	Urho3D::Model* GetModelSnapshot(unsigned item);
+
+	unsigned GetNumItems() const { return items_.Size(); }
+
+private:
+	IoRenderItem& GetItem(unsigned item);
+	void RemoveItem(IoRenderItem& renderItem);
+
+	Urho3D::WeakPtr<Urho3D::Context> context_;
+	Urho3D::Vector<IoRenderItem> items_;
+	Urho3D::HashMap<Urho3D::String, unsigned> itemIndices_;
+};
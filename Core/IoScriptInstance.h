@@ -114,6 +114,9 @@ public:
 
 	void SolveInstance(const Urho3D::Vector<Urho3D::Variant>& inSolveInstance, Urho3D::Vector<Urho3D::Variant>& outSolveInstance);
 
+	/// Scripts may drive the scene or UI, solve them with the visible branches.
+	bool IsVisibleOutput() const { return true; }
+
 private:
 	/// (Re)create the script object and check for supported methods if successfully created.
 	void CreateObject();
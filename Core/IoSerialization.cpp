@@ -22,7 +22,18 @@
 
 #include "IoSerialization.h"
 #include "IoScriptInstance.h"
+#include <Urho3D/Core/StringUtils.h>
+#include <Urho3D/Core/Timer.h>
+#include <Urho3D/Core/WorkQueue.h>
 #include <Urho3D/IO/File.h>
+#include <Urho3D/IO/Compression.h>
+#include <Urho3D/IO/MemoryBuffer.h>
+#include <Urho3D/IO/VectorBuffer.h>
+#include <Urho3D/IO/Log.h>
+#include <Urho3D/Resource/JSONFile.h>
+#include <Urho3D/Resource/ResourceCache.h>
+
+#include <memory>
 
 using namespace Urho3D;
 
@@ -31,11 +42,590 @@ using namespace Urho3D;
 
 Urho3D::Context* IoSerialization::context_;
 IoGraph* IoSerialization::currentGraph_;
+Vector<Pair<String, float> > IoSerialization::loadTimings_;
 
 /////////////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////////////
 
-void IoSerialization::SaveGraph(IoGraph const & graph, String path)
+namespace
+{
+	const char* GRAPH_FILE_ID = "IOGB";
+	const char* DATA_FILE_ID = "IODB";
+	//2: packed arrays of meshes are stored as TAG_PACKED_ARRAY
+	const unsigned char BINARY_VERSION = 2;
+
+	//container flags
+	const unsigned char BINARY_COMPRESSED = 1;
+
+	//item tags, plain items are written with Serializer::WriteVariant
+	enum BinaryTag
+	{
+		TAG_VARIANT = 0,
+		TAG_VARIANTVECTOR,
+		TAG_VARIANTMAP,
+		TAG_PACKED,
+		TAG_PACKED_ARRAY
+	};
+
+	//same type as TriMeshPackedArray in Geometry/TriMesh.h, which Core does not include:
+	//raw bytes held by a custom Variant, written as they are
+	typedef std::shared_ptr<const PODVector<unsigned char> > PackedArray;
+
+	//json type name of packed arrays, written as the byte string of Urho3D::BufferToString
+	const char* JSON_PACKED_ARRAY = "PackedArray";
+
+	unsigned RemainingBytes(Deserializer& source)
+	{
+		return source.GetSize() - source.GetPosition();
+	}
+
+	bool HasFileID(Deserializer& source, const String& fileID)
+	{
+		unsigned start = source.GetPosition();
+		if (RemainingBytes(source) < 4)
+			return false;
+
+		bool found = source.ReadFileID() == fileID;
+		source.Seek(start);
+
+		return found;
+	}
+
+	//file ID, version, flags, payload size, stored size, stored bytes
+	void WriteContainer(Serializer& dest, const String& fileID, const VectorBuffer& payload, bool compress)
+	{
+		unsigned size = payload.GetSize();
+		compress = compress && size > 0;
+
+		dest.WriteFileID(fileID);
+		dest.WriteUByte(BINARY_VERSION);
+		dest.WriteUByte(compress ? BINARY_COMPRESSED : 0);
+		dest.WriteUInt(size);
+
+		if (compress)
+		{
+			PODVector<unsigned char> packed(EstimateCompressBound(size));
+			unsigned packedSize = CompressData(&packed[0], payload.GetData(), size);
+			dest.WriteUInt(packedSize);
+			dest.Write(&packed[0], packedSize);
+		}
+		else
+		{
+			dest.WriteUInt(size);
+			if (size > 0)
+				dest.Write(payload.GetData(), size);
+		}
+	}
+
+	bool ReadContainer(Deserializer& source, const String& fileID, PODVector<unsigned char>& payload)
+	{
+		if (RemainingBytes(source) < 14 || source.ReadFileID() != fileID)
+			return false;
+
+		unsigned char version = source.ReadUByte();
+		unsigned char flags = source.ReadUByte();
+		unsigned size = source.ReadUInt();
+		unsigned storedSize = source.ReadUInt();
+
+		if (version > BINARY_VERSION)
+		{
+			URHO3D_LOGERROR("IoSerialization --- file was written by a newer version, format " + String((unsigned)version));
+			return false;
+		}
+
+		if (storedSize > RemainingBytes(source))
+		{
+			URHO3D_LOGERROR("IoSerialization --- truncated file");
+			return false;
+		}
+
+		payload.Resize(size);
+		if (flags & BINARY_COMPRESSED)
+		{
+			PODVector<unsigned char> packed(storedSize);
+			if (storedSize > 0)
+				source.Read(&packed[0], storedSize);
+			if (size == 0 || DecompressData(&payload[0], &packed[0], size) != storedSize)
+			{
+				URHO3D_LOGERROR("IoSerialization --- could not decompress file");
+				return false;
+			}
+		}
+		else
+		{
+			if (storedSize != size)
+				return false;
+			if (size > 0)
+				source.Read(&payload[0], size);
+		}
+
+		return true;
+	}
+
+	unsigned PackedItemSize(VariantType type)
+	{
+		switch (type)
+		{
+		case VAR_INT:
+			return sizeof(int);
+		case VAR_FLOAT:
+			return sizeof(float);
+		case VAR_DOUBLE:
+			return sizeof(double);
+		case VAR_VECTOR2:
+			return sizeof(Vector2);
+		case VAR_VECTOR3:
+			return sizeof(Vector3);
+		case VAR_VECTOR4:
+			return sizeof(Vector4);
+		case VAR_QUATERNION:
+			return sizeof(Quaternion);
+		case VAR_COLOR:
+			return sizeof(Color);
+		case VAR_INTVECTOR2:
+			return sizeof(IntVector2);
+		default:
+			return 0;
+		}
+	}
+
+	//type shared by all items if it can be stored as a raw array, VAR_NONE otherwise
+	VariantType PackedType(const VariantVector& items)
+	{
+		if (items.Size() < 2)
+			return VAR_NONE;
+
+		VariantType type = items[0].GetType();
+		if (PackedItemSize(type) == 0)
+			return VAR_NONE;
+
+		for (unsigned i = 1; i < items.Size(); i++)
+		{
+			if (items[i].GetType() != type)
+				return VAR_NONE;
+		}
+
+		return type;
+	}
+
+	template <class T> void WritePackedItems(const VariantVector& items, Serializer& dest)
+	{
+		PODVector<T> values(items.Size());
+		for (unsigned i = 0; i < items.Size(); i++)
+		{
+			values[i] = items[i].Get<T>();
+		}
+
+		dest.Write(&values[0], values.Size() * sizeof(T));
+	}
+
+	template <class T> bool ReadPackedItems(Deserializer& source, unsigned count, VariantVector& items)
+	{
+		if (count > RemainingBytes(source) / sizeof(T))
+			return false;
+
+		PODVector<T> values(count);
+		if (count > 0)
+			source.Read(&values[0], count * sizeof(T));
+
+		items.Resize(count);
+		for (unsigned i = 0; i < count; i++)
+		{
+			items[i] = values[i];
+		}
+
+		return true;
+	}
+
+	void WriteBinaryVariant(const Variant& var, Serializer& dest);
+
+	void WriteBinaryVector(const VariantVector& items, Serializer& dest)
+	{
+		VariantType type = PackedType(items);
+		if (type == VAR_NONE)
+		{
+			dest.WriteUByte(TAG_VARIANTVECTOR);
+			dest.WriteVLE(items.Size());
+			for (unsigned i = 0; i < items.Size(); i++)
+			{
+				WriteBinaryVariant(items[i], dest);
+			}
+			return;
+		}
+
+		dest.WriteUByte(TAG_PACKED);
+		dest.WriteUByte((unsigned char)type);
+		dest.WriteVLE(items.Size());
+
+		switch (type)
+		{
+		case VAR_INT:
+			WritePackedItems<int>(items, dest);
+			break;
+		case VAR_FLOAT:
+			WritePackedItems<float>(items, dest);
+			break;
+		case VAR_DOUBLE:
+			WritePackedItems<double>(items, dest);
+			break;
+		case VAR_VECTOR2:
+			WritePackedItems<Vector2>(items, dest);
+			break;
+		case VAR_VECTOR3:
+			WritePackedItems<Vector3>(items, dest);
+			break;
+		case VAR_VECTOR4:
+			WritePackedItems<Vector4>(items, dest);
+			break;
+		case VAR_QUATERNION:
+			WritePackedItems<Quaternion>(items, dest);
+			break;
+		case VAR_COLOR:
+			WritePackedItems<Color>(items, dest);
+			break;
+		case VAR_INTVECTOR2:
+			WritePackedItems<IntVector2>(items, dest);
+			break;
+		default:
+			break;
+		}
+	}
+
+	void WriteBinaryVariant(const Variant& var, Serializer& dest)
+	{
+		switch (var.GetType())
+		{
+		case VAR_VARIANTVECTOR:
+			WriteBinaryVector(var.GetVariantVector(), dest);
+			break;
+		case VAR_VARIANTMAP:
+		{
+			const VariantMap& map = var.GetVariantMap();
+			dest.WriteUByte(TAG_VARIANTMAP);
+			dest.WriteVLE(map.Size());
+			for (VariantMap::ConstIterator itr = map.Begin(); itr != map.End(); itr++)
+			{
+				dest.WriteStringHash(itr->first_);
+				WriteBinaryVariant(itr->second_, dest);
+			}
+			break;
+		}
+		case VAR_VOIDPTR:
+		case VAR_PTR:
+			//pointers do not survive a save, store an empty item to keep indices intact
+			dest.WriteUByte(TAG_VARIANT);
+			dest.WriteVariant(Variant::EMPTY);
+			break;
+		case VAR_CUSTOM_HEAP:
+		case VAR_CUSTOM_STACK:
+			if (var.IsCustomType<PackedArray>())
+			{
+				const PackedArray& array = var.GetCustom<PackedArray>();
+				unsigned size = array ? array->Size() : 0;
+				dest.WriteUByte(TAG_PACKED_ARRAY);
+				dest.WriteVLE(size);
+				if (size > 0)
+					dest.Write(&array->Front(), size);
+			}
+			else
+			{
+				//other custom values are handles to derived data (bvh, adjacency), rebuilt on demand like pointers
+				dest.WriteUByte(TAG_VARIANT);
+				dest.WriteVariant(Variant::EMPTY);
+			}
+			break;
+		default:
+			dest.WriteUByte(TAG_VARIANT);
+			dest.WriteVariant(var);
+			break;
+		}
+	}
+
+	bool ReadBinaryVariant(Deserializer& source, Variant& var);
+
+	//reads the body of a TAG_VARIANTVECTOR or TAG_PACKED item
+	bool ReadBinaryVector(Deserializer& source, unsigned char tag, VariantVector& items)
+	{
+		if (tag == TAG_VARIANTVECTOR)
+		{
+			unsigned count = source.ReadVLE();
+			if (count > RemainingBytes(source))
+				return false;
+
+			items.Resize(count);
+			for (unsigned i = 0; i < count; i++)
+			{
+				if (!ReadBinaryVariant(source, items[i]))
+					return false;
+			}
+			return true;
+		}
+
+		if (tag != TAG_PACKED)
+			return false;
+
+		VariantType type = (VariantType)source.ReadUByte();
+		unsigned count = source.ReadVLE();
+
+		switch (type)
+		{
+		case VAR_INT:
+			return ReadPackedItems<int>(source, count, items);
+		case VAR_FLOAT:
+			return ReadPackedItems<float>(source, count, items);
+		case VAR_DOUBLE:
+			return ReadPackedItems<double>(source, count, items);
+		case VAR_VECTOR2:
+			return ReadPackedItems<Vector2>(source, count, items);
+		case VAR_VECTOR3:
+			return ReadPackedItems<Vector3>(source, count, items);
+		case VAR_VECTOR4:
+			return ReadPackedItems<Vector4>(source, count, items);
+		case VAR_QUATERNION:
+			return ReadPackedItems<Quaternion>(source, count, items);
+		case VAR_COLOR:
+			return ReadPackedItems<Color>(source, count, items);
+		case VAR_INTVECTOR2:
+			return ReadPackedItems<IntVector2>(source, count, items);
+		default:
+			return false;
+		}
+	}
+
+	bool ReadBinaryVariant(Deserializer& source, Variant& var)
+	{
+		if (source.IsEof())
+			return false;
+
+		unsigned char tag = source.ReadUByte();
+		switch (tag)
+		{
+		case TAG_VARIANT:
+			var = source.ReadVariant();
+			return true;
+		case TAG_VARIANTVECTOR:
+		case TAG_PACKED:
+		{
+			VariantVector items;
+			if (!ReadBinaryVector(source, tag, items))
+				return false;
+			var = items;
+			return true;
+		}
+		case TAG_VARIANTMAP:
+		{
+			unsigned count = source.ReadVLE();
+			if (count > RemainingBytes(source))
+				return false;
+
+			VariantMap map;
+			for (unsigned i = 0; i < count; i++)
+			{
+				StringHash key = source.ReadStringHash();
+				if (!ReadBinaryVariant(source, map[key]))
+					return false;
+			}
+			var = map;
+			return true;
+		}
+		case TAG_PACKED_ARRAY:
+		{
+			unsigned size = source.ReadVLE();
+			if (size > RemainingBytes(source))
+				return false;
+
+			std::shared_ptr<PODVector<unsigned char> > array = std::make_shared<PODVector<unsigned char> >(size);
+			if (size > 0)
+				source.Read(&array->Front(), size);
+			var.SetCustom<PackedArray>(array);
+			return true;
+		}
+		default:
+			return false;
+		}
+	}
+
+	//the json fallback nests vectors and maps instead of flattening them through ToString
+	JSONValue VariantToJSON(const Variant& var)
+	{
+		JSONValue varVal;
+
+		if (var.GetType() == VAR_CUSTOM_HEAP || var.GetType() == VAR_CUSTOM_STACK)
+		{
+			if (!var.IsCustomType<PackedArray>())
+			{
+				//handles are written as empty items, as in WriteBinaryVariant
+				return VariantToJSON(Variant::EMPTY);
+			}
+
+			const PackedArray& array = var.GetCustom<PackedArray>();
+			String bytes;
+			if (array && !array->Empty())
+				BufferToString(bytes, &array->Front(), array->Size());
+
+			varVal.Set("var_type", JSON_PACKED_ARRAY);
+			varVal.Set("var_value", bytes);
+			return varVal;
+		}
+
+		varVal.Set("var_type", var.GetTypeName());
+
+		if (var.GetType() == VAR_VARIANTVECTOR)
+		{
+			const VariantVector& items = var.GetVariantVector();
+			JSONArray itemArr;
+			for (unsigned i = 0; i < items.Size(); i++)
+			{
+				itemArr.Push(VariantToJSON(items[i]));
+			}
+			varVal.Set("var_items", itemArr);
+		}
+		else if (var.GetType() == VAR_VARIANTMAP)
+		{
+			const VariantMap& map = var.GetVariantMap();
+			JSONArray itemArr;
+			for (VariantMap::ConstIterator itr = map.Begin(); itr != map.End(); itr++)
+			{
+				JSONValue itemVal = VariantToJSON(itr->second_);
+				itemVal.Set("var_key", itr->first_.Value());
+				itemArr.Push(itemVal);
+			}
+			varVal.Set("var_items", itemArr);
+		}
+		else
+		{
+			varVal.Set("var_value", var.ToString());
+		}
+
+		return varVal;
+	}
+
+	Variant VariantFromJSON(const JSONValue& varVal)
+	{
+		String type = varVal["var_type"].GetString();
+
+		if (type == Variant::GetTypeName(VAR_VARIANTVECTOR))
+		{
+			const JSONArray& itemArr = varVal["var_items"].GetArray();
+			VariantVector items(itemArr.Size());
+			for (unsigned i = 0; i < itemArr.Size(); i++)
+			{
+				items[i] = VariantFromJSON(itemArr[i]);
+			}
+			return items;
+		}
+		else if (type == Variant::GetTypeName(VAR_VARIANTMAP))
+		{
+			const JSONArray& itemArr = varVal["var_items"].GetArray();
+			VariantMap map;
+			for (unsigned i = 0; i < itemArr.Size(); i++)
+			{
+				map[StringHash(itemArr[i]["var_key"].GetUInt())] = VariantFromJSON(itemArr[i]);
+			}
+			return map;
+		}
+		else if (type == JSON_PACKED_ARRAY)
+		{
+			std::shared_ptr<PODVector<unsigned char> > array = std::make_shared<PODVector<unsigned char> >();
+			StringToBuffer(*array, varVal["var_value"].GetString());
+			Variant var;
+			var.SetCustom<PackedArray>(array);
+			return var;
+		}
+
+		return Variant(type, varVal["var_value"].GetString());
+	}
+
+	//graph payload: structure json, then the length-prefixed input tree blocks it refers to by index
+	bool ReadGraphPayload(const PODVector<unsigned char>& payload, JSONFile& json, Vector<Pair<unsigned, unsigned> >& treeBlocks)
+	{
+		if (payload.Size() < 4)
+			return false;
+
+		MemoryBuffer buffer(&payload[0], payload.Size());
+		unsigned jsonSize = buffer.ReadUInt();
+		if (jsonSize > RemainingBytes(buffer))
+			return false;
+
+		MemoryBuffer jsonBuffer(&payload[buffer.GetPosition()], jsonSize);
+		if (!json.Load(jsonBuffer))
+			return false;
+
+		buffer.Seek(buffer.GetPosition() + jsonSize);
+		unsigned numBlocks = buffer.ReadVLE();
+		for (unsigned i = 0; i < numBlocks; i++)
+		{
+			unsigned blockSize = buffer.ReadUInt();
+			unsigned offset = buffer.GetPosition();
+			if (blockSize > RemainingBytes(buffer))
+				return false;
+
+			treeBlocks.Push(Pair<unsigned, unsigned>(offset, blockSize));
+			buffer.Seek(offset + blockSize);
+		}
+
+		return true;
+	}
+
+	//an unlinked input whose tree is decoded off the main thread
+	struct InputTreeJob
+	{
+		SharedPtr<IoDataTree> tree;
+		//json tree, or null for a binary block
+		const JSONValue* treeVal;
+		const unsigned char* data;
+		unsigned size;
+		bool failed;
+	};
+
+	void DecodeInputTreeWork(const WorkItem* item, unsigned threadIndex)
+	{
+		InputTreeJob* job = static_cast<InputTreeJob*>(item->start_);
+		if (job->treeVal)
+		{
+			IoSerialization::LoadDataTree(*job->tree, *job->treeVal);
+		}
+		else if (job->data)
+		{
+			MemoryBuffer blockBuffer(job->data, job->size);
+			job->failed = !IoSerialization::LoadDataTree(*job->tree, blockBuffer);
+		}
+	}
+
+	//start reading the script files of script components in the background,
+	//so they are ready by the time the components are constructed and only compilation is left
+	void PrefetchScripts(Context* context, const JSONArray& compArray)
+	{
+		ResourceCache* cache = context->GetSubsystem<ResourceCache>();
+		if (!cache)
+			return;
+
+		for (unsigned i = 0; i < compArray.Size(); i++)
+		{
+			const JSONValue& metaVal = compArray[i].Get("metadata");
+			const JSONValue& loadVal = metaVal.Get("LoadScript");
+			if (loadVal.IsNull())
+				continue;
+
+			Variant loadScript(loadVal.Get("type").GetString(), loadVal.Get("value").GetString());
+			String scriptPath = metaVal.Get("ScriptPath").Get("value").GetString();
+			if (loadScript.GetBool() && !scriptPath.Empty())
+			{
+				cache->BackgroundLoadResource<ScriptFile>(scriptPath);
+			}
+		}
+	}
+
+	void PushLoadTiming(Vector<Pair<String, float> >& timings, const String& phase, HiresTimer& timer)
+	{
+		timings.Push(MakePair(phase, timer.GetUSec(true) / 1000.0f));
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////
+
+void IoSerialization::SaveGraph(IoGraph const & graph, String path, IoFileFormat format)
 {
 	//track the context
 	context_ = graph.GetContext();
@@ -54,6 +644,10 @@ void IoSerialization::SaveGraph(IoGraph const & graph, String path)
 	JSONValue compVal;
 	JSONArray compArray;
 
+	//binary formats keep input trees out of the json
+	VectorBuffer treeBlocks;
+	unsigned numTreeBlocks = 0;
+
 	for (unsigned i = 0; i < graph.components_.Size(); i++)
 	{
 		SharedPtr<IoComponentBase> node = graph.components_[i];
@@ -105,10 +699,22 @@ void IoSerialization::SaveGraph(IoGraph const & graph, String path)
 				slotVal.Set("linked_slot_index", -1);
 
 				//store input data tree
-				JSONValue treeVal;
-				SaveDataTree(slot->ioDataTree_, treeVal);
+				if (format == FORMAT_JSON)
+				{
+					JSONValue treeVal;
+					SaveDataTree(slot->ioDataTree_, treeVal);
+
+					slotVal.Set("input_tree", treeVal);
+				}
+				else
+				{
+					VectorBuffer block;
+					SaveDataTree(slot->ioDataTree_, block);
+					treeBlocks.WriteUInt(block.GetSize());
+					treeBlocks.Write(block.GetData(), block.GetSize());
 
-				slotVal.Set("input_tree", treeVal);
+					slotVal.Set("input_tree_block", numTreeBlocks++);
+				}
 			}
 
 			//push to array
@@ -163,11 +769,30 @@ void IoSerialization::SaveGraph(IoGraph const & graph, String path)
 	//push the component array to the root
 	graphVal.Set("components", compArray);
 
+	//graph settings
+	graphVal.Set("parallel_solve", graph.IsParallelSolve());
+
 	//push the graph to the root object
 	rootElem.Set("graph", graphVal);
 
-	//write to json file
-	json->Save(*dest, "\t");
+	if (format == FORMAT_JSON)
+	{
+		//write to json file
+		json->Save(*dest, "\t");
+	}
+	else
+	{
+		VectorBuffer structure;
+		json->Save(structure, "");
+
+		VectorBuffer payload;
+		payload.WriteUInt(structure.GetSize());
+		payload.Write(structure.GetData(), structure.GetSize());
+		payload.WriteVLE(numTreeBlocks);
+		payload.Write(treeBlocks.GetData(), treeBlocks.GetSize());
+
+		WriteContainer(*dest, GRAPH_FILE_ID, payload, format == FORMAT_BINARY_COMPRESSED);
+	}
 
 	//flush stream
 	dest->Close();
@@ -186,11 +811,31 @@ void IoSerialization::LoadGraph(IoGraph & graph, File* source)
 		return;
 	}
 
+	//per phase timings of this load
+	loadTimings_.Clear();
+	HiresTimer phaseTimer;
+
 	//create the json file
 	SharedPtr<JSONFile> json(new JSONFile(context_));
 
-	//load file in to json
-	json->Load(*source);
+	//binary graphs carry the json structure plus separately stored input trees
+	PODVector<unsigned char> payload;
+	Vector<Pair<unsigned, unsigned> > treeBlocks;
+
+	if (HasFileID(*source, GRAPH_FILE_ID))
+	{
+		if (!ReadContainer(*source, GRAPH_FILE_ID, payload) || !ReadGraphPayload(payload, *json, treeBlocks))
+		{
+			URHO3D_LOGERROR("IoSerialization --- could not read binary graph");
+			source->Close();
+			return;
+		}
+	}
+	else
+	{
+		//load file in to json
+		json->Load(*source);
+	}
 
 	//get the graph
 	const JSONValue& graphVal = json->GetRoot().Get("graph");
@@ -201,10 +846,20 @@ void IoSerialization::LoadGraph(IoGraph & graph, File* source)
 		return;
 	}
 
+	PushLoadTiming(loadTimings_, "read", phaseTimer);
+
+	//graph settings, graphs saved without them solve serially
+	graph.SetParallelSolve(graphVal.Get("parallel_solve").GetBool());
+
 	//loop through the components array to instantiate
 	const JSONArray& compArray = graphVal.Get("components").GetArray();
 	Vector<Pair<int, int>> loadedCompID;
 
+	//component index by ID, graph.GetComponent is a linear search
+	HashMap<String, int> componentIndices;
+
+	PrefetchScripts(context_, compArray);
+
 	for (unsigned i = 0; i < compArray.Size(); i++)
 	{
 		const JSONValue& compVal = compArray[i];
@@ -296,6 +951,21 @@ void IoSerialization::LoadGraph(IoGraph & graph, File* source)
 				}
 			}
 
+			//let the component handle slots saved with another data access
+			const JSONArray& savedInputs = compVal.Get("input_slots").GetArray();
+			for (unsigned j = 0; j < savedInputs.Size() && j < newComp->GetNumInputs(); j++)
+			{
+				const JSONValue& accessVal = savedInputs[j].Get("data_access");
+				if (accessVal.IsNull())
+					continue;
+
+				DataAccess savedAccess = (DataAccess)accessVal.GetInt();
+				if (savedAccess != newComp->inputSlots_[j]->GetDataAccess())
+				{
+					newComp->LoadInputAccess(j, savedAccess);
+				}
+			}
+
 			newComp->ID = ID;
 			newComp->Name = Name;
 			newComp->type = type;
@@ -310,7 +980,11 @@ void IoSerialization::LoadGraph(IoGraph & graph, File* source)
 			newComp->SetViewSize(viewSize.GetIntVector2());
 
 			graph.AddNewComponent(newComp);
-			int id = graph.GetComponentIndex(newComp->ID);
+			int id = graph.components_.Size() - 1;
+			if (!componentIndices.Contains(ID))
+			{
+				componentIndices[ID] = id;
+			}
 			Pair<int, int> p(id, i);
 			loadedCompID.Push(p);
 		}
@@ -322,19 +996,70 @@ void IoSerialization::LoadGraph(IoGraph & graph, File* source)
 
 	}
 
+	PushLoadTiming(loadTimings_, "components", phaseTimer);
+
+	//decode the trees of unlinked inputs, in the same order as the link loop below visits them
+	Vector<InputTreeJob> treeJobs;
+	for (unsigned i = 0; i < loadedCompID.Size(); i++)
+	{
+		const JSONArray& inputs = compArray[loadedCompID[i].second_].Get("input_slots").GetArray();
+		for (unsigned j = 0; j < inputs.Size(); j++)
+		{
+			if (inputs[j].Get("linked_slot_index").GetInt() != -1)
+				continue;
+
+			InputTreeJob job;
+			job.tree = new IoDataTree(context_);
+			job.treeVal = 0;
+			job.data = 0;
+			job.size = 0;
+			job.failed = false;
+
+			const JSONValue& blockVal = inputs[j].Get("input_tree_block");
+			if (blockVal.IsNull())
+			{
+				job.treeVal = &inputs[j].Get("input_tree");
+			}
+			else if (blockVal.GetUInt() < treeBlocks.Size())
+			{
+				const Pair<unsigned, unsigned>& block = treeBlocks[blockVal.GetUInt()];
+				job.data = &payload[block.first_];
+				job.size = block.second_;
+			}
+
+			treeJobs.Push(job);
+		}
+	}
+
+	//trees only touch their own branches, so they decode concurrently
+	WorkQueue* queue = context_->GetSubsystem<WorkQueue>();
+	for (unsigned i = 0; i < treeJobs.Size(); i++)
+	{
+		SharedPtr<WorkItem> item = queue ? queue->GetFreeItem() : SharedPtr<WorkItem>(new WorkItem());
+		item->priority_ = M_MAX_UNSIGNED;
+		item->workFunction_ = DecodeInputTreeWork;
+		item->start_ = &treeJobs[i];
+
+		if (queue)
+			queue->AddWorkItem(item);
+		else
+			DecodeInputTreeWork(item, 0);
+	}
+
+	if (queue)
+		queue->Complete(M_MAX_UNSIGNED);
+
+	PushLoadTiming(loadTimings_, "input trees", phaseTimer);
+
 	//loop to link the pointers
 	//TODO: loop only through successfully created components
+	unsigned nextTreeJob = 0;
 	for (unsigned i = 0; i < loadedCompID.Size(); i++)
 	{
 		int id = loadedCompID[i].first_;
 		SharedPtr<IoComponentBase> node = graph.components_[id]; //maybe better to look from ID?
 		const JSONArray& inputs = compArray[loadedCompID[i].second_].Get("input_slots").GetArray();
 
-		if (node->GetTypeName() == "Mesh_FillPolygon")
-		{
-			int test = 5;
-		}
-
 		for (unsigned j = 0; j < inputs.Size(); j++)
 		{
 			int linkedIndex = inputs[j].Get("linked_slot_index").GetInt();
@@ -342,9 +1067,13 @@ void IoSerialization::LoadGraph(IoGraph & graph, File* source)
 			if (linkedIndex == -1)
 			{
 				//set the value from file
-				const JSONValue inTreeVal = inputs[j].Get("input_tree");
-				IoDataTree inTree(context_);
-				LoadDataTree(inTree, inTreeVal);
+				const InputTreeJob& job = treeJobs[nextTreeJob++];
+				if (job.failed)
+				{
+					URHO3D_LOGWARNING("IoSerialization --- could not read input tree of component: " + node->ID);
+				}
+
+				IoDataTree& inTree = *job.tree;
 				Vector<int> path = inTree.Begin();
 				if (path.Size() > 0)
 				{
@@ -358,7 +1087,8 @@ void IoSerialization::LoadGraph(IoGraph & graph, File* source)
 			{
 				//create a new link via the graph
 				String linkedID = inputs[j].Get("linked_component").GetString();
-				int parentIndex = graph.GetComponent(linkedID);
+				HashMap<String, int>::ConstIterator found = componentIndices.Find(linkedID);
+				int parentIndex = found != componentIndices.End() ? found->second_ : -1;
 
 				if (parentIndex >= 0)
 				{
@@ -377,6 +1107,8 @@ void IoSerialization::LoadGraph(IoGraph & graph, File* source)
 
 	//init calcs
 	graph.UpdateRoots();
+
+	PushLoadTiming(loadTimings_, "links", phaseTimer);
 }
 
 void IoSerialization::LoadGraph(IoGraph & graph, String path)
@@ -399,30 +1131,19 @@ void IoSerialization::SaveDataTree(IoDataTree& tree, JSONValue& treeVal)
 {
 	//create branches array
 	JSONArray branchArr;
-	HashMap<String, IoBranch*>::ConstIterator itr;
-	for (itr = tree.branches_.Begin(); itr != tree.branches_.End(); itr++)
+	const IoBranchStore& branches = tree.Branches();
+	for (unsigned b = 0; b < branches.Size(); b++)
 	{
+		IoBranch* branch = branches.branches[b];
 		JSONValue bVal;
 		JSONArray bItems;
-		int numItems = itr->second_->data.Size();
+		int numItems = branch->data.Size();
 		for (int i = 0; i < numItems; i++)
 		{
-			//TODO: only store basic types
-			Variant var = itr->second_->data[i];
-
-			if (var.GetType() == VAR_VARIANTVECTOR || var.GetType() == VAR_VARIANTMAP)
-				continue;
-
-			JSONValue varVal;
-			varVal.Set("var_type", var.GetTypeName());
-			varVal.Set("var_value", var.ToString());
-
-			bItems.Push(varVal);
-
-
+			bItems.Push(VariantToJSON(branch->data[i]));
 		}
 
-		bVal.Set("path", itr->first_);
+		bVal.Set("path", tree.PathToUniqueString(branch->address));
 		bVal.Set("items", bItems);
 		branchArr.Push(bVal);
 	}
@@ -443,13 +1164,88 @@ void IoSerialization::LoadDataTree(IoDataTree& tree, const JSONValue& treeVal)
 		const JSONArray& bItems = branches[i]["items"].GetArray();
 		for (unsigned j = 0; j < bItems.Size(); j++)
 		{
-			String type = bItems[j]["var_type"].GetString();
-			String val = bItems[j]["var_value"].GetString();
+			tree.Add(path, VariantFromJSON(bItems[j]));
+		}
+	}
+}
+
+void IoSerialization::SaveDataTree(IoDataTree& tree, Serializer& dest)
+{
+	const IoBranchStore& branches = tree.Branches();
+	dest.WriteVLE(branches.Size());
+	for (unsigned b = 0; b < branches.Size(); b++)
+	{
+		IoBranch* branch = branches.branches[b];
+
+		dest.WriteVLE(branch->address.Size());
+		for (unsigned i = 0; i < branch->address.Size(); i++)
+		{
+			dest.WriteInt(branch->address[i]);
+		}
+
+		WriteBinaryVector(branch->data, dest);
+	}
+}
+
+bool IoSerialization::LoadDataTree(IoDataTree& tree, Deserializer& source)
+{
+	unsigned numBranches = source.ReadVLE();
+	for (unsigned b = 0; b < numBranches; b++)
+	{
+		unsigned pathSize = source.ReadVLE();
+		if (pathSize > RemainingBytes(source) / sizeof(int))
+			return false;
 
-			Variant var(type, val);
-			tree.Add(path, var);
+		Vector<int> path(pathSize);
+		for (unsigned i = 0; i < pathSize; i++)
+		{
+			path[i] = source.ReadInt();
 		}
+
+		VariantVector items;
+		if (!ReadBinaryVector(source, source.ReadUByte(), items))
+			return false;
+
+		tree.Add(path, items);
+	}
+
+	return true;
+}
+
+void IoSerialization::SaveData(const VariantMap& data, Serializer& dest, IoFileFormat format)
+{
+	if (format == FORMAT_JSON)
+	{
+		//json is only used for graphs, keep writing the old plain data files;
+		//these cannot hold packed mesh arrays, use a binary format for meshes
+		dest.WriteVariantMap(data);
+		return;
 	}
+
+	VectorBuffer payload;
+	WriteBinaryVariant(data, payload);
+	WriteContainer(dest, DATA_FILE_ID, payload, format == FORMAT_BINARY_COMPRESSED);
+}
+
+bool IoSerialization::LoadData(VariantMap& data, Deserializer& source)
+{
+	if (!HasFileID(source, DATA_FILE_ID))
+	{
+		data = source.ReadVariantMap();
+		return true;
+	}
+
+	PODVector<unsigned char> payload;
+	if (!ReadContainer(source, DATA_FILE_ID, payload) || payload.Empty())
+		return false;
+
+	MemoryBuffer buffer(&payload[0], payload.Size());
+	Variant var;
+	if (!ReadBinaryVariant(buffer, var) || var.GetType() != VAR_VARIANTMAP)
+		return false;
+
+	data = var.GetVariantMap();
+	return true;
 }
 
 void IoSerialization::SaveMetaData(HashMap<String, Pair<String, Variant>>& data, JSONValue& treeVal)
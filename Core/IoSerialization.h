@@ -26,21 +26,42 @@
 #include "IoComponentBase.h"
 #include "IoDataTree.h"
 
+#include <Urho3D/IO/Serializer.h>
+#include <Urho3D/IO/Deserializer.h>
+
+///on-disk layout of graph and data files
+///binary files start with a file ID and store input trees as typed, length-prefixed blocks,
+///with homogeneous arrays (mesh vertices, face indices) packed as raw floats and ints
+enum IoFileFormat
+{
+	FORMAT_JSON,
+	FORMAT_BINARY,
+	FORMAT_BINARY_COMPRESSED
+};
+
 class IoSerialization
 {
 private:
 	static Urho3D::Context* context_;
 	static Urho3D::File* destinaton_;
+	static Urho3D::Vector<Urho3D::Pair<Urho3D::String, float> > loadTimings_;
 
 public:
 	static IoGraph * currentGraph_;
-	static void SaveGraph(IoGraph const & graph, Urho3D::String path);
+	static void SaveGraph(IoGraph const & graph, Urho3D::String path, IoFileFormat format = FORMAT_BINARY_COMPRESSED);
 	static void LoadGraph(IoGraph & graph, Urho3D::String path);
 	static void LoadGraph(IoGraph & graph, Urho3D::File* file);
 	static void SetContext(Urho3D::Context* context) { context_ = context; };
 	static Urho3D::Context* GetContext() { return context_; };
+	//milliseconds spent in each phase of the last LoadGraph
+	static const Urho3D::Vector<Urho3D::Pair<Urho3D::String, float> >& GetLoadTimings() { return loadTimings_; }
 	static void SaveDataTree(IoDataTree& tree, Urho3D::JSONValue& treeVal);
 	static void LoadDataTree(IoDataTree& tree, const Urho3D::JSONValue& treeVal);
+	static void SaveDataTree(IoDataTree& tree, Urho3D::Serializer& dest);
+	static bool LoadDataTree(IoDataTree& tree, Urho3D::Deserializer& source);
+	//frozen data, files without the binary file ID are read as a plain variant map
+	static void SaveData(const Urho3D::VariantMap& data, Urho3D::Serializer& dest, IoFileFormat format = FORMAT_BINARY_COMPRESSED);
+	static bool LoadData(Urho3D::VariantMap& data, Urho3D::Deserializer& source);
 	static void SaveMetaData(Urho3D::HashMap<Urho3D::String, Urho3D::Pair<Urho3D::String, Urho3D::Variant>>& data, Urho3D::JSONValue& treeVal);
 	static void LoadMetaData(Urho3D::HashMap<Urho3D::String, Urho3D::Pair<Urho3D::String, Urho3D::Variant>>& data, const Urho3D::JSONValue& treeVal);
 };
\ No newline at end of file
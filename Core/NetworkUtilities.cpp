@@ -23,6 +23,18 @@
 #include "NetworkUtilities.h"
 
 #include "IndexUtilities.h"
+#include "IoComponentBase.h"
+#include "IoGraph.h"
+
+// links made or broken here bypass IoGraph::AddConnection and DeleteConnection,
+// so the graph owning the receiving component has to drop its cached topology
+static void InvalidateGraphTopology(Urho3D::SharedPtr<IoInputSlot> in)
+{
+	IoGraph* graph = in->GetHomeComponent()->GetGraph();
+	if (graph) {
+		graph->InvalidateTopology();
+	}
+}
 
 void mConnect(
 	Urho3D::SharedPtr<IoOutputSlot> out,
@@ -40,6 +52,7 @@ void mConnect(
 
 		out->linkedInputSlots_.Push(in);
 		in->linkedOutputSlot_ = out;
+		InvalidateGraphTopology(in);
 
 		in->ioDataTree_ = out->ioDataTree_;
 		out->Transmit(in);
@@ -63,6 +76,7 @@ void mDisconnect(Urho3D::SharedPtr<IoOutputSlot> out)
 			out->linkedInputSlots_[i].Reset(); // do not erase yet, it invalids index positions
 
 			in->linkedOutputSlot_.Reset();
+			InvalidateGraphTopology(in);
 			in->Lose();
 		}
 	}
@@ -114,5 +128,6 @@ void mDisconnect(
 	out->linkedInputSlots_.Erase(indexIntoOut);
 
 	in->linkedOutputSlot_.Reset();
+	InvalidateGraphTopology(in);
 	in->Lose();
 }
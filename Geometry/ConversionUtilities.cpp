@@ -37,6 +37,8 @@
 #include <Urho3D/Core/Variant.h>
 #include <Urho3D/Container/Vector.h>
 
+#include "TriMesh.h"
+
 #pragma warning(disable : 4244)
 
 using Urho3D::Variant;
@@ -243,6 +245,23 @@ bool IglMeshToMatrices(
 	Eigen::MatrixXi& F
 )
 {
+	// packed meshes are already contiguous, only the index range needs checking
+	if (TriMesh_IsPacked(mesh)) {
+		TriMeshView view(mesh);
+		if (!view.IsValid()) {
+			std::cout << "ERROR: IglMeshToMatrices --- packed mesh has no vertices or faces" << std::endl;
+			return false;
+		}
+		TriMeshFaceMap G = view.GetFaceMap();
+		if (G.minCoeff() < 0 || G.maxCoeff() > (int)view.GetNumVertices() - 1) {
+			std::cout << "ERROR: IglMeshMatrices -- faceIndex out of range" << std::endl;
+			return false;
+		}
+		V = view.GetVertexMap();
+		F = G;
+		return true;
+	}
+
 	VariantMap meshMap = mesh.GetVariantMap();
 	if (meshMap.Empty()) {
 		// V, F untouched
@@ -349,6 +368,11 @@ bool ExtractMeshData(
 	Urho3D::VariantVector& faceList
 )
 {
+	// the checks below work on per-element lists
+	if (TriMesh_IsPacked(mesh)) {
+		return ExtractMeshData(TriMesh_Unpack(mesh), vertexList, faceList);
+	}
+
 	// extract the map
 	if (mesh.GetType() != VariantType::VAR_VARIANTMAP) {
 		std::cerr << "ERROR: ExtractMeshData --- mesh.GetType() != VAR_VARIANTMAP\n";
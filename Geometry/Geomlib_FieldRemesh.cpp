@@ -0,0 +1,864 @@
+//
+// Copyright (c) 2016 - 2017 Mesh Consultants Inc.
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "Geomlib_FieldRemesh.h"
+
+#include <algorithm>
+#include <cmath>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+#include <Urho3D/Math/Vector3.h>
+
+#include <igl/parallel_for.h>
+
+#include "NMesh.h"
+#include "TriMesh.h"
+
+using namespace Urho3D;
+
+namespace {
+
+	// below this many vertices a smoothing phase runs on the calling thread
+	const int MIN_PARALLEL_VERTICES = 1000;
+	// the hierarchy stops at this many levels or when a level stops shrinking
+	const unsigned MAX_LEVELS = 25;
+	// Gauss-Seidel sweeps per level for each field
+	const unsigned ORIENTATION_ITERATIONS = 6;
+	const unsigned POSITION_ITERATIONS = 6;
+	// refine the input until its edges are shorter than this fraction of the target edge length
+	const float MAX_EDGE_FRACTION = 0.5f;
+	// extracted faces with more sides than this are holes; up to MAX_PATCH_SIDES they are still patched
+	// as one face where they are away from the boundary of the input
+	const unsigned MAX_FACE_SIDES = 6;
+	const unsigned MAX_PATCH_SIDES = 12;
+
+	// One vertex graph of the multigrid hierarchy, stored as contiguous arrays
+	struct Level
+	{
+		PODVector<Vector3> positions_;
+		PODVector<Vector3> normals_;
+		PODVector<float> areas_;
+		// whether a vertex of the finest level is on the boundary of the input
+		PODVector<bool> boundary_;
+		// neighbours of vertex i are adjacency_[adjacencyStart_[i] .. adjacencyStart_[i + 1])
+		PODVector<int> adjacencyStart_;
+		PODVector<int> adjacency_;
+		PODVector<float> weights_;
+		// vertices grouped by colour, so no two vertices of a phase are neighbours
+		PODVector<int> phaseStart_;
+		PODVector<int> phases_;
+		// the coarser vertex each vertex was merged into, and the up to two finer vertices of each vertex
+		PODVector<int> toCoarser_;
+		PODVector<int> toFiner_;
+		// smoothed fields: a tangent direction, and a lattice point near the vertex
+		PODVector<Vector3> orientations_;
+		PODVector<Vector3> origins_;
+
+		unsigned GetNumVertices() const
+		{
+			return positions_.Size();
+		}
+	};
+
+	unsigned long long EdgeKey(int a, int b)
+	{
+		return ((unsigned long long)(unsigned)a << 32) | (unsigned)b;
+	}
+
+	Vector3 AnyTangent(const Vector3& n)
+	{
+		Vector3 axis = std::abs(n.x_) > 0.9f ? Vector3(0.0f, 1.0f, 0.0f) : Vector3(1.0f, 0.0f, 0.0f);
+		return (axis - n * n.DotProduct(axis)).Normalized();
+	}
+
+	Vector3 ProjectToTangent(const Vector3& v, const Vector3& n)
+	{
+		Vector3 projected = v - n * n.DotProduct(v);
+		float length = projected.Length();
+		return length > 0.0f ? projected / length : AnyTangent(n);
+	}
+
+	// Bisects the longest edges until none is longer than maxLength
+	void SplitLongEdges(PODVector<Vector3>& positions, PODVector<int>& indices, float maxLength)
+	{
+		std::unordered_map<unsigned long long, int> edgeFaces;
+		edgeFaces.reserve(indices.Size() * 2);
+		std::priority_queue<std::pair<float, std::pair<int, int> > > queue;
+		for (unsigned f = 0; f < indices.Size() / 3; ++f) {
+			for (unsigned i = 0; i < 3; ++i) {
+				int a = indices[3 * f + i];
+				int b = indices[3 * f + (i + 1) % 3];
+				edgeFaces[EdgeKey(a, b)] = f;
+				float length = (positions[a] - positions[b]).Length();
+				if (a < b && length > maxLength) {
+					queue.push(std::make_pair(length, std::make_pair(a, b)));
+				}
+			}
+		}
+
+		while (!queue.empty()) {
+			int a = queue.top().second.first;
+			int b = queue.top().second.second;
+			queue.pop();
+			std::unordered_map<unsigned long long, int>::iterator left = edgeFaces.find(EdgeKey(a, b));
+			std::unordered_map<unsigned long long, int>::iterator right = edgeFaces.find(EdgeKey(b, a));
+			if (left == edgeFaces.end() && right == edgeFaces.end()) {
+				continue;
+			}
+
+			int m = (int)positions.Size();
+			positions.Push(0.5f * (positions[a] + positions[b]));
+			float half = 0.5f * (positions[a] - positions[b]).Length();
+
+			// each face (p, q, r) on edge p -> q becomes (p, m, r) and (m, q, r)
+			int sides[2][2] = { { a, b }, { b, a } };
+			int faces[2] = {
+				left != edgeFaces.end() ? left->second : -1,
+				right != edgeFaces.end() ? right->second : -1
+			};
+			for (unsigned s = 0; s < 2; ++s) {
+				if (faces[s] < 0) {
+					continue;
+				}
+				int p = sides[s][0];
+				int q = sides[s][1];
+				int f = faces[s];
+				int r = indices[3 * f] + indices[3 * f + 1] + indices[3 * f + 2] - p - q;
+				edgeFaces.erase(EdgeKey(p, q));
+
+				indices[3 * f] = p;
+				indices[3 * f + 1] = m;
+				indices[3 * f + 2] = r;
+				int g = (int)indices.Size() / 3;
+				indices.Push(m);
+				indices.Push(q);
+				indices.Push(r);
+
+				edgeFaces[EdgeKey(p, m)] = f;
+				edgeFaces[EdgeKey(m, r)] = f;
+				edgeFaces[EdgeKey(r, p)] = f;
+				edgeFaces[EdgeKey(m, q)] = g;
+				edgeFaces[EdgeKey(q, r)] = g;
+				edgeFaces[EdgeKey(r, m)] = g;
+
+				float length = (positions[m] - positions[r]).Length();
+				if (length > maxLength) {
+					queue.push(std::make_pair(length, std::make_pair(Min(m, r), Max(m, r))));
+				}
+			}
+			if (half > maxLength) {
+				queue.push(std::make_pair(half, std::make_pair(Min(a, m), Max(a, m))));
+				queue.push(std::make_pair(half, std::make_pair(Min(m, b), Max(m, b))));
+			}
+		}
+	}
+
+	// Finest level: area weighted vertex normals, a third of the area of each face at its corners,
+	// and unit weights on the mesh edges
+	void MakeFinestLevel(const PODVector<Vector3>& positions, const PODVector<int>& indices, Level& level)
+	{
+		unsigned numVertices = positions.Size();
+		level.positions_ = positions;
+		level.normals_.Resize(numVertices);
+		level.areas_.Resize(numVertices);
+		for (unsigned i = 0; i < numVertices; ++i) {
+			level.normals_[i] = Vector3::ZERO;
+			level.areas_[i] = 0.0f;
+		}
+
+		std::vector<std::pair<int, int> > edges;
+		edges.reserve(indices.Size() * 2);
+		for (unsigned f = 0; f < indices.Size() / 3; ++f) {
+			const int* v = &indices[3 * f];
+			Vector3 n = (positions[v[1]] - positions[v[0]]).CrossProduct(positions[v[2]] - positions[v[0]]);
+			float area = 0.5f * n.Length();
+			for (unsigned i = 0; i < 3; ++i) {
+				level.normals_[v[i]] += n;
+				level.areas_[v[i]] += area / 3.0f;
+				edges.push_back(std::make_pair(v[i], v[(i + 1) % 3]));
+				edges.push_back(std::make_pair(v[(i + 1) % 3], v[i]));
+			}
+		}
+		for (unsigned i = 0; i < numVertices; ++i) {
+			float length = level.normals_[i].Length();
+			level.normals_[i] = length > 0.0f ? level.normals_[i] / length : Vector3(0.0f, 1.0f, 0.0f);
+		}
+
+		level.boundary_.Resize(numVertices);
+		for (unsigned i = 0; i < numVertices; ++i) {
+			level.boundary_[i] = false;
+		}
+		std::sort(edges.begin(), edges.end());
+		for (unsigned e = 0; e < edges.size(); ++e) {
+			bool repeated = (e > 0 && edges[e - 1] == edges[e]) || (e + 1 < edges.size() && edges[e + 1] == edges[e]);
+			if (!repeated) {
+				level.boundary_[edges[e].first] = level.boundary_[edges[e].second] = true;
+			}
+		}
+		edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+		level.adjacencyStart_.Resize(numVertices + 1);
+		level.adjacency_.Resize((unsigned)edges.size());
+		level.weights_.Resize((unsigned)edges.size());
+		unsigned next = 0;
+		for (unsigned i = 0; i <= numVertices; ++i) {
+			while (next < edges.size() && edges[next].first < (int)i) {
+				++next;
+			}
+			level.adjacencyStart_[i] = next;
+		}
+		for (unsigned e = 0; e < edges.size(); ++e) {
+			level.adjacency_[e] = edges[e].second;
+			level.weights_[e] = 1.0f;
+		}
+	}
+
+	// Next coarser level, merging neighbours with similar normals and areas in pairs
+	void MakeCoarserLevel(Level& fine, Level& coarse)
+	{
+		unsigned numFine = fine.GetNumVertices();
+		std::vector<std::pair<float, std::pair<int, int> > > candidates;
+		candidates.reserve(fine.adjacency_.Size() / 2);
+		for (unsigned i = 0; i < numFine; ++i) {
+			for (int e = fine.adjacencyStart_[i]; e < fine.adjacencyStart_[i + 1]; ++e) {
+				int k = fine.adjacency_[e];
+				if (k <= (int)i) {
+					continue;
+				}
+				float a = fine.areas_[i];
+				float b = fine.areas_[k];
+				float ratio = a > b ? (b > 0.0f ? a / b : M_LARGE_VALUE) : (a > 0.0f ? b / a : M_LARGE_VALUE);
+				candidates.push_back(std::make_pair(-fine.normals_[i].DotProduct(fine.normals_[k]) / ratio, std::make_pair((int)i, k)));
+			}
+		}
+		std::sort(candidates.begin(), candidates.end());
+
+		fine.toCoarser_.Resize(numFine);
+		for (unsigned i = 0; i < numFine; ++i) {
+			fine.toCoarser_[i] = -1;
+		}
+		for (unsigned c = 0; c < candidates.size(); ++c) {
+			int i = candidates[c].second.first;
+			int k = candidates[c].second.second;
+			if (fine.toCoarser_[i] >= 0 || fine.toCoarser_[k] >= 0) {
+				continue;
+			}
+			fine.toCoarser_[i] = fine.toCoarser_[k] = (int)coarse.toFiner_.Size() / 2;
+			coarse.toFiner_.Push(i);
+			coarse.toFiner_.Push(k);
+		}
+		for (unsigned i = 0; i < numFine; ++i) {
+			if (fine.toCoarser_[i] < 0) {
+				fine.toCoarser_[i] = (int)coarse.toFiner_.Size() / 2;
+				coarse.toFiner_.Push(i);
+				coarse.toFiner_.Push(-1);
+			}
+		}
+
+		unsigned numCoarse = coarse.toFiner_.Size() / 2;
+		coarse.positions_.Resize(numCoarse);
+		coarse.normals_.Resize(numCoarse);
+		coarse.areas_.Resize(numCoarse);
+		for (unsigned c = 0; c < numCoarse; ++c) {
+			int i = coarse.toFiner_[2 * c];
+			int k = coarse.toFiner_[2 * c + 1];
+			if (k < 0) {
+				coarse.positions_[c] = fine.positions_[i];
+				coarse.normals_[c] = fine.normals_[i];
+				coarse.areas_[c] = fine.areas_[i];
+				continue;
+			}
+			float area = fine.areas_[i] + fine.areas_[k];
+			coarse.areas_[c] = area;
+			coarse.positions_[c] = area > 0.0f ?
+				(fine.positions_[i] * fine.areas_[i] + fine.positions_[k] * fine.areas_[k]) / area :
+				0.5f * (fine.positions_[i] + fine.positions_[k]);
+			Vector3 n = fine.normals_[i] * fine.areas_[i] + fine.normals_[k] * fine.areas_[k];
+			float length = n.Length();
+			coarse.normals_[c] = length > 0.0f ? n / length : fine.normals_[i];
+		}
+
+		// neighbours of the finer vertices, with the weights of repeated neighbours summed
+		coarse.adjacencyStart_.Resize(numCoarse + 1);
+		coarse.adjacency_.Clear();
+		coarse.weights_.Clear();
+		std::vector<std::pair<int, float> > neighbours;
+		for (unsigned c = 0; c < numCoarse; ++c) {
+			coarse.adjacencyStart_[c] = coarse.adjacency_.Size();
+			neighbours.clear();
+			for (unsigned s = 0; s < 2; ++s) {
+				int i = coarse.toFiner_[2 * c + s];
+				if (i < 0) {
+					continue;
+				}
+				for (int e = fine.adjacencyStart_[i]; e < fine.adjacencyStart_[i + 1]; ++e) {
+					int j = fine.toCoarser_[fine.adjacency_[e]];
+					if (j != (int)c) {
+						neighbours.push_back(std::make_pair(j, fine.weights_[e]));
+					}
+				}
+			}
+			std::sort(neighbours.begin(), neighbours.end());
+			for (unsigned n = 0; n < neighbours.size(); ++n) {
+				if (n > 0 && neighbours[n].first == neighbours[n - 1].first) {
+					coarse.weights_.Back() += neighbours[n].second;
+					continue;
+				}
+				coarse.adjacency_.Push(neighbours[n].first);
+				coarse.weights_.Push(neighbours[n].second);
+			}
+		}
+		coarse.adjacencyStart_[numCoarse] = coarse.adjacency_.Size();
+	}
+
+	// Greedy graph colouring, so each colour can be smoothed in parallel
+	void MakePhases(Level& level)
+	{
+		unsigned numVertices = level.GetNumVertices();
+		PODVector<int> colours(numVertices);
+		std::vector<bool> taken;
+		int numColours = 0;
+		for (unsigned i = 0; i < numVertices; ++i) {
+			taken.assign(numColours + 1, false);
+			for (int e = level.adjacencyStart_[i]; e < level.adjacencyStart_[i + 1]; ++e) {
+				int j = level.adjacency_[e];
+				if (j < (int)i) {
+					taken[colours[j]] = true;
+				}
+			}
+			int colour = 0;
+			while (taken[colour]) {
+				++colour;
+			}
+			colours[i] = colour;
+			numColours = Max(numColours, colour + 1);
+		}
+
+		level.phaseStart_.Resize(numColours + 1);
+		for (int c = 0; c <= numColours; ++c) {
+			level.phaseStart_[c] = 0;
+		}
+		for (unsigned i = 0; i < numVertices; ++i) {
+			++level.phaseStart_[colours[i] + 1];
+		}
+		for (int c = 0; c < numColours; ++c) {
+			level.phaseStart_[c + 1] += level.phaseStart_[c];
+		}
+		level.phases_.Resize(numVertices);
+		PODVector<int> filled(numColours);
+		for (int c = 0; c < numColours; ++c) {
+			filled[c] = level.phaseStart_[c];
+		}
+		for (unsigned i = 0; i < numVertices; ++i) {
+			level.phases_[filled[colours[i]]++] = i;
+		}
+	}
+
+	// Runs smooth(i) over every vertex, one colour at a time
+	template <typename Smooth>
+	void SmoothLevel(const Level& level, unsigned iterations, const Smooth& smooth)
+	{
+		unsigned numPhases = level.phaseStart_.Size() - 1;
+		for (unsigned iteration = 0; iteration < iterations; ++iteration) {
+			for (unsigned p = 0; p < numPhases; ++p) {
+				int start = level.phaseStart_[p];
+				igl::parallel_for(
+					level.phaseStart_[p + 1] - start,
+					[&](int k) {
+						smooth(level.phases_[start + k]);
+					},
+					MIN_PARALLEL_VERTICES
+				);
+			}
+		}
+	}
+
+	// The representatives of two 4-RoSy directions that are closest to each other
+	void CompatOrientations(const Vector3& q0, const Vector3& n0, const Vector3& q1, const Vector3& n1, Vector3& a, Vector3& b)
+	{
+		Vector3 as[2] = { q0, n0.CrossProduct(q0) };
+		Vector3 bs[2] = { q1, n1.CrossProduct(q1) };
+		float bestScore = -1.0f;
+		unsigned bestA = 0, bestB = 0;
+		for (unsigned i = 0; i < 2; ++i) {
+			for (unsigned j = 0; j < 2; ++j) {
+				float score = std::abs(as[i].DotProduct(bs[j]));
+				if (score > bestScore) {
+					bestScore = score;
+					bestA = i;
+					bestB = j;
+				}
+			}
+		}
+		a = as[bestA];
+		b = as[bestA].DotProduct(bs[bestB]) < 0.0f ? -bs[bestB] : bs[bestB];
+	}
+
+	// The lattice point of origin o, direction q and normal n at or below p in both lattice directions
+	Vector3 PositionFloor(const Vector3& o, const Vector3& q, const Vector3& n, const Vector3& p, float scale)
+	{
+		Vector3 t = n.CrossProduct(q);
+		Vector3 d = p - o;
+		return o + q * (std::floor(q.DotProduct(d) / scale) * scale) + t * (std::floor(t.DotProduct(d) / scale) * scale);
+	}
+
+	Vector3 PositionRound(const Vector3& o, const Vector3& q, const Vector3& n, const Vector3& p, float scale)
+	{
+		Vector3 t = n.CrossProduct(q);
+		Vector3 d = p - o;
+		return o + q * (std::floor(q.DotProduct(d) / scale + 0.5f) * scale) + t * (std::floor(t.DotProduct(d) / scale + 0.5f) * scale);
+	}
+
+	// The point closest to both tangent planes, between p0 and p1
+	Vector3 MiddlePoint(const Vector3& p0, const Vector3& n0, const Vector3& p1, const Vector3& n1)
+	{
+		float n0p0 = n0.DotProduct(p0), n0p1 = n0.DotProduct(p1);
+		float n1p0 = n1.DotProduct(p0), n1p1 = n1.DotProduct(p1);
+		float n0n1 = n0.DotProduct(n1);
+		float denominator = 1.0f / (1.0f - n0n1 * n0n1 + 1e-4f);
+		float lambda0 = 2.0f * (n0p1 - n0p0 - n0n1 * (n1p0 - n1p1)) * denominator;
+		float lambda1 = 2.0f * (n1p0 - n1p1 - n0n1 * (n0p1 - n0p0)) * denominator;
+		return 0.5f * (p0 + p1) - 0.25f * (n0 * lambda0 + n1 * lambda1);
+	}
+
+	// The lattice points of two vertices, near the point between them, that are closest to each other
+	void CompatPositions(
+		const Vector3& p0, const Vector3& n0, const Vector3& q0, const Vector3& o0,
+		const Vector3& p1, const Vector3& n1, const Vector3& q1, const Vector3& o1,
+		float scale,
+		Vector3& a,
+		Vector3& b
+	)
+	{
+		Vector3 t0 = n0.CrossProduct(q0);
+		Vector3 t1 = n1.CrossProduct(q1);
+		Vector3 middle = MiddlePoint(p0, n0, p1, n1);
+		Vector3 base0 = PositionFloor(o0, q0, n0, middle, scale);
+		Vector3 base1 = PositionFloor(o1, q1, n1, middle, scale);
+		float bestCost = M_INFINITY;
+		for (unsigned i = 0; i < 4; ++i) {
+			Vector3 c0 = base0 + (q0 * (float)(i & 1) + t0 * (float)((i & 2) >> 1)) * scale;
+			for (unsigned j = 0; j < 4; ++j) {
+				Vector3 c1 = base1 + (q1 * (float)(j & 1) + t1 * (float)((j & 2) >> 1)) * scale;
+				float cost = (c0 - c1).LengthSquared();
+				if (cost < bestCost) {
+					bestCost = cost;
+					a = c0;
+					b = c1;
+				}
+			}
+		}
+	}
+
+	void SmoothOrientations(Level& level)
+	{
+		SmoothLevel(level, ORIENTATION_ITERATIONS, [&](int i) {
+			const Vector3& n = level.normals_[i];
+			Vector3 q = level.orientations_[i];
+			float weightSum = 0.0f;
+			for (int e = level.adjacencyStart_[i]; e < level.adjacencyStart_[i + 1]; ++e) {
+				int j = level.adjacency_[e];
+				float w = level.weights_[e];
+				Vector3 a, b;
+				CompatOrientations(q, n, level.orientations_[j], level.normals_[j], a, b);
+				q = a * weightSum + b * w;
+				weightSum += w;
+				q = ProjectToTangent(q, n);
+			}
+			level.orientations_[i] = q;
+		});
+	}
+
+	void SmoothPositions(Level& level, float scale)
+	{
+		SmoothLevel(level, POSITION_ITERATIONS, [&](int i) {
+			const Vector3& p = level.positions_[i];
+			const Vector3& n = level.normals_[i];
+			const Vector3& q = level.orientations_[i];
+			Vector3 o = level.origins_[i];
+			float weightSum = 0.0f;
+			for (int e = level.adjacencyStart_[i]; e < level.adjacencyStart_[i + 1]; ++e) {
+				int j = level.adjacency_[e];
+				float w = level.weights_[e];
+				Vector3 a, b;
+				CompatPositions(
+					p, n, q, o,
+					level.positions_[j], level.normals_[j], level.orientations_[j], level.origins_[j],
+					scale, a, b
+				);
+				o = (a * weightSum + b * w) / (weightSum + w);
+				weightSum += w;
+				o -= n * n.DotProduct(o - p);
+			}
+			level.origins_[i] = PositionRound(o, q, n, p, scale);
+		});
+	}
+
+	struct UnionFind
+	{
+		UnionFind(unsigned size) :
+			parent_(size)
+		{
+			for (unsigned i = 0; i < size; ++i) {
+				parent_[i] = i;
+			}
+		}
+
+		int Find(int i)
+		{
+			while (parent_[i] != i) {
+				parent_[i] = parent_[parent_[i]];
+				i = parent_[i];
+			}
+			return i;
+		}
+
+		void Join(int a, int b)
+		{
+			a = Find(a);
+			b = Find(b);
+			if (a != b) {
+				parent_[Max(a, b)] = Min(a, b);
+			}
+		}
+
+		PODVector<int> parent_;
+	};
+
+	// Collapses vertices on the same lattice point, joins neighbouring lattice points and traces the faces
+	// of the resulting graph. Faces are output as their number of sides followed by their vertices.
+	void ExtractMesh(const Level& level, float scale, PODVector<Vector3>& vertices, PODVector<int>& faces)
+	{
+		unsigned numVertices = level.GetNumVertices();
+		UnionFind clusters(numVertices);
+		std::vector<std::pair<int, int> > latticeEdges;
+		for (unsigned i = 0; i < numVertices; ++i) {
+			const Vector3& n = level.normals_[i];
+			const Vector3& q = level.orientations_[i];
+			Vector3 t = n.CrossProduct(q);
+			for (int e = level.adjacencyStart_[i]; e < level.adjacencyStart_[i + 1]; ++e) {
+				int j = level.adjacency_[e];
+				if (j < (int)i) {
+					continue;
+				}
+				Vector3 d = level.origins_[j] - level.origins_[i];
+				float u = q.DotProduct(d) / scale;
+				float v = t.DotProduct(d) / scale;
+				float roundU = std::floor(u + 0.5f);
+				float roundV = std::floor(v + 0.5f);
+				// far off the lattice, the fields do not agree here
+				if (std::abs(u - roundU) + std::abs(v - roundV) > 0.5f) {
+					continue;
+				}
+				float steps = std::abs(roundU) + std::abs(roundV);
+				if (steps == 0.0f) {
+					clusters.Join(i, j);
+				}
+				else if (steps == 1.0f) {
+					latticeEdges.push_back(std::make_pair((int)i, j));
+				}
+			}
+		}
+
+		// each cluster becomes a vertex at the area weighted mean of its lattice points
+		PODVector<int> clusterOf(numVertices);
+		PODVector<int> clusterIndex(numVertices);
+		for (unsigned i = 0; i < numVertices; ++i) {
+			clusterIndex[i] = -1;
+		}
+		PODVector<Vector3> clusterNormals;
+		PODVector<Vector3> clusterOrientations;
+		PODVector<float> clusterAreas;
+		std::vector<bool> clusterBoundary;
+		for (unsigned i = 0; i < numVertices; ++i) {
+			int root = clusters.Find(i);
+			if (clusterIndex[root] < 0) {
+				clusterIndex[root] = (int)vertices.Size();
+				vertices.Push(Vector3::ZERO);
+				clusterNormals.Push(Vector3::ZERO);
+				clusterOrientations.Push(level.orientations_[root]);
+				clusterAreas.Push(0.0f);
+				clusterBoundary.push_back(false);
+			}
+			int c = clusterIndex[root];
+			clusterOf[i] = c;
+			float area = Max(level.areas_[i], M_EPSILON);
+			vertices[c] += level.origins_[i] * area;
+			clusterNormals[c] += level.normals_[i] * area;
+			clusterAreas[c] += area;
+			if (level.boundary_[i]) {
+				clusterBoundary[c] = true;
+			}
+		}
+		unsigned numClusters = vertices.Size();
+		for (unsigned c = 0; c < numClusters; ++c) {
+			vertices[c] /= clusterAreas[c];
+			float length = clusterNormals[c].Length();
+			clusterNormals[c] = length > 0.0f ? clusterNormals[c] / length : Vector3(0.0f, 1.0f, 0.0f);
+			clusterOrientations[c] = ProjectToTangent(clusterOrientations[c], clusterNormals[c]);
+		}
+
+		std::vector<std::vector<int> > neighbours(numClusters);
+		for (unsigned e = 0; e < latticeEdges.size(); ++e) {
+			int a = clusterOf[latticeEdges[e].first];
+			int b = clusterOf[latticeEdges[e].second];
+			if (a != b) {
+				neighbours[a].push_back(b);
+				neighbours[b].push_back(a);
+			}
+		}
+		for (unsigned c = 0; c < numClusters; ++c) {
+			std::sort(neighbours[c].begin(), neighbours[c].end());
+			neighbours[c].erase(std::unique(neighbours[c].begin(), neighbours[c].end()), neighbours[c].end());
+		}
+
+		// Where the fields disagree, lattice points can be left hanging off one edge or in the middle of a
+		// straight run of two. Hanging ones are cut off and those in a run are bridged by one edge.
+		std::vector<int> pending;
+		for (unsigned c = 0; c < numClusters; ++c) {
+			pending.push_back(c);
+		}
+		while (!pending.empty()) {
+			int c = pending.back();
+			pending.pop_back();
+			std::vector<int>& ring = neighbours[c];
+			if (ring.empty() || ring.size() > 2) {
+				continue;
+			}
+			for (unsigned k = 0; k < ring.size(); ++k) {
+				std::vector<int>& other = neighbours[ring[k]];
+				other.erase(std::find(other.begin(), other.end(), c));
+			}
+			if (ring.size() == 2 && std::find(neighbours[ring[0]].begin(), neighbours[ring[0]].end(), ring[1]) == neighbours[ring[0]].end()) {
+				neighbours[ring[0]].push_back(ring[1]);
+				neighbours[ring[1]].push_back(ring[0]);
+			}
+			pending.insert(pending.end(), ring.begin(), ring.end());
+			ring.clear();
+		}
+
+		std::vector<std::pair<int, int> > edges;
+		edges.reserve(latticeEdges.size() * 2);
+		for (unsigned c = 0; c < numClusters; ++c) {
+			for (unsigned k = 0; k < neighbours[c].size(); ++k) {
+				edges.push_back(std::make_pair((int)c, neighbours[c][k]));
+			}
+		}
+		std::sort(edges.begin(), edges.end());
+
+		// neighbours of each cluster in counterclockwise order about its normal
+		PODVector<int> start(numClusters + 1);
+		unsigned next = 0;
+		for (unsigned c = 0; c <= numClusters; ++c) {
+			while (next < edges.size() && edges[next].first < (int)c) {
+				++next;
+			}
+			start[c] = next;
+		}
+		PODVector<int> ring((unsigned)edges.size());
+		std::vector<std::pair<float, int> > angles;
+		for (unsigned c = 0; c < numClusters; ++c) {
+			const Vector3& n = clusterNormals[c];
+			const Vector3& q = clusterOrientations[c];
+			Vector3 t = n.CrossProduct(q);
+			angles.clear();
+			for (int e = start[c]; e < start[c + 1]; ++e) {
+				Vector3 d = vertices[edges[e].second] - vertices[c];
+				angles.push_back(std::make_pair(std::atan2(t.DotProduct(d), q.DotProduct(d)), edges[e].second));
+			}
+			std::sort(angles.begin(), angles.end());
+			for (unsigned k = 0; k < angles.size(); ++k) {
+				ring[start[c] + k] = angles[k].second;
+			}
+		}
+
+		// the face left of edge u -> v continues to the neighbour of v just clockwise of u
+		std::vector<bool> used(edges.size(), false);
+		PODVector<int> face;
+		for (unsigned c = 0; c < numClusters; ++c) {
+			for (int e = start[c]; e < start[c + 1]; ++e) {
+				if (used[e]) {
+					continue;
+				}
+				face.Clear();
+				bool boundary = false;
+				int u = c;
+				int edge = e;
+				while (!used[edge]) {
+					used[edge] = true;
+					face.Push(u);
+					boundary = boundary || clusterBoundary[u];
+					int v = ring[edge];
+					int degree = start[v + 1] - start[v];
+					int k = 0;
+					while (ring[start[v] + k] != u) {
+						++k;
+					}
+					edge = start[v] + (k + degree - 1) % degree;
+					u = v;
+				}
+				if (face.Size() >= 3 && (face.Size() <= MAX_FACE_SIDES || (face.Size() <= MAX_PATCH_SIDES && !boundary))) {
+					faces.Push(face.Size());
+					faces.Push(face);
+				}
+			}
+		}
+	}
+
+} // namespace
+
+bool Geomlib::FieldRemesh(
+	const Variant& meshIn,
+	int targetFaces,
+	bool quads,
+	Variant& meshOut
+)
+{
+	TriMeshView view(meshIn);
+	if (!view.IsValid() || targetFaces <= 0) {
+		return false;
+	}
+
+	PODVector<Vector3> positions(view.GetNumVertices());
+	for (unsigned i = 0; i < positions.Size(); ++i) {
+		positions[i] = view.GetVertex(i);
+	}
+	PODVector<int> indices(3 * view.GetNumFaces());
+	float area = 0.0f;
+	for (unsigned f = 0; f < view.GetNumFaces(); ++f) {
+		for (unsigned i = 0; i < 3; ++i) {
+			indices[3 * f + i] = view.GetIndex(f, i);
+		}
+		area += 0.5f * (positions[indices[3 * f + 1]] - positions[indices[3 * f]]).CrossProduct(positions[indices[3 * f + 2]] - positions[indices[3 * f]]).Length();
+	}
+	if (area <= 0.0f) {
+		return false;
+	}
+
+	// a lattice cell is a quad, or two triangles
+	float scale = std::sqrt((quads ? area : 2.0f * area) / targetFaces);
+	SplitLongEdges(positions, indices, MAX_EDGE_FRACTION * scale);
+
+	Vector<Level> levels(1);
+	MakeFinestLevel(positions, indices, levels[0]);
+	while (levels.Back().GetNumVertices() > 1 && levels.Size() < MAX_LEVELS) {
+		Level coarse;
+		MakeCoarserLevel(levels.Back(), coarse);
+		if (coarse.GetNumVertices() == levels.Back().GetNumVertices()) {
+			break;
+		}
+		levels.Push(coarse);
+	}
+	for (unsigned l = 0; l < levels.Size(); ++l) {
+		MakePhases(levels[l]);
+	}
+
+	// orientations from the coarsest level down, each level starting from the one above it
+	for (int l = (int)levels.Size() - 1; l >= 0; --l) {
+		Level& level = levels[l];
+		level.orientations_.Resize(level.GetNumVertices());
+		for (unsigned i = 0; i < level.GetNumVertices(); ++i) {
+			level.orientations_[i] = l + 1 < (int)levels.Size() ?
+				ProjectToTangent(levels[l + 1].orientations_[level.toCoarser_[i]], level.normals_[i]) :
+				AnyTangent(level.normals_[i]);
+		}
+		SmoothOrientations(level);
+	}
+
+	// then positions the same way
+	for (int l = (int)levels.Size() - 1; l >= 0; --l) {
+		Level& level = levels[l];
+		level.origins_.Resize(level.GetNumVertices());
+		for (unsigned i = 0; i < level.GetNumVertices(); ++i) {
+			if (l + 1 < (int)levels.Size()) {
+				Vector3 o = levels[l + 1].origins_[level.toCoarser_[i]];
+				level.origins_[i] = o - level.normals_[i] * level.normals_[i].DotProduct(o - level.positions_[i]);
+			}
+			else {
+				level.origins_[i] = level.positions_[i];
+			}
+		}
+		SmoothPositions(level, scale);
+	}
+
+	PODVector<Vector3> vertices;
+	PODVector<int> faces;
+	ExtractMesh(levels[0], scale, vertices, faces);
+	if (faces.Empty()) {
+		return false;
+	}
+
+	// drop the vertices no face uses
+	PODVector<int> remap(vertices.Size());
+	for (unsigned i = 0; i < remap.Size(); ++i) {
+		remap[i] = -1;
+	}
+	PODVector<Vector3> usedVertices;
+	for (unsigned i = 0; i < faces.Size(); i += faces[i] + 1) {
+		for (int k = 1; k <= faces[i]; ++k) {
+			int& v = faces[i + k];
+			if (remap[v] < 0) {
+				remap[v] = (int)usedVertices.Size();
+				usedVertices.Push(vertices[v]);
+			}
+			v = remap[v];
+		}
+	}
+
+	if (quads) {
+		VariantVector vertexList(usedVertices.Size());
+		for (unsigned i = 0; i < usedVertices.Size(); ++i) {
+			vertexList[i] = usedVertices[i];
+		}
+		VariantVector faceList(faces.Size());
+		for (unsigned i = 0; i < faces.Size(); ++i) {
+			faceList[i] = faces[i];
+		}
+		meshOut = NMesh_Make(vertexList, faceList);
+		return true;
+	}
+
+	PODVector<float> outPositions(3 * usedVertices.Size());
+	for (unsigned i = 0; i < usedVertices.Size(); ++i) {
+		outPositions[3 * i] = usedVertices[i].x_;
+		outPositions[3 * i + 1] = usedVertices[i].y_;
+		outPositions[3 * i + 2] = usedVertices[i].z_;
+	}
+	PODVector<int> outIndices;
+	for (unsigned i = 0; i < faces.Size(); i += faces[i] + 1) {
+		const int* v = &faces[i + 1];
+		int sides = faces[i];
+		// quads are split along their shorter diagonal, larger faces fanned
+		int first = 0;
+		if (sides == 4 && (usedVertices[v[1]] - usedVertices[v[3]]).LengthSquared() < (usedVertices[v[0]] - usedVertices[v[2]]).LengthSquared()) {
+			first = 1;
+		}
+		for (int k = 1; k + 1 < sides; ++k) {
+			outIndices.Push(v[first]);
+			outIndices.Push(v[(first + k) % sides]);
+			outIndices.Push(v[(first + k + 1) % sides]);
+		}
+	}
+	meshOut = TriMesh_MakePacked(outPositions, outIndices);
+	return true;
+}
@@ -0,0 +1,48 @@
+//
+// Copyright (c) 2016 - 2017 Mesh Consultants Inc.
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include <Urho3D/Core/Variant.h>
+
+namespace Geomlib {
+
+	// Field-aligned remeshing after Jakob et al., Instant Field-Aligned Meshes (2015).
+	// The mesh is refined until its edges are shorter than half the target edge length. A hierarchy of
+	// coarser vertex graphs is built by pairing neighbours, and a 4-RoSy orientation field and then a
+	// position field are smoothed from the coarsest graph down. Vertices whose lattice points coincide are
+	// collapsed, neighbouring lattice points are joined, and faces are traced around the joined graph.
+	// Inputs
+	//   meshIn: TriMesh to remesh
+	//   targetFaces: about how many faces the result should have
+	//   quads: output a quad dominant NMesh, otherwise a TriMesh
+	// Outputs
+	//   meshOut: the remeshed NMesh or TriMesh
+	// Returns false when meshIn is not valid or no faces could be extracted.
+	bool FieldRemesh(
+		const Urho3D::Variant& meshIn,
+		int targetFaces,
+		bool quads,
+		Urho3D::Variant& meshOut
+	);
+
+} // namespace Geomlib
@@ -0,0 +1,514 @@
+//
+// Copyright (c) 2016 - 2017 Mesh Consultants Inc.
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "Geomlib_HalfEdgeMesh.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "TriMesh.h"
+#include <utility>
+
+using namespace Urho3D;
+
+namespace Geomlib {
+
+	HalfEdgeMesh::HalfEdgeMesh() :
+		markStamp_(0)
+	{
+	}
+
+	bool HalfEdgeMesh::Build(const PODVector<Vector3>& vertices, const PODVector<int>& faces)
+	{
+		positions_.Clear();
+		vertexHalfEdge_.Clear();
+		heVertex_.Clear();
+		heNext_.Clear();
+		hePrev_.Clear();
+		heFace_.Clear();
+		faceHalfEdge_.Clear();
+		vertexMark_.Clear();
+		markStamp_ = 0;
+
+		int numVertices = (int)vertices.Size();
+		int numFaces = (int)faces.Size() / 3;
+		if (numFaces == 0 || faces.Size() % 3 != 0)
+			return false;
+
+		for (int i = 0; i < 3 * numFaces; ++i) {
+			if (faces[i] < 0 || faces[i] >= numVertices)
+				return false;
+		}
+
+		// sort face corners by undirected edge so twins end up next to each other
+		int numCorners = 3 * numFaces;
+		std::vector<std::pair<long long, int> > corners(numCorners);
+		for (int f = 0; f < numFaces; ++f) {
+			for (int k = 0; k < 3; ++k) {
+				long long i = faces[3 * f + k];
+				long long j = faces[3 * f + (k + 1) % 3];
+				if (i == j)
+					return false;
+				long long key = i < j ? i * numVertices + j : j * numVertices + i;
+				corners[3 * f + k] = std::make_pair(key, 3 * f + k);
+			}
+		}
+		std::sort(corners.begin(), corners.end());
+
+		// corner c = 3f + k holds the half-edge from faces[c] to the next corner of f
+		PODVector<int> cornerHalfEdge(numCorners);
+		int numEdges = 0;
+		for (int i = 0; i < numCorners; ) {
+			int j = i + 1;
+			while (j < numCorners && corners[j].first == corners[i].first)
+				++j;
+			if (j - i > 2)
+				return false;
+			int c0 = corners[i].second;
+			cornerHalfEdge[c0] = 2 * numEdges;
+			if (j - i == 2) {
+				// twins must run in opposite directions
+				int c1 = corners[i + 1].second;
+				if (faces[c0] == faces[c1])
+					return false;
+				cornerHalfEdge[c1] = 2 * numEdges + 1;
+			}
+			++numEdges;
+			i = j;
+		}
+
+		positions_ = vertices;
+		vertexHalfEdge_.Resize(numVertices);
+		heVertex_.Resize(2 * numEdges);
+		heNext_.Resize(2 * numEdges);
+		hePrev_.Resize(2 * numEdges);
+		heFace_.Resize(2 * numEdges);
+		faceHalfEdge_.Resize(numFaces);
+		for (int v = 0; v < numVertices; ++v)
+			vertexHalfEdge_[v] = -1;
+		for (int h = 0; h < 2 * numEdges; ++h) {
+			heVertex_[h] = -1;
+			heFace_[h] = -1;
+		}
+
+		PODVector<int> numOutgoing(numVertices);
+		for (int v = 0; v < numVertices; ++v)
+			numOutgoing[v] = 0;
+
+		for (int f = 0; f < numFaces; ++f) {
+			for (int k = 0; k < 3; ++k) {
+				int c = 3 * f + k;
+				int h = cornerHalfEdge[c];
+				heVertex_[h] = faces[3 * f + (k + 1) % 3];
+				heFace_[h] = f;
+				heNext_[h] = cornerHalfEdge[3 * f + (k + 1) % 3];
+				hePrev_[h] = cornerHalfEdge[3 * f + (k + 2) % 3];
+				if (vertexHalfEdge_[faces[c]] < 0)
+					vertexHalfEdge_[faces[c]] = h;
+				++numOutgoing[faces[c]];
+			}
+			faceHalfEdge_[f] = cornerHalfEdge[3 * f];
+		}
+
+		// boundary half-edges: each boundary vertex gets exactly one outgoing boundary half-edge
+		for (int e = 0; e < numEdges; ++e) {
+			int b = 2 * e + 1;
+			if (heVertex_[b] >= 0)
+				continue;
+			int from = heVertex_[b ^ 1];
+			heVertex_[b] = heVertex_[hePrev_[b ^ 1]];
+			if (heFace_[vertexHalfEdge_[from]] < 0)
+				return false;
+			vertexHalfEdge_[from] = b;
+			++numOutgoing[from];
+		}
+		for (int e = 0; e < numEdges; ++e) {
+			int b = 2 * e + 1;
+			if (heFace_[b] < 0)
+				Link(b, vertexHalfEdge_[heVertex_[b]]);
+		}
+
+		// a vertex ring that misses some of its outgoing half-edges joins several fans
+		for (int v = 0; v < numVertices; ++v) {
+			if (vertexHalfEdge_[v] < 0)
+				continue;
+			if (Valence(v) != numOutgoing[v])
+				return false;
+		}
+
+		return true;
+	}
+
+	void HalfEdgeMesh::GetMesh(PODVector<Vector3>& vertices, PODVector<int>& faces) const
+	{
+		vertices.Clear();
+		faces.Clear();
+
+		PODVector<int> vertexMap(positions_.Size());
+		for (unsigned v = 0; v < positions_.Size(); ++v) {
+			if (vertexHalfEdge_[v] >= 0) {
+				vertexMap[v] = (int)vertices.Size();
+				vertices.Push(positions_[v]);
+			}
+			else
+				vertexMap[v] = -1;
+		}
+
+		faces.Reserve(3 * faceHalfEdge_.Size());
+		for (unsigned f = 0; f < faceHalfEdge_.Size(); ++f) {
+			int h = faceHalfEdge_[f];
+			if (h < 0)
+				continue;
+			faces.Push(vertexMap[Source(h)]);
+			faces.Push(vertexMap[Target(h)]);
+			faces.Push(vertexMap[Target(heNext_[h])]);
+		}
+	}
+
+	int HalfEdgeMesh::Valence(int v) const
+	{
+		int start = vertexHalfEdge_[v];
+		if (start < 0)
+			return 0;
+		int valence = 0;
+		int h = start;
+		do {
+			++valence;
+			h = NextOutgoing(h);
+		} while (h != start);
+		return valence;
+	}
+
+	int HalfEdgeMesh::SplitEdge(int e, const Vector3& p)
+	{
+		int h = 2 * e;
+		int t = h + 1;
+		int b = Target(h);
+		bool hBoundary = IsBoundary(h);
+		bool tBoundary = IsBoundary(t);
+
+		// h: a->m, h2: m->b on the h side; t2: b->m, t: m->a on the t side
+		int m = AddVertex(p);
+		int h2 = AddEdge();
+		int t2 = h2 + 1;
+		heVertex_[h] = m;
+		heVertex_[h2] = b;
+		heVertex_[t2] = m;
+
+		if (!hBoundary) {
+			int hn = heNext_[h];
+			int hp = hePrev_[h];
+			int f0 = heFace_[h];
+			int f2 = AddFace();
+			int s = AddEdge();
+			heVertex_[s] = Target(hn);
+			heVertex_[s + 1] = m;
+
+			Link(h, s); Link(s, hp); Link(hp, h);
+			Link(h2, hn); Link(hn, s + 1); Link(s + 1, h2);
+			heFace_[s] = f0;
+			heFace_[h2] = heFace_[hn] = heFace_[s + 1] = f2;
+			faceHalfEdge_[f0] = h;
+			faceHalfEdge_[f2] = h2;
+		}
+		else {
+			Link(h2, heNext_[h]);
+			Link(h, h2);
+			heFace_[h2] = -1;
+		}
+
+		if (!tBoundary) {
+			int tn = heNext_[t];
+			int tp = hePrev_[t];
+			int f1 = heFace_[t];
+			int f3 = AddFace();
+			int s = AddEdge();
+			heVertex_[s] = Target(tn);
+			heVertex_[s + 1] = m;
+
+			Link(t, tn); Link(tn, s + 1); Link(s + 1, t);
+			Link(t2, s); Link(s, tp); Link(tp, t2);
+			heFace_[s + 1] = f1;
+			heFace_[t2] = heFace_[s] = heFace_[tp] = f3;
+			faceHalfEdge_[f1] = t;
+			faceHalfEdge_[f3] = t2;
+		}
+		else {
+			Link(hePrev_[t], t2);
+			Link(t2, t);
+			heFace_[t2] = -1;
+		}
+
+		vertexHalfEdge_[m] = tBoundary ? t : h2;
+		if (vertexHalfEdge_[b] == t)
+			vertexHalfEdge_[b] = t2;
+
+		return m;
+	}
+
+	bool HalfEdgeMesh::CanCollapse(int h) const
+	{
+		int t = h ^ 1;
+		int a = Source(h);
+		int b = Target(h);
+		bool hBoundary = IsBoundary(h);
+		bool tBoundary = IsBoundary(t);
+
+		// an interior edge between two boundary vertices would pinch the surface
+		if (!hBoundary && !tBoundary && IsBoundaryVertex(a) && IsBoundaryVertex(b))
+			return false;
+
+		// a face whose other two edges are both on the boundary would be left dangling
+		if (!hBoundary && IsBoundary(heNext_[h] ^ 1) && IsBoundary(hePrev_[h] ^ 1))
+			return false;
+		if (!tBoundary && IsBoundary(heNext_[t] ^ 1) && IsBoundary(hePrev_[t] ^ 1))
+			return false;
+
+		// boundary loops keep at least three edges
+		if (hBoundary && heNext_[heNext_[heNext_[h]]] == h)
+			return false;
+		if (tBoundary && heNext_[heNext_[heNext_[t]]] == t)
+			return false;
+
+		// link condition: the only common neighbours of a and b are the opposite vertices
+		int c = hBoundary ? -1 : Target(heNext_[h]);
+		int d = tBoundary ? -1 : Target(heNext_[t]);
+
+		if (vertexMark_.Size() < positions_.Size()) {
+			unsigned oldSize = vertexMark_.Size();
+			vertexMark_.Resize(positions_.Size());
+			for (unsigned i = oldSize; i < vertexMark_.Size(); ++i)
+				vertexMark_[i] = 0;
+		}
+		++markStamp_;
+
+		int start = vertexHalfEdge_[a];
+		int x = start;
+		do {
+			vertexMark_[Target(x)] = markStamp_;
+			x = NextOutgoing(x);
+		} while (x != start);
+
+		start = vertexHalfEdge_[b];
+		x = start;
+		do {
+			int n = Target(x);
+			if (vertexMark_[n] == markStamp_ && n != c && n != d)
+				return false;
+			x = NextOutgoing(x);
+		} while (x != start);
+
+		// a lone tetrahedron passes the vertex test but would fold flat
+		if (!hBoundary && !tBoundary && Valence(a) == 3 && Valence(b) == 3 && Valence(c) == 3 && Valence(d) == 3)
+			return false;
+
+		return true;
+	}
+
+	void HalfEdgeMesh::CollapseEdge(int h, const Vector3& p)
+	{
+		int t = h ^ 1;
+		int a = Source(h);
+		int b = Target(h);
+		bool hBoundary = IsBoundary(h);
+		bool tBoundary = IsBoundary(t);
+		int hn = heNext_[h];
+		int hp = hePrev_[h];
+		int tn = heNext_[t];
+		int tp = hePrev_[t];
+
+		// everything that left a now leaves b
+		int start = vertexHalfEdge_[a];
+		int x = start;
+		do {
+			heVertex_[x ^ 1] = b;
+			x = NextOutgoing(x);
+		} while (x != start);
+
+		// h side: face (a, b, c) goes, hn takes over the place of a->c
+		if (!hBoundary) {
+			int c = Target(hn);
+			Replace(hp ^ 1, hn);
+			if (vertexHalfEdge_[c] == hp)
+				vertexHalfEdge_[c] = hn ^ 1;
+			faceHalfEdge_[heFace_[h]] = -1;
+			RemoveEdge(hp >> 1);
+		}
+		else
+			Link(hp, hn);
+
+		// t side: face (b, a, d) goes, tp takes over the place of d->a
+		if (!tBoundary) {
+			int d = Target(tn);
+			Replace(tn ^ 1, tp);
+			if (vertexHalfEdge_[d] == (tn ^ 1))
+				vertexHalfEdge_[d] = tp;
+			faceHalfEdge_[heFace_[t]] = -1;
+			RemoveEdge(tn >> 1);
+		}
+		else
+			Link(tp, tn);
+
+		RemoveEdge(h >> 1);
+		vertexHalfEdge_[a] = -1;
+
+		positions_[b] = p;
+		vertexHalfEdge_[b] = hn;
+		AdjustOutgoing(b);
+	}
+
+	bool HalfEdgeMesh::CanFlip(int e) const
+	{
+		int h = 2 * e;
+		int t = h + 1;
+		if (IsBoundary(h) || IsBoundary(t))
+			return false;
+
+		int c = Target(heNext_[h]);
+		int d = Target(heNext_[t]);
+		if (c == d)
+			return false;
+
+		// the new diagonal must not exist already
+		int start = vertexHalfEdge_[c];
+		int x = start;
+		do {
+			if (Target(x) == d)
+				return false;
+			x = NextOutgoing(x);
+		} while (x != start);
+
+		return true;
+	}
+
+	void HalfEdgeMesh::FlipEdge(int e)
+	{
+		int h = 2 * e;
+		int t = h + 1;
+		int a = Source(h);
+		int b = Target(h);
+		int hn = heNext_[h];
+		int hp = hePrev_[h];
+		int tn = heNext_[t];
+		int tp = hePrev_[t];
+		int f0 = heFace_[h];
+		int f1 = heFace_[t];
+
+		// faces (a, b, c) and (b, a, d) become (c, a, d) and (d, b, c)
+		heVertex_[h] = Target(hn);
+		heVertex_[t] = Target(tn);
+
+		Link(hp, tn); Link(tn, h); Link(h, hp);
+		Link(tp, hn); Link(hn, t); Link(t, tp);
+		heFace_[tn] = f0;
+		heFace_[hn] = f1;
+		faceHalfEdge_[f0] = h;
+		faceHalfEdge_[f1] = t;
+
+		if (vertexHalfEdge_[a] == h)
+			vertexHalfEdge_[a] = tn;
+		if (vertexHalfEdge_[b] == t)
+			vertexHalfEdge_[b] = hn;
+	}
+
+	int HalfEdgeMesh::AddVertex(const Vector3& p)
+	{
+		positions_.Push(p);
+		vertexHalfEdge_.Push(-1);
+		return (int)positions_.Size() - 1;
+	}
+
+	int HalfEdgeMesh::AddEdge()
+	{
+		int h = (int)heVertex_.Size();
+		for (int i = 0; i < 2; ++i) {
+			heVertex_.Push(-1);
+			heNext_.Push(-1);
+			hePrev_.Push(-1);
+			heFace_.Push(-1);
+		}
+		return h;
+	}
+
+	int HalfEdgeMesh::AddFace()
+	{
+		faceHalfEdge_.Push(-1);
+		return (int)faceHalfEdge_.Size() - 1;
+	}
+
+	void HalfEdgeMesh::Replace(int old, int h)
+	{
+		int f = heFace_[old];
+		Link(hePrev_[old], h);
+		Link(h, heNext_[old]);
+		heFace_[h] = f;
+		if (f >= 0 && faceHalfEdge_[f] == old)
+			faceHalfEdge_[f] = h;
+	}
+
+	void HalfEdgeMesh::AdjustOutgoing(int v)
+	{
+		int start = vertexHalfEdge_[v];
+		int h = start;
+		do {
+			if (IsBoundary(h)) {
+				vertexHalfEdge_[v] = h;
+				return;
+			}
+			h = NextOutgoing(h);
+		} while (h != start);
+	}
+
+	void HalfEdgeMesh::RemoveEdge(int e)
+	{
+		heVertex_[2 * e] = -1;
+		heVertex_[2 * e + 1] = -1;
+	}
+	bool HalfEdgeMesh_FromTriMesh(const Variant& tri_mesh, HalfEdgeMesh& mesh)
+	{
+		TriMeshView view(tri_mesh);
+		if (!view.IsValid())
+			return false;
+
+		PODVector<Vector3> vertices(view.GetNumVertices());
+		for (unsigned i = 0; i < view.GetNumVertices(); ++i)
+			vertices[i] = view.GetVertex(i);
+		PODVector<int> faces(3 * view.GetNumFaces());
+		memcpy(&faces[0], view.GetIndices(), faces.Size() * sizeof(int));
+
+		return mesh.Build(vertices, faces);
+	}
+
+	Variant HalfEdgeMesh_ToTriMesh(const HalfEdgeMesh& mesh)
+	{
+		PODVector<Vector3> vertices;
+		PODVector<int> faces;
+		mesh.GetMesh(vertices, faces);
+
+		PODVector<float> positions(3 * vertices.Size());
+		if (!vertices.Empty())
+			memcpy(&positions[0], vertices[0].Data(), positions.Size() * sizeof(float));
+
+		return TriMesh_MakePacked(positions, faces);
+	}
+}
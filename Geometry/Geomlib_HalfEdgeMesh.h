@@ -0,0 +1,120 @@
+//
+// Copyright (c) 2016 - 2017 Mesh Consultants Inc.
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include <Urho3D/Container/Vector.h>
+#include <Urho3D/Core/Variant.h>
+#include <Urho3D/Math/Vector3.h>
+
+namespace Geomlib {
+
+	// Half-edge triangle mesh for local topological edits: edge split, collapse and flip in place.
+	// Half-edges are stored in twin pairs, so edge e owns half-edges 2e and 2e + 1 and Twin(h) == h ^ 1.
+	// Boundary half-edges are stored explicitly with face -1, which lets every vertex ring and boundary
+	// loop be walked with Next/Twin alone. A boundary vertex always keeps its outgoing boundary half-edge
+	// as GetVertexHalfEdge, so IsBoundaryVertex is O(1).
+	// Edits never renumber live elements: removed vertices, edges and faces are flagged and only
+	// dropped when the mesh is written out with GetMesh.
+	class HalfEdgeMesh
+	{
+	public:
+		HalfEdgeMesh();
+
+		// Builds from an indexed triangle list.
+		// Returns false unless the faces form an oriented 2-manifold, possibly with boundary.
+		bool Build(const Urho3D::PODVector<Urho3D::Vector3>& vertices, const Urho3D::PODVector<int>& faces);
+
+		// Writes the live elements out as an indexed triangle list, dropping unreferenced vertices
+		void GetMesh(Urho3D::PODVector<Urho3D::Vector3>& vertices, Urho3D::PODVector<int>& faces) const;
+
+		// element slots, including removed ones
+		unsigned GetNumVertices() const { return positions_.Size(); }
+		unsigned GetNumEdges() const { return heVertex_.Size() / 2; }
+		unsigned GetNumFaces() const { return faceHalfEdge_.Size(); }
+
+		bool IsVertexAlive(int v) const { return vertexHalfEdge_[v] >= 0; }
+		bool IsEdgeAlive(int e) const { return heVertex_[2 * e] >= 0; }
+		bool IsFaceAlive(int f) const { return faceHalfEdge_[f] >= 0; }
+
+		// traversal
+		int Twin(int h) const { return h ^ 1; }
+		int Next(int h) const { return heNext_[h]; }
+		int Prev(int h) const { return hePrev_[h]; }
+		int Target(int h) const { return heVertex_[h]; }
+		int Source(int h) const { return heVertex_[h ^ 1]; }
+		int Face(int h) const { return heFace_[h]; }
+		int GetVertexHalfEdge(int v) const { return vertexHalfEdge_[v]; }
+		int GetFaceHalfEdge(int f) const { return faceHalfEdge_[f]; }
+		// next outgoing half-edge around the source vertex of h
+		int NextOutgoing(int h) const { return heNext_[h ^ 1]; }
+
+		bool IsBoundary(int h) const { return heFace_[h] < 0; }
+		bool IsBoundaryEdge(int e) const { return heFace_[2 * e] < 0 || heFace_[2 * e + 1] < 0; }
+		bool IsBoundaryVertex(int v) const { return heFace_[vertexHalfEdge_[v]] < 0; }
+		int Valence(int v) const;
+
+		const Urho3D::Vector3& GetPosition(int v) const { return positions_[v]; }
+		void SetPosition(int v, const Urho3D::Vector3& p) { positions_[v] = p; }
+		float EdgeLength(int e) const { return (positions_[heVertex_[2 * e]] - positions_[heVertex_[2 * e + 1]]).Length(); }
+
+		// Inserts a vertex at p on edge e and splits the faces on either side; returns the new vertex
+		int SplitEdge(int e, const Urho3D::Vector3& p);
+
+		// Whether collapsing h merges its source into its target without breaking the manifold
+		bool CanCollapse(int h) const;
+		// Removes the source vertex of h, moving its target to p. Check CanCollapse first.
+		void CollapseEdge(int h, const Urho3D::Vector3& p);
+
+		// Whether the two faces on edge e can swap diagonals
+		bool CanFlip(int e) const;
+		// Replaces edge e by the other diagonal of its two faces. Check CanFlip first.
+		void FlipEdge(int e);
+
+	private:
+		int AddVertex(const Urho3D::Vector3& p);
+		int AddEdge();
+		int AddFace();
+		void Link(int h, int next) { heNext_[h] = next; hePrev_[next] = h; }
+		// hands the place of half-edge old in its face or boundary loop over to h
+		void Replace(int old, int h);
+		// makes a boundary vertex point at its outgoing boundary half-edge again
+		void AdjustOutgoing(int v);
+		void RemoveEdge(int e);
+
+		Urho3D::PODVector<Urho3D::Vector3> positions_;
+		Urho3D::PODVector<int> vertexHalfEdge_;
+		Urho3D::PODVector<int> heVertex_;
+		Urho3D::PODVector<int> heNext_;
+		Urho3D::PODVector<int> hePrev_;
+		Urho3D::PODVector<int> heFace_;
+		Urho3D::PODVector<int> faceHalfEdge_;
+
+		// scratch marks for neighbourhood tests
+		mutable Urho3D::PODVector<unsigned> vertexMark_;
+		mutable unsigned markStamp_;
+	};
+	// Builds mesh from a TriMesh in either layout; false if it is not an oriented manifold
+	bool HalfEdgeMesh_FromTriMesh(const Urho3D::Variant& tri_mesh, HalfEdgeMesh& mesh);
+	// Packed TriMesh holding the live elements of mesh
+	Urho3D::Variant HalfEdgeMesh_ToTriMesh(const HalfEdgeMesh& mesh);
+}
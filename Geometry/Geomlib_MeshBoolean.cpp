@@ -0,0 +1,893 @@
+//
+// Copyright (c) 2016 - 2017 Mesh Consultants Inc.
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "Geomlib_MeshBoolean.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <set>
+#include <vector>
+
+#include <Urho3D/Math/MathDefs.h>
+
+#include <igl/parallel_for.h>
+
+#include "Geomlib_TriTriIntersection.h"
+#include "TriMesh.h"
+
+using namespace Urho3D;
+
+namespace {
+
+	// below this many cut faces they are retriangulated on the calling thread
+	const int MIN_PARALLEL_CUT_FACES = 64;
+	// triangles each surface piece is sampled at to tell whether it is inside the other mesh
+	const unsigned SAMPLES_PER_PATCH = 16;
+	// a sample whose winding numbers average this far from one half is clearly inside or outside
+	const double CONCLUSIVE_SCORE = 0.25;
+	// below this many samples their winding numbers are computed on the calling thread
+	const int MIN_PARALLEL_SAMPLES = 4;
+	// winding numbers are sampled this far in front of and behind a piece, relative to the bounding box diagonal
+	const double SIDE_OFFSET = 1e-5;
+
+	// Triangulation of one face cut by intersection segments, worked in the 2D coordinates of the face's
+	// dominant plane with the face's orientation kept
+	class FaceSplitter
+	{
+	public:
+		FaceSplitter(const PODVector<Vector3>& positions, const int* corners) :
+			positions_(positions)
+		{
+			double n[3];
+			FaceNormal(positions, corners, n);
+			unsigned axis = 0;
+			if (std::abs(n[1]) > std::abs(n[axis])) {
+				axis = 1;
+			}
+			if (std::abs(n[2]) > std::abs(n[axis])) {
+				axis = 2;
+			}
+			uAxis_ = (axis + 1) % 3;
+			vAxis_ = (axis + 2) % 3;
+			if (n[axis] < 0.0) {
+				std::swap(uAxis_, vAxis_);
+			}
+
+			for (unsigned i = 0; i < 3; ++i) {
+				AddVertex(corners[i]);
+			}
+			double size = 0.0;
+			for (unsigned i = 0; i < 3; ++i) {
+				unsigned j = (i + 1) % 3;
+				size = Max(size, std::abs(u_[j] - u_[i]) + std::abs(v_[j] - v_[i]));
+			}
+			tolerance_ = 1e-9 * size;
+
+			triangles_.push_back(Triangle());
+			SetTriangle(0, 0, 1, 2);
+		}
+
+		static void FaceNormal(const PODVector<Vector3>& positions, const int* corners, double* n)
+		{
+			double e1[3], e2[3];
+			for (unsigned i = 0; i < 3; ++i) {
+				e1[i] = (double)positions[corners[1]].Data()[i] - positions[corners[0]].Data()[i];
+				e2[i] = (double)positions[corners[2]].Data()[i] - positions[corners[0]].Data()[i];
+			}
+			n[0] = e1[1] * e2[2] - e1[2] * e2[1];
+			n[1] = e1[2] * e2[0] - e1[0] * e2[2];
+			n[2] = e1[0] * e2[1] - e1[1] * e2[0];
+		}
+
+		bool HasVertex(int global) const
+		{
+			return locals_.find(global) != locals_.end();
+		}
+
+		// returns the local index of a vertex, adding it if needed
+		int AddVertex(int global)
+		{
+			std::map<int, int>::const_iterator it = locals_.find(global);
+			if (it != locals_.end()) {
+				return it->second;
+			}
+			int local = (int)globals_.Size();
+			locals_[global] = local;
+			globals_.Push(global);
+			u_.Push(positions_[global].Data()[uAxis_]);
+			v_.Push(positions_[global].Data()[vAxis_]);
+			return local;
+		}
+
+		// splits edge a -> b, which must be on the outline, at p
+		void InsertOnEdge(int p, int a, int b)
+		{
+			int t = FindTriangle(a, b);
+			if (t < 0 || p == a || p == b) {
+				return;
+			}
+			int c = ThirdVertex(t, a, b);
+			SetTriangle(t, a, p, c);
+			AddTriangle(p, b, c);
+		}
+
+		void InsertInside(int p)
+		{
+			// the triangle p is deepest inside, which is always found even when rounding puts p just outside
+			int best = 0;
+			double bestDepth = -M_INFINITY;
+			unsigned bestEdge = 0;
+			for (unsigned t = 0; t < triangles_.size(); ++t) {
+				double depth = M_INFINITY;
+				unsigned edge = 0;
+				for (unsigned i = 0; i < 3; ++i) {
+					int a = triangles_[t].v_[i];
+					int b = triangles_[t].v_[(i + 1) % 3];
+					double length = std::abs(u_[b] - u_[a]) + std::abs(v_[b] - v_[a]);
+					double d = length > 0.0 ? Orient(a, b, p) / length : 0.0;
+					if (d < depth) {
+						depth = d;
+						edge = i;
+					}
+				}
+				if (depth > bestDepth) {
+					bestDepth = depth;
+					best = t;
+					bestEdge = edge;
+				}
+			}
+
+			Triangle tri = triangles_[best];
+			int a = tri.v_[bestEdge];
+			int b = tri.v_[(bestEdge + 1) % 3];
+			int c = tri.v_[(bestEdge + 2) % 3];
+			int twin = FindTriangle(b, a);
+			if (bestDepth <= tolerance_ && twin >= 0) {
+				// on the edge shared with twin, split both
+				int d = ThirdVertex(twin, b, a);
+				SetTriangle(best, a, p, c);
+				AddTriangle(p, b, c);
+				SetTriangle(twin, b, p, d);
+				AddTriangle(p, a, d);
+				return;
+			}
+
+			SetTriangle(best, a, b, p);
+			AddTriangle(b, c, p);
+			AddTriangle(c, a, p);
+		}
+
+		// makes the segment pq an edge by flipping the edges that cross it (Sloan, A fast algorithm for
+		// generating constrained Delaunay triangulations)
+		bool RecoverEdge(int p, int q)
+		{
+			unsigned maxFlips = 4 * (unsigned)triangles_.size() * (unsigned)triangles_.size() + 16;
+			for (unsigned flips = 0; flips < maxFlips; ++flips) {
+				if (FindTriangle(p, q) >= 0 || FindTriangle(q, p) >= 0) {
+					constrained_.insert(EdgeKey(p, q));
+					return true;
+				}
+
+				bool flipped = false;
+				for (unsigned t = 0; t < triangles_.size() && !flipped; ++t) {
+					for (unsigned i = 0; i < 3 && !flipped; ++i) {
+						int a = triangles_[t].v_[i];
+						int b = triangles_[t].v_[(i + 1) % 3];
+						if (a == p || a == q || b == p || b == q || constrained_.count(EdgeKey(a, b))) {
+							continue;
+						}
+						if (Orient(p, q, a) * Orient(p, q, b) >= 0.0 || Orient(a, b, p) * Orient(a, b, q) >= 0.0) {
+							continue;
+						}
+						flipped = FlipIfConvex(t, a, b);
+					}
+				}
+				if (!flipped) {
+					return false;
+				}
+			}
+			return false;
+		}
+
+		// Lawson flips towards the Delaunay triangulation that keeps the outline and recovered segments
+		void MakeDelaunay()
+		{
+			unsigned maxPasses = (unsigned)triangles_.size() + 8;
+			for (unsigned pass = 0; pass < maxPasses; ++pass) {
+				bool changed = false;
+				for (unsigned t = 0; t < triangles_.size(); ++t) {
+					for (unsigned i = 0; i < 3; ++i) {
+						int a = triangles_[t].v_[i];
+						int b = triangles_[t].v_[(i + 1) % 3];
+						if (a > b || constrained_.count(EdgeKey(a, b))) {
+							continue;
+						}
+						int twin = FindTriangle(b, a);
+						if (twin < 0) {
+							continue;
+						}
+						int c = ThirdVertex(t, a, b);
+						int d = ThirdVertex(twin, b, a);
+						if (InCircle(a, b, c, d) > 0.0 && FlipIfConvex(t, a, b)) {
+							changed = true;
+							break;
+						}
+					}
+				}
+				if (!changed) {
+					return;
+				}
+			}
+		}
+
+		void GetTriangles(PODVector<int>& indices) const
+		{
+			for (unsigned t = 0; t < triangles_.size(); ++t) {
+				for (unsigned i = 0; i < 3; ++i) {
+					indices.Push(globals_[triangles_[t].v_[i]]);
+				}
+			}
+		}
+
+	private:
+		struct Triangle
+		{
+			int v_[3];
+		};
+
+		static std::pair<int, int> EdgeKey(int a, int b)
+		{
+			return a < b ? std::make_pair(a, b) : std::make_pair(b, a);
+		}
+
+		double Orient(int a, int b, int c) const
+		{
+			return (u_[b] - u_[a]) * (v_[c] - v_[a]) - (v_[b] - v_[a]) * (u_[c] - u_[a]);
+		}
+
+		// positive when d is inside the circle through the counterclockwise triangle abc
+		double InCircle(int a, int b, int c, int d) const
+		{
+			double adu = u_[a] - u_[d], adv = v_[a] - v_[d];
+			double bdu = u_[b] - u_[d], bdv = v_[b] - v_[d];
+			double cdu = u_[c] - u_[d], cdv = v_[c] - v_[d];
+			double ad = adu * adu + adv * adv;
+			double bd = bdu * bdu + bdv * bdv;
+			double cd = cdu * cdu + cdv * cdv;
+			return adu * (bdv * cd - bd * cdv) - adv * (bdu * cd - bd * cdu) + ad * (bdu * cdv - bdv * cdu);
+		}
+
+		int FindTriangle(int a, int b) const
+		{
+			std::map<std::pair<int, int>, int>::const_iterator it = edges_.find(std::make_pair(a, b));
+			return it != edges_.end() ? it->second : -1;
+		}
+
+		int ThirdVertex(int t, int a, int b) const
+		{
+			const Triangle& tri = triangles_[t];
+			for (unsigned i = 0; i < 3; ++i) {
+				if (tri.v_[i] != a && tri.v_[i] != b) {
+					return tri.v_[i];
+				}
+			}
+			return a;
+		}
+
+		void SetTriangle(int t, int a, int b, int c)
+		{
+			Triangle& tri = triangles_[t];
+			for (unsigned i = 0; i < 3; ++i) {
+				std::map<std::pair<int, int>, int>::iterator it = edges_.find(std::make_pair(tri.v_[i], tri.v_[(i + 1) % 3]));
+				if (it != edges_.end() && it->second == t) {
+					edges_.erase(it);
+				}
+			}
+			tri.v_[0] = a;
+			tri.v_[1] = b;
+			tri.v_[2] = c;
+			edges_[std::make_pair(a, b)] = t;
+			edges_[std::make_pair(b, c)] = t;
+			edges_[std::make_pair(c, a)] = t;
+		}
+
+		void AddTriangle(int a, int b, int c)
+		{
+			Triangle tri;
+			tri.v_[0] = tri.v_[1] = tri.v_[2] = -1;
+			triangles_.push_back(tri);
+			SetTriangle((int)triangles_.size() - 1, a, b, c);
+		}
+
+		// replaces edge a -> b of t and its twin by the other diagonal of their quad, if the quad is convex
+		bool FlipIfConvex(int t, int a, int b)
+		{
+			int twin = FindTriangle(b, a);
+			if (twin < 0) {
+				return false;
+			}
+			int c = ThirdVertex(t, a, b);
+			int d = ThirdVertex(twin, b, a);
+			if (Orient(c, d, a) * Orient(c, d, b) >= 0.0) {
+				return false;
+			}
+			SetTriangle(t, a, d, c);
+			SetTriangle(twin, d, b, c);
+			return true;
+		}
+
+		const PODVector<Vector3>& positions_;
+		unsigned uAxis_;
+		unsigned vAxis_;
+		double tolerance_;
+		PODVector<double> u_;
+		PODVector<double> v_;
+		PODVector<int> globals_;
+		std::map<int, int> locals_;
+		std::vector<Triangle> triangles_;
+		std::map<std::pair<int, int>, int> edges_;
+		std::set<std::pair<int, int> > constrained_;
+	};
+
+	// Generalized winding number of a closed mesh at q, from the solid angles of its faces
+	// (Van Oosterom and Strackee, The Solid Angle of a Plane Triangle)
+	double WindingNumber(const PODVector<Vector3>& positions, const int* indices, unsigned numFaces, unsigned offset, const double* q)
+	{
+		double sum = 0.0;
+		for (unsigned f = 0; f < numFaces; ++f) {
+			double v[3][3];
+			double length[3];
+			for (unsigned i = 0; i < 3; ++i) {
+				const float* p = positions[offset + indices[3 * f + i]].Data();
+				v[i][0] = p[0] - q[0];
+				v[i][1] = p[1] - q[1];
+				v[i][2] = p[2] - q[2];
+				length[i] = std::sqrt(v[i][0] * v[i][0] + v[i][1] * v[i][1] + v[i][2] * v[i][2]);
+			}
+			double det =
+				v[0][0] * (v[1][1] * v[2][2] - v[1][2] * v[2][1]) -
+				v[0][1] * (v[1][0] * v[2][2] - v[1][2] * v[2][0]) +
+				v[0][2] * (v[1][0] * v[2][1] - v[1][1] * v[2][0]);
+			double dot01 = v[0][0] * v[1][0] + v[0][1] * v[1][1] + v[0][2] * v[1][2];
+			double dot02 = v[0][0] * v[2][0] + v[0][1] * v[2][1] + v[0][2] * v[2][2];
+			double dot12 = v[1][0] * v[2][0] + v[1][1] * v[2][1] + v[1][2] * v[2][2];
+			double denominator = length[0] * length[1] * length[2] + dot01 * length[2] + dot02 * length[1] + dot12 * length[0];
+			sum += 2.0 * std::atan2(det, denominator);
+		}
+		return sum / (4.0 * M_PI);
+	}
+
+	struct UnionFind
+	{
+		UnionFind(unsigned size) :
+			parent_(size)
+		{
+			for (unsigned i = 0; i < size; ++i) {
+				parent_[i] = i;
+			}
+		}
+
+		unsigned Find(unsigned i)
+		{
+			while (parent_[i] != i) {
+				parent_[i] = parent_[parent_[i]];
+				i = parent_[i];
+			}
+			return i;
+		}
+
+		void Join(unsigned a, unsigned b)
+		{
+			a = Find(a);
+			b = Find(b);
+			if (a != b) {
+				parent_[Max(a, b)] = Min(a, b);
+			}
+		}
+
+		PODVector<unsigned> parent_;
+	};
+
+	// Retriangulates the faces of one mesh that the intersection segments cross.
+	// Intersection points are numbered after the vertices of both meshes, and all vertices are
+	// output as their welded number.
+	void SplitFaces(
+		int mesh,
+		const PODVector<Vector3>& positions,
+		const PODVector<int>& welded,
+		const int* indices,
+		unsigned numFaces,
+		unsigned vertexOffset,
+		unsigned pointOffset,
+		const PODVector<Geomlib::MeshIntersectionPoint>& points,
+		const PODVector<Geomlib::MeshIntersectionSegment>& segments,
+		PODVector<int>& triangles
+	)
+	{
+		Vector<PODVector<int> > faceSegments(numFaces);
+		for (unsigned i = 0; i < segments.Size(); ++i) {
+			faceSegments[mesh == 0 ? segments[i].faceA_ : segments[i].faceB_].Push(i);
+		}
+		PODVector<int> cutFaces;
+		for (unsigned f = 0; f < numFaces; ++f) {
+			if (!faceSegments[f].Empty()) {
+				cutFaces.Push(f);
+			}
+		}
+
+		Vector<PODVector<int> > cutTriangles(cutFaces.Size());
+		igl::parallel_for(
+			(int)cutFaces.Size(),
+			[&](int k) {
+				int f = cutFaces[k];
+				int corners[3];
+				for (unsigned i = 0; i < 3; ++i) {
+					corners[i] = welded[vertexOffset + indices[3 * f + i]];
+				}
+				if (corners[0] == corners[1] || corners[1] == corners[2] || corners[2] == corners[0]) {
+					cutTriangles[k].Push(corners[0]);
+					cutTriangles[k].Push(corners[1]);
+					cutTriangles[k].Push(corners[2]);
+					return;
+				}
+				FaceSplitter splitter(positions, corners);
+
+				// points on the outline go in first, in the order they have along their edge;
+				// a neighbouring face orders them the same way, so the two sides of the edge match
+				PODVector<int> facePoints;
+				for (unsigned i = 0; i < faceSegments[f].Size(); ++i) {
+					const Geomlib::MeshIntersectionSegment& segment = segments[faceSegments[f][i]];
+					facePoints.Push(segment.start_);
+					facePoints.Push(segment.end_);
+				}
+				std::sort(facePoints.Begin(), facePoints.End());
+				facePoints.Resize((unsigned)(std::unique(facePoints.Begin(), facePoints.End()) - facePoints.Begin()));
+
+				for (unsigned e = 0; e < 3; ++e) {
+					int start = indices[3 * f + e];
+					int end = indices[3 * f + (e + 1) % 3];
+					int low = Min(start, end);
+					int high = Max(start, end);
+					const Vector3& from = positions[vertexOffset + low];
+					Vector3 direction = positions[vertexOffset + high] - from;
+
+					std::vector<std::pair<float, int> > onEdge;
+					for (unsigned i = 0; i < facePoints.Size(); ++i) {
+						const Geomlib::MeshIntersectionPoint& point = points[facePoints[i]];
+						if (point.edgeMesh_ == mesh && point.edgeStart_ == low && point.edgeEnd_ == high) {
+							onEdge.push_back(std::make_pair((point.position_ - from).DotProduct(direction), facePoints[i]));
+						}
+					}
+					std::sort(onEdge.begin(), onEdge.end());
+					if (start != low) {
+						std::reverse(onEdge.begin(), onEdge.end());
+					}
+
+					int previous = splitter.AddVertex(welded[vertexOffset + start]);
+					int last = splitter.AddVertex(welded[vertexOffset + end]);
+					for (unsigned i = 0; i < onEdge.size(); ++i) {
+						int p = splitter.AddVertex(welded[pointOffset + onEdge[i].second]);
+						splitter.InsertOnEdge(p, previous, last);
+						previous = p;
+					}
+				}
+
+				for (unsigned i = 0; i < facePoints.Size(); ++i) {
+					int point = welded[pointOffset + facePoints[i]];
+					if (points[facePoints[i]].edgeMesh_ != mesh && !splitter.HasVertex(point)) {
+						splitter.InsertInside(splitter.AddVertex(point));
+					}
+				}
+				splitter.MakeDelaunay();
+
+				for (unsigned i = 0; i < faceSegments[f].Size(); ++i) {
+					const Geomlib::MeshIntersectionSegment& segment = segments[faceSegments[f][i]];
+					int start = welded[pointOffset + segment.start_];
+					int end = welded[pointOffset + segment.end_];
+					if (start != end) {
+						splitter.RecoverEdge(splitter.AddVertex(start), splitter.AddVertex(end));
+					}
+				}
+				splitter.MakeDelaunay();
+
+				splitter.GetTriangles(cutTriangles[k]);
+			},
+			MIN_PARALLEL_CUT_FACES
+		);
+
+		unsigned next = 0;
+		for (unsigned f = 0; f < numFaces; ++f) {
+			if (next < cutFaces.Size() && cutFaces[next] == (int)f) {
+				triangles.Push(cutTriangles[next]);
+				++next;
+				continue;
+			}
+			for (unsigned i = 0; i < 3; ++i) {
+				triangles.Push(welded[vertexOffset + indices[3 * f + i]]);
+			}
+		}
+	}
+
+	// Groups triangles into pieces of surface bounded by the intersection curves, numbered from 0.
+	// Pieces meeting across a curve are returned as neighbours.
+	unsigned FindPatches(
+		const PODVector<int>& triangles,
+		const std::set<std::pair<int, int> >& curveEdges,
+		PODVector<unsigned>& patches,
+		std::vector<std::vector<unsigned> >& neighbours
+	)
+	{
+		unsigned numTriangles = triangles.Size() / 3;
+		std::vector<std::pair<std::pair<int, int>, unsigned> > edges;
+		edges.reserve(triangles.Size());
+		for (unsigned t = 0; t < numTriangles; ++t) {
+			for (unsigned i = 0; i < 3; ++i) {
+				int a = triangles[3 * t + i];
+				int b = triangles[3 * t + (i + 1) % 3];
+				edges.push_back(std::make_pair(std::make_pair(Min(a, b), Max(a, b)), t));
+			}
+		}
+		std::sort(edges.begin(), edges.end());
+
+		UnionFind sets(numTriangles);
+		for (unsigned i = 0; i + 1 < edges.size(); ++i) {
+			if (edges[i].first == edges[i + 1].first && !curveEdges.count(edges[i].first)) {
+				sets.Join(edges[i].second, edges[i + 1].second);
+			}
+		}
+
+		std::map<unsigned, unsigned> numbers;
+		patches.Resize(numTriangles);
+		for (unsigned t = 0; t < numTriangles; ++t) {
+			unsigned root = sets.Find(t);
+			std::map<unsigned, unsigned>::const_iterator it = numbers.find(root);
+			if (it == numbers.end()) {
+				it = numbers.insert(std::make_pair(root, (unsigned)numbers.size())).first;
+			}
+			patches[t] = it->second;
+		}
+
+		neighbours.assign(numbers.size(), std::vector<unsigned>());
+		for (unsigned i = 0; i + 1 < edges.size(); ++i) {
+			if (edges[i].first != edges[i + 1].first || !curveEdges.count(edges[i].first)) {
+				continue;
+			}
+			unsigned a = patches[edges[i].second];
+			unsigned b = patches[edges[i + 1].second];
+			if (a != b) {
+				neighbours[a].push_back(b);
+				neighbours[b].push_back(a);
+			}
+		}
+		return (unsigned)numbers.size();
+	}
+
+	// Winding numbers of the other mesh just in front of and behind a triangle
+	void SampleSides(
+		const PODVector<Vector3>& positions,
+		const PODVector<int>& triangles,
+		unsigned t,
+		const int* otherIndices,
+		unsigned otherNumFaces,
+		unsigned otherOffset,
+		double offset,
+		double& front,
+		double& back
+	)
+	{
+		int corners[3] = { triangles[3 * t], triangles[3 * t + 1], triangles[3 * t + 2] };
+		double n[3];
+		FaceSplitter::FaceNormal(positions, corners, n);
+		double length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+		if (length == 0.0) {
+			front = back = 0.5;
+			return;
+		}
+		double frontPoint[3], backPoint[3];
+		for (unsigned k = 0; k < 3; ++k) {
+			double centroid = ((double)positions[corners[0]].Data()[k] + positions[corners[1]].Data()[k] + positions[corners[2]].Data()[k]) / 3.0;
+			frontPoint[k] = centroid + offset * n[k] / length;
+			backPoint[k] = centroid - offset * n[k] / length;
+		}
+		front = WindingNumber(positions, otherIndices, otherNumFaces, otherOffset, frontPoint);
+		back = WindingNumber(positions, otherIndices, otherNumFaces, otherOffset, backPoint);
+	}
+
+	// Decides for each patch of one mesh whether it lies inside the other mesh.
+	// Where the meshes touch or overlap without crossing, a patch can lie on the other surface and its
+	// winding number is not conclusive. Patches are therefore sampled for a start only; inside and outside
+	// then alternate across each intersection curve, as they do for the symbolically perturbed meshes the
+	// curves were found on. Patches with no conclusive sample anywhere around them lie wholly on the other
+	// surface: pieces of A count as inside B there, and pieces of B as inside A where the two face away
+	// from each other, so coincident surface ends up in the result once.
+	void ClassifyPatches(
+		bool meshA,
+		const PODVector<Vector3>& positions,
+		const PODVector<int>& triangles,
+		const PODVector<unsigned>& patches,
+		unsigned numPatches,
+		const std::vector<std::vector<unsigned> >& neighbours,
+		const int* otherIndices,
+		unsigned otherNumFaces,
+		unsigned otherOffset,
+		double offset,
+		std::vector<bool>& inside
+	)
+	{
+		std::vector<std::vector<unsigned> > patchTriangles(numPatches);
+		for (unsigned t = 0; t < patches.Size(); ++t) {
+			patchTriangles[patches[t]].push_back(t);
+		}
+
+		// a patch is sampled at one triangle first, then at more spread through it if that was not conclusive;
+		// the score is how far the mean of the front and back winding numbers is from one half
+		std::vector<double> scores(numPatches, 0.0);
+		std::vector<double> facing(numPatches, 0.0);
+		for (unsigned round = 0; round < 2; ++round) {
+			std::vector<unsigned> samples;
+			std::vector<unsigned> sampledPatches;
+			for (unsigned i = 0; i < numPatches; ++i) {
+				if (std::abs(scores[i]) >= CONCLUSIVE_SCORE) {
+					continue;
+				}
+				unsigned size = (unsigned)patchTriangles[i].size();
+				unsigned count = round == 0 ? 1 : Min(size, SAMPLES_PER_PATCH);
+				for (unsigned k = round; k < count; ++k) {
+					samples.push_back(patchTriangles[i][(unsigned)((unsigned long long)k * size / count)]);
+					sampledPatches.push_back(i);
+				}
+			}
+
+			std::vector<double> fronts(samples.size());
+			std::vector<double> backs(samples.size());
+			igl::parallel_for(
+				(int)samples.size(),
+				[&](int i) {
+					SampleSides(positions, triangles, samples[i], otherIndices, otherNumFaces, otherOffset, offset, fronts[i], backs[i]);
+				},
+				MIN_PARALLEL_SAMPLES
+			);
+
+			for (unsigned i = 0; i < samples.size(); ++i) {
+				unsigned patch = sampledPatches[i];
+				double score = 0.5 * (fronts[i] + backs[i]) - 0.5;
+				if (std::abs(score) > std::abs(scores[patch])) {
+					scores[patch] = score;
+				}
+				if (std::abs(fronts[i] - backs[i]) > std::abs(facing[patch])) {
+					facing[patch] = fronts[i] - backs[i];
+				}
+			}
+		}
+
+		std::vector<std::pair<double, unsigned> > order(numPatches);
+		for (unsigned i = 0; i < numPatches; ++i) {
+			order[i] = std::make_pair(-std::abs(scores[i]), i);
+		}
+		std::sort(order.begin(), order.end());
+
+		inside.assign(numPatches, false);
+		std::vector<bool> visited(numPatches, false);
+		std::vector<unsigned> stack;
+		for (unsigned i = 0; i < numPatches; ++i) {
+			unsigned seed = order[i].second;
+			if (visited[seed]) {
+				continue;
+			}
+			visited[seed] = true;
+			if (std::abs(scores[seed]) >= CONCLUSIVE_SCORE) {
+				inside[seed] = scores[seed] > 0.0;
+			}
+			else {
+				inside[seed] = meshA || facing[seed] > 0.0;
+			}
+			stack.push_back(seed);
+			while (!stack.empty()) {
+				unsigned patch = stack.back();
+				stack.pop_back();
+				for (unsigned k = 0; k < neighbours[patch].size(); ++k) {
+					unsigned next = neighbours[patch][k];
+					if (!visited[next]) {
+						visited[next] = true;
+						inside[next] = !inside[patch];
+						stack.push_back(next);
+					}
+				}
+			}
+		}
+	}
+
+} // namespace
+
+bool Geomlib::MeshBoolean(
+	const Variant& meshA,
+	const Variant& meshB,
+	MeshBooleanOperation operation,
+	Variant& meshOut
+)
+{
+	PODVector<MeshIntersectionPoint> points;
+	PODVector<MeshIntersectionSegment> segments;
+	if (!TriMeshIntersection(meshA, meshB, points, segments)) {
+		return false;
+	}
+
+	TriMeshView viewA(meshA);
+	TriMeshView viewB(meshB);
+	unsigned numVerticesA = viewA.GetNumVertices();
+	unsigned numVerticesB = viewB.GetNumVertices();
+	unsigned pointOffset = numVerticesA + numVerticesB;
+
+	// vertices of A, then of B, then the intersection points
+	PODVector<Vector3> positions(pointOffset + points.Size());
+	Vector3 boxMin(M_INFINITY, M_INFINITY, M_INFINITY);
+	Vector3 boxMax = -boxMin;
+	for (unsigned i = 0; i < numVerticesA; ++i) {
+		positions[i] = viewA.GetVertex(i);
+	}
+	for (unsigned i = 0; i < numVerticesB; ++i) {
+		positions[numVerticesA + i] = viewB.GetVertex(i);
+	}
+	for (unsigned i = 0; i < pointOffset; ++i) {
+		boxMin = Vector3(Min(boxMin.x_, positions[i].x_), Min(boxMin.y_, positions[i].y_), Min(boxMin.z_, positions[i].z_));
+		boxMax = Vector3(Max(boxMax.x_, positions[i].x_), Max(boxMax.y_, positions[i].y_), Max(boxMax.z_, positions[i].z_));
+	}
+	for (unsigned i = 0; i < points.Size(); ++i) {
+		positions[pointOffset + i] = points[i].position_;
+	}
+	double offset = SIDE_OFFSET * (boxMax - boxMin).Length();
+
+	// Where the meshes touch, intersection points land exactly on vertices and on each other.
+	// They are welded, along with vertices of B lying on vertices of A, so no zero length edges are made.
+	PODVector<int> welded(positions.Size());
+	std::map<std::pair<std::pair<float, float>, float>, int> firstAt;
+	for (unsigned i = 0; i < positions.Size(); ++i) {
+		welded[i] = i;
+		std::pair<std::pair<float, float>, float> key(std::make_pair(positions[i].x_, positions[i].y_), positions[i].z_);
+		std::map<std::pair<std::pair<float, float>, float>, int>::const_iterator it = firstAt.find(key);
+		if (it == firstAt.end()) {
+			firstAt[key] = i;
+		}
+		else if (i >= pointOffset || (i >= numVerticesA && it->second < (int)numVerticesA)) {
+			welded[i] = it->second;
+		}
+	}
+
+	// Segments welded onto the same edge enclose surface of no width; crossing both of them changes nothing,
+	// so only edges under an odd number of segments separate inside from outside.
+	std::map<std::pair<int, int>, unsigned> segmentCounts;
+	for (unsigned i = 0; i < segments.Size(); ++i) {
+		int a = welded[pointOffset + segments[i].start_];
+		int b = welded[pointOffset + segments[i].end_];
+		if (a != b) {
+			++segmentCounts[std::make_pair(Min(a, b), Max(a, b))];
+		}
+	}
+	std::set<std::pair<int, int> > curveEdges;
+	for (std::map<std::pair<int, int>, unsigned>::const_iterator it = segmentCounts.begin(); it != segmentCounts.end(); ++it) {
+		if (it->second % 2 == 1) {
+			curveEdges.insert(it->first);
+		}
+	}
+
+	PODVector<int> trianglesA, trianglesB;
+	SplitFaces(0, positions, welded, viewA.GetIndices(), viewA.GetNumFaces(), 0, pointOffset, points, segments, trianglesA);
+	SplitFaces(1, positions, welded, viewB.GetIndices(), viewB.GetNumFaces(), numVerticesA, pointOffset, points, segments, trianglesB);
+
+	PODVector<unsigned> patchesA, patchesB;
+	std::vector<std::vector<unsigned> > neighboursA, neighboursB;
+	unsigned numPatchesA = FindPatches(trianglesA, curveEdges, patchesA, neighboursA);
+	unsigned numPatchesB = FindPatches(trianglesB, curveEdges, patchesB, neighboursB);
+
+	std::vector<bool> insideA, insideB;
+	ClassifyPatches(true, positions, trianglesA, patchesA, numPatchesA, neighboursA, viewB.GetIndices(), viewB.GetNumFaces(), numVerticesA, offset, insideB);
+	ClassifyPatches(false, positions, trianglesB, patchesB, numPatchesB, neighboursB, viewA.GetIndices(), viewA.GetNumFaces(), 0, offset, insideA);
+
+	PODVector<int> kept;
+	for (unsigned t = 0; t < patchesA.Size(); ++t) {
+		bool inB = insideB[patchesA[t]];
+		if (operation == MESH_INTERSECTION ? inB : !inB) {
+			for (unsigned i = 0; i < 3; ++i) {
+				kept.Push(trianglesA[3 * t + i]);
+			}
+		}
+	}
+	for (unsigned t = 0; t < patchesB.Size(); ++t) {
+		bool inA = insideA[patchesB[t]];
+		if (operation == MESH_UNION ? inA : !inA) {
+			continue;
+		}
+		if (operation == MESH_DIFFERENCE) {
+			kept.Push(trianglesB[3 * t]);
+			kept.Push(trianglesB[3 * t + 2]);
+			kept.Push(trianglesB[3 * t + 1]);
+		}
+		else {
+			for (unsigned i = 0; i < 3; ++i) {
+				kept.Push(trianglesB[3 * t + i]);
+			}
+		}
+	}
+
+	// where faces of A and B coincide, a piece and its reverse can both be kept as a sheet of no thickness
+	std::map<std::pair<std::pair<int, int>, int>, PODVector<unsigned> > faceKeys;
+	for (unsigned t = 0; t < kept.Size() / 3; ++t) {
+		int* v = &kept[3 * t];
+		unsigned first = v[0] < v[1] ? (v[0] < v[2] ? 0 : 2) : (v[1] < v[2] ? 1 : 2);
+		faceKeys[std::make_pair(std::make_pair(v[first], v[(first + 1) % 3]), v[(first + 2) % 3])].Push(t);
+	}
+	PODVector<bool> removed(kept.Size() / 3);
+	for (unsigned t = 0; t < removed.Size(); ++t) {
+		removed[t] = false;
+	}
+	for (std::map<std::pair<std::pair<int, int>, int>, PODVector<unsigned> >::iterator it = faceKeys.begin(); it != faceKeys.end(); ++it) {
+		const std::pair<int, int>& edge = it->first.first;
+		if (edge.second < it->first.second) {
+			continue;
+		}
+		std::map<std::pair<std::pair<int, int>, int>, PODVector<unsigned> >::iterator reversed =
+			faceKeys.find(std::make_pair(std::make_pair(edge.first, it->first.second), edge.second));
+		if (reversed == faceKeys.end()) {
+			continue;
+		}
+		unsigned count = Min(it->second.Size(), reversed->second.Size());
+		for (unsigned i = 0; i < count; ++i) {
+			removed[it->second[i]] = true;
+			removed[reversed->second[i]] = true;
+		}
+	}
+	unsigned numKept = 0;
+	for (unsigned t = 0; t < removed.Size(); ++t) {
+		if (!removed[t]) {
+			for (unsigned i = 0; i < 3; ++i) {
+				kept[3 * numKept + i] = kept[3 * t + i];
+			}
+			++numKept;
+		}
+	}
+	kept.Resize(3 * numKept);
+	if (kept.Empty()) {
+		return false;
+	}
+
+	// keep only the vertices in use
+	PODVector<int> remap(positions.Size());
+	for (unsigned i = 0; i < remap.Size(); ++i) {
+		remap[i] = -1;
+	}
+	PODVector<float> outPositions;
+	PODVector<int> outIndices(kept.Size());
+	for (unsigned i = 0; i < kept.Size(); ++i) {
+		int v = kept[i];
+		if (remap[v] < 0) {
+			remap[v] = (int)outPositions.Size() / 3;
+			outPositions.Push(positions[v].x_);
+			outPositions.Push(positions[v].y_);
+			outPositions.Push(positions[v].z_);
+		}
+		outIndices[i] = remap[v];
+	}
+
+	meshOut = TriMesh_MakePacked(outPositions, outIndices);
+	return true;
+}
@@ -0,0 +1,52 @@
+//
+// Copyright (c) 2016 - 2017 Mesh Consultants Inc.
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include <Urho3D/Core/Variant.h>
+
+namespace Geomlib {
+
+	enum MeshBooleanOperation {
+		MESH_UNION,
+		MESH_INTERSECTION,
+		MESH_DIFFERENCE
+	};
+
+	// Boolean of two closed, consistently oriented TriMeshes.
+	// Faces crossed by the intersection curves of TriMeshIntersection are retriangulated around them,
+	// each piece of surface between curves is kept or dropped by whether it lies inside the other mesh,
+	// and the kept pieces are joined along the curve vertices. Coincident faces are kept once.
+	// Inputs
+	//   meshA, meshB: TriMeshes
+	//   operation: MESH_DIFFERENCE removes meshB from meshA
+	// Outputs
+	//   meshOut: the result as a TriMesh
+	// Returns false when either mesh is not valid or nothing is left.
+	bool MeshBoolean(
+		const Urho3D::Variant& meshA,
+		const Urho3D::Variant& meshB,
+		MeshBooleanOperation operation,
+		Urho3D::Variant& meshOut
+	);
+
+} // namespace Geomlib
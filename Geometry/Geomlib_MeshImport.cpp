@@ -0,0 +1,1083 @@
+//
+// Copyright (c) 2016 - 2017 Mesh Consultants Inc.
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "Geomlib_MeshImport.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+#include <Urho3D/Core/StringUtils.h>
+#include <Urho3D/Math/MathDefs.h>
+
+#include <igl/parallel_for.h>
+
+#include "TriMesh.h"
+
+using namespace Urho3D;
+
+namespace {
+
+	// text below this size is parsed on one thread
+	const unsigned MIN_CHUNK_SIZE = 1 << 20;
+	// block size for reading files of unknown size
+	const unsigned READ_BLOCK_SIZE = 1 << 24;
+
+	const double POWERS_OF_TEN[] = {
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+
+	inline bool IsSpace(char c)
+	{
+		return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+	}
+
+	inline bool IsDigit(char c)
+	{
+		return c >= '0' && c <= '9';
+	}
+
+	inline const char* SkipSpaces(const char* p, const char* end)
+	{
+		while (p < end && IsSpace(*p)) {
+			++p;
+		}
+		return p;
+	}
+
+	inline const char* SkipToken(const char* p, const char* end)
+	{
+		while (p < end && !IsSpace(*p) && *p != '\n') {
+			++p;
+		}
+		return p;
+	}
+
+	inline const char* FindLineEnd(const char* p, const char* end)
+	{
+		const char* newline = (const char*)memchr(p, '\n', end - p);
+		return newline != NULL ? newline : end;
+	}
+
+	inline const char* NextLine(const char* p, const char* end)
+	{
+		const char* lineEnd = FindLineEnd(p, end);
+		return lineEnd < end ? lineEnd + 1 : end;
+	}
+
+	// not empty and not a comment
+	inline bool IsDataLine(const char* p, const char* lineEnd)
+	{
+		p = SkipSpaces(p, lineEnd);
+		return p < lineEnd && *p != '#';
+	}
+
+	// Decimal floats without going through the C locale; anything unusual (nan, inf, hex) goes to strtod
+	bool ParseFloat(const char*& p, const char* end, float& value)
+	{
+		const char* s = p;
+		bool negative = false;
+		if (s < end && (*s == '-' || *s == '+')) {
+			negative = *s == '-';
+			++s;
+		}
+
+		unsigned long long mantissa = 0;
+		int exponent = 0;
+		bool anyDigits = false;
+		while (s < end && IsDigit(*s)) {
+			if (mantissa < 100000000000000000ULL) {
+				mantissa = 10 * mantissa + (*s - '0');
+			}
+			else {
+				++exponent;
+			}
+			anyDigits = true;
+			++s;
+		}
+		if (s < end && *s == '.') {
+			++s;
+			while (s < end && IsDigit(*s)) {
+				if (mantissa < 100000000000000000ULL) {
+					mantissa = 10 * mantissa + (*s - '0');
+					--exponent;
+				}
+				anyDigits = true;
+				++s;
+			}
+		}
+
+		if (!anyDigits || (s < end && (IsDigit(*s) || *s == 'x' || *s == 'X'))) {
+			char token[64];
+			const char* tokenEnd = SkipToken(p, end);
+			unsigned length = (unsigned)(tokenEnd - p);
+			if (length == 0 || length >= sizeof(token)) {
+				return false;
+			}
+			memcpy(token, p, length);
+			token[length] = '\0';
+			char* parsedEnd = NULL;
+			value = (float)strtod(token, &parsedEnd);
+			if (parsedEnd != token + length) {
+				return false;
+			}
+			p = tokenEnd;
+			return true;
+		}
+
+		if (s < end && (*s == 'e' || *s == 'E')) {
+			const char* e = s + 1;
+			bool negativeExponent = false;
+			if (e < end && (*e == '-' || *e == '+')) {
+				negativeExponent = *e == '-';
+				++e;
+			}
+			if (e < end && IsDigit(*e)) {
+				int written = 0;
+				while (e < end && IsDigit(*e)) {
+					if (written < 10000) {
+						written = 10 * written + (*e - '0');
+					}
+					++e;
+				}
+				exponent += negativeExponent ? -written : written;
+				s = e;
+			}
+		}
+
+		double result = (double)mantissa;
+		if (mantissa != 0 && exponent != 0) {
+			if (exponent > 0 && exponent <= 22) {
+				result *= POWERS_OF_TEN[exponent];
+			}
+			else if (exponent < 0 && exponent >= -22) {
+				result /= POWERS_OF_TEN[-exponent];
+			}
+			else {
+				result *= pow(10.0, (double)exponent);
+			}
+		}
+		value = (float)(negative ? -result : result);
+		p = s;
+		return true;
+	}
+
+	bool ParseInt(const char*& p, const char* end, long long& value)
+	{
+		const char* s = p;
+		bool negative = false;
+		if (s < end && (*s == '-' || *s == '+')) {
+			negative = *s == '-';
+			++s;
+		}
+		if (s == end || !IsDigit(*s)) {
+			return false;
+		}
+		long long result = 0;
+		while (s < end && IsDigit(*s)) {
+			if (result < 1000000000000LL) {
+				result = 10 * result + (*s - '0');
+			}
+			++s;
+		}
+		value = negative ? -result : result;
+		p = s;
+		return true;
+	}
+
+	// A line aligned piece of text with what it contributes to the mesh
+	struct TextChunk
+	{
+		const char* begin_;
+		const char* end_;
+		unsigned numLines_;
+		unsigned numVertices_;
+		unsigned numTriangles_;
+		unsigned vertexOffset_;
+		unsigned triangleOffset_;
+		bool ok_;
+	};
+
+	// with parallel false the whole text is one chunk, parsed on the calling thread
+	void SplitIntoChunks(const char* begin, const char* end, bool parallel, Vector<TextChunk>& chunks)
+	{
+		chunks.Clear();
+
+		size_t size = end - begin;
+		size_t maxChunks = parallel ? 4 * Max(std::thread::hardware_concurrency(), 1u) : 1;
+		size_t numChunks = Clamp(size / MIN_CHUNK_SIZE, (size_t)1, maxChunks);
+
+		const char* p = begin;
+		for (size_t i = 0; i < numChunks && p < end; ++i) {
+			const char* q = i + 1 == numChunks ? end : begin + size * (i + 1) / numChunks;
+			if (q < p) {
+				q = p;
+			}
+			q = NextLine(q, end);
+			if (i + 1 == numChunks || q == end) {
+				q = end;
+			}
+
+			TextChunk chunk;
+			chunk.begin_ = p;
+			chunk.end_ = q;
+			chunk.numLines_ = 0;
+			chunk.numVertices_ = 0;
+			chunk.numTriangles_ = 0;
+			chunk.vertexOffset_ = 0;
+			chunk.triangleOffset_ = 0;
+			chunk.ok_ = true;
+			chunks.Push(chunk);
+			p = q;
+		}
+	}
+
+	// Fills in the offsets, returns false if any chunk failed
+	bool AccumulateChunks(Vector<TextChunk>& chunks, unsigned& numVertices, unsigned& numTriangles)
+	{
+		numVertices = 0;
+		numTriangles = 0;
+		for (unsigned i = 0; i < chunks.Size(); ++i) {
+			if (!chunks[i].ok_) {
+				return false;
+			}
+			chunks[i].vertexOffset_ = numVertices;
+			chunks[i].triangleOffset_ = numTriangles;
+			numVertices += chunks[i].numVertices_;
+			numTriangles += chunks[i].numTriangles_;
+		}
+		return true;
+	}
+
+	bool AllChunksOk(const Vector<TextChunk>& chunks)
+	{
+		for (unsigned i = 0; i < chunks.Size(); ++i) {
+			if (!chunks[i].ok_) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	template <class Func>
+	void ForEachChunk(Vector<TextChunk>& chunks, const Func& func)
+	{
+		igl::parallel_for((int)chunks.Size(), [&](int i) { func(chunks[i]); }, 2);
+	}
+
+	// Writes the fan of one polygon, first vertex first
+	inline void WriteFanTriangle(int* triangle, int first, int previous, int current)
+	{
+		triangle[0] = first;
+		triangle[1] = previous;
+		triangle[2] = current;
+	}
+
+	///////
+	// OBJ
+
+	inline bool IsOBJKeyword(const char* p, const char* lineEnd, char keyword)
+	{
+		return p + 1 < lineEnd && p[0] == keyword && IsSpace(p[1]);
+	}
+
+	void CountOBJChunk(TextChunk& chunk)
+	{
+		for (const char* line = chunk.begin_; line < chunk.end_; ) {
+			const char* lineEnd = FindLineEnd(line, chunk.end_);
+			const char* p = SkipSpaces(line, lineEnd);
+
+			if (IsOBJKeyword(p, lineEnd, 'v')) {
+				++chunk.numVertices_;
+			}
+			else if (IsOBJKeyword(p, lineEnd, 'f')) {
+				unsigned corners = 0;
+				p = SkipSpaces(p + 1, lineEnd);
+				while (p < lineEnd) {
+					++corners;
+					p = SkipSpaces(SkipToken(p, lineEnd), lineEnd);
+				}
+				if (corners < 3) {
+					chunk.ok_ = false;
+					return;
+				}
+				chunk.numTriangles_ += corners - 2;
+			}
+
+			line = lineEnd < chunk.end_ ? lineEnd + 1 : chunk.end_;
+		}
+	}
+
+	void ParseOBJChunk(TextChunk& chunk, float* positions, int* indices)
+	{
+		// vertices before the current line, for relative indices
+		long long numVertices = chunk.vertexOffset_;
+		float* position = positions + 3 * chunk.vertexOffset_;
+		int* triangle = indices + 3 * chunk.triangleOffset_;
+
+		for (const char* line = chunk.begin_; line < chunk.end_; ) {
+			const char* lineEnd = FindLineEnd(line, chunk.end_);
+			const char* p = SkipSpaces(line, lineEnd);
+
+			if (IsOBJKeyword(p, lineEnd, 'v')) {
+				// x y z [w]
+				p = SkipSpaces(p + 1, lineEnd);
+				for (int i = 0; i < 3; ++i) {
+					if (!ParseFloat(p, lineEnd, position[i])) {
+						chunk.ok_ = false;
+						return;
+					}
+					p = SkipSpaces(p, lineEnd);
+				}
+				position += 3;
+				++numVertices;
+			}
+			else if (IsOBJKeyword(p, lineEnd, 'f')) {
+				// v, v/vt, v//vn or v/vt/vn per corner, only v is kept
+				int first = -1;
+				int previous = -1;
+				unsigned corner = 0;
+				p = SkipSpaces(p + 1, lineEnd);
+				while (p < lineEnd) {
+					long long index = 0;
+					if (!ParseInt(p, lineEnd, index) || index == 0) {
+						chunk.ok_ = false;
+						return;
+					}
+					int current = (int)(index < 0 ? numVertices + index : index - 1);
+					if (corner == 0) {
+						first = current;
+					}
+					else if (corner >= 2) {
+						WriteFanTriangle(triangle, first, previous, current);
+						triangle += 3;
+					}
+					previous = current;
+					++corner;
+					p = SkipSpaces(SkipToken(p, lineEnd), lineEnd);
+				}
+			}
+
+			line = lineEnd < chunk.end_ ? lineEnd + 1 : chunk.end_;
+		}
+	}
+
+	/////////////////////////
+	// Line per element text
+
+	// Data lines of a vertex or face section, as in OFF and ascii PLY.
+	// Vertex lines hold at least maxColumn + 1 numbers, x, y and z at columns[].
+	// Face lines hold skipTokens values, then a corner count and that many indices.
+	struct LineLayout
+	{
+		int columns_[3];
+		int maxColumn_;
+		int skipTokens_;
+	};
+
+	void CountVertexLines(TextChunk& chunk)
+	{
+		for (const char* line = chunk.begin_; line < chunk.end_; ) {
+			const char* lineEnd = FindLineEnd(line, chunk.end_);
+			if (IsDataLine(line, lineEnd)) {
+				++chunk.numLines_;
+			}
+			line = lineEnd < chunk.end_ ? lineEnd + 1 : chunk.end_;
+		}
+		chunk.numVertices_ = chunk.numLines_;
+	}
+
+	void ParseVertexLines(TextChunk& chunk, const LineLayout& layout, float* positions)
+	{
+		float* position = positions + 3 * chunk.vertexOffset_;
+		for (const char* line = chunk.begin_; line < chunk.end_; ) {
+			const char* lineEnd = FindLineEnd(line, chunk.end_);
+			if (IsDataLine(line, lineEnd)) {
+				const char* p = SkipSpaces(line, lineEnd);
+				for (int column = 0; column <= layout.maxColumn_; ++column) {
+					float value;
+					if (!ParseFloat(p, lineEnd, value)) {
+						chunk.ok_ = false;
+						return;
+					}
+					for (int i = 0; i < 3; ++i) {
+						if (layout.columns_[i] == column) {
+							position[i] = value;
+						}
+					}
+					p = SkipSpaces(p, lineEnd);
+				}
+				position += 3;
+			}
+			line = lineEnd < chunk.end_ ? lineEnd + 1 : chunk.end_;
+		}
+	}
+
+	// returns the corner count, or -1
+	long long ReadCornerCount(const char*& p, const char* lineEnd, const LineLayout& layout)
+	{
+		p = SkipSpaces(p, lineEnd);
+		for (int i = 0; i < layout.skipTokens_; ++i) {
+			p = SkipSpaces(SkipToken(p, lineEnd), lineEnd);
+		}
+		long long count = 0;
+		if (!ParseInt(p, lineEnd, count) || count < 3) {
+			return -1;
+		}
+		return count;
+	}
+
+	void CountFaceLines(TextChunk& chunk, const LineLayout& layout)
+	{
+		for (const char* line = chunk.begin_; line < chunk.end_; ) {
+			const char* lineEnd = FindLineEnd(line, chunk.end_);
+			if (IsDataLine(line, lineEnd)) {
+				const char* p = line;
+				long long count = ReadCornerCount(p, lineEnd, layout);
+				if (count < 0) {
+					chunk.ok_ = false;
+					return;
+				}
+				++chunk.numLines_;
+				chunk.numTriangles_ += (unsigned)count - 2;
+			}
+			line = lineEnd < chunk.end_ ? lineEnd + 1 : chunk.end_;
+		}
+	}
+
+	void ParseFaceLines(TextChunk& chunk, const LineLayout& layout, int* indices)
+	{
+		int* triangle = indices + 3 * chunk.triangleOffset_;
+		for (const char* line = chunk.begin_; line < chunk.end_; ) {
+			const char* lineEnd = FindLineEnd(line, chunk.end_);
+			if (IsDataLine(line, lineEnd)) {
+				const char* p = line;
+				long long count = ReadCornerCount(p, lineEnd, layout);
+				int first = -1;
+				int previous = -1;
+				for (long long corner = 0; corner < count; ++corner) {
+					long long index = 0;
+					p = SkipSpaces(p, lineEnd);
+					if (!ParseInt(p, lineEnd, index)) {
+						chunk.ok_ = false;
+						return;
+					}
+					int current = (int)index;
+					if (corner == 0) {
+						first = current;
+					}
+					else if (corner >= 2) {
+						WriteFanTriangle(triangle, first, previous, current);
+						triangle += 3;
+					}
+					previous = current;
+				}
+			}
+			line = lineEnd < chunk.end_ ? lineEnd + 1 : chunk.end_;
+		}
+	}
+
+	// Returns the end of the first count data lines from p, or NULL if the text ends first
+	const char* SkipDataLines(const char* p, const char* end, unsigned count)
+	{
+		while (count > 0) {
+			if (p >= end) {
+				return NULL;
+			}
+			const char* lineEnd = FindLineEnd(p, end);
+			if (IsDataLine(p, lineEnd)) {
+				--count;
+			}
+			p = lineEnd < end ? lineEnd + 1 : end;
+		}
+		return p;
+	}
+
+	bool ParseVertexSection(
+		const char* begin,
+		const char* end,
+		unsigned numVertices,
+		const LineLayout& layout,
+		bool parallel,
+		PODVector<float>& positions
+	)
+	{
+		Vector<TextChunk> chunks;
+		SplitIntoChunks(begin, end, parallel, chunks);
+		ForEachChunk(chunks, [](TextChunk& chunk) { CountVertexLines(chunk); });
+
+		unsigned counted = 0;
+		unsigned numTriangles = 0;
+		if (!AccumulateChunks(chunks, counted, numTriangles) || counted != numVertices) {
+			return false;
+		}
+
+		positions.Resize(3 * numVertices);
+		float* data = positions.Empty() ? NULL : &positions[0];
+		ForEachChunk(chunks, [&](TextChunk& chunk) { ParseVertexLines(chunk, layout, data); });
+		return AllChunksOk(chunks);
+	}
+
+	bool ParseFaceSection(
+		const char* begin,
+		const char* end,
+		unsigned numFaces,
+		const LineLayout& layout,
+		bool parallel,
+		PODVector<int>& indices
+	)
+	{
+		Vector<TextChunk> chunks;
+		SplitIntoChunks(begin, end, parallel, chunks);
+		ForEachChunk(chunks, [&](TextChunk& chunk) { CountFaceLines(chunk, layout); });
+
+		unsigned numLines = 0;
+		for (unsigned i = 0; i < chunks.Size(); ++i) {
+			numLines += chunks[i].numLines_;
+		}
+		unsigned numVertices = 0;
+		unsigned numTriangles = 0;
+		if (!AccumulateChunks(chunks, numVertices, numTriangles) || numLines != numFaces) {
+			return false;
+		}
+
+		indices.Resize(3 * numTriangles);
+		int* data = indices.Empty() ? NULL : &indices[0];
+		ForEachChunk(chunks, [&](TextChunk& chunk) { ParseFaceLines(chunk, layout, data); });
+		return AllChunksOk(chunks);
+	}
+
+	///////
+	// PLY
+
+	enum PlyType {
+		PLY_INVALID,
+		PLY_INT8,
+		PLY_UINT8,
+		PLY_INT16,
+		PLY_UINT16,
+		PLY_INT32,
+		PLY_UINT32,
+		PLY_FLOAT32,
+		PLY_FLOAT64
+	};
+
+	struct PlyProperty
+	{
+		String name_;
+		PlyType type_;
+		// lists only
+		bool isList_;
+		PlyType countType_;
+	};
+
+	struct PlyElement
+	{
+		String name_;
+		unsigned count_;
+		Vector<PlyProperty> properties_;
+	};
+
+	PlyType GetPlyType(const String& name)
+	{
+		if (name == "char" || name == "int8") return PLY_INT8;
+		if (name == "uchar" || name == "uint8") return PLY_UINT8;
+		if (name == "short" || name == "int16") return PLY_INT16;
+		if (name == "ushort" || name == "uint16") return PLY_UINT16;
+		if (name == "int" || name == "int32") return PLY_INT32;
+		if (name == "uint" || name == "uint32") return PLY_UINT32;
+		if (name == "float" || name == "float32") return PLY_FLOAT32;
+		if (name == "double" || name == "float64") return PLY_FLOAT64;
+		return PLY_INVALID;
+	}
+
+	unsigned GetPlyTypeSize(PlyType type)
+	{
+		switch (type) {
+		case PLY_INT8: case PLY_UINT8: return 1;
+		case PLY_INT16: case PLY_UINT16: return 2;
+		case PLY_INT32: case PLY_UINT32: case PLY_FLOAT32: return 4;
+		case PLY_FLOAT64: return 8;
+		default: return 0;
+		}
+	}
+
+	double ReadPlyValue(const unsigned char* p, PlyType type, bool swap)
+	{
+		unsigned char bytes[8];
+		unsigned size = GetPlyTypeSize(type);
+		for (unsigned i = 0; i < size; ++i) {
+			bytes[i] = swap ? p[size - 1 - i] : p[i];
+		}
+
+		switch (type) {
+		case PLY_INT8: { signed char v; memcpy(&v, bytes, 1); return v; }
+		case PLY_UINT8: return bytes[0];
+		case PLY_INT16: { short v; memcpy(&v, bytes, 2); return v; }
+		case PLY_UINT16: { unsigned short v; memcpy(&v, bytes, 2); return v; }
+		case PLY_INT32: { int v; memcpy(&v, bytes, 4); return v; }
+		case PLY_UINT32: { unsigned v; memcpy(&v, bytes, 4); return v; }
+		case PLY_FLOAT32: { float v; memcpy(&v, bytes, 4); return v; }
+		case PLY_FLOAT64: { double v; memcpy(&v, bytes, 8); return v; }
+		default: return 0.0;
+		}
+	}
+
+	int FindPlyProperty(const PlyElement& element, const char* name0, const char* name1 = NULL)
+	{
+		for (unsigned i = 0; i < element.properties_.Size(); ++i) {
+			const String& name = element.properties_[i].name_;
+			if (name == name0 || (name1 != NULL && name == name1)) {
+				return (int)i;
+			}
+		}
+		return -1;
+	}
+
+	bool HasPlyListBefore(const PlyElement& element, int property)
+	{
+		for (int i = 0; i < property; ++i) {
+			if (element.properties_[i].isList_) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// Reads the header up to end_header, returns the start of the body or NULL
+	const char* ParsePlyHeader(const char* p, const char* end, String& format, Vector<PlyElement>& elements)
+	{
+		bool first = true;
+		while (p < end) {
+			const char* lineEnd = FindLineEnd(p, end);
+			Vector<String> words = String(p, (unsigned)(lineEnd - p)).Split(' ');
+			for (unsigned i = 0; i < words.Size(); ++i) {
+				words[i] = words[i].Trimmed();
+			}
+			p = lineEnd < end ? lineEnd + 1 : end;
+
+			if (first) {
+				if (words.Empty() || words[0] != "ply") {
+					return NULL;
+				}
+				first = false;
+				continue;
+			}
+			if (words.Empty() || words[0] == "comment" || words[0] == "obj_info") {
+				continue;
+			}
+
+			if (words[0] == "end_header") {
+				return p;
+			}
+			else if (words[0] == "format" && words.Size() >= 2) {
+				format = words[1];
+			}
+			else if (words[0] == "element" && words.Size() >= 3) {
+				PlyElement element;
+				element.name_ = words[1];
+				element.count_ = ToUInt(words[2]);
+				elements.Push(element);
+			}
+			else if (words[0] == "property" && words.Size() >= 3 && !elements.Empty()) {
+				PlyProperty property;
+				property.isList_ = words[1] == "list";
+				if (property.isList_) {
+					if (words.Size() < 5) {
+						return NULL;
+					}
+					property.countType_ = GetPlyType(words[2]);
+					property.type_ = GetPlyType(words[3]);
+					property.name_ = words[4];
+					if (property.countType_ == PLY_INVALID) {
+						return NULL;
+					}
+				}
+				else {
+					property.countType_ = PLY_INVALID;
+					property.type_ = GetPlyType(words[1]);
+					property.name_ = words[2];
+				}
+				if (property.type_ == PLY_INVALID) {
+					return NULL;
+				}
+				elements.Back().properties_.Push(property);
+			}
+			else {
+				return NULL;
+			}
+		}
+		return NULL;
+	}
+
+	bool ParseAsciiPLY(
+		const char* body,
+		const char* end,
+		const Vector<PlyElement>& elements,
+		bool parallel,
+		PODVector<float>& positions,
+		PODVector<int>& indices
+	)
+	{
+		const char* p = body;
+		for (unsigned e = 0; e < elements.Size(); ++e) {
+			const PlyElement& element = elements[e];
+			const char* sectionEnd = SkipDataLines(p, end, element.count_);
+			if (sectionEnd == NULL) {
+				return false;
+			}
+
+			if (element.name_ == "vertex") {
+				LineLayout layout;
+				layout.columns_[0] = FindPlyProperty(element, "x");
+				layout.columns_[1] = FindPlyProperty(element, "y");
+				layout.columns_[2] = FindPlyProperty(element, "z");
+				layout.maxColumn_ = Max(layout.columns_[0], Max(layout.columns_[1], layout.columns_[2]));
+				layout.skipTokens_ = 0;
+				if (
+					layout.columns_[0] < 0 || layout.columns_[1] < 0 || layout.columns_[2] < 0 ||
+					HasPlyListBefore(element, layout.maxColumn_ + 1) ||
+					!ParseVertexSection(p, sectionEnd, element.count_, layout, parallel, positions)
+					)
+				{
+					return false;
+				}
+			}
+			else if (element.name_ == "face") {
+				LineLayout layout;
+				layout.columns_[0] = layout.columns_[1] = layout.columns_[2] = -1;
+				layout.maxColumn_ = -1;
+				layout.skipTokens_ = FindPlyProperty(element, "vertex_indices", "vertex_index");
+				if (
+					layout.skipTokens_ < 0 ||
+					HasPlyListBefore(element, layout.skipTokens_) ||
+					!ParseFaceSection(p, sectionEnd, element.count_, layout, parallel, indices)
+					)
+				{
+					return false;
+				}
+			}
+
+			p = sectionEnd;
+		}
+		return true;
+	}
+
+	bool ParseBinaryPLY(
+		const unsigned char* body,
+		const unsigned char* end,
+		const Vector<PlyElement>& elements,
+		bool swap,
+		bool parallel,
+		PODVector<float>& positions,
+		PODVector<int>& indices
+	)
+	{
+		const unsigned char* p = body;
+		for (unsigned e = 0; e < elements.Size(); ++e) {
+			const PlyElement& element = elements[e];
+
+			bool hasLists = false;
+			unsigned stride = 0;
+			PODVector<unsigned> offsets;
+			for (unsigned i = 0; i < element.properties_.Size(); ++i) {
+				offsets.Push(stride);
+				hasLists = hasLists || element.properties_[i].isList_;
+				stride += GetPlyTypeSize(element.properties_[i].type_);
+			}
+
+			if (!hasLists) {
+				// fixed size records, vertices are decoded in parallel
+				if ((size_t)(end - p) < (size_t)element.count_ * stride) {
+					return false;
+				}
+
+				if (element.name_ == "vertex") {
+					int x = FindPlyProperty(element, "x");
+					int y = FindPlyProperty(element, "y");
+					int z = FindPlyProperty(element, "z");
+					if (x < 0 || y < 0 || z < 0) {
+						return false;
+					}
+					const PlyProperty* xyz[3] = { &element.properties_[x], &element.properties_[y], &element.properties_[z] };
+					unsigned xyzOffsets[3] = { offsets[x], offsets[y], offsets[z] };
+
+					positions.Resize(3 * element.count_);
+					float* data = positions.Empty() ? NULL : &positions[0];
+					const unsigned char* records = p;
+					igl::parallel_for(
+						(int)element.count_,
+						[&](int i) {
+							const unsigned char* record = records + (size_t)i * stride;
+							for (int k = 0; k < 3; ++k) {
+								data[3 * i + k] = (float)ReadPlyValue(record + xyzOffsets[k], xyz[k]->type_, swap);
+							}
+						},
+						parallel ? 10000 : element.count_ + 1
+					);
+				}
+
+				p += (size_t)element.count_ * stride;
+				continue;
+			}
+
+			// variable size records are walked in order
+			int list = element.name_ == "face" ? FindPlyProperty(element, "vertex_indices", "vertex_index") : -1;
+			if (list >= 0) {
+				indices.Clear();
+				indices.Reserve(3 * element.count_);
+			}
+			for (unsigned r = 0; r < element.count_; ++r) {
+				for (unsigned i = 0; i < element.properties_.Size(); ++i) {
+					const PlyProperty& property = element.properties_[i];
+					unsigned valueSize = GetPlyTypeSize(property.type_);
+					if (!property.isList_) {
+						if ((size_t)(end - p) < valueSize) {
+							return false;
+						}
+						p += valueSize;
+						continue;
+					}
+
+					unsigned countSize = GetPlyTypeSize(property.countType_);
+					if ((size_t)(end - p) < countSize) {
+						return false;
+					}
+					double countValue = ReadPlyValue(p, property.countType_, swap);
+					p += countSize;
+					if (countValue < 0.0 || (size_t)(end - p) < (size_t)countValue * valueSize) {
+						return false;
+					}
+					unsigned count = (unsigned)countValue;
+
+					if ((int)i == list) {
+						if (count < 3) {
+							return false;
+						}
+						int first = (int)ReadPlyValue(p, property.type_, swap);
+						int previous = (int)ReadPlyValue(p + valueSize, property.type_, swap);
+						for (unsigned k = 2; k < count; ++k) {
+							int current = (int)ReadPlyValue(p + k * valueSize, property.type_, swap);
+							indices.Push(first);
+							indices.Push(previous);
+							indices.Push(current);
+							previous = current;
+						}
+					}
+					p += (size_t)count * valueSize;
+				}
+			}
+		}
+		return true;
+	}
+
+} // namespace
+
+bool Geomlib::ParseOBJ(
+	const char* data,
+	size_t size,
+	PODVector<float>& positions,
+	PODVector<int>& indices,
+	bool parallel
+)
+{
+	positions.Clear();
+	indices.Clear();
+
+	Vector<TextChunk> chunks;
+	SplitIntoChunks(data, data + size, parallel, chunks);
+	ForEachChunk(chunks, [](TextChunk& chunk) { CountOBJChunk(chunk); });
+
+	unsigned numVertices = 0;
+	unsigned numTriangles = 0;
+	if (!AccumulateChunks(chunks, numVertices, numTriangles)) {
+		return false;
+	}
+
+	positions.Resize(3 * numVertices);
+	indices.Resize(3 * numTriangles);
+	float* positionData = positions.Empty() ? NULL : &positions[0];
+	int* indexData = indices.Empty() ? NULL : &indices[0];
+	ForEachChunk(chunks, [&](TextChunk& chunk) { ParseOBJChunk(chunk, positionData, indexData); });
+
+	return AllChunksOk(chunks);
+}
+
+bool Geomlib::ParseOFF(
+	const char* data,
+	size_t size,
+	PODVector<float>& positions,
+	PODVector<int>& indices,
+	bool parallel
+)
+{
+	positions.Clear();
+	indices.Clear();
+
+	const char* end = data + size;
+	const char* p = data;
+
+	// OFF, NOFF or COFF; normals and colors after the coordinates are skipped
+	while (p < end && !IsDataLine(p, FindLineEnd(p, end))) {
+		p = NextLine(p, end);
+	}
+	p = SkipSpaces(p, end);
+	const char* keyword = p;
+	p = SkipToken(p, end);
+	String header(keyword, (unsigned)(p - keyword));
+	if (!header.EndsWith("OFF")) {
+		return false;
+	}
+
+	// #vertices #faces #edges, on the same line or the next data line
+	long long counts[3] = { 0, 0, 0 };
+	for (int i = 0; i < 3; ++i) {
+		p = SkipSpaces(p, end);
+		while (p < end && (*p == '\n' || *p == '#')) {
+			p = NextLine(p, end);
+			p = SkipSpaces(p, end);
+		}
+		if (!ParseInt(p, end, counts[i]) || counts[i] < 0) {
+			return false;
+		}
+	}
+	p = NextLine(p, end);
+
+	const char* faceSection = SkipDataLines(p, end, (unsigned)counts[0]);
+	if (faceSection == NULL) {
+		return false;
+	}
+
+	LineLayout vertexLayout = { { 0, 1, 2 }, 2, 0 };
+	LineLayout faceLayout = { { -1, -1, -1 }, -1, 0 };
+	return
+		ParseVertexSection(p, faceSection, (unsigned)counts[0], vertexLayout, parallel, positions) &&
+		ParseFaceSection(faceSection, end, (unsigned)counts[1], faceLayout, parallel, indices);
+}
+
+bool Geomlib::ParsePLY(
+	const char* data,
+	size_t size,
+	PODVector<float>& positions,
+	PODVector<int>& indices,
+	bool parallel
+)
+{
+	positions.Clear();
+	indices.Clear();
+
+	const char* end = data + size;
+	String format;
+	Vector<PlyElement> elements;
+	const char* body = ParsePlyHeader(data, end, format, elements);
+	if (body == NULL) {
+		return false;
+	}
+
+	if (format == "ascii") {
+		return ParseAsciiPLY(body, end, elements, parallel, positions, indices);
+	}
+
+	unsigned short one = 1;
+	bool littleEndianHost = *(const unsigned char*)&one == 1;
+	if (format == "binary_little_endian" || format == "binary_big_endian") {
+		bool swap = (format == "binary_little_endian") != littleEndianHost;
+		return ParseBinaryPLY((const unsigned char*)body, (const unsigned char*)end, elements, swap, parallel, positions, indices);
+	}
+
+	return false;
+}
+
+bool Geomlib::ReadMeshFileData(
+	File* source,
+	std::vector<char>& data
+)
+{
+	data.clear();
+	if (source == NULL || !source->IsOpen()) {
+		return false;
+	}
+
+	// read until the source runs dry rather than trusting its 32 bit size
+	size_t size = 0;
+	for (;;) {
+		data.resize(size + READ_BLOCK_SIZE);
+		unsigned read = source->Read(&data[size], READ_BLOCK_SIZE);
+		size += read;
+		if (read < READ_BLOCK_SIZE) {
+			break;
+		}
+	}
+
+	data.resize(size);
+	return true;
+}
+
+bool Geomlib::ReadMeshFileData(
+	const String& filename,
+	std::vector<char>& data
+)
+{
+	data.clear();
+	FILE* file = fopen(filename.CString(), "rb");
+	if (file == NULL) {
+		return false;
+	}
+
+	// the size is not asked for up front, ftell stops at 2 GB on some platforms
+	size_t size = 0;
+	for (;;) {
+		data.resize(size + READ_BLOCK_SIZE);
+		size_t read = fread(&data[size], 1, READ_BLOCK_SIZE, file);
+		size += read;
+		if (read < READ_BLOCK_SIZE) {
+			break;
+		}
+	}
+	bool ok = ferror(file) == 0;
+	fclose(file);
+
+	data.resize(size);
+	return ok;
+}
+
+bool Geomlib::MakeImportedTriMesh(
+	PODVector<float>& positions,
+	const PODVector<int>& indices,
+	bool yup,
+	Variant& tri_mesh
+)
+{
+	if (yup) {
+		for (unsigned i = 0; i < positions.Size(); i += 3) {
+			float y = positions[i + 1];
+			positions[i + 1] = positions[i + 2];
+			positions[i + 2] = -y;
+		}
+	}
+
+	tri_mesh = TriMesh_MakePacked(positions, indices);
+	return TriMesh_Verify(tri_mesh);
+}
@@ -0,0 +1,84 @@
+//
+// Copyright (c) 2016 - 2017 Mesh Consultants Inc.
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include <Urho3D/Container/Str.h>
+#include <Urho3D/Container/Vector.h>
+#include <Urho3D/Core/Variant.h>
+#include <Urho3D/IO/File.h>
+
+#include <vector>
+
+namespace Geomlib {
+
+	// Whole-file mesh parsers behind ReadOBJ, ReadOFF and ReadPLY.
+	// Text is split into line aligned chunks that are counted, then parsed in parallel straight into
+	// packed arrays:
+	//   positions: x, y, z per vertex
+	//   indices: three per triangle, polygons are triangulated as fans
+	// With parallel false everything runs on the calling thread.
+	bool ParseOBJ(
+		const char* data,
+		size_t size,
+		Urho3D::PODVector<float>& positions,
+		Urho3D::PODVector<int>& indices,
+		bool parallel = true
+	);
+
+	bool ParseOFF(
+		const char* data,
+		size_t size,
+		Urho3D::PODVector<float>& positions,
+		Urho3D::PODVector<int>& indices,
+		bool parallel = true
+	);
+
+	// ascii, binary_little_endian and binary_big_endian
+	bool ParsePLY(
+		const char* data,
+		size_t size,
+		Urho3D::PODVector<float>& positions,
+		Urho3D::PODVector<int>& indices,
+		bool parallel = true
+	);
+
+	// Reads the rest of source, or the whole file, in large blocks.
+	// Sizes are 64 bit, so files past 4 GB are read whole.
+	bool ReadMeshFileData(
+		Urho3D::File* source,
+		std::vector<char>& data
+	);
+
+	bool ReadMeshFileData(
+		const Urho3D::String& filename,
+		std::vector<char>& data
+	);
+
+	// Converts from y-up if asked, then makes a packed TriMesh
+	bool MakeImportedTriMesh(
+		Urho3D::PODVector<float>& positions,
+		const Urho3D::PODVector<int>& indices,
+		bool yup,
+		Urho3D::Variant& tri_mesh
+	);
+}
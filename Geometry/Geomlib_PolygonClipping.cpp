@@ -0,0 +1,659 @@
+//
+// Copyright (c) 2016 - 2017 Mesh Consultants Inc.
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "Geomlib_PolygonClipping.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <vector>
+
+#include <Urho3D/Math/Vector2.h>
+
+#include <igl/parallel_for.h>
+
+#include "clipper/clipper.hpp"
+#include "Polyline.h"
+
+using Urho3D::Matrix3x4;
+using Urho3D::PODVector;
+using Urho3D::Variant;
+using Urho3D::VariantVector;
+using Urho3D::Vector;
+using Urho3D::Vector2;
+using Urho3D::Vector3;
+
+using ClipperLib::IntPoint;
+using ClipperLib::long64;
+
+namespace {
+
+	// Largest coordinate magnitude after scaling. Clipper switches to 128 bit arithmetic above 0x3FFFFFFF,
+	// this stays well below that with room for offsets and the frame used by negative offsets.
+	const double CLIPPER_RANGE = 268435456.0;
+	const double PI_D = 3.14159265358979323846;
+
+	long64 RoundToInt(double value)
+	{
+		return (long64)std::floor(value + 0.5);
+	}
+
+	// Maps points between the plane and Clipper's integer coordinates.
+	// Clipper's X, Y are the plane's local Z, X, so that counter-clockwise in Clipper is counter-clockwise seen from +Y.
+	class PlaneMapping
+	{
+	public:
+		PlaneMapping(const Matrix3x4& plane) :
+			plane_(plane),
+			inverse_(plane.Inverse()),
+			centerX_(0.0),
+			centerY_(0.0),
+			scale_(1.0)
+		{
+		}
+
+		// Projects the sequential vertices of each valid polyline, dropping repeated vertices and the closing one.
+		void Project(const VariantVector& polylines, Vector<PODVector<Vector2> >& rings) const
+		{
+			for (unsigned i = 0; i < polylines.Size(); ++i) {
+				if (!Polyline_Verify(polylines[i])) {
+					continue;
+				}
+				VariantVector verts = Polyline_ComputeSequentialVertexList(polylines[i]);
+
+				PODVector<Vector2> ring;
+				for (unsigned j = 0; j < verts.Size(); ++j) {
+					Vector3 local = inverse_ * verts[j].GetVector3();
+					Vector2 p(local.z_, local.x_);
+					if (ring.Empty() || ring.Back() != p) {
+						ring.Push(p);
+					}
+				}
+				while (ring.Size() > 1 && ring.Back() == ring.Front()) {
+					ring.Pop();
+				}
+				if (ring.Size() >= 3) {
+					rings.Push(ring);
+				}
+			}
+		}
+
+		// Centers and scales the integer grid on the bounding box of rings, grown by margin on every side.
+		void Fit(const Vector<PODVector<Vector2> >& rings, double margin)
+		{
+			double minX = 0.0, minY = 0.0, maxX = 0.0, maxY = 0.0;
+			bool first = true;
+			for (unsigned i = 0; i < rings.Size(); ++i) {
+				for (unsigned j = 0; j < rings[i].Size(); ++j) {
+					const Vector2& p = rings[i][j];
+					if (first) {
+						minX = maxX = p.x_;
+						minY = maxY = p.y_;
+						first = false;
+					}
+					minX = std::min(minX, (double)p.x_);
+					maxX = std::max(maxX, (double)p.x_);
+					minY = std::min(minY, (double)p.y_);
+					maxY = std::max(maxY, (double)p.y_);
+				}
+			}
+
+			centerX_ = 0.5 * (minX + maxX);
+			centerY_ = 0.5 * (minY + maxY);
+			double extent = std::max(maxX - minX, maxY - minY) * 0.5 + margin;
+			scale_ = extent > 0.0 ? CLIPPER_RANGE / extent : 1.0;
+		}
+
+		double GetScale() const { return scale_; }
+
+		void ToClipper(const Vector<PODVector<Vector2> >& rings, ClipperLib::Polygons& polys) const
+		{
+			polys.resize(rings.Size());
+			for (unsigned i = 0; i < rings.Size(); ++i) {
+				ClipperLib::Polygon& poly = polys[i];
+				poly.clear();
+				poly.reserve(rings[i].Size());
+				for (unsigned j = 0; j < rings[i].Size(); ++j) {
+					IntPoint pt(
+						RoundToInt((rings[i][j].x_ - centerX_) * scale_),
+						RoundToInt((rings[i][j].y_ - centerY_) * scale_)
+					);
+					// vertices closer than the grid resolution collapse
+					if (poly.empty() || pt.X != poly.back().X || pt.Y != poly.back().Y) {
+						poly.push_back(pt);
+					}
+				}
+			}
+		}
+
+		Variant ToPolyline(const ClipperLib::Polygon& poly) const
+		{
+			VariantVector verts(poly.size() + 1);
+			for (unsigned i = 0; i < poly.size(); ++i) {
+				Vector3 local(
+					(float)(poly[i].Y / scale_ + centerY_),
+					0.0f,
+					(float)(poly[i].X / scale_ + centerX_)
+				);
+				verts[i] = plane_ * local;
+			}
+			verts[poly.size()] = verts[0];
+
+			return Polyline_Make(verts);
+		}
+
+		void ToPolylines(
+			const ClipperLib::ExPolygons& regions,
+			VariantVector& boundariesOut,
+			PODVector<bool>& holesOut,
+			PODVector<int>& regionsOut
+		) const
+		{
+			boundariesOut.Clear();
+			holesOut.Clear();
+			regionsOut.Clear();
+
+			for (unsigned i = 0; i < regions.size(); ++i) {
+				boundariesOut.Push(ToPolyline(regions[i].outer));
+				holesOut.Push(false);
+				regionsOut.Push(i);
+				for (unsigned j = 0; j < regions[i].holes.size(); ++j) {
+					boundariesOut.Push(ToPolyline(regions[i].holes[j]));
+					holesOut.Push(true);
+					regionsOut.Push(i);
+				}
+			}
+		}
+
+	private:
+		Matrix3x4 plane_;
+		Matrix3x4 inverse_;
+		double centerX_;
+		double centerY_;
+		double scale_;
+	};
+
+	ClipperLib::PolyFillType ToClipperFill(Geomlib::PolygonFillRule fillRule)
+	{
+		return fillRule == Geomlib::FILL_EVENODD ? ClipperLib::pftEvenOdd : ClipperLib::pftNonZero;
+	}
+
+	struct Normal {
+		double x;
+		double y;
+	};
+
+	// Offsets the corners of rings, in the manner of later Clipper versions' ClipperOffset: the offset edges are
+	// joined at each convex corner, concave corners are looped through the vertex and left to the union that follows.
+	// Unlike the bundled OffsetPolygons, the number of arc steps depends on the tolerance and not on the integer scale.
+	class RingOffsetter
+	{
+	public:
+		RingOffsetter(double delta, Geomlib::PolygonJoin join, double miterLimit, double roundTolerance) :
+			delta_(delta),
+			join_(join)
+		{
+			miterMin_ = miterLimit > 2.0 ? 2.0 / (miterLimit * miterLimit) : 0.5;
+
+			double tolerance = std::max(roundTolerance, 1e-6);
+			double steps = tolerance < 1.0 ? PI_D / std::acos(1.0 - tolerance) : 2.0;
+			steps = std::max(std::min(steps, std::fabs(delta) * PI_D), 4.0);
+			stepSin_ = std::sin(2.0 * PI_D / steps);
+			stepCos_ = std::cos(2.0 * PI_D / steps);
+			stepsPerRad_ = steps / (2.0 * PI_D);
+			if (delta < 0.0) {
+				stepSin_ = -stepSin_;
+			}
+		}
+
+		void Offset(const ClipperLib::Polygons& in, ClipperLib::Polygons& out)
+		{
+			out.clear();
+			out.reserve(in.size());
+			for (unsigned i = 0; i < in.size(); ++i) {
+				if (in[i].size() < 3) {
+					continue;
+				}
+				out.push_back(ClipperLib::Polygon());
+				OffsetRing(in[i], out.back());
+			}
+		}
+
+	private:
+		void OffsetRing(const ClipperLib::Polygon& src, ClipperLib::Polygon& dest)
+		{
+			unsigned len = (unsigned)src.size();
+			normals_.resize(len);
+			for (unsigned j = 0; j < len; ++j) {
+				const IntPoint& a = src[j];
+				const IntPoint& b = src[(j + 1) % len];
+				double dx = (double)(b.X - a.X);
+				double dy = (double)(b.Y - a.Y);
+				double l = std::sqrt(dx * dx + dy * dy);
+				normals_[j].x = l > 0.0 ? dy / l : 0.0;
+				normals_[j].y = l > 0.0 ? -dx / l : 0.0;
+			}
+
+			dest.clear();
+			dest.reserve(2 * len);
+			unsigned k = len - 1;
+			for (unsigned j = 0; j < len; ++j) {
+				OffsetCorner(src[j], normals_[k], normals_[j], dest);
+				k = j;
+			}
+		}
+
+		void Push(ClipperLib::Polygon& dest, const IntPoint& pt, double x, double y)
+		{
+			dest.push_back(IntPoint(RoundToInt(pt.X + x), RoundToInt(pt.Y + y)));
+		}
+
+		void OffsetCorner(const IntPoint& pt, const Normal& nk, const Normal& nj, ClipperLib::Polygon& dest)
+		{
+			double sinA = nk.x * nj.y - nj.x * nk.y;
+			double cosA = nk.x * nj.x + nk.y * nj.y;
+
+			if (std::fabs(sinA * delta_) < 1.0) {
+				// almost straight on, one vertex will do
+				if (cosA > 0.0) {
+					Push(dest, pt, nk.x * delta_, nk.y * delta_);
+					return;
+				}
+			}
+			else {
+				sinA = std::max(std::min(sinA, 1.0), -1.0);
+			}
+
+			if (sinA * delta_ < 0.0) {
+				// concave with respect to the offset, the loop through pt is removed by the union
+				Push(dest, pt, nk.x * delta_, nk.y * delta_);
+				dest.push_back(pt);
+				Push(dest, pt, nj.x * delta_, nj.y * delta_);
+				return;
+			}
+
+			switch (join_) {
+			case Geomlib::JOIN_MITER:
+			{
+				double r = 1.0 + cosA;
+				if (r >= miterMin_) {
+					double q = delta_ / r;
+					Push(dest, pt, (nk.x + nj.x) * q, (nk.y + nj.y) * q);
+				}
+				else {
+					Square(pt, nk, nj, sinA, cosA, dest);
+				}
+				break;
+			}
+			case Geomlib::JOIN_ROUND:
+			{
+				double a = std::atan2(sinA, cosA);
+				int steps = std::max((int)RoundToInt(stepsPerRad_ * std::fabs(a)), 1);
+				double x = nk.x;
+				double y = nk.y;
+				for (int i = 0; i < steps; ++i) {
+					Push(dest, pt, x * delta_, y * delta_);
+					double x2 = x;
+					x = x * stepCos_ - stepSin_ * y;
+					y = x2 * stepSin_ + y * stepCos_;
+				}
+				Push(dest, pt, nj.x * delta_, nj.y * delta_);
+				break;
+			}
+			default:
+				Square(pt, nk, nj, sinA, cosA, dest);
+				break;
+			}
+		}
+
+		void Square(const IntPoint& pt, const Normal& nk, const Normal& nj, double sinA, double cosA, ClipperLib::Polygon& dest)
+		{
+			double dx = std::tan(std::atan2(sinA, cosA) / 4.0);
+			Push(dest, pt, delta_ * (nk.x - nk.y * dx), delta_ * (nk.y + nk.x * dx));
+			Push(dest, pt, delta_ * (nj.x + nj.y * dx), delta_ * (nj.y - nj.x * dx));
+		}
+
+		double delta_;
+		Geomlib::PolygonJoin join_;
+		double miterMin_;
+		double stepSin_;
+		double stepCos_;
+		double stepsPerRad_;
+		std::vector<Normal> normals_;
+	};
+
+	// Groups the polygons into clusters whose bounding boxes, grown by margin, do not touch across clusters.
+	// Filled regions of different clusters cannot overlap, so each cluster is an independent, much smaller
+	// Clipper problem. This also sidesteps the bundled Clipper's sorted list inserts, which are quadratic in the
+	// number of polygons per call. Polygons within a cluster are ordered by their lowest point, which is the
+	// order its local minima list is cheapest to build in.
+	struct PolygonCluster
+	{
+		ClipperLib::Polygons subjects_;
+		ClipperLib::Polygons clips_;
+	};
+
+	struct PolygonBounds
+	{
+		long64 minX_;
+		long64 minY_;
+		long64 maxX_;
+		long64 maxY_;
+	};
+
+	int FindRoot(std::vector<int>& parents, int i)
+	{
+		while (parents[i] != i) {
+			parents[i] = parents[parents[i]];
+			i = parents[i];
+		}
+		return i;
+	}
+
+	void ClusterPolygons(
+		const ClipperLib::Polygons& subjects,
+		const ClipperLib::Polygons& clips,
+		long64 margin,
+		Vector<PolygonCluster>& clusters
+	)
+	{
+		unsigned numSubjects = (unsigned)subjects.size();
+		unsigned numPolys = numSubjects + (unsigned)clips.size();
+
+		std::vector<PolygonBounds> bounds(numPolys);
+		for (unsigned i = 0; i < numPolys; ++i) {
+			const ClipperLib::Polygon& poly = i < numSubjects ? subjects[i] : clips[i - numSubjects];
+			PolygonBounds& b = bounds[i];
+			b.minX_ = b.maxX_ = poly.empty() ? 0 : poly[0].X;
+			b.minY_ = b.maxY_ = poly.empty() ? 0 : poly[0].Y;
+			for (unsigned j = 1; j < poly.size(); ++j) {
+				b.minX_ = std::min(b.minX_, poly[j].X);
+				b.maxX_ = std::max(b.maxX_, poly[j].X);
+				b.minY_ = std::min(b.minY_, poly[j].Y);
+				b.maxY_ = std::max(b.maxY_, poly[j].Y);
+			}
+		}
+
+		// sweep along X, testing each box against the boxes still open at its left side
+		std::vector<int> order(numPolys);
+		for (unsigned i = 0; i < numPolys; ++i) {
+			order[i] = i;
+		}
+		std::sort(order.begin(), order.end(), [&bounds](int a, int b) {
+			return bounds[a].minX_ < bounds[b].minX_;
+		});
+
+		std::vector<int> parents(numPolys);
+		for (unsigned i = 0; i < numPolys; ++i) {
+			parents[i] = i;
+		}
+
+		std::vector<int> open;
+		for (unsigned k = 0; k < numPolys; ++k) {
+			const PolygonBounds& b = bounds[order[k]];
+			unsigned numOpen = 0;
+			for (unsigned m = 0; m < open.size(); ++m) {
+				const PolygonBounds& o = bounds[open[m]];
+				if (o.maxX_ + 2 * margin < b.minX_) {
+					continue;
+				}
+				open[numOpen++] = open[m];
+				if (o.minY_ - 2 * margin <= b.maxY_ && b.minY_ - 2 * margin <= o.maxY_) {
+					parents[FindRoot(parents, open[m])] = FindRoot(parents, order[k]);
+				}
+			}
+			open.resize(numOpen);
+			open.push_back(order[k]);
+		}
+
+		// clusters numbered by their first polygon, so results come out in input order
+		std::vector<int> clusterOf(numPolys, -1);
+		std::vector<int> polyCluster(numPolys);
+		clusters.Clear();
+		for (unsigned i = 0; i < numPolys; ++i) {
+			int root = FindRoot(parents, i);
+			if (clusterOf[root] < 0) {
+				clusterOf[root] = (int)clusters.Size();
+				clusters.Push(PolygonCluster());
+			}
+			polyCluster[i] = clusterOf[root];
+		}
+
+		std::sort(order.begin(), order.end(), [&bounds](int a, int b) {
+			return bounds[a].maxY_ < bounds[b].maxY_;
+		});
+		for (unsigned k = 0; k < numPolys; ++k) {
+			int i = order[k];
+			PolygonCluster& cluster = clusters[polyCluster[i]];
+			if (i < (int)numSubjects) {
+				cluster.subjects_.push_back(subjects[i]);
+			}
+			else {
+				cluster.clips_.push_back(clips[i - numSubjects]);
+			}
+		}
+	}
+
+	// below this many clusters the Clipper runs stay on the calling thread
+	const int MIN_PARALLEL_CLUSTERS = 8;
+
+	bool SolveClusters(
+		const Vector<PolygonCluster>& clusters,
+		const std::function<bool(const PolygonCluster&, ClipperLib::ExPolygons&)>& solve,
+		ClipperLib::ExPolygons& regions
+	)
+	{
+		std::vector<ClipperLib::ExPolygons> clusterRegions(clusters.Size());
+		std::vector<char> clusterSolved(clusters.Size(), 0);
+		igl::parallel_for(
+			(int)clusters.Size(),
+			[&clusters, &solve, &clusterRegions, &clusterSolved](int i) {
+				clusterSolved[i] = solve(clusters[i], clusterRegions[i]) ? 1 : 0;
+			},
+			MIN_PARALLEL_CLUSTERS
+		);
+
+		regions.clear();
+		for (unsigned i = 0; i < clusters.Size(); ++i) {
+			if (!clusterSolved[i]) {
+				return false;
+			}
+			regions.insert(regions.end(), clusterRegions[i].begin(), clusterRegions[i].end());
+		}
+		return true;
+	}
+
+	bool OffsetCluster(
+		const ClipperLib::Polygons& input,
+		double delta,
+		Geomlib::PolygonJoin join,
+		double miterLimit,
+		double roundTolerance,
+		ClipperLib::ExPolygons& regions
+	)
+	{
+		// normalize first: outer boundaries counter-clockwise, holes clockwise, no overlaps
+		ClipperLib::Polygons polys;
+		ClipperLib::SimplifyPolygons(input, polys, ClipperLib::pftNonZero);
+
+		if (std::fabs(delta) >= 1.0) {
+			ClipperLib::Polygons offsetPolys;
+			RingOffsetter offsetter(delta, join, miterLimit, roundTolerance);
+			offsetter.Offset(polys, offsetPolys);
+
+			ClipperLib::Clipper clipper;
+			clipper.AddPolygons(offsetPolys, ClipperLib::ptSubject);
+			if (delta > 0.0) {
+				if (!clipper.Execute(ClipperLib::ctUnion, regions, ClipperLib::pftPositive, ClipperLib::pftPositive)) {
+					return false;
+				}
+				return true;
+			}
+
+			// Shrunk outlines wind negatively where they remain; frame them so the union keeps exactly those parts.
+			ClipperLib::IntRect r = clipper.GetBounds();
+			ClipperLib::Polygon outer(4);
+			outer[0] = IntPoint(r.left - 10, r.bottom + 10);
+			outer[1] = IntPoint(r.right + 10, r.bottom + 10);
+			outer[2] = IntPoint(r.right + 10, r.top - 10);
+			outer[3] = IntPoint(r.left - 10, r.top - 10);
+			clipper.AddPolygon(outer, ClipperLib::ptSubject);
+
+			if (!clipper.Execute(ClipperLib::ctUnion, polys, ClipperLib::pftNegative, ClipperLib::pftNegative)) {
+				return false;
+			}
+			if (!polys.empty()) {
+				polys.erase(polys.begin());
+			}
+			ClipperLib::ReversePolygons(polys);
+		}
+
+		// one more pass to pair holes with their outer boundaries
+		ClipperLib::Clipper clipper;
+		clipper.AddPolygons(polys, ClipperLib::ptSubject);
+		return clipper.Execute(ClipperLib::ctUnion, regions, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
+	}
+
+} // namespace
+
+bool Geomlib::PolygonBoolean(
+	const Urho3D::VariantVector& subjects,
+	const Urho3D::VariantVector& clips,
+	PolygonOperation operation,
+	PolygonFillRule fillRule,
+	const Urho3D::Matrix3x4& plane,
+	Urho3D::VariantVector& boundariesOut,
+	Urho3D::PODVector<bool>& holesOut,
+	Urho3D::PODVector<int>& regionsOut
+)
+{
+	boundariesOut.Clear();
+	holesOut.Clear();
+	regionsOut.Clear();
+
+	PlaneMapping mapping(plane);
+	Vector<PODVector<Vector2> > subjectRings;
+	Vector<PODVector<Vector2> > clipRings;
+	mapping.Project(subjects, subjectRings);
+	mapping.Project(clips, clipRings);
+	if (subjectRings.Empty() && clipRings.Empty()) {
+		return false;
+	}
+
+	// one grid for both lists, so shared vertices stay shared
+	Vector<PODVector<Vector2> > allRings = subjectRings;
+	allRings.Push(clipRings);
+	mapping.Fit(allRings, 0.0);
+
+	ClipperLib::Polygons subjectPolys;
+	ClipperLib::Polygons clipPolys;
+	mapping.ToClipper(subjectRings, subjectPolys);
+	mapping.ToClipper(clipRings, clipPolys);
+
+	ClipperLib::ClipType clipType = ClipperLib::ctUnion;
+	switch (operation) {
+	case POLYGON_INTERSECTION:
+		clipType = ClipperLib::ctIntersection;
+		break;
+	case POLYGON_DIFFERENCE:
+		clipType = ClipperLib::ctDifference;
+		break;
+	case POLYGON_XOR:
+		clipType = ClipperLib::ctXor;
+		break;
+	default:
+		break;
+	}
+	ClipperLib::PolyFillType fill = ToClipperFill(fillRule);
+
+	Vector<PolygonCluster> clusters;
+	ClusterPolygons(subjectPolys, clipPolys, 0, clusters);
+
+	ClipperLib::ExPolygons regions;
+	bool success = SolveClusters(
+		clusters,
+		[clipType, fill](const PolygonCluster& cluster, ClipperLib::ExPolygons& clusterRegions) {
+			ClipperLib::Clipper clipper;
+			clipper.AddPolygons(cluster.subjects_, ClipperLib::ptSubject);
+			clipper.AddPolygons(cluster.clips_, ClipperLib::ptClip);
+			return clipper.Execute(clipType, clusterRegions, fill, fill);
+		},
+		regions
+	);
+	if (!success) {
+		return false;
+	}
+
+	mapping.ToPolylines(regions, boundariesOut, holesOut, regionsOut);
+	return true;
+}
+
+bool Geomlib::PolygonOffset(
+	const Urho3D::VariantVector& polylines,
+	float distance,
+	PolygonJoin join,
+	float miterLimit,
+	const Urho3D::Matrix3x4& plane,
+	Urho3D::VariantVector& boundariesOut,
+	Urho3D::PODVector<bool>& holesOut,
+	Urho3D::PODVector<int>& regionsOut,
+	float roundTolerance
+)
+{
+	boundariesOut.Clear();
+	holesOut.Clear();
+	regionsOut.Clear();
+
+	PlaneMapping mapping(plane);
+	Vector<PODVector<Vector2> > rings;
+	mapping.Project(polylines, rings);
+	if (rings.Empty()) {
+		return false;
+	}
+
+	// leave room for the farthest a miter can reach
+	double reach = std::fabs((double)distance) * std::max((double)miterLimit, 2.0);
+	mapping.Fit(rings, reach);
+
+	ClipperLib::Polygons polys;
+	mapping.ToClipper(rings, polys);
+
+	// outlines further apart than twice the reach cannot meet after offsetting
+	double delta = distance * mapping.GetScale();
+	Vector<PolygonCluster> clusters;
+	ClusterPolygons(polys, ClipperLib::Polygons(), distance > 0.0f ? RoundToInt(reach * mapping.GetScale()) + 1 : 0, clusters);
+
+	ClipperLib::ExPolygons regions;
+	bool success = SolveClusters(
+		clusters,
+		[delta, join, miterLimit, roundTolerance](const PolygonCluster& cluster, ClipperLib::ExPolygons& clusterRegions) {
+			return OffsetCluster(cluster.subjects_, delta, join, miterLimit, roundTolerance, clusterRegions);
+		},
+		regions
+	);
+	if (!success) {
+		return false;
+	}
+
+	mapping.ToPolylines(regions, boundariesOut, holesOut, regionsOut);
+	return true;
+}
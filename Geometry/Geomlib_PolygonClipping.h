@@ -0,0 +1,93 @@
+//
+// Copyright (c) 2016 - 2017 Mesh Consultants Inc.
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include <Urho3D/Container/Vector.h>
+#include <Urho3D/Core/Variant.h>
+#include <Urho3D/Math/Matrix3x4.h>
+
+namespace Geomlib {
+
+	enum PolygonOperation {
+		POLYGON_UNION = 0,
+		POLYGON_INTERSECTION,
+		POLYGON_DIFFERENCE,
+		POLYGON_XOR
+	};
+
+	// How overlapping and nested boundaries of one input list are filled.
+	// Even-odd treats every nested boundary as a hole whatever its winding;
+	// non-zero fills overlaps, so holes must wind opposite to their outer boundary (as all results here do).
+	enum PolygonFillRule {
+		FILL_EVENODD = 0,
+		FILL_NONZERO
+	};
+
+	enum PolygonJoin {
+		JOIN_MITER = 0,
+		JOIN_ROUND,
+		JOIN_SQUARE
+	};
+
+	// Planar polygon operations on closed polylines, computed by Clipper in integer coordinates.
+	//
+	// The polylines are projected onto the XZ plane of the transform plane (its Y axis is the normal), scaled to
+	// integers over their joint bounding box, and the results are mapped back onto the plane; open polylines are
+	// treated as closed. A whole list is processed in one sweep, so unions of thousands of outlines cost about as
+	// much as sorting their edges.
+	//
+	// Outputs:
+	//   boundariesOut: closed polylines; each outer boundary is followed by its holes.
+	//                  Outer boundaries wind counter-clockwise seen from the +Y side of plane, holes clockwise.
+	//   holesOut:      per boundary, whether it is a hole
+	//   regionsOut:    per boundary, index of the filled region (outer boundary plus holes) it belongs to
+	// Returns false if Clipper fails or no input is a valid polyline.
+	bool PolygonBoolean(
+		const Urho3D::VariantVector& subjects,
+		const Urho3D::VariantVector& clips,
+		PolygonOperation operation,
+		PolygonFillRule fillRule,
+		const Urho3D::Matrix3x4& plane,
+		Urho3D::VariantVector& boundariesOut,
+		Urho3D::PODVector<bool>& holesOut,
+		Urho3D::PODVector<int>& regionsOut
+	);
+
+	// Offsets the region filled by polylines (non-zero fill) by distance, growing it for distance > 0
+	// and shrinking it for distance < 0. Overlaps created by the offset are merged, parts that vanish are dropped.
+	// Miter joins fall back to square ones where the miter would exceed miterLimit * |distance|.
+	// Round joins deviate from the true arc by at most roundTolerance * |distance|.
+	// Outputs as PolygonBoolean.
+	bool PolygonOffset(
+		const Urho3D::VariantVector& polylines,
+		float distance,
+		PolygonJoin join,
+		float miterLimit,
+		const Urho3D::Matrix3x4& plane,
+		Urho3D::VariantVector& boundariesOut,
+		Urho3D::PODVector<bool>& holesOut,
+		Urho3D::PODVector<int>& regionsOut,
+		float roundTolerance = 0.002f
+	);
+
+}
@@ -25,7 +25,7 @@
 #include <algorithm>
 #include <vector>
 
-#include "Geomlib_PolylinePointFromParameter.h"
+#include "Geomlib_PolylineEvaluator.h"
 #include "Polyline.h"
 
 namespace {
@@ -74,29 +74,27 @@ bool Geomlib::PolylineDivide(
 		return false;
 	}
 
+	std::shared_ptr<const PolylineEvaluator> evaluator = PolylineEvaluator::Get(polylineIn);
+	if (!evaluator) {
+		polylineOut = Variant();
+		return false;
+	}
+
 	float inc = 1.0f / n;
 
-	Vector<float> params;
-	for (unsigned i = 0; i < n; ++i) {
-		params.Push(i * inc);
+	Urho3D::PODVector<float> params(n + 1);
+	for (int i = 0; i < n; ++i) {
+		params[i] = i * inc;
 	}
-	params.Push(1.0f);
+	params[n] = 1.0f;
 
-	if (params.Size() <= 1) {
-		polylineOut = Variant();
-		return false;
-	}
+	// the parameters ascend, so they are evaluated in one walk along the polyline
+	Urho3D::PODVector<Vector3> points;
+	evaluator->Evaluate(params, &points);
 
-	Urho3D::VariantVector vertexList;
-	for (unsigned i = 0; i < params.Size(); ++i) {
-		Vector3 vec;
-		float t = params[i];
-		bool success = PolylinePointFromParameter(polylineIn, t, vec);
-		if (!success) {
-			polylineOut = Variant();
-			return false;
-		}
-		vertexList.Push(Variant(vec));
+	Urho3D::VariantVector vertexList(points.Size());
+	for (unsigned i = 0; i < points.Size(); ++i) {
+		vertexList[i] = Variant(points[i]);
 	}
 	if (vertexList.Size() <= 1) {
 		polylineOut = Variant();
@@ -0,0 +1,322 @@
+//
+// Copyright (c) 2016 - 2017 Mesh Consultants Inc.
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "Geomlib_PolylineEvaluator.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <Urho3D/Core/Mutex.h>
+#include <Urho3D/Math/Quaternion.h>
+
+using namespace Urho3D;
+
+namespace {
+
+	// number of polylines whose evaluator is kept around
+	const unsigned MAX_CACHED_EVALUATORS = 16;
+
+	Mutex evaluatorCacheMutex;
+	Vector<std::shared_ptr<const Geomlib::PolylineEvaluator> > evaluatorCache;
+
+	// sequential vertex list of a polyline, as Polyline_ComputeSequentialVertexList but reading the map in place
+	bool ExtractPolyline(const Variant& polyline, PODVector<Vector3>& points, bool& closed)
+	{
+		if (polyline.GetType() != VAR_VARIANTMAP) {
+			return false;
+		}
+
+		const VariantMap& varMap = polyline.GetVariantMap();
+		VariantMap::ConstIterator type = varMap.Find("type");
+		VariantMap::ConstIterator vertices = varMap.Find("vertices");
+		VariantMap::ConstIterator edges = varMap.Find("edges");
+		if (type == varMap.End() || type->second_.GetType() != VAR_STRING || type->second_.GetString() != "Polyline" ||
+			vertices == varMap.End() || edges == varMap.End()) {
+			return false;
+		}
+
+		const VariantVector& vertexList = vertices->second_.GetVariantVector();
+		const VariantVector& edgeList = edges->second_.GetVariantVector();
+
+		points.Resize(edgeList.Size());
+		for (unsigned i = 0; i < edgeList.Size(); ++i) {
+			int j = edgeList[i].GetInt();
+			if (j < 0 || j >= (int)vertexList.Size()) {
+				return false;
+			}
+			points[i] = vertexList[j].GetVector3();
+		}
+
+		closed = edgeList.Size() >= 3 && edgeList[0].GetInt() == edgeList.Back().GetInt();
+
+		return !points.Empty();
+	}
+
+	// sdbm over the raw coordinate bits
+	unsigned HashPoints(const PODVector<Vector3>& points, bool closed)
+	{
+		unsigned hash = 2 * points.Size() + (closed ? 1 : 0);
+		for (unsigned i = 0; i < points.Size(); ++i) {
+			const float* data = points[i].Data();
+			for (unsigned k = 0; k < 3; ++k) {
+				unsigned word;
+				memcpy(&word, data + k, sizeof(word));
+				hash = word + (hash << 6) + (hash << 16) - hash;
+			}
+		}
+		return hash;
+	}
+
+} // namespace
+
+Geomlib::PolylineEvaluator::PolylineEvaluator(const Variant& polyline) :
+	closed_(false),
+	hash_(0)
+{
+	if (!ExtractPolyline(polyline, points_, closed_)) {
+		points_.Clear();
+		closed_ = false;
+	}
+	Build();
+}
+
+Geomlib::PolylineEvaluator::PolylineEvaluator(const PODVector<Vector3>& points, bool closed) :
+	points_(points),
+	closed_(closed),
+	hash_(0)
+{
+	Build();
+}
+
+void Geomlib::PolylineEvaluator::Build()
+{
+	lengths_.Resize(points_.Size());
+
+	float length = 0.0f;
+	for (unsigned i = 0; i < points_.Size(); ++i) {
+		if (i > 0) {
+			length += (points_[i] - points_[i - 1]).Length();
+		}
+		lengths_[i] = length;
+	}
+
+	hash_ = HashPoints(points_, closed_);
+}
+
+unsigned Geomlib::PolylineEvaluator::FindSegment(float distance) const
+{
+	// first vertex past distance among the segment starts
+	unsigned last = points_.Size() - 2;
+	const float* begin = &lengths_[0];
+	unsigned i = (unsigned)(std::upper_bound(begin, begin + last + 1, distance) - begin);
+
+	return i > 0 ? i - 1 : 0;
+}
+
+unsigned Geomlib::PolylineEvaluator::AdvanceSegment(unsigned segment, float distance) const
+{
+	unsigned last = points_.Size() - 2;
+	while (segment < last && lengths_[segment + 1] <= distance) {
+		++segment;
+	}
+
+	return segment;
+}
+
+Vector3 Geomlib::PolylineEvaluator::SegmentPoint(unsigned segment, float distance) const
+{
+	Vector3 start = points_[segment];
+	Vector3 seg = points_[segment + 1] - start;
+	float segLength = seg.Length();
+	if (Equals(segLength, 0.0f)) {
+		return start;
+	}
+
+	float s = Clamp((distance - lengths_[segment]) / segLength, 0.0f, 1.0f);
+	return start + s * seg;
+}
+
+Vector3 Geomlib::PolylineEvaluator::SegmentTangent(unsigned segment) const
+{
+	return (points_[segment + 1] - points_[segment]).Normalized();
+}
+
+// Normal of the plane of the corner at vertex i, the first vertex of an open polyline borrows the corner at vertex 1.
+// Collinear corners give a zero normal, the frame then falls back to the shortest rotation onto the tangent.
+Vector3 Geomlib::PolylineEvaluator::VertexNormal(unsigned i) const
+{
+	unsigned n = points_.Size();
+	Vector3 leftHandDir;
+	Vector3 rightHandDir;
+
+	if (i == 0 && closed_) {
+		// note we want the second last entry, the last one repeats the first
+		leftHandDir = points_[n - 2] - points_[0];
+		rightHandDir = points_[1] - points_[0];
+	}
+	else if (i == 0) {
+		leftHandDir = points_[0] - points_[1];
+		rightHandDir = points_[2] - points_[1];
+	}
+	else {
+		leftHandDir = points_[i - 1] - points_[i];
+		rightHandDir = points_[i + 1] - points_[i];
+	}
+
+	return rightHandDir.Normalized().CrossProduct(leftHandDir.Normalized());
+}
+
+Matrix3x4 Geomlib::PolylineEvaluator::SegmentFrame(unsigned segment, const Vector3& position) const
+{
+	// a single segment has no plane, look along it
+	Vector3 normal = points_.Size() > 2 ? VertexNormal(segment) : Vector3::ZERO;
+
+	Quaternion rot;
+	rot.FromLookRotation(SegmentTangent(segment), normal);
+
+	return Matrix3x4(position, rot, Vector3::ONE);
+}
+
+Vector3 Geomlib::PolylineEvaluator::PointAt(float t) const
+{
+	if (points_.Size() < 2 || Equals(GetLength(), 0.0f)) {
+		// degenerate 1-point polyline, or all points identical
+		return points_.Empty() ? Vector3::ZERO : points_[0];
+	}
+
+	float distance = Clamp(t, 0.0f, 1.0f) * GetLength();
+	return SegmentPoint(FindSegment(distance), distance);
+}
+
+bool Geomlib::PolylineEvaluator::FrameAt(float t, Matrix3x4& frame) const
+{
+	if (points_.Size() < 2 || Equals(GetLength(), 0.0f)) {
+		return false;
+	}
+
+	float distance = Clamp(t, 0.0f, 1.0f) * GetLength();
+	unsigned segment = FindSegment(distance);
+	frame = SegmentFrame(segment, SegmentPoint(segment, distance));
+
+	return true;
+}
+
+void Geomlib::PolylineEvaluator::Evaluate(
+	const PODVector<float>& ts,
+	PODVector<Vector3>* points,
+	PODVector<Vector3>* tangents,
+	PODVector<Matrix3x4>* frames
+) const
+{
+	unsigned m = ts.Size();
+	if (points) {
+		points->Resize(m);
+	}
+	if (tangents) {
+		tangents->Resize(m);
+	}
+	if (frames) {
+		frames->Resize(m);
+	}
+
+	if (points_.Size() < 2 || Equals(GetLength(), 0.0f)) {
+		Vector3 point = points_.Empty() ? Vector3::ZERO : points_[0];
+		for (unsigned i = 0; i < m; ++i) {
+			if (points) {
+				(*points)[i] = point;
+			}
+			if (tangents) {
+				(*tangents)[i] = Vector3::ZERO;
+			}
+			if (frames) {
+				(*frames)[i] = Matrix3x4::IDENTITY;
+			}
+		}
+		return;
+	}
+
+	float totalLength = GetLength();
+	unsigned segment = 0;
+	float lastDistance = -1.0f;
+
+	for (unsigned i = 0; i < m; ++i) {
+		float distance = Clamp(ts[i], 0.0f, 1.0f) * totalLength;
+		segment = distance >= lastDistance ? AdvanceSegment(segment, distance) : FindSegment(distance);
+		lastDistance = distance;
+
+		Vector3 point = SegmentPoint(segment, distance);
+		if (points) {
+			(*points)[i] = point;
+		}
+		if (tangents) {
+			(*tangents)[i] = SegmentTangent(segment);
+		}
+		if (frames) {
+			(*frames)[i] = SegmentFrame(segment, point);
+		}
+	}
+}
+
+bool Geomlib::PolylineEvaluator::Matches(const PODVector<Vector3>& points, bool closed) const
+{
+	return closed_ == closed &&
+		points_.Size() == points.Size() &&
+		memcmp(&points_[0], &points[0], points_.Size() * sizeof(Vector3)) == 0;
+}
+
+std::shared_ptr<const Geomlib::PolylineEvaluator> Geomlib::PolylineEvaluator::Get(const Variant& polyline)
+{
+	std::shared_ptr<const PolylineEvaluator> evaluator;
+
+	// the walk over the vertices is needed to key the cache anyway, but copies no Variants
+	PODVector<Vector3> points;
+	bool closed = false;
+	if (!ExtractPolyline(polyline, points, closed)) {
+		return evaluator;
+	}
+
+	{
+		unsigned hash = HashPoints(points, closed);
+
+		MutexLock lock(evaluatorCacheMutex);
+		for (unsigned i = 0; i < evaluatorCache.Size(); ++i) {
+			const std::shared_ptr<const PolylineEvaluator>& cached = evaluatorCache[i];
+			if (cached->hash_ == hash && cached->Matches(points, closed)) {
+				// most recently used goes to the front
+				evaluator = cached;
+				evaluatorCache.Erase(i);
+				evaluatorCache.Insert(0, evaluator);
+				return evaluator;
+			}
+		}
+	}
+
+	// build outside the lock, two threads racing on the same polyline just build it twice
+	evaluator = std::make_shared<PolylineEvaluator>(points, closed);
+
+	MutexLock lock(evaluatorCacheMutex);
+	evaluatorCache.Insert(0, evaluator);
+	if (evaluatorCache.Size() > MAX_CACHED_EVALUATORS) {
+		evaluatorCache.Pop();
+	}
+	return evaluator;
+}
@@ -0,0 +1,85 @@
+//
+// Copyright (c) 2016 - 2017 Mesh Consultants Inc.
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include <Urho3D/Container/Vector.h>
+#include <Urho3D/Core/Variant.h>
+#include <Urho3D/Math/Matrix3x4.h>
+#include <Urho3D/Math/Vector3.h>
+
+#include <memory>
+
+namespace Geomlib {
+
+	// Arc-length parameterization of a polyline.
+	// The cumulative segment lengths are kept in one prefix array, so a parameter is located by binary search
+	// and an ascending batch of parameters by a single forward walk. Build once with PolylineEvaluator::Get and share it.
+	class PolylineEvaluator
+	{
+	public:
+		PolylineEvaluator(const Urho3D::Variant& polyline);
+		PolylineEvaluator(const Urho3D::PODVector<Urho3D::Vector3>& points, bool closed);
+
+		bool IsValid() const { return !points_.Empty(); }
+		unsigned GetNumVertices() const { return points_.Size(); }
+		const Urho3D::Vector3& GetVertex(unsigned i) const { return points_[i]; }
+		float GetLength() const { return lengths_.Empty() ? 0.0f : lengths_.Back(); }
+		bool IsClosed() const { return closed_; }
+
+		// t is clamped to 0 <= t <= 1, start of polyline is t=0, end of polyline is t=1
+		Urho3D::Vector3 PointAt(float t) const;
+		// Returns false on polylines without length, where no frame is defined
+		bool FrameAt(float t, Urho3D::Matrix3x4& frame) const;
+
+		// Evaluates all parameters of ts. Runs of ascending values are located by walking forward from the previous one,
+		// anything else by binary search. Outputs that are null are skipped.
+		// Tangents are unit length, frames are those of FrameAt; both are left zero/identity on polylines without length.
+		void Evaluate(
+			const Urho3D::PODVector<float>& ts,
+			Urho3D::PODVector<Urho3D::Vector3>* points,
+			Urho3D::PODVector<Urho3D::Vector3>* tangents = 0,
+			Urho3D::PODVector<Urho3D::Matrix3x4>* frames = 0
+		) const;
+
+		// Returns the evaluator of polyline, building it on first use.
+		static std::shared_ptr<const PolylineEvaluator> Get(const Urho3D::Variant& polyline);
+
+	private:
+		void Build();
+		// last segment [i, i + 1] starting at or before distance, skipping zero length segments where possible
+		unsigned FindSegment(float distance) const;
+		unsigned AdvanceSegment(unsigned segment, float distance) const;
+		Urho3D::Vector3 SegmentPoint(unsigned segment, float distance) const;
+		Urho3D::Vector3 SegmentTangent(unsigned segment) const;
+		Urho3D::Matrix3x4 SegmentFrame(unsigned segment, const Urho3D::Vector3& position) const;
+		Urho3D::Vector3 VertexNormal(unsigned i) const;
+		bool Matches(const Urho3D::PODVector<Urho3D::Vector3>& points, bool closed) const;
+
+		// vertices in sequence, a closed polyline repeats its first vertex at the end
+		Urho3D::PODVector<Urho3D::Vector3> points_;
+		// lengths_[i] is the arc length from the start to vertex i
+		Urho3D::PODVector<float> lengths_;
+		bool closed_;
+		unsigned hash_;
+	};
+}
@@ -19,215 +19,591 @@
 // THE SOFTWARE.
 //
 
-#include "Geomlib_PolylineIntersection.h""
-
-
-// [t1, t2] interval of real number line; no promise that t1 <= t2
-// [s1, s2] interval of real number line; no promise that s1 <= s2
-// Returns:
-//   1 if [t1, t2] and [s1, s2] have non-empty intersection
-//   0 otherwise
-
-//int IntervalIntervalIntersection(
-//	double t1,
-//	double t2,
-//	double s1,
-//	double s2)
-//{
-//	if (t1 > t2) {
-//		double x = t1;
-//		t1 = t2;
-//		t2 = x;
-//	}
-//	if (s1 > s2) {
-//		double y = s1;
-//		s1 = s2;
-//		s2 = y;
-//	}
-//
-//	if (s1 <= t1 && t1 <= s2) {
-//		return 1;
-//	}
-//	else if (s1 <= t2 && t2 <= s2) {
-//		return 1;
-//	}
-//	else if (t1 <= s1 && s1 <= t2) {
-//		return 1;
-//	}
-//
-//	return 0;
-//}
-//
-////   1 if (A,B) and (C,D) have non-empty intersection
-////   0 otherwise
-//int SegmentSegmentIntersection2D(
-//	const Eigen::RowVector2d& A,
-//	const Eigen::RowVector2d& B,
-//	const Eigen::RowVector2d& C,
-//	const Eigen::RowVector2d& D)
-//{
-//	// left & right half plane checks
-//	if (
-//		(A(0) > 0 && B(0) > 0) && // A,B in right half plane
-//		(C(0) < 0 && D(0) < 0)    // C,D in left half plane
-//		) {
-//		return 0;
-//	}
-//	if (
-//		(A(0) < 0 && B(0) < 0) && // A,B in left half plane
-//		(C(0) > 0 && D(0) > 0)    // C,D in right half plane
-//		) {
-//		return 0;
-//	}
-//	// upper & lower half plane checks
-//	if (
-//		(A(1) > 0 && B(1) > 0) && // A,B in upper half plane
-//		(C(1) < 0 && D(1) < 0)    // C,D in lower half plane
-//		) {
-//		return 0;
-//	}
-//	if (
-//		(A(1) < 0 && B(1) < 0) && // A,B in lower half plane
-//		(C(1) > 0 && D(1) > 0)    // C,D in upper half plane
-//		) {
-//		return 0;
-//	}
-//
-//	// do C and D lie strictly on the same side of line through AB?
-//	double cval = (B(1) - A(1)) * (C(0) - A(0)) + (A(0) - B(0)) * (C(1) - A(1));
-//	double dval = (B(1) - A(1)) * (D(0) - A(0)) + (A(0) - B(0)) * (D(1) - A(1));
-//	if ((cval > 0 && dval > 0) || (cval < 0 && dval < 0)) {
-//		return 0;
-//	}
-//	// do A and B lie strictly on the same side of line through CD?
-//	double aval = (D(1) - C(1)) * (A(0) - C(0)) + (C(0) - D(0)) * (A(1) - C(1));
-//	double bval = (D(1) - C(1)) * (B(0) - C(0)) + (C(0) - D(0)) * (B(1) - C(1));
-//	if ((aval > 0 && bval > 0) || (aval < 0 && bval < 0)) {
-//		return 0;
-//	}
-//
-//	// lines through AB and CD definitely intersect
-//	double k11 = B(0) - A(0);
-//	double k12 = C(0) - D(0);
-//	double k21 = B(1) - A(1);
-//	double k22 = C(1) - D(1);
-//	double z1 = C(0) - A(0);
-//	double z2 = C(1) - A(1);
-//	double prod1 = k11 * k22;
-//	double prod2 = k12 * k21;
-//	double prod3 = k22 * z1;
-//	double prod4 = k12 * z2;
-//	if (abs(prod1) > 1e16 || abs(prod2) > 1e16 || abs(prod3) > 1e16 || abs(prod4) > 1e16) {
-//		double shrink = 1e-6;
-//		return SegmentSegmentIntersection2D(shrink * A, shrink * B, shrink * C, shrink * D);
-//	}
-//	double denom = prod1 - prod2;
-//	double numer = prod3 - prod4;
-//	if (prod1 == prod2) {
-//		denom = 0;
-//	}
-//
-//	const double eps = 1e-8;
-//
-//	if (denom > eps || -denom > eps) {
-//		// there is unique point of intersection: does it lie in segment AB?
-//		double t = (k22 * z1 - k12 * z2) / denom;
-//		return 0 <= t && t <= 1;
-//	}
-//	else {
-//		// lines through AB and CD coincide
-//		double rise = B(1) - A(1);
-//		double run = B(0) - A(0);
-//		// normal is (-rise, run)
-//		if (rise >= run) { // x-coord of normal is bigger, project segments to y-axis
-//			return IntervalIntervalIntersection(A(1), B(1), C(1), D(1));
-//		}
-//		else { // y-coord of normal is bigger, project segments to x-axis
-//			return IntervalIntervalIntersection(A(0), B(0), C(0), D(0));
-//		}
-//	}
-//}
-//
-//int SegmentSegmentIntersection3D(
-//	const Eigen::RowVector3d& A,
-//	const Eigen::RowVector3d& B,
-//	const Eigen::RowVector3d& C,
-//	const Eigen::RowVector3d& D,
-//	NgonPlane facePlane)
-//{
-//	// project to plane
-//	Eigen::RowVector3d N(facePlane.N);
-//
-//	// converting to regular vector to use max_element
-//	std::vector<double> Nreg;
-//	Nreg.push_back(std::abs(N(0)));
-//	Nreg.push_back(std::abs(N(1)));
-//	Nreg.push_back(std::abs(N(2)));
-//
-//	// find greatest coordinate from plane normal
-//	// projection plane will be the plane generate by the OTHER coordinate axes
-//	// e.g. if N.y is largest, project to xz-plane
-//	int maxCoord = max_element(Nreg.begin(), Nreg.end()) - Nreg.begin();
-//
-//	std::vector<Eigen::RowVector3d> startVerts;
-//	startVerts.push_back(A);
-//	startVerts.push_back(B);
-//	startVerts.push_back(C);
-//	startVerts.push_back(D);
-//
-//	// project coords to the appropriate plane
-//	// NOTE SYNTAX!!!!!!!!!!! 
-//	std::vector<Eigen::RowVector2d, Eigen::aligned_allocator<Eigen::RowVector2d>> flatVerts;
-//	for (int i = 0; i < startVerts.size(); ++i)
-//	{
-//		int counter = 0;
-//		Eigen::RowVector2d tmpCoords;
-//		for (int j = 0; j < 3; ++j)
-//		{
-//			if (j != maxCoord)
-//			{
-//				//std::cout << "counter=" << counter << " j=" << j << std::endl;
-//				//std::cout << "startVerts[" << i << "](" << j << ")=" << startVerts[i](j) << std::endl;
-//				tmpCoords(counter) = startVerts[i](j);
-//				++counter;
-//			}
-//		}
-//		//std::cout << "tmpCoords=" << tmpCoords << std::endl;
-//		flatVerts.push_back(tmpCoords);
-//	}
-//
-//	int ret = SegmentSegmentIntersection2D(flatVerts[0], flatVerts[1], flatVerts[2], flatVerts[3]);
-//	return ret;
-//
-//}
-//
-//
-//
-//// Computes the list of edges to check in IsFacePolySelfIntersecting, N = # of edges
-//// Note for edge 0, we only check it with edges 2, 3, 4, ..., N-2
-//// And we only check pairs of the form (A, B) where B>A (removes duplicate checks)
-//std::vector<std::vector<int>> GetEdgesToIntersect(int N)
-//{
-//	std::vector<std::vector<int>> edgesToCheck;
-//
-//	std::vector<int> edgePair;
-//	for (int i = 0; i < N - 1; ++i)
-//	{
-//		std::vector<int> firstCoord;
-//		firstCoord.push_back(i);
-//		for (int j = i + 2; j < N - 1 + i; ++j)
-//		{
-//			if (j < N)
-//			{
-//				edgePair = firstCoord;
-//				edgePair.push_back(j);
-//				edgesToCheck.push_back(edgePair);
-//
-//
-//			}
-//		}
-//
-//	}
-//
-//	return edgesToCheck;
-//}
\ No newline at end of file
+
+#include "Geomlib_PolylineIntersection.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <Urho3D/Math/MathDefs.h>
+
+#include <igl/parallel_for.h>
+
+#include "Polyline.h"
+
+using namespace Urho3D;
+
+namespace {
+
+	// below this many occupied cells the pair tests stay on the calling thread
+	const int MIN_PARALLEL_CELLS = 256;
+	// cell coordinates are packed in 21 bits each
+	const unsigned MAX_CELLS_PER_AXIS = 1 << 20;
+
+	struct CurveData
+	{
+		// sequential vertices, projected into the plane when there is one
+		PODVector<Vector3> points_;
+		// sequential vertices as given
+		PODVector<Vector3> worldPoints_;
+		// arc length from the start to each vertex
+		PODVector<float> lengths_;
+		bool closed_;
+
+		unsigned GetNumSegments() const { return points_.Size() - 1; }
+	};
+
+	// position on a curve, normalized so that a vertex is always (i, 0), except the end of an open curve
+	struct CurvePosition
+	{
+		int segment_;
+		float s_;
+
+		bool operator<(const CurvePosition& rhs) const
+		{
+			return segment_ < rhs.segment_ || (segment_ == rhs.segment_ && s_ < rhs.s_);
+		}
+		bool operator==(const CurvePosition& rhs) const
+		{
+			return segment_ == rhs.segment_ && s_ == rhs.s_;
+		}
+	};
+
+	CurvePosition MakePosition(const CurveData& curve, int segment, float s)
+	{
+		CurvePosition pos;
+		pos.segment_ = segment;
+		pos.s_ = s;
+		if (s >= 1.0f) {
+			if (segment + 1 < (int)curve.GetNumSegments()) {
+				pos.segment_ = segment + 1;
+				pos.s_ = 0.0f;
+			}
+			else if (curve.closed_) {
+				pos.segment_ = 0;
+				pos.s_ = 0.0f;
+			}
+			else {
+				pos.s_ = 1.0f;
+			}
+		}
+		return pos;
+	}
+
+	Vector3 PointAt(const PODVector<Vector3>& points, const CurvePosition& pos)
+	{
+		const Vector3& a = points[pos.segment_];
+		return a + (points[pos.segment_ + 1] - a) * pos.s_;
+	}
+
+	struct CurveHit
+	{
+		int curveA_;
+		CurvePosition posA_;
+		int curveB_;
+		CurvePosition posB_;
+		Vector3 point_;
+
+		bool operator<(const CurveHit& rhs) const
+		{
+			if (curveA_ != rhs.curveA_) return curveA_ < rhs.curveA_;
+			if (!(posA_ == rhs.posA_)) return posA_ < rhs.posA_;
+			if (curveB_ != rhs.curveB_) return curveB_ < rhs.curveB_;
+			return posB_ < rhs.posB_;
+		}
+		bool operator==(const CurveHit& rhs) const
+		{
+			return curveA_ == rhs.curveA_ && posA_ == rhs.posA_ && curveB_ == rhs.curveB_ && posB_ == rhs.posB_;
+		}
+	};
+
+	struct GridSegment
+	{
+		int curve_;
+		int segment_;
+		// bounds grown by half the tolerance, so that boxes of segments within tolerance overlap
+		Vector3 min_;
+		Vector3 max_;
+	};
+
+	struct CellEntry
+	{
+		unsigned long long key_;
+		int segment_;
+
+		bool operator<(const CellEntry& rhs) const
+		{
+			return key_ < rhs.key_ || (key_ == rhs.key_ && segment_ < rhs.segment_);
+		}
+	};
+
+	class SegmentGrid
+	{
+	public:
+		SegmentGrid(const Vector3& origin, float cellSize) :
+			origin_(origin),
+			invCellSize_(1.0f / cellSize)
+		{
+		}
+
+		unsigned CellIndex(float x, float origin) const
+		{
+			float c = (x - origin) * invCellSize_;
+			return c <= 0.0f ? 0 : Min((unsigned)c, MAX_CELLS_PER_AXIS - 1);
+		}
+
+		void CellRange(const Vector3& lo, const Vector3& hi, unsigned* cellLo, unsigned* cellHi) const
+		{
+			cellLo[0] = CellIndex(lo.x_, origin_.x_);
+			cellLo[1] = CellIndex(lo.y_, origin_.y_);
+			cellLo[2] = CellIndex(lo.z_, origin_.z_);
+			cellHi[0] = CellIndex(hi.x_, origin_.x_);
+			cellHi[1] = CellIndex(hi.y_, origin_.y_);
+			cellHi[2] = CellIndex(hi.z_, origin_.z_);
+		}
+
+		static unsigned long long Key(unsigned x, unsigned y, unsigned z)
+		{
+			return ((unsigned long long)x << 42) | ((unsigned long long)y << 21) | (unsigned long long)z;
+		}
+
+		unsigned long long Key(const Vector3& p) const
+		{
+			return Key(CellIndex(p.x_, origin_.x_), CellIndex(p.y_, origin_.y_), CellIndex(p.z_, origin_.z_));
+		}
+
+		// Keys of the cells within radius of segment [a, b], sorted and unique.
+		// The segment is walked cell by cell (Amanatides and Woo) and each piece adds the cells its bounds grown by radius overlap,
+		// so a long diagonal segment covers a band of cells instead of its whole bounding box.
+		void SegmentCells(const Vector3& a, const Vector3& b, float radius, std::vector<unsigned long long>& keys) const
+		{
+			keys.clear();
+
+			// a little slack so that points at exactly radius, up to rounding, are still covered
+			Vector3 grow = Vector3::ONE * (radius + 0.001f / invCellSize_);
+			Vector3 d = b - a;
+			float tNext[3], tDelta[3];
+			for (unsigned k = 0; k < 3; ++k) {
+				float u = (a.Data()[k] - origin_.Data()[k]) * invCellSize_;
+				float du = d.Data()[k] * invCellSize_;
+				if (du > 0.0f) {
+					tNext[k] = (floorf(u) + 1.0f - u) / du;
+					tDelta[k] = 1.0f / du;
+				}
+				else if (du < 0.0f) {
+					tNext[k] = (floorf(u) - u) / du;
+					tDelta[k] = -1.0f / du;
+				}
+				else {
+					tNext[k] = M_INFINITY;
+					tDelta[k] = M_INFINITY;
+				}
+			}
+
+			float t0 = 0.0f;
+			for (;;) {
+				unsigned k = tNext[0] < tNext[1] ? (tNext[0] < tNext[2] ? 0 : 2) : (tNext[1] < tNext[2] ? 1 : 2);
+				float t1 = Min(tNext[k], 1.0f);
+				Vector3 p0 = a + d * t0;
+				Vector3 p1 = a + d * t1;
+
+				unsigned cellLo[3], cellHi[3];
+				CellRange(VectorMin(p0, p1) - grow, VectorMax(p0, p1) + grow, cellLo, cellHi);
+				for (unsigned x = cellLo[0]; x <= cellHi[0]; ++x) {
+					for (unsigned y = cellLo[1]; y <= cellHi[1]; ++y) {
+						for (unsigned z = cellLo[2]; z <= cellHi[2]; ++z) {
+							keys.push_back(Key(x, y, z));
+						}
+					}
+				}
+
+				if (t1 >= 1.0f) {
+					break;
+				}
+				t0 = t1;
+				tNext[k] += tDelta[k];
+			}
+
+			std::sort(keys.begin(), keys.end());
+			keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+		}
+
+	private:
+		Vector3 origin_;
+		float invCellSize_;
+	};
+
+	// Closest points of segments [p1, q1] and [p2, q2], after Ericson, Real-Time Collision Detection, 5.1.9.
+	// Returns the squared distance; s and t are the parameters along each segment.
+	float SegmentSegmentClosest(
+		const Vector3& p1,
+		const Vector3& q1,
+		const Vector3& p2,
+		const Vector3& q2,
+		float& s,
+		float& t
+	)
+	{
+		// relative to p1, to keep float precision with large coordinates
+		Vector3 d1 = q1 - p1;
+		Vector3 d2 = q2 - p2;
+		Vector3 r = p1 - p2;
+		float a = d1.DotProduct(d1);
+		float e = d2.DotProduct(d2);
+		float f = d2.DotProduct(r);
+
+		const float EPS = 1e-20f;
+		if (a <= EPS && e <= EPS) {
+			s = t = 0.0f;
+		}
+		else if (a <= EPS) {
+			s = 0.0f;
+			t = Clamp(f / e, 0.0f, 1.0f);
+		}
+		else {
+			float c = d1.DotProduct(r);
+			if (e <= EPS) {
+				t = 0.0f;
+				s = Clamp(-c / a, 0.0f, 1.0f);
+			}
+			else {
+				float b = d1.DotProduct(d2);
+				float denom = a * e - b * b;
+				// parallel segments get any closest pair, here the one at s = 0
+				s = denom > EPS * a * e ? Clamp((b * f - c * e) / denom, 0.0f, 1.0f) : 0.0f;
+				t = (b * s + f) / e;
+				if (t < 0.0f) {
+					t = 0.0f;
+					s = Clamp(-c / a, 0.0f, 1.0f);
+				}
+				else if (t > 1.0f) {
+					t = 1.0f;
+					s = Clamp((b - c) / a, 0.0f, 1.0f);
+				}
+			}
+		}
+
+		return (d1 * s - d2 * t + r).LengthSquared();
+	}
+
+	// parameters within tolerance of a vertex snap to it
+	float SnapParam(float s, float segLength, float tolerance)
+	{
+		if (s * segLength <= tolerance) {
+			return 0.0f;
+		}
+		if ((1.0f - s) * segLength <= tolerance) {
+			return 1.0f;
+		}
+		return s;
+	}
+
+	bool ReadCurves(const VariantVector& polylines, const Matrix3x4* plane, Vector<CurveData>& curves)
+	{
+		Matrix3x4 inverse = plane ? plane->Inverse() : Matrix3x4::IDENTITY;
+
+		curves.Resize(polylines.Size());
+		bool any = false;
+		for (unsigned i = 0; i < polylines.Size(); ++i) {
+			CurveData& curve = curves[i];
+			if (!Polyline_Verify(polylines[i])) {
+				continue;
+			}
+			VariantVector verts = Polyline_ComputeSequentialVertexList(polylines[i]);
+			if (verts.Size() < 2) {
+				continue;
+			}
+
+			curve.closed_ = Polyline_IsClosed(polylines[i]);
+			curve.points_.Resize(verts.Size());
+			curve.worldPoints_.Resize(verts.Size());
+			curve.lengths_.Resize(verts.Size());
+			float length = 0.0f;
+			for (unsigned j = 0; j < verts.Size(); ++j) {
+				Vector3 p = verts[j].GetVector3();
+				if (j > 0) {
+					length += (p - curve.worldPoints_[j - 1]).Length();
+				}
+				curve.worldPoints_[j] = p;
+				curve.lengths_[j] = length;
+				if (plane) {
+					Vector3 local = inverse * p;
+					curve.points_[j] = Vector3(local.x_, 0.0f, local.z_);
+				}
+				else {
+					curve.points_[j] = p;
+				}
+			}
+			any = true;
+		}
+
+		return any;
+	}
+
+	void FindHits(const Vector<CurveData>& curves, float tolerance, bool selfIntersections, std::vector<CurveHit>& hits)
+	{
+		std::vector<GridSegment> segments;
+		for (unsigned i = 0; i < curves.Size(); ++i) {
+			for (unsigned j = 0; j + 1 < curves[i].points_.Size(); ++j) {
+				const Vector3& a = curves[i].points_[j];
+				const Vector3& b = curves[i].points_[j + 1];
+				GridSegment seg;
+				seg.curve_ = i;
+				seg.segment_ = j;
+				seg.min_ = VectorMin(a, b) - Vector3::ONE * (0.5f * tolerance);
+				seg.max_ = VectorMax(a, b) + Vector3::ONE * (0.5f * tolerance);
+				segments.push_back(seg);
+			}
+		}
+		if (segments.size() < 2) {
+			return;
+		}
+
+		// cells about the size of an average segment
+		Vector3 lo = segments[0].min_;
+		Vector3 hi = segments[0].max_;
+		double sumExtent = 0.0;
+		for (unsigned i = 0; i < segments.size(); ++i) {
+			lo = VectorMin(lo, segments[i].min_);
+			hi = VectorMax(hi, segments[i].max_);
+			Vector3 extent = segments[i].max_ - segments[i].min_;
+			sumExtent += Max(extent.x_, Max(extent.y_, extent.z_));
+		}
+		Vector3 size = hi - lo;
+		float cellSize = (float)(sumExtent / segments.size());
+		cellSize = Max(cellSize, Max(size.x_, Max(size.y_, size.z_)) / (float)MAX_CELLS_PER_AXIS);
+		if (!(cellSize > 0.0f)) {
+			cellSize = 1.0f;
+		}
+		SegmentGrid grid(lo, cellSize);
+
+		std::vector<CellEntry> entries;
+		entries.reserve(2 * segments.size());
+		std::vector<unsigned long long> keys;
+		for (unsigned i = 0; i < segments.size(); ++i) {
+			const CurveData& curve = curves[segments[i].curve_];
+			grid.SegmentCells(curve.points_[segments[i].segment_], curve.points_[segments[i].segment_ + 1], 0.5f * tolerance, keys);
+			for (unsigned k = 0; k < keys.size(); ++k) {
+				CellEntry entry;
+				entry.key_ = keys[k];
+				entry.segment_ = i;
+				entries.push_back(entry);
+			}
+		}
+		std::sort(entries.begin(), entries.end());
+
+		// cells holding at least two segments
+		std::vector<unsigned> cellStarts;
+		for (unsigned i = 0; i < entries.size();) {
+			unsigned j = i + 1;
+			while (j < entries.size() && entries[j].key_ == entries[i].key_) {
+				++j;
+			}
+			if (j - i > 1) {
+				cellStarts.push_back(i);
+			}
+			i = j;
+		}
+
+		float tolSquared = tolerance * tolerance;
+		std::vector<std::vector<CurveHit> > cellHits(cellStarts.size());
+		auto testCell = [&](int c) {
+			unsigned begin = cellStarts[c];
+			unsigned long long key = entries[begin].key_;
+			unsigned end = begin;
+			while (end < entries.size() && entries[end].key_ == key) {
+				++end;
+			}
+
+			for (unsigned i = begin; i < end; ++i) {
+				const GridSegment& segA = segments[entries[i].segment_];
+				const CurveData& curveA = curves[segA.curve_];
+				for (unsigned j = i + 1; j < end; ++j) {
+					const GridSegment& segB = segments[entries[j].segment_];
+					if (segA.max_.x_ < segB.min_.x_ || segB.max_.x_ < segA.min_.x_ ||
+						segA.max_.y_ < segB.min_.y_ || segB.max_.y_ < segA.min_.y_ ||
+						segA.max_.z_ < segB.min_.z_ || segB.max_.z_ < segA.min_.z_) {
+						continue;
+					}
+					if (segA.curve_ == segB.curve_) {
+						if (!selfIntersections) {
+							continue;
+						}
+						int gap = Abs(segA.segment_ - segB.segment_);
+						if (gap <= 1 || (curveA.closed_ && gap == (int)curveA.GetNumSegments() - 1)) {
+							continue;
+						}
+					}
+
+					const CurveData& curveB = curves[segB.curve_];
+					const Vector3& p1 = curveA.points_[segA.segment_];
+					const Vector3& q1 = curveA.points_[segA.segment_ + 1];
+					const Vector3& p2 = curveB.points_[segB.segment_];
+					const Vector3& q2 = curveB.points_[segB.segment_ + 1];
+					float s, t;
+					if (SegmentSegmentClosest(p1, q1, p2, q2, s, t) > tolSquared) {
+						continue;
+					}
+					// a pair sharing several cells is reported only by the cell of the midpoint of its closest points,
+					// which is within half the tolerance of both segments and so among the cells of both
+					Vector3 midpoint = 0.5f * (p1 + (q1 - p1) * s + p2 + (q2 - p2) * t);
+					if (grid.Key(midpoint) != key) {
+						continue;
+					}
+					s = SnapParam(s, (q1 - p1).Length(), tolerance);
+					t = SnapParam(t, (q2 - p2).Length(), tolerance);
+
+					CurveHit hit;
+					hit.curveA_ = segA.curve_;
+					hit.posA_ = MakePosition(curveA, segA.segment_, s);
+					hit.curveB_ = segB.curve_;
+					hit.posB_ = MakePosition(curveB, segB.segment_, t);
+					if (hit.curveB_ < hit.curveA_ || (hit.curveB_ == hit.curveA_ && hit.posB_ < hit.posA_)) {
+						std::swap(hit.curveA_, hit.curveB_);
+						std::swap(hit.posA_, hit.posB_);
+					}
+					hit.point_ = PointAt(curves[hit.curveA_].worldPoints_, hit.posA_);
+					cellHits[c].push_back(hit);
+				}
+			}
+		};
+		igl::parallel_for((int)cellStarts.size(), testCell, MIN_PARALLEL_CELLS);
+
+		for (unsigned c = 0; c < cellHits.size(); ++c) {
+			hits.insert(hits.end(), cellHits[c].begin(), cellHits[c].end());
+		}
+
+		// segments meeting at a shared vertex all report it
+		std::sort(hits.begin(), hits.end());
+		hits.erase(std::unique(hits.begin(), hits.end()), hits.end());
+	}
+
+	float CurveParam(const CurveData& curve, const CurvePosition& pos)
+	{
+		float total = curve.lengths_.Back();
+		if (total <= 0.0f) {
+			return 0.0f;
+		}
+		float start = curve.lengths_[pos.segment_];
+		float end = curve.lengths_[pos.segment_ + 1];
+		return (start + pos.s_ * (end - start)) / total;
+	}
+
+	Variant MakePiece(const CurveData& curve, const CurvePosition& from, const CurvePosition& to, bool wrap)
+	{
+		const PODVector<Vector3>& points = curve.worldPoints_;
+		int numSegments = (int)curve.GetNumSegments();
+
+		Vector<Vector3> vertexList;
+		vertexList.Push(PointAt(points, from));
+		int last = to.s_ > 0.0f ? to.segment_ : to.segment_ - 1;
+		if (wrap) {
+			last += numSegments;
+		}
+		for (int k = from.segment_ + 1; k <= last; ++k) {
+			vertexList.Push(points[k % numSegments]);
+		}
+		vertexList.Push(PointAt(points, to));
+
+		return Polyline_Make(vertexList);
+	}
+
+} // namespace
+
+void Geomlib::PolylineIntersections(
+	const Urho3D::VariantVector& polylines,
+	float tolerance,
+	const Urho3D::Matrix3x4* plane,
+	bool selfIntersections,
+	Urho3D::PODVector<PolylineIntersection>& intersections
+)
+{
+	intersections.Clear();
+
+	Vector<CurveData> curves;
+	if (!ReadCurves(polylines, plane, curves)) {
+		return;
+	}
+
+	std::vector<CurveHit> hits;
+	FindHits(curves, Max(tolerance, 0.0f), selfIntersections, hits);
+
+	intersections.Resize(hits.size());
+	for (unsigned i = 0; i < hits.size(); ++i) {
+		const CurveHit& hit = hits[i];
+		PolylineIntersection& x = intersections[i];
+		x.curveA_ = hit.curveA_;
+		x.segmentA_ = hit.posA_.segment_;
+		x.segmentParamA_ = hit.posA_.s_;
+		x.curveParamA_ = CurveParam(curves[hit.curveA_], hit.posA_);
+		x.curveB_ = hit.curveB_;
+		x.segmentB_ = hit.posB_.segment_;
+		x.segmentParamB_ = hit.posB_.s_;
+		x.curveParamB_ = CurveParam(curves[hit.curveB_], hit.posB_);
+		x.point_ = hit.point_;
+	}
+}
+
+void Geomlib::PolylineSplitAtIntersections(
+	const Urho3D::VariantVector& polylines,
+	const Urho3D::PODVector<PolylineIntersection>& intersections,
+	Urho3D::VariantVector& piecesOut,
+	Urho3D::PODVector<int>& sourcesOut
+)
+{
+	piecesOut.Clear();
+	sourcesOut.Clear();
+
+	Vector<CurveData> curves;
+	ReadCurves(polylines, 0, curves);
+
+	Vector<PODVector<CurvePosition> > cuts(curves.Size());
+	for (unsigned i = 0; i < intersections.Size(); ++i) {
+		const PolylineIntersection& x = intersections[i];
+		if (x.curveA_ >= 0 && x.curveA_ < (int)curves.Size() && x.segmentA_ < (int)curves[x.curveA_].GetNumSegments()) {
+			cuts[x.curveA_].Push(MakePosition(curves[x.curveA_], x.segmentA_, x.segmentParamA_));
+		}
+		if (x.curveB_ >= 0 && x.curveB_ < (int)curves.Size() && x.segmentB_ < (int)curves[x.curveB_].GetNumSegments()) {
+			cuts[x.curveB_].Push(MakePosition(curves[x.curveB_], x.segmentB_, x.segmentParamB_));
+		}
+	}
+
+	for (unsigned i = 0; i < curves.Size(); ++i) {
+		const CurveData& curve = curves[i];
+		if (curve.points_.Size() < 2) {
+			continue;
+		}
+
+		PODVector<CurvePosition>& curveCuts = cuts[i];
+		std::sort(curveCuts.Begin(), curveCuts.End());
+		curveCuts.Resize((unsigned)(std::unique(curveCuts.Begin(), curveCuts.End()) - curveCuts.Begin()));
+
+		if (!curve.closed_) {
+			// the ends are not cuts
+			CurvePosition start = MakePosition(curve, 0, 0.0f);
+			CurvePosition end = MakePosition(curve, curve.GetNumSegments() - 1, 1.0f);
+			if (!curveCuts.Empty() && curveCuts.Front() == start) {
+				curveCuts.Erase(0);
+			}
+			if (!curveCuts.Empty() && curveCuts.Back() == end) {
+				curveCuts.Pop();
+			}
+			curveCuts.Insert(0, start);
+			curveCuts.Push(end);
+		}
+
+		if (curveCuts.Size() < 2 && !(curve.closed_ && curveCuts.Size() == 1)) {
+			piecesOut.Push(polylines[i]);
+			sourcesOut.Push(i);
+			continue;
+		}
+
+		unsigned numPieces = curve.closed_ ? curveCuts.Size() : curveCuts.Size() - 1;
+		for (unsigned j = 0; j < numPieces; ++j) {
+			bool wrap = j + 1 == curveCuts.Size();
+			const CurvePosition& to = wrap ? curveCuts[0] : curveCuts[j + 1];
+			piecesOut.Push(MakePiece(curve, curveCuts[j], to, wrap));
+			sourcesOut.Push(i);
+		}
+	}
+}
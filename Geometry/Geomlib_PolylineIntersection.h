@@ -22,46 +22,58 @@
 
 #pragma once
 
-#include <Urho3D/Core/Variant.h>
 #include <Urho3D/Container/Vector.h>
+#include <Urho3D/Core/Variant.h>
+#include <Urho3D/Math/Matrix3x4.h>
+#include <Urho3D/Math/Vector3.h>
 
 namespace Geomlib {
 
-	//// From Mesh Repair:
-
-	//// [t1, t2] interval of real number line; no promise that t1 <= t2
-	//// [s1, s2] interval of real number line; no promise that s1 <= s2
-	//// Returns:
-	////   1 if [t1, t2] and [s1, s2] have non-empty intersection
-	////   0 otherwise
-	//int IntervalIntervalIntersection(
-	//	double t1,
-	//	double t2,
-	//	double s1,
-	//	double s2);
-
-	//// returns	1 for intersection (including intersection at endpoints)
-	////			0 for no intersection
-	//int SegmentSegmentIntersection2D(
-	//	const Eigen::RowVector2d& A,
-	//	const Eigen::RowVector2d& B,
-	//	const Eigen::RowVector2d& C,
-	//	const Eigen::RowVector2d& D);
-
-	//// returns	1 for intersection (including intersection at endpoints)
-	////			0 for no intersection
-	//int SegmentSegmentIntersection3D(
-	//	const Eigen::RowVector3d& A,
-	//	const Eigen::RowVector3d& B,
-	//	const Eigen::RowVector3d& C,
-	//	const Eigen::RowVector3d& D,
-	//	NgonPlane facePlane);
-
+	// One crossing of two polyline segments. Segment i of a polyline is [i, i + 1] of its sequential vertices;
+	// segmentParam is 0 <= s <= 1 along the segment, curveParam the normalized arc length 0 <= t <= 1 along the
+	// whole polyline, as used by PolylinePointFromParameter. curveA <= curveB, and for a self crossing the
+	// A side comes first along the polyline.
+	struct PolylineIntersection
+	{
+		int curveA_;
+		int segmentA_;
+		float segmentParamA_;
+		float curveParamA_;
+		int curveB_;
+		int segmentB_;
+		float segmentParamB_;
+		float curveParamB_;
+		// point on polyline A
+		Urho3D::Vector3 point_;
+	};
 
+	// Finds all crossings among the segments of polylines, binning the segments in a uniform grid so that only
+	// segments sharing a cell are tested against each other.
+	//
+	// Segments cross where they come within tolerance of each other, and parameters within tolerance of a vertex
+	// snap to it, so a street ending on another one counts as a crossing. Segments that share a vertex along the
+	// same polyline are never tested; other pairs within a polyline only if selfIntersections is set.
+	// Collinear overlaps report a single point.
+	//
+	// With plane, segments are projected to its XZ plane and cross where their projections do (e.g. streets,
+	// whatever their height); without, they are tested in 3D.
+	// Crossings come out sorted by curveA, curveParamA, curveB, curveParamB; each is reported once.
+	void PolylineIntersections(
+		const Urho3D::VariantVector& polylines,
+		float tolerance,
+		const Urho3D::Matrix3x4* plane,
+		bool selfIntersections,
+		Urho3D::PODVector<PolylineIntersection>& intersections
+	);
 
-	//// Computes the list of edges to check in IsFacePolySelfIntersecting, N = # of edges
-	//// Note for edge 0, we only check it with edges 2, 3, 4, ..., N-2
-	//// And we only check pairs of the form (A, B) where B>A (removes duplicate checks)
-	//std::vector<std::vector<int>> GetEdgesToIntersect(int N);
+	// Splits each polyline at its crossings, as returned by PolylineIntersections for the same list.
+	// A closed polyline with k crossings gives k pieces, an open one k + 1 (crossings at its ends do not split it).
+	// sourcesOut gives the index of the polyline each piece came from.
+	void PolylineSplitAtIntersections(
+		const Urho3D::VariantVector& polylines,
+		const Urho3D::PODVector<PolylineIntersection>& intersections,
+		Urho3D::VariantVector& piecesOut,
+		Urho3D::PODVector<int>& sourcesOut
+	);
 
-}
\ No newline at end of file
+}
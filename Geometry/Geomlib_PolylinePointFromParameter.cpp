@@ -22,6 +22,7 @@
 
 #include "Geomlib_PolylinePointFromParameter.h"
 
+#include "Geomlib_PolylineEvaluator.h"
 #include "Polyline.h"
 
 // Inputs:
@@ -37,186 +38,38 @@ bool Geomlib::PolylinePointFromParameter(
 	Urho3D::Vector3& point
 )
 {
-	using Urho3D::VariantVector;
-	using Urho3D::Vector3;
-
 	//////////////////////////////////
 	// Extract and validate input data
 	//////////////////////////////////
 
-	if (!Polyline_Verify(polyline)) {
-		return false;
-	}
 	if (t < 0.0f || t > 1.0f) {
 		return false;
 	}
 
-	const VariantVector vertexList = Polyline_ComputeSequentialVertexList(polyline);
-	if (vertexList.Size() == 0) {
+	// the evaluator checks the polyline, and is shared with every other query on it
+	std::shared_ptr<const PolylineEvaluator> evaluator = PolylineEvaluator::Get(polyline);
+	if (!evaluator) {
 		return false;
 	}
-	else if (vertexList.Size() == 1) {
-		// degenerate 1-point polyline
-		point = vertexList[0].GetVector3();
-		return true;
-	}
-
-	////////////////////////////////////////////////////////
-	// Vertex count is >= 2, proper computation begins here.
-	////////////////////////////////////////////////////////
-
-	float totalLength = 0.0f;
-	// loop over each edge [i, i + 1]
-	for (unsigned i = 0; i < vertexList.Size() - 1; ++i) {
-		Vector3 seg = vertexList[i + 1].GetVector3() - vertexList[i].GetVector3();
-		totalLength += seg.Length();
-	}
-
-	if (Urho3D::Equals(totalLength, 0.0f)) {
-		// All points in polyline are identical, or, more likely,
-		// the Variants do not store Vector3's and so return the origin for GetVector3().
-		point = vertexList[0].GetVector3();
-		return true;
-	}
-
-	float targetDistance = t * totalLength;
-
-	// loop over each edge [i, i + 1]
-	float startLength = 0.0f;
-	for (unsigned i = 0; i < vertexList.Size() - 1; ++i) {
-		Vector3 start = vertexList[i].GetVector3();
-		Vector3 end = vertexList[i + 1].GetVector3();
-		Vector3 seg = end - start;
-		float segLength = seg.Length();
-		float endLength = startLength + segLength;
-
-		// If point lies on this segment....
-		if (endLength >= targetDistance) {
-			if (Urho3D::Equals(segLength, 0.0f)) {
-				point = start; // or end, since in this case start == end
-				return true;
-			}
-			float s = (targetDistance - startLength) / segLength;
-			point = start + s * seg;
-			return true;
-		}
-
-		// Point lies on a later segment. Update and carry on.
-		startLength = endLength;
-	}
 
-	// If computation logic is correct, we should never arrive here.
-	return false;
+	// a degenerate 1-point polyline, or one whose points are all identical, gives its first point
+	point = evaluator->PointAt(t);
+	return true;
 }
 
 bool Geomlib::PolylineTransformFromParameter(const Urho3D::Variant & polyline, float t, Urho3D::Matrix3x4 & transform)
 {
-	using Urho3D::VariantVector;
-	using Urho3D::Vector3;
-
-	// the components making up the transform
-	Urho3D::Vector3 position;
-	Urho3D::Vector3 tangent;
-	Urho3D::Vector3 normal;
-	Urho3D::Vector3 x_axis;
-
-
-	//////////////////////////////////
-	// Extract and validate input data
-	//////////////////////////////////
-
-	if (!Polyline_Verify(polyline)) {
-		return false;
-	}
 	if (t < 0.0f || t > 1.0f) {
 		return false;
 	}
 
-	const VariantVector vertexList = Polyline_ComputeSequentialVertexList(polyline);
-	if (vertexList.Size() == 0) {
-		return false;
-	}
-	else if (vertexList.Size() == 1) {
-		// degenerate 1-point polyline, no transform defined
-		return false;
-	}
-
-
-	bool isClosed = Polyline_IsClosed(polyline);
-
-	float totalLength = 0.0f;
-	// loop over each edge [i, i + 1]
-	for (unsigned i = 0; i < vertexList.Size() - 1; ++i) {
-		Vector3 seg = vertexList[i + 1].GetVector3() - vertexList[i].GetVector3();
-		totalLength += seg.Length();
-	}
-
-	if (Urho3D::Equals(totalLength, 0.0f)) {
-		// All points in polyline are identical, or, more likely,
-		// the Variants do not store Vector3's and so return false.
+	std::shared_ptr<const PolylineEvaluator> evaluator = PolylineEvaluator::Get(polyline);
+	if (!evaluator) {
 		return false;
 	}
 
-	float targetDistance = t * totalLength;
-
-	// loop over each edge [i, i + 1]
-	float startLength = 0.0f;
-	for (unsigned i = 0; i < vertexList.Size() - 1; ++i) {
-		Vector3 start = vertexList[i].GetVector3();
-		Vector3 end = vertexList[i + 1].GetVector3();
-		Vector3 seg = end - start;
-		float segLength = seg.Length();
-		float endLength = startLength + segLength;
-
-		// If point lies on this segment....
-		if (endLength >= targetDistance) {
-			//if (Urho3D::Equals(segLength, 0.0f)) {
-			//	point = start; // or end, since in this case start == end
-			//	return true;
-			//}
-			// Here is the actual transform computation
-			float s = (targetDistance - startLength) / segLength;
-			position = start + s * seg;
-
-			// if it is just a line, use the "Look at" idea
-			if (vertexList.Size() == 2) {
-				Vector3 targetPt = vertexList[1].GetVector3();
-				Vector3 startPt = vertexList[0].GetVector3();
-				Vector3 up = Vector3::UP;
-				Urho3D::Quaternion rot;
-				rot.FromLookRotation(targetPt - startPt, up);
-				Urho3D::Matrix3x4 xform(position, rot, Vector3::ONE);
-				transform = xform;
-			}
-			else {
-				GetVertexNormal(polyline, normal, i);
-			}
-
-			tangent = seg.Normalized();
-			x_axis = normal.CrossProduct(tangent);
-
-			
-			Urho3D::Quaternion rot;
-			rot.FromLookRotation(tangent, normal);
-			//Urho3D::Quaternion quat(tangent, normal, x_axis);
-			//Urho3D::Matrix3 rotation = quat.RotationMatrix();
-
-			//Urho3D::Matrix3x4 xform(position, rot, Vector3::ONE);
-			//transform = xform;
-			transform.SetRotation(rot.RotationMatrix());
-			transform.SetTranslation(position);
-			//transform.SetScale(1.0f);
-
-			return true;
-		}
-
-		// Point lies on a later segment. Update and carry on.
-		startLength = endLength;
-	}
-
-	// If computation logic is correct, we should never arrive here.
-	return false;
-
+	// fails on degenerate polylines, where no transform is defined
+	return evaluator->FrameAt(t, transform);
 }
 
 bool Geomlib::GetVertexNormal(const Urho3D::Variant & polyline, Urho3D::Vector3& normal, int vert_id)
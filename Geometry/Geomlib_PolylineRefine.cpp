@@ -25,7 +25,7 @@
 #include <algorithm>
 #include <vector>
 
-#include "Geomlib_PolylinePointFromParameter.h"
+#include "Geomlib_PolylineEvaluator.h"
 #include "Polyline.h"
 
 namespace { // woot got visual studio to stop indenting namespaces!
@@ -176,13 +176,23 @@ bool Geomlib::PolylineRefine(
 		}
 	}
 
-	// clean_vals is ready
-	VariantVector newVertexList;
+	// clean_vals is ready, and ascending, so one walk along the polyline evaluates them all
+	std::shared_ptr<const PolylineEvaluator> evaluator = PolylineEvaluator::Get(polylineIn);
+	if (!evaluator) {
+		polylineOut = Variant();
+		return false;
+	}
+
+	Urho3D::PODVector<float> params(clean_vals.Size());
 	for (unsigned i = 0; i < clean_vals.Size(); ++i) {
-		float par = clean_vals[i];
-		Vector3 pt;
-		PolylinePointFromParameter(polylineIn, par, pt);
-		newVertexList.Push(Variant(pt));
+		params[i] = clean_vals[i];
+	}
+	Urho3D::PODVector<Vector3> points;
+	evaluator->Evaluate(params, &points);
+
+	VariantVector newVertexList(points.Size());
+	for (unsigned i = 0; i < points.Size(); ++i) {
+		newVertexList[i] = Variant(points[i]);
 	}
 
 	//VariantMap outMap;
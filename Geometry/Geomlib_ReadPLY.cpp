@@ -21,16 +21,7 @@
 
 #include "Geomlib_ReadPLY.h"
 
-#include <iostream>
-#include <vector>
-
-#include <Eigen/Core>
-
-#include <igl/readPLY.h>
-#include <igl/list_to_matrix.h>
-
-#include "ConversionUtilities.h"
-#include "TriMesh.h"
+#include "Geomlib_MeshImport.h"
 
 using namespace Urho3D;
 
@@ -40,25 +31,18 @@ bool Geomlib::ReadPLY(
 	bool yup
 )
 {
-	Eigen::MatrixXf V;
-	Eigen::MatrixXi F;
-	bool read_success = igl::readPLY(ply_filename.CString(), V, F);
-	if (!read_success) {
+	std::vector<char> data;
+	if (!ReadMeshFileData(ply_filename, data)) {
 		return false;
 	}
 
-	if (yup) {
-		Eigen::MatrixXf W = V;
-		W.col(1) = V.col(2);
-		W.col(2) = -1 * V.col(1);
-		V = W;
-	}
-
-	tri_mesh = TriMesh_Make(V, F);
-	if (!TriMesh_Verify(tri_mesh)) {
+	PODVector<float> positions;
+	PODVector<int> indices;
+	if (!ParsePLY(data.empty() ? "" : &data[0], data.size(), positions, indices)) {
 		return false;
 	}
-	return true;
+
+	return MakeImportedTriMesh(positions, indices, yup, tri_mesh);
 }
 
 bool Geomlib::ReadPLY(
@@ -67,39 +51,16 @@ bool Geomlib::ReadPLY(
 	bool yup
 )
 {
-	std::vector<std::vector<float> > vV;
-	std::vector<std::vector<int> > vF;
-	std::vector<std::vector<float> > vN;
-	std::vector<std::vector<float> > vUV;
-	FILE* ply_file = (FILE*)source->GetHandle();
-	bool read_success = igl::readPLY(ply_file, vV, vF, vN, vUV);
-	if (!read_success) {
+	std::vector<char> data;
+	if (!ReadMeshFileData(source, data)) {
 		return false;
 	}
 
-	Eigen::MatrixXf xV; // xV = matrix V
-	bool V_rect = igl::list_to_matrix(vV, xV);
-	if (!V_rect) {
+	PODVector<float> positions;
+	PODVector<int> indices;
+	if (!ParsePLY(data.empty() ? "" : &data[0], data.size(), positions, indices)) {
 		return false;
 	}
 
-	Eigen::MatrixXi xF; // xF = matrix F
-	bool F_rect = igl::list_to_matrix(vF, xF);
-	if (!F_rect) {
-		return false;
-	}
-
-	if (yup) {
-		Eigen::MatrixXf W = xV;
-		W.col(1) = xV.col(2);
-		W.col(2) = -1 * xV.col(1);
-		xV = W;
-	}
-
-	tri_mesh = TriMesh_Make(xV, xF);
-	if (!TriMesh_Verify(tri_mesh)) {
-		return false;
-	}
-	std::cout << "return true from Geomlib_ReadPLY" << std::endl;
-	return true;
+	return MakeImportedTriMesh(positions, indices, yup, tri_mesh);
 }
@@ -21,7 +21,7 @@
 
 
 #include "Geomlib_RebuildPolyline.h"
-#include "Geomlib_PolylinePointFromParameter.h"
+#include "Geomlib_PolylineEvaluator.h"
 #include "Polyline.h"
 
 using namespace Urho3D;
@@ -37,16 +37,26 @@ Urho3D::Variant Geomlib::RebuildPolyline(
 		return false;
 	}
 
-	bool closed = Polyline_IsClosed(polylineIn);
-	VariantVector newVerts;
+	std::shared_ptr<const PolylineEvaluator> evaluator = PolylineEvaluator::Get(polylineIn);
+	if (!evaluator || numSegments < 1)
+	{
+		return false;
+	}
 
-	//push the first point
-	Vector3 pt;
+	// all parameters ascend, so they are evaluated in one walk along the polyline
+	PODVector<float> params(numSegments + 1);
 	for (int i = 0; i <= numSegments; i++)
 	{
-		float t = (float)i / (float)numSegments;
-		PolylinePointFromParameter(polylineIn, t, pt);
-		newVerts.Push(pt);
+		params[i] = (float)i / (float)numSegments;
+	}
+
+	PODVector<Vector3> points;
+	evaluator->Evaluate(params, &points);
+
+	VariantVector newVerts(points.Size());
+	for (unsigned i = 0; i < points.Size(); i++)
+	{
+		newVerts[i] = points[i];
 	}
 
 	return Polyline_Make(newVerts);
@@ -22,20 +22,187 @@
 
 #include "Geomlib_RemoveDuplicates.h"
 
-#include <algorithm>
-#include <vector>
+#include <math.h>
+
+#include <Urho3D/Container/HashMap.h>
+#include <Urho3D/Math/Vector2.h>
+
+#include <igl/parallel_for.h>
 
 #pragma warning(disable : 4244)
 
+using Urho3D::Equals;
+using Urho3D::HashMap;
+using Urho3D::IntVector2;
+using Urho3D::M_EPSILON;
+using Urho3D::PODVector;
 using Urho3D::Variant;
 using Urho3D::Vector;
 using Urho3D::Vector3;
 
 namespace {
-bool Vector3Equals(const Urho3D::Vector3& lhs, const Urho3D::Vector3& rhs)
+
+// below this many points parallel cell computation is not worth starting threads for
+const unsigned MIN_PARALLEL_POINTS = 10000;
+
+// packs 21 bits of each cell coordinate; wrapped coordinates only add candidates, the distance test stays exact
+unsigned long long CellKey(long long x, long long y, long long z)
 {
-	return Urho3D::Equals(lhs.x_, rhs.x_) && Urho3D::Equals(lhs.y_, rhs.y_) && Urho3D::Equals(lhs.z_, rhs.z_);
+	const unsigned long long mask = (1ull << 21) - 1;
+	return ((unsigned long long)x & mask) |
+		(((unsigned long long)y & mask) << 21) |
+		(((unsigned long long)z & mask) << 42);
 }
+
+long long CellCoordinate(float value, double invCellSize)
+{
+	double cell = floor((double)value * invCellSize);
+	// also catches NaN
+	if (!(cell > -1e15)) {
+		return (long long)-1e15;
+	}
+	if (cell > 1e15) {
+		return (long long)1e15;
+	}
+	return (long long)cell;
+}
+
+void RemoveDuplicatePoints(
+	const PODVector<Vector3>& points,
+	Variant& vertices,
+	Variant& indices
+)
+{
+	PODVector<Vector3> weldedPoints;
+	PODVector<int> weldIndices;
+	Geomlib::WeldPoints(points, 0.0f, Geomlib::WELD_EQUALS, weldedPoints, weldIndices);
+
+	Vector<Variant> newVertexList(weldedPoints.Size());
+	for (unsigned i = 0; i < weldedPoints.Size(); ++i) {
+		newVertexList[i] = weldedPoints[i];
+	}
+	vertices = Variant(newVertexList);
+
+	Vector<Variant> indexList(weldIndices.Size());
+	for (unsigned i = 0; i < weldIndices.Size(); ++i) {
+		indexList[i] = weldIndices[i];
+	}
+	indices = Variant(indexList);
+}
+
+}
+
+void Geomlib::WeldPoints(
+	const PODVector<Vector3>& points,
+	float eps,
+	WeldTest test,
+	PODVector<Vector3>& weldedPoints,
+	PODVector<int>& weldIndices,
+	bool parallel
+)
+{
+	unsigned numPoints = points.Size();
+	weldedPoints.Clear();
+	weldIndices.Resize(numPoints);
+	if (numPoints == 0) {
+		return;
+	}
+
+	// Equals tolerates at most M_EPSILON, so M_EPSILON sized cells are enough for it
+	if (test == WELD_EQUALS) {
+		eps = M_EPSILON;
+	}
+
+	// with eps sized cells every point that can pass the test with p is in one of the 27 cells around p's cell;
+	// exact welding only ever needs p's own cell
+	bool exact = !(eps > 0.0f);
+	double invCellSize = exact ? 1.0 : 1.0 / eps;
+	float epsSquared = eps * eps;
+	int range = exact ? 0 : 1;
+
+	// cells are independent per point, so this part may run on all threads
+	PODVector<long long> cells(3 * numPoints);
+	auto computeCell = [&points, &cells, invCellSize](int i) {
+		cells[3 * i] = CellCoordinate(points[i].x_, invCellSize);
+		cells[3 * i + 1] = CellCoordinate(points[i].y_, invCellSize);
+		cells[3 * i + 2] = CellCoordinate(points[i].z_, invCellSize);
+	};
+	if (parallel) {
+		igl::parallel_for((int)numPoints, computeCell, MIN_PARALLEL_POINTS);
+	}
+	else {
+		for (unsigned i = 0; i < numPoints; ++i) {
+			computeCell((int)i);
+		}
+	}
+
+	// previous points are chained per cell in input order, so the first hit in a cell is the earliest there;
+	// cellChains holds the first and last point of each chain
+	HashMap<unsigned long long, IntVector2> cellChains;
+	PODVector<int> next(numPoints);
+	PODVector<int> weldedTo(numPoints);
+	PODVector<bool> kept(numPoints);
+	for (unsigned i = 0; i < numPoints; ++i) {
+		kept[i] = false;
+	}
+
+	for (unsigned i = 0; i < numPoints; ++i) {
+		const Vector3& p = points[i];
+		const long long* cell = &cells[3 * i];
+
+		int match = -1;
+		for (int dx = -range; dx <= range; ++dx) {
+			for (int dy = -range; dy <= range; ++dy) {
+				for (int dz = -range; dz <= range; ++dz) {
+					HashMap<unsigned long long, IntVector2>::Iterator it = cellChains.Find(CellKey(cell[0] + dx, cell[1] + dy, cell[2] + dz));
+					if (it == cellChains.End()) {
+						continue;
+					}
+					for (int j = it->second_.x_; j >= 0 && (match < 0 || j < match); j = next[j]) {
+						const Vector3& q = points[j];
+						bool same = test == WELD_EQUALS ? Equals(q.x_, p.x_) && Equals(q.y_, p.y_) && Equals(q.z_, p.z_) :
+							exact ? q == p : (q - p).LengthSquared() < epsSquared;
+						if (same) {
+							match = j;
+							break;
+						}
+					}
+				}
+			}
+		}
+
+		weldedTo[i] = match >= 0 ? match : (int)i;
+		kept[weldedTo[i]] = true;
+
+		// an exact copy of its match passes and fails every test just as the match does, but is always found
+		// after it, so it is left out of the chains; this keeps long runs of repeated points cheap
+		if (match >= 0 && points[match] == p) {
+			continue;
+		}
+
+		next[i] = -1;
+		unsigned long long key = CellKey(cell[0], cell[1], cell[2]);
+		HashMap<unsigned long long, IntVector2>::Iterator chain = cellChains.Find(key);
+		if (chain != cellChains.End()) {
+			next[chain->second_.y_] = (int)i;
+			chain->second_.y_ = (int)i;
+		}
+		else {
+			cellChains[key] = IntVector2((int)i, (int)i);
+		}
+	}
+
+	// kept points are numbered in input order
+	PODVector<int> keptIndices(numPoints);
+	for (unsigned i = 0; i < numPoints; ++i) {
+		if (kept[i]) {
+			keptIndices[i] = (int)weldedPoints.Size();
+			weldedPoints.Push(points[i]);
+		}
+	}
+	for (unsigned i = 0; i < numPoints; ++i) {
+		weldIndices[i] = keptIndices[weldedTo[i]];
+	}
 }
 
 // vertexList:
@@ -78,40 +245,12 @@ void Geomlib::RemoveDuplicates(
 	Urho3D::Variant& indices
 )
 {
-	using Urho3D::Variant;
-	using Urho3D::Vector;
-
-	int numVerts = (int)vertexList.Size();
-	std::vector<int> vertexDuplicates_(numVerts);
-
-	for (int i = 0; i < numVerts; ++i) {
-		vertexDuplicates_[i] = i; // Assume not a duplicate
-		for (int j = 0; j < i; ++j) {
-			if (Vector3Equals(vertexList[j].GetVector3(), vertexList[i].GetVector3())) {
-				vertexDuplicates_[i] = j;
-				break;
-			}
-		}
-	}
-
-	std::vector<int> vertexUniques_ = vertexDuplicates_;
-	std::sort(vertexUniques_.begin(), vertexUniques_.end());
-	vertexUniques_.erase(std::unique(vertexUniques_.begin(), vertexUniques_.end()), vertexUniques_.end());
-
-	Vector<Variant> newVertexList;
-	for (int i = 0; i < vertexUniques_.size(); ++i) {
-		int k = vertexUniques_[i];
-		newVertexList.Push(Variant(vertexList[k].GetVector3()));
+	PODVector<Vector3> points(vertexList.Size());
+	for (unsigned i = 0; i < vertexList.Size(); ++i) {
+		points[i] = vertexList[i].GetVector3();
 	}
-	vertices = Variant(newVertexList);
 
-	Vector<Variant> indexList;
-	for (int j = 0; j < numVerts; ++j) {
-		int orig_j = vertexDuplicates_[j];
-		int uniq_j = find(vertexUniques_.begin(), vertexUniques_.end(), orig_j) - vertexUniques_.begin();
-		indexList.Push(Variant(uniq_j));
-	}
-	indices = Variant(indexList);
+	RemoveDuplicatePoints(points, vertices, indices);
 }
 
 void Geomlib::RemoveDuplicates(
@@ -120,35 +259,10 @@ void Geomlib::RemoveDuplicates(
 	Variant& faces
 )
 {
-	int numVerts = (int)vertexListIn.Size();
-	std::vector<int> vertexDuplicates_(numVerts);
-
-	for (int i = 0; i < numVerts; ++i) {
-		vertexDuplicates_[i] = i; // Assume not a duplicate
-		for (int j = 0; j < i; ++j) {
-			if (Vector3Equals(vertexListIn[j], vertexListIn[i])) {
-				vertexDuplicates_[i] = j;
-				break;
-			}
-		}
-	}
-
-	std::vector<int> vertexUniques_ = vertexDuplicates_;
-	std::sort(vertexUniques_.begin(), vertexUniques_.end());
-	vertexUniques_.erase(std::unique(vertexUniques_.begin(), vertexUniques_.end()), vertexUniques_.end());
-
-	Vector<Variant> newVertexList;
-	for (int i = 0; i < vertexUniques_.size(); ++i) {
-		int k = vertexUniques_[i];
-		newVertexList.Push(Variant(vertexListIn[k]));
+	PODVector<Vector3> points(vertexListIn.Size());
+	for (unsigned i = 0; i < vertexListIn.Size(); ++i) {
+		points[i] = vertexListIn[i];
 	}
-	vertices = Variant(newVertexList);
 
-	Vector<Variant> faceList;
-	for (int j = 0; j < numVerts; ++j) {
-		int orig_j = vertexDuplicates_[j];
-		int uniq_j = find(vertexUniques_.begin(), vertexUniques_.end(), orig_j) - vertexUniques_.begin();
-		faceList.Push(Variant(uniq_j));
-	}
-	faces = Variant(faceList);
+	RemoveDuplicatePoints(points, vertices, faces);
 }
\ No newline at end of file
@@ -22,10 +22,46 @@
 
 #pragma once
 
+#include <Urho3D/Container/Vector.h>
 #include <Urho3D/Core/Variant.h>
+#include <Urho3D/Math/MathDefs.h>
+#include <Urho3D/Math/Vector3.h>
 
 namespace Geomlib {
 
+// How WeldPoints compares two points against eps
+enum WeldTest {
+	// closer than eps, (p - q).LengthSquared() < eps * eps; the ShapeOp_Solve weld test
+	WELD_DISTANCE,
+	// Urho3D::Equals holds for every coordinate; the RemoveDuplicates test. eps is not used
+	WELD_EQUALS
+};
+
+// Welds points that pass test against eps, in expected O(n) using a hash grid of eps sized cells.
+// Gives the same result as the quadratic scan it replaces: each point is welded to the earliest previous
+// point it passes the test with, and every point that something was welded to is kept. Since the tests are
+// not transitive, a kept point may itself have been welded to an earlier one.
+// points:
+//   Points to weld.
+// eps:
+//   Weld distance for WELD_DISTANCE. With eps <= 0 only exactly equal points are welded.
+// test:
+//   Distance test, see WeldTest.
+// weldedPoints:
+//   The kept points, in input order.
+// weldIndices:
+//   weldIndices[i] is the index into weldedPoints of the point that points[i] was welded to, or of itself.
+// parallel:
+//   Compute grid cells on all hardware threads, worth it for large inputs.
+void WeldPoints(
+	const Urho3D::PODVector<Urho3D::Vector3>& points,
+	float eps,
+	WeldTest test,
+	Urho3D::PODVector<Urho3D::Vector3>& weldedPoints,
+	Urho3D::PODVector<int>& weldIndices,
+	bool parallel = false
+);
+
 // vertexList:
 //   If object is a triangle mesh, then vertexList is a triangle-by-triangle list
 //   of coordinates of vertices, e.g.,
@@ -60,6 +96,7 @@ namespace Geomlib {
 //       v2 v3
 //       ...
 //   but we don't do this, we just do v0 v1 v2, etc. So beware.
+// Vertices are duplicates when Urho3D::Equals holds for every coordinate, see WeldPoints with WELD_EQUALS.
 void RemoveDuplicates(
 	const Urho3D::Vector<Urho3D::Variant>& vertexList,
 	Urho3D::Variant& vertices,
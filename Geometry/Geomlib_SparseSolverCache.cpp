@@ -0,0 +1,268 @@
+//
+// Copyright (c) 2016 - 2017 Mesh Consultants Inc.
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "Geomlib_SparseSolverCache.h"
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include <Urho3D/Core/Mutex.h>
+
+#pragma warning(push, 0)
+#include <igl/cotmatrix.h>
+#include <igl/invert_diag.h>
+#include <igl/massmatrix.h>
+#pragma warning(pop)
+
+#include "TriMesh.h"
+
+using namespace Urho3D;
+
+namespace {
+
+	// number of factorized harmonic systems kept around
+	const unsigned MAX_CACHED_HARMONIC_SYSTEMS = 4;
+
+	// Q = -L (M^-1 -L)^(k-1) split into free (u) and fixed (b) rows and columns,
+	// minimizing x'Qx with x_b fixed gives Q_uu x_u = -Q_ub x_b
+	struct HarmonicSystem
+	{
+		bool Matches(const TriMeshView& view, const PODVector<int>& b, int k) const
+		{
+			return k_ == k &&
+				b_ == b &&
+				vertices_.Size() == 3 * view.GetNumVertices() &&
+				indices_.Size() == 3 * view.GetNumFaces() &&
+				memcmp(&vertices_[0], view.GetPositions(), vertices_.Size() * sizeof(float)) == 0 &&
+				memcmp(&indices_[0], view.GetIndices(), indices_.Size() * sizeof(int)) == 0;
+		}
+
+		unsigned hash_;
+		int k_;
+		PODVector<int> b_;
+		PODVector<float> vertices_;
+		PODVector<int> indices_;
+
+		// column of each vertex in Q_uu or Q_ub
+		PODVector<int> column_;
+		PODVector<bool> fixed_;
+		Eigen::SparseMatrix<double> Qub_;
+		Geomlib::CachedSparseSolver solver_;
+	};
+
+	unsigned HashHarmonicKey(const TriMeshView& view, const PODVector<int>& b, int k)
+	{
+		unsigned hash = view.GetVertexHash() * 31 + view.GetFaceHash();
+		hash = (unsigned)k + (hash << 6) + (hash << 16) - hash;
+		for (unsigned i = 0; i < b.Size(); ++i) {
+			hash = (unsigned)b[i] + (hash << 6) + (hash << 16) - hash;
+		}
+		return hash;
+	}
+
+	std::shared_ptr<HarmonicSystem> BuildHarmonicSystem(const TriMeshView& view, const PODVector<int>& b, int k)
+	{
+		std::shared_ptr<HarmonicSystem> system = std::make_shared<HarmonicSystem>();
+		unsigned numVertices = view.GetNumVertices();
+
+		system->hash_ = HashHarmonicKey(view, b, k);
+		system->k_ = k;
+		system->b_ = b;
+		system->vertices_.Resize(3 * numVertices);
+		memcpy(&system->vertices_[0], view.GetPositions(), system->vertices_.Size() * sizeof(float));
+		system->indices_.Resize(3 * view.GetNumFaces());
+		memcpy(&system->indices_[0], view.GetIndices(), system->indices_.Size() * sizeof(int));
+
+		Eigen::MatrixXd V = view.GetVertexMap().cast<double>();
+		Eigen::MatrixXi F = view.GetFaceMap();
+
+		Eigen::SparseMatrix<double> L;
+		igl::cotmatrix(V, F, L);
+		Eigen::SparseMatrix<double> Q = -L;
+		if (k > 1) {
+			Eigen::SparseMatrix<double> M;
+			Eigen::SparseMatrix<double> Mi;
+			igl::massmatrix(V, F, igl::MASSMATRIX_TYPE_DEFAULT, M);
+			igl::invert_diag(M, Mi);
+			for (int p = 1; p < k; ++p) {
+				Q = (Q * Mi * -L).eval();
+			}
+		}
+
+		system->fixed_.Resize(numVertices);
+		system->column_.Resize(numVertices);
+		for (unsigned i = 0; i < numVertices; ++i) {
+			system->fixed_[i] = false;
+		}
+		for (unsigned i = 0; i < b.Size(); ++i) {
+			system->fixed_[b[i]] = true;
+		}
+		int numFree = 0;
+		int numFixed = 0;
+		for (unsigned i = 0; i < numVertices; ++i) {
+			system->column_[i] = system->fixed_[i] ? numFixed++ : numFree++;
+		}
+
+		std::vector<Eigen::Triplet<double> > uu;
+		std::vector<Eigen::Triplet<double> > ub;
+		for (int j = 0; j < Q.outerSize(); ++j) {
+			for (Eigen::SparseMatrix<double>::InnerIterator it(Q, j); it; ++it) {
+				int row = (int)it.row();
+				if (system->fixed_[row]) {
+					continue;
+				}
+				if (system->fixed_[j]) {
+					ub.push_back(Eigen::Triplet<double>(system->column_[row], system->column_[j], it.value()));
+				}
+				else {
+					uu.push_back(Eigen::Triplet<double>(system->column_[row], system->column_[j], it.value()));
+				}
+			}
+		}
+
+		Eigen::SparseMatrix<double> Quu(numFree, numFree);
+		Quu.setFromTriplets(uu.begin(), uu.end());
+		system->Qub_.resize(numFree, numFixed);
+		system->Qub_.setFromTriplets(ub.begin(), ub.end());
+
+		if (!system->solver_.Factorize(Quu, system->hash_, system->hash_)) {
+			return std::shared_ptr<HarmonicSystem>();
+		}
+		return system;
+	}
+
+	Mutex harmonicCacheMutex;
+	Vector<std::shared_ptr<const HarmonicSystem> > harmonicCache;
+
+} // namespace
+
+Geomlib::CachedSparseSolver::CachedSparseSolver() :
+	analyzed_(false),
+	factorized_(false),
+	patternKey_(0),
+	valueKey_(0)
+{
+}
+
+bool Geomlib::CachedSparseSolver::Factorize(const Matrix& A, unsigned patternKey, unsigned valueKey)
+{
+	if (IsFactorized(patternKey, valueKey)) {
+		return true;
+	}
+
+	if (!analyzed_ || patternKey != patternKey_) {
+		solver_.analyzePattern(A);
+		analyzed_ = solver_.info() == Eigen::Success;
+		patternKey_ = patternKey;
+		if (!analyzed_) {
+			factorized_ = false;
+			return false;
+		}
+	}
+
+	solver_.factorize(A);
+	factorized_ = solver_.info() == Eigen::Success;
+	valueKey_ = valueKey;
+	return factorized_;
+}
+
+bool Geomlib::CachedSparseSolver::IsFactorized(unsigned patternKey, unsigned valueKey) const
+{
+	return factorized_ && patternKey == patternKey_ && valueKey == valueKey_;
+}
+
+bool Geomlib::TriMesh_HarmonicDeformation(
+	const Variant& tri_mesh,
+	const PODVector<int>& b,
+	const PODVector<Vector3>& bc,
+	int k,
+	PODVector<Vector3>& displacements
+)
+{
+	displacements.Clear();
+
+	TriMeshView view(tri_mesh);
+	if (!view.IsValid() || b.Empty() || b.Size() != bc.Size() || k < 1) {
+		return false;
+	}
+	for (unsigned i = 0; i < b.Size(); ++i) {
+		if (b[i] < 0 || b[i] >= (int)view.GetNumVertices()) {
+			return false;
+		}
+	}
+
+	std::shared_ptr<const HarmonicSystem> system;
+	{
+		unsigned hash = HashHarmonicKey(view, b, k);
+
+		MutexLock lock(harmonicCacheMutex);
+		for (unsigned i = 0; i < harmonicCache.Size(); ++i) {
+			const std::shared_ptr<const HarmonicSystem>& cached = harmonicCache[i];
+			if (cached->hash_ == hash && cached->Matches(view, b, k)) {
+				// most recently used goes to the front
+				system = cached;
+				harmonicCache.Erase(i);
+				harmonicCache.Insert(0, system);
+				break;
+			}
+		}
+	}
+
+	// factorize outside the lock, two threads racing on the same system just build it twice
+	if (!system) {
+		system = BuildHarmonicSystem(view, b, k);
+		if (!system) {
+			return false;
+		}
+
+		MutexLock lock(harmonicCacheMutex);
+		harmonicCache.Insert(0, system);
+		if (harmonicCache.Size() > MAX_CACHED_HARMONIC_SYSTEMS) {
+			harmonicCache.Pop();
+		}
+	}
+
+	// repeated handles keep their last displacement
+	Eigen::MatrixXd fixedValues(system->Qub_.cols(), 3);
+	for (unsigned i = 0; i < b.Size(); ++i) {
+		int column = system->column_[b[i]];
+		fixedValues(column, 0) = bc[i].x_;
+		fixedValues(column, 1) = bc[i].y_;
+		fixedValues(column, 2) = bc[i].z_;
+	}
+
+	Eigen::MatrixXd freeValues;
+	if (system->Qub_.rows() > 0) {
+		freeValues = system->solver_.Solve(-(system->Qub_ * fixedValues));
+	}
+
+	unsigned numVertices = view.GetNumVertices();
+	displacements.Resize(numVertices);
+	for (unsigned i = 0; i < numVertices; ++i) {
+		const Eigen::MatrixXd& values = system->fixed_[i] ? fixedValues : freeValues;
+		int row = system->column_[i];
+		displacements[i] = Vector3((float)values(row, 0), (float)values(row, 1), (float)values(row, 2));
+	}
+
+	return true;
+}
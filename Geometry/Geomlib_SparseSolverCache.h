@@ -0,0 +1,73 @@
+//
+// Copyright (c) 2016 - 2017 Mesh Consultants Inc.
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include <Urho3D/Container/Vector.h>
+#include <Urho3D/Core/Variant.h>
+#include <Urho3D/Math/Vector3.h>
+
+#include <Eigen/Core>
+#include <Eigen/Sparse>
+
+namespace Geomlib {
+
+	// Sparse LDLT solver that keeps its symbolic analysis while the sparsity pattern of the matrix stays
+	// the same, and its numeric factorization while the values do.
+	// The matrix is described by two keys instead of being compared: patternKey must change whenever the
+	// nonzero structure does (mesh topology, set of fixed vertices), valueKey whenever any entry does.
+	class CachedSparseSolver
+	{
+	public:
+		typedef Eigen::SparseMatrix<double> Matrix;
+
+		CachedSparseSolver();
+
+		// Returns false if A could not be factorized
+		bool Factorize(const Matrix& A, unsigned patternKey, unsigned valueKey);
+		bool IsFactorized(unsigned patternKey, unsigned valueKey) const;
+
+		// Back-substitution against the last factorization, one column per right-hand side
+		Eigen::MatrixXd Solve(const Eigen::MatrixXd& rhs) const { return solver_.solve(rhs); }
+
+	private:
+		Eigen::SimplicialLDLT<Matrix> solver_;
+		bool analyzed_;
+		bool factorized_;
+		unsigned patternKey_;
+		unsigned valueKey_;
+	};
+
+	// Deformation field of power k (1 harmonic, 2 biharmonic, ...) that takes the displacements bc at the
+	// vertices b, as igl::harmonic computes it.
+	// The reduced system only depends on the mesh, b and k. Its factorization is cached, so calls that
+	// only change bc, such as dragging handles, cost a back-substitution.
+	// Outputs
+	//   displacements: one per mesh vertex
+	bool TriMesh_HarmonicDeformation(
+		const Urho3D::Variant& tri_mesh,
+		const Urho3D::PODVector<int>& b,
+		const Urho3D::PODVector<Urho3D::Vector3>& bc,
+		int k,
+		Urho3D::PODVector<Urho3D::Vector3>& displacements
+	);
+}
@@ -0,0 +1,214 @@
+//
+// Copyright (c) 2016 - 2017 Mesh Consultants Inc.
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "Geomlib_TriMeshAdjacency.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include <Urho3D/Core/Mutex.h>
+
+#include "TriMesh.h"
+
+using namespace Urho3D;
+
+namespace {
+
+	// number of meshes whose adjacency is kept around
+	const unsigned MAX_CACHED_ADJACENCIES = 8;
+
+	// turns per-row counts stored at offsets[row + 1] into row offsets
+	void AccumulateOffsets(PODVector<unsigned>& offsets)
+	{
+		for (unsigned i = 1; i < offsets.Size(); ++i) {
+			offsets[i] += offsets[i - 1];
+		}
+	}
+
+	Mutex adjacencyCacheMutex;
+	Vector<std::shared_ptr<const Geomlib::TriMeshAdjacency> > adjacencyCache;
+
+} // namespace
+
+Geomlib::TriMeshAdjacency::TriMeshAdjacency(const Variant& mesh) :
+	hash_(0)
+{
+	vertexVertexOffsets_.Push(0);
+
+	TriMeshView view(mesh);
+	if (!view.IsValid()) {
+		return;
+	}
+
+	unsigned numVertices = view.GetNumVertices();
+	unsigned numFaces = view.GetNumFaces();
+	const int* indices = view.GetIndices();
+	for (unsigned i = 0; i < 3 * numFaces; ++i) {
+		if (indices[i] < 0 || indices[i] >= (int)numVertices) {
+			return;
+		}
+	}
+
+	indices_.Resize(3 * numFaces);
+	memcpy(&indices_[0], indices, indices_.Size() * sizeof(int));
+	indexArray_ = view.GetIndexArray();
+	hash_ = view.IsPacked() ? 0 : view.GetFaceHash();
+
+	// vertex-face, faces come out in increasing order
+	vertexFaceOffsets_.Resize(numVertices + 1);
+	for (unsigned i = 0; i <= numVertices; ++i) {
+		vertexFaceOffsets_[i] = 0;
+	}
+	for (unsigned i = 0; i < 3 * numFaces; ++i) {
+		++vertexFaceOffsets_[indices[i] + 1];
+	}
+	AccumulateOffsets(vertexFaceOffsets_);
+	vertexFaces_.Resize(3 * numFaces);
+	{
+		PODVector<unsigned> fill(vertexFaceOffsets_);
+		for (unsigned i = 0; i < 3 * numFaces; ++i) {
+			vertexFaces_[fill[indices[i]]++] = i / 3;
+		}
+	}
+
+	// sorting the face corners by undirected edge puts the faces sharing an edge next to each other
+	std::vector<std::pair<long long, int> > corners(3 * numFaces);
+	for (unsigned c = 0; c < 3 * numFaces; ++c) {
+		long long i = indices[c];
+		long long j = indices[c - c % 3 + (c % 3 + 1) % 3];
+		long long key = i < j ? i * numVertices + j : j * numVertices + i;
+		corners[c] = std::make_pair(key, (int)c);
+	}
+	std::sort(corners.begin(), corners.end());
+
+	// face-face, on non-manifold edges every face links to the first other face on the edge
+	faceFaces_.Resize(3 * numFaces);
+	vertexVertexOffsets_.Resize(numVertices + 1);
+	for (unsigned i = 0; i <= numVertices; ++i) {
+		vertexVertexOffsets_[i] = 0;
+	}
+	PODVector<int> edges;
+	for (unsigned i = 0; i < corners.size(); ) {
+		unsigned j = i + 1;
+		while (j < corners.size() && corners[j].first == corners[i].first) {
+			++j;
+		}
+		for (unsigned k = i; k < j; ++k) {
+			int c = corners[k].second;
+			faceFaces_[c] = j - i > 1 ? corners[k == i ? i + 1 : i].second / 3 : -1;
+		}
+
+		int u = (int)(corners[i].first / numVertices);
+		int v = (int)(corners[i].first % numVertices);
+		if (u != v) {
+			edges.Push(u);
+			edges.Push(v);
+			++vertexVertexOffsets_[u + 1];
+			++vertexVertexOffsets_[v + 1];
+		}
+		i = j;
+	}
+
+	// vertex-vertex from the unique edges
+	AccumulateOffsets(vertexVertexOffsets_);
+	vertexVertices_.Resize(edges.Size());
+	{
+		PODVector<unsigned> fill(vertexVertexOffsets_);
+		for (unsigned i = 0; i < edges.Size(); i += 2) {
+			vertexVertices_[fill[edges[i]]++] = edges[i + 1];
+			vertexVertices_[fill[edges[i + 1]]++] = edges[i];
+		}
+	}
+	for (unsigned v = 0; v < numVertices; ++v) {
+		std::sort(
+			vertexVertices_.Begin() + vertexVertexOffsets_[v],
+			vertexVertices_.Begin() + vertexVertexOffsets_[v + 1]
+		);
+	}
+}
+
+const int* Geomlib::TriMeshAdjacency::GetVertexVertices(int v, unsigned& count) const
+{
+	count = vertexVertexOffsets_[v + 1] - vertexVertexOffsets_[v];
+	return count > 0 ? &vertexVertices_[vertexVertexOffsets_[v]] : NULL;
+}
+
+const int* Geomlib::TriMeshAdjacency::GetVertexFaces(int v, unsigned& count) const
+{
+	count = vertexFaceOffsets_[v + 1] - vertexFaceOffsets_[v];
+	return count > 0 ? &vertexFaces_[vertexFaceOffsets_[v]] : NULL;
+}
+
+bool Geomlib::TriMeshAdjacency::Matches(const int* indices, unsigned numVertices, unsigned numFaces) const
+{
+	return GetNumVertices() == numVertices &&
+		indices_.Size() == 3 * numFaces &&
+		memcmp(&indices_[0], indices, indices_.Size() * sizeof(int)) == 0;
+}
+
+bool Geomlib::TriMeshAdjacency::IsBuiltFrom(const TriMeshView& view) const
+{
+	return view.IsPacked() && indexArray_ == view.GetIndexArray();
+}
+
+std::shared_ptr<const Geomlib::TriMeshAdjacency> Geomlib::TriMeshAdjacency::Get(const Variant& mesh)
+{
+	std::shared_ptr<const TriMeshAdjacency> adjacency;
+	{
+		TriMeshView view(mesh);
+		if (!view.IsValid()) {
+			return adjacency;
+		}
+
+		// packed arrays are matched by identity, only unpacked meshes need hashing
+		unsigned hash = view.IsPacked() ? 0 : view.GetFaceHash();
+
+		MutexLock lock(adjacencyCacheMutex);
+		for (unsigned i = 0; i < adjacencyCache.Size(); ++i) {
+			const std::shared_ptr<const TriMeshAdjacency>& cached = adjacencyCache[i];
+			bool match = view.IsPacked() ? cached->IsBuiltFrom(view) :
+				cached->hash_ == hash && cached->Matches(view.GetIndices(), view.GetNumVertices(), view.GetNumFaces());
+			if (match) {
+				// most recently used goes to the front
+				adjacency = cached;
+				adjacencyCache.Erase(i);
+				adjacencyCache.Insert(0, adjacency);
+				return adjacency;
+			}
+		}
+	}
+
+	// build outside the lock, two threads racing on the same mesh just build it twice
+	adjacency = std::make_shared<TriMeshAdjacency>(mesh);
+	if (!adjacency->IsValid()) {
+		return std::shared_ptr<const TriMeshAdjacency>();
+	}
+
+	MutexLock lock(adjacencyCacheMutex);
+	adjacencyCache.Insert(0, adjacency);
+	if (adjacencyCache.Size() > MAX_CACHED_ADJACENCIES) {
+		adjacencyCache.Pop();
+	}
+	return adjacency;
+}
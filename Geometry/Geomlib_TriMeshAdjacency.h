@@ -0,0 +1,79 @@
+//
+// Copyright (c) 2016 - 2017 Mesh Consultants Inc.
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include <Urho3D/Container/Vector.h>
+#include <Urho3D/Core/Variant.h>
+
+#include <memory>
+
+class TriMeshView;
+
+namespace Geomlib {
+
+	// Vertex-vertex, vertex-face and face-face adjacency of a TriMesh in compressed row arrays.
+	// Build once with TriMeshAdjacency::Get and share it: every neighbourhood is a range in one flat
+	// array, so queries are O(1) and copy nothing.
+	class TriMeshAdjacency
+	{
+	public:
+		TriMeshAdjacency(const Urho3D::Variant& mesh);
+
+		bool IsValid() const { return !faceFaces_.Empty(); }
+		unsigned GetNumVertices() const { return vertexVertexOffsets_.Size() - 1; }
+		unsigned GetNumFaces() const { return faceFaces_.Size() / 3; }
+
+		// Neighbourhoods of vertex v, sorted by index
+		// Outputs
+		//   count: number of entries starting at the returned pointer
+		const int* GetVertexVertices(int v, unsigned& count) const;
+		const int* GetVertexFaces(int v, unsigned& count) const;
+
+		// face across the edge from corner k to corner k + 1 of face f, -1 on the boundary
+		int GetFaceFace(int f, int k) const { return faceFaces_[3 * f + k]; }
+		// the three vertices of face f
+		const int* GetFaceVertices(int f) const { return &indices_[3 * f]; }
+
+		// True if built from the packed index array view refers to
+		bool IsBuiltFrom(const TriMeshView& view) const;
+
+		// Returns the adjacency of mesh, building it on first use.
+		// Adjacency only depends on the faces, so meshes that differ in vertex positions alone
+		// (a smoothing or deformation loop) share one entry. Packed meshes are matched by the identity
+		// of their index array; unpacked ones are hashed, so callers that query one mesh many times
+		// should hold on to the returned pointer (see TriMesh_ComputeAdjacencyData).
+		static std::shared_ptr<const TriMeshAdjacency> Get(const Urho3D::Variant& mesh);
+
+	private:
+		bool Matches(const int* indices, unsigned numVertices, unsigned numFaces) const;
+
+		Urho3D::PODVector<unsigned> vertexVertexOffsets_;
+		Urho3D::PODVector<int> vertexVertices_;
+		Urho3D::PODVector<unsigned> vertexFaceOffsets_;
+		Urho3D::PODVector<int> vertexFaces_;
+		Urho3D::PODVector<int> faceFaces_;
+		Urho3D::PODVector<int> indices_;
+		std::shared_ptr<const Urho3D::PODVector<unsigned char> > indexArray_;
+		unsigned hash_;
+	};
+}
@@ -0,0 +1,628 @@
+//
+// Copyright (c) 2016 - 2017 Mesh Consultants Inc.
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "Geomlib_TriMeshBVH.h"
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+#include <Urho3D/Core/Mutex.h>
+#include <Urho3D/Math/MathDefs.h>
+
+#include <igl/parallel_for.h>
+
+#include "Geomlib_ClosestPoint.h"
+#include "Geomlib_RayTriangleIntersection.h"
+#include "TriMesh.h"
+
+using namespace Urho3D;
+
+namespace {
+
+	// faces per leaf
+	const unsigned LEAF_SIZE = 4;
+	// enough for any tree built by median splits
+	const unsigned MAX_STACK_DEPTH = 64;
+	// number of meshes whose hierarchies are kept around
+	const unsigned MAX_CACHED_BVHS = 8;
+	// TriMesh map entry holding an attached hierarchy
+	const char* BVH_KEY = "bvh";
+	// below this many queries ClosestPoints stays on the calling thread
+	const unsigned MIN_PARALLEL_QUERIES = 1000;
+	// OverlappingFaces hands out this many subtree pairs per thread, to even out the load
+	const unsigned NODE_PAIRS_PER_THREAD = 32;
+	// below this many subtree pairs OverlappingFaces stays on the calling thread
+	const unsigned MIN_PARALLEL_NODE_PAIRS = 8;
+
+	bool BoxesOverlap(const Vector3& minA, const Vector3& maxA, const Vector3& minB, const Vector3& maxB)
+	{
+		return minA.x_ <= maxB.x_ && minB.x_ <= maxA.x_ &&
+			minA.y_ <= maxB.y_ && minB.y_ <= maxA.y_ &&
+			minA.z_ <= maxB.z_ && minB.z_ <= maxA.z_;
+	}
+
+	float BoxSize(const Vector3& min, const Vector3& max)
+	{
+		Vector3 extent = max - min;
+		return extent.x_ + extent.y_ + extent.z_;
+	}
+
+	float BoxSquaredDistance(const Vector3& min, const Vector3& max, const Vector3& q)
+	{
+		float dx = Max(Max(min.x_ - q.x_, 0.0f), q.x_ - max.x_);
+		float dy = Max(Max(min.y_ - q.y_, 0.0f), q.y_ - max.y_);
+		float dz = Max(Max(min.z_ - q.z_, 0.0f), q.z_ - max.z_);
+		return dx * dx + dy * dy + dz * dz;
+	}
+
+	// slab test against the forward ray origin + s * direction, s in [0, maxS]
+	bool RayHitsBox(const Vector3& min, const Vector3& max, const Vector3& origin, const Vector3& direction, float maxS)
+	{
+		const float* lo = min.Data();
+		const float* hi = max.Data();
+		const float* o = origin.Data();
+		const float* d = direction.Data();
+
+		float sMin = 0.0f;
+		float sMax = maxS;
+		for (unsigned axis = 0; axis < 3; ++axis) {
+			if (d[axis] == 0.0f) {
+				if (o[axis] < lo[axis] || o[axis] > hi[axis]) {
+					return false;
+				}
+				continue;
+			}
+			float inv = 1.0f / d[axis];
+			float s0 = (lo[axis] - o[axis]) * inv;
+			float s1 = (hi[axis] - o[axis]) * inv;
+			if (s0 > s1) {
+				std::swap(s0, s1);
+			}
+			sMin = Max(sMin, s0);
+			sMax = Min(sMax, s1);
+			if (sMin > sMax) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// Closest point on triangle abc to p by Voronoi region tests (Ericson, Real-Time Collision Detection 5.1.5).
+	// Avoids the two ray casts of Geomlib::TriangleClosestPoint in the inner loop, and its fixed determinant
+	// epsilon, which misses the interior of very small triangles.
+	Vector3 ClosestPointOnTriangle(const Vector3& p, const Vector3& a, const Vector3& b, const Vector3& c)
+	{
+		Vector3 ab = b - a;
+		Vector3 ac = c - a;
+		Vector3 ap = p - a;
+		float d1 = ab.DotProduct(ap);
+		float d2 = ac.DotProduct(ap);
+		if (d1 <= 0.0f && d2 <= 0.0f) {
+			return a;
+		}
+
+		Vector3 bp = p - b;
+		float d3 = ab.DotProduct(bp);
+		float d4 = ac.DotProduct(bp);
+		if (d3 >= 0.0f && d4 <= d3) {
+			return b;
+		}
+
+		float vc = d1 * d4 - d3 * d2;
+		if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) {
+			return a + (d1 / (d1 - d3)) * ab;
+		}
+
+		Vector3 cp = p - c;
+		float d5 = ab.DotProduct(cp);
+		float d6 = ac.DotProduct(cp);
+		if (d6 >= 0.0f && d5 <= d6) {
+			return c;
+		}
+
+		float vb = d5 * d2 - d1 * d6;
+		if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) {
+			return a + (d2 / (d2 - d6)) * ac;
+		}
+
+		float va = d3 * d6 - d5 * d4;
+		if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) {
+			return b + ((d4 - d3) / ((d4 - d3) + (d5 - d6))) * (c - b);
+		}
+
+		float denom = va + vb + vc;
+		if (denom == 0.0f) {
+			// degenerate triangle, fall back to the robust version
+			return Geomlib::TriangleClosestPoint(a, b, c, p);
+		}
+		float v = vb / denom;
+		float w = vc / denom;
+		return a + ab * v + ac * w;
+	}
+
+	Mutex bvhCacheMutex;
+	Vector<std::shared_ptr<const Geomlib::TriMeshBVH> > bvhCache;
+
+} // namespace
+
+Geomlib::TriMeshBVH::TriMeshBVH(const Variant& mesh) :
+	hash_(0)
+{
+	TriMeshView view(mesh);
+	if (!view.IsValid()) {
+		return;
+	}
+
+	unsigned numVertices = view.GetNumVertices();
+	unsigned numFaces = view.GetNumFaces();
+	const int* indices = view.GetIndices();
+	for (unsigned i = 0; i < 3 * numFaces; ++i) {
+		if (indices[i] < 0 || (unsigned)indices[i] >= numVertices) {
+			return;
+		}
+	}
+
+	vertices_.Resize(numVertices);
+	for (unsigned i = 0; i < numVertices; ++i) {
+		vertices_[i] = view.GetVertex(i);
+	}
+	indices_.Resize(3 * numFaces);
+	memcpy(&indices_[0], indices, 3 * numFaces * sizeof(int));
+	hash_ = view.GetVertexHash() * 31 + view.GetFaceHash();
+	positionArray_ = view.GetPositionArray();
+	indexArray_ = view.GetIndexArray();
+
+	PODVector<Vector3> centroids(numFaces);
+	faceOrder_.Resize(numFaces);
+	for (unsigned f = 0; f < numFaces; ++f) {
+		centroids[f] = (vertices_[indices[3 * f]] + vertices_[indices[3 * f + 1]] + vertices_[indices[3 * f + 2]]) / 3.0f;
+		faceOrder_[f] = f;
+	}
+
+	nodes_.Reserve(2 * (numFaces / LEAF_SIZE + 1));
+	Build(0, numFaces, centroids);
+}
+
+unsigned Geomlib::TriMeshBVH::Build(unsigned begin, unsigned end, const PODVector<Vector3>& centroids)
+{
+	Node node;
+	node.min_ = Vector3(M_INFINITY, M_INFINITY, M_INFINITY);
+	node.max_ = -node.min_;
+	Vector3 centroidMin = node.min_;
+	Vector3 centroidMax = node.max_;
+	for (unsigned i = begin; i < end; ++i) {
+		unsigned f = faceOrder_[i];
+		for (unsigned j = 0; j < 3; ++j) {
+			const Vector3& v = vertices_[indices_[3 * f + j]];
+			node.min_ = VectorMin(node.min_, v);
+			node.max_ = VectorMax(node.max_, v);
+		}
+		centroidMin = VectorMin(centroidMin, centroids[f]);
+		centroidMax = VectorMax(centroidMax, centroids[f]);
+	}
+
+	unsigned index = nodes_.Size();
+	if (end - begin <= LEAF_SIZE) {
+		node.first_ = begin;
+		node.count_ = end - begin;
+		nodes_.Push(node);
+		return index;
+	}
+
+	node.first_ = 0;
+	node.count_ = 0;
+	nodes_.Push(node);
+
+	// median split along the longest axis of the centroid bounds
+	Vector3 extent = centroidMax - centroidMin;
+	unsigned axis = 0;
+	if (extent.y_ > extent.x_) {
+		axis = 1;
+	}
+	if (extent.z_ > extent.Data()[axis]) {
+		axis = 2;
+	}
+
+	unsigned mid = begin + (end - begin) / 2;
+	std::nth_element(
+		&faceOrder_[0] + begin,
+		&faceOrder_[0] + mid,
+		&faceOrder_[0] + end,
+		[&centroids, axis](unsigned a, unsigned b) { return centroids[a].Data()[axis] < centroids[b].Data()[axis]; }
+	);
+
+	Build(begin, mid, centroids);
+	unsigned right = Build(mid, end, centroids);
+	nodes_[index].first_ = right;
+	return index;
+}
+
+bool Geomlib::TriMeshBVH::Matches(const float* positions, unsigned numVertices, const int* indices, unsigned numFaces) const
+{
+	return numVertices == vertices_.Size() &&
+		3 * numFaces == indices_.Size() &&
+		memcmp(&vertices_[0], positions, 3 * numVertices * sizeof(float)) == 0 &&
+		memcmp(&indices_[0], indices, 3 * numFaces * sizeof(int)) == 0;
+}
+
+bool Geomlib::TriMeshBVH::IsBuiltFrom(const TriMeshView& view) const
+{
+	return view.IsPacked() && positionArray_ == view.GetPositionArray() && indexArray_ == view.GetIndexArray();
+}
+
+bool Geomlib::TriMeshBVH::ClosestPoint(const Vector3& q, int& face, Vector3& p) const
+{
+	if (!IsValid()) {
+		return false;
+	}
+
+	float minSqDistance = M_INFINITY;
+	int minFace = -1;
+
+	unsigned stack[MAX_STACK_DEPTH];
+	unsigned depth = 0;
+	stack[depth++] = 0;
+
+	while (depth > 0) {
+		unsigned nodeIndex = stack[--depth];
+		const Node& node = nodes_[nodeIndex];
+		if (BoxSquaredDistance(node.min_, node.max_, q) > minSqDistance) {
+			continue;
+		}
+
+		if (node.count_ > 0) {
+			for (unsigned i = node.first_; i < node.first_ + node.count_; ++i) {
+				int f = (int)faceOrder_[i];
+				Vector3 r = ClosestPointOnTriangle(
+					q,
+					vertices_[indices_[3 * f]],
+					vertices_[indices_[3 * f + 1]],
+					vertices_[indices_[3 * f + 2]]
+				);
+				float sqDistance = (r - q).LengthSquared();
+				// ties go to the lowest face index, as with a linear scan
+				if (sqDistance < minSqDistance || (sqDistance == minSqDistance && f < minFace)) {
+					minSqDistance = sqDistance;
+					minFace = f;
+					p = r;
+				}
+			}
+			continue;
+		}
+
+		// visit the nearer child first
+		unsigned left = nodeIndex + 1;
+		unsigned right = node.first_;
+		float leftDistance = BoxSquaredDistance(nodes_[left].min_, nodes_[left].max_, q);
+		float rightDistance = BoxSquaredDistance(nodes_[right].min_, nodes_[right].max_, q);
+		if (leftDistance < rightDistance) {
+			std::swap(left, right);
+		}
+		stack[depth++] = left;
+		stack[depth++] = right;
+	}
+
+	face = minFace;
+	return minFace >= 0;
+}
+
+void Geomlib::TriMeshBVH::ClosestPoints(
+	const PODVector<Vector3>& queries,
+	PODVector<int>& faces,
+	PODVector<Vector3>& points
+) const
+{
+	faces.Resize(queries.Size());
+	points.Resize(queries.Size());
+
+	igl::parallel_for(
+		(int)queries.Size(),
+		[this, &queries, &faces, &points](int i) {
+			faces[i] = -1;
+			points[i] = queries[i];
+			ClosestPoint(queries[i], faces[i], points[i]);
+		},
+		MIN_PARALLEL_QUERIES
+	);
+}
+
+bool Geomlib::TriMeshBVH::Raycast(const Vector3& origin, const Vector3& direction, int& face, float& s) const
+{
+	if (!IsValid()) {
+		return false;
+	}
+
+	float minS = M_INFINITY;
+	int minFace = -1;
+
+	unsigned stack[MAX_STACK_DEPTH];
+	unsigned depth = 0;
+	stack[depth++] = 0;
+
+	while (depth > 0) {
+		unsigned nodeIndex = stack[--depth];
+		const Node& node = nodes_[nodeIndex];
+		if (!RayHitsBox(node.min_, node.max_, origin, direction, minS)) {
+			continue;
+		}
+
+		if (node.count_ > 0) {
+			for (unsigned i = node.first_; i < node.first_ + node.count_; ++i) {
+				int f = (int)faceOrder_[i];
+				float t = 0.0f;
+				bool hit = Geomlib::RayTriangleIntersection(
+					vertices_[indices_[3 * f]],
+					vertices_[indices_[3 * f + 1]],
+					vertices_[indices_[3 * f + 2]],
+					origin,
+					direction,
+					t
+				);
+				if (hit && (t < minS || (t == minS && f < minFace))) {
+					minS = t;
+					minFace = f;
+				}
+			}
+			continue;
+		}
+
+		stack[depth++] = node.first_;
+		stack[depth++] = nodeIndex + 1;
+	}
+
+	if (minFace < 0) {
+		return false;
+	}
+
+	face = minFace;
+	s = minS;
+	return true;
+}
+
+void Geomlib::TriMeshBVH::FacesInRadius(const Vector3& center, float radius, PODVector<int>& faces) const
+{
+	if (!IsValid() || radius < 0.0f) {
+		return;
+	}
+
+	float sqRadius = radius * radius;
+
+	unsigned stack[MAX_STACK_DEPTH];
+	unsigned depth = 0;
+	stack[depth++] = 0;
+
+	while (depth > 0) {
+		unsigned nodeIndex = stack[--depth];
+		const Node& node = nodes_[nodeIndex];
+		if (BoxSquaredDistance(node.min_, node.max_, center) > sqRadius) {
+			continue;
+		}
+
+		if (node.count_ > 0) {
+			for (unsigned i = node.first_; i < node.first_ + node.count_; ++i) {
+				int f = (int)faceOrder_[i];
+				Vector3 r = ClosestPointOnTriangle(
+					center,
+					vertices_[indices_[3 * f]],
+					vertices_[indices_[3 * f + 1]],
+					vertices_[indices_[3 * f + 2]]
+				);
+				if ((r - center).LengthSquared() <= sqRadius) {
+					faces.Push(f);
+				}
+			}
+			continue;
+		}
+
+		stack[depth++] = node.first_;
+		stack[depth++] = nodeIndex + 1;
+	}
+}
+
+bool Geomlib::TriMeshBVH::SplitNodePair(const TriMeshBVH& other, const IntVector2& nodePair, IntVector2* children) const
+{
+	const Node& a = nodes_[nodePair.x_];
+	const Node& b = other.nodes_[nodePair.y_];
+	bool leafA = a.count_ > 0;
+	bool leafB = b.count_ > 0;
+	if (leafA && leafB) {
+		return false;
+	}
+
+	// descend into the bigger box
+	if (leafB || (!leafA && BoxSize(a.min_, a.max_) >= BoxSize(b.min_, b.max_))) {
+		children[0] = IntVector2(nodePair.x_ + 1, nodePair.y_);
+		children[1] = IntVector2(a.first_, nodePair.y_);
+	}
+	else {
+		children[0] = IntVector2(nodePair.x_, nodePair.y_ + 1);
+		children[1] = IntVector2(nodePair.x_, b.first_);
+	}
+	return true;
+}
+
+void Geomlib::TriMeshBVH::CollectOverlaps(const TriMeshBVH& other, const IntVector2& nodePair, PODVector<IntVector2>& pairs) const
+{
+	IntVector2 stack[2 * MAX_STACK_DEPTH];
+	unsigned depth = 0;
+	stack[depth++] = nodePair;
+
+	while (depth > 0) {
+		IntVector2 current = stack[--depth];
+		const Node& a = nodes_[current.x_];
+		const Node& b = other.nodes_[current.y_];
+		if (!BoxesOverlap(a.min_, a.max_, b.min_, b.max_)) {
+			continue;
+		}
+
+		if (SplitNodePair(other, current, stack + depth)) {
+			depth += 2;
+			continue;
+		}
+
+		for (unsigned i = a.first_; i < a.first_ + a.count_; ++i) {
+			int fa = (int)faceOrder_[i];
+			const Vector3& a0 = vertices_[indices_[3 * fa]];
+			const Vector3& a1 = vertices_[indices_[3 * fa + 1]];
+			const Vector3& a2 = vertices_[indices_[3 * fa + 2]];
+			Vector3 minA = VectorMin(a0, VectorMin(a1, a2));
+			Vector3 maxA = VectorMax(a0, VectorMax(a1, a2));
+			for (unsigned j = b.first_; j < b.first_ + b.count_; ++j) {
+				int fb = (int)other.faceOrder_[j];
+				const Vector3& b0 = other.vertices_[other.indices_[3 * fb]];
+				const Vector3& b1 = other.vertices_[other.indices_[3 * fb + 1]];
+				const Vector3& b2 = other.vertices_[other.indices_[3 * fb + 2]];
+				if (BoxesOverlap(minA, maxA, VectorMin(b0, VectorMin(b1, b2)), VectorMax(b0, VectorMax(b1, b2)))) {
+					pairs.Push(IntVector2(fa, fb));
+				}
+			}
+		}
+	}
+}
+
+void Geomlib::TriMeshBVH::OverlappingFaces(const TriMeshBVH& other, PODVector<IntVector2>& pairs) const
+{
+	if (!IsValid() || !other.IsValid()) {
+		return;
+	}
+
+	// expand the root pair breadth first into enough overlapping subtree pairs to share out
+	unsigned numThreads = Max(std::thread::hardware_concurrency(), 1u);
+	PODVector<IntVector2> frontier;
+	frontier.Push(IntVector2(0, 0));
+	bool expanded = true;
+	while (expanded && frontier.Size() < NODE_PAIRS_PER_THREAD * numThreads) {
+		expanded = false;
+		PODVector<IntVector2> next;
+		for (unsigned i = 0; i < frontier.Size(); ++i) {
+			const Node& a = nodes_[frontier[i].x_];
+			const Node& b = other.nodes_[frontier[i].y_];
+			if (!BoxesOverlap(a.min_, a.max_, b.min_, b.max_)) {
+				continue;
+			}
+			IntVector2 children[2];
+			if (SplitNodePair(other, frontier[i], children)) {
+				next.Push(children[0]);
+				next.Push(children[1]);
+				expanded = true;
+			}
+			else {
+				next.Push(frontier[i]);
+			}
+		}
+		frontier = next;
+	}
+
+	Vector<PODVector<IntVector2> > found(frontier.Size());
+	igl::parallel_for(
+		(int)frontier.Size(),
+		[this, &other, &frontier, &found](int i) { CollectOverlaps(other, frontier[i], found[i]); },
+		MIN_PARALLEL_NODE_PAIRS
+	);
+
+	for (unsigned i = 0; i < found.Size(); ++i) {
+		pairs.Push(found[i]);
+	}
+}
+
+std::shared_ptr<const Geomlib::TriMeshBVH> Geomlib::TriMeshBVH::Get(const Variant& mesh)
+{
+	std::shared_ptr<const TriMeshBVH> bvh;
+	{
+		TriMeshView view(mesh);
+		if (!view.IsValid()) {
+			return bvh;
+		}
+
+		const Variant* handle = mesh.GetVariantMap()[BVH_KEY];
+		if (handle != NULL && handle->IsCustomType<std::shared_ptr<const TriMeshBVH> >()) {
+			bvh = handle->GetCustom<std::shared_ptr<const TriMeshBVH> >();
+			if (bvh && bvh->IsBuiltFrom(view)) {
+				return bvh;
+			}
+			bvh.reset();
+		}
+
+		// packed arrays are matched by identity, only unpacked meshes need hashing
+		unsigned hash = view.IsPacked() ? 0 : view.GetVertexHash() * 31 + view.GetFaceHash();
+
+		MutexLock lock(bvhCacheMutex);
+		for (unsigned i = 0; i < bvhCache.Size(); ++i) {
+			const std::shared_ptr<const TriMeshBVH>& cached = bvhCache[i];
+			bool match = view.IsPacked() ? cached->IsBuiltFrom(view) :
+				cached->hash_ == hash &&
+				cached->Matches(view.GetPositions(), view.GetNumVertices(), view.GetIndices(), view.GetNumFaces());
+			if (match)
+			{
+				// most recently used goes to the front
+				bvh = cached;
+				bvhCache.Erase(i);
+				bvhCache.Insert(0, bvh);
+				return bvh;
+			}
+		}
+	}
+
+	// build outside the lock, two threads racing on the same mesh just build it twice
+	bvh = std::make_shared<TriMeshBVH>(mesh);
+	if (!bvh->IsValid()) {
+		return std::shared_ptr<const TriMeshBVH>();
+	}
+
+	MutexLock lock(bvhCacheMutex);
+	bvhCache.Insert(0, bvh);
+	if (bvhCache.Size() > MAX_CACHED_BVHS) {
+		bvhCache.Pop();
+	}
+	return bvh;
+}
+
+bool Geomlib::TriMeshRaycast(
+	const Variant& mesh,
+	const Vector3& O,
+	const Vector3& D,
+	int& index,
+	float& s
+)
+{
+	std::shared_ptr<const TriMeshBVH> bvh = TriMeshBVH::Get(mesh);
+	if (!bvh) {
+		return false;
+	}
+
+	return bvh->Raycast(O, D, index, s);
+}
+
+Variant Geomlib::TriMesh_AttachBVH(const Variant& mesh)
+{
+	Variant packed = TriMesh_Pack(mesh);
+	std::shared_ptr<const TriMeshBVH> bvh = TriMeshBVH::Get(packed);
+	if (!bvh) {
+		return Variant();
+	}
+
+	Variant handle;
+	handle.SetCustom<std::shared_ptr<const TriMeshBVH> >(bvh);
+	(*packed.GetVariantMapPtr())[BVH_KEY] = handle;
+	return packed;
+}
@@ -0,0 +1,124 @@
+//
+// Copyright (c) 2016 - 2017 Mesh Consultants Inc.
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include <Urho3D/Container/Vector.h>
+#include <Urho3D/Core/Variant.h>
+#include <Urho3D/Math/Vector2.h>
+#include <Urho3D/Math/Vector3.h>
+
+#include <memory>
+
+class TriMeshView;
+
+namespace Geomlib {
+
+	// Bounding volume hierarchy over the faces of a TriMesh.
+	// Build once with TriMeshBVH::Get and reuse it for closest point, ray and radius queries;
+	// queries are const and safe to run from several threads at once.
+	class TriMeshBVH
+	{
+	public:
+		TriMeshBVH(const Urho3D::Variant& mesh);
+
+		bool IsValid() const { return !nodes_.Empty(); }
+		unsigned GetNumFaces() const { return indices_.Size() / 3; }
+
+		// Inputs
+		//   q: query point
+		// Outputs
+		//   face: index of face closest to q
+		//   p: point on mesh closest to q
+		bool ClosestPoint(const Urho3D::Vector3& q, int& face, Urho3D::Vector3& p) const;
+
+		// Batched ClosestPoint, spread over all hardware threads for large query sets
+		void ClosestPoints(
+			const Urho3D::PODVector<Urho3D::Vector3>& queries,
+			Urho3D::PODVector<int>& faces,
+			Urho3D::PODVector<Urho3D::Vector3>& points
+		) const;
+
+		// Inputs
+		//   origin, direction: ray, direction does not need to be normalized
+		// Outputs
+		//   face: index of first face hit
+		//   s: hit point is origin + s * direction
+		bool Raycast(const Urho3D::Vector3& origin, const Urho3D::Vector3& direction, int& face, float& s) const;
+
+		// Appends the indices of all faces within radius of center
+		void FacesInRadius(const Urho3D::Vector3& center, float radius, Urho3D::PODVector<int>& faces) const;
+
+		// Appends each pair of faces, x from this hierarchy and y from other, whose bounding boxes overlap.
+		// The two trees are split into independent subtree pairs that are traversed on all hardware threads.
+		void OverlappingFaces(const TriMeshBVH& other, Urho3D::PODVector<Urho3D::IntVector2>& pairs) const;
+
+		// Returns the hierarchy for mesh, building it on first use.
+		// A hierarchy attached to the mesh with TriMesh_AttachBVH is returned directly. Packed meshes are
+		// otherwise looked up by the identity of their shared arrays, also without touching the data.
+		// Unpacked meshes are values, so for them the cache is keyed by a hash of the vertex and face data
+		// and a hit is confirmed against the stored copy, which costs a pass over the mesh per call.
+		static std::shared_ptr<const TriMeshBVH> Get(const Urho3D::Variant& mesh);
+
+	private:
+		// inner nodes keep their left child at the next index and the right child in first_
+		struct Node
+		{
+			Urho3D::Vector3 min_;
+			Urho3D::Vector3 max_;
+			unsigned first_;
+			unsigned count_;
+		};
+
+		unsigned Build(unsigned begin, unsigned end, const Urho3D::PODVector<Urho3D::Vector3>& centroids);
+		bool SplitNodePair(const TriMeshBVH& other, const Urho3D::IntVector2& nodePair, Urho3D::IntVector2* children) const;
+		void CollectOverlaps(const TriMeshBVH& other, const Urho3D::IntVector2& nodePair, Urho3D::PODVector<Urho3D::IntVector2>& pairs) const;
+		bool Matches(const float* positions, unsigned numVertices, const int* indices, unsigned numFaces) const;
+		bool IsBuiltFrom(const TriMeshView& view) const;
+
+		Urho3D::PODVector<Urho3D::Vector3> vertices_;
+		Urho3D::PODVector<int> indices_;
+		Urho3D::PODVector<unsigned> faceOrder_;
+		Urho3D::PODVector<Node> nodes_;
+		unsigned hash_;
+		// arrays of the packed mesh this was built from, NULL for unpacked meshes
+		std::shared_ptr<const Urho3D::PODVector<unsigned char> > positionArray_;
+		std::shared_ptr<const Urho3D::PODVector<unsigned char> > indexArray_;
+	};
+
+	// Returns a packed copy of mesh with its TriMeshBVH stored under "bvh", so that repeated
+	// queries through TriMeshBVH::Get, e.g. TriMeshRaycast in a script loop, skip the cache lookup.
+	// The handle is ignored once the mesh data is replaced.
+	Urho3D::Variant TriMesh_AttachBVH(const Urho3D::Variant& mesh);
+
+	// Ray cast against a TriMesh through its cached TriMeshBVH
+	// Outputs
+	//   index: index of first face hit
+	//   s: hit point is O + s * D
+	bool TriMeshRaycast(
+		const Urho3D::Variant& mesh,
+		const Urho3D::Vector3& O,
+		const Urho3D::Vector3& D,
+		int& index,
+		float& s
+	);
+}
@@ -29,12 +29,11 @@
 
 #include "ConversionUtilities.h"
 
-#include "Geomlib_ClosestPoint.h"
+#include "Geomlib_TriMeshBVH.h"
 #include "TriMesh.h"
 
 using namespace Urho3D;
 
-// IN PROGRESS, NOT DONE * IN PROGRESS, NOT DONE
 // Inputs
 //   mesh: mesh data stored in Urho3D::Variant
 //   q: query point
@@ -46,52 +45,14 @@ bool Geomlib::TriMeshClosestPoint(const Variant& mesh, const Vector3 q, int& ind
 	if (!TriMesh_Verify(mesh)) {
 		return false;
 	}
-	VariantMap meshMap = mesh.GetVariantMap();
 
-	// mesh data guaranteed
-	Vector<Variant> vertexList = meshMap["vertices"].GetVariantVector();
-	Vector<Variant> faceList = meshMap["faces"].GetVariantVector();
-
-	unsigned numVertices = vertexList.Size();
-	assert(numVertices > 0);
-	unsigned numFaces = faceList.Size() / 3;
-	assert(numFaces > 0);
-
-	float* sqDistances = new float[numFaces];
-	Vector<Vector3> perFaceClosePoints;
-
-	for (unsigned i = 0; i < faceList.Size(); i += 3) {
-
-		unsigned faceIndex = i / 3;
-
-		// these lookups should be guaranteed by ExtractMeshData --- no safety checks needed!
-		unsigned i0 = faceList[i].GetInt();
-		unsigned i1 = faceList[i + 1].GetInt();
-		unsigned i2 = faceList[i + 2].GetInt();
-		Vector3 v0 = vertexList[i0].GetVector3();
-		Vector3 v1 = vertexList[i1].GetVector3();
-		Vector3 v2 = vertexList[i2].GetVector3();
-
-		Vector3 r = Geomlib::TriangleClosestPoint(v0, v1, v2, q);
-		sqDistances[faceIndex] = (r - q).LengthSquared();
-		perFaceClosePoints.Push(r);
-	}
-
-	float minSqDistance = sqDistances[0];
-	unsigned minFaceIndex = 0;
-	for (unsigned f = 1; f < numFaces; ++f) {
-		float sqDistance = sqDistances[f];
-		if (sqDistance < minSqDistance) {
-			minSqDistance = sqDistance;
-			minFaceIndex = f;
-		}
+	// the hierarchy is cached per mesh, so repeated queries only pay for the lookup
+	std::shared_ptr<const TriMeshBVH> bvh = TriMeshBVH::Get(mesh);
+	if (!bvh) {
+		return false;
 	}
 
-	delete[] sqDistances;
-
-	index = (int)minFaceIndex;
-	p = perFaceClosePoints[minFaceIndex];
-	return true;
+	return bvh->ClosestPoint(q, index, p);
 }
 
 bool Geomlib::TriMeshPerVertexClosestPoint(
@@ -100,18 +61,30 @@ bool Geomlib::TriMeshPerVertexClosestPoint(
 	Urho3D::VariantVector& closest_points
 )
 {
-	VariantVector vertex_list = TriMesh_GetVertexList(mesh);
 	closest_points.Clear();
 
-	for (int i = 0; i < vertex_list.Size(); ++i) {
+	if (!TriMesh_Verify(target_mesh)) {
+		return false;
+	}
+
+	std::shared_ptr<const TriMeshBVH> bvh = TriMeshBVH::Get(target_mesh);
+	if (!bvh) {
+		return false;
+	}
 
-		Vector3 v = vertex_list[i].GetVector3();
+	TriMeshView view(mesh);
+	PODVector<Vector3> queries(view.GetNumVertices());
+	for (unsigned i = 0; i < queries.Size(); ++i) {
+		queries[i] = view.GetVertex(i);
+	}
 
-		Vector3 p;
-		int f = -1;
-		TriMeshClosestPoint(target_mesh, v, f, p);
+	PODVector<int> faces;
+	PODVector<Vector3> points;
+	bvh->ClosestPoints(queries, faces, points);
 
-		closest_points.Push(p);
+	closest_points.Resize(points.Size());
+	for (unsigned i = 0; i < points.Size(); ++i) {
+		closest_points[i] = points[i];
 	}
 
 	return true;
@@ -180,6 +180,6 @@ bool Geomlib::TriMeshLoopSubdivide(
 
 	loop_subdivide_mesh(V, F, NV, NF);
 
-	meshOut = TriMesh_Make(NV, NF);
+	meshOut = TriMesh_MakePacked(NV, NF);
 	return true;
 }
\ No newline at end of file
@@ -37,30 +37,35 @@
 
 #include "TriMesh.h"
 #include "ConversionUtilities.h"
+#include "Geomlib_SparseSolverCache.h"
 
 namespace {
 
+// S = M - 0.001 L keeps the sparsity pattern of the faces, so the solver only redoes the
+// symbolic analysis when the topology changes and refactors the new values every step
 bool IglMeanCurvatureStep(
 	const Eigen::MatrixXf& V,
 	const Eigen::MatrixXi& F,
+	Geomlib::CachedSparseSolver& solver,
+	unsigned topologyKey,
+	unsigned stepKey,
 	Eigen::MatrixXf& NV,
 	Eigen::MatrixXi& NF
 )
 {
-	Eigen::MatrixXf U = V;
+	Eigen::MatrixXd Vd = V.cast<double>();
 
-	Eigen::SparseMatrix<float> L;
-	igl::cotmatrix(V, F, L);
+	Eigen::SparseMatrix<double> L;
+	igl::cotmatrix(Vd, F, L);
 
-	Eigen::SparseMatrix<float> M;
-	igl::massmatrix(U, F, igl::MASSMATRIX_TYPE_BARYCENTRIC, M);
+	Eigen::SparseMatrix<double> M;
+	igl::massmatrix(Vd, F, igl::MASSMATRIX_TYPE_BARYCENTRIC, M);
 
-	const auto & S = (M - 0.001f * L);
-	Eigen::SimplicialLLT<Eigen::SparseMatrix<float> > solver(S);
-	if (solver.info() != Eigen::Success) {
+	Eigen::SparseMatrix<double> S = M - 0.001 * L;
+	if (!solver.Factorize(S, topologyKey, stepKey)) {
 		return false;
 	}
-	U = solver.solve(M * U).eval();
+	Eigen::MatrixXf U = solver.Solve(M * Vd).cast<float>();
 
 	// Compute centroid and subtract (also important for numerics)
 	Eigen::VectorXf doubleArea;
@@ -71,7 +76,7 @@ bool IglMeanCurvatureStep(
 	}
 
 	Eigen::MatrixXf BC;
-	igl::barycenter(U, F, doubleArea);
+	igl::barycenter(U, F, BC);
 	Eigen::RowVector3f centroid(0, 0, 0);
 	for (int i = 0; i < BC.rows(); ++i) {
 		centroid += (0.5f * doubleArea(i) / area) * BC.row(i);
@@ -119,7 +124,8 @@ Urho3D::Variant Geomlib::TriMesh_MeanCurvatureFlowStep(
 	// V, F are ok
 	Eigen::MatrixXf NV;
 	Eigen::MatrixXi NF;
-	bool success = IglMeanCurvatureStep(V, F, NV, NF);
+	Geomlib::CachedSparseSolver solver;
+	bool success = IglMeanCurvatureStep(V, F, solver, 0, 0, NV, NF);
 	if (!success) {
 		return Variant();
 	}
@@ -146,11 +152,15 @@ bool Geomlib::TriMesh_MeanCurvatureFlow(
 
 	// V, F are ok here
 
+	// faces never change between steps, one symbolic analysis serves them all
+	Geomlib::CachedSparseSolver solver;
+	unsigned topologyKey = TriMeshView(tri_mesh).GetFaceHash();
+
 	for (int i = 0; i < num_steps; ++i) {
 
 		Eigen::MatrixXf VV;
 		Eigen::MatrixXi FF;
-		bool success = IglMeanCurvatureStep(V, F, VV, FF);
+		bool success = IglMeanCurvatureStep(V, F, solver, topologyKey, (unsigned)i, VV, FF);
 		if (!success) {
 			return false;
 		}
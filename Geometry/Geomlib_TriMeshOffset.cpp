@@ -46,9 +46,8 @@ bool Geomlib::TriMeshOffset(
 	}
 
 	// meshIn: verify and parse
-	VariantMap meshMap = meshIn.GetVariantMap();
-	const VariantVector vertexList = meshMap["vertices"].GetVariantVector();
-	const VariantVector faceList = meshMap["faces"].GetVariantVector();
+	const VariantVector vertexList = TriMesh_GetVertexList(meshIn);
+	const VariantVector faceList = TriMesh_GetFaceList(meshIn);
 
 	VariantVector vertNormals = TriMesh_ComputeVertexNormals(meshIn, true);
 	assert(vertNormals.Size() == vertexList.Size());
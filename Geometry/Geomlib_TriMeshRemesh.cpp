@@ -0,0 +1,251 @@
+//
+// Copyright (c) 2016 - 2017 Mesh Consultants Inc.
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "Geomlib_TriMeshRemesh.h"
+
+#include <algorithm>
+
+#include <Urho3D/Math/MathDefs.h>
+
+#include <igl/parallel_for.h>
+
+#include "Geomlib_HalfEdgeMesh.h"
+#include "Geomlib_TriMeshBVH.h"
+
+using namespace Urho3D;
+using Geomlib::HalfEdgeMesh;
+
+namespace {
+
+	// below this many vertices relaxation stays on the calling thread
+	const unsigned MIN_PARALLEL_VERTICES = 1000;
+
+	Vector3 TriangleNormal(const Vector3& a, const Vector3& b, const Vector3& c)
+	{
+		return (b - a).CrossProduct(c - a);
+	}
+
+	float AverageEdgeLength(const HalfEdgeMesh& mesh)
+	{
+		double sum = 0.0;
+		unsigned count = 0;
+		for (unsigned e = 0; e < mesh.GetNumEdges(); ++e) {
+			if (mesh.IsEdgeAlive(e)) {
+				sum += mesh.EdgeLength(e);
+				++count;
+			}
+		}
+		return count > 0 ? (float)(sum / count) : 0.0f;
+	}
+
+	void SplitLongEdges(HalfEdgeMesh& mesh, float high)
+	{
+		float high2 = high * high;
+		// edges created by a split are appended and get checked in the same pass
+		for (unsigned e = 0; e < mesh.GetNumEdges(); ++e) {
+			if (!mesh.IsEdgeAlive(e) || mesh.IsBoundaryEdge(e))
+				continue;
+			Vector3 a = mesh.GetPosition(mesh.Source(2 * e));
+			Vector3 b = mesh.GetPosition(mesh.Target(2 * e));
+			if ((b - a).LengthSquared() > high2)
+				mesh.SplitEdge(e, 0.5f * (a + b));
+		}
+	}
+
+	// Rejects collapses that create edges longer than high or turn a surviving face over
+	bool IsCollapseGood(const HalfEdgeMesh& mesh, int h, const Vector3& p, float high2)
+	{
+		int a = mesh.Source(h);
+		int b = mesh.Target(h);
+		int f0 = mesh.Face(h);
+		int f1 = mesh.Face(h ^ 1);
+
+		int ends[2] = { a, b };
+		for (int i = 0; i < 2; ++i) {
+			int v = ends[i];
+			const Vector3& pv = mesh.GetPosition(v);
+			int start = mesh.GetVertexHalfEdge(v);
+			int x = start;
+			do {
+				int n = mesh.Target(x);
+				if (n != a && n != b && (mesh.GetPosition(n) - p).LengthSquared() > high2)
+					return false;
+				int f = mesh.Face(x);
+				if (f >= 0 && f != f0 && f != f1) {
+					const Vector3& q1 = mesh.GetPosition(n);
+					const Vector3& q2 = mesh.GetPosition(mesh.Target(mesh.Next(x)));
+					if (TriangleNormal(pv, q1, q2).DotProduct(TriangleNormal(p, q1, q2)) <= 0.0f)
+						return false;
+				}
+				x = mesh.NextOutgoing(x);
+			} while (x != start);
+		}
+		return true;
+	}
+
+	void CollapseShortEdges(HalfEdgeMesh& mesh, float low, float high)
+	{
+		float low2 = low * low;
+		float high2 = high * high;
+		for (unsigned e = 0; e < mesh.GetNumEdges(); ++e) {
+			if (!mesh.IsEdgeAlive(e) || mesh.IsBoundaryEdge(e))
+				continue;
+
+			int h = 2 * e;
+			bool sourceBoundary = mesh.IsBoundaryVertex(mesh.Source(h));
+			bool targetBoundary = mesh.IsBoundaryVertex(mesh.Target(h));
+			if (sourceBoundary && targetBoundary)
+				continue;
+			if ((mesh.GetPosition(mesh.Target(h)) - mesh.GetPosition(mesh.Source(h))).LengthSquared() >= low2)
+				continue;
+
+			// the removed vertex is always an interior one, boundary vertices stay where they are
+			if (sourceBoundary) {
+				h ^= 1;
+				std::swap(sourceBoundary, targetBoundary);
+			}
+			const Vector3& a = mesh.GetPosition(mesh.Source(h));
+			const Vector3& b = mesh.GetPosition(mesh.Target(h));
+			Vector3 p = targetBoundary ? b : 0.5f * (a + b);
+
+			if (!IsCollapseGood(mesh, h, p, high2) || !mesh.CanCollapse(h))
+				continue;
+			mesh.CollapseEdge(h, p);
+		}
+	}
+
+	int ValenceDeviation(const HalfEdgeMesh& mesh, int v, int change)
+	{
+		int target = mesh.IsBoundaryVertex(v) ? 4 : 6;
+		return Abs(mesh.Valence(v) + change - target);
+	}
+
+	void EqualizeValences(HalfEdgeMesh& mesh)
+	{
+		for (unsigned e = 0; e < mesh.GetNumEdges(); ++e) {
+			if (!mesh.IsEdgeAlive(e) || mesh.IsBoundaryEdge(e))
+				continue;
+
+			int h = 2 * e;
+			int a = mesh.Source(h);
+			int b = mesh.Target(h);
+			int c = mesh.Target(mesh.Next(h));
+			int d = mesh.Target(mesh.Next(h ^ 1));
+
+			int before = ValenceDeviation(mesh, a, 0) + ValenceDeviation(mesh, b, 0) +
+				ValenceDeviation(mesh, c, 0) + ValenceDeviation(mesh, d, 0);
+			int after = ValenceDeviation(mesh, a, -1) + ValenceDeviation(mesh, b, -1) +
+				ValenceDeviation(mesh, c, 1) + ValenceDeviation(mesh, d, 1);
+			if (after >= before || !mesh.CanFlip(e))
+				continue;
+
+			// both new faces must face the same way as the pair they replace
+			const Vector3& pa = mesh.GetPosition(a);
+			const Vector3& pb = mesh.GetPosition(b);
+			const Vector3& pc = mesh.GetPosition(c);
+			const Vector3& pd = mesh.GetPosition(d);
+			Vector3 n = TriangleNormal(pa, pb, pc) + TriangleNormal(pb, pa, pd);
+			if (TriangleNormal(pc, pa, pd).DotProduct(n) <= 0.0f || TriangleNormal(pd, pb, pc).DotProduct(n) <= 0.0f)
+				continue;
+
+			mesh.FlipEdge(e);
+		}
+	}
+
+	// Moves every interior vertex to the centroid of its neighbours, projected onto its tangent plane
+	void TangentialRelaxation(HalfEdgeMesh& mesh, PODVector<int>& moved, PODVector<Vector3>& targets)
+	{
+		moved.Clear();
+		for (unsigned v = 0; v < mesh.GetNumVertices(); ++v) {
+			if (mesh.IsVertexAlive(v) && !mesh.IsBoundaryVertex(v))
+				moved.Push(v);
+		}
+		targets.Resize(moved.Size());
+
+		const HalfEdgeMesh& constMesh = mesh;
+		igl::parallel_for(
+			(int)moved.Size(),
+			[&constMesh, &moved, &targets](int i) {
+				int v = moved[i];
+				const Vector3& p = constMesh.GetPosition(v);
+				Vector3 centroid = Vector3::ZERO;
+				Vector3 normal = Vector3::ZERO;
+				int count = 0;
+				int start = constMesh.GetVertexHalfEdge(v);
+				int x = start;
+				do {
+					const Vector3& q = constMesh.GetPosition(constMesh.Target(x));
+					centroid += q;
+					normal += TriangleNormal(p, q, constMesh.GetPosition(constMesh.Target(constMesh.Next(x))));
+					++count;
+					x = constMesh.NextOutgoing(x);
+				} while (x != start);
+				centroid /= (float)count;
+				normal.Normalize();
+				targets[i] = centroid + normal.DotProduct(p - centroid) * normal;
+			},
+			MIN_PARALLEL_VERTICES
+		);
+
+		for (unsigned i = 0; i < moved.Size(); ++i)
+			mesh.SetPosition(moved[i], targets[i]);
+	}
+}
+
+Variant Geomlib::TriMesh_Remesh(
+	const Variant& tri_mesh,
+	float target_length,
+	float tolerance,
+	int iterations
+)
+{
+	HalfEdgeMesh mesh;
+	if (!HalfEdgeMesh_FromTriMesh(tri_mesh, mesh))
+		return Variant();
+
+	std::shared_ptr<const TriMeshBVH> surface = TriMeshBVH::Get(tri_mesh);
+	if (!surface || !surface->IsValid())
+		return Variant();
+
+	PODVector<int> moved;
+	PODVector<Vector3> targets;
+	PODVector<int> faces;
+	PODVector<Vector3> projected;
+	for (int i = 0; i < iterations; ++i) {
+		// without a target the length follows the mesh from step to step
+		float length = target_length > 0.0f ? target_length : AverageEdgeLength(mesh);
+		float low = (1.0f - tolerance) * length;
+		float high = (1.0f + tolerance) * length;
+
+		SplitLongEdges(mesh, high);
+		CollapseShortEdges(mesh, low, high);
+		EqualizeValences(mesh);
+		TangentialRelaxation(mesh, moved, targets);
+
+		// relaxation leaves moved and targets holding the interior vertices, pull them back onto the input
+		surface->ClosestPoints(targets, faces, projected);
+		for (unsigned j = 0; j < moved.Size(); ++j)
+			mesh.SetPosition(moved[j], projected[j]);
+	}
+
+	return HalfEdgeMesh_ToTriMesh(mesh);
+}
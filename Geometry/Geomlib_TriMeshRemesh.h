@@ -0,0 +1,44 @@
+//
+// Copyright (c) 2016 - 2017 Mesh Consultants Inc.
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include <Urho3D/Core/Variant.h>
+
+namespace Geomlib {
+
+// Isotropic remeshing after Botsch and Kobbelt, "A Remeshing Approach to Multiresolution Modeling" (2004).
+// Each iteration splits edges longer than (1 + tolerance) * target_length, collapses edges shorter than
+// (1 - tolerance) * target_length, flips edges towards valence 6 (4 on the boundary), relaxes vertices
+// tangentially and projects them back onto the input surface. All edits happen in place on a HalfEdgeMesh.
+// Boundary vertices and edges are left untouched.
+// target_length <= 0 uses the average edge length of the mesh at the start of each iteration.
+// Returns an empty Variant if tri_mesh is not an oriented manifold; callers can fall back to
+// TriMesh_SplitLongEdges and TriMesh_CollapseShortEdges, which accept any mesh.
+Urho3D::Variant TriMesh_Remesh(
+	const Urho3D::Variant& tri_mesh,
+	float target_length,
+	float tolerance,
+	int iterations
+);
+
+}
@@ -23,6 +23,8 @@
 #include "Geomlib_TriMeshSaveOFF.h"
 #include <Urho3D/Core/StringUtils.h>
 
+#include "TriMesh.h"
+
 using Urho3D::File;
 using Urho3D::FileMode;
 using Urho3D::String;
@@ -40,7 +42,7 @@ bool Geomlib::TriMeshWriteOFF(
 		return false;
 	}
 
-	VariantMap meshMap = meshIn.GetVariantMap();
+	VariantMap meshMap = TriMesh_Unpack(meshIn).GetVariantMap();
 	if (meshMap.Keys().Contains("vertices") && meshMap.Keys().Contains("faces"))
 	{
 		VariantVector verts = meshMap["vertices"].GetVariantVector();
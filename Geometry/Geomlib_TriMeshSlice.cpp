@@ -0,0 +1,362 @@
+//
+// Copyright (c) 2016 - 2017 Mesh Consultants Inc.
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "Geomlib_TriMeshSlice.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include <Urho3D/Math/MathDefs.h>
+
+#include <igl/parallel_for.h>
+
+#include "Polyline.h"
+#include "TriMesh.h"
+
+using namespace Urho3D;
+
+namespace {
+
+	// below this many planes contouring stays on the calling thread
+	const unsigned MIN_PARALLEL_PLANES = 4;
+
+	struct SlicePlane
+	{
+		Vector3 normal_;
+		float height_;
+		// faces that may cross the plane, null to test every face of the mesh
+		const int* faces_;
+		unsigned numFaces_;
+	};
+
+	struct SliceContour
+	{
+		PODVector<Vector3> points_;
+		bool closed_;
+	};
+
+	// a face section, running from the edge where the face goes below the plane to the edge where it comes back up
+	struct SliceSegment
+	{
+		long long from_;
+		long long to_;
+		Vector3 start_;
+		Vector3 end_;
+	};
+
+	// planes and the face binning must agree exactly on which side of a plane a vertex lies
+	inline float Height(const Vector3& n, const float* p)
+	{
+		return n.x_ * p[0] + n.y_ * p[1] + n.z_ * p[2];
+	}
+
+	inline long long EdgeKey(int u, int v, unsigned numVertices)
+	{
+		return u < v ? (long long)u * numVertices + v : (long long)v * numVertices + u;
+	}
+
+	// evaluated in index order so both faces on the edge get the identical point
+	Vector3 EdgePoint(const float* positions, int u, int v, float hu, float hv, float d)
+	{
+		if (u > v) {
+			std::swap(u, v);
+			std::swap(hu, hv);
+		}
+		Vector3 pu(positions + 3 * u);
+		Vector3 pv(positions + 3 * v);
+		float t = (d - hu) / (hv - hu);
+		return pu + t * (pv - pu);
+	}
+
+	void AddContourPoint(SliceContour& contour, const Vector3& p)
+	{
+		if (contour.points_.Empty() || (contour.points_.Back() - p).LengthSquared() > M_EPSILON * M_EPSILON) {
+			contour.points_.Push(p);
+		}
+	}
+
+	void ContourPlane(const TriMeshView& mesh, const SlicePlane& plane, Vector<SliceContour>& contours)
+	{
+		const float* positions = mesh.GetPositions();
+		const int* indices = mesh.GetIndices();
+		unsigned numVertices = mesh.GetNumVertices();
+		float d = plane.height_;
+
+		PODVector<SliceSegment> segments;
+		for (unsigned i = 0; i < plane.numFaces_; ++i) {
+			const int* f = indices + 3 * (plane.faces_ ? plane.faces_[i] : i);
+			float h[3];
+			bool above[3];
+			for (int k = 0; k < 3; ++k) {
+				h[k] = Height(plane.normal_, positions + 3 * f[k]);
+				above[k] = h[k] >= d;
+			}
+			if (above[0] == above[1] && above[1] == above[2]) {
+				continue;
+			}
+
+			int up = 0;
+			int down = 0;
+			for (int k = 0; k < 3; ++k) {
+				int next = (k + 1) % 3;
+				if (above[k] != above[next]) {
+					if (above[next]) {
+						up = k;
+					}
+					else {
+						down = k;
+					}
+				}
+			}
+
+			SliceSegment segment;
+			segment.from_ = EdgeKey(f[down], f[(down + 1) % 3], numVertices);
+			segment.to_ = EdgeKey(f[up], f[(up + 1) % 3], numVertices);
+			segment.start_ = EdgePoint(positions, f[down], f[(down + 1) % 3], h[down], h[(down + 1) % 3], d);
+			segment.end_ = EdgePoint(positions, f[up], f[(up + 1) % 3], h[up], h[(up + 1) % 3], d);
+			segments.Push(segment);
+		}
+
+		unsigned numSegments = segments.Size();
+		if (numSegments == 0) {
+			return;
+		}
+
+		// stitch: a segment continues with the one entering through the edge it leaves through
+		std::vector<std::pair<long long, int> > byFrom(numSegments);
+		for (unsigned i = 0; i < numSegments; ++i) {
+			byFrom[i] = std::make_pair(segments[i].from_, (int)i);
+		}
+		std::sort(byFrom.begin(), byFrom.end());
+
+		PODVector<int> next(numSegments);
+		PODVector<bool> hasPrev(numSegments);
+		for (unsigned i = 0; i < numSegments; ++i) {
+			next[i] = -1;
+			hasPrev[i] = false;
+		}
+		for (unsigned i = 0; i < numSegments; ++i) {
+			std::vector<std::pair<long long, int> >::const_iterator it = std::lower_bound(
+				byFrom.begin(), byFrom.end(), std::make_pair(segments[i].to_, -1)
+			);
+			// more than one candidate only happens on non-manifold edges, take the first free one
+			for (; it != byFrom.end() && it->first == segments[i].to_; ++it) {
+				if (!hasPrev[it->second] && it->second != (int)i) {
+					next[i] = it->second;
+					hasPrev[it->second] = true;
+					break;
+				}
+			}
+		}
+
+		// open chains start where no segment leads in, everything left over is a loop
+		PODVector<bool> visited(numSegments);
+		for (unsigned i = 0; i < numSegments; ++i) {
+			visited[i] = false;
+		}
+		for (int pass = 0; pass < 2; ++pass) {
+			for (unsigned i = 0; i < numSegments; ++i) {
+				if (visited[i] || (pass == 0 && hasPrev[i])) {
+					continue;
+				}
+
+				SliceContour contour;
+				int j = (int)i;
+				int last = j;
+				while (j >= 0 && !visited[j]) {
+					visited[j] = true;
+					AddContourPoint(contour, segments[j].start_);
+					last = j;
+					j = next[j];
+				}
+
+				contour.closed_ = j == (int)i;
+				if (contour.closed_) {
+					if (contour.points_.Size() > 1 &&
+						(contour.points_.Back() - contour.points_.Front()).LengthSquared() <= M_EPSILON * M_EPSILON) {
+						contour.points_.Pop();
+					}
+					if (contour.points_.Size() < 3) {
+						continue;
+					}
+					contour.points_.Push(contour.points_.Front());
+				}
+				else {
+					AddContourPoint(contour, segments[last].end_);
+					if (contour.points_.Size() < 2) {
+						continue;
+					}
+				}
+				contours.Push(contour);
+			}
+		}
+	}
+
+	// Bins the faces into the planes of one parallel family, whose indices are sorted by height.
+	// A face crosses plane d when its lowest vertex is below d and its highest is not.
+	void BinFaces(
+		const TriMeshView& mesh,
+		const PODVector<int>& family,
+		Vector<SlicePlane>& planes,
+		PODVector<int>& bins
+	)
+	{
+		const Vector3& normal = planes[family[0]].normal_;
+		const float* positions = mesh.GetPositions();
+		const int* indices = mesh.GetIndices();
+		unsigned numPlanes = family.Size();
+
+		PODVector<float> heights(numPlanes);
+		for (unsigned i = 0; i < numPlanes; ++i) {
+			heights[i] = planes[family[i]].height_;
+		}
+		PODVector<float> vertexHeights(mesh.GetNumVertices());
+		for (unsigned v = 0; v < mesh.GetNumVertices(); ++v) {
+			vertexHeights[v] = Height(normal, positions + 3 * v);
+		}
+
+		// counting pass, then a fill pass into one array
+		PODVector<unsigned> offsets(numPlanes + 1);
+		for (unsigned i = 0; i <= numPlanes; ++i) {
+			offsets[i] = 0;
+		}
+		for (int pass = 0; pass < 2; ++pass) {
+			for (unsigned f = 0; f < mesh.GetNumFaces(); ++f) {
+				float h0 = vertexHeights[indices[3 * f]];
+				float h1 = vertexHeights[indices[3 * f + 1]];
+				float h2 = vertexHeights[indices[3 * f + 2]];
+				float lo = Min(h0, Min(h1, h2));
+				float hi = Max(h0, Max(h1, h2));
+				unsigned first = (unsigned)(std::upper_bound(heights.Begin(), heights.End(), lo) - heights.Begin());
+				unsigned last = (unsigned)(std::upper_bound(heights.Begin() + first, heights.End(), hi) - heights.Begin());
+				for (unsigned p = first; p < last; ++p) {
+					if (pass == 0) {
+						++offsets[p + 1];
+					}
+					else {
+						bins[offsets[p]++] = f;
+					}
+				}
+			}
+			if (pass == 0) {
+				for (unsigned p = 0; p < numPlanes; ++p) {
+					offsets[p + 1] += offsets[p];
+				}
+				bins.Resize(offsets[numPlanes]);
+			}
+		}
+
+		// the fill pass advanced every offset to the start of the next bin
+		unsigned start = 0;
+		for (unsigned p = 0; p < numPlanes; ++p) {
+			SlicePlane& plane = planes[family[p]];
+			plane.faces_ = start < bins.Size() ? &bins[start] : 0;
+			plane.numFaces_ = offsets[p] - start;
+			start = offsets[p];
+		}
+	}
+}
+
+bool Geomlib::TriMesh_Slice(
+	const Variant& tri_mesh,
+	const PODVector<Vector3>& points,
+	const PODVector<Vector3>& normals,
+	VariantVector& contours,
+	PODVector<int>& contour_planes
+)
+{
+	contours.Clear();
+	contour_planes.Clear();
+
+	if (points.Empty() || normals.Empty()) {
+		return false;
+	}
+	TriMeshView mesh(tri_mesh);
+	if (!mesh.IsValid()) {
+		return false;
+	}
+
+	// group the planes into parallel families
+	unsigned numPlanes = points.Size();
+	Vector<SlicePlane> planes(numPlanes);
+	Vector<PODVector<int> > families;
+	for (unsigned i = 0; i < numPlanes; ++i) {
+		SlicePlane& plane = planes[i];
+		plane.normal_ = normals[i % normals.Size()].Normalized();
+		plane.height_ = Height(plane.normal_, points[i].Data());
+		plane.faces_ = 0;
+		plane.numFaces_ = 0;
+		if (plane.normal_ == Vector3::ZERO) {
+			continue;
+		}
+
+		unsigned f = 0;
+		while (f < families.Size() && !(planes[families[f][0]].normal_ == plane.normal_)) {
+			++f;
+		}
+		if (f == families.Size()) {
+			families.Push(PODVector<int>());
+		}
+		families[f].Push(i);
+	}
+
+	// lone planes test every face, families share one binning pass
+	Vector<PODVector<int> > bins(families.Size());
+	for (unsigned f = 0; f < families.Size(); ++f) {
+		PODVector<int>& family = families[f];
+		if (family.Size() == 1) {
+			planes[family[0]].numFaces_ = mesh.GetNumFaces();
+			continue;
+		}
+		std::sort(family.Begin(), family.End(), [&planes](int a, int b) {
+			return planes[a].height_ < planes[b].height_;
+		});
+		BinFaces(mesh, family, planes, bins[f]);
+	}
+
+	Vector<Vector<SliceContour> > planeContours(numPlanes);
+	igl::parallel_for(
+		(int)numPlanes,
+		[&mesh, &planes, &planeContours](int i) {
+			ContourPlane(mesh, planes[i], planeContours[i]);
+		},
+		MIN_PARALLEL_PLANES
+	);
+
+	for (unsigned i = 0; i < numPlanes; ++i) {
+		for (unsigned j = 0; j < planeContours[i].Size(); ++j) {
+			const PODVector<Vector3>& contourPoints = planeContours[i][j].points_;
+			Vector<Vector3> vertexList(contourPoints.Size());
+			for (unsigned k = 0; k < contourPoints.Size(); ++k) {
+				vertexList[k] = contourPoints[k];
+			}
+			Variant polyline = Polyline_Make(vertexList);
+			if (polyline.GetType() == VAR_VARIANTMAP) {
+				contours.Push(polyline);
+				contour_planes.Push(i);
+			}
+		}
+	}
+
+	return true;
+}
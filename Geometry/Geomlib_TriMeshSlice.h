@@ -0,0 +1,49 @@
+//
+// Copyright (c) 2016 - 2017 Mesh Consultants Inc.
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include <Urho3D/Container/Vector.h>
+#include <Urho3D/Core/Variant.h>
+#include <Urho3D/Math/Vector3.h>
+
+namespace Geomlib {
+
+// Intersects tri_mesh with many planes at once and returns the contour polylines.
+// Plane i passes through points[i] with normal normals[i]; if normals holds fewer entries than points
+// the list is cycled, so a single normal slices along a family of parallel planes.
+// Planes sharing a normal are handled together: every face is binned into the planes crossing its
+// height interval once, after which the planes are contoured in parallel. Segments are chained through
+// the mesh edges they cross, so closed sections come out as closed polylines, and contours run
+// counter-clockwise about the normal on outward facing meshes.
+// Outputs
+//   contours: one polyline per contour, grouped by plane in input order
+//   contour_planes: index of the plane each contour lies in
+bool TriMesh_Slice(
+	const Urho3D::Variant& tri_mesh,
+	const Urho3D::PODVector<Urho3D::Vector3>& points,
+	const Urho3D::PODVector<Urho3D::Vector3>& normals,
+	Urho3D::VariantVector& contours,
+	Urho3D::PODVector<int>& contour_planes
+);
+
+}
@@ -552,6 +552,6 @@ bool Geomlib::TriMeshSubdivide(
 
 	Eigen::MatrixXf NV = IglDoubleToFloat(NVd);
 
-	meshOut = TriMesh_Make(NV, NF);
+	meshOut = TriMesh_MakePacked(NV, NF);
 	return true;
 }
@@ -56,9 +56,8 @@ bool Geomlib::TriMeshThicken(
 		meshOut = Variant();
 		return false;
 	}
-	VariantMap meshMap = meshIn.GetVariantMap();
-	const VariantVector vertexList = meshMap["vertices"].GetVariantVector();
-	const VariantVector faceList = meshMap["faces"].GetVariantVector();
+	const VariantVector vertexList = TriMesh_GetVertexList(meshIn);
+	const VariantVector faceList = TriMesh_GetFaceList(meshIn);
 
 	// Compute vertices for outer part of solid, using unit normals
 	VariantVector vertNormals = TriMesh_ComputeVertexNormals(meshIn, true);
@@ -22,10 +22,641 @@
 
 #include "Geomlib_TriTriIntersection.h"
 
-#include <assert.h>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include <Urho3D/Math/MathDefs.h>
+#include <Urho3D/Math/Vector2.h>
+
+#include <igl/parallel_for.h>
+
+#include "Geomlib_TriMeshBVH.h"
+#include "Polyline.h"
+#include "TriMesh.h"
+
+using namespace Urho3D;
 
 namespace {
 
+	// below this many candidate face pairs the narrow phase stays on the calling thread
+	const int MIN_PARALLEL_FACE_PAIRS = 1000;
+	// below this many points their positions are computed on the calling thread
+	const int MIN_PARALLEL_POINTS = 5000;
+
+	// Exact sum of doubles, held as a nonoverlapping expansion of increasing magnitude
+	// (Shewchuk, Adaptive Precision Floating-Point Arithmetic and Fast Robust Geometric Predicates).
+	class Expansion
+	{
+	public:
+		Expansion() :
+			size_(0)
+		{
+		}
+
+		void Add(double b)
+		{
+			double q = b;
+			unsigned m = 0;
+			for (unsigned i = 0; i < size_; ++i) {
+				double sum = q + components_[i];
+				double bVirtual = sum - q;
+				double aVirtual = sum - bVirtual;
+				double error = (q - aVirtual) + (components_[i] - bVirtual);
+				q = sum;
+				if (error != 0.0) {
+					components_[m++] = error;
+				}
+			}
+			if (q != 0.0) {
+				components_[m++] = q;
+			}
+			size_ = m;
+		}
+
+		// adds the exact product of three floats
+		void AddProduct(float a, float b, float c, bool negate)
+		{
+			// two floats multiply exactly in double, the third factor leaves a rounding error fma recovers
+			double ab = (double)a * (double)b;
+			double product = ab * (double)c;
+			double error = std::fma(ab, (double)c, -product);
+			Add(negate ? -product : product);
+			Add(negate ? -error : error);
+		}
+
+		int Sign() const
+		{
+			if (size_ == 0) {
+				return 0;
+			}
+			return components_[size_ - 1] > 0.0 ? 1 : -1;
+		}
+
+	private:
+		// a 4x4 minor sums 24 products of two parts each
+		double components_[48];
+		unsigned size_;
+	};
+
+	// Term of the Simulation of Simplicity expansion of a 4x4 orientation determinant
+	// (Edelsbrunner and Muecke, Simulation of Simplicity). Coordinate c of row r is perturbed by
+	// eps^(2^(3r + 2 - c)); the term is the minor left after taking the perturbed entries (rows_[i], cols_[i]).
+	struct PerturbationTerm
+	{
+		unsigned exponent_;
+		unsigned count_;
+		unsigned rows_[3];
+		unsigned cols_[3];
+		int sign_;
+
+		bool operator<(const PerturbationTerm& rhs) const { return exponent_ < rhs.exponent_; }
+	};
+
+	// all terms with a nonzero coefficient, most significant first
+	std::vector<PerturbationTerm> MakePerturbationTerms()
+	{
+		std::vector<PerturbationTerm> terms;
+		// each row takes either no perturbed entry or the one in column choice - 1
+		for (unsigned code = 0; code < 4 * 4 * 4 * 4; ++code) {
+			PerturbationTerm term;
+			term.exponent_ = 0;
+			term.count_ = 0;
+			unsigned usedCols = 0;
+			bool valid = true;
+			for (unsigned r = 0; r < 4; ++r) {
+				unsigned choice = (code >> (2 * r)) & 3;
+				if (choice == 0) {
+					continue;
+				}
+				unsigned c = choice - 1;
+				if (usedCols & (1 << c)) {
+					valid = false;
+					break;
+				}
+				usedCols |= 1 << c;
+				term.rows_[term.count_] = r;
+				term.cols_[term.count_] = c;
+				++term.count_;
+				term.exponent_ += 1 << (3 * r + 2 - c);
+			}
+			if (!valid) {
+				continue;
+			}
+
+			// generalized Laplace expansion: (-1)^(sum of rows and columns) times the sign of the row to column matching
+			int sign = 1;
+			for (unsigned i = 0; i < term.count_; ++i) {
+				if ((term.rows_[i] + term.cols_[i]) & 1) {
+					sign = -sign;
+				}
+				for (unsigned j = i + 1; j < term.count_; ++j) {
+					if (term.cols_[j] < term.cols_[i]) {
+						sign = -sign;
+					}
+				}
+			}
+			term.sign_ = sign;
+			terms.push_back(term);
+		}
+		std::sort(terms.begin(), terms.end());
+		return terms;
+	}
+
+	// Exact sign of the minor of [p 1], rows p[0..3] and columns x, y, z, 1, left after removing the masked rows and columns
+	int MinorSign(const Vector3* const* p, unsigned rowMask, unsigned colMask)
+	{
+		unsigned rows[4], cols[4];
+		unsigned size = 0;
+		for (unsigned r = 0; r < 4; ++r) {
+			if (!(rowMask & (1 << r))) {
+				rows[size++] = r;
+			}
+		}
+		size = 0;
+		for (unsigned c = 0; c < 4; ++c) {
+			if (!(colMask & (1 << c))) {
+				cols[size++] = c;
+			}
+		}
+
+		// Leibniz expansion; the column of ones is never removed, so every product holds at most three coordinates
+		unsigned perm[4] = { 0, 1, 2, 3 };
+		Expansion sum;
+		do {
+			unsigned inversions = 0;
+			for (unsigned i = 0; i < size; ++i) {
+				for (unsigned j = i + 1; j < size; ++j) {
+					if (perm[j] < perm[i]) {
+						++inversions;
+					}
+				}
+			}
+			float factors[3] = { 1.0f, 1.0f, 1.0f };
+			unsigned numFactors = 0;
+			for (unsigned i = 0; i < size; ++i) {
+				unsigned c = cols[perm[i]];
+				if (c < 3) {
+					factors[numFactors++] = p[rows[i]]->Data()[c];
+				}
+			}
+			sum.AddProduct(factors[0], factors[1], factors[2], (inversions & 1) != 0);
+		} while (std::next_permutation(perm, perm + size));
+
+		return sum.Sign();
+	}
+
+	// Sign of det[p 1] with the rows perturbed symbolically, never zero for four distinct points
+	int PerturbedOrientation(const Vector3* const* p)
+	{
+		static const std::vector<PerturbationTerm> terms = MakePerturbationTerms();
+
+		// the leading term is the determinant itself, which is minus Orient3D
+		int sign = -Geomlib::Orient3D(*p[0], *p[1], *p[2], *p[3]);
+		for (unsigned t = 1; sign == 0 && t < terms.size(); ++t) {
+			const PerturbationTerm& term = terms[t];
+			unsigned rowMask = 0;
+			unsigned colMask = 0;
+			for (unsigned i = 0; i < term.count_; ++i) {
+				rowMask |= 1 << term.rows_[i];
+				colMask |= 1 << term.cols_[i];
+			}
+			sign = term.sign_ * MinorSign(p, rowMask, colMask);
+		}
+		return sign;
+	}
+
+	struct IntersectionKey
+	{
+		int edgeMesh_;
+		int edgeStart_;
+		int edgeEnd_;
+		int face_;
+
+		bool operator<(const IntersectionKey& rhs) const
+		{
+			if (edgeMesh_ != rhs.edgeMesh_) return edgeMesh_ < rhs.edgeMesh_;
+			if (edgeStart_ != rhs.edgeStart_) return edgeStart_ < rhs.edgeStart_;
+			if (edgeEnd_ != rhs.edgeEnd_) return edgeEnd_ < rhs.edgeEnd_;
+			return face_ < rhs.face_;
+		}
+		bool operator==(const IntersectionKey& rhs) const
+		{
+			return edgeMesh_ == rhs.edgeMesh_ && edgeStart_ == rhs.edgeStart_ && edgeEnd_ == rhs.edgeEnd_ && face_ == rhs.face_;
+		}
+	};
+
+	struct FacePairResult
+	{
+		IntersectionKey keys_[2];
+		bool crosses_;
+	};
+
+	// Two meshes with their vertices under one numbering, the second mesh's following the first's
+	class MeshPair
+	{
+	public:
+		MeshPair(
+			const float* positionsA,
+			unsigned numVerticesA,
+			const int* indicesA,
+			const float* positionsB,
+			unsigned numVerticesB,
+			const int* indicesB
+		) :
+			numVerticesA_(numVerticesA)
+		{
+			vertices_.Resize(numVerticesA + numVerticesB);
+			for (unsigned i = 0; i < numVerticesA; ++i) {
+				vertices_[i] = Vector3(positionsA + 3 * i);
+			}
+			for (unsigned i = 0; i < numVerticesB; ++i) {
+				vertices_[numVerticesA + i] = Vector3(positionsB + 3 * i);
+			}
+			indices_[0] = indicesA;
+			indices_[1] = indicesB;
+		}
+
+		bool IntersectFaces(int faceA, int faceB, FacePairResult& result) const
+		{
+			int a[3], b[3];
+			GetFace(0, faceA, a);
+			GetFace(1, faceB, b);
+			if (a[0] == a[1] || a[1] == a[2] || a[2] == a[0] || b[0] == b[1] || b[1] == b[2] || b[2] == b[0]) {
+				return false;
+			}
+
+			int signsA[3], signsB[3];
+			for (unsigned i = 0; i < 3; ++i) {
+				signsA[i] = Orient(b[0], b[1], b[2], a[i]);
+			}
+			if (signsA[0] == signsA[1] && signsA[1] == signsA[2]) {
+				return false;
+			}
+			for (unsigned i = 0; i < 3; ++i) {
+				signsB[i] = Orient(a[0], a[1], a[2], b[i]);
+			}
+			if (signsB[0] == signsB[1] && signsB[1] == signsB[2]) {
+				return false;
+			}
+
+			// the segment runs between the edges of either face that pass through the other face
+			unsigned found = 0;
+			for (unsigned i = 0; i < 3; ++i) {
+				unsigned j = (i + 1) % 3;
+				if (signsA[i] != signsA[j] && EdgeCrossesFace(a[i], a[j], b)) {
+					if (found < 2) {
+						result.keys_[found] = MakeKey(0, a[i], a[j], faceB);
+					}
+					++found;
+				}
+				if (signsB[i] != signsB[j] && EdgeCrossesFace(b[i], b[j], a)) {
+					if (found < 2) {
+						result.keys_[found] = MakeKey(1, b[i], b[j], faceA);
+					}
+					++found;
+				}
+			}
+			return found == 2;
+		}
+
+		Vector3 GetPosition(const IntersectionKey& key) const
+		{
+			unsigned offset = key.edgeMesh_ == 0 ? 0 : numVerticesA_;
+			const Vector3& p = vertices_[offset + key.edgeStart_];
+			const Vector3& q = vertices_[offset + key.edgeEnd_];
+			int t[3];
+			GetFace(1 - key.edgeMesh_, key.face_, t);
+
+			// edge against the face's plane, in double so that near-parallel edges stay put
+			double e1[3], e2[3], n[3], dp = 0.0, dq = 0.0;
+			for (unsigned i = 0; i < 3; ++i) {
+				e1[i] = (double)vertices_[t[1]].Data()[i] - vertices_[t[0]].Data()[i];
+				e2[i] = (double)vertices_[t[2]].Data()[i] - vertices_[t[0]].Data()[i];
+			}
+			n[0] = e1[1] * e2[2] - e1[2] * e2[1];
+			n[1] = e1[2] * e2[0] - e1[0] * e2[2];
+			n[2] = e1[0] * e2[1] - e1[1] * e2[0];
+			for (unsigned i = 0; i < 3; ++i) {
+				dp += n[i] * ((double)p.Data()[i] - vertices_[t[0]].Data()[i]);
+				dq += n[i] * ((double)q.Data()[i] - vertices_[t[0]].Data()[i]);
+			}
+			double s = dp != dq ? dp / (dp - dq) : 0.5;
+			if (Geomlib::Orient3D(vertices_[t[0]], vertices_[t[1]], vertices_[t[2]], p) == 0 &&
+				Geomlib::Orient3D(vertices_[t[0]], vertices_[t[1]], vertices_[t[2]], q) == 0)
+			{
+				// the edge lies in the face's plane and only crosses it under the perturbation,
+				// so take the middle of the part of the edge that is over the face
+				s = CoplanarEdgeMiddle(p, q, t, n);
+			}
+			s = Clamp(s, 0.0, 1.0);
+
+			return Vector3(
+				(float)(p.x_ + ((double)q.x_ - p.x_) * s),
+				(float)(p.y_ + ((double)q.y_ - p.y_) * s),
+				(float)(p.z_ + ((double)q.z_ - p.z_) * s)
+			);
+		}
+
+	private:
+		// parameter of the middle of the part of edge pq inside face t, both lying in the plane with normal n
+		double CoplanarEdgeMiddle(const Vector3& p, const Vector3& q, const int* t, const double* n) const
+		{
+			unsigned axis = 0;
+			if (std::abs(n[1]) > std::abs(n[axis])) {
+				axis = 1;
+			}
+			if (std::abs(n[2]) > std::abs(n[axis])) {
+				axis = 2;
+			}
+			unsigned u = (axis + 1) % 3;
+			unsigned v = (axis + 2) % 3;
+			double side = n[axis] > 0.0 ? 1.0 : -1.0;
+
+			double begin = 0.0;
+			double end = 1.0;
+			for (unsigned i = 0; i < 3; ++i) {
+				const float* a = vertices_[t[i]].Data();
+				const float* b = vertices_[t[(i + 1) % 3]].Data();
+				double eu = (double)b[u] - a[u];
+				double ev = (double)b[v] - a[v];
+				double fp = side * (eu * ((double)p.Data()[v] - a[v]) - ev * ((double)p.Data()[u] - a[u]));
+				double fq = side * (eu * ((double)q.Data()[v] - a[v]) - ev * ((double)q.Data()[u] - a[u]));
+				if (fp < 0.0 && fq < 0.0) {
+					return 0.5;
+				}
+				if (fp < 0.0) {
+					begin = Max(begin, fp / (fp - fq));
+				}
+				else if (fq < 0.0) {
+					end = Min(end, fp / (fp - fq));
+				}
+			}
+			return begin <= end ? 0.5 * (begin + end) : 0.5;
+		}
+
+		void GetFace(int mesh, int face, int* vertices) const
+		{
+			unsigned offset = mesh == 0 ? 0 : numVerticesA_;
+			for (unsigned i = 0; i < 3; ++i) {
+				vertices[i] = offset + indices_[mesh][3 * face + i];
+			}
+		}
+
+		IntersectionKey MakeKey(int mesh, int start, int end, int face) const
+		{
+			unsigned offset = mesh == 0 ? 0 : numVerticesA_;
+			IntersectionKey key;
+			key.edgeMesh_ = mesh;
+			key.edgeStart_ = Min(start, end) - offset;
+			key.edgeEnd_ = Max(start, end) - offset;
+			key.face_ = face;
+			return key;
+		}
+
+		// Orientation of four vertices by index, perturbed symbolically in index order so that it is never zero
+		// and every face pair asking about the same four vertices gets the same answer
+		int Orient(int i, int j, int k, int l) const
+		{
+			int ids[4] = { i, j, k, l };
+			bool odd = false;
+			for (unsigned pass = 0; pass < 3; ++pass) {
+				for (unsigned m = 0; m + 1 < 4 - pass; ++m) {
+					if (ids[m] > ids[m + 1]) {
+						std::swap(ids[m], ids[m + 1]);
+						odd = !odd;
+					}
+				}
+			}
+
+			const Vector3* p[4] = { &vertices_[ids[0]], &vertices_[ids[1]], &vertices_[ids[2]], &vertices_[ids[3]] };
+			// det[p 1] and Orient3D have opposite signs
+			int sign = -PerturbedOrientation(p);
+			return odd ? -sign : sign;
+		}
+
+		// whether edge pq, whose ends lie on opposite sides of face t, passes through it
+		bool EdgeCrossesFace(int p, int q, const int* t) const
+		{
+			if (p > q) {
+				std::swap(p, q);
+			}
+			int s0 = Orient(p, q, t[0], t[1]);
+			int s1 = Orient(p, q, t[1], t[2]);
+			int s2 = Orient(p, q, t[2], t[0]);
+			return s0 == s1 && s1 == s2;
+		}
+
+		PODVector<Vector3> vertices_;
+		const int* indices_[2];
+		unsigned numVerticesA_;
+	};
 
 } // namespace
 
+int Geomlib::Orient3D(const Vector3& a, const Vector3& b, const Vector3& c, const Vector3& d)
+{
+	// Shewchuk's orient3d filter, which computes the opposite sign
+	double adx = (double)a.x_ - d.x_;
+	double bdx = (double)b.x_ - d.x_;
+	double cdx = (double)c.x_ - d.x_;
+	double ady = (double)a.y_ - d.y_;
+	double bdy = (double)b.y_ - d.y_;
+	double cdy = (double)c.y_ - d.y_;
+	double adz = (double)a.z_ - d.z_;
+	double bdz = (double)b.z_ - d.z_;
+	double cdz = (double)c.z_ - d.z_;
+
+	double bdxcdy = bdx * cdy;
+	double cdxbdy = cdx * bdy;
+	double cdxady = cdx * ady;
+	double adxcdy = adx * cdy;
+	double adxbdy = adx * bdy;
+	double bdxady = bdx * ady;
+
+	double det = adz * (bdxcdy - cdxbdy) + bdz * (cdxady - adxcdy) + cdz * (adxbdy - bdxady);
+	double permanent =
+		(std::abs(bdxcdy) + std::abs(cdxbdy)) * std::abs(adz) +
+		(std::abs(cdxady) + std::abs(adxcdy)) * std::abs(bdz) +
+		(std::abs(adxbdy) + std::abs(bdxady)) * std::abs(cdz);
+	const double epsilon = 1.1102230246251565e-16;
+	const double errorBound = (7.0 + 56.0 * epsilon) * epsilon;
+	if (det > errorBound * permanent) {
+		return -1;
+	}
+	if (-det > errorBound * permanent) {
+		return 1;
+	}
+
+	// exact det[a 1; b 1; c 1; d 1], again with the opposite sign
+	const Vector3* p[4] = { &a, &b, &c, &d };
+	return -MinorSign(p, 0, 0);
+}
+
+bool Geomlib::TriTriIntersection(
+	const Vector3& p0,
+	const Vector3& p1,
+	const Vector3& p2,
+	const Vector3& q0,
+	const Vector3& q1,
+	const Vector3& q2,
+	Vector3& s0,
+	Vector3& s1
+)
+{
+	const Vector3 positionsA[] = { p0, p1, p2 };
+	const Vector3 positionsB[] = { q0, q1, q2 };
+	const int indices[] = { 0, 1, 2 };
+	MeshPair pair(positionsA[0].Data(), 3, indices, positionsB[0].Data(), 3, indices);
+
+	FacePairResult result;
+	if (!pair.IntersectFaces(0, 0, result)) {
+		return false;
+	}
+
+	s0 = pair.GetPosition(result.keys_[0]);
+	s1 = pair.GetPosition(result.keys_[1]);
+	return true;
+}
+
+bool Geomlib::TriMeshIntersection(
+	const Variant& meshA,
+	const Variant& meshB,
+	PODVector<MeshIntersectionPoint>& points,
+	PODVector<MeshIntersectionSegment>& segments
+)
+{
+	points.Clear();
+	segments.Clear();
+
+	std::shared_ptr<const TriMeshBVH> bvhA = TriMeshBVH::Get(meshA);
+	std::shared_ptr<const TriMeshBVH> bvhB = TriMeshBVH::Get(meshB);
+	if (!bvhA || !bvhB) {
+		return false;
+	}
+
+	TriMeshView viewA(meshA);
+	TriMeshView viewB(meshB);
+	MeshPair pair(
+		viewA.GetPositions(),
+		viewA.GetNumVertices(),
+		viewA.GetIndices(),
+		viewB.GetPositions(),
+		viewB.GetNumVertices(),
+		viewB.GetIndices()
+	);
+
+	PODVector<IntVector2> candidates;
+	bvhA->OverlappingFaces(*bvhB, candidates);
+
+	std::vector<FacePairResult> results(candidates.Size());
+	igl::parallel_for(
+		(int)candidates.Size(),
+		[&pair, &candidates, &results](int i) {
+			results[i].crosses_ = pair.IntersectFaces(candidates[i].x_, candidates[i].y_, results[i]);
+		},
+		MIN_PARALLEL_FACE_PAIRS
+	);
+
+	// each point is named by its edge and face, so the face pairs around it all find the same one
+	std::vector<IntersectionKey> keys;
+	for (unsigned i = 0; i < results.size(); ++i) {
+		if (results[i].crosses_) {
+			keys.push_back(results[i].keys_[0]);
+			keys.push_back(results[i].keys_[1]);
+		}
+	}
+	std::sort(keys.begin(), keys.end());
+	keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+	points.Resize(keys.size());
+	igl::parallel_for(
+		(int)keys.size(),
+		[&pair, &keys, &points](int i) {
+			MeshIntersectionPoint& point = points[i];
+			point.edgeMesh_ = keys[i].edgeMesh_;
+			point.edgeStart_ = keys[i].edgeStart_;
+			point.edgeEnd_ = keys[i].edgeEnd_;
+			point.face_ = keys[i].face_;
+			point.position_ = pair.GetPosition(keys[i]);
+		},
+		MIN_PARALLEL_POINTS
+	);
+
+	for (unsigned i = 0; i < results.size(); ++i) {
+		if (!results[i].crosses_) {
+			continue;
+		}
+		MeshIntersectionSegment segment;
+		segment.faceA_ = candidates[i].x_;
+		segment.faceB_ = candidates[i].y_;
+		segment.start_ = (int)(std::lower_bound(keys.begin(), keys.end(), results[i].keys_[0]) - keys.begin());
+		segment.end_ = (int)(std::lower_bound(keys.begin(), keys.end(), results[i].keys_[1]) - keys.begin());
+		segments.Push(segment);
+	}
+
+	return true;
+}
+
+bool Geomlib::TriMeshIntersectionPolylines(
+	const Variant& meshA,
+	const Variant& meshB,
+	VariantVector& polylines
+)
+{
+	polylines.Clear();
+
+	PODVector<MeshIntersectionPoint> points;
+	PODVector<MeshIntersectionSegment> segments;
+	if (!TriMeshIntersection(meshA, meshB, points, segments)) {
+		return false;
+	}
+
+	Vector<PODVector<int> > incident(points.Size());
+	for (unsigned i = 0; i < segments.Size(); ++i) {
+		incident[segments[i].start_].Push(i);
+		incident[segments[i].end_].Push(i);
+	}
+
+	// chains run through points with two segments and end anywhere else;
+	// open chains are traced from their ends first, then the closed loops that are left
+	PODVector<bool> used(segments.Size());
+	for (unsigned i = 0; i < used.Size(); ++i) {
+		used[i] = false;
+	}
+	for (unsigned pass = 0; pass < 2; ++pass) {
+		for (unsigned p = 0; p < points.Size(); ++p) {
+			if (pass == 0 && incident[p].Size() == 2) {
+				continue;
+			}
+			for (unsigned k = 0; k < incident[p].Size(); ++k) {
+				int segment = incident[p][k];
+				if (used[segment]) {
+					continue;
+				}
+
+				Vector<Vector3> vertexList;
+				vertexList.Push(points[p].position_);
+				int current = p;
+				while (segment >= 0) {
+					used[segment] = true;
+					current = segments[segment].start_ == current ? segments[segment].end_ : segments[segment].start_;
+					vertexList.Push(points[current].position_);
+
+					segment = -1;
+					if (incident[current].Size() == 2) {
+						for (unsigned m = 0; m < 2; ++m) {
+							if (!used[incident[current][m]]) {
+								segment = incident[current][m];
+							}
+						}
+					}
+				}
+				polylines.Push(Polyline_Make(vertexList));
+			}
+		}
+	}
+
+	return true;
+}
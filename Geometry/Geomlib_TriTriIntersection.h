@@ -22,10 +22,82 @@
 
 #pragma once
 
+#include <Urho3D/Container/Vector.h>
 #include <Urho3D/Core/Variant.h>
 #include <Urho3D/Math/Vector3.h>
 
 namespace Geomlib {
 
+	// Sign of the orientation of d relative to the plane through a, b, c:
+	// 1 when d is on the side (b - a) x (c - a) points to, -1 on the other side, 0 when coplanar.
+	// Evaluated in floating point, with an exact fallback when the result is too close to zero to trust.
+	int Orient3D(
+		const Urho3D::Vector3& a,
+		const Urho3D::Vector3& b,
+		const Urho3D::Vector3& c,
+		const Urho3D::Vector3& d
+	);
 
-} // namespace Geomlib
\ No newline at end of file
+	// Inputs
+	//   p0, p1, p2: first triangle
+	//   q0, q1, q2: second triangle
+	// Outputs
+	//   s0, s1: endpoints of the segment the triangles cross along
+	// Returns false when the triangles do not cross; coplanar triangles never do.
+	bool TriTriIntersection(
+		const Urho3D::Vector3& p0,
+		const Urho3D::Vector3& p1,
+		const Urho3D::Vector3& p2,
+		const Urho3D::Vector3& q0,
+		const Urho3D::Vector3& q1,
+		const Urho3D::Vector3& q2,
+		Urho3D::Vector3& s0,
+		Urho3D::Vector3& s1
+	);
+
+	// Point where an edge of one mesh passes through a face of the other
+	struct MeshIntersectionPoint
+	{
+		// 0 when the edge belongs to the first mesh, 1 when it belongs to the second
+		int edgeMesh_;
+		// vertex indices of the edge, lower first
+		int edgeStart_;
+		int edgeEnd_;
+		// face of the other mesh
+		int face_;
+		Urho3D::Vector3 position_;
+	};
+
+	// Piece of intersection curve where a face of the first mesh crosses a face of the second
+	struct MeshIntersectionSegment
+	{
+		int faceA_;
+		int faceB_;
+		// indices into the intersection points
+		int start_;
+		int end_;
+	};
+
+	// Finds where two TriMeshes cross.
+	// Candidate face pairs come from the meshes' TriMeshBVHs and are tested in parallel.
+	// All decisions are made with exact orientation signs, and exact ties are broken by vertex index,
+	// so neighbouring face pairs always agree on where a curve passes and the segments join up.
+	// Every point is shared by all segments through it.
+	bool TriMeshIntersection(
+		const Urho3D::Variant& meshA,
+		const Urho3D::Variant& meshB,
+		Urho3D::PODVector<MeshIntersectionPoint>& points,
+		Urho3D::PODVector<MeshIntersectionSegment>& segments
+	);
+
+	// Inputs
+	//   meshA, meshB: TriMeshes
+	// Outputs
+	//   polylines: intersection curves, closed ones repeat their first vertex
+	bool TriMeshIntersectionPolylines(
+		const Urho3D::Variant& meshA,
+		const Urho3D::Variant& meshB,
+		Urho3D::VariantVector& polylines
+	);
+
+} // namespace Geomlib
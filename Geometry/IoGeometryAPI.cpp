@@ -15,11 +15,12 @@
 #include "Geomlib_HausdorffDistance.h"
 #include "Geomlib_Incenter.h"
 #include "Geomlib_JoinMeshes.h"
+#include "Geomlib_MeshBoolean.h"
 #include "Geomlib_MeshTetrahedralize.h"
 #include "Geomlib_PolylineBlend.h"
 #include "Geomlib_PolylineDivide.h"
 #include "Geomlib_PolylineExtrude.h"
-//TODO: #include "Geomlib_PolylineIntersection.h" --- currently there is no function here
+#include "Geomlib_PolylineIntersection.h"
 #include "Geomlib_PolylineLoft.h"
 #include "Geomlib_PolylineOffset.h"
 #include "Geomlib_PolylinePointFromParameter.h"
@@ -41,6 +42,7 @@
 #include "Geomlib_TransformVertexList.h"
 #include "Geomlib_TriangulatePolygon.h"
 #include "Geomlib_TriMeshAverageEdgeLength.h"
+#include "Geomlib_TriMeshBVH.h"
 #include "Geomlib_TriMeshClosestPoint.h"
 #include "Geomlib_TriMeshEdgeCollapse.h"
 #include "Geomlib_TriMeshEdgeSplit.h"
@@ -55,7 +57,7 @@
 #include "Geomlib_TriMeshThicken.h"
 #include "Geomlib_TriMeshVolume.h"
 #include "Geomlib_TriMeshWindow.h"
-//TODO: #include "Geomlib_TriTriIntersection.h" --- currently there is no function here
+#include "Geomlib_TriTriIntersection.h"
 #include "Geomlib_WriteOBJ.h"
 #include "Geomlib_WriteOFF.h"
 #include "Geomlib_WritePLY.h"
@@ -127,7 +129,7 @@ void WriteDxf(
 
 		//only support triangle meshes right now
 		if (TriMesh_Verify((*mMap))) {
-			dWriter->SetMesh((*mMap)["vertices"].GetVariantVector(), (*mMap)["faces"].GetVariantVector(), layer);
+			dWriter->SetMesh(TriMesh_GetVertexList(*mMap), TriMesh_GetFaceList(*mMap), layer);
 		}
 		else if (NMesh_Verify((*mMap))) {
 			Variant triMesh = NMesh_ConvertToTriMesh(*mMap);
@@ -245,6 +247,19 @@ Urho3D::Variant JoinMeshes(Urho3D::CScriptArray* mesh_list_arr)
 	return Geomlib::JoinMeshes(meshlist);
 }
 
+bool MeshBoolean(
+	const Urho3D::Variant& meshA,
+	const Urho3D::Variant& meshB,
+	int operation,
+	Urho3D::Variant& meshOut
+)
+{
+	if (operation < Geomlib::MESH_UNION || operation > Geomlib::MESH_DIFFERENCE) {
+		return false;
+	}
+	return Geomlib::MeshBoolean(meshA, meshB, (Geomlib::MeshBooleanOperation)operation, meshOut);
+}
+
 bool MeshTetrahedralize(
 	const Urho3D::Variant& meshIn,
 	float maxVolume,
@@ -290,6 +305,23 @@ bool PolylineLoft(
 	return Geomlib::PolylineLoft(polylines, mesh);
 }
 
+Urho3D::CScriptArray* PolylineSplitAtCrossings(
+	Urho3D::CScriptArray* polylines_arr,
+	float tolerance
+)
+{
+	Vector<Variant> polylines = ArrayToVector<Variant>(polylines_arr);
+
+	PODVector<Geomlib::PolylineIntersection> intersections;
+	Geomlib::PolylineIntersections(polylines, tolerance, &Matrix3x4::IDENTITY, true, intersections);
+
+	Vector<Variant> pieces;
+	PODVector<int> sources;
+	Geomlib::PolylineSplitAtIntersections(polylines, intersections, pieces, sources);
+
+	return Urho3D::VectorToArray<Variant>(pieces, "Array<Variant>");
+}
+
 bool PolylineOffset(
 	const Urho3D::Variant& polyIn,
 	Urho3D::Variant& polyOut,
@@ -515,6 +547,22 @@ bool TriMeshClosestPoint(
 	return Geomlib::TriMeshClosestPoint(mesh, q, index, p);
 }
 
+bool TriMeshRaycast(
+	const Urho3D::Variant& mesh,
+	const Urho3D::Vector3& O,
+	const Urho3D::Vector3& D,
+	int& index,
+	float& s
+)
+{
+	return Geomlib::TriMeshRaycast(mesh, O, D, index, s);
+}
+
+Urho3D::Variant TriMesh_AttachBVH(const Urho3D::Variant& mesh)
+{
+	return Geomlib::TriMesh_AttachBVH(mesh);
+}
+
 Urho3D::Variant TriMesh_CollapseShortEdges(
 	const Urho3D::Variant& tri_mesh,
 	float collapse_threshold
@@ -633,6 +681,30 @@ bool TriMeshWindow(
 	return Geomlib::TriMeshWindow(meshIn, t, meshOut);
 }
 
+Urho3D::CScriptArray* TriMeshIntersection(
+	const Urho3D::Variant& meshA,
+	const Urho3D::Variant& meshB
+)
+{
+	Vector<Variant> polylines;
+	Geomlib::TriMeshIntersectionPolylines(meshA, meshB, polylines);
+	return Urho3D::VectorToArray<Variant>(polylines, "Array<Variant>");
+}
+
+bool TriTriIntersection(
+	const Urho3D::Vector3& p0,
+	const Urho3D::Vector3& p1,
+	const Urho3D::Vector3& p2,
+	const Urho3D::Vector3& q0,
+	const Urho3D::Vector3& q1,
+	const Urho3D::Vector3& q2,
+	Urho3D::Vector3& start,
+	Urho3D::Vector3& end
+)
+{
+	return Geomlib::TriTriIntersection(p0, p1, p2, q0, q1, q2, start, end);
+}
+
 bool WriteOBJ(
 	const Urho3D::String& obj_filename,
 	const Urho3D::Variant& tri_mesh,
@@ -752,6 +824,13 @@ void RegisterGeometryFunctions(Urho3D::Context* context)
 	);
 	CHECK_GEO_REG(res)
 
+	res = engine->RegisterGlobalFunction(
+		"bool MeshBoolean(const Variant&, const Variant&, int, Variant&)",
+		asFUNCTION(MeshBoolean),
+		asCALL_CDECL
+	);
+	CHECK_GEO_REG(res)
+
 	res = engine->RegisterGlobalFunction(
 		"bool MeshTetrahedralize(const Variant&, float, Variant&)",
 		asFUNCTION(MeshTetrahedralize),
@@ -787,6 +866,13 @@ void RegisterGeometryFunctions(Urho3D::Context* context)
 	);
 	CHECK_GEO_REG(res)
 
+	res = engine->RegisterGlobalFunction(
+		"Array<Variant>@ PolylineSplitAtCrossings(Array<Variant>@, float)",
+		asFUNCTION(PolylineSplitAtCrossings),
+		asCALL_CDECL
+	);
+	CHECK_GEO_REG(res)
+
 	res = engine->RegisterGlobalFunction(
 		"bool PolylineOffset(const Variant&, Variant&, float)",
 		asFUNCTION(PolylineOffset),
@@ -953,6 +1039,20 @@ void RegisterGeometryFunctions(Urho3D::Context* context)
 	);
 	CHECK_GEO_REG(res);
 
+	res = engine->RegisterGlobalFunction(
+		"bool TriMeshRaycast(const Variant&, const Vector3&, const Vector3&, int&, float&)",
+		asFUNCTION(TriMeshRaycast),
+		asCALL_CDECL
+	);
+	CHECK_GEO_REG(res);
+
+	res = engine->RegisterGlobalFunction(
+		"Variant TriMesh_AttachBVH(const Variant&)",
+		asFUNCTION(TriMesh_AttachBVH),
+		asCALL_CDECL
+	);
+	CHECK_GEO_REG(res);
+
 	res = engine->RegisterGlobalFunction(
 		"Variant TriMesh_CollapseShortEdges(const Variant&, float)",
 		asFUNCTION(TriMesh_CollapseShortEdges),
@@ -1051,6 +1151,20 @@ void RegisterGeometryFunctions(Urho3D::Context* context)
 	);
 	CHECK_GEO_REG(res)
 
+	res = engine->RegisterGlobalFunction(
+		"Array<Variant>@ TriMeshIntersection(const Variant&, const Variant&)",
+		asFUNCTION(TriMeshIntersection),
+		asCALL_CDECL
+	);
+	CHECK_GEO_REG(res)
+
+	res = engine->RegisterGlobalFunction(
+		"bool TriTriIntersection(const Vector3&, const Vector3&, const Vector3&, const Vector3&, const Vector3&, const Vector3&, Vector3&, Vector3&)",
+		asFUNCTION(TriTriIntersection),
+		asCALL_CDECL
+	);
+	CHECK_GEO_REG(res)
+
 	res = engine->RegisterGlobalFunction(
 		"bool WriteOBJ(const String&, const Variant&, bool)",
 		asFUNCTION(WriteOBJ),
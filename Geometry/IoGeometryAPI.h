@@ -81,6 +81,13 @@ Urho3D::Vector3 Incenter(
 
 Urho3D::Variant JoinMeshes(Urho3D::CScriptArray* mesh_list_arr);
 
+bool MeshBoolean(
+	const Urho3D::Variant& meshA,
+	const Urho3D::Variant& meshB,
+	int operation,
+	Urho3D::Variant& meshOut
+);
+
 bool MeshTetrahedralize(
 	const Urho3D::Variant& meshIn,
 	float maxVolume,
@@ -110,6 +117,11 @@ bool PolylineLoft(
 	Urho3D::Variant& mesh
 );
 
+Urho3D::CScriptArray* PolylineSplitAtCrossings(
+	Urho3D::CScriptArray* polylines_arr,
+	float tolerance
+);
+
 bool PolylineOffset(
 	const Urho3D::Variant& polyIn,
 	Urho3D::Variant& polyOut,
@@ -248,6 +260,16 @@ bool TriMeshClosestPoint(
 	Urho3D::Vector3& p
 );
 
+bool TriMeshRaycast(
+	const Urho3D::Variant& mesh,
+	const Urho3D::Vector3& O,
+	const Urho3D::Vector3& D,
+	int& index,
+	float& s
+);
+
+Urho3D::Variant TriMesh_AttachBVH(const Urho3D::Variant& mesh);
+
 Urho3D::Variant TriMesh_CollapseShortEdges(
 	const Urho3D::Variant& tri_mesh,
 	float collapse_threshold
@@ -324,6 +346,22 @@ bool TriMeshWindow(
 	Urho3D::Variant& meshOut
 );
 
+Urho3D::CScriptArray* TriMeshIntersection(
+	const Urho3D::Variant& meshA,
+	const Urho3D::Variant& meshB
+);
+
+bool TriTriIntersection(
+	const Urho3D::Vector3& p0,
+	const Urho3D::Vector3& p1,
+	const Urho3D::Vector3& p2,
+	const Urho3D::Vector3& q0,
+	const Urho3D::Vector3& q1,
+	const Urho3D::Vector3& q2,
+	Urho3D::Vector3& start,
+	Urho3D::Vector3& end
+);
+
 bool WriteOBJ(
 	const Urho3D::String& obj_filename,
 	const Urho3D::Variant& tri_mesh,
@@ -30,10 +30,11 @@
 /*
  ["type"] = TriMeshWithData
  ["mesh"] = VariantMap
- ["vertex-vertex"] = VariantVector (with Vector<Vector<int>> structure)
- ["vertex-face"] = VariantVector (with Vector<Vector<int>> structure)
- ["face-face"] = VariantVector
+ ["adjacency"] = handle to the Geomlib::TriMeshAdjacency of mesh (custom Variant)
  
+ The adjacency is built once per mesh into flat arrays by Geomlib::TriMeshAdjacency. Queries on a
+ TriMeshWithData read it through the handle, so each query is O(1) plus the size of its result.
+ The queries below also accept a plain TriMesh, which looks the adjacency up on every call.
  */
 
 // Leaving out edges and labels for now
@@ -45,7 +46,7 @@
 // this computes all the various adjacency data and stores it as an enhanced triMesh
 Urho3D::Variant TriMesh_ComputeAdjacencyData(const Urho3D::Variant& triMesh); // REGISTERED
 
-// this checks for existance, but makes no guarantee that the data is uptodate.
+// this checks for existance of the wrapper; the adjacency it refers to is always up to date.
 bool TriMesh_HasAdjacencyData(const Urho3D::Variant& triMeshWithData); // REGISTERED
 
 
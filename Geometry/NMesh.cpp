@@ -385,6 +385,28 @@ Urho3D::Model* NMesh_GetRenderMesh(const Urho3D::Variant& nMesh, Urho3D::Context
     return model;
 }
 
+bool NMesh_GetRenderData(
+	const Urho3D::Variant& nMesh,
+	Urho3D::VariantVector vColors,
+	Urho3D::PODVector<Urho3D::Vector3>& positions,
+	Urho3D::PODVector<Urho3D::Vector3>& normals,
+	Urho3D::PODVector<unsigned>& colors,
+	Urho3D::PODVector<unsigned>& indices
+)
+{
+	if (!NMesh_Verify(nMesh))
+	{
+		return false;
+	}
+
+	// same flat shaded triangulation as NMesh_GetRenderMesh
+	Urho3D::VariantVector faceTris;
+	Urho3D::Variant convertedMesh = NMesh_ConvertToTriMesh_P2T(nMesh, faceTris);
+	Urho3D::Variant unifiedMesh = TriMesh_UnifyNormals(convertedMesh);
+
+	return TriMesh_GetRenderData(unifiedMesh, vColors, true, positions, normals, colors, indices);
+}
+
 // for scripts
 Urho3D::Variant NMesh_MakeFromVariantArrays(Urho3D::CScriptArray* vertex_array, Urho3D::CScriptArray* face_array)
 {
@@ -55,6 +55,14 @@ Urho3D::Vector<Urho3D::Pair<int, int>> NMesh_ComputeEdges(const Urho3D::Variant&
 
 //Display functions
 Urho3D::Model* NMesh_GetRenderMesh(const Urho3D::Variant& nMesh, Urho3D::Context* context, Urho3D::VariantVector vColors, bool split=false);
+bool NMesh_GetRenderData(
+	const Urho3D::Variant& nMesh,
+	Urho3D::VariantVector vColors,
+	Urho3D::PODVector<Urho3D::Vector3>& positions,
+	Urho3D::PODVector<Urho3D::Vector3>& normals,
+	Urho3D::PODVector<unsigned>& colors,
+	Urho3D::PODVector<unsigned>& indices
+);
 
 // for scripts
 Urho3D::Variant NMesh_MakeFromVariantArrays(Urho3D::CScriptArray* vertex_array, Urho3D::CScriptArray* face_array);
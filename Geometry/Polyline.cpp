@@ -342,15 +342,11 @@ struct VertexData
 };
 
 
-Urho3D::SharedPtr<Model> Polyline_GetRenderMesh(const Urho3D::Variant& poly, Urho3D::Context* context, Urho3D::VariantVector vCols, float thickness, bool split)
-{
-	SharedPtr<Model> model(new Model(context));
-
-	if (!Polyline_Verify(poly))
-	{
-		return model;
-	}
+namespace {
 
+// Thin strip mesh used to draw a polyline, with colors repeated to match its vertices
+void Polyline_GetThickMesh(const Urho3D::Variant& poly, const Urho3D::VariantVector& vCols, float thickness, Variant& thickMesh, VariantVector& doubledCols)
+{
 	Variant polyA;
 	Geomlib::PolylineOffset(poly, polyA, 0.5f * thickness);
 	Variant polyB;
@@ -361,10 +357,8 @@ Urho3D::SharedPtr<Model> Polyline_GetRenderMesh(const Urho3D::Variant& poly, Urh
 	polys.Push(polyA);
 	polys.Push(polyB);
 	Geomlib::PolylineLoft(polys, polyMesh);
-	Variant thickMesh;
 	Geomlib::TriMeshThicken(polyMesh, 0.0001f, thickMesh);
 	//Variant backFaceMesh = TriMesh_DoubleAndFlipFaces(polyMesh);
-	VariantVector doubledCols;
 	if (vCols.Empty())
 	{
 		doubledCols.Push(Color(0.8f, 0.8f, 1.0f, 1.0f));
@@ -380,12 +374,51 @@ Urho3D::SharedPtr<Model> Polyline_GetRenderMesh(const Urho3D::Variant& poly, Urh
 			doubledCols.Push(vCols[i]);
 		}
 	}
+}
+
+} // namespace
+
+Urho3D::SharedPtr<Model> Polyline_GetRenderMesh(const Urho3D::Variant& poly, Urho3D::Context* context, Urho3D::VariantVector vCols, float thickness, bool split)
+{
+	SharedPtr<Model> model(new Model(context));
+
+	if (!Polyline_Verify(poly))
+	{
+		return model;
+	}
+
+	Variant thickMesh;
+	VariantVector doubledCols;
+	Polyline_GetThickMesh(poly, vCols, thickness, thickMesh, doubledCols);
 
 	model = TriMesh_GetRenderMesh(thickMesh, context, doubledCols, split);
 
 	return model;
 }
 
+bool Polyline_GetRenderData(
+	const Urho3D::Variant& poly,
+	Urho3D::VariantVector vCols,
+	float thickness,
+	bool split,
+	Urho3D::PODVector<Urho3D::Vector3>& positions,
+	Urho3D::PODVector<Urho3D::Vector3>& normals,
+	Urho3D::PODVector<unsigned>& colors,
+	Urho3D::PODVector<unsigned>& indices
+)
+{
+	if (!Polyline_Verify(poly))
+	{
+		return false;
+	}
+
+	Variant thickMesh;
+	VariantVector doubledCols;
+	Polyline_GetThickMesh(poly, vCols, thickness, thickMesh, doubledCols);
+
+	return TriMesh_GetRenderData(thickMesh, doubledCols, split, positions, normals, colors, indices);
+}
+
 // script versions
 
 Urho3D::Variant Polyline_MakeFromVariantArray(CScriptArray* vertexList_arr)
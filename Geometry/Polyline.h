@@ -51,6 +51,16 @@ bool Polyline_IsClosed(const Urho3D::Variant& polyline); // REGISTERED
 Urho3D::Variant Polyline_ApplyTransform(const Urho3D::Variant& polyline, const Urho3D::Matrix3x4& T); // REGISTERED
 
 Urho3D::SharedPtr<Urho3D::Model> Polyline_GetRenderMesh(const Urho3D::Variant& triMesh, Urho3D::Context* context, Urho3D::VariantVector vCols, float thickness, bool split=false);
+bool Polyline_GetRenderData(
+	const Urho3D::Variant& poly,
+	Urho3D::VariantVector vCols,
+	float thickness,
+	bool split,
+	Urho3D::PODVector<Urho3D::Vector3>& positions,
+	Urho3D::PODVector<Urho3D::Vector3>& normals,
+	Urho3D::PODVector<unsigned>& colors,
+	Urho3D::PODVector<unsigned>& indices
+);
 
 // script versions
 Urho3D::Variant Polyline_MakeFromVariantArray(Urho3D::CScriptArray* vertexList_arr);
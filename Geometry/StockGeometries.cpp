@@ -38,6 +38,7 @@
 #include "TriMesh.h"
 #include "Polyline.h"
 #include "NMesh.h"
+#include "Geomlib_RemoveDuplicates.h"
 #include "Geomlib_TriangulatePolygon.h"
 #include "Geomlib_TriMeshThicken.h"
 
@@ -60,50 +61,6 @@ using Urho3D::Vector3;
 
 namespace {
 
-bool Vector3Equals(const Vector3& lhs, const Vector3& rhs)
-{
-	return Equals(lhs.x_, rhs.x_) && Equals(lhs.y_, rhs.y_) && Equals(lhs.z_, rhs.z_);
-}
-
-void RemoveDuplicates(
-	const Vector<Vector3>& vertexListIn,
-	Variant& vertices,
-	Variant& faces
-)
-{
-	int numVerts = (int)vertexListIn.Size();
-	std::vector<int> vertexDuplicates_(numVerts);
-
-	for (int i = 0; i < numVerts; ++i) {
-		vertexDuplicates_[i] = i; // Assume not a duplicate
-		for (int j = 0; j < i; ++j) {
-			if (Vector3Equals(vertexListIn[j], vertexListIn[i])) {
-				vertexDuplicates_[i] = j;
-				break;
-			}
-		}
-	}
-
-	std::vector<int> vertexUniques_ = vertexDuplicates_;
-	std::sort(vertexUniques_.begin(), vertexUniques_.end());
-	vertexUniques_.erase(std::unique(vertexUniques_.begin(), vertexUniques_.end()), vertexUniques_.end());
-
-	Vector<Variant> newVertexList;
-	for (int i = 0; i < (int)vertexUniques_.size(); ++i) {
-		int k = vertexUniques_[i];
-		newVertexList.Push(Variant(vertexListIn[k]));
-	}
-	vertices = Variant(newVertexList);
-
-	Vector<Variant> faceList;
-	for (int j = 0; j < numVerts; ++j) {
-		int orig_j = vertexDuplicates_[j];
-		int uniq_j = find(vertexUniques_.begin(), vertexUniques_.end(), orig_j) - vertexUniques_.begin();
-		faceList.Push(Variant(uniq_j));
-	}
-	faces = Variant(faceList);
-}
-
 void subdivide_icosahedron(
 	const Eigen::MatrixXf& V,
 	const Eigen::MatrixXi& F,
@@ -196,7 +153,7 @@ Urho3D::Variant MakeHexayurtMesh(float s)
 	}
 
 	Variant vertices, faces;
-	RemoveDuplicates(vertexCoords, vertices, faces);
+	Geomlib::RemoveDuplicates(vertexCoords, vertices, faces);
 
 	return TriMesh_Make(vertices, faces);
 }
@@ -234,7 +191,7 @@ Urho3D::Variant MakeCubeMeshFromExtremeCorners(Vector3 m, Vector3 M)
 	}
 
 	Variant vertices, faces;
-	RemoveDuplicates(vertexCoords, vertices, faces);
+	Geomlib::RemoveDuplicates(vertexCoords, vertices, faces);
 
 	return TriMesh_Make(vertices, faces);
 }
@@ -279,7 +236,7 @@ Urho3D::Variant MakeCubeMesh(float s)
 	}
 
 	Variant vertices, faces;
-	RemoveDuplicates(vertexCoords, vertices, faces);
+	Geomlib::RemoveDuplicates(vertexCoords, vertices, faces);
 
 	return TriMesh_Make(vertices, faces);
 }
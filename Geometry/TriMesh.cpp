@@ -22,6 +22,7 @@
 
 #include "TriMesh.h"
 
+#include <cstring>
 #include <iostream>
 #include <vector>
 
@@ -135,6 +136,111 @@ namespace {
 		return faceList;
 	}
 
+	bool IsPackedArray(const Variant* var)
+	{
+		return var != NULL && var->IsCustomType<TriMeshPackedArray>();
+	}
+
+	template <class T>
+	void SetPackedArray(Variant& var, const PODVector<T>& data)
+	{
+		std::shared_ptr<PODVector<unsigned char> > buffer = std::make_shared<PODVector<unsigned char> >(data.Size() * sizeof(T));
+		if (!data.Empty()) {
+			memcpy(&buffer->Front(), &data[0], buffer->Size());
+		}
+		var.SetCustom<TriMeshPackedArray>(buffer);
+	}
+
+	// returns the packed array stored in var, or NULL if var is missing, empty or not packed;
+	// the data stays valid for as long as array holds it
+	template <class T>
+	const T* GetPackedArray(const Variant* var, TriMeshPackedArray& array, unsigned& count)
+	{
+		count = 0;
+		array.reset();
+		if (!IsPackedArray(var)) {
+			return NULL;
+		}
+
+		array = var->GetCustom<TriMeshPackedArray>();
+		count = array ? array->Size() / sizeof(T) : 0;
+		return count > 0 ? reinterpret_cast<const T*>(&array->Front()) : NULL;
+	}
+
+	VariantVector UnpackVector3List(const Variant* var)
+	{
+		if (var == NULL) {
+			return VariantVector();
+		}
+		if (!IsPackedArray(var)) {
+			return var->GetVariantVector();
+		}
+
+		TriMeshPackedArray array;
+		unsigned count = 0;
+		const float* data = GetPackedArray<float>(var, array, count);
+		VariantVector list(count / 3);
+		for (unsigned i = 0; i < list.Size(); ++i) {
+			list[i] = Vector3(data + 3 * i);
+		}
+		return list;
+	}
+
+	VariantVector UnpackIntList(const Variant* var)
+	{
+		if (var == NULL) {
+			return VariantVector();
+		}
+		if (!IsPackedArray(var)) {
+			return var->GetVariantVector();
+		}
+
+		TriMeshPackedArray array;
+		unsigned count = 0;
+		const int* data = GetPackedArray<int>(var, array, count);
+		VariantVector list(count);
+		for (unsigned i = 0; i < count; ++i) {
+			list[i] = data[i];
+		}
+		return list;
+	}
+
+	// straight average of the unnormalized face normals around each vertex, as in IglComputeVertexNormals
+	void ComputePackedVertexNormals(const PODVector<float>& positions, const PODVector<int>& indices, PODVector<float>& normals)
+	{
+		unsigned numVertices = positions.Size() / 3;
+		normals.Resize(positions.Size());
+		PODVector<unsigned> valence(numVertices);
+		for (unsigned i = 0; i < numVertices; ++i) {
+			normals[3 * i] = normals[3 * i + 1] = normals[3 * i + 2] = 0.0f;
+			valence[i] = 0;
+		}
+
+		for (unsigned i = 0; i < indices.Size(); i += 3) {
+			Vector3 v0(&positions[3 * indices[i]]);
+			Vector3 v1(&positions[3 * indices[i + 1]]);
+			Vector3 v2(&positions[3 * indices[i + 2]]);
+			Vector3 n = (v1 - v0).CrossProduct(v2 - v0);
+
+			for (unsigned j = 0; j < 3; ++j) {
+				unsigned v = indices[i + j];
+				normals[3 * v] += n.x_;
+				normals[3 * v + 1] += n.y_;
+				normals[3 * v + 2] += n.z_;
+				valence[v]++;
+			}
+		}
+
+		for (unsigned i = 0; i < numVertices; ++i) {
+			if (valence[i] > 0) {
+				float scale = 1.0f / valence[i];
+				normals[3 * i] *= scale;
+				normals[3 * i + 1] *= scale;
+				normals[3 * i + 2] *= scale;
+			}
+		}
+	}
+
 
 	VariantVector ComputeFaceNormals(const Eigen::MatrixXf& V, const Eigen::MatrixXi& F)
 	{
@@ -150,17 +256,13 @@ namespace {
 		return normals;
 	}
 
-	VariantVector ComputeFaceNormals(const VariantVector& vertexList, const VariantVector& faceList, bool normalize)
+	VariantVector ComputeFaceNormals(const TriMeshView& view, bool normalize)
 	{
 		VariantVector normals;
-		for (unsigned i = 0; i < faceList.Size(); i += 3) {
-			unsigned i0 = faceList[i].GetInt();
-			unsigned i1 = faceList[i + 1].GetInt();
-			unsigned i2 = faceList[i + 2].GetInt();
-
-			Vector3 v0 = vertexList[i0].GetVector3();
-			Vector3 v1 = vertexList[i1].GetVector3();
-			Vector3 v2 = vertexList[i2].GetVector3();
+		for (unsigned i = 0; i < view.GetNumFaces(); ++i) {
+			Vector3 v0 = view.GetVertex(view.GetIndex(i, 0));
+			Vector3 v1 = view.GetVertex(view.GetIndex(i, 1));
+			Vector3 v2 = view.GetVertex(view.GetIndex(i, 2));
 
 			Vector3 n = (v1 - v0).CrossProduct(v2 - v0);
 
@@ -306,15 +408,231 @@ bool TriMesh_Verify(const Urho3D::Variant& triMesh)
 {
 	if (triMesh.GetType() != VariantType::VAR_VARIANTMAP) return false;
 
-	VariantMap var_map = triMesh.GetVariantMap();
-	Variant var_type = var_map["type"];
-	if (var_type.GetType() != VariantType::VAR_STRING) return false;
+	const VariantMap& var_map = triMesh.GetVariantMap();
+	const Variant* var_type = var_map["type"];
+	if (var_type == NULL || var_type->GetType() != VariantType::VAR_STRING) return false;
 
-	if (var_type.GetString() != "TriMesh") return false;
+	if (var_type->GetString() != "TriMesh") return false;
 
 	return true;
 }
 
+Urho3D::Variant TriMesh_MakePacked(const Urho3D::PODVector<float>& positions, const Urho3D::PODVector<int>& indices)
+{
+	Variant earlyRet;
+	if (positions.Size() == 0 || positions.Size() % 3 != 0) {
+		std::cerr << "ERROR: TriMesh_MakePacked --- positions.Size() is not a positive multiple of 3\n";
+		return earlyRet;
+	}
+	if (indices.Size() == 0 || indices.Size() % 3 != 0) {
+		std::cerr << "ERROR: TriMesh_MakePacked --- indices.Size() is not a positive multiple of 3\n";
+		return earlyRet;
+	}
+
+	int numVertices = (int)(positions.Size() / 3);
+	for (unsigned i = 0; i < indices.Size(); i += 3) {
+		int i0 = indices[i];
+		int i1 = indices[i + 1];
+		int i2 = indices[i + 2];
+
+		if (i0 == i1 || i1 == i2 || i2 == i0) {
+			std::cerr << "ERROR: TriMesh_MakePacked --- repeated vertex indices in face\n";
+			return earlyRet;
+		}
+
+		if (
+			(i0 < 0 || i0 > numVertices - 1) ||
+			(i1 < 0 || i1 > numVertices - 1) ||
+			(i2 < 0 || i2 > numVertices - 1)
+			)
+		{
+			std::cerr << "ERROR: TriMesh_MakePacked --- vertex indices out of range\n";
+			return earlyRet;
+		}
+	}
+
+	PODVector<float> normals;
+	ComputePackedVertexNormals(positions, indices, normals);
+
+	Variant triMesh = VariantMap();
+	VariantMap& var_map = *triMesh.GetVariantMapPtr();
+	var_map["type"] = Variant(String("TriMesh"));
+	SetPackedArray(var_map["vertices"], positions);
+	SetPackedArray(var_map["faces"], indices);
+	SetPackedArray(var_map["normals"], normals);
+
+	return triMesh;
+}
+
+Urho3D::Variant TriMesh_MakePacked(const Eigen::MatrixXf& V, const Eigen::MatrixXi& F)
+{
+	if (V.cols() != 3 || F.cols() != 3) {
+		std::cerr << "ERROR: TriMesh_MakePacked --- V.cols() != 3 or F.cols() != 3\n";
+		return Variant();
+	}
+
+	PODVector<float> positions;
+	positions.Resize(3 * (unsigned)V.rows());
+	for (unsigned i = 0; i < V.rows(); ++i) {
+		for (unsigned j = 0; j < 3; ++j) {
+			positions[3 * i + j] = V(i, j);
+		}
+	}
+
+	PODVector<int> indices;
+	indices.Resize(3 * (unsigned)F.rows());
+	for (unsigned i = 0; i < F.rows(); ++i) {
+		for (unsigned j = 0; j < 3; ++j) {
+			indices[3 * i + j] = F(i, j);
+		}
+	}
+
+	return TriMesh_MakePacked(positions, indices);
+}
+
+bool TriMesh_IsPacked(const Urho3D::Variant& triMesh)
+{
+	if (!TriMesh_Verify(triMesh)) {
+		return false;
+	}
+
+	const VariantMap& var_map = triMesh.GetVariantMap();
+	return IsPackedArray(var_map["vertices"]) || IsPackedArray(var_map["faces"]) || IsPackedArray(var_map["normals"]);
+}
+
+Urho3D::Variant TriMesh_Pack(const Urho3D::Variant& triMesh)
+{
+	if (!TriMesh_Verify(triMesh)) {
+		return Variant();
+	}
+
+	const VariantMap& src = triMesh.GetVariantMap();
+	if (IsPackedArray(src["vertices"]) && IsPackedArray(src["faces"]) && IsPackedArray(src["normals"])) {
+		return triMesh;
+	}
+
+	TriMeshView view(triMesh);
+	if (!view.IsValid()) {
+		return Variant();
+	}
+
+	PODVector<float> positions(view.GetPositions(), 3 * view.GetNumVertices());
+	PODVector<int> indices(view.GetIndices(), 3 * view.GetNumFaces());
+	Variant packed = TriMesh_MakePacked(positions, indices);
+	if (packed.GetType() != VariantType::VAR_VARIANTMAP) {
+		return packed;
+	}
+
+	VariantMap& dest = *packed.GetVariantMapPtr();
+
+	// keep normals that came with the mesh rather than the recomputed ones
+	VariantVector normalList = UnpackVector3List(src["normals"]);
+	if (normalList.Size() == view.GetNumVertices()) {
+		PODVector<float> normals;
+		normals.Resize(3 * normalList.Size());
+		for (unsigned i = 0; i < normalList.Size(); ++i) {
+			Vector3 n = normalList[i].GetVector3();
+			normals[3 * i] = n.x_;
+			normals[3 * i + 1] = n.y_;
+			normals[3 * i + 2] = n.z_;
+		}
+		SetPackedArray(dest["normals"], normals);
+	}
+
+	// carry over anything else stored with the mesh, e.g. labels
+	for (VariantMap::ConstIterator it = src.Begin(); it != src.End(); ++it) {
+		if (!dest.Contains(it->first_)) {
+			dest[it->first_] = it->second_;
+		}
+	}
+
+	return packed;
+}
+
+Urho3D::Variant TriMesh_Unpack(const Urho3D::Variant& triMesh)
+{
+	if (!TriMesh_IsPacked(triMesh)) {
+		return triMesh;
+	}
+
+	Variant unpacked = triMesh;
+	VariantMap& var_map = *unpacked.GetVariantMapPtr();
+	var_map["vertices"] = TriMesh_GetVertexList(triMesh);
+	var_map["faces"] = TriMesh_GetFaceList(triMesh);
+	if (var_map.Contains("normals")) {
+		var_map["normals"] = TriMesh_GetNormalList(triMesh);
+	}
+
+	return unpacked;
+}
+
+TriMeshView::TriMeshView(const Urho3D::Variant& triMesh) :
+	positions_(NULL),
+	indices_(NULL),
+	numVertices_(0),
+	numFaces_(0)
+{
+	if (triMesh.GetType() != VariantType::VAR_VARIANTMAP) {
+		return;
+	}
+
+	const VariantMap& var_map = triMesh.GetVariantMap();
+	unsigned count = 0;
+
+	const Variant* vertices = var_map["vertices"];
+	if (IsPackedArray(vertices)) {
+		positions_ = GetPackedArray<float>(vertices, positionArray_, count);
+		numVertices_ = count / 3;
+	}
+	else if (vertices != NULL) {
+		const VariantVector& vertexList = vertices->GetVariantVector();
+		numVertices_ = vertexList.Size();
+		positionCopy_.Resize(3 * numVertices_);
+		for (unsigned i = 0; i < numVertices_; ++i) {
+			Vector3 vert = vertexList[i].GetVector3();
+			positionCopy_[3 * i] = vert.x_;
+			positionCopy_[3 * i + 1] = vert.y_;
+			positionCopy_[3 * i + 2] = vert.z_;
+		}
+		positions_ = numVertices_ > 0 ? &positionCopy_[0] : NULL;
+	}
+
+	const Variant* faces = var_map["faces"];
+	if (IsPackedArray(faces)) {
+		indices_ = GetPackedArray<int>(faces, indexArray_, count);
+		numFaces_ = count / 3;
+	}
+	else if (faces != NULL) {
+		const VariantVector& faceList = faces->GetVariantVector();
+		numFaces_ = faceList.Size() / 3;
+		indexCopy_.Resize(3 * numFaces_);
+		for (unsigned i = 0; i < indexCopy_.Size(); ++i) {
+			indexCopy_[i] = faceList[i].GetInt();
+		}
+		indices_ = numFaces_ > 0 ? &indexCopy_[0] : NULL;
+	}
+}
+
+unsigned TriMeshView::GetVertexHash() const
+{
+	unsigned hash = numVertices_;
+	for (unsigned i = 0; i < 3 * numVertices_; ++i) {
+		unsigned word;
+		memcpy(&word, positions_ + i, sizeof(word));
+		hash = word + (hash << 6) + (hash << 16) - hash;
+	}
+	return hash;
+}
+
+unsigned TriMeshView::GetFaceHash() const
+{
+	unsigned hash = numFaces_;
+	for (unsigned i = 0; i < 3 * numFaces_; ++i) {
+		hash = (unsigned)indices_[i] + (hash << 6) + (hash << 16) - hash;
+	}
+	return hash;
+}
+
 Urho3D::VariantVector TriMesh_GetVertexList(const Urho3D::Variant& triMesh)
 {
 	bool ver = TriMesh_Verify(triMesh);
@@ -322,8 +640,8 @@ Urho3D::VariantVector TriMesh_GetVertexList(const Urho3D::Variant& triMesh)
 		return VariantVector();
 	}
 
-	VariantMap var_map = triMesh.GetVariantMap();
-	return var_map["vertices"].GetVariantVector();
+	const VariantMap& var_map = triMesh.GetVariantMap();
+	return UnpackVector3List(var_map["vertices"]);
 }
 Urho3D::VariantVector TriMesh_GetFaceList(const Urho3D::Variant& triMesh)
 {
@@ -332,8 +650,8 @@ Urho3D::VariantVector TriMesh_GetFaceList(const Urho3D::Variant& triMesh)
 		return VariantVector();
 	}
 
-	VariantMap var_map = triMesh.GetVariantMap();
-	return var_map["faces"].GetVariantVector();
+	const VariantMap& var_map = triMesh.GetVariantMap();
+	return UnpackIntList(var_map["faces"]);
 }
 
 Urho3D::VariantVector TriMesh_GetNormalList(const Urho3D::Variant& triMesh)
@@ -343,8 +661,8 @@ Urho3D::VariantVector TriMesh_GetNormalList(const Urho3D::Variant& triMesh)
 		return VariantVector();
 	}
 
-	VariantMap var_map = triMesh.GetVariantMap();
-	return var_map["normals"].GetVariantVector();
+	const VariantMap& var_map = triMesh.GetVariantMap();
+	return UnpackVector3List(var_map["normals"]);
 }
 
 Urho3D::VariantVector TriMesh_GetLabelList(const Urho3D::Variant& triMesh)
@@ -368,20 +686,8 @@ Urho3D::Vector<float> TriMesh_GetVerticesAsFloats(const Urho3D::Variant& triMesh
 		return Vector<float>();
 	}
 
-	VariantVector verts = TriMesh_GetVertexList(triMesh);
-	Vector<float> vertsOut;
-	int numVerts = verts.Size();
-	vertsOut.Resize(numVerts * 3);
-
-	for (int i = 0; i < numVerts; i++)
-	{
-		Vector3 v = verts[i].GetVector3();
-		vertsOut[3 * i] = v.x_;
-		vertsOut[3 * i + 1] = v.y_;
-		vertsOut[3 * i + 2] = v.z_;
-	}
-
-	return vertsOut;
+	TriMeshView view(triMesh);
+	return Vector<float>(view.GetPositions(), 3 * view.GetNumVertices());
 }
 
 Urho3D::Vector<double> TriMesh_GetVerticesAsDoubles(const Urho3D::Variant& triMesh)
@@ -391,17 +697,15 @@ Urho3D::Vector<double> TriMesh_GetVerticesAsDoubles(const Urho3D::Variant& triMe
 		return Vector<double>();
 	}
 
-	VariantVector verts = TriMesh_GetVertexList(triMesh);
+	TriMeshView view(triMesh);
+	const float* positions = view.GetPositions();
 	Vector<double> vertsOut;
-	int numVerts = verts.Size();
-	vertsOut.Resize(numVerts * 3);
+	int numCoords = 3 * view.GetNumVertices();
+	vertsOut.Resize(numCoords);
 
-	for (int i = 0; i < numVerts; i++)
+	for (int i = 0; i < numCoords; i++)
 	{
-		Vector3 v = verts[i].GetVector3();
-		vertsOut[3 * i] = (double)v.x_;
-		vertsOut[3 * i + 1] = (double)v.y_;
-		vertsOut[3 * i + 2] = (double)v.z_;
+		vertsOut[i] = (double)positions[i];
 	}
 
 	return vertsOut;
@@ -414,17 +718,8 @@ Urho3D::Vector<int> TriMesh_GetFacesAsInts(const Urho3D::Variant& triMesh)
 		return Vector<int>();
 	}
 
-	VariantVector faces = TriMesh_GetFaceList(triMesh);
-	Vector<int> facesOut;
-	int numFaces = faces.Size();
-	facesOut.Resize(numFaces);
-
-	for (int i = 0; i < numFaces; i++)
-	{
-		facesOut[i] = faces[i].GetInt();
-	}
-
-	return facesOut;
+	TriMeshView view(triMesh);
+	return Vector<int>(view.GetIndices(), 3 * view.GetNumFaces());
 
 }
 
@@ -470,11 +765,8 @@ Urho3D::VariantVector TriMesh_ComputeFaceNormals(const Urho3D::Variant& triMesh,
 		return VariantVector();
 	}
 
-	VariantMap var_map = triMesh.GetVariantMap();
-	VariantVector vertexList = var_map["vertices"].GetVariantVector();
-	VariantVector faceList = var_map["faces"].GetVariantVector();
-
-	return ComputeFaceNormals(vertexList, faceList, normalize);
+	TriMeshView view(triMesh);
+	return ComputeFaceNormals(view, normalize);
 }
 
 Urho3D::VariantVector TriMesh_ComputeVertexNormals(const Urho3D::Variant& triMesh, bool normalize)
@@ -555,10 +847,10 @@ Urho3D::Vector<Urho3D::Vector3> TriMesh_ComputePointCloud(const Urho3D::Variant&
 	}
 
 	Vector<Vector3> point_cloud;
-	VariantVector vertex_list = TriMesh_GetVertexList(triMesh);
+	TriMeshView view(triMesh);
 
-	for (unsigned i = 0; i < vertex_list.Size(); ++i) {
-		point_cloud.Push(vertex_list[i].GetVector3());
+	for (unsigned i = 0; i < view.GetNumVertices(); ++i) {
+		point_cloud.Push(view.GetVertex(i));
 	}
 
 	return point_cloud;
@@ -723,46 +1015,16 @@ Urho3D::Vector3 TriMesh_CenterOfMass(const Urho3D::Variant& tri_mesh)
 
 void TriMeshToMatrices(const Variant& triMesh, Eigen::MatrixXf& V, Eigen::MatrixXi& F)
 {
-	VariantMap var_map = triMesh.GetVariantMap();
-	VariantVector vertexList = var_map["vertices"].GetVariantVector();
-	VariantVector faceList = var_map["faces"].GetVariantVector();
-
-	unsigned numVertices = vertexList.Size();
-	V.setZero(numVertices, 3);
-	for (unsigned i = 0; i < numVertices; ++i) {
-		Vector3 vert = vertexList[i].GetVector3();
-		V.row(i) = Eigen::RowVector3f(vert.x_, vert.y_, vert.z_);
-	}
-
-	unsigned numFaces = faceList.Size() / 3;
-	F.setZero(numFaces, 3);
-	for (unsigned i = 0; i < numFaces; ++i) {
-		for (unsigned j = 0; j < 3; ++j) {
-			F(i, j) = faceList[3 * i + j].GetInt();
-		}
-	}
+	TriMeshView view(triMesh);
+	V = view.GetVertexMap();
+	F = view.GetFaceMap();
 }
 
 void TriMeshToDoubleMatrices(const Variant& triMesh, Eigen::MatrixXd& V, Eigen::MatrixXi& F)
 {
-	VariantMap var_map = triMesh.GetVariantMap();
-	VariantVector vertexList = var_map["vertices"].GetVariantVector();
-	VariantVector faceList = var_map["faces"].GetVariantVector();
-
-	unsigned numVertices = vertexList.Size();
-	V.setZero(numVertices, 3);
-	for (unsigned i = 0; i < numVertices; ++i) {
-		Vector3 vert = vertexList[i].GetVector3();
-		V.row(i) = Eigen::RowVector3d(vert.x_, vert.y_, vert.z_);
-	}
-
-	unsigned numFaces = faceList.Size() / 3;
-	F.setZero(numFaces, 3);
-	for (unsigned i = 0; i < numFaces; ++i) {
-		for (unsigned j = 0; j < 3; ++j) {
-			F(i, j) = faceList[3 * i + j].GetInt();
-		}
-	}
+	TriMeshView view(triMesh);
+	V = view.GetVertexMap().cast<double>();
+	F = view.GetFaceMap();
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -782,77 +1044,99 @@ struct VertexData
 	unsigned color;
 };
 
-Urho3D::Model* TriMesh_GetRenderMesh(const Urho3D::Variant& triMesh, Urho3D::Context* context, VariantVector vColors, bool split)
+bool TriMesh_GetRenderData(
+	const Urho3D::Variant& triMesh,
+	Urho3D::VariantVector vColors,
+	bool split,
+	Urho3D::PODVector<Urho3D::Vector3>& positions,
+	Urho3D::PODVector<Urho3D::Vector3>& normals,
+	Urho3D::PODVector<unsigned>& colors,
+	Urho3D::PODVector<unsigned>& indices
+)
 {
 	if (!TriMesh_Verify(triMesh))
 	{
-		return NULL;
+		return false;
 	}
 
-	Vector<VertexData> vbd;
-	Vector<Vector3> tmpVerts;
-	Vector<int> tmpFaces;
-
 	VariantVector verts = TriMesh_GetVertexList(triMesh);
 	VariantVector faces = TriMesh_GetFaceList(triMesh);
-	VariantVector normals;
+	VariantVector normalList;
+
+	if (verts.Empty() || faces.Empty())
+	{
+		return false;
+	}
 
 	if (vColors.Empty())
 	{
 		vColors.Push(Color::WHITE);
 	}
-	
+
 	int numColors = vColors.Size();
 
 	if (split)
 	{
-		normals = TriMesh_ComputeFaceNormals(triMesh, true);
-		tmpFaces.Resize(faces.Size());
-		tmpVerts.Resize(faces.Size());
-		vbd.Resize(faces.Size());
-
-		unsigned int vCol = Urho3D::Color::CYAN.ToUInt();
+		normalList = TriMesh_ComputeFaceNormals(triMesh, true);
+		positions.Resize(faces.Size());
+		normals.Resize(faces.Size());
+		colors.Resize(faces.Size());
+		indices.Resize(faces.Size());
 
 		//render with duplicate verts for flat face shading
 		for (unsigned i = 0; i < faces.Size(); i++)
 		{
 			int fId = faces[i].GetInt();
-			int normId = (int)floor((float)i / 3.0f);
-			unsigned int col = vColors[normId%numColors].GetColor().ToUInt();
-			if (fId < (int)verts.Size())
-			{
-				vbd[i].position = verts[fId].GetVector3();
-				vbd[i].normal = normals[normId].GetVector3();
-				vbd[i].color = col;
-				tmpVerts[i] = vbd[i].position;
-			}
-
-			tmpFaces[i] = i;
-
+			int normId = i / 3;
+			positions[i] = fId < (int)verts.Size() ? verts[fId].GetVector3() : Vector3::ZERO;
+			normals[i] = normalList[normId].GetVector3();
+			colors[i] = vColors[normId%numColors].GetColor().ToUInt();
+			indices[i] = i;
 		}
 	}
 	else
 	{
-		normals = TriMesh_ComputeVertexNormals(triMesh);
-		tmpFaces.Resize(faces.Size());
-		tmpVerts.Resize(verts.Size());
-		vbd.Resize(verts.Size());
-		unsigned int vCol = Color::CYAN.ToUInt();
+		normalList = TriMesh_ComputeVertexNormals(triMesh);
+		positions.Resize(verts.Size());
+		normals.Resize(verts.Size());
+		colors.Resize(verts.Size());
+		indices.Resize(faces.Size());
 
 		for (unsigned i = 0; i < verts.Size(); i++)
 		{
-			vbd[i].position = verts[i].GetVector3();
-			vbd[i].normal = normals[i].GetVector3();
-			vbd[i].color = vColors[i%numColors].GetColor().ToUInt();
-			tmpVerts[i] = verts[i].GetVector3();
+			positions[i] = verts[i].GetVector3();
+			normals[i] = normalList[i].GetVector3();
+			colors[i] = vColors[i%numColors].GetColor().ToUInt();
 		}
 
 		for (unsigned i = 0; i < faces.Size(); i++)
 		{
-			tmpFaces[i] = faces[i].GetInt();
+			indices[i] = faces[i].GetInt();
 		}
 	}
 
+	return true;
+}
+
+Urho3D::Model* TriMesh_GetRenderMesh(const Urho3D::Variant& triMesh, Urho3D::Context* context, VariantVector vColors, bool split)
+{
+	PODVector<Vector3> positions;
+	PODVector<Vector3> normals;
+	PODVector<unsigned> colors;
+	PODVector<unsigned> indices;
+	if (!TriMesh_GetRenderData(triMesh, vColors, split, positions, normals, colors, indices))
+	{
+		return NULL;
+	}
+
+	Vector<VertexData> vbd(positions.Size());
+	for (unsigned i = 0; i < positions.Size(); i++)
+	{
+		vbd[i].position = positions[i];
+		vbd[i].normal = normals[i];
+		vbd[i].color = colors[i];
+	}
+
 	SharedPtr<VertexBuffer> vb(new VertexBuffer(context));
 	SharedPtr<IndexBuffer> ib(new IndexBuffer(context));
 
@@ -861,20 +1145,34 @@ Urho3D::Model* TriMesh_GetRenderMesh(const Urho3D::Variant& triMesh, Urho3D::Con
 	vb->SetSize(vbd.Size(), Urho3D::MASK_POSITION | Urho3D::MASK_NORMAL | Urho3D::MASK_COLOR);
 	vb->SetData((void*)&vbd[0]);
 
+	// 16 bit indices whenever every vertex can be addressed with them
 	ib->SetShadowed(true);
-	ib->SetSize(tmpFaces.Size(), true);
-	ib->SetData(&tmpFaces[0]);
+	if (positions.Size() <= 65536)
+	{
+		PODVector<unsigned short> shortIndices(indices.Size());
+		for (unsigned i = 0; i < indices.Size(); i++)
+		{
+			shortIndices[i] = (unsigned short)indices[i];
+		}
+		ib->SetSize(shortIndices.Size(), false);
+		ib->SetData(&shortIndices[0]);
+	}
+	else
+	{
+		ib->SetSize(indices.Size(), true);
+		ib->SetData(&indices[0]);
+	}
 
 	Geometry* geom = new Geometry(context);
 	geom->SetNumVertexBuffers(1);
 	geom->SetVertexBuffer(0, vb);
 	geom->SetIndexBuffer(ib);
-	geom->SetDrawRange(Urho3D::TRIANGLE_LIST, 0, faces.Size());
+	geom->SetDrawRange(Urho3D::TRIANGLE_LIST, 0, indices.Size());
 
 	Model* model = new Model(context);
 	model->SetNumGeometries(1);
 	model->SetGeometry(0, 0, geom);
-	model->SetBoundingBox(BoundingBox(&tmpVerts[0], tmpVerts.Size()));
+	model->SetBoundingBox(BoundingBox(&positions[0], positions.Size()));
 	model->SetGeometryCenter(0, Vector3::ZERO);
 
 	Vector<SharedPtr<VertexBuffer>> allVBuffers;
@@ -1016,6 +1314,25 @@ bool RegisterTriMeshFunctions(Urho3D::Context* context)
 	);
 	CHECK_GEO_REG(res);
 
+	res = engine->RegisterGlobalFunction(
+		"bool TriMesh_IsPacked(const Variant&)",
+		asFUNCTION(TriMesh_IsPacked),
+		asCALL_CDECL
+	);
+	CHECK_GEO_REG(res);
+	res = engine->RegisterGlobalFunction(
+		"Variant TriMesh_Pack(const Variant&)",
+		asFUNCTION(TriMesh_Pack),
+		asCALL_CDECL
+	);
+	CHECK_GEO_REG(res);
+	res = engine->RegisterGlobalFunction(
+		"Variant TriMesh_Unpack(const Variant&)",
+		asFUNCTION(TriMesh_Unpack),
+		asCALL_CDECL
+	);
+	CHECK_GEO_REG(res);
+
 	res = engine->RegisterGlobalFunction(
 		"Array<Variant>@ TriMesh_GetVertexArray(const Variant&)",
 		asFUNCTION(TriMesh_GetVertexArray),
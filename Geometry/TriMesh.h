@@ -32,6 +32,8 @@
 
 #include <Eigen/Core>
 
+#include <memory>
+
 Urho3D::Variant TriMesh_Make(const Eigen::MatrixXf& V, const Eigen::MatrixXi& F);
 Urho3D::Variant TriMesh_Make(const Urho3D::Variant& vertices, const Urho3D::Variant& faces); // REGISTERED as TriMesh_MakeFromVariants
 Urho3D::Variant TriMesh_Make(const Urho3D::VariantVector& vertexList, const Urho3D::VariantVector& faceList); // REGISTERED as TriMesh_MakeFromVariantArrays
@@ -40,6 +42,68 @@ Urho3D::Variant TriMesh_Make(const Urho3D::VariantVector& vertexList, const Urho
 
 bool TriMesh_Verify(const Urho3D::Variant& triMesh); // REGISTERED
 
+// Packed storage
+// "vertices", "faces" and "normals" may each hold a TriMeshPackedArray of tightly packed floats (x, y, z per vertex)
+// or ints (three per face) instead of one Variant per element. The array is a custom Variant value held by shared
+// pointer, so copies of the mesh share it; it is never modified after the mesh is made. TriMesh_Make always returns
+// the unpacked layout. The functions in this header accept either layout; code that reads the map directly should
+// use the accessors, TriMeshView, or TriMesh_Unpack first.
+typedef std::shared_ptr<const Urho3D::PODVector<unsigned char> > TriMeshPackedArray;
+
+Urho3D::Variant TriMesh_MakePacked(const Urho3D::PODVector<float>& positions, const Urho3D::PODVector<int>& indices);
+Urho3D::Variant TriMesh_MakePacked(const Eigen::MatrixXf& V, const Eigen::MatrixXi& F);
+bool TriMesh_IsPacked(const Urho3D::Variant& triMesh); // REGISTERED
+Urho3D::Variant TriMesh_Pack(const Urho3D::Variant& triMesh); // REGISTERED
+Urho3D::Variant TriMesh_Unpack(const Urho3D::Variant& triMesh); // REGISTERED
+
+typedef Eigen::Map<const Eigen::Matrix<float, Eigen::Dynamic, 3, Eigen::RowMajor> > TriMeshVertexMap;
+typedef Eigen::Map<const Eigen::Matrix<int, Eigen::Dynamic, 3, Eigen::RowMajor> > TriMeshFaceMap;
+
+// Contiguous read access to the positions and indices of a TriMesh in either layout.
+// Packed arrays are viewed in place and kept alive by the view; unpacked meshes are converted once on construction.
+class TriMeshView
+{
+public:
+	TriMeshView(const Urho3D::Variant& triMesh);
+	TriMeshView(const TriMeshView&) = delete;
+	TriMeshView& operator=(const TriMeshView&) = delete;
+
+	bool IsValid() const { return numVertices_ > 0 && numFaces_ > 0; }
+	unsigned GetNumVertices() const { return numVertices_; }
+	unsigned GetNumFaces() const { return numFaces_; }
+	const float* GetPositions() const { return positions_; }
+	const int* GetIndices() const { return indices_; }
+	Urho3D::Vector3 GetVertex(unsigned i) const { return Urho3D::Vector3(positions_ + 3 * i); }
+	int GetIndex(unsigned face, unsigned corner) const { return indices_[3 * face + corner]; }
+
+	// the packed arrays behind the view, or NULL when the mesh is not packed;
+	// packed arrays never change, so these identify the mesh data for as long as they are held
+	const TriMeshPackedArray& GetPositionArray() const { return positionArray_; }
+	const TriMeshPackedArray& GetIndexArray() const { return indexArray_; }
+	bool IsPacked() const { return positionArray_ && indexArray_; }
+
+	// content hashes for keying caches of data derived from the mesh; confirm hits against the data itself
+	unsigned GetVertexHash() const;
+	unsigned GetFaceHash() const;
+
+	// zero-copy Eigen views, these can be handed to the templated libigl functions directly
+	TriMeshVertexMap GetVertexMap() const { return TriMeshVertexMap(positions_, numVertices_, 3); }
+	TriMeshFaceMap GetFaceMap() const { return TriMeshFaceMap(indices_, numFaces_, 3); }
+
+private:
+	// packed arrays of the mesh, or NULL when not packed
+	TriMeshPackedArray positionArray_;
+	TriMeshPackedArray indexArray_;
+	// only filled when the mesh is not packed
+	Urho3D::PODVector<float> positionCopy_;
+	Urho3D::PODVector<int> indexCopy_;
+
+	const float* positions_;
+	const int* indices_;
+	unsigned numVertices_;
+	unsigned numFaces_;
+};
+
 Urho3D::VariantVector TriMesh_GetVertexList(const Urho3D::Variant& triMesh); // REGISTERED as TriMesh_GetVertexArray
 Urho3D::VariantVector TriMesh_GetFaceList(const Urho3D::Variant& triMesh); // REGISTERED as TriMesh_GetFaceArray
 Urho3D::VariantVector TriMesh_GetNormalList(const Urho3D::Variant& triMesh); // REGISTERED as TriMesh_GetNormalArray
@@ -81,6 +145,16 @@ void TriMeshToDoubleMatrices(const Urho3D::Variant& triMesh, Eigen::MatrixXd& V,
 
 //Display functions
 Urho3D::Model* TriMesh_GetRenderMesh(const Urho3D::Variant& triMesh, Urho3D::Context* context, Urho3D::VariantVector vColors, bool split=false);
+// Triangle list streams behind TriMesh_GetRenderMesh, for callers that keep their own GPU buffers
+bool TriMesh_GetRenderData(
+	const Urho3D::Variant& triMesh,
+	Urho3D::VariantVector vColors,
+	bool split,
+	Urho3D::PODVector<Urho3D::Vector3>& positions,
+	Urho3D::PODVector<Urho3D::Vector3>& normals,
+	Urho3D::PODVector<unsigned>& colors,
+	Urho3D::PODVector<unsigned>& indices
+);
 
 // for scripts
 Urho3D::Variant TriMesh_MakeFromVariants(const Urho3D::Variant& vertices, const Urho3D::Variant& faces);
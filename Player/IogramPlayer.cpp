@@ -87,6 +87,9 @@ using namespace Urho3D;
 
 IogramPlayer* IogramPlayer::instance_;
 
+//milliseconds of graph solving per frame while the startup graph is solved progressively
+static const float PROGRESSIVE_SOLVE_BUDGET = 30.0f;
+
 URHO3D_DEFINE_APPLICATION_MAIN(IogramPlayer);
 
 IoGraph* graph;
@@ -190,11 +193,21 @@ void IogramPlayer::LoadGraph()
 
 	bool init = false;
 
-	//first check command like arguments
+	//first check command like arguments: the graph directory, and -parallelsolve to solve independent components concurrently
 	Vector<String> args = GetArguments();
-	if (args.Size() > 0)
+	bool parallelSolve = false;
+	bool hasGraphDir = false;
+	for (unsigned i = 0; i < args.Size(); i++)
 	{
-		graphDir = args[0];
+		if (args[i].ToLower() == "-parallelsolve")
+		{
+			parallelSolve = true;
+		}
+		else if (!hasGraphDir && !args[i].StartsWith("-"))
+		{
+			graphDir = args[i];
+			hasGraphDir = true;
+		}
 	}
 
 	if (fs->DirExists(graphDir))
@@ -205,8 +218,8 @@ void IogramPlayer::LoadGraph()
 		IoGraph* graph = GetSubsystem<IoGraph>();
 		IoSerialization::LoadGraph(*graph, graphDir + "/main.graph");
 		graph->scene = scene_;
-		//solve it
-		graph->TopoSolveGraph();
+		//solve it, visible branches first, over the next frames
+		graph->BeginProgressiveSolve();
 
 		init = true;
 	}
@@ -234,8 +247,8 @@ void IogramPlayer::LoadGraph()
 						IoSerialization::LoadGraph(*graph, graphFile);
 						graph->scene = scene_;
 
-						////solve it
-						graph->TopoSolveGraph();
+						//solve it, visible branches first, over the next frames
+						graph->BeginProgressiveSolve();
 
 						init = true;
 						goto hasfile;
@@ -247,6 +260,22 @@ void IogramPlayer::LoadGraph()
 
 hasfile:
 
+	if (init)
+	{
+		//the option overrides the mode saved with the graph
+		IoGraph* graph = GetSubsystem<IoGraph>();
+		if (parallelSolve)
+			graph->SetParallelSolve(true);
+
+		//collect the level timings of the startup solve for LogStartupTimings
+		if (graph->IsParallelSolve())
+		{
+			parallelLevels_ = 0;
+			parallelSolveTime_ = 0.0f;
+			slowestLevelTime_ = 0.0f;
+			SubscribeToEvent("OnParallelSolve", URHO3D_HANDLER(IogramPlayer, HandleParallelSolve));
+		}
+	}
 
 	if (!init)
 	{
@@ -254,6 +283,43 @@ hasfile:
 	}
 }
 
+void IogramPlayer::LogStartupTimings()
+{
+	String report = "IogramPlayer::LogStartupTimings --- load";
+	const Vector<Pair<String, float> >& loadTimings = IoSerialization::GetLoadTimings();
+	for (unsigned i = 0; i < loadTimings.Size(); i++)
+	{
+		report += ", " + loadTimings[i].first_ + " " + String(loadTimings[i].second_) + " ms";
+	}
+	URHO3D_LOGINFO(report);
+
+	report = "IogramPlayer::LogStartupTimings --- solve";
+	const Vector<Pair<String, float> >& solveTimings = GetSubsystem<IoGraph>()->GetProgressiveTimings();
+	for (unsigned i = 0; i < solveTimings.Size(); i++)
+	{
+		report += ", " + solveTimings[i].first_ + " after " + String(solveTimings[i].second_) + " ms";
+	}
+	URHO3D_LOGINFO(report);
+
+	if (GetSubsystem<IoGraph>()->IsParallelSolve())
+	{
+		URHO3D_LOGINFO("IogramPlayer::LogStartupTimings --- parallel solve, " + String(parallelLevels_) + " levels in " +
+			String(parallelSolveTime_) + " ms, slowest level " + String(slowestLevelTime_) + " ms");
+		UnsubscribeFromEvent("OnParallelSolve");
+	}
+}
+
+void IogramPlayer::HandleParallelSolve(StringHash eventType, VariantMap& eventData)
+{
+	const VariantVector& levelTimings = eventData["level_timings"].GetVariantVector();
+	for (unsigned i = 0; i < levelTimings.Size(); i++)
+	{
+		slowestLevelTime_ = Max(slowestLevelTime_, levelTimings[i].GetFloat());
+	}
+	parallelLevels_ += levelTimings.Size();
+	parallelSolveTime_ += eventData["total_time"].GetFloat();
+}
+
 void IogramPlayer::LoadPlugins()
 {
 	//FileSystem* fs = GetSubsystem<FileSystem>();
@@ -424,6 +490,16 @@ void IogramPlayer::HandleUpdate(StringHash eventType, VariantMap& eventData)
 
 #endif
 
+	//keep solving the graph loaded at startup, a few batches per frame so finished branches render as they complete
+	IoGraph* graph = GetSubsystem<IoGraph>();
+	if (graph->IsProgressiveSolving())
+	{
+		if (!graph->StepProgressiveSolve(PROGRESSIVE_SOLVE_BUDGET))
+		{
+			LogStartupTimings();
+		}
+	}
+
 	Input* input = GetSubsystem<Input>();
 	if (input->GetKeyDown(KEY_ALT) && input->GetKeyPress(KEY_G))
 	{
@@ -37,6 +37,7 @@ public:
 	void CreateScene();
 	void SetupViewport();
 	void LoadGraph();
+	void LogStartupTimings();
 	void LoadPlugins();
 	void SetUIScale();
 
@@ -50,4 +51,10 @@ public:
 
 private:
 	void HandleUpdate(Urho3D::StringHash eventType, Urho3D::VariantMap& eventData);
+	void HandleParallelSolve(Urho3D::StringHash eventType, Urho3D::VariantMap& eventData);
+
+	//level timings of the startup solve, summed over its parallel batches
+	unsigned parallelLevels_ = 0;
+	float parallelSolveTime_ = 0.0f;
+	float slowestLevelTime_ = 0.0f;
 };
\ No newline at end of file
@@ -147,6 +147,40 @@ extern shapeop_err shapeop_editConstraint(ShapeOpSolver *op,
   }
   return SO_INVALID_CONSTRAINT_TYPE;
 }
+extern int shapeop_addConstraints(ShapeOpSolver *op,
+                                  const char *constraintType,
+                                  const int *ids,
+                                  int nb_ids_per_constraint,
+                                  const ShapeOpScalar *weights,
+                                  int nb_constraints,
+                                  int *constraint_ids) {
+
+  const std::string ct(constraintType);
+  std::vector<int> idv(nb_ids_per_constraint);
+  int added = 0;
+  for (int i = 0; i < nb_constraints; ++i) {
+    idv.assign(ids + i * nb_ids_per_constraint, ids + (i + 1) * nb_ids_per_constraint);
+    std::shared_ptr<ShapeOp::Constraint> c = ShapeOp::Constraint::shapeConstraintFactory(ct, idv, weights[i], op->s->getPoints());
+    if (!c) { constraint_ids[i] = -1; continue; }
+    constraint_ids[i] = op->s->addConstraint(c);
+    ++added;
+  }
+  return added;
+}
+extern shapeop_err shapeop_editConstraints(ShapeOpSolver *op,
+                                           const char *constraintType,
+                                           const int *constraint_ids,
+                                           int nb_constraints,
+                                           const ShapeOpScalar *scalars,
+                                           int nb_scl_per_constraint) {
+
+  for (int i = 0; i < nb_constraints; ++i) {
+    if (constraint_ids[i] < 0) { continue; }
+    shapeop_err err = shapeop_editConstraint(op, constraintType, constraint_ids[i], scalars + i * nb_scl_per_constraint, nb_scl_per_constraint);
+    if (err != SO_SUCCESS) { return err; }
+  }
+  return SO_SUCCESS;
+}
 extern int shapeop_addUniformLaplacianConstraint(ShapeOpSolver *op, int *ids, int nb_ids,
                                                  int displacement_lap, ShapeOpScalar weight) {
   std::vector<int> id_vector(ids, ids + nb_ids);
@@ -129,6 +129,40 @@ SHAPEOP_API shapeop_err shapeop_editConstraint(ShapeOpSolver *op,
                                                int constraint_id,
                                                const ShapeOpScalar *scalars,
                                                int nb_scl);
+
+/** \brief Add many constraints of the same type to the ShapeOp solver in one call.
+  \param op The ShapeOp Solver object
+  \param constraintType A c-style string containing one of the constraint types listed in #shapeop_addConstraint
+  \param ids The indices of all constraints one after the other, nb_ids_per_constraint per constraint
+  \param nb_ids_per_constraint The number of indices of each constraint
+  \param weights The weight of each constraint
+  \param nb_constraints The number of constraints
+  \param constraint_ids Receives nb_constraints constraint indices in the solver, -1 where adding failed
+  \return The number of constraints added.
+*/
+SHAPEOP_API int shapeop_addConstraints(ShapeOpSolver *op,
+                                       const char *constraintType,
+                                       const int *ids,
+                                       int nb_ids_per_constraint,
+                                       const ShapeOpScalar *weights,
+                                       int nb_constraints,
+                                       int *constraint_ids);
+
+/** \brief Edit many constraints of the same type, see #shapeop_editConstraint.
+  \param op The ShapeOp Solver object
+  \param constraintType A c-style string containing one of the constraint types listed in #shapeop_editConstraint
+  \param constraint_ids The ids of the constraints, as returned by #shapeop_addConstraint or #shapeop_addConstraints. Ids of -1 are skipped.
+  \param nb_constraints The number of constraints
+  \param scalars The scalars of all constraints one after the other, nb_scl_per_constraint per constraint
+  \param nb_scl_per_constraint The number of scalars of each constraint
+  \return SO_SUCCESS, or the first error returned by #shapeop_editConstraint
+*/
+SHAPEOP_API shapeop_err shapeop_editConstraints(ShapeOpSolver *op,
+                                                const char *constraintType,
+                                                const int *constraint_ids,
+                                                int nb_constraints,
+                                                const ShapeOpScalar *scalars,
+                                                int nb_scl_per_constraint);
 ///////////////////////////////////////////////////////////////////////////////
 // Forces
 /** \brief Add a gravity force to the ShapeOp solver. For more details see #ShapeOp::GravityForce.
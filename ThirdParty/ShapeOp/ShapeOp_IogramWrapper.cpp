@@ -8,6 +8,31 @@
 
 namespace {
 
+	void SetPackedArray(Urho3D::Variant& var, const void* data, unsigned size)
+	{
+		if (size > 0) {
+			var.SetBuffer(data, size);
+		}
+		else {
+			var = Urho3D::PODVector<unsigned char>();
+		}
+	}
+
+	// returns the packed array stored at key, or NULL if it is missing, empty or not packed
+	template <class T>
+	const T* GetPackedArray(const Urho3D::VariantMap& var_map, const char* key, unsigned& count)
+	{
+		count = 0;
+		const Urho3D::Variant* var = var_map[key];
+		if (var == NULL || var->GetType() != Urho3D::VariantType::VAR_BUFFER) {
+			return NULL;
+		}
+
+		const Urho3D::PODVector<unsigned char>& buffer = var->GetBuffer();
+		count = buffer.Size() / sizeof(T);
+		return count > 0 ? reinterpret_cast<const T*>(&buffer[0]) : NULL;
+	}
+
 } // namespace
 
 ////////////////////
@@ -17,11 +42,11 @@ bool ShapeOpConstraint_Verify(const Urho3D::Variant& constraint)
 {
 	if (constraint.GetType() != Urho3D::VariantType::VAR_VARIANTMAP) return false;
 
-	Urho3D::VariantMap var_map = constraint.GetVariantMap();
-	Urho3D::Variant var_type = var_map["type"];
-	if (var_type.GetType() != Urho3D::VariantType::VAR_STRING) return false;
+	const Urho3D::VariantMap& var_map = constraint.GetVariantMap();
+	const Urho3D::Variant* var_type = var_map["type"];
+	if (var_type == NULL || var_type->GetType() != Urho3D::VariantType::VAR_STRING) return false;
 
-	if (var_type.GetString() != "ShapeOpConstraint") return false;
+	if (var_type->GetString() != "ShapeOpConstraint") return false;
 
 	return true;
 }
@@ -31,8 +56,8 @@ Urho3D::String ShapeOpConstraint_constraintType(const Urho3D::Variant& constrain
 	bool ver = ShapeOpConstraint_Verify(constraint);
 	if (!ver) return Urho3D::String("");
 
-	Urho3D::VariantMap var_map = constraint.GetVariantMap();
-	return var_map["constraintType"].GetString();
+	const Urho3D::Variant* constraintType = constraint.GetVariantMap()["constraintType"];
+	return constraintType != NULL ? constraintType->GetString() : Urho3D::String("");
 }
 
 double ShapeOpConstraint_weight(const Urho3D::Variant& constraint)
@@ -40,8 +65,8 @@ double ShapeOpConstraint_weight(const Urho3D::Variant& constraint)
 	bool ver = ShapeOpConstraint_Verify(constraint);
 	if (!ver) return 0.0;
 
-	Urho3D::VariantMap var_map = constraint.GetVariantMap();
-	return (double)(var_map["weight"].GetFloat());
+	const Urho3D::Variant* weight = constraint.GetVariantMap()["weight"];
+	return weight != NULL ? (double)weight->GetFloat() : 0.0;
 }
 
 ////////////////
@@ -192,4 +217,121 @@ void ShapeOpConstraint_SetConstraintId(
 
 	Urho3D::VariantMap* var_map = constraint.GetVariantMapPtr();
 	(*var_map)["constraint_id"] = constraint_id;
+}
+
+/////////////////////////
+// ShapeOpConstraintBlock
+
+Urho3D::Variant ShapeOpConstraintBlock_Make(
+	const Urho3D::String& constraintType,
+	const Urho3D::PODVector<Urho3D::Vector3>& points,
+	const Urho3D::PODVector<int>& ids,
+	unsigned idsPerConstraint,
+	const Urho3D::PODVector<float>& weights,
+	const Urho3D::PODVector<double>& scalars,
+	unsigned scalarsPerConstraint
+)
+{
+	if (constraintType.Empty() || idsPerConstraint == 0 || ids.Empty() || ids.Size() % idsPerConstraint != 0) {
+		std::cout << "ShapeOpConstraintBlock_Make --- ids must hold idsPerConstraint indices per constraint" << std::endl;
+		return Urho3D::Variant();
+	}
+
+	unsigned numConstraints = ids.Size() / idsPerConstraint;
+	if (weights.Size() != numConstraints) {
+		std::cout << "ShapeOpConstraintBlock_Make --- weights must hold one weight per constraint" << std::endl;
+		return Urho3D::Variant();
+	}
+	if (!scalars.Empty() && (scalarsPerConstraint == 0 || scalars.Size() != numConstraints * scalarsPerConstraint)) {
+		std::cout << "ShapeOpConstraintBlock_Make --- scalars must hold scalarsPerConstraint values per constraint" << std::endl;
+		return Urho3D::Variant();
+	}
+
+	// fill the map in place so the buffers are only copied once
+	Urho3D::Variant block = Urho3D::VariantMap();
+	Urho3D::VariantMap& var_map = *block.GetVariantMapPtr();
+	var_map["type"] = Urho3D::Variant("ShapeOpConstraintBlock");
+	var_map["constraintType"] = Urho3D::Variant(constraintType);
+	var_map["idsPerConstraint"] = (int)idsPerConstraint;
+	var_map["scalarsPerConstraint"] = scalars.Empty() ? 0 : (int)scalarsPerConstraint;
+	SetPackedArray(var_map["points"], points.Empty() ? NULL : &points[0], points.Size() * sizeof(Urho3D::Vector3));
+	SetPackedArray(var_map["ids"], &ids[0], ids.Size() * sizeof(int));
+	SetPackedArray(var_map["weights"], &weights[0], weights.Size() * sizeof(float));
+	SetPackedArray(var_map["scalars"], scalars.Empty() ? NULL : &scalars[0], scalars.Size() * sizeof(double));
+
+	if (!ShapeOpConstraintBlock_Verify(block)) {
+		std::cout << "ShapeOpConstraintBlock_Make --- ids out of range of points" << std::endl;
+		return Urho3D::Variant();
+	}
+
+	return block;
+}
+
+bool ShapeOpConstraintBlock_Verify(const Urho3D::Variant& block)
+{
+	return ShapeOpConstraintBlockView(block).IsValid();
+}
+
+ShapeOpConstraintBlockView::ShapeOpConstraintBlockView(const Urho3D::Variant& block) :
+	valid_(false),
+	numConstraints_(0),
+	idsPerConstraint_(0),
+	scalarsPerConstraint_(0),
+	numPoints_(0),
+	points_(NULL),
+	ids_(NULL),
+	weights_(NULL),
+	scalars_(NULL)
+{
+	if (block.GetType() != Urho3D::VariantType::VAR_VARIANTMAP) {
+		return;
+	}
+
+	const Urho3D::VariantMap& var_map = block.GetVariantMap();
+	const Urho3D::Variant* var_type = var_map["type"];
+	if (var_type == NULL || var_type->GetType() != Urho3D::VariantType::VAR_STRING || var_type->GetString() != "ShapeOpConstraintBlock") {
+		return;
+	}
+
+	const Urho3D::Variant* constraintType = var_map["constraintType"];
+	const Urho3D::Variant* idsPerConstraint = var_map["idsPerConstraint"];
+	const Urho3D::Variant* scalarsPerConstraint = var_map["scalarsPerConstraint"];
+	if (constraintType == NULL || idsPerConstraint == NULL || scalarsPerConstraint == NULL) {
+		return;
+	}
+	constraintType_ = constraintType->GetString();
+	if (constraintType_.Empty() || idsPerConstraint->GetInt() <= 0 || scalarsPerConstraint->GetInt() < 0) {
+		return;
+	}
+	idsPerConstraint_ = (unsigned)idsPerConstraint->GetInt();
+	scalarsPerConstraint_ = (unsigned)scalarsPerConstraint->GetInt();
+
+	unsigned numFloats = 0;
+	unsigned numIds = 0;
+	unsigned numWeights = 0;
+	unsigned numScalars = 0;
+	points_ = GetPackedArray<float>(var_map, "points", numFloats);
+	ids_ = GetPackedArray<int>(var_map, "ids", numIds);
+	weights_ = GetPackedArray<float>(var_map, "weights", numWeights);
+	scalars_ = GetPackedArray<double>(var_map, "scalars", numScalars);
+
+	numPoints_ = numFloats / 3;
+	numConstraints_ = numIds / idsPerConstraint_;
+	if (numIds == 0 || numIds % idsPerConstraint_ != 0 || numWeights != numConstraints_) {
+		return;
+	}
+	if (numScalars != numConstraints_ * scalarsPerConstraint_ && numScalars != 0) {
+		return;
+	}
+	if (numScalars == 0) {
+		scalarsPerConstraint_ = 0;
+	}
+
+	for (unsigned i = 0; i < numIds; ++i) {
+		if (ids_[i] < 0 || ids_[i] >= (int)numPoints_) {
+			return;
+		}
+	}
+
+	valid_ = true;
 }
\ No newline at end of file
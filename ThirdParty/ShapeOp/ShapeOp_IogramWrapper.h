@@ -54,4 +54,59 @@ int ShapeOpConstraint_NeedsEdit(
 void ShapeOpConstraint_SetConstraintId(
 	Urho3D::Variant& constraint,
 	int constraint_id
-);
\ No newline at end of file
+);
+
+/////////////////////////
+// ShapeOpConstraintBlock
+
+// Many constraints of one type stored as VAR_BUFFERs of packed values, so that generators and
+// ShapeOp_Solve do not touch a Variant per constraint:
+//   "points": floats, x y z per point; welded with all other constraint points by ShapeOp_Solve
+//   "ids": ints, idsPerConstraint indices into "points" per constraint
+//   "weights": floats, one per constraint
+//   "scalars": doubles, scalarsPerConstraint values per constraint as passed to shapeop_editConstraint;
+//              empty to keep ShapeOp's defaults
+Urho3D::Variant ShapeOpConstraintBlock_Make(
+	const Urho3D::String& constraintType,
+	const Urho3D::PODVector<Urho3D::Vector3>& points,
+	const Urho3D::PODVector<int>& ids,
+	unsigned idsPerConstraint,
+	const Urho3D::PODVector<float>& weights,
+	const Urho3D::PODVector<double>& scalars,
+	unsigned scalarsPerConstraint
+);
+
+bool ShapeOpConstraintBlock_Verify(const Urho3D::Variant& block);
+
+// Read-only access to the arrays of a block, valid while the block Variant is alive and unchanged
+class ShapeOpConstraintBlockView
+{
+public:
+	ShapeOpConstraintBlockView(const Urho3D::Variant& block);
+
+	bool IsValid() const { return valid_; }
+
+	const Urho3D::String& GetConstraintType() const { return constraintType_; }
+	unsigned GetNumConstraints() const { return numConstraints_; }
+	unsigned GetIdsPerConstraint() const { return idsPerConstraint_; }
+	unsigned GetScalarsPerConstraint() const { return scalarsPerConstraint_; }
+	unsigned GetNumPoints() const { return numPoints_; }
+
+	const float* GetPoints() const { return points_; }
+	const int* GetIds() const { return ids_; }
+	const float* GetWeights() const { return weights_; }
+	// NULL when the block keeps ShapeOp's defaults
+	const double* GetScalars() const { return scalars_; }
+
+private:
+	bool valid_;
+	Urho3D::String constraintType_;
+	unsigned numConstraints_;
+	unsigned idsPerConstraint_;
+	unsigned scalarsPerConstraint_;
+	unsigned numPoints_;
+	const float* points_;
+	const int* ids_;
+	const float* weights_;
+	const double* scalars_;
+};
\ No newline at end of file